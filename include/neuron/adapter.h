@@ -39,6 +39,20 @@ typedef int (*neu_adapter_update_metric_cb_t)(neu_adapter_t *adapter,
                                               const char *   metric_name,
                                               uint64_t n, const char *group);
 
+/**
+ * @brief 适配器解析度量项句柄的回调函数类型。
+ *
+ * 在注册度量项后调用一次，之后通过 neu_metric_handle_update 更新，避免每次
+ * 更新都加锁并按名称查找。
+ *
+ * @param adapter     指向neu_adapter_t类型的指针，表示当前适配器实例。
+ * @param metric_name 指标名称。
+ * @param group       组名称，节点级指标为 NULL。
+ * @return 度量项句柄，指标未注册时返回 NULL。
+ */
+typedef neu_metric_handle_t *(*neu_adapter_metric_handle_cb_t)(
+    neu_adapter_t *adapter, const char *metric_name, const char *group);
+
 /**
  * @brief 适配器注册指标的回调函数类型。
  *
@@ -133,6 +147,13 @@ typedef struct adapter_callbacks {
      */
     neu_adapter_update_metric_cb_t   update_metric;
 
+    /**
+     * @brief 解析指标句柄的回调函数。
+     *
+     * 允许适配器以句柄方式无锁地更新其性能指标。
+     */
+    neu_adapter_metric_handle_cb_t   metric_handle;
+
     union {
         struct {
             /**
@@ -194,6 +215,15 @@ typedef struct adapter_callbacks {
             void (*write_response)(neu_adapter_t *adapter, void *req,
                                    int error);
                                    
+            /**
+             * @brief 按点位返回写入结果的回调函数。
+             *
+             * @param adapter    当前适配器实例。
+             * @param req        请求对象。
+             * @param responses  各点位的写入结果，与传入的点位一一对应且顺序
+             *                   相同，group 为空时由驱动按位置填写。
+             * @param n_response 结果个数。
+             */
             void (*write_responses)(neu_adapter_t *adapter, void *req,
                                     neu_driver_write_responses_t *responses,
                                     int                           n_response);
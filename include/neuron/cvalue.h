@@ -0,0 +1,132 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+#ifndef _NEU_CVALUE_H_
+#define _NEU_CVALUE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "type.h"
+
+/**
+ * @brief 紧凑值：neu_dvalue_t 的 16 字节表示。
+ *
+ * neu_dvalue_t 内联了 neu_value_u 中最大的数组（约 2KB），而绝大多数点位
+ * 是 1 到 8 字节的标量。紧凑值把标量和不超过 NEU_CVALUE_INLINE_STR 字节的
+ * 字符串直接存放在 16 字节内，更长的字符串、数组、bytes 与 PTR 放入引用计数
+ * 的外部存储（neu_cvalue_blob_t），复制紧凑值只增加引用计数。
+ *
+ * 插件接口仍使用 neu_dvalue_t，通过 neu_cvalue_from_dvalue 与
+ * neu_cvalue_to_dvalue 两个转换函数与紧凑值互转。
+ */
+
+/** 内联字符串的最大长度（不含结尾 '\0'） */
+#define NEU_CVALUE_INLINE_STR 11
+
+/** value.blob 指向引用计数的外部存储 */
+#define NEU_CVALUE_F_BLOB 0x01
+/** value.ptr 持有一个 json_t 引用（NEU_TYPE_CUSTOM） */
+#define NEU_CVALUE_F_JSON 0x02
+
+typedef struct neu_cvalue_blob {
+    uint32_t ref;
+    uint32_t size; ///< data 的字节数
+    uint8_t  data[];
+} neu_cvalue_blob_t;
+
+typedef struct {
+    /**
+     * @brief 数值或外部存储指针。
+     *
+     * 内联字符串从 value.str 开始，连续占用 value 与 str_tail 共 12 字节。
+     */
+    union {
+        int8_t             i8;
+        uint8_t            u8;
+        int16_t            i16;
+        uint16_t           u16;
+        int32_t            i32;
+        uint32_t           u32;
+        int64_t            i64;
+        uint64_t           u64;
+        float              f32;
+        double             d64;
+        bool               boolean;
+        char               str[8];
+        neu_cvalue_blob_t *blob;
+        void *             ptr;
+    } value;
+    char    str_tail[4];
+    uint8_t type;      ///< neu_type_e
+    uint8_t precision; ///< 同 neu_dvalue_t.precision
+    uint8_t flags;     ///< NEU_CVALUE_F_*
+    /**
+     * @brief 数组与 bytes 的元素个数；NEU_TYPE_PTR 时为 ptr.type。
+     */
+    uint8_t length;
+} neu_cvalue_t;
+
+/**
+ * @brief 由 neu_dvalue_t 构造紧凑值，复制其中的数据，不接管 dvalue 持有的
+ * 堆内存（字符串数组、PTR），NEU_TYPE_CUSTOM 会增加 json 引用计数。
+ */
+void neu_cvalue_from_dvalue(neu_cvalue_t *cv, const neu_dvalue_t *dv);
+
+/**
+ * @brief 把紧凑值写回 neu_dvalue_t，只写入 type、precision 与有效数据部分。
+ * 字符串数组、PTR 与 NEU_TYPE_CUSTOM 会复制出新的堆内存，由调用者释放，
+ * 与原先从缓存取值的约定一致。
+ */
+void neu_cvalue_to_dvalue(const neu_cvalue_t *cv, neu_dvalue_t *dv);
+
+/**
+ * @brief 复制紧凑值，外部存储共享并增加引用计数。
+ */
+void neu_cvalue_copy(neu_cvalue_t *dst, const neu_cvalue_t *src);
+
+/**
+ * @brief 释放紧凑值持有的引用，释放后为类型 0 的空值。
+ */
+void neu_cvalue_release(neu_cvalue_t *cv);
+
+/**
+ * @brief 逐字节比较两个紧凑值的类型与数据，不考虑精度，
+ * NEU_TYPE_CUSTOM 按 json 内容比较。
+ */
+bool neu_cvalue_equal(const neu_cvalue_t *a, const neu_cvalue_t *b);
+
+/**
+ * @brief 字符串类型的内容，内联或外部存储均可。
+ */
+static inline const char *neu_cvalue_str(const neu_cvalue_t *cv)
+{
+    return (cv->flags & NEU_CVALUE_F_BLOB) ? (const char *) cv->value.blob->data
+                                           : (const char *) cv;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -45,6 +45,57 @@ neu_events_t *neu_event_new(void);
  */
 int neu_event_close(neu_events_t *events);
 
+/**
+ * @brief 共享事件循环池。
+ *
+ * 节点默认不再各自创建事件线程，而是从池中取用一个循环（M 个节点对 N 个线程），
+ * 池大小默认等于 CPU 核数。插件回调中有阻塞 I/O 的节点可通过
+ * neu_plugin_module_t.dedicated_events 使用独占的事件循环，避免拖慢同一循环上的其他节点。
+ */
+
+/**
+ * @brief 设置并启动事件循环池，需在第一次 neu_event_pool_get 之前调用。
+ * @param[in] n_loop 循环线程数，小于等于 0 时使用 CPU 核数。
+ * @return 0 成功；池已启动时返回 -1。
+ */
+int neu_event_pool_init(int n_loop);
+
+/**
+ * @brief 停止并释放池中的所有循环，调用前所有节点应已归还循环。
+ */
+void neu_event_pool_fini(void);
+
+/**
+ * @brief 从池中取用当前使用者最少的循环，池未启动时按默认大小启动。
+ * 取得的循环与 neu_event_new 创建的用法相同，使用完毕调用 neu_event_close 归还，
+ * 归还时会等待该循环上正在执行的回调返回，但不会停止循环线程。
+ * @return 共享的事件循环。
+ */
+neu_events_t *neu_event_pool_get(void);
+
+/**
+ * @brief 事件循环的运行统计，利用率与延迟为上一个一秒统计周期的值。
+ */
+typedef struct {
+    uint32_t users;        ///< 取用该循环的次数（节点数）
+    uint32_t events;       ///< 已注册的 I/O 与定时器个数
+    uint32_t busy_percent; ///< 执行回调的时间占比，百分比
+    uint64_t lag_max_us;   ///< 定时器实际触发时间相对到期时间的最大延迟
+    uint64_t lag_avg_us;   ///< 定时器触发的平均延迟
+    uint64_t dispatched;   ///< 累计分发的事件数
+} neu_event_loop_stats_t;
+
+/**
+ * @brief 事件循环池中的循环个数，池未启动时为 0。
+ */
+int neu_event_pool_size(void);
+
+/**
+ * @brief 读取池中第 index 个循环的统计。
+ * @return 0 成功；index 越界时返回 -1。
+ */
+int neu_event_pool_stats(int index, neu_event_loop_stats_t *stats);
+
 typedef struct neu_event_timer neu_event_timer_t;
 typedef int (*neu_event_timer_callback)(void *usr_data);
 
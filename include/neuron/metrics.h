@@ -31,11 +31,10 @@ extern "C" {
 #include "define.h"
 #include "type.h"
 #include "utils/rolling_counter.h"
+#include "utils/time.h"
 #include "utils/utextend.h"
 #include "utils/uthash.h"
 
-extern int64_t global_timestamp;
-
 /**
  * @brief 指标类型枚举，用于定义不同的性能指标类型。
  *
@@ -114,6 +113,12 @@ typedef enum {
 #define NEU_METRIC_RECV_BYTES_TYPE NEU_METRIC_TYPE_COUNTER_SET
 #define NEU_METRIC_RECV_BYTES_HELP "Total number of bytes received"
 
+// percentage of time the serial bus carries frames
+#define NEU_METRIC_BUS_UTILIZATION "bus_utilization_percent"
+#define NEU_METRIC_BUS_UTILIZATION_TYPE NEU_METRIC_TYPE_GAUAGE
+#define NEU_METRIC_BUS_UTILIZATION_HELP \
+    "Percentage of time the serial bus carried frames in the last minute"
+
 // maintained by neuron core
 // number of tag read including errors
 #define NEU_METRIC_TAG_READS_TOTAL "tag_reads_total"
@@ -127,6 +132,13 @@ typedef enum {
 #define NEU_METRIC_TAG_READ_ERRORS_TOTAL_TYPE NEU_METRIC_TYPE_COUNTER
 #define NEU_METRIC_TAG_READ_ERRORS_TOTAL_HELP "Total number of tag read errors"
 
+// maintained by neuron core
+// number of tag value changes suppressed by deadband
+#define NEU_METRIC_TAG_SUPPRESSED_TOTAL "tag_suppressed_updates_total"
+#define NEU_METRIC_TAG_SUPPRESSED_TOTAL_TYPE NEU_METRIC_TYPE_COUNTER
+#define NEU_METRIC_TAG_SUPPRESSED_TOTAL_HELP \
+    "Total number of tag value changes suppressed by deadband"
+
 // maintained by neuron core
 // number of tags in group
 #define NEU_METRIC_TAGS_TOTAL "tags_total"
@@ -179,6 +191,18 @@ typedef enum {
 #define NEU_METRIC_SEND_MSG_ERRORS_TOTAL_HELP \
     "Total number of errors sending messages"
 
+// number of messages dropped because the send queue is full
+#define NEU_METRIC_SEND_MSG_DROPS_TOTAL "send_msg_drops_total"
+#define NEU_METRIC_SEND_MSG_DROPS_TOTAL_TYPE NEU_METRIC_TYPE_COUNTER
+#define NEU_METRIC_SEND_MSG_DROPS_TOTAL_HELP \
+    "Total number of messages dropped because the send queue is full"
+
+// number of messages waiting in the send queue
+#define NEU_METRIC_SEND_QUEUE_SIZE "send_queue_size"
+#define NEU_METRIC_SEND_QUEUE_SIZE_TYPE NEU_METRIC_TYPE_GAUAGE
+#define NEU_METRIC_SEND_QUEUE_SIZE_HELP \
+    "Number of messages waiting in the send queue"
+
 // number of messages received
 #define NEU_METRIC_RECV_MSGS_TOTAL "recv_msgs_total"
 #define NEU_METRIC_RECV_MSGS_TOTAL_TYPE NEU_METRIC_TYPE_COUNTER
@@ -353,6 +377,9 @@ typedef struct {
     /** @brief 关联的适配器，指向与该节点关联的适配器对象的指针。*/
     neu_adapter_t *      adapter;   
 
+    /** @brief 结构版本号，度量项或组增删改名时递增，导出器据此重建缓存。*/
+    uint32_t             version;
+
     /** @brief 哈希表句柄，用于在哈希表中按name有序存储节点度量对象。*/    
     UT_hash_handle       hh;            
 } neu_node_metrics_t;
@@ -389,6 +416,7 @@ typedef struct {
     size_t              south_disconnected_nodes;    ///< 断开连接的南向节点数
     neu_node_metrics_t *node_metrics;                ///< 节点度量信息
     neu_metric_entry_t *registered_metrics;          ///< 注册的度量项列表
+    uint32_t            version;                     ///< 结构版本号
 } neu_metrics_t;
 
 void neu_metrics_init();
@@ -434,6 +462,81 @@ static inline const char *neu_metric_type_str(neu_metric_type_e type)
     }
 }
 
+/**
+ * @brief 度量项句柄。
+ *
+ * 由 neu_node_metrics_handle 一次性解析得到，之后通过 neu_metric_handle_update
+ * 更新，不再按名称查找，也不持有节点锁。句柄在所属节点（组度量项为所属组）
+ * 删除前有效。
+ */
+typedef neu_metric_entry_t neu_metric_handle_t;
+
+/**
+ * @brief 更新度量项的值。
+ *
+ * 计数器为原子累加，仪表为原子写入，滚动计数器为无锁累加，可在不持有节点锁
+ * 时由多个线程并发调用。
+ */
+static inline void neu_metric_entry_update(neu_metric_entry_t *entry,
+                                           uint64_t            n)
+{
+    if (neu_metric_type_is_counter(entry->type)) {
+        __atomic_fetch_add(&entry->value, n, __ATOMIC_RELAXED);
+    } else if (neu_metric_type_is_rolling_counter(entry->type)) {
+        if (NULL != entry->rcnt) {
+            neu_rolling_counter_add(entry->rcnt, neu_time_mono_ms_coarse(), n);
+        }
+    } else {
+        __atomic_store_n(&entry->value, n, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief 读取度量项的当前值，滚动计数器按当前时间剔除过期的时间片。
+ */
+static inline uint64_t neu_metric_entry_value(neu_metric_entry_t *entry)
+{
+    if (neu_metric_type_is_rolling_counter(entry->type)) {
+        return NULL != entry->rcnt
+            ? neu_rolling_counter_value_at(entry->rcnt,
+                                           neu_time_mono_ms_coarse())
+            : 0;
+    }
+    return __atomic_load_n(&entry->value, __ATOMIC_RELAXED);
+}
+
+static inline void neu_metric_entry_reset(neu_metric_entry_t *entry)
+{
+    if (neu_metric_type_no_reset(entry->type)) {
+        return;
+    }
+
+    __atomic_store_n(&entry->value, entry->init, __ATOMIC_RELAXED);
+    if (neu_metric_type_is_rolling_counter(entry->type) &&
+        NULL != entry->rcnt) {
+        neu_rolling_counter_reset(entry->rcnt);
+    }
+}
+
+static inline void neu_metric_handle_update(neu_metric_handle_t *handle,
+                                            uint64_t             n)
+{
+    if (NULL != handle) {
+        neu_metric_entry_update(handle, n);
+    }
+}
+
+/**
+ * @brief 以相同的值更新一组句柄，如同一指标 5s/30s/60s 三个时间窗口的度量项。
+ */
+static inline void neu_metric_handles_update(neu_metric_handle_t **handles,
+                                             size_t len, uint64_t n)
+{
+    for (size_t i = 0; i < len; ++i) {
+        neu_metric_handle_update(handles[i], n);
+    }
+}
+
 int neu_metric_entries_add(neu_metric_entry_t **entries, const char *name,
                            const char *help, neu_metric_type_e type,
                            uint64_t init);
@@ -576,6 +679,9 @@ static inline int neu_node_metrics_add(neu_node_metrics_t *node_metrics,
             }
         }
     }
+    if (0 == rv) {
+        ++node_metrics->version;
+    }
     pthread_mutex_unlock(&node_metrics->lock);
 
     // 如果添加度量项失败，则取消注册度量项
@@ -598,14 +704,13 @@ static inline int neu_node_metrics_add(neu_node_metrics_t *node_metrics,
  * @param n            要更新的度量值。
  * @return 成功时返回 0；如果未找到度量条目或未提供有效的组名，则返回 `-1`。
  */
-static inline int neu_node_metrics_update(neu_node_metrics_t *node_metrics,
-                                          const char *        group,
-                                          const char *metric_name, uint64_t n)
+// 调用者持有节点锁
+static inline neu_metric_entry_t *
+neu_node_metrics_find(neu_node_metrics_t *node_metrics, const char *group,
+                      const char *metric_name)
 {
     neu_metric_entry_t *entry = NULL;
 
-    pthread_mutex_lock(&node_metrics->lock);
-
     // 根据组名查找指标项
     if (NULL == group) {
         HASH_FIND_STR(node_metrics->entries, metric_name, entry); // 表中查找指标名称的项
@@ -617,20 +722,37 @@ static inline int neu_node_metrics_update(neu_node_metrics_t *node_metrics,
         }
     }
 
+    return entry;
+}
+
+/**
+ * @brief 解析已注册度量项的句柄，度量项不存在时返回 NULL。
+ */
+static inline neu_metric_handle_t *
+neu_node_metrics_handle(neu_node_metrics_t *node_metrics, const char *group,
+                        const char *metric_name)
+{
+    pthread_mutex_lock(&node_metrics->lock);
+    neu_metric_entry_t *entry =
+        neu_node_metrics_find(node_metrics, group, metric_name);
+    pthread_mutex_unlock(&node_metrics->lock);
+
+    return entry;
+}
+
+static inline int neu_node_metrics_update(neu_node_metrics_t *node_metrics,
+                                          const char *        group,
+                                          const char *metric_name, uint64_t n)
+{
+    pthread_mutex_lock(&node_metrics->lock);
+    neu_metric_entry_t *entry =
+        neu_node_metrics_find(node_metrics, group, metric_name);
     if (NULL == entry) {
         pthread_mutex_unlock(&node_metrics->lock);
         return -1;
     }
 
-    //判断度量的类型
-    if (neu_metric_type_is_counter(entry->type)) {
-        entry->value += n;
-    } else if (neu_metric_type_is_rolling_counter(entry->type)) {
-        entry->value =
-            neu_rolling_counter_inc(entry->rcnt, global_timestamp, n);
-    } else {
-        entry->value = n;
-    }
+    neu_metric_entry_update(entry, n);
     pthread_mutex_unlock(&node_metrics->lock);
 
     return 0;
@@ -643,12 +765,7 @@ static inline void neu_node_metrics_reset(neu_node_metrics_t *node_metrics)
     pthread_mutex_lock(&node_metrics->lock);
     HASH_LOOP(hh, node_metrics->entries, entry)
     {
-        if (!neu_metric_type_no_reset(entry->type)) {
-            entry->value = entry->init;
-            if (neu_metric_type_is_rolling_counter(entry->type)) {
-                neu_rolling_counter_reset(entry->rcnt);
-            }
-        }
+        neu_metric_entry_reset(entry);
     }
 
     neu_group_metrics_t *g = NULL;
@@ -656,12 +773,7 @@ static inline void neu_node_metrics_reset(neu_node_metrics_t *node_metrics)
     {
         HASH_LOOP(hh, g->entries, entry)
         {
-            if (!neu_metric_type_no_reset(entry->type)) {
-                entry->value = entry->init;
-                if (neu_metric_type_is_rolling_counter(entry->type)) {
-                    neu_rolling_counter_reset(entry->rcnt);
-                }
-            }
+            neu_metric_entry_reset(entry);
         }
     }
     pthread_mutex_unlock(&node_metrics->lock);
@@ -684,6 +796,7 @@ neu_node_metrics_update_group(neu_node_metrics_t *node_metrics,
             free(group_metrics->name);
             group_metrics->name = name;
             HASH_ADD_STR(node_metrics->group_metrics, name, group_metrics);
+            ++node_metrics->version;
             rv = 0;
         }
     }
@@ -701,6 +814,7 @@ static inline void neu_node_metrics_del_group(neu_node_metrics_t *node_metrics,
     if (NULL != gm) {
         HASH_DEL(node_metrics->group_metrics, gm);
         neu_group_metrics_free(gm);
+        ++node_metrics->version;
     }
     pthread_mutex_unlock(&node_metrics->lock);
 }
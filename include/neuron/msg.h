@@ -220,6 +220,10 @@ typedef enum neu_reqresp_type {
     NEU_REQRESP_NODE_DELETED,
     /** @brief 添加驱动器请求 */
     NEU_REQ_ADD_DRIVERS,
+    /** @brief 批量导入全局配置请求 */
+    NEU_REQ_IMPORT_CONFIG,
+    /** @brief 批量导入全局配置响应 */
+    NEU_RESP_IMPORT_CONFIG,
     /** @brief 更新日志级别请求 */
     NEU_REQ_UPDATE_LOG_LEVEL,
     /** @brief 程序文件上传请求 */
@@ -351,7 +355,9 @@ static const char *neu_reqresp_type_string_t[] = {
     [NEU_REQRESP_NODES_STATE]  = "NEU_REQRESP_NODES_STATE",
     [NEU_REQRESP_NODE_DELETED] = "NEU_REQRESP_NODE_DELETED",
 
-    [NEU_REQ_ADD_DRIVERS] = "NEU_REQ_ADD_DRIVERS",
+    [NEU_REQ_ADD_DRIVERS]    = "NEU_REQ_ADD_DRIVERS",
+    [NEU_REQ_IMPORT_CONFIG]  = "NEU_REQ_IMPORT_CONFIG",
+    [NEU_RESP_IMPORT_CONFIG] = "NEU_RESP_IMPORT_CONFIG",
 
     [NEU_REQ_UPDATE_LOG_LEVEL] = "NEU_REQ_UPDATE_LOG_LEVEL",
     [NEU_REQ_PRGFILE_UPLOAD]   = "NEU_REQ_PRGFILE_UPLOAD",
@@ -464,6 +470,13 @@ typedef struct neu_reqresp_head {
      */
     uint32_t           len;
     bool               monitor;
+
+    /**
+     * @brief 请求已入队的持久化命令。
+     *
+     * 随请求的转发与应答传递，由收到应答的一方等待或释放。
+     */
+    struct neu_persist_ticket *persist_ticket;
 } neu_reqresp_head_t;
 
 typedef struct neu_resp_error {
@@ -1367,6 +1380,68 @@ static inline void neu_req_driver_array_fini(neu_req_driver_array_t *req)
     free(req->drivers);
 }
 
+/**
+ * @brief 批量导入全局配置，替换全部非静态节点。
+ *
+ * 应用节点的 n_group 为 0；订阅的 port 字段不使用。
+ */
+typedef struct {
+    bool                 dry_run; ///< 只与当前配置比较，不做修改
+    uint16_t             n_node;
+    neu_req_driver_t *   nodes;
+    uint32_t             n_subscription;
+    neu_req_subscribe_t *subscriptions;
+} neu_req_import_config_t;
+
+static inline void neu_req_import_config_fini(neu_req_import_config_t *req)
+{
+    for (uint16_t i = 0; i < req->n_node; ++i) {
+        neu_req_driver_fini(&req->nodes[i]);
+    }
+    free(req->nodes);
+    for (uint32_t i = 0; i < req->n_subscription; ++i) {
+        free(req->subscriptions[i].params);
+        free(req->subscriptions[i].static_tags);
+    }
+    free(req->subscriptions);
+}
+
+/**
+ * @brief 导入的配置与当前配置的差异。
+ *
+ * 节点以名称、组以驱动与组名、订阅以应用、驱动与组名区分，两边都有的计为
+ * update。
+ */
+typedef struct {
+    int       error;
+    char      node[NEU_NODE_NAME_LEN]; ///< 出错的节点，可为空
+    bool      dry_run;
+    UT_array *add_nodes;    ///< char *
+    UT_array *del_nodes;    ///< char *
+    UT_array *update_nodes; ///< char *
+    uint32_t  add_groups;
+    uint32_t  del_groups;
+    uint32_t  update_groups;
+    uint32_t  add_subscriptions;
+    uint32_t  del_subscriptions;
+    uint32_t  update_subscriptions;
+    uint64_t  current_tags;
+    uint64_t  import_tags;
+} neu_resp_import_config_t;
+
+static inline void neu_resp_import_config_fini(neu_resp_import_config_t *resp)
+{
+    if (resp->add_nodes) {
+        utarray_free(resp->add_nodes);
+    }
+    if (resp->del_nodes) {
+        utarray_free(resp->del_nodes);
+    }
+    if (resp->update_nodes) {
+        utarray_free(resp->update_nodes);
+    }
+}
+
 static inline void neu_trans_data_free(neu_reqresp_trans_data_t *data)
 {
     pthread_mutex_lock(&data->ctx->mtx);
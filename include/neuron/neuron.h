@@ -55,6 +55,7 @@ extern "C" {
 #include "json/neu_json_param.h"
 #include "json/neu_json_rw.h"
 
+#include "cvalue.h"
 #include "define.h"
 
 #include "adapter.h"
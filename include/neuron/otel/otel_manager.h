@@ -23,15 +23,40 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 typedef enum {
     NEU_OTEL_STATUS_UNSET = 0,
     NEU_OTEL_STATUS_OK    = 1,
     NEU_OTEL_STATUS_ERROR = 2,
 } neu_otel_status_code_e;
 
+/**
+ * @brief 追踪导出的统计。
+ */
+typedef struct {
+    uint64_t traces;           ///< 表中尚未完成的追踪数
+    uint64_t queued_traces;    ///< 等待导出的追踪数
+    uint64_t queued_bytes;     ///< 等待导出的编码长度
+    uint64_t exported;         ///< 已导出的追踪数
+    uint64_t export_failures;  ///< 发送失败的次数
+    uint64_t dropped_limit;    ///< 表已满未创建的追踪数
+    uint64_t dropped_queue;    ///< 导出队列已满丢弃的追踪数
+    uint64_t dropped_timeout;  ///< 超时未完成丢弃的追踪数
+    uint64_t dropped_rejected; ///< 采集器拒绝（400）的追踪数
+} neu_otel_stats_t;
+
 typedef void *neu_otel_trace_ctx;
 typedef void *neu_otel_scope_ctx;
 
+/**
+ * @brief 创建追踪并以 req_ctx 为键登记。
+ *
+ * 表中的追踪数达到上限时返回 NULL。追踪与 span 的接口都接受 NULL 并直接
+ * 返回，调用者不必区分。
+ */
 neu_otel_trace_ctx neu_otel_create_trace(const char *trace_id, void *req_ctx,
                                          uint32_t    flags,
                                          const char *tracestate);
@@ -99,6 +124,8 @@ void neu_otel_split_traceparent(const char *in, char *trace_id, char *span_id,
 
 void        neu_otel_start();
 void        neu_otel_stop();
+void        neu_otel_get_stats(neu_otel_stats_t *stats);
+bool        neu_otel_data_sampled();
 bool        neu_otel_control_is_started();
 bool        neu_otel_data_is_started();
 double      neu_otel_data_sample_rate();
@@ -107,4 +134,8 @@ void        neu_otel_set_config(void *config);
 void *      neu_otel_get_config();
 const char *neu_otel_service_name();
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif // NEU_OTEL_MANAGER_H
\ No newline at end of file
@@ -31,6 +31,10 @@ extern "C" {
 
 typedef neu_json_plugin_req_plugin_t neu_persist_plugin_info_t;
 
+typedef struct neu_persist_ticket neu_persist_ticket_t;
+
+typedef void (*neu_persist_ticket_cb)(int error, void *arg);
+
 /**
  * @brief 用于存储持久化节点信息的结构体。
  *
@@ -94,6 +98,14 @@ typedef struct {
     char *   context;
 } neu_persist_group_info_t;
 
+/**
+ * @brief 一个组下的全部标签，节点启动时按节点一次性加载。
+ */
+typedef struct {
+    char *    group_name; ///< 组名
+    UT_array *tags;       ///< neu_datatag_t 向量，按写入顺序排列
+} neu_persist_group_tags_t;
+
 typedef struct {
     char *driver_name;
     char *group_name;
@@ -106,6 +118,47 @@ typedef struct {
     char *hash;
 } neu_persist_user_info_t;
 
+/**
+ * @brief 批量导入的节点，字符串均引用调用者的数据。
+ */
+typedef struct {
+    neu_persist_node_info_t info;
+    const char *            setting; ///< 节点设置，NULL 表示没有设置
+} neu_persist_import_node_t;
+
+/**
+ * @brief 批量导入的组及其全部点位。
+ */
+typedef struct {
+    const char *         driver_name;
+    const char *         name;
+    uint32_t             interval;
+    const neu_datatag_t *tags;
+    int                  n_tag;
+} neu_persist_import_group_t;
+
+typedef struct {
+    const char *app_name;
+    const char *driver_name;
+    const char *group_name;
+    const char *params;
+    const char *static_tags;
+} neu_persist_import_sub_t;
+
+/**
+ * @brief 一次批量导入：先删除 del_nodes 中的节点，再写入其余内容。
+ */
+typedef struct {
+    const char *const *               del_nodes;
+    size_t                            n_del_node;
+    const neu_persist_import_node_t * nodes;
+    size_t                            n_node;
+    const neu_persist_import_group_t *groups;
+    size_t                            n_group;
+    const neu_persist_import_sub_t *  subscriptions;
+    size_t                            n_subscription;
+} neu_persist_import_t;
+
 static inline void neu_persist_plugin_infos_free(UT_array *plugin_infos)
 {
     utarray_free(plugin_infos);
@@ -125,6 +178,12 @@ static inline void neu_persist_group_info_fini(neu_persist_group_info_t *info)
     }
 }
 
+static inline void neu_persist_group_tags_fini(neu_persist_group_tags_t *info)
+{
+    free(info->group_name);
+    utarray_free(info->tags);
+}
+
 static inline void
 neu_persist_subscription_info_fini(neu_persist_subscription_info_t *info)
 {
@@ -154,6 +213,55 @@ void neu_persister_destroy();
 
 sqlite3 *neu_persister_get_db();
 
+/**
+ * Wait until all previously issued store/update/delete operations are
+ * committed.
+ *
+ * Write operations are queued and committed asynchronously by the persister
+ * thread, their return value only indicates that the operation is queued.
+ * This waits for the operations of all threads, use a ticket to wait for the
+ * operations of one request only.
+ * @return 0 on success, non-zero if any of the waited operations failed
+ */
+int neu_persister_sync();
+
+/**
+ * Start recording the write operations issued by the current thread on
+ * behalf of one request.
+ * @param ticket                    operations the request already issued on
+ *                                  other threads, may be NULL; ownership is
+ *                                  taken.
+ */
+void neu_persister_track_begin(neu_persist_ticket_t *ticket);
+
+/**
+ * Take the operations recorded so far, later ones start a new record.
+ * @return NULL if no operation was issued.
+ */
+neu_persist_ticket_t *neu_persister_track_take();
+
+/**
+ * Stop recording and release the record that was not taken.
+ */
+void neu_persister_track_end();
+
+/**
+ * Call cb once all operations of the ticket are committed, then free the
+ * ticket. Only these operations are waited for and reported.
+ *
+ * cb is called directly if they are already committed, otherwise it is called
+ * from the persister thread and must not call load operations.
+ * @param cb                        error is 0 on success, otherwise the error
+ *                                  of the first failed operation.
+ */
+void neu_persister_ticket_wait(neu_persist_ticket_t *ticket,
+                               neu_persist_ticket_cb cb, void *arg);
+
+/**
+ * Free a ticket without waiting for it.
+ */
+void neu_persister_ticket_release(neu_persist_ticket_t *ticket);
+
 /**
  * Persist nodes.
  * @param node_info                 neu_persist_node_info_t.
@@ -228,6 +336,17 @@ int neu_persister_store_tags(const char *driver_name, const char *group_name,
 int neu_persister_load_tags(const char *driver_name, const char *group_name,
                             UT_array **tag_infos);
 
+/**
+ * Load all tag infos of a node with a single query.
+ * @param driver_name               name of the node who owns the tags
+ * @param[out] group_tags           used to return pointer to heap allocated
+ *                                  vector of neu_persist_group_tags_t, one
+ *                                  element per group that has tags
+ * @return 0 on success, non-zero otherwise
+ */
+int neu_persister_load_node_tags(const char *driver_name,
+                                 UT_array ** group_tags);
+
 /**
  * Update node tags.
  * @param driver_name               name of the driver who owns the tags
@@ -403,9 +522,38 @@ int neu_persister_load_user(const char *              user_name,
  */
 int neu_persister_delete_user(const char *user_name);
 
+/**
+ * Import a whole configuration in one transaction.
+ *
+ * Either every node, setting, group, tag and subscription is written, or
+ * nothing changes. The configuration before the import is kept as a snapshot
+ * until neu_persister_import_end is called.
+ * @param import                    configuration to import, only read during
+ *                                  the call.
+ * @return 0 on success, non-zero on failure
+ */
+int neu_persister_import(const neu_persist_import_t *import);
+
+/**
+ * Finish an import started by neu_persister_import.
+ * @param rollback                  restore the snapshot taken before the
+ *                                  import if true, otherwise discard it.
+ * @return 0 on success, non-zero on failure
+ */
+int neu_persister_import_end(bool rollback);
+
 char *neu_persister_save_file_tmp(const char *file_data, uint32_t len,
                                   const char *suffix);
 
+/**
+ * Decode base64 data into a new temporary file.
+ * @param data                      base64 encoded file content.
+ * @param suffix                    suffix of the temporary file.
+ * @return path of the temporary file on success, NULL on failure.
+ */
+char *neu_persister_save_file_tmp_decode64(const char *data,
+                                           const char *suffix);
+
 bool neu_persister_library_exists(const char *library);
 
 #ifdef __cplusplus
@@ -24,6 +24,7 @@
 extern "C" {
 #endif
 
+#include "utils/time.h"
 #include "utils/utextend.h"
 #include "utils/zlog.h"
 
@@ -44,7 +45,9 @@ extern "C" {
     plugin->common.adapter_callbacks->update_metric(plugin->common.adapter, \
                                                     name, val, grp)
 
-extern int64_t global_timestamp;
+#define NEU_PLUGIN_METRIC_HANDLE(plugin, name, grp)                         \
+    plugin->common.adapter_callbacks->metric_handle(plugin->common.adapter, \
+                                                    name, grp)
 
 /**
  * @brief 插件公共部分结构体，用于描述一个插件的基础信息和通用配置。
@@ -483,6 +486,14 @@ typedef struct neu_plugin_module {
      * 定义了插件使用的缓存类型。这有助于主程序根据缓存类型对插件进行优化和管理。
      */
     neu_tag_cache_type_e cache_type;
+
+    /**
+     * @brief 是否使用独占的事件循环
+     *
+     * 插件回调（组采集、请求处理等）中有阻塞 I/O 时置为 true，节点使用独立的事件线程；
+     * 否则节点的事件与组定时器由共享事件循环池调度。
+     */
+    bool dedicated_events;
 } neu_plugin_module_t;
 
 inline static neu_plugin_common_t *
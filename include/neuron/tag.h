@@ -175,6 +175,37 @@ typedef union {
     } bit;
 } neu_datatag_addr_option_u;
 
+/**
+ * @brief 死区类型。
+ */
+typedef enum {
+    NEU_DEADBAND_NONE     = 0, ///< 不启用死区，按原有规则判断变化
+    NEU_DEADBAND_ABSOLUTE = 1, ///< value 为绝对值
+    NEU_DEADBAND_SPAN     = 2, ///< value 为量程 span 的百分比
+    NEU_DEADBAND_VALUE    = 3, ///< value 为上次上报值的百分比
+} neu_deadband_type_e;
+
+/**
+ * @brief 数值标签的变化上报过滤配置。
+ *
+ * 新值与上次上报值之差不超过死区时不视为变化；变化方向与上次相反时
+ * 死区再加上 hysteresis。距上次上报超过 heartbeat 毫秒时无论是否越过
+ * 死区都视为变化，heartbeat 可单独使用。
+ */
+typedef struct {
+    neu_deadband_type_e type;
+    double              value;      ///< 死区宽度，单位由 type 决定
+    double              span;       ///< 量程，仅 NEU_DEADBAND_SPAN 使用
+    double              hysteresis; ///< 方向反转时的回差，单位同 value
+    uint32_t            heartbeat;  ///< 最长静默时间（毫秒），0 表示不启用
+} neu_datatag_deadband_t;
+
+static inline bool
+neu_tag_deadband_enabled(const neu_datatag_deadband_t *deadband)
+{
+    return deadband->type != NEU_DEADBAND_NONE || deadband->heartbeat > 0;
+}
+
 /**
  * @brief 数据标签结构体，用于描述一个数据标签的各项属性。
  *
@@ -265,6 +296,13 @@ typedef struct {
      * 表示`format`数组中有多少个有效的格式化字符串。
      */
     uint8_t                   n_format;
+
+    /**
+     * @brief 变化上报的死区配置。
+     *
+     * 仅对数值类型生效，未配置时 type 为 NEU_DEADBAND_NONE。
+     */
+    neu_datatag_deadband_t    deadband;
 } neu_datatag_t;
 
 /**
@@ -298,6 +336,16 @@ UT_icd *neu_tag_get_icd();
 void neu_tag_format_str(const neu_datatag_t *tag, char *buf, int len);
 int  neu_format_from_str(const char *format_str, uint8_t *formats);
 
+/**
+ * @brief 死区配置与持久化字符串互转，格式为
+ *        "type,value,span,hysteresis,heartbeat"，未启用时为空字符串。
+ *
+ * @return neu_deadband_from_str 成功返回 0，格式错误返回 -1。
+ */
+void neu_tag_deadband_str(const neu_datatag_deadband_t *deadband, char *buf,
+                          int len);
+int  neu_deadband_from_str(const char *str, neu_datatag_deadband_t *deadband);
+
 neu_datatag_t *neu_tag_dup(const neu_datatag_t *tag);
 void           neu_tag_copy(neu_datatag_t *tag, const neu_datatag_t *other);
 void           neu_tag_fini(neu_datatag_t *tag);
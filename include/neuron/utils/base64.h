@@ -24,6 +24,9 @@
 extern "C" {
 #endif
 
+#include <stdint.h>
+#include <stdio.h>
+
 /**
  * @brief base64 encoding.
  *
@@ -43,6 +46,15 @@ char *neu_encode64(const unsigned char *input, int length);
  */
 unsigned char *neu_decode64(int *length, const char *input);
 
+/**
+ * @brief base64 decoding into a file, block by block.
+ *
+ * @param[in] input Data to be decoded.
+ * @param[in] fp File the decoded data is written to.
+ * @return Length of the decoded data, or -1 on failure.
+ */
+int64_t neu_decode64_to_file(const char *input, FILE *fp);
+
 #ifdef __cplusplus
 }
 #endif
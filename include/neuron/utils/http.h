@@ -83,6 +83,26 @@ int         neu_http_internal_error(nng_aio *aio, char *content);
 int neu_http_response_file(nng_aio *aio, void *data, size_t len,
                            const char *disposition);
 
+// Parse a single `bytes=` range of the Range header against a resource of
+// `size` bytes.
+// Returns 0 and stores the inclusive range in `start` and `end` on success,
+// 1 if the header should be ignored (absent, malformed or multiple ranges),
+// -1 if the range is not satisfiable.
+int neu_http_parse_range(const char *range, uint64_t size, uint64_t *start,
+                         uint64_t *end);
+
+// Respond with the file at `path` without loading it into memory.
+// The connection is taken over from the http server and the file is written
+// in fixed-size chunks, then the connection is closed. A satisfiable Range
+// header gets a 206 response of that range, an unsatisfiable one gets 416.
+// Without Range, the body is gzip compressed on the fly with chunked transfer
+// encoding if the client accepts gzip. `disposition` may be NULL.
+// Returns 0 if the response is under way, otherwise an error code and the
+// caller should respond itself.
+int neu_http_response_file_stream(nng_aio *aio, const char *path,
+                                  const char *content_type,
+                                  const char *disposition);
+
 int neu_http_post_otel_trace(uint8_t *data, int len);
 
 #ifdef __cplusplus
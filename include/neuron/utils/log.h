@@ -22,13 +22,95 @@ config_ **/
 
 #include <inttypes.h>
 #include <memory.h>
+#include <stddef.h>
+#include <stdint.h>
 
 #include "utils/zlog.h"
 
 #include "define.h"
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 extern zlog_category_t *neuron;
 
+/**
+ * @brief 每个调用点的最大日志记录长度，超长的记录直接同步写出。
+ */
+#define NEU_LOG_RECORD_MAX 4096
+
+/**
+ * @brief 每个线程的日志缓冲区大小，写满后丢弃新记录。
+ */
+#define NEU_LOG_RING_SIZE (256 * 1024)
+
+/**
+ * @brief 调用点的默认限速：每秒补充的记录数与可突发的记录数。
+ */
+#define NEU_LOG_SITE_RATE 100
+#define NEU_LOG_SITE_BURST 1000
+
+/**
+ * @brief 日志调用点状态，每个日志宏展开处一份。
+ *
+ * 令牌桶：bucket 高 48 位为上次补充令牌的时间（ms），低 16 位为剩余令牌数。
+ */
+typedef struct {
+    uint64_t bucket;
+    uint32_t suppressed; ///< 上次写出后因限速丢弃的记录数
+} neu_log_site_t;
+
+typedef struct {
+    uint64_t written;      ///< 写线程写出的记录数
+    uint64_t direct;       ///< 同步写出的记录数（未启动、超长或 FATAL）
+    uint64_t rate_limited; ///< 因调用点限速丢弃的记录数
+    uint64_t ring_full;    ///< 因线程缓冲区已满丢弃的记录数
+    uint32_t rings;        ///< 当前的线程缓冲区数
+} neu_log_stats_t;
+
+/**
+ * @brief 日志前端。
+ *
+ * 调用线程只做级别过滤、限速和消息格式化，记录写入本线程的无锁缓冲区，
+ * 由后台写线程交给 zlog 落盘；日志时间为写出时间。FATAL 级别、超长记录
+ * 以及写线程未启动时直接同步调用 zlog。
+ */
+void neu_log(neu_log_site_t *site, zlog_category_t *category, const char *file,
+             size_t file_len, const char *func, size_t func_len, long line,
+             int level, const char *format, ...) ZLOG_CHECK_PRINTF(9, 10);
+
+/**
+ * @brief 启动后台写线程，此后的日志异步写出。
+ * @return 成功返回 0，失败返回 -1。
+ */
+int neu_log_start(void);
+
+/**
+ * @brief 写出全部缓冲的日志后停止写线程，此后的日志同步写出。
+ */
+void neu_log_stop(void);
+
+/**
+ * @brief 等待调用前产生的日志全部写出，例如在卸载插件库之前。
+ */
+void neu_log_flush(void);
+
+/**
+ * @brief 设置调用点限速，rate 为 0 时不限速；burst 不超过 65535。
+ */
+void neu_log_set_limit(uint32_t rate, uint32_t burst);
+
+void neu_log_stats(neu_log_stats_t *stats);
+
+#define neu_log_at(category, level, ...)                                       \
+    do {                                                                       \
+        static neu_log_site_t neu_log_site_;                                   \
+        neu_log(&neu_log_site_, (category), __FILE__, sizeof(__FILE__) - 1,    \
+                __func__, sizeof(__func__) - 1, __LINE__, (level),             \
+                __VA_ARGS__);                                                  \
+    } while (0)
+
 inline static const char *log_level_to_str(int level)
 {
     switch (level) {
@@ -51,43 +133,25 @@ inline static const char *log_level_to_str(int level)
 
 #define nlog_level_change(level) zlog_level_switch(neuron, level)
 
-#define nlog_fatal(...)                                    \
-    zlog(neuron, __FILE__, sizeof(__FILE__) - 1, __func__, \
-         sizeof(__func__) - 1, __LINE__, ZLOG_LEVEL_FATAL, __VA_ARGS__)
-#define nlog_error(...)                                    \
-    zlog(neuron, __FILE__, sizeof(__FILE__) - 1, __func__, \
-         sizeof(__func__) - 1, __LINE__, ZLOG_LEVEL_ERROR, __VA_ARGS__)
-#define nlog_warn(...)                                     \
-    zlog(neuron, __FILE__, sizeof(__FILE__) - 1, __func__, \
-         sizeof(__func__) - 1, __LINE__, ZLOG_LEVEL_WARN, __VA_ARGS__)
-#define nlog_notice(...)                                   \
-    zlog(neuron, __FILE__, sizeof(__FILE__) - 1, __func__, \
-         sizeof(__func__) - 1, __LINE__, ZLOG_LEVEL_NOTICE, __VA_ARGS__)
-#define nlog_info(...)                                     \
-    zlog(neuron, __FILE__, sizeof(__FILE__) - 1, __func__, \
-         sizeof(__func__) - 1, __LINE__, ZLOG_LEVEL_INFO, __VA_ARGS__)
-#define nlog_debug(...)                                    \
-    zlog(neuron, __FILE__, sizeof(__FILE__) - 1, __func__, \
-         sizeof(__func__) - 1, __LINE__, ZLOG_LEVEL_DEBUG, __VA_ARGS__)
-
-#define plog_fatal(plugin, ...)                                          \
-    zlog((plugin)->common.log, __FILE__, sizeof(__FILE__) - 1, __func__, \
-         sizeof(__func__) - 1, __LINE__, ZLOG_LEVEL_FATAL, __VA_ARGS__)
-#define plog_error(plugin, ...)                                          \
-    zlog((plugin)->common.log, __FILE__, sizeof(__FILE__) - 1, __func__, \
-         sizeof(__func__) - 1, __LINE__, ZLOG_LEVEL_ERROR, __VA_ARGS__)
-#define plog_warn(plugin, ...)                                           \
-    zlog((plugin)->common.log, __FILE__, sizeof(__FILE__) - 1, __func__, \
-         sizeof(__func__) - 1, __LINE__, ZLOG_LEVEL_WARN, __VA_ARGS__)
-#define plog_notice(plugin, ...)                                         \
-    zlog((plugin)->common.log, __FILE__, sizeof(__FILE__) - 1, __func__, \
-         sizeof(__func__) - 1, __LINE__, ZLOG_LEVEL_NOTICE, __VA_ARGS__)
-#define plog_info(plugin, ...)                                           \
-    zlog((plugin)->common.log, __FILE__, sizeof(__FILE__) - 1, __func__, \
-         sizeof(__func__) - 1, __LINE__, ZLOG_LEVEL_INFO, __VA_ARGS__)
-#define plog_debug(plugin, ...)                                          \
-    zlog((plugin)->common.log, __FILE__, sizeof(__FILE__) - 1, __func__, \
-         sizeof(__func__) - 1, __LINE__, ZLOG_LEVEL_DEBUG, __VA_ARGS__)
+#define nlog_fatal(...) neu_log_at(neuron, ZLOG_LEVEL_FATAL, __VA_ARGS__)
+#define nlog_error(...) neu_log_at(neuron, ZLOG_LEVEL_ERROR, __VA_ARGS__)
+#define nlog_warn(...) neu_log_at(neuron, ZLOG_LEVEL_WARN, __VA_ARGS__)
+#define nlog_notice(...) neu_log_at(neuron, ZLOG_LEVEL_NOTICE, __VA_ARGS__)
+#define nlog_info(...) neu_log_at(neuron, ZLOG_LEVEL_INFO, __VA_ARGS__)
+#define nlog_debug(...) neu_log_at(neuron, ZLOG_LEVEL_DEBUG, __VA_ARGS__)
+
+#define plog_fatal(plugin, ...) \
+    neu_log_at((plugin)->common.log, ZLOG_LEVEL_FATAL, __VA_ARGS__)
+#define plog_error(plugin, ...) \
+    neu_log_at((plugin)->common.log, ZLOG_LEVEL_ERROR, __VA_ARGS__)
+#define plog_warn(plugin, ...) \
+    neu_log_at((plugin)->common.log, ZLOG_LEVEL_WARN, __VA_ARGS__)
+#define plog_notice(plugin, ...) \
+    neu_log_at((plugin)->common.log, ZLOG_LEVEL_NOTICE, __VA_ARGS__)
+#define plog_info(plugin, ...) \
+    neu_log_at((plugin)->common.log, ZLOG_LEVEL_INFO, __VA_ARGS__)
+#define plog_debug(plugin, ...) \
+    neu_log_at((plugin)->common.log, ZLOG_LEVEL_DEBUG, __VA_ARGS__)
 
 enum neu_protocol_log_type {
     NEU_PROTOCOL_SEND,
@@ -139,4 +203,8 @@ inline static void zlog_protocol(zlog_category_t *log, uint8_t *bytes,
 
 void remove_logs(const char *node);
 
+#ifdef __cplusplus
+}
+#endif
+
 #endif
\ No newline at end of file
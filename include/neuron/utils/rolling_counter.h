@@ -33,50 +33,38 @@ extern "C" {
  * @brief 滚动计数器。
  *
  * 此计数器用于在某个最近的时间跨度内对值进行计数，例如最近5秒内的网络字节发送量等。
+ *
+ * 时间跨度被划分为 n 个时间片，每个时间片占一个 64 位槽：高 32 位为时间片
+ * 序号（时间戳除以分辨率），低 32 位为该时间片内的计数。累加通过对槽的 CAS
+ * 完成，槽中序号过期时直接以新序号覆盖，因此多个线程可以无锁地并发更新；
+ * 读取时只累计仍在时间跨度内的槽。
  */
 typedef struct {
     /**
-     * @brief 累加器，用于存储累计的值。
-     */
-    uint64_t val;      
-
-    /**
-     * @brief 头部时间戳，以毫秒为单位。
-     *
-     * 记录当前滚动窗口的起始时间戳。每次更新计数器时，
-     * 会根据这个时间戳和当前时间的差值来确定需要更新哪些计数器。
+     * @brief 最近一次更新所在的时间片序号。
      */
-    uint64_t ts;       
+    uint32_t ts;
 
     /**
      * @brief 时间分辨率，以毫秒为单位。
      *
-     * 用于定义每个计数器的时间间隔大小。
+     * 用于定义每个时间片的时间间隔大小。
      */
-    uint32_t res : 21; 
+    uint32_t res;
 
     /**
-     * @brief 头部位置，表示当前计数器的头部位置。
-     * 
-     * 它是一个循环索引，用于指示当前计数器数组中的哪个元素是头部。
-     * 每次更新计数器时，头部位置会根据时间的推移进行更新。
-     */
-    uint32_t hd : 5;  
-
-    /**
-     * @brief 计数器数量，表示计数器数组中的计数器个数。
-     * 
-     * 不同的时间跨度会对应不同的计数器数量
+     * @brief 时间片数量，为 2 的幂。
+     *
+     * 不同的时间跨度会对应不同的时间片数量
      */
-    uint32_t n : 6;   
+    uint32_t n;
 
     /**
-     * @brief 计数器数组，包含多个计数器的存储单元。
-     * 
-     * 每个元素代表一个特定时间间隔内的计数值
-     * 例如在计算最近 5 秒的网络字节发送量时，计数器数组中的每个元素可能代表 1 秒内的字节发送量。
+     * @brief 时间片槽数组。
+     *
+     * 例如统计最近 5 秒的字节发送量时，每个槽可能代表 1 秒多内的发送量。
      */
-    uint32_t counts[]; 
+    uint64_t slots[];
 } neu_rolling_counter_t;
 
 /** Create rolling counter.
@@ -86,10 +74,10 @@ typedef struct {
 static inline neu_rolling_counter_t *neu_rolling_counter_new(unsigned span)
 {
     unsigned n = span <= 6000 ? 4 : span <= 32000 ? 8 : span <= 64000 ? 16 : 32;
-    assert(span / n < (1 << 22)); // should not overflow ti
+    assert(span / n > 0);
 
     neu_rolling_counter_t *counter = (neu_rolling_counter_t *) calloc(
-        1, sizeof(*counter) + sizeof(counter->counts[0]) * n);
+        1, sizeof(*counter) + sizeof(counter->slots[0]) * n);
     if (counter) {
         counter->res = span / n;
         counter->n   = n;
@@ -107,11 +95,62 @@ static inline void neu_rolling_counter_free(neu_rolling_counter_t *counter)
 }
 
 /**
- * @brief 增量滚动计数器并返回更新后的值。
+ * @brief 累计时间片序号为 epoch 时仍在时间跨度内的计数。
+ */
+static inline uint64_t neu_rolling_counter_sum(neu_rolling_counter_t *counter,
+                                               uint32_t               epoch)
+{
+    uint64_t val = 0;
+
+    for (unsigned i = 0; i < counter->n; ++i) {
+        uint64_t slot = __atomic_load_n(&counter->slots[i], __ATOMIC_RELAXED);
+        if ((uint32_t)(epoch - (uint32_t)(slot >> 32)) < counter->n) {
+            val += (uint32_t) slot;
+        }
+    }
+
+    return val;
+}
+
+/**
+ * @brief 无锁地累加滚动计数器。
  *
- * 此函数用于增量滚动计数器，并根据提供的时间戳和增量值更新计数器的状态。它首先计算自上次更新以来
- * 经过了多少个分辨率单位（`step`），然后根据这个步数更新计数器的历史数据。如果有多个步长未被更新，
- * 则依次更新每个步长的数据，确保计数器只保留最近 `n` 个分辨率单位的数据。最后，增加当前计数值，并更新时间戳。
+ * @param counter 表示滚动计数器对象。
+ * @param ts      时间戳，以毫秒为单位
+ * @param dt      要增加的增量值。
+ */
+static inline void neu_rolling_counter_add(neu_rolling_counter_t *counter,
+                                           uint64_t ts, unsigned dt)
+{
+    uint32_t epoch = ts / counter->res;
+
+    if (dt > 0) {
+        uint64_t *slot = &counter->slots[epoch & (counter->n - 1)];
+        uint64_t  old  = __atomic_load_n(slot, __ATOMIC_RELAXED);
+        uint64_t  val  = 0;
+
+        do {
+            uint32_t slot_epoch = old >> 32;
+            if ((int32_t)(slot_epoch - epoch) >= 0) {
+                // 同一时间片；或其他线程已用更新的时间片覆盖，计入其中
+                val = (old & 0xFFFFFFFF00000000ULL) | (uint32_t)(old + dt);
+            } else {
+                val = ((uint64_t) epoch << 32) | dt;
+            }
+        } while (!__atomic_compare_exchange_n(slot, &old, val, true,
+                                              __ATOMIC_RELAXED,
+                                              __ATOMIC_RELAXED));
+    }
+
+    uint32_t last = __atomic_load_n(&counter->ts, __ATOMIC_RELAXED);
+    while ((int32_t)(epoch - last) > 0 &&
+           !__atomic_compare_exchange_n(&counter->ts, &last, epoch, true,
+                                        __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+/**
+ * @brief 增量滚动计数器并返回更新后的值。
  *
  * @param counter 表示滚动计数器对象。
  * @param ts      时间戳，以毫秒为单位
@@ -121,38 +160,17 @@ static inline void neu_rolling_counter_free(neu_rolling_counter_t *counter)
 static inline uint64_t neu_rolling_counter_inc(neu_rolling_counter_t *counter,
                                                uint64_t ts, unsigned dt)
 {
-    //计算时间步长
-    uint64_t step = (ts - counter->ts) / counter->res;
-
-    //滑动窗口更新
-    for (unsigned i = 0; i < step && i < counter->n; ++i) {
-        //更新头部位置，确保头部位置始终在 0 到 counter->n - 1 的范围内。
-        counter->hd = (counter->hd + 1) & (counter->n - 1);  
-
-        //更新累计值，将当前头部位置的计数值从累计值 val 中减去
-        counter->val -= counter->counts[counter->hd];
-
-        //重置计数值，将当前头部位置的计数值重置为 0，为新的时间间隔做准备。
-        counter->counts[counter->hd] = 0;
-    }
-
-    //增加增量值
-    counter->val += dt;
-    counter->counts[counter->hd] += dt;
-
-    //更新头部时间戳
-    counter->ts += step * counter->res;
-    
-    return counter->val;
+    neu_rolling_counter_add(counter, ts, dt);
+    return neu_rolling_counter_sum(counter, ts / counter->res);
 }
 
 /** Reset the counter.
  */
 static inline void neu_rolling_counter_reset(neu_rolling_counter_t *counter)
 {
-    counter->val = 0;
-    counter->hd  = 0;
-    memset(counter->counts, 0, counter->n * sizeof(counter->counts[0]));
+    for (unsigned i = 0; i < counter->n; ++i) {
+        __atomic_store_n(&counter->slots[i], 0, __ATOMIC_RELAXED);
+    }
 }
 
 /** Return the counter value.
@@ -161,7 +179,17 @@ static inline void neu_rolling_counter_reset(neu_rolling_counter_t *counter)
  */
 static inline uint64_t neu_rolling_counter_value(neu_rolling_counter_t *counter)
 {
-    return counter->val;
+    return neu_rolling_counter_sum(
+        counter, __atomic_load_n(&counter->ts, __ATOMIC_RELAXED));
+}
+
+/**
+ * @brief 返回时间戳 ts 时的计数器值，过期的时间片不计入。
+ */
+static inline uint64_t
+neu_rolling_counter_value_at(neu_rolling_counter_t *counter, uint64_t ts)
+{
+    return neu_rolling_counter_sum(counter, ts / counter->res);
 }
 
 #ifdef __cplusplus
@@ -25,6 +25,7 @@ extern "C" {
 
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "uthash.h"
 
@@ -85,6 +86,42 @@ static inline int neu_strset_add(neu_strset_t *set, const char *str)
     return 1;
 }
 
+/** Add a copy of the given string to the set.
+ * NOTE: Sets built with this function must be destructed by
+ *       neu_strset_free_dup.
+ * Return 1 if success, 0 if the string is already a member, -1 on error.
+ */
+static inline int neu_strset_add_dup(neu_strset_t *set, const char *str)
+{
+    if (neu_strset_test(set, str)) {
+        return 0;
+    }
+
+    char *dup = strdup(str);
+    if (NULL == dup) {
+        return -1;
+    }
+
+    int rv = neu_strset_add(set, dup);
+    if (1 != rv) {
+        free(dup);
+    }
+    return rv;
+}
+
+/** Destructs the string set together with the copied strings.
+ */
+static inline void neu_strset_free_dup(neu_strset_t *set)
+{
+    neu_strset_node_t *e = NULL, *tmp = NULL;
+    HASH_ITER(hh, *set, e, tmp)
+    {
+        HASH_DEL(*set, e);
+        free((char *) e->str);
+        free(e);
+    }
+}
+
 #ifdef __cplusplus
 }
 #endif
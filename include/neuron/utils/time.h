@@ -28,20 +28,70 @@ extern "C" {
 #include <sys/time.h>
 #include <time.h>
 
-static inline int64_t neu_time_ms()
+/**
+ * 时钟服务
+ *
+ * 所有读取均通过 clock_gettime 完成，在 Linux 上由 vDSO 提供，不陷入内核。
+ *  - neu_time_ms / neu_time_ns: 精确的墙上时间，用于标签时间戳与上报时间戳；
+ *  - neu_time_ms_coarse: 粗粒度墙上时间（精度为一个 jiffy），只读取内核已
+ *    缓存的时间，不访问硬件计数器，用于热路径上的过期判断；
+ *  - neu_time_mono_ms_coarse: 粗粒度单调时间，用于滚动计数器、限频等只关心
+ *    时间差的场景；
+ *  - neu_time_mono_ns: 精确单调时间，用于耗时统计。
+ *
+ * 平台不支持 *_COARSE 时钟时退化为对应的精确时钟。
+ */
+#ifdef CLOCK_REALTIME_COARSE
+#define NEU_CLOCK_REALTIME_COARSE CLOCK_REALTIME_COARSE
+#else
+#define NEU_CLOCK_REALTIME_COARSE CLOCK_REALTIME
+#endif
+
+#ifdef CLOCK_MONOTONIC_COARSE
+#define NEU_CLOCK_MONOTONIC_COARSE CLOCK_MONOTONIC_COARSE
+#else
+#define NEU_CLOCK_MONOTONIC_COARSE CLOCK_MONOTONIC
+#endif
+
+static inline int64_t neu_clock_ms(clockid_t clock)
 {
-    struct timeval tv = { 0 };
-    gettimeofday(&tv, NULL);
-    return (int64_t) tv.tv_sec * 1000 + (int64_t) tv.tv_usec / 1000;
+    struct timespec ts = { 0 };
+    clock_gettime(clock, &ts);
+    return (int64_t) ts.tv_sec * 1000 + (int64_t) ts.tv_nsec / 1000000;
 }
 
-static inline int64_t neu_time_ns()
+static inline int64_t neu_clock_ns(clockid_t clock)
 {
     struct timespec ts = { 0 };
-    clock_gettime(CLOCK_REALTIME, &ts);
+    clock_gettime(clock, &ts);
     return (int64_t) ts.tv_sec * 1000000000 + (int64_t) ts.tv_nsec;
 }
 
+static inline int64_t neu_time_ms()
+{
+    return neu_clock_ms(CLOCK_REALTIME);
+}
+
+static inline int64_t neu_time_ns()
+{
+    return neu_clock_ns(CLOCK_REALTIME);
+}
+
+static inline int64_t neu_time_ms_coarse()
+{
+    return neu_clock_ms(NEU_CLOCK_REALTIME_COARSE);
+}
+
+static inline int64_t neu_time_mono_ms_coarse()
+{
+    return neu_clock_ms(NEU_CLOCK_MONOTONIC_COARSE);
+}
+
+static inline int64_t neu_time_mono_ns()
+{
+    return neu_clock_ns(CLOCK_MONOTONIC);
+}
+
 static inline void neu_msleep(unsigned msec)
 {
     struct timespec tv = {
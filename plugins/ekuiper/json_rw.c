@@ -159,7 +159,7 @@ int json_encode_read_resp(void *json_object, void *param)
 
     json_read_resp_header_t header = { .group_name = trans_data->group,
                                        .node_name  = trans_data->driver,
-                                       .timestamp  = global_timestamp };
+                                       .timestamp  = neu_time_ms() };
 
     ret = json_encode_read_resp_header(json_object, &header);
     if (0 != ret) {
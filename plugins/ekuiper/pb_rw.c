@@ -0,0 +1,197 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "neuron.h"
+
+#include "pb_rw.h"
+#include "ptformat.pb-c.h"
+
+static void set_int(Model__DataItem *item, Model__DataItemValue *value,
+                    int64_t v)
+{
+    item->item_case   = MODEL__DATA_ITEM__ITEM_VALUE;
+    item->value       = value;
+    value->value_case = MODEL__DATA_ITEM_VALUE__VALUE_INT_VALUE;
+    value->int_value  = v;
+}
+
+static void set_float(Model__DataItem *item, Model__DataItemValue *value,
+                      float v)
+{
+    item->item_case    = MODEL__DATA_ITEM__ITEM_VALUE;
+    item->value        = value;
+    value->value_case  = MODEL__DATA_ITEM_VALUE__VALUE_FLOAT_VALUE;
+    value->float_value = v;
+}
+
+static void wrap_tag(Model__DataItem *item, Model__DataItemValue *value,
+                     neu_resp_tag_value_meta_t *tag_value)
+{
+    neu_value_u *v = &tag_value->value.value;
+
+    model__data_item__init(item);
+    model__data_item_value__init(value);
+    item->name = tag_value->tag;
+
+    switch (tag_value->value.type) {
+    case NEU_TYPE_ERROR:
+        item->item_case = MODEL__DATA_ITEM__ITEM_ERROR;
+        item->error     = v->i32;
+        break;
+    case NEU_TYPE_BIT:
+    case NEU_TYPE_UINT8:
+        set_int(item, value, v->u8);
+        break;
+    case NEU_TYPE_INT8:
+        set_int(item, value, v->i8);
+        break;
+    case NEU_TYPE_INT16:
+        set_int(item, value, v->i16);
+        break;
+    case NEU_TYPE_WORD:
+    case NEU_TYPE_UINT16:
+        set_int(item, value, v->u16);
+        break;
+    case NEU_TYPE_INT32:
+        set_int(item, value, v->i32);
+        break;
+    case NEU_TYPE_DWORD:
+    case NEU_TYPE_UINT32:
+        set_int(item, value, v->u32);
+        break;
+    case NEU_TYPE_INT64:
+        set_int(item, value, v->i64);
+        break;
+    case NEU_TYPE_LWORD:
+    case NEU_TYPE_UINT64:
+        set_int(item, value, (int64_t) v->u64);
+        break;
+    case NEU_TYPE_FLOAT:
+        set_float(item, value, v->f32);
+        break;
+    case NEU_TYPE_DOUBLE:
+        set_float(item, value, (float) v->d64);
+        break;
+    case NEU_TYPE_BOOL:
+        item->item_case   = MODEL__DATA_ITEM__ITEM_VALUE;
+        item->value       = value;
+        value->value_case = MODEL__DATA_ITEM_VALUE__VALUE_BOOL_VALUE;
+        value->bool_value = v->boolean;
+        break;
+    case NEU_TYPE_STRING:
+        item->item_case     = MODEL__DATA_ITEM__ITEM_VALUE;
+        item->value         = value;
+        value->value_case   = MODEL__DATA_ITEM_VALUE__VALUE_STRING_VALUE;
+        value->string_value = v->str;
+        break;
+    default:
+        // 数组等类型在 DataReport 中没有对应的值，仅上报点位名
+        break;
+    }
+
+    for (int i = 0; i < NEU_TAG_META_SIZE; i++) {
+        if (0 == strlen(tag_value->metas[i].name)) {
+            break;
+        }
+        if (0 == strcmp(tag_value->metas[i].name, "q")) {
+            item->has_q = true;
+            item->q     = tag_value->metas[i].value.value.i32;
+        } else if (0 == strcmp(tag_value->metas[i].name, "t")) {
+            item->has_t = true;
+            item->t     = tag_value->metas[i].value.value.i64;
+        }
+    }
+}
+
+int pb_encode_read_resp(neu_reqresp_trans_data_t *trans_data, uint8_t **buf,
+                        size_t *len)
+{
+    Model__DataReport     report = MODEL__DATA_REPORT__INIT;
+    size_t                n_tag  = utarray_len(trans_data->tags);
+    Model__DataItem *     items  = NULL;
+    Model__DataItemValue *values = NULL;
+    Model__DataItem **    tags   = NULL;
+    int                   ret    = -1;
+
+    // 点位一次性分配，避免逐个 calloc
+    if (n_tag > 0) {
+        items  = calloc(n_tag, sizeof(Model__DataItem));
+        values = calloc(n_tag, sizeof(Model__DataItemValue));
+        tags   = calloc(n_tag, sizeof(Model__DataItem *));
+        if (NULL == items || NULL == values || NULL == tags) {
+            goto end;
+        }
+    }
+
+    size_t index = 0;
+    utarray_foreach(trans_data->tags, neu_resp_tag_value_meta_t *, tag_value)
+    {
+        wrap_tag(&items[index], &values[index], tag_value);
+        tags[index] = &items[index];
+        index++;
+    }
+
+    report.node      = trans_data->driver;
+    report.group     = trans_data->group;
+    report.timestamp = neu_time_ms();
+    report.n_tags    = n_tag;
+    report.tags      = tags;
+
+    *len = model__data_report__get_packed_size(&report);
+    *buf = malloc(*len > 0 ? *len : 1);
+    if (NULL == *buf) {
+        goto end;
+    }
+    model__data_report__pack(&report, *buf);
+    ret = 0;
+
+end:
+    free(tags);
+    free(values);
+    free(items);
+    return ret;
+}
+
+size_t pb_report_frame_size(size_t len)
+{
+    size_t n = 1;
+    for (size_t v = len; v >= 0x80; v >>= 7) {
+        n++;
+    }
+    return 1 + n + len;
+}
+
+size_t pb_report_frame(uint8_t *dst, const uint8_t *report, size_t len)
+{
+    uint8_t *p = dst;
+
+    *p++ = PB_DATA_REPORTS_KEY;
+    for (size_t v = len;; v >>= 7) {
+        if (v < 0x80) {
+            *p++ = (uint8_t) v;
+            break;
+        }
+        *p++ = (uint8_t)(v | 0x80);
+    }
+    memcpy(p, report, len);
+    return (size_t)(p - dst) + len;
+}
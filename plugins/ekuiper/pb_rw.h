@@ -0,0 +1,71 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+#ifndef NEURON_PLUGIN_EKUIPER_PB_RW_H
+#define NEURON_PLUGIN_EKUIPER_PB_RW_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "neuron.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * protobuf 格式下每条消息都是若干个 MQTT ptformat.proto 中的 DataReport，
+ * 线格式等价于:
+ *
+ *     message DataReports {
+ *         repeated DataReport reports = 2;
+ *     }
+ *
+ * 字段号取 2，使消息首字节 (0x12) 不会与追踪头魔数 0x0A 0xCE 混淆。
+ */
+#define PB_DATA_REPORTS_KEY 0x12
+
+/**
+ * @brief 将一个组的上报数据编码为 DataReport。
+ *
+ * @param trans_data 组上报数据。
+ * @param buf 输出编码结果，由调用者 free。
+ * @param len 输出编码长度。
+ * @return 成功返回 0，失败返回 -1。
+ */
+int pb_encode_read_resp(neu_reqresp_trans_data_t *trans_data, uint8_t **buf,
+                        size_t *len);
+
+/**
+ * @brief 计算以 DataReports 字段封装 len 字节的 DataReport 所需的长度。
+ */
+size_t pb_report_frame_size(size_t len);
+
+/**
+ * @brief 以 DataReports 字段封装一条 DataReport 写入 dst。
+ *
+ * @return 写入的字节数，等于 pb_report_frame_size(len)。
+ */
+size_t pb_report_frame(uint8_t *dst, const uint8_t *report, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
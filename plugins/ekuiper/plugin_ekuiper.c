@@ -31,6 +31,9 @@
 
 #define EKUIPER_PLUGIN_URL "tcp://127.0.0.1:7081"
 
+// 积压留在插件的发送队列中以便合并，套接字只保留少量缓冲
+#define EKUIPER_SOCKET_SENDBUF 16
+
 const neu_plugin_module_t neu_plugin_module;
 
 static neu_plugin_t *ekuiper_plugin_open(void)
@@ -96,16 +99,53 @@ static void pipe_rm_cb(nng_pipe p, nng_pipe_ev ev, void *arg)
     plugin->common.link_state = NEU_NODE_LINK_STATE_DISCONNECTED;
     nng_mtx_unlock(plugin->mtx);
 
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_DISCONNECTION_60S, 1, NULL);
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_DISCONNECTION_600S, 1, NULL);
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_DISCONNECTION_1800S, 1, NULL);
+    neu_metric_handles_update(plugin->metrics.disconnection, 3, 1);
+}
+
+#define METRIC_HANDLE(name) NEU_PLUGIN_METRIC_HANDLE(plugin, name, NULL)
+
+/**
+ * @brief 解析数据路径上更新的度量项句柄。
+ *
+ * 发送、接收总数由适配器注册，仅在节点可见时存在，对应句柄可能为 NULL。
+ */
+static void resolve_metrics(neu_plugin_t *plugin)
+{
+    plugin->metrics.trans_data[0] = METRIC_HANDLE(NEU_METRIC_TRANS_DATA_5S);
+    plugin->metrics.trans_data[1] = METRIC_HANDLE(NEU_METRIC_TRANS_DATA_30S);
+    plugin->metrics.trans_data[2] = METRIC_HANDLE(NEU_METRIC_TRANS_DATA_60S);
+    plugin->metrics.send_msgs_total =
+        METRIC_HANDLE(NEU_METRIC_SEND_MSGS_TOTAL);
+    plugin->metrics.send_msg_errors_total =
+        METRIC_HANDLE(NEU_METRIC_SEND_MSG_ERRORS_TOTAL);
+    plugin->metrics.send_msg_drops_total =
+        METRIC_HANDLE(NEU_METRIC_SEND_MSG_DROPS_TOTAL);
+    plugin->metrics.send_queue_size = METRIC_HANDLE(NEU_METRIC_SEND_QUEUE_SIZE);
+    plugin->metrics.send_bytes[0] = METRIC_HANDLE(NEU_METRIC_SEND_BYTES_5S);
+    plugin->metrics.send_bytes[1] = METRIC_HANDLE(NEU_METRIC_SEND_BYTES_30S);
+    plugin->metrics.send_bytes[2] = METRIC_HANDLE(NEU_METRIC_SEND_BYTES_60S);
+    plugin->metrics.recv_msgs_total =
+        METRIC_HANDLE(NEU_METRIC_RECV_MSGS_TOTAL);
+    plugin->metrics.recv_bytes[0] = METRIC_HANDLE(NEU_METRIC_RECV_BYTES_5S);
+    plugin->metrics.recv_bytes[1] = METRIC_HANDLE(NEU_METRIC_RECV_BYTES_30S);
+    plugin->metrics.recv_bytes[2] = METRIC_HANDLE(NEU_METRIC_RECV_BYTES_60S);
+    plugin->metrics.recv_msgs[0]  = METRIC_HANDLE(NEU_METRIC_RECV_MSGS_5S);
+    plugin->metrics.recv_msgs[1]  = METRIC_HANDLE(NEU_METRIC_RECV_MSGS_30S);
+    plugin->metrics.recv_msgs[2]  = METRIC_HANDLE(NEU_METRIC_RECV_MSGS_60S);
+    plugin->metrics.disconnection[0] =
+        METRIC_HANDLE(NEU_METRIC_DISCONNECTION_60S);
+    plugin->metrics.disconnection[1] =
+        METRIC_HANDLE(NEU_METRIC_DISCONNECTION_600S);
+    plugin->metrics.disconnection[2] =
+        METRIC_HANDLE(NEU_METRIC_DISCONNECTION_1800S);
 }
 
 /**
  * @brief 初始化 eKuiper 插件。
  *
- * 该函数用于对 eKuiper 插件进行初始化操作，包括分配互斥锁、异步 I/O 对象，
- * 以及注册多个指标。如果在初始化过程中出现错误，函数会记录错误日志并返回相应的错误码。
+ * 该函数用于对 eKuiper 插件进行初始化操作，包括分配互斥锁、收发异步 I/O
+ * 对象，以及注册多个指标。如果在初始化过程中出现错误，函数会记录错误日志
+ * 并返回相应的错误码。
  *
  * @param plugin 指向 neu_plugin_t 结构体的指针，代表要初始化的插件。
  * @param load 一个布尔值，指示是否加载插件。在本函数中该参数未被使用。
@@ -116,6 +156,7 @@ static int ekuiper_plugin_init(neu_plugin_t *plugin, bool load)
     (void) load;
     int      rv       = 0;
     nng_aio *recv_aio = NULL;
+    nng_aio *send_aio = NULL;
 
     // 初始化插件的互斥锁
     plugin->mtx = NULL;
@@ -134,8 +175,22 @@ static int ekuiper_plugin_init(neu_plugin_t *plugin, bool load)
         return rv;
     }
 
+    rv = nng_aio_alloc(&send_aio, send_data_callback, plugin);
+    if (rv < 0) {
+        plog_error(plugin, "cannot allocate send_aio: %s", nng_strerror(rv));
+        nng_aio_free(recv_aio);
+        nng_mtx_free(plugin->mtx);
+        plugin->mtx = NULL;
+        return rv;
+    }
+
     // 将分配的异步 I/O 对象赋值给插件
     plugin->recv_aio = recv_aio;
+    plugin->send_aio = send_aio;
+
+    plugin->format          = EKUIPER_FORMAT_JSON;
+    plugin->batch_size      = EKUIPER_BATCH_SIZE_DEFAULT;
+    plugin->send_queue_size = EKUIPER_SEND_QUEUE_SIZE_DEFAULT;
 
     // 注册多个指标，用于监控数据传输、字节数、消息数和断开连接情况
     NEU_PLUGIN_REGISTER_METRIC(plugin, NEU_METRIC_TRANS_DATA_5S, 5000);
@@ -153,6 +208,9 @@ static int ekuiper_plugin_init(neu_plugin_t *plugin, bool load)
     NEU_PLUGIN_REGISTER_METRIC(plugin, NEU_METRIC_DISCONNECTION_60S, 60000);
     NEU_PLUGIN_REGISTER_METRIC(plugin, NEU_METRIC_DISCONNECTION_600S, 600000);
     NEU_PLUGIN_REGISTER_METRIC(plugin, NEU_METRIC_DISCONNECTION_1800S, 1800000);
+    NEU_PLUGIN_REGISTER_METRIC(plugin, NEU_METRIC_SEND_MSG_DROPS_TOTAL, 0);
+    NEU_PLUGIN_REGISTER_METRIC(plugin, NEU_METRIC_SEND_QUEUE_SIZE, 0);
+    resolve_metrics(plugin);
 
     plog_notice(plugin, "plugin initialized");
     return rv;
@@ -163,6 +221,8 @@ static int ekuiper_plugin_uninit(neu_plugin_t *plugin)
     int rv = 0;
 
     nng_close(plugin->sock);
+    send_queue_drain(plugin);
+    nng_aio_free(plugin->send_aio);
     nng_aio_free(plugin->recv_aio);
     nng_mtx_free(plugin->mtx);
     free(plugin->host);
@@ -209,8 +269,8 @@ static inline int start(neu_plugin_t *plugin, const char *url)
     // 设置管道移除事件的通知回调函数
     nng_pipe_notify(plugin->sock, NNG_PIPE_EV_REM_POST, pipe_rm_cb, plugin);
 
-    // 设置套接字的发送缓冲区大小为 2048 字节
-    nng_socket_set_int(plugin->sock, NNG_OPT_SENDBUF, 2048);
+    // 设置套接字的发送缓冲区大小
+    nng_socket_set_int(plugin->sock, NNG_OPT_SENDBUF, EKUIPER_SOCKET_SENDBUF);
 
     // 设置套接字的接收缓冲区大小为 2048 字节
     nng_socket_set_int(plugin->sock, NNG_OPT_RECVBUF, 2048);
@@ -282,6 +342,7 @@ static int ekuiper_plugin_start(neu_plugin_t *plugin)
 static inline void stop(neu_plugin_t *plugin)
 {
     nng_close(plugin->sock);
+    send_queue_drain(plugin);
 }
 
 static int ekuiper_plugin_stop(neu_plugin_t *plugin)
@@ -292,6 +353,68 @@ static int ekuiper_plugin_stop(neu_plugin_t *plugin)
     return NEU_ERR_SUCCESS;
 }
 
+/**
+ * @brief 解析发送相关的可选配置，缺省时使用默认值。
+ */
+static int parse_send_config(neu_plugin_t *plugin, const char *setting,
+                             ekuiper_format_e *format_p, uint16_t *batch_p,
+                             uint32_t *queue_p)
+{
+    neu_json_elem_t format     = { .name      = "format",
+                                   .t         = NEU_JSON_INT,
+                                   .v.val_int = EKUIPER_FORMAT_JSON };
+    neu_json_elem_t batch_size = { .name      = "batch_size",
+                                   .t         = NEU_JSON_INT,
+                                   .v.val_int = EKUIPER_BATCH_SIZE_DEFAULT };
+    neu_json_elem_t queue_size = {
+        .name      = "send_queue_size",
+        .t         = NEU_JSON_INT,
+        .v.val_int = EKUIPER_SEND_QUEUE_SIZE_DEFAULT,
+    };
+
+    // format, optional, default to json
+    if (0 != neu_parse_param(setting, NULL, 1, &format)) {
+        format.v.val_int = EKUIPER_FORMAT_JSON;
+    }
+    if (EKUIPER_FORMAT_JSON != format.v.val_int &&
+        EKUIPER_FORMAT_PROTOBUF != format.v.val_int) {
+        plog_error(plugin, "setting invalid format: %" PRIi64,
+                   format.v.val_int);
+        return -1;
+    }
+
+    // batch_size, optional, default to 1
+    if (0 != neu_parse_param(setting, NULL, 1, &batch_size)) {
+        batch_size.v.val_int = EKUIPER_BATCH_SIZE_DEFAULT;
+    }
+    if (batch_size.v.val_int < 1 ||
+        batch_size.v.val_int > EKUIPER_BATCH_SIZE_MAX) {
+        plog_error(plugin, "setting invalid batch_size: %" PRIi64,
+                   batch_size.v.val_int);
+        return -1;
+    }
+
+    // send_queue_size, optional
+    if (0 != neu_parse_param(setting, NULL, 1, &queue_size)) {
+        queue_size.v.val_int = EKUIPER_SEND_QUEUE_SIZE_DEFAULT;
+    }
+    if (queue_size.v.val_int < 1 ||
+        queue_size.v.val_int > EKUIPER_SEND_QUEUE_SIZE_MAX) {
+        plog_error(plugin, "setting invalid send_queue_size: %" PRIi64,
+                   queue_size.v.val_int);
+        return -1;
+    }
+
+    *format_p = format.v.val_int;
+    *batch_p  = batch_size.v.val_int;
+    *queue_p  = queue_size.v.val_int;
+
+    plog_notice(plugin, "config format:%d batch_size:%" PRIu16
+                        " send_queue_size:%" PRIu32,
+                *format_p, *batch_p, *queue_p);
+    return 0;
+}
+
 static int parse_config(neu_plugin_t *plugin, const char *setting,
                         char **host_p, uint16_t *port_p)
 {
@@ -348,10 +471,13 @@ error:
  */
 static int ekuiper_plugin_config(neu_plugin_t *plugin, const char *setting)
 {
-    int      rv   = 0;
-    char *   url  = NULL;
-    char *   host = NULL;
-    uint16_t port = 0;
+    int              rv         = 0;
+    char *           url        = NULL;
+    char *           host       = NULL;
+    uint16_t         port       = 0;
+    ekuiper_format_e format     = EKUIPER_FORMAT_JSON;
+    uint16_t         batch_size = 0;
+    uint32_t         queue_size = 0;
 
     // 解析配置信息，获取主机名和端口号
     if (0 != parse_config(plugin, setting, &host, &port)) {
@@ -359,6 +485,13 @@ static int ekuiper_plugin_config(neu_plugin_t *plugin, const char *setting)
         goto error;
     }
 
+    // 解析发送格式、批量大小与发送队列长度
+    if (0 != parse_send_config(plugin, setting, &format, &batch_size,
+                               &queue_size)) {
+        rv = NEU_ERR_NODE_SETTING_INVALID;
+        goto error;
+    }
+
     // 根据主机名和端口号生成 URL
     neu_asprintf(&url, "tcp://%s:%" PRIu16, host, port);
     if (NULL == url) {
@@ -396,6 +529,13 @@ static int ekuiper_plugin_config(neu_plugin_t *plugin, const char *setting)
     plugin->port = port;
     plugin->url  = url;
 
+    // 已入队的组上报保留各自的编码格式，新格式只作用于之后的上报
+    nng_mtx_lock(plugin->mtx);
+    plugin->format          = format;
+    plugin->batch_size      = batch_size;
+    plugin->send_queue_size = queue_size;
+    nng_mtx_unlock(plugin->mtx);
+
     return rv;
 
 error:
@@ -492,16 +632,45 @@ static int ekuiper_plugin_request(neu_plugin_t *      plugin,
         }
         break;
     }
+    case NEU_RESP_WRITE_TAGS: {
+        neu_resp_write_tags_t *resp  = (neu_resp_write_tags_t *) data;
+        int                    error = NEU_ERR_SUCCESS;
+
+        // 驱动按点位返回写结果，取第一个失败点位的错误码
+        utarray_foreach(resp->tags, neu_resp_write_tags_ele_t *, ele)
+        {
+            if (ele->error != NEU_ERR_SUCCESS) {
+                plog_debug(plugin, "write %s:%s errcode: %d", ele->group,
+                           ele->tag, ele->error);
+                if (error == NEU_ERR_SUCCESS) {
+                    error = ele->error;
+                }
+            }
+        }
+        plog_debug(plugin, "receive resp errcode: %d", error);
+        if (trace) {
+            if (error != NEU_ERR_SUCCESS) {
+                neu_otel_scope_set_status_code2(scope, NEU_OTEL_STATUS_ERROR,
+                                                error);
+            } else {
+                neu_otel_scope_set_status_code2(scope, NEU_OTEL_STATUS_OK,
+                                                error);
+            }
+            neu_otel_scope_set_span_end_time(scope, neu_time_ns());
+            neu_otel_trace_set_final(trace);
+        }
+        utarray_free(resp->tags);
+        if (header->ctx) {
+            free(header->ctx);
+        }
+        break;
+    }
     case NEU_REQRESP_TRANS_DATA: {
         neu_reqresp_trans_data_t *trans_data = data;
 
         if (plugin->started) {
             // 更新不同时间窗口的传输数据指标
-            NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_TRANS_DATA_5S, 1, NULL);
-            NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_TRANS_DATA_30S, 1,
-                                     NULL);
-            NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_TRANS_DATA_60S, 1,
-                                     NULL);
+            neu_metric_handles_update(plugin->metrics.trans_data, 3, 1);
         }
 
         if (disconnected) {
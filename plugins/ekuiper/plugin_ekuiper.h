@@ -27,11 +27,41 @@
 #include <nng/supplemental/util/platform.h>
 
 #include "neuron.h"
+#include "otel/otel_manager.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+// 上报数据的编码格式
+typedef enum {
+    EKUIPER_FORMAT_JSON     = 0,
+    EKUIPER_FORMAT_PROTOBUF = 1,
+} ekuiper_format_e;
+
+#define EKUIPER_BATCH_SIZE_DEFAULT 1
+#define EKUIPER_BATCH_SIZE_MAX 1000
+#define EKUIPER_SEND_QUEUE_SIZE_DEFAULT 1024
+#define EKUIPER_SEND_QUEUE_SIZE_MAX 65535
+
+// 追踪头: 2 字节魔数 + 16 字节 trace id + 8 字节 span id
+#define EKUIPER_TRACE_HEADER_LEN 26
+
+/**
+ * @brief 发送队列中的一个组上报，payload 为单个组的编码结果。
+ */
+typedef struct ekuiper_send_item {
+    ekuiper_format_e   format; // 入队时的编码格式，不随之后的配置变化
+    uint8_t *          payload;
+    size_t             len;
+    neu_otel_trace_ctx trace;
+    neu_otel_scope_ctx scope;
+    uint8_t            trace_header[EKUIPER_TRACE_HEADER_LEN];
+
+    struct ekuiper_send_item *prev;
+    struct ekuiper_send_item *next;
+} ekuiper_send_item_t;
+
 /**
  * @brief 表示ekuiper插件的结构体
  *
@@ -48,6 +78,33 @@ struct neu_plugin {
     char *              host;
     uint16_t            port;
     char *              url;
+
+    ekuiper_format_e format;
+    uint16_t         batch_size;
+    uint32_t         send_queue_size;
+
+    // 发送管线，均由 mtx 保护。queue 为待发送的组上报，inflight 为
+    // send_aio 正在发送的消息所包含的组上报
+    nng_aio *            send_aio;
+    bool                 sending;
+    ekuiper_send_item_t *queue;
+    size_t               queue_len;
+    ekuiper_send_item_t *inflight;
+    size_t               inflight_bytes;
+
+    // 初始化时解析的度量项句柄，三个元素对应同一指标的三个时间窗口
+    struct {
+        neu_metric_handle_t *trans_data[3];
+        neu_metric_handle_t *send_msgs_total;
+        neu_metric_handle_t *send_msg_errors_total;
+        neu_metric_handle_t *send_msg_drops_total;
+        neu_metric_handle_t *send_queue_size;
+        neu_metric_handle_t *send_bytes[3];
+        neu_metric_handle_t *recv_msgs_total;
+        neu_metric_handle_t *recv_bytes[3];
+        neu_metric_handle_t *recv_msgs[3];
+        neu_metric_handle_t *disconnection[3];
+    } metrics;
 };
 
 #ifdef __cplusplus
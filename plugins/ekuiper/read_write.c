@@ -21,10 +21,12 @@
 
 #include "neuron.h"
 #include "otel/otel_manager.h"
+#include "utils/utlist.h"
 #include "json/neu_json_fn.h"
 #include "json/neu_json_rw.h"
 
 #include "json_rw.h"
+#include "pb_rw.h"
 #include "read_write.h"
 
 static int send_write_tag_req(neu_plugin_t *plugin, neu_json_write_req_t *req,
@@ -84,31 +86,207 @@ static void binary_to_hex(const unsigned char *binary, size_t length, char *hex)
 }
 
 /**
- * @brief 发送数据到指定的插件
+ * @brief 结束一个组上报的发送，记录追踪状态并释放内存。
  *
- * 此函数用于将传输数据编码为 JSON 格式，并通过网络套接字发送出去。
- * 同时，它还支持 OpenTelemetry 跟踪，可记录数据发送操作的详细信息。
+ * @param rv 发送结果，0 表示成功，否则为 NNG 错误码。
+ * @param reason 失败原因，为 NULL 时使用 rv 对应的错误描述。
+ */
+static void send_item_finish(ekuiper_send_item_t *item, int rv,
+                             const char *reason)
+{
+    if (item->trace) {
+        if (0 == rv) {
+            neu_otel_scope_set_status_code2(item->scope, NEU_OTEL_STATUS_OK,
+                                            0);
+        } else {
+            neu_otel_scope_set_status_code(
+                item->scope, NEU_OTEL_STATUS_ERROR,
+                reason ? reason : nng_strerror(rv));
+        }
+        neu_otel_scope_set_span_end_time(item->scope, neu_time_ns());
+        neu_otel_trace_set_final(item->trace);
+    }
+
+    free(item->payload);
+    free(item);
+}
+
+static void send_items_finish(ekuiper_send_item_t *items, int rv,
+                              const char *reason)
+{
+    ekuiper_send_item_t *item = NULL;
+    ekuiper_send_item_t *tmp  = NULL;
+
+    DL_FOREACH_SAFE(items, item, tmp)
+    {
+        DL_DELETE(items, item);
+        send_item_finish(item, rv, reason);
+    }
+}
+
+/**
+ * @brief 计算一个组上报在消息中占用的字节数。
+ */
+static size_t send_item_size(ekuiper_send_item_t *item)
+{
+    if (EKUIPER_FORMAT_PROTOBUF == item->format) {
+        return pb_report_frame_size(item->len);
+    }
+    return item->len;
+}
+
+/**
+ * @brief 从发送队列头部取出若干组上报合并为一条消息，并启动异步发送。
  *
- * @param plugin 指向 `neu_plugin_t` 结构体的指针，代表要发送数据的插件。
- * @param trans_data 指向 `neu_reqresp_trans_data_t` 结构体的指针，包含要发送的传输数据。
+ * 调用者需持有 plugin->mtx。带追踪头的组上报单独成一条消息，其余按
+ * batch_size 合并编码格式相同的组上报：JSON 格式在 batch_size 大于 1 时为
+ * 数组，protobuf 格式总是以 DataReports 封装。队列为空时清除 sending 标志。
  */
-void send_data(neu_plugin_t *plugin, neu_reqresp_trans_data_t *trans_data)
+static void send_next(neu_plugin_t *plugin)
 {
-    int rv = 0;
+    while (NULL != plugin->queue) {
+        ekuiper_send_item_t *item   = NULL;
+        ekuiper_send_item_t *tmp    = NULL;
+        ekuiper_send_item_t *items  = NULL;
+        nng_msg *            msg    = NULL;
+        ekuiper_format_e     format = plugin->queue->format;
+        bool                 traced = NULL != plugin->queue->trace;
+        bool                 array =
+            EKUIPER_FORMAT_JSON == format && plugin->batch_size > 1;
+        size_t n   = 0;
+        size_t len = traced ? EKUIPER_TRACE_HEADER_LEN : 0;
+
+        DL_FOREACH(plugin->queue, item)
+        {
+            if (n > 0 &&
+                (n == plugin->batch_size || NULL != item->trace ||
+                 format != item->format)) {
+                break;
+            }
+            len += send_item_size(item);
+            n++;
+            if (traced) {
+                break;
+            }
+        }
+        if (array) {
+            // '[' ']' 以及 n - 1 个 ','
+            len += n + 1;
+        }
 
-    // 用于存储编码后的 JSON 字符串
-    char *           json_str = NULL;
+        DL_FOREACH_SAFE(plugin->queue, item, tmp)
+        {
+            if (0 == n--) {
+                break;
+            }
+            DL_DELETE(plugin->queue, item);
+            DL_APPEND(items, item);
+            plugin->queue_len--;
+        }
+        neu_metric_handle_update(plugin->metrics.send_queue_size,
+                                 plugin->queue_len);
+
+        int rv = nng_msg_alloc(&msg, len);
+        if (0 != rv) {
+            plog_error(plugin, "nng cannot allocate msg");
+            neu_metric_handle_update(plugin->metrics.send_msg_errors_total,
+                                     1);
+            send_items_finish(items, rv, NULL);
+            continue;
+        }
+
+        uint8_t *p = nng_msg_body(msg);
+        if (traced) {
+            memcpy(p, items->trace_header, EKUIPER_TRACE_HEADER_LEN);
+            p += EKUIPER_TRACE_HEADER_LEN;
+        }
+        if (array) {
+            *p++ = '[';
+        }
+        DL_FOREACH(items, item)
+        {
+            if (EKUIPER_FORMAT_PROTOBUF == format) {
+                p += pb_report_frame(p, item->payload, item->len);
+            } else {
+                if (array && item != items) {
+                    *p++ = ',';
+                }
+                memcpy(p, item->payload, item->len); // no null byte
+                p += item->len;
+            }
+            // 编码结果已拷贝，仅保留追踪信息直到发送完成
+            free(item->payload);
+            item->payload = NULL;
+        }
+        if (array) {
+            *p++ = ']';
+        }
+
+        plugin->inflight       = items;
+        plugin->inflight_bytes = len;
+        plugin->sending        = true;
+        nng_aio_set_msg(plugin->send_aio, msg);
+        nng_send_aio(plugin->sock, plugin->send_aio);
+        return;
+    }
 
-    // 用于 JSON 编码的响应结构体
+    plugin->sending = false;
+}
+
+/**
+ * @brief 将组上报编码为 item->format 格式，结果保存在 item->payload 中。
+ */
+static int send_item_encode(neu_plugin_t *            plugin,
+                            neu_reqresp_trans_data_t *trans_data,
+                            ekuiper_send_item_t *     item)
+{
+    if (EKUIPER_FORMAT_PROTOBUF == item->format) {
+        if (0 != pb_encode_read_resp(trans_data, &item->payload, &item->len)) {
+            plog_error(plugin, "fail encode trans data to protobuf");
+            return -1;
+        }
+        plog_debug(plugin, ">> protobuf %s:%s %zu bytes", trans_data->driver,
+                   trans_data->group, item->len);
+        return 0;
+    }
+
+    char *           json_str = NULL;
     json_read_resp_t resp     = {
         .plugin     = plugin,
         .trans_data = trans_data,
     };
 
+    int rv = neu_json_encode_by_fn(&resp, json_encode_read_resp, &json_str);
+    if (0 != rv || json_str == NULL) {
+        plog_error(plugin, "fail encode trans data to json");
+        return -1;
+    }
+
+    item->payload = (uint8_t *) json_str;
+    item->len     = strlen(json_str);
+    plog_debug(plugin, ">> json %s:%s %zu bytes", trans_data->driver,
+               trans_data->group, item->len);
+    return 0;
+}
+
+/**
+ * @brief 发送数据到指定的插件
+ *
+ * 此函数将传输数据编码为 JSON 或 protobuf 格式后放入有界的发送队列，
+ * 由 send_aio 异步发送。队列已满时丢弃最早的组上报并更新丢弃计数。
+ * 同时，它还支持 OpenTelemetry 跟踪，跨度在发送完成或被丢弃时结束。
+ *
+ * @param plugin 指向 `neu_plugin_t` 结构体的指针，代表要发送数据的插件。
+ * @param trans_data 指向 `neu_reqresp_trans_data_t` 结构体的指针，包含要发送的传输数据。
+ */
+void send_data(neu_plugin_t *plugin, neu_reqresp_trans_data_t *trans_data)
+{
+    ekuiper_send_item_t *item    = NULL;
+    ekuiper_send_item_t *dropped = NULL;
+
     // OpenTelemetry 跟踪相关变量
     neu_otel_trace_ctx trans_trace     = NULL;
     neu_otel_scope_ctx trans_scope     = NULL;
-    uint8_t *          trace_id        = NULL;
     char               new_span_id[36] = { 0 };
 
     // 检查 OpenTelemetry 数据跟踪是否启用，并且传输数据包含跟踪上下文
@@ -131,105 +309,137 @@ void send_data(neu_plugin_t *plugin, neu_reqresp_trans_data_t *trans_data)
         }
     }
 
-    // 执行数据发送操作的主循环，仅执行一次
-    do {
-        // 将传输数据编码为 JSON 字符串
-        rv = neu_json_encode_by_fn(&resp, json_encode_read_resp, &json_str);
-        if (0 != rv || json_str == NULL) {
-            plog_error(plugin, "fail encode trans data to json");
-            break;
+    item = calloc(1, sizeof(ekuiper_send_item_t));
+    if (NULL == item) {
+        plog_error(plugin, "cannot allocate send item");
+        neu_metric_handle_update(plugin->metrics.send_msg_errors_total, 1);
+        if (trans_trace) {
+            neu_otel_scope_set_status_code(trans_scope, NEU_OTEL_STATUS_ERROR,
+                                           "out of memory");
+            neu_otel_scope_set_span_end_time(trans_scope, neu_time_ns());
+            neu_otel_trace_set_final(trans_trace);
         }
+        return;
+    }
 
-        // 存储要发送的消息
-        nng_msg *msg              = NULL;
-
-        // 获取 JSON 字符串的长度
-        size_t   json_len         = strlen(json_str);
+    item->trace = trans_trace;
+    item->scope = trans_scope;
 
-        // 跟踪头部的长度
-        size_t   trace_header_len = 0;
+    // 配置可能在其他线程中更新，编码格式在加锁时读取并随组上报保存
+    nng_mtx_lock(plugin->mtx);
+    item->format = plugin->format;
+    nng_mtx_unlock(plugin->mtx);
 
-        // 如果启用了 OpenTelemetry 数据跟踪且传输数据包含跟踪上下文
-        if (neu_otel_data_is_started() && trans_data->trace_ctx) {
-            trace_header_len = 26;
-        }
+    if (0 != send_item_encode(plugin, trans_data, item)) {
+        neu_metric_handle_update(plugin->metrics.send_msg_errors_total, 1);
+        send_item_finish(item, NNG_EINVAL, "encode failure");
+        return;
+    }
 
-        // 分配消息内存
-        rv = nng_msg_alloc(&msg, json_len + trace_header_len);
-        if (0 != rv) {
-            plog_error(plugin, "nng cannot allocate msg");
-            free(json_str);
-            break;
-        }
+    if (trans_trace) {
+        uint8_t *trace_id           = neu_otel_get_trace_id(trans_trace);
+        uint8_t  span_id[8]         = { 0 };
+        uint16_t trace_header_magic = 0xCE0A;
+        hex_string_to_binary(new_span_id, span_id, 8);
+
+        // 魔数、跟踪 ID 与跨度 ID 依次写入追踪头
+        memcpy(item->trace_header, &trace_header_magic, 2);
+        memcpy(item->trace_header + 2, trace_id, 16);
+        memcpy(item->trace_header + 2 + 16, span_id, 8);
+    }
 
-        if (trans_trace) {
-            // 获取跟踪 ID
-            trace_id           = neu_otel_get_trace_id(trans_trace);
-            uint8_t span_id[8] = { 0 };
-            hex_string_to_binary(new_span_id, span_id, 8);
-            uint16_t tarce_header_magic = 0xCE0A;
+    nng_mtx_lock(plugin->mtx);
+    if (plugin->queue_len >= plugin->send_queue_size) {
+        dropped = plugin->queue;
+        DL_DELETE(plugin->queue, dropped);
+        plugin->queue_len--;
+    }
+    DL_APPEND(plugin->queue, item);
+    plugin->queue_len++;
+    if (!plugin->sending) {
+        send_next(plugin);
+    } else {
+        neu_metric_handle_update(plugin->metrics.send_queue_size,
+                                 plugin->queue_len);
+    }
+    nng_mtx_unlock(plugin->mtx);
 
-            // 将跟踪头部的魔术值复制到消息体中
-            memcpy(nng_msg_body(msg), &tarce_header_magic, 2);
+    if (dropped) {
+        plog_debug(plugin, "send queue full, drop oldest report");
+        neu_metric_handle_update(plugin->metrics.send_msg_drops_total, 1);
+        send_item_finish(dropped, NNG_EAGAIN, "send queue full");
+    }
+}
 
-            // 将跟踪 ID 复制到消息体中
-            memcpy(nng_msg_body(msg) + 2, trace_id, 16);
+/**
+ * @brief 发送完成的回调函数
+ *
+ * 更新发送指标，结束已发送组上报的追踪，然后继续发送队列中的下一条消息。
+ * 套接字关闭时清空发送队列。
+ *
+ * @param arg 指向 neu_plugin_t 结构体的指针
+ */
+void send_data_callback(void *arg)
+{
+    neu_plugin_t *       plugin  = arg;
+    ekuiper_send_item_t *done    = NULL;
+    ekuiper_send_item_t *dropped = NULL;
+    size_t               bytes   = 0;
+    int                  rv      = nng_aio_result(plugin->send_aio);
 
-            // 将跨度 ID 复制到消息体中
-            memcpy(nng_msg_body(msg) + 2 + 16, span_id, 8);
+    if (0 != rv) {
+        nng_msg_free(nng_aio_get_msg(plugin->send_aio));
+        if (NNG_ECLOSED != rv) {
+            plog_error(plugin, "nng cannot send msg: %s", nng_strerror(rv));
         }
+        neu_metric_handle_update(plugin->metrics.send_msg_errors_total, 1);
+    }
 
-        // 将传输数据复制到消息体中
-        memcpy(nng_msg_body(msg) + trace_header_len, json_str,
-               json_len); // no null byte
-        plog_debug(plugin, ">> %s", json_str);
-
-        // 释放 JSON 字符串内存
-        free(json_str);
-
-        // 非阻塞方式发送消息
-        rv = nng_sendmsg(plugin->sock, msg,
-                         NNG_FLAG_NONBLOCK); // TODO: use aio to send message
-        if (0 == rv) {
-            // 更新发送消息总数的指标
-            NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_SEND_MSGS_TOTAL, 1,
-                                     NULL);
-
-            // 更新 5 秒内发送字节数的指标
-            NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_SEND_BYTES_5S, json_len,
-                                     NULL);
-            NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_SEND_BYTES_30S,
-                                     json_len, NULL);
-            NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_SEND_BYTES_60S,
-                                     json_len, NULL);
-        } else {
-            // 记录消息发送失败的错误信息
-            plog_error(plugin, "nng cannot send msg: %s", nng_strerror(rv));
+    nng_mtx_lock(plugin->mtx);
+    done             = plugin->inflight;
+    bytes            = plugin->inflight_bytes;
+    plugin->inflight = NULL;
+    if (NNG_ECLOSED == rv) {
+        dropped           = plugin->queue;
+        plugin->queue     = NULL;
+        plugin->queue_len = 0;
+        plugin->sending   = false;
+        neu_metric_handle_update(plugin->metrics.send_queue_size, 0);
+    } else {
+        send_next(plugin);
+    }
+    nng_mtx_unlock(plugin->mtx);
 
-            // 释放消息内存
-            nng_msg_free(msg);
+    if (0 == rv) {
+        // 更新发送消息总数与各时间窗口发送字节数的指标
+        neu_metric_handle_update(plugin->metrics.send_msgs_total, 1);
+        neu_metric_handles_update(plugin->metrics.send_bytes, 3, bytes);
+    }
 
-            // 更新发送消息错误总数的指标
-            NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_SEND_MSG_ERRORS_TOTAL,
-                                     1, NULL);
-        }
-    } while (0);
+    send_items_finish(done, rv, NULL);
+    send_items_finish(dropped, rv, NULL);
+}
 
-    if (trans_trace) {
-        if (rv == 0) {
-            // 设置跨度的状态码为成功
-            neu_otel_scope_set_status_code2(trans_scope, NEU_OTEL_STATUS_OK, 0);
-        } else {
-            // 设置跨度的状态码为错误，并记录错误信息
-            neu_otel_scope_set_status_code(trans_scope, NEU_OTEL_STATUS_ERROR,
-                                           nng_strerror(rv));
-        }
-        // 设置跨度的结束时间
-        neu_otel_scope_set_span_end_time(trans_scope, neu_time_ns());
+/**
+ * @brief 等待进行中的发送结束并丢弃发送队列，须在关闭套接字后调用。
+ */
+void send_queue_drain(neu_plugin_t *plugin)
+{
+    ekuiper_send_item_t *dropped = NULL;
 
-        // 标记跟踪为最终状态
-        neu_otel_trace_set_final(trans_trace);
+    nng_mtx_lock(plugin->mtx);
+    while (plugin->sending) {
+        nng_mtx_unlock(plugin->mtx);
+        nng_msleep(10);
+        nng_mtx_lock(plugin->mtx);
     }
+    dropped           = plugin->queue;
+    plugin->queue     = NULL;
+    plugin->queue_len = 0;
+    nng_mtx_unlock(plugin->mtx);
+
+    neu_metric_handle_update(plugin->metrics.send_queue_size, 0);
+    send_items_finish(dropped, NNG_ECLOSED, NULL);
 }
 
 /**
@@ -292,17 +502,13 @@ void recv_data_callback(void *arg)
     plog_debug(plugin, "<< %.*s", (int) json_len, json_str);
 
     // 更新接收消息总数的指标
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_MSGS_TOTAL, 1, NULL);
+    neu_metric_handle_update(plugin->metrics.recv_msgs_total, 1);
 
     // 更新不同时间间隔内接收字节数的指标
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_BYTES_5S, json_len, NULL);
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_BYTES_30S, json_len, NULL);
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_BYTES_60S, json_len, NULL);
+    neu_metric_handles_update(plugin->metrics.recv_bytes, 3, json_len);
 
     // 更新不同时间间隔内接收消息数的指标
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_MSGS_5S, 1, NULL);
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_MSGS_30S, 1, NULL);
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_MSGS_60S, 1, NULL);
+    neu_metric_handles_update(plugin->metrics.recv_msgs, 3, 1);
 
     // 解码 JSON 写入请求
     if (json_decode_write_req(json_str, json_len, &req) < 0) {
@@ -31,6 +31,10 @@ extern "C" {
 
 void send_data(neu_plugin_t *plugin, neu_reqresp_trans_data_t *trans_data);
 
+void send_data_callback(void *arg);
+
+void send_queue_drain(neu_plugin_t *plugin);
+
 void recv_data_callback(void *arg);
 
 #ifdef __cplusplus
@@ -0,0 +1,783 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <neuron.h>
+
+#include "errcodes.h"
+
+#include "file_cache.h"
+
+// 不小于该大小的普通文件只按选择器读取所需的区间
+#define FILE_PREAD_THRESHOLD (64 * 1024)
+
+// 大文件中按行定位时每次读取的字节数
+#define FILE_SCAN_CHUNK (16 * 1024)
+
+// 超过该时长未被点位引用的文件与选择器会被清理
+#define FILE_IDLE_MS (60 * 60 * 1000)
+
+#define FILE_WATCH_MASK                                                   \
+    (IN_CLOSE_WRITE | IN_MODIFY | IN_ATTRIB | IN_CREATE | IN_DELETE | \
+     IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF |   \
+     IN_ONLYDIR)
+
+/**
+ * @brief 文件中的一个选择器及其截取的值，同一文件的点位共享。
+ */
+struct file_view {
+    char *         selector;
+    file_select_e  select;
+    uint64_t       offset;
+    uint64_t       length;
+    uint64_t       line;
+    char *         value;
+    size_t         len;
+    int            error;
+    int64_t        last_used;
+    UT_hash_handle hh;
+};
+
+/**
+ * @brief 被监视的目录，以路径前缀（含结尾的 '/'）为键，由文件引用计数。
+ */
+struct file_dir {
+    char *         prefix;
+    int            wd;
+    int            refs;
+    UT_hash_handle hh;
+};
+
+struct file_entry {
+    char *            path;
+    const char *      name;
+    struct file_dir * dir;
+    bool              dirty;
+    int               error;
+    int64_t           last_used;
+    struct file_view *views;
+    UT_hash_handle    hh;
+};
+
+struct file_cache {
+    file_mode_e        mode;
+    int                fd;
+    int64_t            now;
+    struct file_dir *  dirs;
+    struct file_entry *entries;
+};
+
+static int parse_u64(const char *str, const char **end, uint64_t *value)
+{
+    char *e = NULL;
+
+    if (*str < '0' || *str > '9') {
+        return -1;
+    }
+
+    errno  = 0;
+    *value = strtoull(str, &e, 10);
+    *end   = e;
+    return 0 == errno ? 0 : -1;
+}
+
+static int parse_selector(const char *sel, file_address_t *addr)
+{
+    const char *end = NULL;
+
+    if (0 == strncmp(sel, "line=", 5)) {
+        if (0 != parse_u64(sel + 5, &end, &addr->line) || 0 == addr->line) {
+            return -1;
+        }
+        addr->select = FILE_SELECT_LINE;
+    } else {
+        if (0 != parse_u64(sel + 6, &end, &addr->offset)) {
+            return -1;
+        }
+        if (',' == *end &&
+            (0 != parse_u64(end + 1, &end, &addr->length) ||
+             0 == addr->length)) {
+            return -1;
+        }
+        addr->select = FILE_SELECT_BYTES;
+    }
+
+    return '\0' == *end ? 0 : -1;
+}
+
+int file_address_parse(const char *address, file_address_t *addr)
+{
+    const char *sharp    = strrchr(address, '#');
+    size_t      path_len = strlen(address);
+
+    memset(addr, 0, sizeof(*addr));
+    addr->selector = "";
+    addr->select   = FILE_SELECT_ALL;
+
+    // `#` 后不是选择器时视为路径的一部分
+    if (NULL != sharp &&
+        (0 == strncmp(sharp + 1, "line=", 5) ||
+         0 == strncmp(sharp + 1, "bytes=", 6))) {
+        if (0 != parse_selector(sharp + 1, addr)) {
+            return NEU_ERR_TAG_ADDRESS_FORMAT_INVALID;
+        }
+        addr->selector = sharp + 1;
+        path_len       = sharp - address;
+    }
+
+    if (0 == path_len) {
+        return NEU_ERR_TAG_ADDRESS_FORMAT_INVALID;
+    }
+
+    addr->path = strndup(address, path_len);
+    return NULL == addr->path ? NEU_ERR_EINTERNAL : 0;
+}
+
+void file_address_fini(file_address_t *addr)
+{
+    free(addr->path);
+    addr->path = NULL;
+}
+
+/**
+ * @brief 保存截取的值，值在第一个 '\0' 处截断且不超过 FILE_VALUE_MAX。
+ */
+static int view_set_value(struct file_view *view, const char *start, size_t n)
+{
+    if (n > FILE_VALUE_MAX) {
+        n = FILE_VALUE_MAX;
+    }
+    n = strnlen(start, n);
+
+    view->value = malloc(n + 1);
+    if (NULL == view->value) {
+        return NEU_ERR_EINTERNAL;
+    }
+    memcpy(view->value, start, n);
+    view->value[n] = '\0';
+    view->len      = n;
+    return 0;
+}
+
+/**
+ * @brief 行首到行尾的长度，不含 '\n' 以及行尾的 '\r'。
+ */
+static size_t line_len(const char *start, const char *end)
+{
+    const char *nl = memchr(start, '\n', end - start);
+    size_t      n  = NULL != nl ? (size_t)(nl - start) : (size_t)(end - start);
+
+    if (n > 0 && '\r' == start[n - 1]) {
+        n--;
+    }
+    return n;
+}
+
+/**
+ * @brief 按选择器从文件内容中截取值。
+ */
+static int view_extract(struct file_view *view, const char *data, size_t size)
+{
+    const char *start = data;
+    size_t      n     = size;
+
+    switch (view->select) {
+    case FILE_SELECT_ALL:
+        break;
+    case FILE_SELECT_BYTES:
+        if (view->offset > size) {
+            return NEU_ERR_FILE_READ_FAILURE;
+        }
+        start = data + view->offset;
+        n     = size - view->offset;
+        if (view->length > 0 && view->length < n) {
+            n = view->length;
+        }
+        break;
+    case FILE_SELECT_LINE: {
+        const char *end = data + size;
+        for (uint64_t i = 1; i < view->line; i++) {
+            const char *nl = memchr(start, '\n', end - start);
+            if (NULL == nl) {
+                return NEU_ERR_FILE_READ_FAILURE;
+            }
+            start = nl + 1;
+        }
+        if (start == end) {
+            return NEU_ERR_FILE_READ_FAILURE;
+        }
+        n = line_len(start, end);
+        break;
+    }
+    }
+
+    return view_set_value(view, start, n);
+}
+
+/**
+ * @brief 从 offset 处读取至多 n 字节，遇到文件末尾时提前结束。
+ */
+static int pread_all(int fd, char *buf, size_t n, uint64_t offset,
+                     size_t *len)
+{
+    size_t done = 0;
+
+    while (done < n) {
+        ssize_t r = pread(fd, buf + done, n - done, offset + done);
+        if (r < 0 && EINTR == errno) {
+            continue;
+        }
+        if (r < 0) {
+            return -1;
+        }
+        if (0 == r) {
+            break;
+        }
+        done += r;
+    }
+
+    *len = done;
+    return 0;
+}
+
+/**
+ * @brief 在大小为 size 的文件中查找第 line 行的行首偏移。
+ */
+static int line_offset(int fd, uint64_t size, uint64_t line,
+                       uint64_t *offset)
+{
+    char     buf[FILE_SCAN_CHUNK];
+    uint64_t pos = 0;
+
+    for (uint64_t i = 1; i < line;) {
+        size_t n = sizeof(buf);
+        if (pos >= size) {
+            return -1;
+        }
+        if (size - pos < n) {
+            n = size - pos;
+        }
+        if (0 != pread_all(fd, buf, n, pos, &n) || 0 == n) {
+            return -1;
+        }
+
+        const char *p   = buf;
+        const char *end = buf + n;
+        const char *nl  = NULL;
+        while (i < line && NULL != (nl = memchr(p, '\n', end - p))) {
+            p = nl + 1;
+            i++;
+        }
+        pos += i < line ? n : (size_t)(p - buf);
+    }
+
+    if (pos >= size) {
+        return -1;
+    }
+    *offset = pos;
+    return 0;
+}
+
+/**
+ * @brief 按选择器从大文件中读取所需的区间并截取值。
+ *
+ * 值不超过 FILE_VALUE_MAX，每个选择器至多读取 FILE_VALUE_MAX + 2 字节，
+ * 多读的两个字节用于识别行尾的 "\r\n"。行选择器需从文件头逐块查找行首。
+ */
+static int view_pread(struct file_view *view, int fd, uint64_t size)
+{
+    uint64_t offset = 0;
+    uint64_t n      = size;
+    size_t   len    = 0;
+    char *   buf    = NULL;
+    int      ret    = 0;
+
+    switch (view->select) {
+    case FILE_SELECT_ALL:
+        break;
+    case FILE_SELECT_BYTES:
+        if (view->offset > size) {
+            return NEU_ERR_FILE_READ_FAILURE;
+        }
+        offset = view->offset;
+        n      = size - offset;
+        if (view->length > 0 && view->length < n) {
+            n = view->length;
+        }
+        break;
+    case FILE_SELECT_LINE:
+        if (0 != line_offset(fd, size, view->line, &offset)) {
+            return NEU_ERR_FILE_READ_FAILURE;
+        }
+        n = size - offset;
+        break;
+    }
+
+    if (n > FILE_VALUE_MAX + 2) {
+        n = FILE_VALUE_MAX + 2;
+    }
+    buf = malloc(n > 0 ? n : 1);
+    if (NULL == buf) {
+        return NEU_ERR_EINTERNAL;
+    }
+    if (0 != pread_all(fd, buf, n, offset, &len)) {
+        free(buf);
+        return NEU_ERR_FILE_READ_FAILURE;
+    }
+
+    if (FILE_SELECT_LINE == view->select) {
+        len = line_len(buf, buf + len);
+    }
+    ret = view_set_value(view, buf, len);
+    free(buf);
+    return ret;
+}
+
+static void view_free(struct file_view *view)
+{
+    free(view->value);
+    free(view->selector);
+    free(view);
+}
+
+/**
+ * @brief 以新的文件内容重新截取所有选择器的值，并清理长时间未用的选择器。
+ *
+ * data 为 NULL 时各选择器从 fd 中读取所需的区间，size 为文件大小。
+ */
+static void entry_update_views(file_cache_t *cache, struct file_entry *entry,
+                               int fd, const char *data, size_t size)
+{
+    struct file_view *view = NULL;
+    struct file_view *tmp  = NULL;
+
+    HASH_ITER(hh, entry->views, view, tmp)
+    {
+        if (cache->now - view->last_used > FILE_IDLE_MS) {
+            HASH_DEL(entry->views, view);
+            view_free(view);
+            continue;
+        }
+
+        free(view->value);
+        view->value = NULL;
+        view->len   = 0;
+        if (0 != entry->error) {
+            view->error = entry->error;
+        } else if (NULL == data) {
+            view->error = view_pread(view, fd, size);
+        } else {
+            view->error = view_extract(view, data, size);
+        }
+    }
+}
+
+static int read_all(int fd, size_t hint, char **buf, size_t *size)
+{
+    size_t cap = hint > 0 ? hint + 1 : 4096;
+    size_t len = 0;
+    char * p   = malloc(cap);
+
+    if (NULL == p) {
+        return -1;
+    }
+
+    for (;;) {
+        if (len == cap) {
+            char *np = realloc(p, cap * 2);
+            if (NULL == np) {
+                free(p);
+                return -1;
+            }
+            p = np;
+            cap *= 2;
+        }
+
+        ssize_t n = read(fd, p + len, cap - len);
+        if (n < 0 && EINTR == errno) {
+            continue;
+        }
+        if (n < 0) {
+            free(p);
+            return -1;
+        }
+        if (0 == n) {
+            break;
+        }
+        len += n;
+    }
+
+    *buf  = p;
+    *size = len;
+    return 0;
+}
+
+static void dir_watch(file_cache_t *cache, struct file_dir *dir)
+{
+    char   path[PATH_MAX] = { 0 };
+    size_t len            = strlen(dir->prefix);
+
+    if (cache->fd < 0 || dir->wd >= 0) {
+        return;
+    }
+
+    if (0 == len) {
+        strcpy(path, ".");
+    } else if (1 == len) {
+        strcpy(path, "/");
+    } else if (len < sizeof(path)) {
+        memcpy(path, dir->prefix, len - 1);
+    } else {
+        return;
+    }
+
+    // 目录不存在时失败，文件按 POLL 方式刷新，下次加载时重试
+    dir->wd = inotify_add_watch(cache->fd, path, FILE_WATCH_MASK);
+}
+
+/**
+ * @brief 重新加载文件内容。
+ *
+ * WATCH 模式下先建立目录监视再读取，避免遗漏读取期间发生的修改。
+ * 大文件不整体读取，由各选择器通过 pread 读取所需的区间。
+ */
+static void entry_load(file_cache_t *cache, struct file_entry *entry)
+{
+    struct stat st   = { 0 };
+    char *      buf  = NULL;
+    size_t      size = 0;
+
+    dir_watch(cache, entry->dir);
+    entry->dirty = false;
+    entry->error = 0;
+
+    int fd = open(entry->path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        entry->error = ENOENT == errno ? NEU_ERR_FILE_NOT_EXIST
+                                      : NEU_ERR_FILE_OPEN_FAILURE;
+        entry_update_views(cache, entry, -1, NULL, 0);
+        return;
+    }
+
+    if (0 != fstat(fd, &st)) {
+        entry->error = NEU_ERR_FILE_READ_FAILURE;
+        entry_update_views(cache, entry, fd, NULL, 0);
+    } else if (S_ISREG(st.st_mode) && st.st_size >= FILE_PREAD_THRESHOLD) {
+        entry_update_views(cache, entry, fd, NULL, st.st_size);
+    } else if (0 != read_all(fd, S_ISREG(st.st_mode) ? st.st_size : 0, &buf,
+                             &size)) {
+        // 小文件以及 /proc、/sys 等大小为 0 的文件直接读取
+        entry->error = NEU_ERR_FILE_READ_FAILURE;
+        entry_update_views(cache, entry, fd, NULL, 0);
+    } else {
+        entry_update_views(cache, entry, fd, buf, size);
+    }
+    close(fd);
+    free(buf);
+}
+
+static struct file_dir *dir_get(file_cache_t *cache, const char *path)
+{
+    struct file_dir *dir    = NULL;
+    const char *     slash  = strrchr(path, '/');
+    size_t           len    = NULL != slash ? (size_t)(slash - path + 1) : 0;
+    char *           prefix = strndup(path, len);
+
+    if (NULL == prefix) {
+        return NULL;
+    }
+
+    HASH_FIND_STR(cache->dirs, prefix, dir);
+    if (NULL != dir) {
+        free(prefix);
+        dir->refs++;
+        return dir;
+    }
+
+    dir = calloc(1, sizeof(struct file_dir));
+    if (NULL == dir) {
+        free(prefix);
+        return NULL;
+    }
+    dir->prefix = prefix;
+    dir->wd     = -1;
+    dir->refs   = 1;
+    HASH_ADD_KEYPTR(hh, cache->dirs, dir->prefix, len, dir);
+    return dir;
+}
+
+static void dir_put(file_cache_t *cache, struct file_dir *dir)
+{
+    if (--dir->refs > 0) {
+        return;
+    }
+
+    if (dir->wd >= 0) {
+        inotify_rm_watch(cache->fd, dir->wd);
+    }
+    HASH_DEL(cache->dirs, dir);
+    free(dir->prefix);
+    free(dir);
+}
+
+static struct file_entry *entry_get(file_cache_t *cache, const char *path)
+{
+    struct file_entry *entry = NULL;
+
+    HASH_FIND_STR(cache->entries, path, entry);
+    if (NULL != entry) {
+        return entry;
+    }
+
+    entry = calloc(1, sizeof(struct file_entry));
+    if (NULL == entry) {
+        return NULL;
+    }
+    entry->path = strdup(path);
+    entry->dir  = dir_get(cache, path);
+    if (NULL == entry->path || NULL == entry->dir) {
+        if (NULL != entry->dir) {
+            dir_put(cache, entry->dir);
+        }
+        free(entry->path);
+        free(entry);
+        return NULL;
+    }
+    entry->name  = entry->path + strlen(entry->dir->prefix);
+    entry->dirty = true;
+    HASH_ADD_KEYPTR(hh, cache->entries, entry->path, strlen(entry->path),
+                    entry);
+    return entry;
+}
+
+static void entry_free(file_cache_t *cache, struct file_entry *entry)
+{
+    struct file_view *view = NULL;
+    struct file_view *tmp  = NULL;
+
+    HASH_ITER(hh, entry->views, view, tmp)
+    {
+        HASH_DEL(entry->views, view);
+        view_free(view);
+    }
+
+    HASH_DEL(cache->entries, entry);
+    dir_put(cache, entry->dir);
+    free(entry->path);
+    free(entry);
+}
+
+static void mark_dir_dirty(file_cache_t *cache, struct file_dir *dir)
+{
+    struct file_entry *entry = NULL;
+    struct file_entry *tmp   = NULL;
+
+    HASH_ITER(hh, cache->entries, entry, tmp)
+    {
+        if (NULL == dir || entry->dir == dir) {
+            entry->dirty = true;
+        }
+    }
+}
+
+static void handle_event(file_cache_t *cache, const struct inotify_event *ev)
+{
+    struct file_dir *  dir   = NULL;
+    struct file_dir *  tmp   = NULL;
+    struct file_entry *entry = NULL;
+    char               path[PATH_MAX];
+
+    if (ev->mask & IN_Q_OVERFLOW) {
+        mark_dir_dirty(cache, NULL);
+        return;
+    }
+
+    HASH_ITER(hh, cache->dirs, dir, tmp)
+    {
+        if (dir->wd == ev->wd) {
+            break;
+        }
+    }
+    if (NULL == dir) {
+        return;
+    }
+
+    // 目录被删除或移走，监视已失效，之后按 POLL 方式刷新直到重新监视
+    if (ev->mask & (IN_IGNORED | IN_DELETE_SELF | IN_MOVE_SELF)) {
+        if (ev->mask & IN_IGNORED) {
+            dir->wd = -1;
+        }
+        mark_dir_dirty(cache, dir);
+        return;
+    }
+
+    if (0 == ev->len) {
+        return;
+    }
+
+    if (snprintf(path, sizeof(path), "%s%s", dir->prefix, ev->name) >=
+        (int) sizeof(path)) {
+        return;
+    }
+    HASH_FIND_STR(cache->entries, path, entry);
+    if (NULL != entry) {
+        entry->dirty = true;
+    }
+}
+
+file_cache_t *file_cache_new(file_mode_e mode)
+{
+    file_cache_t *cache = calloc(1, sizeof(file_cache_t));
+
+    if (NULL == cache) {
+        return NULL;
+    }
+
+    cache->mode = FILE_MODE_POLL;
+    cache->fd   = -1;
+    if (FILE_MODE_WATCH == mode) {
+        cache->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (cache->fd >= 0) {
+            cache->mode = FILE_MODE_WATCH;
+        }
+    }
+
+    return cache;
+}
+
+void file_cache_free(file_cache_t *cache)
+{
+    struct file_entry *entry = NULL;
+    struct file_entry *tmp   = NULL;
+
+    if (NULL == cache) {
+        return;
+    }
+
+    HASH_ITER(hh, cache->entries, entry, tmp)
+    {
+        entry_free(cache, entry);
+    }
+
+    if (cache->fd >= 0) {
+        close(cache->fd);
+    }
+    free(cache);
+}
+
+file_mode_e file_cache_mode(file_cache_t *cache)
+{
+    return cache->mode;
+}
+
+void file_cache_begin(file_cache_t *cache)
+{
+    struct file_entry *entry = NULL;
+    struct file_entry *tmp   = NULL;
+
+    cache->now = neu_time_mono_ms_coarse();
+
+    if (cache->fd >= 0) {
+        char buf[4096]
+            __attribute__((aligned(__alignof__(struct inotify_event))));
+
+        for (;;) {
+            ssize_t n = read(cache->fd, buf, sizeof(buf));
+            if (n <= 0) {
+                break;
+            }
+
+            for (char *p = buf; p < buf + n;) {
+                const struct inotify_event *ev =
+                    (const struct inotify_event *) p;
+                handle_event(cache, ev);
+                p += sizeof(struct inotify_event) + ev->len;
+            }
+        }
+    }
+
+    HASH_ITER(hh, cache->entries, entry, tmp)
+    {
+        if (cache->now - entry->last_used > FILE_IDLE_MS) {
+            entry_free(cache, entry);
+        } else if (cache->fd < 0 || entry->dir->wd < 0) {
+            entry->dirty = true;
+        }
+    }
+}
+
+int file_cache_read(file_cache_t *cache, const char *address,
+                    const char **value, size_t *len)
+{
+    file_address_t     addr  = { 0 };
+    struct file_entry *entry = NULL;
+    struct file_view * view  = NULL;
+    int                ret   = file_address_parse(address, &addr);
+
+    if (0 != ret) {
+        return ret;
+    }
+
+    entry = entry_get(cache, addr.path);
+    if (NULL == entry) {
+        file_address_fini(&addr);
+        return NEU_ERR_EINTERNAL;
+    }
+    entry->last_used = cache->now;
+
+    HASH_FIND_STR(entry->views, addr.selector, view);
+    if (NULL == view) {
+        view = calloc(1, sizeof(struct file_view));
+        if (NULL == view || NULL == (view->selector = strdup(addr.selector))) {
+            free(view);
+            file_address_fini(&addr);
+            return NEU_ERR_EINTERNAL;
+        }
+        view->select = addr.select;
+        view->offset = addr.offset;
+        view->length = addr.length;
+        view->line   = addr.line;
+        HASH_ADD_KEYPTR(hh, entry->views, view->selector,
+                        strlen(view->selector), view);
+
+        // 新的选择器需要文件内容才能截取
+        entry->dirty = true;
+    }
+    view->last_used = cache->now;
+    file_address_fini(&addr);
+
+    if (entry->dirty) {
+        entry_load(cache, entry);
+    }
+
+    if (0 != view->error) {
+        return view->error;
+    }
+
+    *value = view->value;
+    *len   = view->len;
+    return 0;
+}
@@ -0,0 +1,118 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#ifndef _NEU_PLUGIN_FILE_CACHE_H_
+#define _NEU_PLUGIN_FILE_CACHE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief 文件内容的刷新方式。
+ */
+typedef enum {
+    /** 每个采集周期每个文件读取一次。 */
+    FILE_MODE_POLL = 0,
+    /** 通过 inotify 监视文件所在目录，仅在文件变化后重新读取。 */
+    FILE_MODE_WATCH = 1,
+} file_mode_e;
+
+/**
+ * @brief 点位地址中的选择器类型。
+ */
+typedef enum {
+    FILE_SELECT_ALL   = 0,
+    FILE_SELECT_BYTES = 1,
+    FILE_SELECT_LINE  = 2,
+} file_select_e;
+
+/**
+ * @brief 解析后的点位地址。
+ *
+ * 地址格式为 `<path>`、`<path>#line=<n>` 或
+ * `<path>#bytes=<offset>[,<length>]`。行号从 1 开始；省略 length 时读取
+ * 到文件末尾。
+ */
+typedef struct {
+    char *        path;
+    const char *  selector; // `#` 之后的部分，整个文件时为空串
+    file_select_e select;
+    uint64_t      offset;
+    uint64_t      length;
+    uint64_t      line;
+} file_address_t;
+
+/**
+ * @brief 点位值的最大字节数，受 neu_value_ptr_t 长度字段的限制。
+ */
+#define FILE_VALUE_MAX (UINT16_MAX - 1)
+
+/**
+ * @brief 解析点位地址。
+ *
+ * @return 成功返回 0，address 中的 path 由 file_address_fini 释放；
+ *         格式错误返回 NEU_ERR_TAG_ADDRESS_FORMAT_INVALID。
+ */
+int  file_address_parse(const char *address, file_address_t *addr);
+void file_address_fini(file_address_t *addr);
+
+typedef struct file_cache file_cache_t;
+
+/**
+ * @brief 创建文件缓存。
+ *
+ * FILE_MODE_WATCH 下 inotify 不可用时退化为 FILE_MODE_POLL，可通过
+ * file_cache_mode 查询实际的模式。
+ */
+file_cache_t *file_cache_new(file_mode_e mode);
+void          file_cache_free(file_cache_t *cache);
+file_mode_e   file_cache_mode(file_cache_t *cache);
+
+/**
+ * @brief 开始一个采集周期。
+ *
+ * POLL 模式下将所有文件标记为待刷新；WATCH 模式下读取已到达的 inotify
+ * 事件，只标记发生变化的文件。同时清理长时间未被点位引用的文件。
+ */
+void file_cache_begin(file_cache_t *cache);
+
+/**
+ * @brief 读取点位的值。
+ *
+ * 文件待刷新时先重新加载，并为该文件的所有点位重新截取值。返回的字符串
+ * 以 '\0' 结尾，在下一次调用 file_cache_read 或 file_cache_begin 前有效。
+ *
+ * @param cache 文件缓存。
+ * @param address 点位地址。
+ * @param value 输出点位值。
+ * @param len 输出点位值长度，不含结尾的 '\0'。
+ * @return 成功返回 0，失败返回 NEU_ERR_FILE_* 或地址格式错误码。
+ */
+int file_cache_read(file_cache_t *cache, const char *address,
+                    const char **value, size_t *len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -17,18 +17,22 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  **/
 #include <errno.h>
+#include <pthread.h>
 #include <stdlib.h>
 
 #include <neuron.h>
 
 #include "errcodes.h"
 
+#include "file_cache.h"
+
 struct neu_plugin {
     neu_plugin_common_t common;
 
-    // neu_events_t *events;
-
-    // int file_length;
+    // 保护 cache，采集定时器与节点设置可能在不同线程中执行
+    pthread_mutex_t mtx;
+    file_mode_e     mode;
+    file_cache_t *  cache;
 };
 
 static neu_plugin_t *driver_open(void);
@@ -102,12 +106,25 @@ static int driver_close(neu_plugin_t *plugin)
 static int driver_init(neu_plugin_t *plugin, bool load)
 {
     (void) load;
+
+    plugin->mode  = FILE_MODE_POLL;
+    plugin->cache = file_cache_new(FILE_MODE_POLL);
+    if (NULL == plugin->cache) {
+        plog_error(plugin, "%s create file cache fail", plugin->common.name);
+        return NEU_ERR_EINTERNAL;
+    }
+    pthread_mutex_init(&plugin->mtx, NULL);
+
     plog_notice(plugin, "%s init success", plugin->common.name);
     return 0;
 }
 
 static int driver_uninit(neu_plugin_t *plugin)
 {
+    file_cache_free(plugin->cache);
+    plugin->cache = NULL;
+    pthread_mutex_destroy(&plugin->mtx);
+
     plog_notice(plugin, "%s uninit success", plugin->common.name);
 
     return 0;
@@ -138,9 +155,40 @@ static int driver_stop(neu_plugin_t *plugin)
 }
 static int driver_config(neu_plugin_t *plugin, const char *config)
 {
-    (void) plugin;
-    (void) config;
+    neu_json_elem_t mode = { .name      = "mode",
+                             .t         = NEU_JSON_INT,
+                             .v.val_int = FILE_MODE_POLL };
+
+    // mode, optional, default to poll
+    if (0 != neu_parse_param(config, NULL, 1, &mode)) {
+        mode.v.val_int = FILE_MODE_POLL;
+    }
+    if (FILE_MODE_POLL != mode.v.val_int &&
+        FILE_MODE_WATCH != mode.v.val_int) {
+        plog_error(plugin, "setting invalid mode: %" PRIi64, mode.v.val_int);
+        return NEU_ERR_NODE_SETTING_INVALID;
+    }
+
+    if ((file_mode_e) mode.v.val_int == plugin->mode) {
+        return 0;
+    }
+
+    file_cache_t *cache = file_cache_new(mode.v.val_int);
+    if (NULL == cache) {
+        return NEU_ERR_EINTERNAL;
+    }
+    if (FILE_MODE_WATCH == mode.v.val_int &&
+        FILE_MODE_WATCH != file_cache_mode(cache)) {
+        plog_warn(plugin, "inotify unavailable, fallback to poll mode");
+    }
+
+    pthread_mutex_lock(&plugin->mtx);
+    file_cache_free(plugin->cache);
+    plugin->cache = cache;
+    plugin->mode  = mode.v.val_int;
+    pthread_mutex_unlock(&plugin->mtx);
 
+    plog_notice(plugin, "config mode:%d", plugin->mode);
     return 0;
 }
 
@@ -161,10 +209,23 @@ static int driver_tag_validator(const neu_datatag_t *tag)
 
 static int driver_validate_tag(neu_plugin_t *plugin, neu_datatag_t *tag)
 {
+    file_address_t addr = { 0 };
+
     if (tag->type != NEU_TYPE_STRING) {
         return NEU_ERR_TAG_TYPE_NOT_SUPPORT;
     }
 
+    int ret = file_address_parse(tag->address, &addr);
+    if (0 != ret) {
+        return ret;
+    }
+    // 只读取文件的一部分的点位不支持写
+    bool partial = FILE_SELECT_ALL != addr.select;
+    file_address_fini(&addr);
+    if (partial && neu_tag_attribute_test(tag, NEU_ATTRIBUTE_WRITE)) {
+        return NEU_ERR_PLUGIN_TAG_NOT_ALLOW_WRITE;
+    }
+
     plog_notice(plugin, "validate tag success, name:%s, address:%s, type:%d ",
                 tag->name, tag->address, tag->type);
 
@@ -176,37 +237,36 @@ static int driver_group_timer(neu_plugin_t *plugin, neu_plugin_group_t *group)
     neu_adapter_update_metric_cb_t update_metric =
         plugin->common.adapter_callbacks->update_metric;
 
+    pthread_mutex_lock(&plugin->mtx);
+    file_cache_begin(plugin->cache);
+
     utarray_foreach(group->tags, neu_datatag_t *, tag)
     {
         neu_dvalue_t dvalue = { 0 };
-
-        FILE *fp = fopen(tag->address, "r");
-        if (fp == NULL) {
-            dvalue.type = NEU_TYPE_ERROR;
-            if (errno == ENOENT) {
-                dvalue.value.i32 = NEU_ERR_FILE_NOT_EXIST;
-            } else {
-                dvalue.value.i32 = NEU_ERR_FILE_OPEN_FAILURE;
-            }
+        const char * value  = NULL;
+        size_t       len    = 0;
+
+        int ret = file_cache_read(plugin->cache, tag->address, &value, &len);
+        if (0 != ret) {
+            dvalue.type      = NEU_TYPE_ERROR;
+            dvalue.value.i32 = ret;
+        } else if (len < NEU_VALUE_SIZE) {
+            dvalue.type = NEU_TYPE_STRING;
+            memcpy(dvalue.value.str, value, len + 1);
         } else {
-            char *buf = calloc(1, 1024);
-            int   ret = fread(buf, 1, 1024, fp);
-            if (ret < 0) {
-                dvalue.type      = NEU_TYPE_ERROR;
-                dvalue.value.i32 = NEU_ERR_FILE_READ_FAILURE;
-            } else {
-                dvalue.type = NEU_TYPE_STRING;
-                strncpy(dvalue.value.str, buf, NEU_VALUE_SIZE - 1);
-            }
-
-            fclose(fp);
-            free(buf);
+            // 长字符串由缓存复制，value 在下一次读取前有效
+            dvalue.type             = NEU_TYPE_PTR;
+            dvalue.value.ptr.type   = NEU_TYPE_STRING;
+            dvalue.value.ptr.length = len + 1;
+            dvalue.value.ptr.ptr    = (uint8_t *) value;
         }
 
         plugin->common.adapter_callbacks->driver.update(
             plugin->common.adapter, group->group_name, tag->name, dvalue);
     }
 
+    pthread_mutex_unlock(&plugin->mtx);
+
     update_metric(plugin->common.adapter, NEU_METRIC_SEND_BYTES, 0, NULL);
     update_metric(plugin->common.adapter, NEU_METRIC_RECV_BYTES, 0, NULL);
     update_metric(plugin->common.adapter, NEU_METRIC_LAST_RTT_MS, 1, NULL);
@@ -218,7 +278,22 @@ static int driver_group_timer(neu_plugin_t *plugin, neu_plugin_group_t *group)
 static int driver_write(neu_plugin_t *plugin, void *req, neu_datatag_t *tag,
                         neu_value_u value)
 {
-    FILE *fp = fopen(tag->address, "w");
+    file_address_t addr = { 0 };
+
+    if (0 != file_address_parse(tag->address, &addr)) {
+        plugin->common.adapter_callbacks->driver.write_response(
+            plugin->common.adapter, req, NEU_ERR_TAG_ADDRESS_FORMAT_INVALID);
+        return 0;
+    }
+    if (FILE_SELECT_ALL != addr.select) {
+        file_address_fini(&addr);
+        plugin->common.adapter_callbacks->driver.write_response(
+            plugin->common.adapter, req, NEU_ERR_PLUGIN_TAG_NOT_ALLOW_WRITE);
+        return 0;
+    }
+
+    FILE *fp = fopen(addr.path, "w");
+    file_address_fini(&addr);
     if (fp == NULL) {
         if (errno == ENOENT) {
             plugin->common.adapter_callbacks->driver.write_response(
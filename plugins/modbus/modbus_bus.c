@@ -0,0 +1,185 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#include <errno.h>
+#include <string.h>
+#include <time.h>
+
+#include "modbus_bus.h"
+
+static const uint32_t bauds[] = {
+    [NEU_CONN_TTY_BAUD_115200] = 115200, [NEU_CONN_TTY_BAUD_57600] = 57600,
+    [NEU_CONN_TTY_BAUD_38400] = 38400,   [NEU_CONN_TTY_BAUD_19200] = 19200,
+    [NEU_CONN_TTY_BAUD_9600] = 9600,     [NEU_CONN_TTY_BAUD_4800] = 4800,
+    [NEU_CONN_TTY_BAUD_2400] = 2400,     [NEU_CONN_TTY_BAUD_1800] = 1800,
+    [NEU_CONN_TTY_BAUD_1200] = 1200,     [NEU_CONN_TTY_BAUD_600] = 600,
+    [NEU_CONN_TTY_BAUD_300] = 300,       [NEU_CONN_TTY_BAUD_200] = 200,
+    [NEU_CONN_TTY_BAUD_150] = 150,
+};
+
+int modbus_rtu_timing(neu_conn_tty_baud_e baud, neu_conn_tty_data_e data,
+                      neu_conn_tty_parity_e parity, neu_conn_tty_stop_e stop,
+                      modbus_rtu_timing_t *timing)
+{
+    if ((unsigned) baud >= sizeof(bauds) / sizeof(bauds[0]) ||
+        data > NEU_CONN_TTY_DATA_8 || parity > NEU_CONN_TTY_PARITY_SPACE ||
+        stop > NEU_CONN_TTY_STOP_2) {
+        return -1;
+    }
+
+    // 起始位 + 数据位 + 校验位 + 停止位
+    uint32_t bits = 1 + (5 + data) + (NEU_CONN_TTY_PARITY_NONE != parity) +
+        (NEU_CONN_TTY_STOP_2 == stop ? 2 : 1);
+    uint32_t rate = bauds[baud];
+
+    timing->char_us = (bits * 1000000 + rate - 1) / rate;
+    if (rate > 19200) {
+        timing->t15_us = 750;
+        timing->t35_us = 1750;
+    } else {
+        timing->t15_us = (3 * bits * 1000000 + 2 * rate - 1) / (2 * rate);
+        timing->t35_us = (7 * bits * 1000000 + 2 * rate - 1) / (2 * rate);
+    }
+
+    return 0;
+}
+
+int64_t modbus_bus_now_us(void)
+{
+    struct timespec ts = { 0 };
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t) ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
+
+void modbus_bus_config(modbus_bus_t *bus, const modbus_rtu_timing_t *timing,
+                       uint16_t interval)
+{
+    memset(bus, 0, sizeof(*bus));
+
+    bus->enable = true;
+    bus->timing = *timing;
+    bus->gap_us = (uint32_t) interval * 1000;
+    if (bus->gap_us < timing->t35_us) {
+        bus->gap_us = timing->t35_us;
+    }
+    bus->window_us = modbus_bus_now_us();
+}
+
+void modbus_bus_disable(modbus_bus_t *bus)
+{
+    bus->enable = false;
+}
+
+void modbus_bus_before_send(modbus_bus_t *bus, uint8_t slave_id,
+                            uint16_t n_byte)
+{
+    if (!bus->enable) {
+        return;
+    }
+
+    // 上一个请求没有收到响应时，以其最后一个字符离开总线的时刻为准
+    if (bus->tx_pending) {
+        bus->idle_us =
+            bus->tx_us + (int64_t) bus->tx_bytes * bus->timing.char_us;
+        bus->wire_us += (uint64_t) bus->tx_bytes * bus->timing.char_us;
+    }
+
+    if (bus->idle_us > 0) {
+        int64_t         until = bus->idle_us + bus->gap_us;
+        struct timespec ts    = { .tv_sec  = until / 1000000,
+                               .tv_nsec = (until % 1000000) * 1000 };
+
+        while (EINTR ==
+               clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL)) {
+        }
+    }
+
+    bus->tx_us      = modbus_bus_now_us();
+    bus->tx_bytes   = n_byte;
+    bus->tx_slave   = slave_id;
+    bus->tx_pending = true;
+}
+
+void modbus_bus_after_recv(modbus_bus_t *bus, int n_byte)
+{
+    if (!bus->enable || !bus->tx_pending) {
+        return;
+    }
+
+    modbus_slave_stat_t *stat = &bus->slaves[bus->tx_slave];
+    int64_t              now  = modbus_bus_now_us();
+
+    bus->tx_pending = false;
+    bus->idle_us    = now;
+    stat->n_request += 1;
+
+    if (n_byte <= 0) {
+        stat->n_timeout += 1;
+        bus->wire_us += (uint64_t) bus->tx_bytes * bus->timing.char_us;
+        return;
+    }
+
+    uint32_t rt = (uint32_t)(now - bus->tx_us);
+    bus->wire_us +=
+        (uint64_t)(bus->tx_bytes + n_byte) * bus->timing.char_us;
+    stat->sum_us += rt;
+    if (0 == stat->min_us || rt < stat->min_us) {
+        stat->min_us = rt;
+    }
+    if (rt > stat->max_us) {
+        stat->max_us = rt;
+    }
+}
+
+bool modbus_bus_report_due(modbus_bus_t *bus, int64_t now_us,
+                           uint32_t *utilization)
+{
+    int64_t elapsed = now_us - bus->window_us;
+
+    if (!bus->enable || elapsed < MODBUS_BUS_REPORT_MS * 1000) {
+        return false;
+    }
+
+    uint64_t percent = bus->wire_us * 100 / elapsed;
+    *utilization     = percent > 100 ? 100 : (uint32_t) percent;
+    return true;
+}
+
+void modbus_bus_reset_stat(modbus_bus_t *bus, int64_t now_us)
+{
+    bus->window_us = now_us;
+    bus->wire_us   = 0;
+    memset(bus->slaves, 0, sizeof(bus->slaves));
+}
+
+void modbus_bus_schedule(const int64_t *due, uint16_t *order, uint16_t n)
+{
+    for (uint16_t i = 1; i < n; i++) {
+        uint16_t cur = order[i];
+        uint16_t j   = i;
+
+        while (j > 0 &&
+               (due[order[j - 1]] > due[cur] ||
+                (due[order[j - 1]] == due[cur] && order[j - 1] > cur))) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = cur;
+    }
+}
@@ -0,0 +1,119 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#ifndef _NEU_M_PLUGIN_MODBUS_BUS_H_
+#define _NEU_M_PLUGIN_MODBUS_BUS_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <neuron.h>
+
+// 统计周期，周期结束时上报总线利用率并输出从站响应时间
+#define MODBUS_BUS_REPORT_MS (60 * 1000)
+
+/**
+ * @brief 串口线路的 RTU 帧时序，单位为微秒。
+ *
+ * 波特率高于 19200 时按 Modbus 串行链路规范使用固定的 750us 与 1750us。
+ */
+typedef struct {
+    uint32_t char_us; // 传输一个字符（含起始、校验与停止位）的时间
+    uint32_t t15_us;  // 帧内字符间最大间隔
+    uint32_t t35_us;  // 帧间最小静默间隔
+} modbus_rtu_timing_t;
+
+/**
+ * @brief 单个从站的响应时间统计。
+ */
+typedef struct {
+    uint32_t n_request;
+    uint32_t n_timeout;
+    uint32_t min_us;
+    uint32_t max_us;
+    uint64_t sum_us;
+} modbus_slave_stat_t;
+
+/**
+ * @brief RS-485 总线状态。
+ *
+ * 由采集线程独占访问：请求发送前等待上一帧结束后的帧间静默间隔，收到
+ * 响应后记录从站响应时间与总线上字符占用的时间。
+ */
+typedef struct {
+    bool                enable;
+    modbus_rtu_timing_t timing;
+    uint32_t            gap_us; // 帧间间隔，不小于 t3.5
+
+    int64_t  idle_us;    // 总线开始静默的时刻
+    int64_t  tx_us;      // 当前请求的发送时刻
+    uint16_t tx_bytes;   // 当前请求的字节数
+    uint8_t  tx_slave;   // 当前请求的从站
+    bool     tx_pending; // 当前请求尚未收到响应
+
+    int64_t             window_us; // 统计周期开始时刻
+    uint64_t            wire_us;   // 统计周期内字符占用总线的时间
+    modbus_slave_stat_t slaves[256];
+} modbus_bus_t;
+
+/**
+ * @brief 按串口参数计算 RTU 帧时序。
+ *
+ * @return 成功返回 0，参数不合法返回 -1。
+ */
+int modbus_rtu_timing(neu_conn_tty_baud_e baud, neu_conn_tty_data_e data,
+                      neu_conn_tty_parity_e parity, neu_conn_tty_stop_e stop,
+                      modbus_rtu_timing_t *timing);
+
+/**
+ * @brief 配置串口总线，interval 为用户配置的指令发送间隔（毫秒），作为帧间
+ *        间隔的下限。配置后统计清零。
+ */
+void modbus_bus_config(modbus_bus_t *bus, const modbus_rtu_timing_t *timing,
+                       uint16_t interval);
+void modbus_bus_disable(modbus_bus_t *bus);
+
+/**
+ * @brief 发送请求前调用，等待到帧间静默间隔结束。
+ */
+void modbus_bus_before_send(modbus_bus_t *bus, uint8_t slave_id,
+                            uint16_t n_byte);
+
+/**
+ * @brief 接收响应后调用，n_byte 不大于 0 表示超时或接收失败。
+ */
+void modbus_bus_after_recv(modbus_bus_t *bus, int n_byte);
+
+/**
+ * @brief 统计周期结束时返回 true 并输出总线利用率（百分比），调用者随后
+ *        读取 slaves 并调用 modbus_bus_reset_stat 开始新的周期。
+ */
+bool modbus_bus_report_due(modbus_bus_t *bus, int64_t now_us,
+                           uint32_t *utilization);
+void modbus_bus_reset_stat(modbus_bus_t *bus, int64_t now_us);
+
+int64_t modbus_bus_now_us(void);
+
+/**
+ * @brief 按截止时间对命令排序（截止时间最早的在前，相同时保持原有顺序）。
+ *
+ * order 为上一次的排序结果，各周期截止时间的变化很小，插入排序接近线性。
+ */
+void modbus_bus_schedule(const int64_t *due, uint16_t *order, uint16_t n);
+
+#endif
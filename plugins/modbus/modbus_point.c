@@ -34,6 +34,7 @@ static bool tag_sort(neu_tag_sort_t *sort, void *tag, void *tag_to_be_sorted);
 static int  tag_cmp_write(neu_tag_sort_elem_t *tag1, neu_tag_sort_elem_t *tag2);
 static bool tag_sort_write(neu_tag_sort_t *sort, void *tag,
                            void *tag_to_be_sorted);
+static void read_cmd_plan(modbus_read_cmd_t *cmd);
 
 int modbus_tag_to_point(const neu_datatag_t *tag, modbus_point_t *point,
                         modbus_address_base address_base)
@@ -252,6 +253,9 @@ modbus_read_cmd_sort_t *modbus_tag_sort(UT_array *tags, uint16_t max_byte)
         sort_result->cmd[i].start_address = tag->start_address;
         sort_result->cmd[i].n_register    = ctx->end - ctx->start;
 
+        // 生成该命令的解码步骤
+        read_cmd_plan(&sort_result->cmd[i]);
+
         // 释放当前分组的上下文信息所占用的内存
         free(result->sorts[i].info.context);
     }
@@ -333,47 +337,47 @@ modbus_write_cmd_sort_t *modbus_write_tags_sort(UT_array *       tags,
         modbus_point_write_t *tag =
             *(modbus_point_write_t **) utarray_front(result->sorts[i].tags);
         struct modbus_sort_ctx *ctx = result->sorts[i].info.context;
+        modbus_write_cmd_t *    cmd = &sort_result->cmd[i];
+        uint16_t                n_register = ctx->end - ctx->start;
+
+        // 数据按点位相对于起始地址的偏移填入，排序是稳定的，地址相同的点位
+        // 以请求中靠后的为准
+        if (tag->point.area == MODBUS_AREA_COIL) {
+            cmd->n_byte = n_register;
+            cmd->bytes  = calloc((n_register + 7) / 8, sizeof(uint8_t));
+        } else {
+            cmd->n_byte = n_register * 2;
+            cmd->bytes  = calloc(n_register, sizeof(uint16_t));
+        }
 
-        int num_tags              = utarray_len(result->sorts[i].tags);
-        sort_result->cmd[i].bytes = calloc(num_tags, sizeof(neu_value_u));
-        int      n_byte = 0, n_byte_tag = 0;
-        uint8_t *data_bit = calloc((num_tags + 7) / 8, sizeof(uint8_t));
-        int      k        = 0;
         utarray_foreach(result->sorts[i].tags, modbus_point_write_t **, tag_s)
         {
+            uint16_t offset = (*tag_s)->point.start_address - ctx->start;
+
             if ((*tag_s)->point.area == MODBUS_AREA_COIL) {
-                n_byte_tag =
-                    cal_n_byte((*tag_s)->point.type, &(*tag_s)->value,
-                               (*tag_s)->point.option, endianess, true);
-                data_bit[k / 8] += ((*tag_s)->value.i8) << k % 8;
-                n_byte += n_byte_tag;
-                k++;
+                uint8_t mask = 1 << offset % 8;
+
+                if ((*tag_s)->value.i8) {
+                    cmd->bytes[offset / 8] |= mask;
+                } else {
+                    cmd->bytes[offset / 8] &= ~mask;
+                }
             } else {
-                n_byte_tag =
+                int n_byte_tag =
                     cal_n_byte((*tag_s)->point.type, &(*tag_s)->value,
                                (*tag_s)->point.option, endianess,
                                (*tag_s)->point.option.value32.is_default);
-                memcpy(sort_result->cmd[i].bytes +
-                           2 *
-                               ((*tag_s)->point.start_address -
-                                tag->point.start_address),
-                       &((*tag_s)->value), n_byte_tag);
-                n_byte += n_byte_tag;
+                memcpy(cmd->bytes + 2 * offset, &((*tag_s)->value),
+                       n_byte_tag);
             }
         }
-        if ((*(modbus_point_write_t **) utarray_front(result->sorts[i].tags))
-                ->point.area == MODBUS_AREA_COIL) {
-            memcpy(sort_result->cmd[i].bytes, data_bit, (k + 7) / 8);
-        }
 
-        sort_result->cmd[i].tags     = utarray_clone(result->sorts[i].tags);
-        sort_result->cmd[i].slave_id = tag->point.slave_id;
-        sort_result->cmd[i].area     = tag->point.area;
-        sort_result->cmd[i].start_address = tag->point.start_address;
-        sort_result->cmd[i].n_register    = ctx->end - ctx->start;
-        sort_result->cmd[i].n_byte        = n_byte;
+        cmd->tags          = utarray_clone(result->sorts[i].tags);
+        cmd->slave_id      = tag->point.slave_id;
+        cmd->area          = tag->point.area;
+        cmd->start_address = tag->point.start_address;
+        cmd->n_register    = n_register;
 
-        free(data_bit);
         free(result->sorts[i].info.context);
     }
 
@@ -385,12 +389,188 @@ void modbus_tag_sort_free(modbus_read_cmd_sort_t *cs)
 {
     for (uint16_t i = 0; i < cs->n_cmd; i++) {
         utarray_free(cs->cmd[i].tags);
+        free(cs->cmd[i].ops);
+        free(cs->cmd[i].values);
     }
 
     free(cs->cmd);
     free(cs);
 }
 
+static uint8_t decode_kind(const modbus_point_t *p)
+{
+    if (p->area == MODBUS_AREA_COIL || p->area == MODBUS_AREA_INPUT) {
+        return MODBUS_DECODE_COIL_BIT;
+    }
+
+    switch (p->type) {
+    case NEU_TYPE_UINT16:
+    case NEU_TYPE_INT16:
+        return MODBUS_DECODE_SWAP16;
+    case NEU_TYPE_FLOAT:
+    case NEU_TYPE_INT32:
+    case NEU_TYPE_UINT32:
+        return p->option.value32.is_default ? MODBUS_DECODE_SWAP32_PLUG
+                                            : MODBUS_DECODE_SWAP32;
+    case NEU_TYPE_DOUBLE:
+    case NEU_TYPE_INT64:
+    case NEU_TYPE_UINT64:
+        return MODBUS_DECODE_SWAP64;
+    case NEU_TYPE_BIT:
+        return MODBUS_DECODE_REG_BIT;
+    case NEU_TYPE_STRING:
+        return p->option.string.type == NEU_DATATAG_STRING_TYPE_L
+            ? MODBUS_DECODE_STRING_L
+            : MODBUS_DECODE_STRING_H;
+    case NEU_TYPE_BYTES:
+        return MODBUS_DECODE_BYTES;
+    default:
+        return MODBUS_DECODE_RAW;
+    }
+}
+
+static void read_cmd_plan(modbus_read_cmd_t *cmd)
+{
+    uint16_t n = utarray_len(cmd->tags);
+
+    cmd->ops    = calloc(n, sizeof(modbus_decode_op_t));
+    cmd->values = calloc(n, sizeof(neu_dvalue_t));
+
+    uint16_t i = 0;
+    utarray_foreach(cmd->tags, modbus_point_t **, p_tag)
+    {
+        modbus_point_t *    p  = *p_tag;
+        modbus_decode_op_t *op = &cmd->ops[i];
+
+        op->slot = i;
+        op->type = p->type;
+        if (p->start_address + p->n_register >
+            cmd->start_address + cmd->n_register) {
+            op->kind = MODBUS_DECODE_ERROR;
+        } else {
+            op->kind = decode_kind(p);
+        }
+
+        if (op->kind == MODBUS_DECODE_COIL_BIT) {
+            op->offset = p->start_address - cmd->start_address;
+        } else {
+            op->offset = (p->start_address - cmd->start_address) * 2;
+            op->width  = p->n_register * 2;
+            op->bit    = p->option.bit.bit;
+        }
+
+        cmd->values[i].type = p->type;
+        i += 1;
+    }
+}
+
+static inline uint32_t decode_u32(const uint8_t *b, modbus_endianess endianess)
+{
+    switch (endianess) {
+    case MODBUS_BADC:
+        return (uint32_t) b[1] << 24 | (uint32_t) b[0] << 16 |
+            (uint32_t) b[3] << 8 | b[2];
+    case MODBUS_DCBA:
+        return (uint32_t) b[3] << 24 | (uint32_t) b[2] << 16 |
+            (uint32_t) b[1] << 8 | b[0];
+    case MODBUS_CDAB:
+        return (uint32_t) b[2] << 24 | (uint32_t) b[3] << 16 |
+            (uint32_t) b[0] << 8 | b[1];
+    case MODBUS_ABCD:
+    default:
+        return (uint32_t) b[0] << 24 | (uint32_t) b[1] << 16 |
+            (uint32_t) b[2] << 8 | b[3];
+    }
+}
+
+static inline uint64_t decode_u64(const uint8_t *b)
+{
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) {
+        v = v << 8 | b[i];
+    }
+    return v;
+}
+
+void modbus_read_cmd_decode(modbus_read_cmd_t *cmd, uint8_t slave_id,
+                            const uint8_t *bytes, uint16_t n_byte,
+                            modbus_endianess endianess)
+{
+    uint16_t n = utarray_len(cmd->tags);
+
+    for (uint16_t i = 0; i < n; i++) {
+        const modbus_decode_op_t *op = &cmd->ops[i];
+        neu_dvalue_t *            v  = &cmd->values[op->slot];
+        const uint8_t *           b  = bytes + op->offset;
+
+        if (op->kind == MODBUS_DECODE_ERROR || slave_id != cmd->slave_id) {
+            v->type      = NEU_TYPE_ERROR;
+            v->value.i32 = NEU_ERR_PLUGIN_READ_FAILURE;
+            continue;
+        }
+
+        v->type = op->type;
+
+        // 响应长度不足时与逐点解析保持一致，返回零值
+        if (op->kind == MODBUS_DECODE_COIL_BIT) {
+            v->value.u64 = 0;
+            if (n_byte > op->offset / 8) {
+                v->value.u8 = (bytes[op->offset / 8] >> (op->offset % 8)) & 1;
+            }
+            continue;
+        }
+
+        v->value.bytes.length = op->width;
+        if (n_byte < op->offset + op->width) {
+            memset(v->value.bytes.bytes, 0, op->width + 1);
+            continue;
+        }
+
+        switch (op->kind) {
+        case MODBUS_DECODE_SWAP16:
+            v->value.u64 = 0;
+            v->value.u16 = (uint16_t) (b[0] << 8 | b[1]);
+            break;
+        case MODBUS_DECODE_SWAP32:
+            v->value.u64 = 0;
+            v->value.u32 = decode_u32(b, MODBUS_ABCD);
+            break;
+        case MODBUS_DECODE_SWAP32_PLUG:
+            v->value.u64 = 0;
+            v->value.u32 = decode_u32(b, endianess);
+            break;
+        case MODBUS_DECODE_SWAP64:
+            v->value.u64 = decode_u64(b);
+            break;
+        case MODBUS_DECODE_REG_BIT: {
+            uint16_t v16 = (uint16_t) (b[0] << 8 | b[1]);
+            v->value.u64 = 0;
+            v->value.u8  = (v16 >> op->bit) & 1;
+            break;
+        }
+        case MODBUS_DECODE_STRING_H:
+        case MODBUS_DECODE_STRING_L:
+            memcpy(v->value.str, b, op->width);
+            v->value.str[op->width] = 0;
+            if (op->kind == MODBUS_DECODE_STRING_L) {
+                neu_datatag_string_ltoh(v->value.str, strlen(v->value.str));
+            }
+            if (!neu_datatag_string_is_utf8(v->value.str,
+                                            strlen(v->value.str))) {
+                v->value.str[0] = '?';
+                v->value.str[1] = 0;
+            }
+            break;
+        case MODBUS_DECODE_BYTES:
+        case MODBUS_DECODE_RAW:
+        default:
+            memset(v->value.bytes.bytes, 0, sizeof(uint64_t));
+            memcpy(v->value.bytes.bytes, b, op->width);
+            break;
+        }
+    }
+}
+
 static int tag_cmp(neu_tag_sort_elem_t *tag1, neu_tag_sort_elem_t *tag2)
 {
     modbus_point_t *p_t1 = (modbus_point_t *) tag1->tag;
@@ -534,31 +714,22 @@ static bool tag_sort_write(neu_tag_sort_t *sort, void *tag,
         return false;
     }
 
+    // 只合并地址连续或重叠的点位，中间有空隙时不能补写未知的值
     if (t2->point.start_address > ctx->end) {
         return false;
     }
 
-    switch (t1->point.area) {
-    case MODBUS_AREA_COIL:
-    case MODBUS_AREA_INPUT:
-        if ((ctx->end - ctx->start) / 8 >= modbus_read_max_byte - 1) {
-            return false;
-        }
-        break;
-    case MODBUS_AREA_INPUT_REGISTER:
-    case MODBUS_AREA_HOLD_REGISTER: {
-        uint16_t now_bytes = (ctx->end - ctx->start) * 2;
-        uint16_t add_now   = now_bytes + t2->point.n_register * 2;
-        if (add_now >= modbus_read_max_byte) {
+    // 写命令的长度受功能码限制，与读命令的 max_byte 配置无关
+    uint32_t end = (uint32_t) t2->point.start_address + t2->point.n_register;
+    uint32_t max = t1->point.area == MODBUS_AREA_COIL
+        ? MODBUS_WRITE_MAX_COIL
+        : MODBUS_WRITE_MAX_REGISTER;
+
+    if (end > ctx->end) {
+        if (end - ctx->start > max || end > UINT16_MAX) {
             return false;
         }
-
-        break;
-    }
-    }
-
-    if (t2->point.start_address + t2->point.n_register > ctx->end) {
-        ctx->end = t2->point.start_address + t2->point.n_register;
+        ctx->end = end;
     }
 
     return true;
@@ -91,6 +91,7 @@ typedef struct modbus_point {
 typedef struct modbus_point_write {
     modbus_point_t point;
     neu_value_u    value;
+    int            error; // 点位所在写命令帧的结果
 } modbus_point_write_t;
 
 int modbus_tag_to_point(const neu_datatag_t *tag, modbus_point_t *point,
@@ -99,6 +100,63 @@ int modbus_write_tag_to_point(const neu_plugin_tag_value_t *tag,
                               modbus_point_write_t *        point,
                               modbus_address_base           address_base);
 
+/**
+ * @brief 读取响应解码方式。
+ *
+ * 在 modbus_tag_sort 生成读取命令时，根据点位的区域、类型和地址选项
+ * 预先确定每个点位的解码方式，解码时不再重复判断。
+ */
+typedef enum {
+    MODBUS_DECODE_ERROR = 0,   // 点位超出命令的读取范围
+    MODBUS_DECODE_RAW,         // 按原始字节复制，不做字节序转换
+    MODBUS_DECODE_SWAP16,      // 16 位大端
+    MODBUS_DECODE_SWAP32,      // 32 位大端
+    MODBUS_DECODE_SWAP32_PLUG, // 32 位，按插件配置的字节序
+    MODBUS_DECODE_SWAP64,      // 64 位大端
+    MODBUS_DECODE_REG_BIT,     // 寄存器中的位
+    MODBUS_DECODE_COIL_BIT,    // 线圈/离散输入中的位
+    MODBUS_DECODE_STRING_H,    // 字符串，高字节在前
+    MODBUS_DECODE_STRING_L,    // 字符串，低字节在前
+    MODBUS_DECODE_BYTES,       // 字节数组
+} modbus_decode_e;
+
+/**
+ * @brief 单个点位的解码步骤。
+ */
+typedef struct modbus_decode_op {
+    /**
+     * @brief 点位在响应数据中的偏移。
+     *
+     * 寄存器区域为字节偏移，线圈/离散输入区域为位偏移。
+     */
+    uint16_t offset;
+
+    /**
+     * @brief 点位占用的字节数，线圈/离散输入区域为 0。
+     */
+    uint16_t width;
+
+    /**
+     * @brief 解码方式，取值为 modbus_decode_e。
+     */
+    uint8_t kind;
+
+    /**
+     * @brief 寄存器中的位序号，仅 MODBUS_DECODE_REG_BIT 使用。
+     */
+    uint8_t bit;
+
+    /**
+     * @brief 点位数据类型。
+     */
+    uint8_t type;
+
+    /**
+     * @brief 解码结果在 values 数组中的位置。
+     */
+    uint16_t slot;
+} modbus_decode_op_t;
+
 /**
  * @brief 用于表示 Modbus 读取命令的结构体。
  * 
@@ -140,6 +198,16 @@ typedef struct modbus_read_cmd {
      * 元素类型：modbus_point_t **。
      */
     UT_array *tags; 
+
+    /**
+     * @brief 预先生成的解码步骤，与 tags 一一对应。
+     */
+    modbus_decode_op_t *ops;
+
+    /**
+     * @brief 解码结果，与 tags 一一对应，在各次读取之间复用。
+     */
+    neu_dvalue_t *values;
 } modbus_read_cmd_t;
 
 /**
@@ -167,12 +235,27 @@ typedef struct modbus_read_cmd_sort {
     modbus_read_cmd_t *cmd;
 } modbus_read_cmd_sort_t;
 
+/**
+ * @brief 单帧写命令的数量上限。
+ *
+ * FC16 的字节数字段最大为 246（123 个寄存器），FC15 最多写 1968 个线圈。
+ */
+#define MODBUS_WRITE_MAX_REGISTER 123
+#define MODBUS_WRITE_MAX_COIL 1968
+
+/**
+ * @brief 合并后的一帧写命令。
+ *
+ * 同一从站、同一区域内地址连续或重叠的点位合并为一帧，地址重叠的部分
+ * 以排序靠后的点位为准。线圈区域的 n_byte 为线圈数量，bytes 按地址偏移
+ * 打包为位；寄存器区域的 n_byte 为数据字节数。
+ */
 typedef struct modbus_write_cmd {
     uint8_t       slave_id;
     modbus_area_e area;
     uint16_t      start_address;
     uint16_t      n_register;
-    uint8_t       n_byte;
+    uint16_t      n_byte;
     uint8_t *     bytes;
 
     UT_array *tags;
@@ -188,6 +271,21 @@ modbus_write_cmd_sort_t *modbus_write_tags_sort(UT_array *       tags,
                                                 modbus_endianess endianess);
 void                     modbus_tag_sort_free(modbus_read_cmd_sort_t *cs);
 
+/**
+ * @brief 按读取命令预先生成的解码步骤解析响应数据。
+ *
+ * 解码结果写入 cmd->values，顺序与 cmd->tags 一致。
+ *
+ * @param cmd       读取命令。
+ * @param slave_id  响应中的从站 ID，与命令不一致时所有点位均置为读取错误。
+ * @param bytes     响应数据。
+ * @param n_byte    响应数据字节数。
+ * @param endianess 插件配置的 32 位数据字节序。
+ */
+void modbus_read_cmd_decode(modbus_read_cmd_t *cmd, uint8_t slave_id,
+                            const uint8_t *bytes, uint16_t n_byte,
+                            modbus_endianess endianess);
+
 void modbus_convert_endianess(neu_value_u *value, modbus_endianess endianess);
 
 #ifdef __cplusplus
@@ -70,6 +70,19 @@ struct modbus_group_data {
      * 
      */
     modbus_address_base     address_base;
+
+    /**
+     * @brief 串口总线上各命令下一次读取的截止时间（单调时钟，微秒）。
+     *
+     * 组定时器按截止时间从早到晚执行命令，本周期未能执行的命令保留原截止
+     * 时间，在下一个周期优先执行。
+     */
+    int64_t * due;
+
+    /**
+     * @brief 按截止时间排序后的命令下标。
+     */
+    uint16_t *order;
 };
 
 struct modbus_write_tags_data {
@@ -166,6 +179,9 @@ int modbus_send_msg(void *ctx, uint16_t n_byte, uint8_t *bytes)
     // 用于存储发送操作的返回结果，初始化为 0
     int           ret    = 0;
 
+    // 串口总线上等待帧间静默间隔结束，RTU 帧的第一个字节为从站地址
+    modbus_bus_before_send(&plugin->bus, bytes[0], n_byte);
+
     // 清空连接的接收缓冲区，确保接收缓冲区中没有残留数据，避免影响后续数据接收
     neu_conn_clear_recv_buffer(plugin->conn);
 
@@ -358,23 +374,67 @@ void check_modbus_read_result(neu_plugin_t *            plugin,
                                 rtt, slave_err);
 }
 
+void modbus_resolve_metrics(neu_plugin_t *plugin)
+{
+    plugin->send_bytes_metric =
+        NEU_PLUGIN_METRIC_HANDLE(plugin, NEU_METRIC_SEND_BYTES, NULL);
+    plugin->recv_bytes_metric =
+        NEU_PLUGIN_METRIC_HANDLE(plugin, NEU_METRIC_RECV_BYTES, NULL);
+    plugin->last_rtt_metric =
+        NEU_PLUGIN_METRIC_HANDLE(plugin, NEU_METRIC_LAST_RTT_MS, NULL);
+    plugin->bus_utilization_metric =
+        NEU_PLUGIN_METRIC_HANDLE(plugin, NEU_METRIC_BUS_UTILIZATION, NULL);
+}
+
+/**
+ * @brief 统计周期结束时上报总线利用率，并输出各从站的响应时间。
+ */
+static void report_bus_stat(neu_plugin_t *plugin)
+{
+    uint32_t utilization = 0;
+    int64_t  now         = modbus_bus_now_us();
+
+    if (!modbus_bus_report_due(&plugin->bus, now, &utilization)) {
+        return;
+    }
+
+    neu_metric_handle_update(plugin->bus_utilization_metric, utilization);
+    plog_notice(plugin, "bus utilization: %" PRIu32 "%%", utilization);
+
+    for (int i = 0; i < MAX_SLAVES; i++) {
+        modbus_slave_stat_t *stat = &plugin->bus.slaves[i];
+        uint32_t             n    = stat->n_request - stat->n_timeout;
+
+        if (0 == stat->n_request) {
+            continue;
+        }
+
+        plog_notice(plugin,
+                    "slave %d, requests: %" PRIu32 ", timeouts: %" PRIu32
+                    ", response us avg/min/max: %" PRIu64 "/%" PRIu32
+                    "/%" PRIu32,
+                    i, stat->n_request, stat->n_timeout,
+                    n > 0 ? stat->sum_us / n : 0, stat->min_us,
+                    stat->max_us);
+    }
+
+    modbus_bus_reset_stat(&plugin->bus, now);
+}
+
 void update_metrics_after_read(neu_plugin_t *plugin, int64_t rtt,
                                neu_plugin_group_t *group,
                                neu_conn_state_t *  state)
 {
     *state = neu_conn_state(plugin->conn);
-    neu_adapter_update_metric_cb_t update_metric =
-        plugin->common.adapter_callbacks->update_metric;
     struct modbus_group_data *gd =
         (struct modbus_group_data *) group->user_data;
 
-    update_metric(plugin->common.adapter, NEU_METRIC_SEND_BYTES,
-                  state->send_bytes, NULL);
-    update_metric(plugin->common.adapter, NEU_METRIC_RECV_BYTES,
-                  state->recv_bytes, NULL);
-    update_metric(plugin->common.adapter, NEU_METRIC_LAST_RTT_MS, rtt, NULL);
-    update_metric(plugin->common.adapter, NEU_METRIC_GROUP_LAST_SEND_MSGS,
-                  gd->cmd_sort->n_cmd, group->group_name);
+    neu_metric_handle_update(plugin->send_bytes_metric, state->send_bytes);
+    neu_metric_handle_update(plugin->recv_bytes_metric, state->recv_bytes);
+    neu_metric_handle_update(plugin->last_rtt_metric, rtt);
+    // 组度量项随组删除而释放，仍按组名更新
+    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_GROUP_LAST_SEND_MSGS,
+                             gd->cmd_sort->n_cmd, group->group_name);
 }
 
 typedef struct {
@@ -478,6 +538,12 @@ int modbus_group_timer(neu_plugin_t *plugin, neu_plugin_group_t *group,
         gd->cmd_sort     = modbus_tag_sort(gd->tags, max_byte);
         // 设置 modbus_group_data 结构体的地址基为插件的地址基
         gd->address_base = plugin->address_base;
+
+        gd->due   = calloc(gd->cmd_sort->n_cmd + 1, sizeof(int64_t));
+        gd->order = calloc(gd->cmd_sort->n_cmd + 1, sizeof(uint16_t));
+        for (uint16_t i = 0; i < gd->cmd_sort->n_cmd; i++) {
+            gd->order[i] = i;
+        }
     }
 
     // 获取组的用户数据指针
@@ -489,7 +555,25 @@ int modbus_group_timer(neu_plugin_t *plugin, neu_plugin_group_t *group,
     // 初始化从站错误记录数组，用于标记每个从站是否出现过错误
     bool slave_err_record[MAX_SLAVES] = { false };
 
-    for (uint16_t i = 0; i < gd->cmd_sort->n_cmd; i++) {
+    // 串口总线上按截止时间调度命令，本周期占用总线不超过一个采集间隔
+    int64_t period    = (int64_t) group->interval * 1000;
+    int64_t cycle_end = modbus_bus_now_us() + period;
+    if (plugin->bus.enable) {
+        modbus_bus_schedule(gd->due, gd->order, gd->cmd_sort->n_cmd);
+    }
+
+    for (uint16_t k = 0; k < gd->cmd_sort->n_cmd; k++) {
+        uint16_t i   = plugin->bus.enable ? gd->order[k] : k;
+        int64_t  now = modbus_bus_now_us();
+
+        // 剩余命令保留原截止时间，让出总线给其他组，下个周期优先执行
+        if (plugin->bus.enable && k > 0 && period > 0 && now >= cycle_end) {
+            plog_debug(plugin, "group %s cycle overrun, defer %hu cmds",
+                       group->group_name, gd->cmd_sort->n_cmd - k);
+            break;
+        }
+        gd->due[i] = now + period;
+
         // 初始化当前命令的从站错误数组，用于标记每个从站在本次命令执行中的错误状态
         bool    slave_err[MAX_SLAVES] = { false };
 
@@ -536,8 +620,8 @@ int modbus_group_timer(neu_plugin_t *plugin, neu_plugin_group_t *group,
             }
         }
 
-        // 如果插件设置了读取间隔时间
-        if (plugin->interval > 0) {
+        // 如果插件设置了读取间隔时间，串口总线上在发送前等待帧间间隔
+        if (!plugin->bus.enable && plugin->interval > 0) {
             struct timespec t1 = { .tv_sec  = plugin->interval / 1000,
                                    .tv_nsec = 1000 * 1000 *
                                        (plugin->interval % 1000) };
@@ -548,6 +632,7 @@ int modbus_group_timer(neu_plugin_t *plugin, neu_plugin_group_t *group,
 
     // 读取操作完成后，更新性能指标，如 RTT、发送和接收字节数等
     update_metrics_after_read(plugin, rtt, group, &state);
+    report_bus_stat(plugin);
     return 0;
 }
 
@@ -576,12 +661,6 @@ int modbus_value_handle(void *ctx, uint8_t slave_id, uint16_t n_byte,
     struct modbus_group_data *gd =
         (struct modbus_group_data *) plugin->plugin_group_data;
 
-    // 获取当前命令的起始地址
-    uint16_t start_address = gd->cmd_sort->cmd[plugin->cmd_idx].start_address;
-
-    // 获取当前命令要读取的寄存器数量
-    uint16_t n_register    = gd->cmd_sort->cmd[plugin->cmd_idx].n_register;
-
     // 处理连接断开错误
     if (error == NEU_ERR_PLUGIN_DISCONNECTED) {
         // 初始化一个 neu_dvalue_t 结构体，用于存储值
@@ -620,128 +699,26 @@ int modbus_value_handle(void *ctx, uint8_t slave_id, uint16_t n_byte,
         return 0;
     }
 
+    // 按预先生成的解码步骤一次性解析整个响应
+    modbus_read_cmd_t *cmd = &gd->cmd_sort->cmd[plugin->cmd_idx];
+    modbus_read_cmd_decode(cmd, slave_id, bytes, n_byte, plugin->endianess);
+
     // 遍历当前命令中的所有标签
-    utarray_foreach(gd->cmd_sort->cmd[plugin->cmd_idx].tags, modbus_point_t **,
-                    p_tag)
+    uint16_t i = 0;
+    utarray_foreach(cmd->tags, modbus_point_t **, p_tag)
     {
-        // 初始化一个 neu_dvalue_t 结构体，用于存储值
-        neu_dvalue_t dvalue = { 0 };
-
-        // 检查标签的起始地址和寄存器数量是否超出范围，或者从站 ID 是否不匹配
-        if ((*p_tag)->start_address + (*p_tag)->n_register >
-                start_address + n_register ||
-            slave_id != (*p_tag)->slave_id) {
-            // 设置值的类型为错误类型
-            dvalue.type      = NEU_TYPE_ERROR;
-
-            // 设置错误码为读取失败
-            dvalue.value.i32 = NEU_ERR_PLUGIN_READ_FAILURE;
-        } else {
-            // 根据标签所在的 Modbus 区域进行不同处理
-            switch ((*p_tag)->area) {
-            case MODBUS_AREA_HOLD_REGISTER:
-            case MODBUS_AREA_INPUT_REGISTER:
-                // 检查读取的字节数是否足够
-                if (n_byte >= ((*p_tag)->start_address - start_address) * 2 +
-                        (*p_tag)->n_register * 2) {
-                    
-                    // 从读取的数据中复制相应的字节到 dvalue 中
-                    memcpy(dvalue.value.bytes.bytes,
-                           bytes +
-                               ((*p_tag)->start_address - start_address) * 2,
-                           (*p_tag)->n_register * 2);
-
-                    // 设置字节长度
-                    dvalue.value.bytes.length = (*p_tag)->n_register * 2;
-                }
-                break;
-            case MODBUS_AREA_COIL:
-            case MODBUS_AREA_INPUT: {
-                uint16_t offset = (*p_tag)->start_address - start_address;
-                if (n_byte > offset / 8) {
-                    neu_value8_u u8 = { .value = bytes[offset / 8] };
-
-                    dvalue.value.u8 = neu_value8_get_bit(u8, offset % 8);
-                }
-                break;
-            }
-            }
-
-            // 设置值的类型为标签的类型
-            dvalue.type = (*p_tag)->type;
-
-            // 根据值的类型进行不同的处理
-            switch ((*p_tag)->type) {
-            case NEU_TYPE_UINT16:
-            case NEU_TYPE_INT16:
-                dvalue.value.u16 = ntohs(dvalue.value.u16);
-                break;
-            case NEU_TYPE_FLOAT:
-            case NEU_TYPE_INT32:
-            case NEU_TYPE_UINT32:
-                if ((*p_tag)->option.value32.is_default) {
-                    modbus_convert_endianess(&dvalue.value, plugin->endianess);
-                }
-                dvalue.value.u32 = ntohl(dvalue.value.u32);
-                break;
-            case NEU_TYPE_DOUBLE:
-            case NEU_TYPE_INT64:
-            case NEU_TYPE_UINT64:
-                dvalue.value.u64 = neu_ntohll(dvalue.value.u64);
-                break;
-            case NEU_TYPE_BIT: {
-                switch ((*p_tag)->area) {
-                case MODBUS_AREA_HOLD_REGISTER:
-                case MODBUS_AREA_INPUT_REGISTER: {
-                    neu_value16_u v16 = { 0 };
-                    v16.value = htons(*(uint16_t *) dvalue.value.bytes.bytes);
-                    memset(&dvalue.value, 0, sizeof(dvalue.value));
-                    dvalue.value.u8 =
-                        neu_value16_get_bit(v16, (*p_tag)->option.bit.bit);
-                    break;
-                }
-                case MODBUS_AREA_COIL:
-                case MODBUS_AREA_INPUT:
-                    break;
-                }
-                break;
-            }
-            case NEU_TYPE_STRING: {
-                switch ((*p_tag)->option.string.type) {
-                case NEU_DATATAG_STRING_TYPE_H:
-                    break;
-                case NEU_DATATAG_STRING_TYPE_L:
-                    neu_datatag_string_ltoh(dvalue.value.str,
-                                            strlen(dvalue.value.str));
-                    break;
-                case NEU_DATATAG_STRING_TYPE_D:
-                    break;
-                case NEU_DATATAG_STRING_TYPE_E:
-                    break;
-                }
-
-                if (!neu_datatag_string_is_utf8(dvalue.value.str,
-                                                strlen(dvalue.value.str))) {
-                    dvalue.value.str[0] = '?';
-                    dvalue.value.str[1] = 0;
-                }
-                break;
-            }
-            default:
-                break;
-            }
-        }
+        neu_dvalue_t *dvalue = &cmd->values[i++];
 
         // 如果有跟踪信息
         if (trace) {
             // 调用带有跟踪信息的适配器更新函数，更新标签数据
             plugin->common.adapter_callbacks->driver.update_with_trace(
-                plugin->common.adapter, gd->group, (*p_tag)->name, dvalue, NULL,
-                0, trace);
+                plugin->common.adapter, gd->group, (*p_tag)->name, *dvalue,
+                NULL, 0, trace);
         } else {
             // 调用适配器的更新函数，更新标签数据
             plugin->common.adapter_callbacks->driver.update(
-                plugin->common.adapter, gd->group, (*p_tag)->name, dvalue);
+                plugin->common.adapter, gd->group, (*p_tag)->name, *dvalue);
         }
     }
     return 0;
@@ -994,6 +971,11 @@ static int write_modbus_point(neu_plugin_t *plugin, void *req,
     return ret;
 }
 
+/**
+ * @brief 发送一帧合并后的写命令并等待响应。
+ *
+ * @return 该帧的写结果，帧内所有点位共享这一结果。
+ */
 static int write_modbus_points(neu_plugin_t *      plugin,
                                modbus_write_cmd_t *write_cmd, void *req)
 {
@@ -1003,12 +985,23 @@ static int write_modbus_points(neu_plugin_t *      plugin,
                                  write_cmd->area, write_cmd->start_address,
                                  write_cmd->n_register, write_cmd->bytes,
                                  write_cmd->n_byte, &response_size, false);
-
-    if (ret > 0) {
-        process_protocol_buf(plugin, write_cmd->slave_id, response_size);
+    if (ret <= 0) {
+        return NEU_ERR_PLUGIN_DISCONNECTED;
     }
 
-    return ret;
+    ret = process_protocol_buf(plugin, write_cmd->slave_id, response_size);
+    switch (ret) {
+    case 0:
+        return NEU_ERR_PLUGIN_DEVICE_NOT_RESPONSE;
+    case -1:
+        // 响应与请求不匹配，断开连接以丢弃残留的数据
+        neu_conn_disconnect(plugin->conn);
+        return NEU_ERR_PLUGIN_PROTOCOL_DECODE_FAILURE;
+    case -2:
+        return NEU_ERR_PLUGIN_WRITE_FAILURE;
+    default:
+        return ret > 0 ? NEU_ERR_SUCCESS : NEU_ERR_PLUGIN_WRITE_FAILURE;
+    }
 }
 
 int modbus_write_tag(neu_plugin_t *plugin, void *req, neu_datatag_t *tag,
@@ -1026,7 +1019,7 @@ int modbus_write_tags(neu_plugin_t *plugin, void *req, UT_array *tags)
 {
     struct modbus_write_tags_data *gtags = NULL;
     int                            ret   = 0;
-    int                            rv    = 0;
+    int                            error = NEU_ERR_SUCCESS;
 
     gtags = calloc(1, sizeof(struct modbus_write_tags_data));
 
@@ -1040,12 +1033,29 @@ int modbus_write_tags(neu_plugin_t *plugin, void *req, UT_array *tags)
         utarray_push_back(gtags->tags, &p);
     }
     gtags->cmd_sort = modbus_write_tags_sort(gtags->tags, plugin->endianess);
+    plog_debug(plugin, "write %u tags in %hu frames", utarray_len(tags),
+               gtags->cmd_sort->n_cmd);
+
     for (uint16_t i = 0; i < gtags->cmd_sort->n_cmd; i++) {
-        ret = write_modbus_points(plugin, &gtags->cmd_sort->cmd[i], req);
-        if (ret <= 0) {
-            rv = 1;
+        modbus_write_cmd_t *cmd = &gtags->cmd_sort->cmd[i];
+
+        // 帧内所有点位共享该帧的结果，返回值取第一个失败帧的错误码
+        ret = write_modbus_points(plugin, cmd, req);
+        if (ret != NEU_ERR_SUCCESS && error == NEU_ERR_SUCCESS) {
+            error = ret;
+        }
+        utarray_foreach(cmd->tags, modbus_point_write_t **, tag)
+        {
+            (*tag)->error = ret;
+            if (ret != NEU_ERR_SUCCESS) {
+                plog_warn(plugin, "write tag %s (%hhu!%hu) fail: %d",
+                          (*tag)->point.name, cmd->slave_id,
+                          (*tag)->point.start_address, ret);
+            }
         }
-        if (plugin->interval > 0) {
+
+        // 串口总线由 modbus_bus_before_send 保证帧间间隔
+        if (plugin->interval > 0 && !plugin->bus.enable) {
             struct timespec t1 = { .tv_sec  = plugin->interval / 1000,
                                    .tv_nsec = 1000 * 1000 *
                                        (plugin->interval % 1000) };
@@ -1054,13 +1064,20 @@ int modbus_write_tags(neu_plugin_t *plugin, void *req, UT_array *tags)
         }
     }
 
-    if (rv == 0) {
-        plugin->common.adapter_callbacks->driver.write_response(
-            plugin->common.adapter, req, NEU_ERR_SUCCESS);
-    } else {
-        plugin->common.adapter_callbacks->driver.write_response(
-            plugin->common.adapter, req, NEU_ERR_PLUGIN_DISCONNECTED);
+    // 按请求中的点位顺序返回各点位的写结果，组名由驱动按请求补全
+    uint32_t                      n_tag = utarray_len(gtags->tags);
+    neu_driver_write_responses_t *responses =
+        calloc(n_tag, sizeof(neu_driver_write_responses_t));
+    for (uint32_t i = 0; i < n_tag; i++) {
+        modbus_point_write_t *p =
+            *(modbus_point_write_t **) utarray_eltptr(gtags->tags, i);
+
+        strcpy(responses[i].name, p->point.name);
+        responses[i].error = p->error;
     }
+    plugin->common.adapter_callbacks->driver.write_responses(
+        plugin->common.adapter, req, responses, (int) n_tag);
+    free(responses);
 
     for (uint16_t i = 0; i < gtags->cmd_sort->n_cmd; i++) {
         utarray_free(gtags->cmd_sort->cmd[i].tags);
@@ -1071,7 +1088,7 @@ int modbus_write_tags(neu_plugin_t *plugin, void *req, UT_array *tags)
     utarray_foreach(gtags->tags, modbus_point_write_t **, tag) { free(*tag); }
     utarray_free(gtags->tags);
     free(gtags);
-    return ret;
+    return error;
 }
 
 int modbus_write_resp(void *ctx, void *req, int error)
@@ -1093,6 +1110,8 @@ static void plugin_group_free(neu_plugin_group_t *pgp)
 
     utarray_free(gd->tags);
     free(gd->group);
+    free(gd->due);
+    free(gd->order);
 
     free(gd);
 }
@@ -1249,6 +1268,7 @@ static int process_modbus_rtu(neu_plugin_t *plugin, uint8_t *recv_buf,
 {
     // 从连接中接收数据，并将实际接收的字节数存储在 ret 中
     ssize_t ret = recv_data(plugin, recv_buf, response_size);
+    modbus_bus_after_recv(&plugin->bus, ret);
     if (ret == 0 || ret == -1) {
         return 0;
     }
@@ -21,6 +21,7 @@
 
 #include <neuron.h>
 
+#include "modbus_bus.h"
 #include "modbus_stack.h"
 
 /**
@@ -61,8 +62,19 @@ struct neu_plugin {
     bool             first_attempt_done;
     neu_conn_param_t param;
     neu_conn_param_t param_backup;
+
+    // 串口链路的帧间时序与调度统计，TCP 链路下不启用
+    modbus_bus_t bus;
+
+    // 每次轮询都会更新的节点级度量项句柄
+    neu_metric_handle_t *send_bytes_metric;
+    neu_metric_handle_t *recv_bytes_metric;
+    neu_metric_handle_t *last_rtt_metric;
+    neu_metric_handle_t *bus_utilization_metric;
 };
 
+void modbus_resolve_metrics(neu_plugin_t *plugin);
+
 void modbus_conn_connected(void *data, int fd);
 void modbus_conn_disconnected(void *data, int fd);
 void modbus_tcp_server_listen(void *data, int fd);
@@ -91,6 +91,8 @@ const neu_plugin_module_t neu_plugin_module = {
     .type      = NEU_NA_TYPE_DRIVER,
     .display   = true,
     .single    = false,
+    // 组采集时同步等待设备响应，使用独占事件循环
+    .dedicated_events = true,
 };
 
 static neu_plugin_t *driver_open(void)
@@ -117,6 +119,8 @@ static int driver_init(neu_plugin_t *plugin, bool load)
     plugin->stack    = modbus_stack_create((void *) plugin, MODBUS_PROTOCOL_RTU,
                                         modbus_send_msg, modbus_value_handle,
                                         modbus_write_resp);
+    NEU_PLUGIN_REGISTER_METRIC(plugin, NEU_METRIC_BUS_UTILIZATION, 0);
+    modbus_resolve_metrics(plugin);
 
     plog_notice(plugin, "%s init success", plugin->common.name);
     return 0;
@@ -260,6 +264,20 @@ static int driver_config(neu_plugin_t *plugin, const char *config)
     plugin->address_base   = address_base.v.val_int;
 
     if (link.v.val_int == 0) {
+        modbus_rtu_timing_t timing = { 0 };
+        if (0 !=
+            modbus_rtu_timing(baud.v.val_int, data.v.val_int,
+                              parity.v.val_int, stop.v.val_int, &timing)) {
+            plog_error(plugin, "config: %s, invalid serial settings", config);
+            free(device.v.val_str);
+            return -1;
+        }
+        modbus_bus_config(&plugin->bus, &timing, plugin->interval);
+        plog_notice(plugin,
+                    "config: t1.5: %" PRIu32 "us, t3.5: %" PRIu32
+                    "us, frame gap: %" PRIu32 "us",
+                    timing.t15_us, timing.t35_us, plugin->bus.gap_us);
+
         param.type = NEU_CONN_TTY_CLIENT;
 
         param.params.tty_client.device  = device.v.val_str;
@@ -294,6 +312,7 @@ static int driver_config(neu_plugin_t *plugin, const char *config)
             plugin->is_server               = false;
         }
 
+        modbus_bus_disable(&plugin->bus);
         plog_notice(plugin,
                     "config: host: %s, port: %" PRId64 ", mode: %" PRId64 "",
                     host.v.val_str, port.v.val_int, mode.v.val_int);
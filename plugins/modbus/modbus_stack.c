@@ -106,14 +106,6 @@ struct modbus_stack {
      * 缓冲区的大小，用于限制存储在缓冲区中的数据量，避免缓冲区溢出。
      */
     uint16_t buf_size;
-
-    /**
-     * @brief 采样计数器。
-     * 
-     * 用于 OpenTelemetry 数据采样的计数器，在进行数据采样时，
-     * 通过该计数器判断是否满足采样条件，以控制采样的频率和比例。
-     */
-    int64_t sample_mod;
 };
 
 /**
@@ -148,7 +140,8 @@ modbus_stack_t *modbus_stack_create(void *ctx, modbus_protocol_e protocol,
     stack->write_resp = write_resp;
     stack->protocol   = protocol;
 
-    stack->buf_size = 256;
+    // 按 Modbus TCP ADU 的最大长度分配，可容纳 123 个寄存器的 FC16 请求
+    stack->buf_size = 260;
     stack->buf      = calloc(stack->buf_size, 1);
 
     return stack;
@@ -585,69 +578,53 @@ int modbus_stack_read(modbus_stack_t *stack, uint8_t slave_id,
     } else {
         // 如果 OpenTelemetry 数据采集已启动
         if (neu_otel_data_is_started()) {
-            // 获取 OpenTelemetry 数据采样率
-            double rate        = neu_otel_data_sample_rate();
-            
-            // 计算采样间隔
-            int    sample_rate = 0;
-            if (rate > 0.0 && rate <= 1.0) {
-                sample_rate = (int) (1.0 / rate);
-            }
-
-            // 如果采样间隔不为 0
-            if (sample_rate != 0) {
-                // 增加采样计数器
-                stack->sample_mod += 1;
-
-                // 如果达到采样间隔
-                if (stack->sample_mod % sample_rate == 0) {
-                    // 生成新的跟踪 ID
-                    char new_trace_id[64] = { 0 };
-                    neu_otel_new_trace_id(new_trace_id);
+            // 按采样率决定本次读取是否记录追踪
+            if (neu_otel_data_sampled()) {
+                // 生成新的跟踪 ID
+                char new_trace_id[64] = { 0 };
+                neu_otel_new_trace_id(new_trace_id);
 
-                    // 跟踪状态信息
-                    const char *trace_state  = "span.mytype=data-collection";
+                // 跟踪状态信息
+                const char *trace_state  = "span.mytype=data-collection";
 
-                    // 跟踪上下文和范围上下文指针
-                    neu_otel_trace_ctx trace = NULL;
-                    neu_otel_scope_ctx scope = NULL;
+                // 跟踪上下文和范围上下文指针
+                neu_otel_trace_ctx trace = NULL;
+                neu_otel_scope_ctx scope = NULL;
 
-                    // 创建跟踪上下文
-                    trace                    = neu_otel_create_trace(
-                        new_trace_id, (void *) (intptr_t) stack->read_seq, 0,
-                        trace_state);
+                // 创建跟踪上下文
+                trace                    = neu_otel_create_trace(
+                    new_trace_id, (void *) (intptr_t) stack->read_seq, 0,
+                    trace_state);
 
-                    // 添加跟踪范围
-                    scope = neu_otel_add_span(trace);
+                // 添加跟踪范围
+                scope = neu_otel_add_span(trace);
 
-                    // 设置跟踪范围的名称
-                    neu_otel_scope_set_span_name(scope, "driver cmd send");
+                // 设置跟踪范围的名称
+                neu_otel_scope_set_span_name(scope, "driver cmd send");
 
-                    // 生成新的跨度 ID
-                    char new_span_id[36] = { 0 };
-                    neu_otel_new_span_id(new_span_id);
+                // 生成新的跨度 ID
+                char new_span_id[36] = { 0 };
+                neu_otel_new_span_id(new_span_id);
 
-                    // 设置跟踪范围的跨度 ID
-                    neu_otel_scope_set_span_id(scope, new_span_id);
+                // 设置跟踪范围的跨度 ID
+                neu_otel_scope_set_span_id(scope, new_span_id);
 
-                    // 设置跟踪范围的标志
-                    neu_otel_scope_set_span_flags(scope, 0);
+                // 设置跟踪范围的标志
+                neu_otel_scope_set_span_flags(scope, 0);
 
-                    // 设置跟踪范围的开始时间
-                    neu_otel_scope_set_span_start_time(scope, ts_start);
+                // 设置跟踪范围的开始时间
+                neu_otel_scope_set_span_start_time(scope, ts_start);
 
-                    // 添加线程 ID 作为跟踪范围的属性
-                    neu_otel_scope_add_span_attr_int(scope, "thread id",
-                                                     (int64_t) pthread_self());
+                // 添加线程 ID 作为跟踪范围的属性
+                neu_otel_scope_add_span_attr_int(scope, "thread id",
+                                                 (int64_t) pthread_self());
 
-                    // 添加节点名称作为跟踪范围的属性
-                    neu_otel_scope_add_span_attr_string(
-                        scope, "node",
-                        ((neu_plugin_t *) stack->ctx)->common.name);
+                // 添加节点名称作为跟踪范围的属性
+                neu_otel_scope_add_span_attr_string(
+                    scope, "node", ((neu_plugin_t *) stack->ctx)->common.name);
 
-                    // 设置跟踪范围的结束时间
-                    neu_otel_scope_set_span_end_time(scope, neu_time_ns());
-                }
+                // 设置跟踪范围的结束时间
+                neu_otel_scope_set_span_end_time(scope, neu_time_ns());
             }
         }
     }
@@ -656,7 +633,7 @@ int modbus_stack_read(modbus_stack_t *stack, uint8_t slave_id,
 
 int modbus_stack_write(modbus_stack_t *stack, void *req, uint8_t slave_id,
                        enum modbus_area area, uint16_t start_address,
-                       uint16_t n_reg, uint8_t *bytes, uint8_t n_byte,
+                       uint16_t n_reg, uint8_t *bytes, uint16_t n_byte,
                        uint16_t *response_size, bool response)
 {
     static __thread neu_protocol_pack_buf_t pbuf     = { 0 };
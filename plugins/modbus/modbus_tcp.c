@@ -88,6 +88,8 @@ const neu_plugin_module_t neu_plugin_module = {
     .type      = NEU_NA_TYPE_DRIVER,
     .display   = true,
     .single    = false,
+    // 组采集时同步等待设备响应，使用独占事件循环
+    .dedicated_events = true,
 };
 
 static neu_plugin_t *driver_open(void)
@@ -114,6 +116,7 @@ static int driver_init(neu_plugin_t *plugin, bool load)
     plugin->stack    = modbus_stack_create((void *) plugin, MODBUS_PROTOCOL_TCP,
                                         modbus_send_msg, modbus_value_handle,
                                         modbus_write_resp);
+    modbus_resolve_metrics(plugin);
 
     plog_notice(plugin, "%s init success", plugin->common.name);
     return 0;
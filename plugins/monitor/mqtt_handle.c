@@ -36,7 +36,7 @@ static char *generate_heartbeat_json(neu_plugin_t *plugin, UT_array *states)
     (void) plugin;
     char *                 version  = NEURON_VERSION;
     neu_json_states_head_t header   = { .version   = version,
-                                      .timpstamp = global_timestamp };
+                                      .timpstamp = neu_time_ms() };
     neu_json_states_t      json     = { 0 };
     char *                 json_str = NULL;
 
@@ -320,12 +320,13 @@ static int azure_plugin_request(neu_plugin_t *plugin, neu_reqresp_head_t *head,
     neu_err_code_e error = NEU_ERR_SUCCESS;
 
     // update cached messages number per seconds
+    int64_t now = neu_time_mono_ms_coarse();
     if (NULL != plugin->client &&
-        (global_timestamp - plugin->cache_metric_update_ts) >= 1000) {
-        NEU_PLUGIN_UPDATE_METRIC(
-            plugin, NEU_METRIC_CACHED_MSGS_NUM,
-            neu_mqtt_client_get_cached_msgs_num(plugin->client), NULL);
-        plugin->cache_metric_update_ts = global_timestamp;
+        (now - plugin->cache_metric_update_ts) >= 1000) {
+        neu_metric_handle_update(
+            plugin->metrics.cached_msgs,
+            neu_mqtt_client_get_cached_msgs_num(plugin->client));
+        plugin->cache_metric_update_ts = now;
     }
 
     switch (head->type) {
@@ -333,16 +334,15 @@ static int azure_plugin_request(neu_plugin_t *plugin, neu_reqresp_head_t *head,
         error =
             handle_write_response(plugin, head->ctx, data, NULL, NULL, NULL);
         break;
+    case NEU_RESP_WRITE_TAGS:
+        error = handle_write_tags_response(plugin, head->ctx, data);
+        break;
     case NEU_RESP_READ_GROUP:
         // error = handle_read_response(plugin, head->ctx, data);
         break;
     case NEU_REQRESP_TRANS_DATA: {
         if (plugin->client && neu_mqtt_client_is_open(plugin->client)) {
-            NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_TRANS_DATA_5S, 1, NULL);
-            NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_TRANS_DATA_30S, 1,
-                                     NULL);
-            NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_TRANS_DATA_60S, 1,
-                                     NULL);
+            neu_metric_handles_update(plugin->metrics.trans_data, 3, 1);
         }
         error = azure_handle_trans_data(plugin, data);
         break;
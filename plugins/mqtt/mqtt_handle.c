@@ -106,7 +106,7 @@ char *generate_upload_json(neu_plugin_t *plugin, neu_reqresp_trans_data_t *data,
     char *                   json_str = NULL;
     neu_json_read_periodic_t header   = { .group     = (char *) data->group,
                                         .node      = (char *) data->driver,
-                                        .timestamp = global_timestamp };
+                                        .timestamp = neu_time_ms() };
     neu_json_read_resp_t     json     = { 0 };
 
     if (!plugin->config.upload_err && skip != NULL) {
@@ -234,7 +234,7 @@ static char *generate_heartbeat_json(neu_plugin_t *plugin, UT_array *states,
                                      bool *drv_none)
 {
     (void) plugin;
-    neu_json_states_head_t header   = { .timpstamp = global_timestamp };
+    neu_json_states_head_t header   = { .timpstamp = neu_time_ms() };
     neu_json_states_t      json     = { 0 };
     char *                 json_str = NULL;
 
@@ -490,13 +490,10 @@ static void publish_cb(int errcode, neu_mqtt_qos_e qos, char *topic,
     neu_plugin_t *plugin = data;
 
     if (0 == errcode) {
-        NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_SEND_MSGS_TOTAL, 1, NULL);
-        NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_SEND_BYTES_5S, len, NULL);
-        NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_SEND_BYTES_30S, len, NULL);
-        NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_SEND_BYTES_60S, len, NULL);
+        neu_metric_handle_update(plugin->metrics.send_msgs_total, 1);
+        neu_metric_handles_update(plugin->metrics.send_bytes, 3, len);
     } else {
-        NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_SEND_MSG_ERRORS_TOTAL, 1,
-                                 NULL);
+        neu_metric_handle_update(plugin->metrics.send_msg_errors_total, 1);
     }
 
     free(payload);
@@ -511,8 +508,7 @@ int publish(neu_plugin_t *plugin, neu_mqtt_qos_e qos, char *topic,
                                 (uint32_t) payload_len, plugin, publish_cb);
     if (0 != rv) {
         plog_error(plugin, "pub [%s, QoS%d] fail", topic, qos);
-        NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_SEND_MSG_ERRORS_TOTAL, 1,
-                                 NULL);
+        neu_metric_handle_update(plugin->metrics.send_msg_errors_total, 1);
         free(payload);
         rv = NEU_ERR_MQTT_PUBLISH_FAILURE;
     }
@@ -529,8 +525,7 @@ int publish_with_trace(neu_plugin_t *plugin, neu_mqtt_qos_e qos, char *topic,
         plugin, publish_cb, traceparent);
     if (0 != rv) {
         plog_error(plugin, "pub [%s, QoS%d] fail", topic, qos);
-        NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_SEND_MSG_ERRORS_TOTAL, 1,
-                                 NULL);
+        neu_metric_handle_update(plugin->metrics.send_msg_errors_total, 1);
         free(payload);
         rv = NEU_ERR_MQTT_PUBLISH_FAILURE;
     }
@@ -551,13 +546,9 @@ void handle_write_req(neu_mqtt_qos_e qos, const char *topic,
     (void) qos;
     (void) topic;
 
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_MSGS_TOTAL, 1, NULL);
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_BYTES_5S, len, NULL);
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_BYTES_30S, len, NULL);
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_BYTES_60S, len, NULL);
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_MSGS_5S, 1, NULL);
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_MSGS_30S, 1, NULL);
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_MSGS_60S, 1, NULL);
+    neu_metric_handle_update(plugin->metrics.recv_msgs_total, 1);
+    neu_metric_handles_update(plugin->metrics.recv_bytes, 3, len);
+    neu_metric_handles_update(plugin->metrics.recv_msgs, 3, 1);
 
     if (plugin->config.format == MQTT_UPLOAD_FORMAT_PROTOBUF) {
         Model__WriteRequest *wr =
@@ -949,13 +940,9 @@ void handle_read_req(neu_mqtt_qos_e qos, const char *topic,
     (void) qos;
     (void) topic;
 
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_MSGS_TOTAL, 1, NULL);
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_BYTES_5S, len, NULL);
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_BYTES_30S, len, NULL);
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_BYTES_60S, len, NULL);
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_MSGS_5S, 1, NULL);
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_MSGS_30S, 1, NULL);
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_RECV_MSGS_60S, 1, NULL);
+    neu_metric_handle_update(plugin->metrics.recv_msgs_total, 1);
+    neu_metric_handles_update(plugin->metrics.recv_bytes, 3, len);
+    neu_metric_handles_update(plugin->metrics.recv_msgs, 3, 1);
 
     if (plugin->config.format == MQTT_UPLOAD_FORMAT_PROTOBUF) {
         Model__ReadRequest *read_req =
@@ -1298,7 +1285,7 @@ int handle_trans_data(neu_plugin_t *            plugin,
 
             data_report.node      = trans_data->driver;
             data_report.group     = trans_data->group;
-            data_report.timestamp = global_timestamp;
+            data_report.timestamp = neu_time_ms();
             data_report.n_tags    = utarray_len(trans_data->tags) + n_satic_tag;
             data_report.tags =
                 calloc(data_report.n_tags, sizeof(Model__DataItem *));
@@ -1664,7 +1651,7 @@ int handle_nodes_state(neu_plugin_t *plugin, neu_reqresp_nodes_state_t *states)
     if (plugin->config.format == MQTT_UPLOAD_FORMAT_PROTOBUF) {
         Model__NodeStateReport nsr = MODEL__NODE_STATE_REPORT__INIT;
 
-        nsr.timestamp = global_timestamp;
+        nsr.timestamp = neu_time_ms();
         nsr.n_nodes   = utarray_len(states->states);
 
         Model__NodeState **node_states =
@@ -43,6 +43,19 @@ typedef struct {
     UT_hash_handle hh;
 } route_entry_t;
 
+// 初始化时解析的度量项句柄，三个元素依次对应 5s/30s/60s 或 60s/600s/1800s
+typedef struct {
+    neu_metric_handle_t *cached_msgs;
+    neu_metric_handle_t *trans_data[3];
+    neu_metric_handle_t *send_msgs_total;
+    neu_metric_handle_t *send_msg_errors_total;
+    neu_metric_handle_t *send_bytes[3];
+    neu_metric_handle_t *recv_msgs_total;
+    neu_metric_handle_t *recv_bytes[3];
+    neu_metric_handle_t *recv_msgs[3];
+    neu_metric_handle_t *disconnection[3];
+} mqtt_metrics_t;
+
 struct neu_plugin {
     neu_plugin_common_t common;
     neu_events_t *      events;
@@ -54,6 +67,7 @@ struct neu_plugin {
     char *              read_resp_topic;
     char *              upload_topic;
     route_entry_t *     route_tbl;
+    mqtt_metrics_t      metrics;
 
     int (*parse_config)(neu_plugin_t *plugin, const char *setting,
                         mqtt_config_t *config);
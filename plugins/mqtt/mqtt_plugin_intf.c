@@ -104,9 +104,7 @@ static void disconnect_cb(void *data)
 {
     neu_plugin_t *plugin      = data;
     plugin->common.link_state = NEU_NODE_LINK_STATE_DISCONNECTED;
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_DISCONNECTION_60S, 1, NULL);
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_DISCONNECTION_600S, 1, NULL);
-    NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_DISCONNECTION_1800S, 1, NULL);
+    neu_metric_handles_update(plugin->metrics.disconnection, 3, 1);
     plog_notice(plugin, "plugin `%s` disconnected",
                 neu_plugin_module.module_name);
 }
@@ -130,6 +128,34 @@ int mqtt_plugin_close(neu_plugin_t *plugin)
     return NEU_ERR_SUCCESS;
 }
 
+#define METRIC_HANDLE(name) NEU_PLUGIN_METRIC_HANDLE(plugin, name, NULL)
+
+// 发送、接收相关度量项由适配器注册，仅在节点可见时存在，句柄可能为 NULL
+static void mqtt_metrics_resolve(neu_plugin_t *plugin)
+{
+    mqtt_metrics_t *m = &plugin->metrics;
+
+    m->cached_msgs           = METRIC_HANDLE(NEU_METRIC_CACHED_MSGS_NUM);
+    m->trans_data[0]         = METRIC_HANDLE(NEU_METRIC_TRANS_DATA_5S);
+    m->trans_data[1]         = METRIC_HANDLE(NEU_METRIC_TRANS_DATA_30S);
+    m->trans_data[2]         = METRIC_HANDLE(NEU_METRIC_TRANS_DATA_60S);
+    m->send_msgs_total       = METRIC_HANDLE(NEU_METRIC_SEND_MSGS_TOTAL);
+    m->send_msg_errors_total = METRIC_HANDLE(NEU_METRIC_SEND_MSG_ERRORS_TOTAL);
+    m->send_bytes[0]         = METRIC_HANDLE(NEU_METRIC_SEND_BYTES_5S);
+    m->send_bytes[1]         = METRIC_HANDLE(NEU_METRIC_SEND_BYTES_30S);
+    m->send_bytes[2]         = METRIC_HANDLE(NEU_METRIC_SEND_BYTES_60S);
+    m->recv_msgs_total       = METRIC_HANDLE(NEU_METRIC_RECV_MSGS_TOTAL);
+    m->recv_bytes[0]         = METRIC_HANDLE(NEU_METRIC_RECV_BYTES_5S);
+    m->recv_bytes[1]         = METRIC_HANDLE(NEU_METRIC_RECV_BYTES_30S);
+    m->recv_bytes[2]         = METRIC_HANDLE(NEU_METRIC_RECV_BYTES_60S);
+    m->recv_msgs[0]          = METRIC_HANDLE(NEU_METRIC_RECV_MSGS_5S);
+    m->recv_msgs[1]          = METRIC_HANDLE(NEU_METRIC_RECV_MSGS_30S);
+    m->recv_msgs[2]          = METRIC_HANDLE(NEU_METRIC_RECV_MSGS_60S);
+    m->disconnection[0]      = METRIC_HANDLE(NEU_METRIC_DISCONNECTION_60S);
+    m->disconnection[1]      = METRIC_HANDLE(NEU_METRIC_DISCONNECTION_600S);
+    m->disconnection[2]      = METRIC_HANDLE(NEU_METRIC_DISCONNECTION_1800S);
+}
+
 int mqtt_plugin_init(neu_plugin_t *plugin, bool load)
 {
     (void) load;
@@ -150,6 +176,7 @@ int mqtt_plugin_init(neu_plugin_t *plugin, bool load)
     NEU_PLUGIN_REGISTER_METRIC(plugin, NEU_METRIC_DISCONNECTION_60S, 60000);
     NEU_PLUGIN_REGISTER_METRIC(plugin, NEU_METRIC_DISCONNECTION_600S, 600000);
     NEU_PLUGIN_REGISTER_METRIC(plugin, NEU_METRIC_DISCONNECTION_1800S, 1800000);
+    mqtt_metrics_resolve(plugin);
 
     plog_notice(plugin, "initialize plugin `%s` success",
                 neu_plugin_module.module_name);
@@ -517,12 +544,13 @@ int mqtt_plugin_request(neu_plugin_t *plugin, neu_reqresp_head_t *head,
     neu_err_code_e error = NEU_ERR_SUCCESS;
 
     // update cached messages number per seconds
+    int64_t now = neu_time_mono_ms_coarse();
     if (NULL != plugin->client &&
-        (global_timestamp - plugin->cache_metric_update_ts) >= 1000) {
-        NEU_PLUGIN_UPDATE_METRIC(
-            plugin, NEU_METRIC_CACHED_MSGS_NUM,
-            neu_mqtt_client_get_cached_msgs_num(plugin->client), NULL);
-        plugin->cache_metric_update_ts = global_timestamp;
+        (now - plugin->cache_metric_update_ts) >= 1000) {
+        neu_metric_handle_update(
+            plugin->metrics.cached_msgs,
+            neu_mqtt_client_get_cached_msgs_num(plugin->client));
+        plugin->cache_metric_update_ts = now;
     }
 
     neu_otel_trace_ctx trace           = NULL;
@@ -580,11 +608,7 @@ int mqtt_plugin_request(neu_plugin_t *plugin, neu_reqresp_head_t *head,
         break;
     case NEU_REQRESP_TRANS_DATA: {
         if (plugin->client && neu_mqtt_client_is_open(plugin->client)) {
-            NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_TRANS_DATA_5S, 1, NULL);
-            NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_TRANS_DATA_30S, 1,
-                                     NULL);
-            NEU_PLUGIN_UPDATE_METRIC(plugin, NEU_METRIC_TRANS_DATA_60S, 1,
-                                     NULL);
+            neu_metric_handles_update(plugin->metrics.trans_data, 3, 1);
         }
         error = handle_trans_data(plugin, data);
         break;
@@ -147,7 +147,7 @@ static void *schema_encode(char *driver, char *group,
         switch (vts[i].vt) {
         case MQTT_SCHEMA_TIMESTAMP:
             elem.t         = NEU_JSON_INT;
-            elem.v.val_int = global_timestamp;
+            elem.v.val_int = neu_time_ms();
             break;
         case MQTT_SCHEMA_NODE_NAME:
             elem.t         = NEU_JSON_STR;
@@ -87,6 +87,7 @@ void handle_add_tags(nng_aio *aio)
                         cmd.tags[i].precision = req->tags[i].precision;
                         cmd.tags[i].decimal   = req->tags[i].decimal;
                         cmd.tags[i].bias      = req->tags[i].bias;
+                        cmd.tags[i].deadband  = req->tags[i].deadband;
                         cmd.tags[i].address   = strdup(req->tags[i].address);
                         cmd.tags[i].name      = strdup(req->tags[i].name);
                         if (req->tags[i].description != NULL) {
@@ -206,6 +207,8 @@ void handle_add_gtags(nng_aio *aio)
                             req->groups[i].tags[j].decimal;
                         cmd.groups[i].tags[j].bias =
                             req->groups[i].tags[j].bias;
+                        cmd.groups[i].tags[j].deadband =
+                            req->groups[i].tags[j].deadband;
                         cmd.groups[i].tags[j].address =
                             strdup(req->groups[i].tags[j].address);
                         cmd.groups[i].tags[j].name =
@@ -330,6 +333,7 @@ void handle_update_tags(nng_aio *aio)
                 cmd.tags[i].precision = req->tags[i].precision;
                 cmd.tags[i].decimal   = req->tags[i].decimal;
                 cmd.tags[i].bias      = req->tags[i].bias;
+                cmd.tags[i].deadband  = req->tags[i].deadband;
                 cmd.tags[i].address   = strdup(req->tags[i].address);
                 cmd.tags[i].name      = strdup(req->tags[i].name);
                 if (req->tags[i].description != NULL) {
@@ -417,6 +421,7 @@ void handle_get_tags_resp(nng_aio *aio, neu_resp_get_tag_t *tags)
         tags_res.tags[index].precision   = tag->precision;
         tags_res.tags[index].decimal     = tag->decimal;
         tags_res.tags[index].bias        = tag->bias;
+        tags_res.tags[index].deadband    = tag->deadband;
         tags_res.tags[index].t           = NEU_JSON_UNDEFINE;
     }
 
@@ -32,9 +32,11 @@
 #include "json/neu_json_error.h"
 #include "json/neu_json_fn.h"
 
+#include "core/config_import.h"
 #include "handle.h"
 #include "tag.h"
 #include "utils/http.h"
+#include "utils/log.h"
 #include "utils/set.h"
 #include "utils/utarray.h"
 
@@ -821,6 +823,7 @@ static int get_tags_resp(context_t *ctx, neu_resp_get_tag_t *tags)
         tags_res.tags[index].precision   = tag->precision;
         tags_res.tags[index].decimal     = tag->decimal;
         tags_res.tags[index].bias        = tag->bias;
+        tags_res.tags[index].deadband    = tag->deadband;
         tags_res.tags[index].t           = NEU_JSON_UNDEFINE;
     }
 
@@ -901,6 +904,7 @@ static int get_driver_tags_resp(context_t *ctx, neu_resp_get_tag_t *tags)
         gtag->tags[index].precision   = tag->precision;
         gtag->tags[index].decimal     = tag->decimal;
         gtag->tags[index].bias        = tag->bias;
+        gtag->tags[index].deadband    = tag->deadband;
         gtag->tags[index].t           = NEU_JSON_UNDEFINE;
         tag->name                     = NULL; // moved
         tag->address                  = NULL; // moved
@@ -1169,6 +1173,7 @@ static int add_tag(context_t *ctx, neu_json_add_tags_req_t *data)
         cmd.tags[i].precision = data->tags[i].precision;
         cmd.tags[i].decimal   = data->tags[i].decimal;
         cmd.tags[i].bias      = data->tags[i].bias;
+        cmd.tags[i].deadband  = data->tags[i].deadband;
         cmd.tags[i].address   = strdup(data->tags[i].address);
         cmd.tags[i].name      = strdup(data->tags[i].name);
         cmd.tags[i].description =
@@ -1242,6 +1247,381 @@ static int add_setting(context_t *ctx, neu_json_node_setting_req_t *data)
     return 0;
 }
 
+#define IMPORT_KEY_LEN \
+    (NEU_NODE_NAME_LEN * 2 + NEU_GROUP_NAME_LEN + NEU_TAG_NAME_LEN)
+
+static void import_key(char *key, const char *a, const char *b, const char *c)
+{
+    snprintf(key, IMPORT_KEY_LEN, "%s\x1f%s\x1f%s", a, b, c ? c : "");
+}
+
+static int import_check_nodes(neu_json_get_nodes_resp_t *nodes,
+                              neu_strset_t *             node_seen)
+{
+    for (int i = 0; i < nodes->n_node; ++i) {
+        neu_json_get_nodes_resp_node_t *node = &nodes->nodes[i];
+
+        if (is_static_node(node->name, node->plugin)) {
+            continue;
+        }
+        if (strlen(node->name) >= NEU_NODE_NAME_LEN) {
+            return NEU_ERR_NODE_NAME_TOO_LONG;
+        }
+        if (strlen(node->plugin) >= NEU_PLUGIN_NAME_LEN) {
+            return NEU_ERR_PLUGIN_NAME_TOO_LONG;
+        }
+        if (1 != neu_strset_add(node_seen, node->name)) {
+            // duplicate node name
+            return NEU_ERR_BODY_IS_WRONG;
+        }
+    }
+
+    if (neu_strset_count(node_seen) > UINT16_MAX) {
+        return NEU_ERR_BODY_IS_WRONG;
+    }
+
+    return 0;
+}
+
+static int import_check_groups(neu_json_get_driver_group_resp_t *groups,
+                               neu_strset_t *                    node_seen,
+                               neu_strset_t *                    group_seen)
+{
+    char key[IMPORT_KEY_LEN];
+
+    for (int i = 0; i < groups->n_group; ++i) {
+        neu_json_get_driver_group_resp_group_t *group = &groups->groups[i];
+
+        if (!neu_strset_test(node_seen, group->driver)) {
+            return NEU_ERR_NODE_NOT_EXIST;
+        }
+        if (strlen(group->group) >= NEU_GROUP_NAME_LEN) {
+            return NEU_ERR_GROUP_NAME_TOO_LONG;
+        }
+        if (group->interval < NEU_GROUP_INTERVAL_LIMIT) {
+            return NEU_ERR_GROUP_PARAMETER_INVALID;
+        }
+
+        import_key(key, group->driver, group->group, NULL);
+        int rv = neu_strset_add_dup(group_seen, key);
+        if (0 == rv) {
+            return NEU_ERR_GROUP_EXIST;
+        } else if (rv < 0) {
+            return NEU_ERR_EINTERNAL;
+        }
+    }
+
+    return 0;
+}
+
+static int import_check_tags(neu_json_global_config_req_tags_t *tags,
+                             neu_strset_t *                     group_seen)
+{
+    int          rv       = 0;
+    neu_strset_t tag_seen = NULL;
+    char         key[IMPORT_KEY_LEN];
+
+    for (int i = 0; 0 == rv && i < tags->n_tag; ++i) {
+        neu_json_add_tags_req_t *req = &tags->tags[i];
+
+        import_key(key, req->node, req->group, NULL);
+        if (!neu_strset_test(group_seen, key)) {
+            rv = NEU_ERR_GROUP_NOT_EXIST;
+            break;
+        }
+
+        for (int j = 0; j < req->n_tag; ++j) {
+            neu_json_tag_t *tag = &req->tags[j];
+
+            if (strlen(tag->name) >= NEU_TAG_NAME_LEN) {
+                rv = NEU_ERR_TAG_NAME_TOO_LONG;
+            } else if (strlen(tag->address) >= NEU_TAG_ADDRESS_LEN) {
+                rv = NEU_ERR_TAG_ADDRESS_TOO_LONG;
+            } else if (tag->description &&
+                       strlen(tag->description) >= NEU_TAG_DESCRIPTION_LEN) {
+                rv = NEU_ERR_TAG_DESCRIPTION_TOO_LONG;
+            } else if (tag->precision > NEU_TAG_FLOAG_PRECISION_MAX) {
+                rv = NEU_ERR_TAG_PRECISION_INVALID;
+            }
+            if (0 != rv) {
+                break;
+            }
+
+            import_key(key, req->node, req->group, tag->name);
+            int ret = neu_strset_add_dup(&tag_seen, key);
+            if (ret <= 0) {
+                rv = 0 == ret ? NEU_ERR_TAG_NAME_CONFLICT : NEU_ERR_EINTERNAL;
+                break;
+            }
+        }
+    }
+
+    neu_strset_free_dup(&tag_seen);
+    return rv;
+}
+
+static int import_check_subscriptions(
+    neu_json_global_config_req_subscriptions_t *subs, neu_strset_t *node_seen,
+    neu_strset_t *group_seen)
+{
+    int          rv       = 0;
+    neu_strset_t sub_seen = NULL;
+    char         key[IMPORT_KEY_LEN];
+
+    for (int i = 0; i < subs->n_subscription; ++i) {
+        neu_json_subscribe_req_t *sub = &subs->subscriptions[i];
+
+        if (!neu_strset_test(node_seen, sub->app) ||
+            !neu_strset_test(node_seen, sub->driver)) {
+            rv = NEU_ERR_NODE_NOT_EXIST;
+            break;
+        }
+        if (0 == strcmp(sub->app, sub->driver)) {
+            rv = NEU_ERR_NODE_NOT_ALLOW_SUBSCRIBE;
+            break;
+        }
+
+        import_key(key, sub->driver, sub->group, NULL);
+        if (!neu_strset_test(group_seen, key)) {
+            rv = NEU_ERR_GROUP_NOT_EXIST;
+            break;
+        }
+
+        import_key(key, sub->app, sub->driver, sub->group);
+        int ret = neu_strset_add_dup(&sub_seen, key);
+        if (ret <= 0) {
+            rv = 0 == ret ? NEU_ERR_GROUP_ALREADY_SUBSCRIBED
+                          : NEU_ERR_EINTERNAL;
+            break;
+        }
+    }
+
+    neu_strset_free_dup(&sub_seen);
+    return rv;
+}
+
+/**
+ * @brief 导入前检查整份配置，任何一项不合法都不做修改。
+ *
+ * 静态节点不导入，其它部分也不能引用静态节点。
+ */
+static int import_check(neu_json_global_config_req_t *req)
+{
+    int          rv         = 0;
+    neu_strset_t node_seen  = NULL;
+    neu_strset_t group_seen = NULL;
+    neu_strset_t set_seen   = NULL;
+
+    rv = import_check_nodes(req->nodes, &node_seen);
+    if (0 == rv) {
+        rv = import_check_groups(req->groups, &node_seen, &group_seen);
+    }
+    if (0 == rv) {
+        rv = import_check_tags(req->tags, &group_seen);
+    }
+    if (0 == rv) {
+        rv = import_check_subscriptions(req->subscriptions, &node_seen,
+                                        &group_seen);
+    }
+
+    for (int i = 0; 0 == rv && i < req->settings->n_setting; ++i) {
+        const char *node = req->settings->settings[i].node;
+
+        if (!neu_strset_test(&node_seen, node)) {
+            rv = NEU_ERR_NODE_NOT_EXIST;
+        } else if (1 != neu_strset_add(&set_seen, node)) {
+            // duplicate setting
+            rv = NEU_ERR_BODY_IS_WRONG;
+        }
+    }
+
+    neu_strset_free(&node_seen);
+    neu_strset_free_dup(&group_seen);
+    neu_strset_free(&set_seen);
+    return rv;
+}
+
+static neu_req_driver_t *import_find_node(neu_req_import_config_t *cmd,
+                                          const char *             name)
+{
+    for (uint16_t i = 0; i < cmd->n_node; ++i) {
+        if (0 == strcmp(cmd->nodes[i].node, name)) {
+            return &cmd->nodes[i];
+        }
+    }
+    return NULL;
+}
+
+static neu_gdatatag_t *import_find_group(neu_req_driver_t *node,
+                                         const char *      name)
+{
+    for (uint16_t i = 0; i < node->n_group; ++i) {
+        if (0 == strcmp(node->groups[i].group, name)) {
+            return &node->groups[i];
+        }
+    }
+    return NULL;
+}
+
+static int import_add_tags(neu_gdatatag_t *group, neu_json_add_tags_req_t *req)
+{
+    if (0 == req->n_tag) {
+        return 0;
+    }
+
+    neu_datatag_t *tags =
+        realloc(group->tags, (group->n_tag + req->n_tag) * sizeof(*tags));
+    if (NULL == tags) {
+        return NEU_ERR_EINTERNAL;
+    }
+    group->tags = tags;
+
+    for (int i = 0; i < req->n_tag; ++i) {
+        neu_json_tag_t *src = &req->tags[i];
+        neu_datatag_t * dst = &group->tags[group->n_tag];
+
+        memset(dst, 0, sizeof(*dst));
+        dst->attribute   = src->attribute;
+        dst->type        = src->type;
+        dst->precision   = src->precision;
+        dst->decimal     = src->decimal;
+        dst->bias        = src->bias;
+        dst->deadband    = src->deadband;
+        dst->address     = src->address;
+        dst->name        = src->name;
+        dst->description = src->description ? src->description : strdup("");
+        src->address     = NULL; // moved
+        src->name        = NULL; // moved
+        src->description = NULL; // moved
+        group->n_tag += 1;
+
+        if (NULL == dst->description) {
+            return NEU_ERR_EINTERNAL;
+        }
+    }
+
+    return 0;
+}
+
+static int import_build(neu_json_global_config_req_t *req,
+                        neu_req_import_config_t *     cmd)
+{
+    neu_json_get_nodes_resp_t *nodes = req->nodes;
+
+    cmd->nodes = calloc(nodes->n_node + 1, sizeof(cmd->nodes[0]));
+    if (NULL == cmd->nodes) {
+        return NEU_ERR_EINTERNAL;
+    }
+
+    for (int i = 0; i < nodes->n_node; ++i) {
+        neu_json_get_nodes_resp_node_t *node = &nodes->nodes[i];
+
+        if (is_static_node(node->name, node->plugin)) {
+            continue;
+        }
+        cmd->nodes[cmd->n_node].node   = node->name;
+        cmd->nodes[cmd->n_node].plugin = node->plugin;
+        node->name                     = NULL; // moved
+        node->plugin                   = NULL; // moved
+        cmd->n_node += 1;
+    }
+
+    for (int i = 0; i < req->settings->n_setting; ++i) {
+        neu_json_node_setting_req_t *setting = &req->settings->settings[i];
+        neu_req_driver_t *node = import_find_node(cmd, setting->node);
+
+        node->setting    = setting->setting;
+        setting->setting = NULL; // moved
+    }
+
+    for (int i = 0; i < req->groups->n_group; ++i) {
+        neu_json_get_driver_group_resp_group_t *group =
+            &req->groups->groups[i];
+        neu_req_driver_t *node = import_find_node(cmd, group->driver);
+
+        if (node->n_group >= NEU_GROUP_MAX_PER_NODE) {
+            return NEU_ERR_GROUP_MAX_GROUPS;
+        }
+        if (0 == node->n_group % 8) {
+            neu_gdatatag_t *groups = realloc(
+                node->groups, (node->n_group + 8) * sizeof(neu_gdatatag_t));
+            if (NULL == groups) {
+                return NEU_ERR_EINTERNAL;
+            }
+            node->groups = groups;
+        }
+
+        neu_gdatatag_t *g = &node->groups[node->n_group++];
+        memset(g, 0, sizeof(*g));
+        strcpy(g->group, group->group);
+        g->interval = group->interval;
+    }
+
+    for (int i = 0; i < req->tags->n_tag; ++i) {
+        neu_json_add_tags_req_t *tags  = &req->tags->tags[i];
+        neu_gdatatag_t *         group = import_find_group(
+            import_find_node(cmd, tags->node), tags->group);
+
+        if (0 != import_add_tags(group, tags)) {
+            return NEU_ERR_EINTERNAL;
+        }
+    }
+
+    cmd->subscriptions = calloc(req->subscriptions->n_subscription + 1,
+                                sizeof(cmd->subscriptions[0]));
+    if (NULL == cmd->subscriptions) {
+        return NEU_ERR_EINTERNAL;
+    }
+
+    for (int i = 0; i < req->subscriptions->n_subscription; ++i) {
+        neu_json_subscribe_req_t *sub = &req->subscriptions->subscriptions[i];
+        neu_req_subscribe_t *     dst = &cmd->subscriptions[i];
+
+        strcpy(dst->app, sub->app);
+        strcpy(dst->driver, sub->driver);
+        strcpy(dst->group, sub->group);
+        dst->params      = sub->params;
+        dst->static_tags = sub->static_tags;
+        sub->params      = NULL; // moved
+        sub->static_tags = NULL; // moved
+        cmd->n_subscription += 1;
+    }
+
+    return 0;
+}
+
+static int send_import(nng_aio *aio, neu_json_global_config_req_t *req,
+                       bool dry_run)
+{
+    int                     ret    = 0;
+    neu_plugin_t *          plugin = neu_rest_get_plugin();
+    neu_req_import_config_t cmd    = { .dry_run = dry_run };
+
+    ret = import_check(req);
+    if (0 != ret) {
+        return ret;
+    }
+
+    ret = import_build(req, &cmd);
+    if (0 != ret) {
+        neu_req_import_config_fini(&cmd);
+        return ret;
+    }
+
+    neu_reqresp_head_t header = {
+        .ctx             = aio,
+        .type            = NEU_REQ_IMPORT_CONFIG,
+        .otel_trace_type = NEU_OTEL_TRACE_TYPE_REST_COMM,
+    };
+
+    if (0 != neu_plugin_op(plugin, header, &cmd)) {
+        neu_req_import_config_fini(&cmd);
+        return NEU_ERR_IS_BUSY;
+    }
+
+    return 0;
+}
+
 void handle_get_global_config(nng_aio *aio)
 {
     NEU_VALIDATE_JWT(aio);
@@ -1260,6 +1640,25 @@ void handle_get_global_config(nng_aio *aio)
 
 void handle_put_global_config(nng_aio *aio)
 {
+    char mode[8]    = { 0 };
+    char dry_run[8] = { 0 };
+
+    // mode=bulk 时整份配置校验后一次导入，否则逐项导入
+    if (neu_http_get_param_str(aio, "mode", mode, sizeof(mode)) > 0 &&
+        0 == strcmp(mode, "bulk")) {
+        neu_http_get_param_str(aio, "dry_run", dry_run, sizeof(dry_run));
+        NEU_PROCESS_HTTP_REQUEST_VALIDATE_JWT(
+            aio, neu_json_global_config_req_t,
+            neu_json_decode_global_config_req, {
+                int ret = send_import(aio, req, 0 == strcmp(dry_run, "true"));
+                if (ret != 0) {
+                    NEU_JSON_RESPONSE_ERROR(
+                        ret, { neu_http_response(aio, ret, result_error); });
+                }
+            });
+        return;
+    }
+
     NEU_PROCESS_HTTP_REQUEST_VALIDATE_JWT(
         aio, neu_json_global_config_req_t, neu_json_decode_global_config_req, {
             context_t *ctx = context_new(aio, PUT_GLOBAL);
@@ -1328,6 +1727,71 @@ error:
     context_free(ctx);
 }
 
+void handle_import_global_config_resp(nng_aio *                 aio,
+                                      neu_resp_import_config_t *resp)
+{
+    char *                        result = NULL;
+    neu_json_import_config_resp_t json   = {
+        .dry_run              = resp->dry_run,
+        .n_add_node           = utarray_len(resp->add_nodes),
+        .add_nodes            = utarray_front(resp->add_nodes),
+        .n_del_node           = utarray_len(resp->del_nodes),
+        .del_nodes            = utarray_front(resp->del_nodes),
+        .n_update_node        = utarray_len(resp->update_nodes),
+        .update_nodes         = utarray_front(resp->update_nodes),
+        .add_groups           = resp->add_groups,
+        .del_groups           = resp->del_groups,
+        .update_groups        = resp->update_groups,
+        .current_tags         = resp->current_tags,
+        .import_tags          = resp->import_tags,
+        .add_subscriptions    = resp->add_subscriptions,
+        .del_subscriptions    = resp->del_subscriptions,
+        .update_subscriptions = resp->update_subscriptions,
+    };
+
+    if (0 != resp->error) {
+        nlog_warn("import global config fail, node: %s, error: %d",
+                  resp->node, resp->error);
+        NEU_JSON_RESPONSE_ERROR(resp->error, {
+            neu_http_response(aio, resp->error, result_error);
+        });
+    } else if (0 !=
+               neu_json_encode_by_fn(
+                   &json, neu_json_encode_import_config_resp, &result)) {
+        NEU_JSON_RESPONSE_ERROR(NEU_ERR_EINTERNAL, {
+            neu_http_response(aio, NEU_ERR_EINTERNAL, result_error);
+        });
+    } else {
+        neu_http_ok(aio, result);
+    }
+
+    free(result);
+    neu_resp_import_config_fini(resp);
+}
+
+void handle_get_global_config_import(nng_aio *aio)
+{
+    char *                          result   = NULL;
+    neu_import_progress_t           progress = { 0 };
+    neu_json_import_progress_resp_t resp     = { 0 };
+
+    NEU_VALIDATE_JWT(aio);
+
+    neu_import_get_progress(&progress);
+    resp.phase   = neu_import_phase_str(progress.phase);
+    resp.dry_run = progress.dry_run;
+    resp.total   = progress.total;
+    resp.done    = progress.done;
+    resp.error   = progress.error;
+    resp.start   = progress.start;
+    resp.elapsed = progress.elapsed;
+
+    neu_json_encode_by_fn(&resp, neu_json_encode_import_progress_resp,
+                          &result);
+    neu_http_ok(aio, result);
+    free(result);
+}
+
 void handle_global_config_resp(nng_aio *aio, neu_reqresp_type_e type,
                                void *data)
 {
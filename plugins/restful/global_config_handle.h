@@ -31,4 +31,8 @@ void handle_get_drivers(nng_aio *aio);
 void handle_global_config_resp(nng_aio *aio, neu_reqresp_type_e type,
                                void *data);
 
+void handle_import_global_config_resp(nng_aio *                 aio,
+                                      neu_resp_import_config_t *resp);
+void handle_get_global_config_import(nng_aio *aio);
+
 #endif
@@ -127,6 +127,9 @@ static struct neu_http_handler cors_handler[] = {
     {
         .url = "/api/v2/global/config",
     },
+    {
+        .url = "/api/v2/global/config/import",
+    },
     {
         .url = "/api/v2/global/drivers",
     },
@@ -473,6 +476,13 @@ static struct neu_http_handler rest_handlers[] = {
         .url           = "/api/v2/global/config",
         .value.handler = handle_put_global_config,
     },
+    // API处理器示例：查询批量导入全局配置的进度
+    {
+        .method        = NEU_HTTP_METHOD_GET,
+        .type          = NEU_HTTP_HANDLER_FUNCTION,
+        .url           = "/api/v2/global/config/import",
+        .value.handler = handle_get_global_config_import,
+    },
     // API处理器示例：更新驱动程序
     {
         .method        = NEU_HTTP_METHOD_PUT,
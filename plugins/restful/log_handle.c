@@ -153,41 +153,14 @@ void handle_log_list(nng_aio *aio)
     utarray_free(log_files);
 }
 
-static int response(nng_aio *aio, char *content, enum nng_http_status status)
-{
-    nng_http_res *res = NULL;
-
-    nng_http_res_alloc(&res);
-
-    nng_http_res_set_header(res, "Content-Type", "text/plain");
-    nng_http_res_set_header(res, "Access-Control-Allow-Origin", "*");
-    nng_http_res_set_header(res, "Access-Control-Allow-Methods",
-                            "POST,GET,PUT,DELETE,OPTIONS");
-    nng_http_res_set_header(res, "Access-Control-Allow-Headers", "*");
-
-    if (content != NULL && strlen(content) > 0) {
-        nng_http_res_copy_data(res, content, strlen(content));
-    }
-
-    nng_http_res_set_status(res, status);
-
-    nng_http_req *nng_req = nng_aio_get_input(aio, 0);
-    nlog_notice("<%p> %s %s [%d]", aio, nng_http_req_get_method(nng_req),
-                nng_http_req_get_uri(nng_req), status);
-
-    nng_aio_set_output(aio, 0, res);
-    nng_aio_finish(aio, 0);
-
-    return 0;
-}
-
 void handle_log_file(nng_aio *aio)
 {
     NEU_VALIDATE_JWT(aio);
 
     char file_name[NEU_NODE_NAME_LEN] = { 0 };
     if (neu_http_get_param_str(aio, "name", file_name, sizeof(file_name)) <=
-        0) {
+            0 ||
+        NULL != strchr(file_name, '/')) {
         NEU_JSON_RESPONSE_ERROR(NEU_ERR_PARAM_IS_WRONG, {
             neu_http_response(aio, error_code.error, result_error);
         })
@@ -202,22 +175,11 @@ void handle_log_file(nng_aio *aio)
     strncat(path, "/", sizeof(path) - strlen(path) - 1);
     strncat(path, file_name, sizeof(path) - strlen(path) - 1);
 
-    FILE *file = fopen(path, "r");
-    if (NULL == file) {
-        NEU_JSON_RESPONSE_ERROR(NEU_ERR_FILE_NOT_EXIST, {
-            neu_http_response(aio, NEU_ERR_FILE_NOT_EXIST, result_error);
+    // 日志文件可达数十 MB，分块读取发送，不整体载入内存
+    int ret = neu_http_response_file_stream(aio, path, "text/plain", NULL);
+    if (ret != 0) {
+        NEU_JSON_RESPONSE_ERROR(ret, {
+            neu_http_response(aio, error_code.error, result_error);
         });
     }
-
-    fseek(file, 0, SEEK_END);
-    long file_size = ftell(file);
-    fseek(file, 0, SEEK_SET);
-
-    char *file_content = (char *) malloc(file_size + 1);
-    fread(file_content, 1, file_size, file);
-    file_content[file_size] = '\0';
-    fclose(file);
-
-    response(aio, file_content, NNG_HTTP_STATUS_OK);
-    free(file_content);
 }
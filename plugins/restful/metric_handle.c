@@ -17,100 +17,264 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  **/
 
+#include <stdarg.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 #include <pthread.h>
+#include <zlib.h>
 
 #include "define.h"
+#include "event/event.h"
 #include "metrics.h"
 #include "plugin.h"
-#include "utils/asprintf.h"
 #include "utils/http.h"
 #include "utils/http_handler.h"
 #include "utils/log.h"
 
 #include "metric_handle.h"
 
-// clang-format off
-#define METRIC_GLOBAL_TMPL                                                       \
-    "# HELP os_info OS distro, kernel version, machine and clib\n"               \
-    "# TYPE os_info gauge\n"                                                     \
-    "os_info{version=\"%s\"} 0\n"                                                \
-    "os_info{kernel=\"%s\"} 0\n"                                                 \
-    "os_info{machine=\"%s\", clib=\"%s-%s\"} 0\n"                                \
-    "# HELP cpu_percent Total CPU utilisation percentage\n"                      \
-    "# TYPE cpu_percent gauge\n"                                                 \
-    "cpu_percent %u\n"                                                           \
-    "# HELP cpu_cores Number of CPU cores\n"                                     \
-    "# TYPE cpu_cores counter\n"                                                 \
-    "cpu_cores %u\n"                                                             \
-    "# HELP mem_total_bytes Total installed memory in bytes\n"                   \
-    "# TYPE mem_total_bytes counter\n"                                           \
-    "mem_total_bytes %zu\n"                                                      \
-    "# HELP mem_used_bytes Used memory in bytes\n"                               \
-    "# TYPE mem_used_bytes gauge\n"                                              \
-    "mem_used_bytes %zu\n"                                                       \
-    "# HELP mem_cache Memory buffer/cache size in bytes\n"                       \
-    "# TYPE mem_cache gauge\n"                                                   \
-    "mem_cache_bytes %zu\n"                                                      \
-    "# HELP rss_bytes RSS (Resident Set Size) in bytes\n"                        \
-    "# TYPE rss_bytes gauge\n"                                                   \
-    "rss_bytes %zu\n"                                                            \
-    "# HELP disk_size_gibibytes Disk size in gibibytes\n"                        \
-    "# TYPE disk_size_gibibytes counter\n"                                       \
-    "disk_size_gibibytes %zu\n"                                                  \
-    "# HELP disk_used_gibibytes Used disk size in gibibytes\n"                   \
-    "# TYPE disk_used_gibibytes gauge\n"                                         \
-    "disk_used_gibibytes %zu\n"                                                  \
-    "# HELP disk_avail_gibibytes Available disk size in gibibytes\n"             \
-    "# TYPE disk_avail_gibibytes gauge\n"                                        \
-    "disk_avail_gibibytes %zu\n"                                                 \
-    "# HELP core_dumped Whether there is any core dump\n"                        \
-    "# TYPE core_dumped gauge\n"                                                 \
-    "core_dumped %d\n"                                                           \
-    "# HELP uptime_seconds Uptime in seconds\n"                                  \
-    "# TYPE uptime_seconds counter\n"                                            \
-    "uptime_seconds %" PRIu64 "\n"                                               \
-    "# HELP license_max_tags License tags limit\n"                               \
-    "# TYPE license_max_tags gauge\n"                                            \
-    "license_max_tags %" PRIu64 "\n"                                             \
-    "# HELP license_used_tags License total used tags\n"                         \
-    "# TYPE license_used_tags gauge\n"                                           \
-    "license_used_tags %" PRIu64 "\n"                                            \
-    "# HELP north_nodes_total Number of north nodes\n"                           \
-    "# TYPE north_nodes_total gauge\n"                                           \
-    "north_nodes_total %zu\n"                                                    \
-    "# HELP north_running_nodes_total Number of north nodes in running state\n"  \
-    "# TYPE north_running_nodes_total gauge\n"                                   \
-    "north_running_nodes_total %zu\n"                                            \
-    "# HELP north_disconnected_nodes_total Number of north nodes disconnected\n" \
-    "# TYPE north_disconnected_nodes_total gauge\n"                              \
-    "north_disconnected_nodes_total %zu\n"                                       \
-    "# HELP south_nodes_total Number of south nodes\n"                           \
-    "# TYPE south_nodes_total gauge\n"                                           \
-    "south_nodes_total %zu\n"                                                    \
-    "# HELP south_running_nodes_total Number of south nodes in running state\n"  \
-    "# TYPE south_running_nodes_total gauge\n"                                   \
-    "south_running_nodes_total %zu\n"                                            \
-    "# HELP south_disconnected_nodes_total Number of south nodes disconnected\n" \
-    "# TYPE south_disconnected_nodes_total gauge\n"                              \
-    "south_disconnected_nodes_total %zu\n"
-// clang-format on
-
-static int response(nng_aio *aio, char *content, enum nng_http_status status)
+#define METRIC_CONTENT_TYPE_TEXT "text/plain"
+#define METRIC_CONTENT_TYPE_OPENMETRICS \
+    "application/openmetrics-text; version=1.0.0; charset=utf-8"
+
+// 小于该长度的响应不压缩
+#define METRIC_GZIP_MIN_SIZE 1024
+
+typedef enum {
+    METRIC_FORMAT_PROMETHEUS,
+    METRIC_FORMAT_OPENMETRICS,
+    METRIC_FORMAT_MAX,
+} metric_format_e;
+
+/**
+ * @brief 可复用的输出缓冲区，每次抓取只重置长度，不释放内存。
+ */
+typedef struct {
+    char * data;
+    size_t len;
+    size_t cap;
+    bool   oom;
+} metric_buf_t;
+
+/**
+ * @brief 一个注册度量项的渲染缓存。
+ *
+ * header 为预先渲染的 HELP/TYPE 行；samples 收集本次抓取中各节点的样本，
+ * 遍历完节点后与 header 一起按注册顺序拼接输出。
+ */
+typedef struct {
+    char *         name;
+    metric_buf_t   header[METRIC_FORMAT_MAX];
+    metric_buf_t   samples;
+    UT_hash_handle hh;
+} metric_family_t;
+
+/**
+ * @brief 节点的一条序列，前缀为预先渲染的 `name{node="n",group="g"} `。
+ */
+typedef struct {
+    uint32_t            family; // 所属度量项在 families 中的序号
+    uint32_t            offset; // 前缀在节点 labels 中的偏移
+    uint32_t            len;
+    neu_metric_entry_t *entry;
+} metric_series_t;
+
+/**
+ * @brief 节点的导出缓存。
+ *
+ * 节点结构版本号变化时在节点锁内重建序列；抓取时只在节点锁内把度量值拷贝
+ * 到平坦的 values 数组，随后在锁外渲染。
+ */
+typedef struct {
+    neu_node_metrics_t *node;
+    uint32_t            version;
+    bool                built;
+    metric_buf_t        labels;   // node_type 样本前缀及全部序列前缀
+    size_t              type_len; // labels 开头 node_type 样本前缀的长度
+    metric_series_t *   series;
+    uint64_t *          values;
+    size_t              n_series;
+    size_t              cap_series;
+} node_cache_t;
+
+/**
+ * @brief 度量导出器，全局度量结构版本号变化时整体重建。
+ *
+ * 节点按类型分别存放，按分类抓取时只遍历对应类型的节点。
+ */
+static struct {
+    pthread_mutex_t  mtx;
+    bool             valid;
+    uint32_t         version;
+    metric_family_t *families;
+    size_t           n_families;
+    metric_family_t *index; // 度量项名称到 families 的索引
+    node_cache_t *   nodes[2];
+    size_t           n_nodes[2];
+    metric_buf_t     types; // node_type 样本
+    metric_buf_t     out;
+    metric_buf_t     gz;
+} g_exporter = {
+    .mtx = PTHREAD_MUTEX_INITIALIZER,
+};
+
+static inline void buf_reset(metric_buf_t *b)
+{
+    b->len = 0;
+    b->oom = false;
+}
+
+static inline void buf_free(metric_buf_t *b)
+{
+    free(b->data);
+    *b = (metric_buf_t){ 0 };
+}
+
+static bool buf_reserve(metric_buf_t *b, size_t n)
+{
+    if (b->len + n <= b->cap) {
+        return true;
+    }
+
+    if (b->oom) {
+        return false;
+    }
+
+    size_t cap = b->cap > 0 ? b->cap : 4096;
+    while (cap < b->len + n) {
+        cap *= 2;
+    }
+
+    char *data = realloc(b->data, cap);
+    if (NULL == data) {
+        b->oom = true;
+        return false;
+    }
+
+    b->data = data;
+    b->cap  = cap;
+    return true;
+}
+
+static inline void buf_append(metric_buf_t *b, const char *s, size_t n)
+{
+    if (buf_reserve(b, n)) {
+        memcpy(b->data + b->len, s, n);
+        b->len += n;
+    }
+}
+
+static inline void buf_puts(metric_buf_t *b, const char *s)
+{
+    buf_append(b, s, strlen(s));
+}
+
+static void buf_printf(metric_buf_t *b, const char *fmt, ...)
+{
+    va_list ap;
+    size_t  avail = b->cap - b->len;
+    char *  dst   = NULL != b->data ? b->data + b->len : NULL;
+
+    va_start(ap, fmt);
+    int n = vsnprintf(dst, avail, fmt, ap);
+    va_end(ap);
+
+    if (n < 0) {
+        b->oom = true;
+        return;
+    }
+
+    if ((size_t) n >= avail) {
+        if (!buf_reserve(b, n + 1)) {
+            return;
+        }
+        va_start(ap, fmt);
+        vsnprintf(b->data + b->len, n + 1, fmt, ap);
+        va_end(ap);
+    }
+
+    b->len += n;
+}
+
+// 写入样本值与换行
+static inline void buf_put_value(metric_buf_t *b, uint64_t v)
+{
+    char  tmp[24];
+    char *p = tmp + sizeof(tmp);
+
+    *--p = '\n';
+    do {
+        *--p = '0' + v % 10;
+        v /= 10;
+    } while (v > 0);
+
+    buf_append(b, p, tmp + sizeof(tmp) - p);
+}
+
+// 写入转义后的标签值
+static void buf_put_label(metric_buf_t *b, const char *s)
+{
+    for (const char *p = s; *p; ++p) {
+        switch (*p) {
+        case '\\':
+            buf_append(b, "\\\\", 2);
+            break;
+        case '"':
+            buf_append(b, "\\\"", 2);
+            break;
+        case '\n':
+            buf_append(b, "\\n", 2);
+            break;
+        default:
+            buf_append(b, p, 1);
+            break;
+        }
+    }
+}
+
+/**
+ * @brief 写入度量项的 HELP/TYPE 行。
+ *
+ * OpenMetrics 要求计数器样本以 _total 结尾且族名不带该后缀，不满足的计数器
+ * 按 unknown 类型输出，保持样本名称与 Prometheus 格式一致。
+ */
+static void put_header(metric_buf_t *b, const char *name, const char *help,
+                       neu_metric_type_e type, metric_format_e fmt)
+{
+    const char *type_str = neu_metric_type_str(type);
+    int         name_len = strlen(name);
+
+    if (METRIC_FORMAT_OPENMETRICS == fmt && neu_metric_type_is_counter(type)) {
+        if (name_len > 6 && 0 == strcmp(name + name_len - 6, "_total")) {
+            name_len -= 6;
+        } else {
+            type_str = "unknown";
+        }
+    }
+
+    buf_printf(b, "# HELP %.*s %s\n# TYPE %.*s %s\n", name_len, name, help,
+               name_len, name, type_str);
+}
+
+static int response(nng_aio *aio, const char *type, const char *encoding,
+                    const char *data, size_t len, enum nng_http_status status)
 {
     nng_http_res *res = NULL;
 
     nng_http_res_alloc(&res);
 
-    nng_http_res_set_header(res, "Content-Type", "text/plain");
+    nng_http_res_set_header(res, "Content-Type", type);
+    if (NULL != encoding) {
+        nng_http_res_set_header(res, "Content-Encoding", encoding);
+    }
     nng_http_res_set_header(res, "Access-Control-Allow-Origin", "*");
     nng_http_res_set_header(res, "Access-Control-Allow-Methods",
                             "POST,GET,PUT,DELETE,OPTIONS");
     nng_http_res_set_header(res, "Access-Control-Allow-Headers", "*");
 
-    if (content != NULL && strlen(content) > 0) {
-        nng_http_res_copy_data(res, content, strlen(content));
+    if (data != NULL && len > 0) {
+        nng_http_res_copy_data(res, data, len);
     } else {
         nng_http_res_set_data(res, NULL, 0);
     }
@@ -151,192 +315,564 @@ static inline bool parse_metrics_catgory(const char *s, size_t len,
     return false;
 }
 
-static inline void gen_global_metrics(const neu_metrics_t *metrics,
-                                      FILE *               stream)
+/**
+ * @brief 确定输出格式，format 参数优先于 Accept 请求头。
+ * @return 成功返回 true，format 参数无效时返回 false。
+ */
+static bool parse_metrics_format(nng_aio *aio, metric_format_e *fmt)
+{
+    size_t      len   = 0;
+    const char *param = neu_http_get_param(aio, "format", &len);
+
+    *fmt = METRIC_FORMAT_PROMETHEUS;
+
+    if (NULL != param) {
+        if (11 == len && 0 == strncmp(param, "openmetrics", len)) {
+            *fmt = METRIC_FORMAT_OPENMETRICS;
+        } else if (!(10 == len && 0 == strncmp(param, "prometheus", len))) {
+            return false;
+        }
+        return true;
+    }
+
+    const char *accept = neu_http_get_header(aio, "Accept");
+    if (NULL != accept &&
+        NULL != strstr(accept, "application/openmetrics-text")) {
+        *fmt = METRIC_FORMAT_OPENMETRICS;
+    }
+
+    return true;
+}
+
+static bool accept_gzip(nng_aio *aio)
+{
+    const char *encoding = neu_http_get_header(aio, "Accept-Encoding");
+
+    return NULL != encoding && NULL != strstr(encoding, "gzip");
+}
+
+static int gzip_buf(const metric_buf_t *in, metric_buf_t *out)
+{
+    z_stream zs = { 0 };
+
+    // 抓取频繁，优先压缩速度
+    int rv = deflateInit2(&zs, Z_BEST_SPEED, Z_DEFLATED, MAX_WBITS + 16, 8,
+                          Z_DEFAULT_STRATEGY);
+    if (Z_OK != rv) {
+        return -1;
+    }
+
+    size_t bound = deflateBound(&zs, in->len);
+
+    buf_reset(out);
+    if (!buf_reserve(out, bound)) {
+        deflateEnd(&zs);
+        return -1;
+    }
+
+    zs.next_in   = (Bytef *) in->data;
+    zs.avail_in  = in->len;
+    zs.next_out  = (Bytef *) out->data;
+    zs.avail_out = bound;
+
+    rv = deflate(&zs, Z_FINISH);
+    deflateEnd(&zs);
+    if (Z_STREAM_END != rv) {
+        return -1;
+    }
+
+    out->len = bound - zs.avail_out;
+    return 0;
+}
+
+static void node_cache_free(node_cache_t *c)
+{
+    buf_free(&c->labels);
+    free(c->series);
+    free(c->values);
+}
+
+static void exporter_clear()
+{
+    for (size_t i = 0; i < g_exporter.n_families; ++i) {
+        metric_family_t *f = &g_exporter.families[i];
+        free(f->name);
+        for (int j = 0; j < METRIC_FORMAT_MAX; ++j) {
+            buf_free(&f->header[j]);
+        }
+        buf_free(&f->samples);
+    }
+    HASH_CLEAR(hh, g_exporter.index);
+    free(g_exporter.families);
+    g_exporter.families   = NULL;
+    g_exporter.n_families = 0;
+
+    for (int t = 0; t < 2; ++t) {
+        for (size_t i = 0; i < g_exporter.n_nodes[t]; ++i) {
+            node_cache_free(&g_exporter.nodes[t][i]);
+        }
+        free(g_exporter.nodes[t]);
+        g_exporter.nodes[t]   = NULL;
+        g_exporter.n_nodes[t] = 0;
+    }
+
+    g_exporter.valid = false;
+}
+
+static inline int node_type_index(neu_node_type_e type)
 {
-    fprintf(stream, METRIC_GLOBAL_TMPL, metrics->distro, metrics->kernel,
-            metrics->machine, metrics->clib, metrics->clib_version,
-            metrics->cpu_percent, metrics->cpu_cores, metrics->mem_total_bytes,
-            metrics->mem_used_bytes, metrics->mem_cache_bytes,
-            metrics->mem_used_bytes, metrics->disk_size_gibibytes,
-            metrics->disk_used_gibibytes, metrics->disk_avail_gibibytes,
-            metrics->core_dumped, metrics->uptime_seconds,
-            metrics->license_max_tags, metrics->license_used_tags,
-            metrics->north_nodes, metrics->north_running_nodes,
-            metrics->north_disconnected_nodes, metrics->south_nodes,
-            metrics->south_running_nodes, metrics->south_disconnected_nodes);
+    if (NEU_NA_TYPE_DRIVER == type) {
+        return 0;
+    } else if (NEU_NA_TYPE_APP == type) {
+        return 1;
+    }
+    return -1;
 }
 
-static inline void gen_single_node_metrics(neu_node_metrics_t *node_metrics,
-                                           FILE *              stream)
+/**
+ * @brief 按全局度量结构重建度量项与节点列表，调用者持有全局度量读锁。
+ */
+static int exporter_rebuild(const neu_metrics_t *metrics)
 {
-    fprintf(stream,
-            "# HELP node_type Driver(1) or APP(2)\n"
-            "# TYPE node_type gauge\n"
-            "node_type{node=\"%s\"} %d\n",
-            node_metrics->name, node_metrics->type);
+    neu_metric_entry_t *r = NULL;
+    neu_node_metrics_t *n = NULL;
+    size_t              i = 0;
+
+    exporter_clear();
 
-    neu_metric_entry_t *e = NULL;
+    size_t n_families = HASH_COUNT(metrics->registered_metrics);
+    if (n_families > 0) {
+        g_exporter.families = calloc(n_families, sizeof(metric_family_t));
+        if (NULL == g_exporter.families) {
+            return -1;
+        }
+    }
 
-    pthread_mutex_lock(&node_metrics->lock);
-    HASH_LOOP(hh, node_metrics->entries, e)
+    HASH_LOOP(hh, metrics->registered_metrics, r)
     {
-        if (neu_metric_type_is_rolling_counter(e->type)) {
-            // force clean stale value
-            e->value = neu_rolling_counter_inc(e->rcnt, global_timestamp, 0);
+        metric_family_t *f = &g_exporter.families[i++];
+        g_exporter.n_families += 1;
+
+        f->name = strdup(r->name);
+        if (NULL == f->name) {
+            exporter_clear();
+            return -1;
         }
-        fprintf(stream,
-                "# HELP %s %s\n# TYPE %s %s\n%s{node=\"%s\"} %" PRIu64 "\n",
-                e->name, e->help, e->name, neu_metric_type_str(e->type),
-                e->name, node_metrics->name, e->value);
+        for (int j = 0; j < METRIC_FORMAT_MAX; ++j) {
+            put_header(&f->header[j], r->name, r->help, r->type, j);
+            if (f->header[j].oom) {
+                exporter_clear();
+                return -1;
+            }
+        }
+        HASH_ADD_KEYPTR(hh, g_exporter.index, f->name, strlen(f->name), f);
     }
 
-    neu_group_metrics_t *g = NULL;
-    HASH_LOOP(hh, node_metrics->group_metrics, g)
+    size_t count[2] = { 0 };
+    HASH_LOOP(hh, metrics->node_metrics, n)
     {
-        HASH_LOOP(hh, g->entries, e)
-        {
-            if (neu_metric_type_is_rolling_counter(e->type)) {
-                // force clean stale value
-                e->value =
-                    neu_rolling_counter_inc(e->rcnt, global_timestamp, 0);
+        int t = node_type_index(n->type);
+        if (t >= 0) {
+            count[t] += 1;
+        }
+    }
+
+    for (int t = 0; t < 2; ++t) {
+        if (count[t] > 0) {
+            g_exporter.nodes[t] = calloc(count[t], sizeof(node_cache_t));
+            if (NULL == g_exporter.nodes[t]) {
+                exporter_clear();
+                return -1;
             }
-            fprintf(stream,
-                    "# HELP %s %s\n# TYPE %s %s\n%s{node=\"%s\",group=\"%s\"} "
-                    "%" PRIu64 "\n",
-                    e->name, e->help, e->name, neu_metric_type_str(e->type),
-                    e->name, node_metrics->name, g->name, e->value);
         }
     }
-    pthread_mutex_unlock(&node_metrics->lock);
+
+    HASH_LOOP(hh, metrics->node_metrics, n)
+    {
+        int t = node_type_index(n->type);
+        if (t >= 0) {
+            g_exporter.nodes[t][g_exporter.n_nodes[t]++].node = n;
+        }
+    }
+
+    g_exporter.version = metrics->version;
+    g_exporter.valid   = true;
+    return 0;
 }
 
-static inline bool has_entry(neu_node_metrics_t *node_metrics, const char *name)
+static int node_cache_add_series(node_cache_t *c, neu_metric_entry_t *e,
+                                 const char *group)
 {
-    neu_metric_entry_t * e = NULL;
-    neu_group_metrics_t *g = NULL;
-    HASH_FIND_STR(node_metrics->entries, name, e);
-    if (e) {
-        return true;
+    metric_family_t *f = NULL;
+
+    HASH_FIND_STR(g_exporter.index, e->name, f);
+    if (NULL == f) {
+        return 0;
     }
 
-    HASH_LOOP(hh, node_metrics->group_metrics, g)
-    {
-        HASH_FIND_STR(g->entries, name, e);
-        if (e) {
-            return true;
+    if (c->n_series == c->cap_series) {
+        size_t cap = c->cap_series > 0 ? c->cap_series * 2 : 16;
+
+        metric_series_t *series = realloc(c->series, cap * sizeof(*series));
+        if (NULL == series) {
+            return -1;
+        }
+        c->series = series;
+
+        uint64_t *values = realloc(c->values, cap * sizeof(*values));
+        if (NULL == values) {
+            return -1;
         }
+        c->values     = values;
+        c->cap_series = cap;
     }
-    return false;
+
+    metric_series_t *s = &c->series[c->n_series++];
+    s->family          = f - g_exporter.families;
+    s->offset          = c->labels.len;
+    s->entry           = e;
+
+    buf_puts(&c->labels, e->name);
+    buf_puts(&c->labels, "{node=\"");
+    buf_put_label(&c->labels, c->node->name);
+    if (NULL != group) {
+        buf_puts(&c->labels, "\",group=\"");
+        buf_put_label(&c->labels, group);
+    }
+    buf_puts(&c->labels, "\"} ");
+
+    s->len = c->labels.len - s->offset;
+    return c->labels.oom ? -1 : 0;
 }
 
-static void gen_all_node_metrics(neu_metrics_t *metrics, int type_filter,
-                                 FILE *stream)
+/**
+ * @brief 重建节点的序列，调用者持有节点锁。
+ */
+static int node_cache_build(node_cache_t *c)
 {
-    neu_metric_entry_t * e = NULL, *r = NULL;
+    neu_node_metrics_t * n = c->node;
+    neu_metric_entry_t * e = NULL, *ne = NULL;
     neu_group_metrics_t *g = NULL;
-    neu_node_metrics_t * n = NULL;
 
-    bool commented = false;
-    HASH_LOOP(hh, metrics->node_metrics, n)
+    c->built    = false;
+    c->n_series = 0;
+    buf_reset(&c->labels);
+
+    buf_puts(&c->labels, "node_type{node=\"");
+    buf_put_label(&c->labels, n->name);
+    buf_puts(&c->labels, "\"} ");
+    c->type_len = c->labels.len;
+
+    HASH_LOOP(hh, n->entries, e)
     {
-        if (!(type_filter & n->type)) {
-            continue;
+        if (0 != node_cache_add_series(c, e, NULL)) {
+            return -1;
+        }
+    }
+
+    HASH_LOOP(hh, n->group_metrics, g)
+    {
+        HASH_LOOP(hh, g->entries, e)
+        {
+            // 与节点级度量项同名的组度量项不输出
+            HASH_FIND_STR(n->entries, e->name, ne);
+            if (NULL == ne && 0 != node_cache_add_series(c, e, g->name)) {
+                return -1;
+            }
         }
+    }
+
+    if (c->labels.oom) {
+        return -1;
+    }
+
+    c->version = n->version;
+    c->built   = true;
+    return 0;
+}
+
+/**
+ * @brief 在节点锁内按需重建序列，并把度量值读取到 values。
+ */
+static int node_cache_sync(node_cache_t *c)
+{
+    neu_node_metrics_t *n  = c->node;
+    int                 rv = 0;
+
+    pthread_mutex_lock(&n->lock);
+    if (!c->built || c->version != n->version) {
+        rv = node_cache_build(c);
+    }
 
-        if (!commented) {
-            commented = true;
-            fprintf(stream,
-                    "# HELP node_type Driver(1) or APP(2)\n"
-                    "# TYPE node_type gauge\n");
+    if (0 == rv) {
+        for (size_t i = 0; i < c->n_series; ++i) {
+            c->values[i] = neu_metric_entry_value(c->series[i].entry);
         }
+    }
+    pthread_mutex_unlock(&n->lock);
+
+    return rv;
+}
+
+/**
+ * @brief 输出共享事件循环池中每个循环的负载，标签 loop 为循环序号。
+ */
+static void gen_event_loop_metrics(metric_buf_t *b, metric_format_e fmt)
+{
+    int n_loop = neu_event_pool_size();
 
-        fprintf(stream, "node_type{node=\"%s\"} %d\n", n->name, n->type);
+    if (n_loop <= 0) {
+        return;
     }
 
-    n = NULL;
+    neu_event_loop_stats_t *stats = calloc(n_loop, sizeof(*stats));
+    if (NULL == stats) {
+        return;
+    }
 
-    HASH_LOOP(hh, metrics->registered_metrics, r)
-    {
-        commented = false;
-        HASH_LOOP(hh, metrics->node_metrics, n)
-        {
-            if (!(type_filter & n->type)) {
+    for (int i = 0; i < n_loop; ++i) {
+        neu_event_pool_stats(i, &stats[i]);
+    }
+
+    put_header(b, "event_loop_nodes",
+               "Number of nodes on the shared event loop",
+               NEU_METRIC_TYPE_GAUAGE, fmt);
+    for (int i = 0; i < n_loop; ++i) {
+        buf_printf(b, "event_loop_nodes{loop=\"%d\"} ", i);
+        buf_put_value(b, stats[i].users);
+    }
+
+    put_header(b, "event_loop_events",
+               "Number of registered io and timer events",
+               NEU_METRIC_TYPE_GAUAGE, fmt);
+    for (int i = 0; i < n_loop; ++i) {
+        buf_printf(b, "event_loop_events{loop=\"%d\"} ", i);
+        buf_put_value(b, stats[i].events);
+    }
+
+    put_header(b, "event_loop_busy_percent",
+               "Percentage of time spent in callbacks in the last second",
+               NEU_METRIC_TYPE_GAUAGE, fmt);
+    for (int i = 0; i < n_loop; ++i) {
+        buf_printf(b, "event_loop_busy_percent{loop=\"%d\"} ", i);
+        buf_put_value(b, stats[i].busy_percent);
+    }
+
+    put_header(b, "event_loop_lag_max_us",
+               "Max timer dispatch lag in the last second",
+               NEU_METRIC_TYPE_GAUAGE, fmt);
+    for (int i = 0; i < n_loop; ++i) {
+        buf_printf(b, "event_loop_lag_max_us{loop=\"%d\"} ", i);
+        buf_put_value(b, stats[i].lag_max_us);
+    }
+
+    put_header(b, "event_loop_lag_avg_us",
+               "Average timer dispatch lag in the last second",
+               NEU_METRIC_TYPE_GAUAGE, fmt);
+    for (int i = 0; i < n_loop; ++i) {
+        buf_printf(b, "event_loop_lag_avg_us{loop=\"%d\"} ", i);
+        buf_put_value(b, stats[i].lag_avg_us);
+    }
+
+    put_header(b, "event_loop_dispatched_total",
+               "Number of dispatched events", NEU_METRIC_TYPE_COUNTER, fmt);
+    for (int i = 0; i < n_loop; ++i) {
+        buf_printf(b, "event_loop_dispatched_total{loop=\"%d\"} ", i);
+        buf_put_value(b, stats[i].dispatched);
+    }
+
+    free(stats);
+}
+
+static void gen_global_metrics(const neu_metrics_t *metrics, metric_buf_t *b,
+                               metric_format_e fmt)
+{
+    const struct {
+        const char *      name;
+        const char *      help;
+        neu_metric_type_e type;
+        uint64_t          value;
+    } entries[] = {
+        { "cpu_percent", "Total CPU utilisation percentage",
+          NEU_METRIC_TYPE_GAUAGE, metrics->cpu_percent },
+        { "cpu_cores", "Number of CPU cores", NEU_METRIC_TYPE_COUNTER,
+          metrics->cpu_cores },
+        { "mem_total_bytes", "Total installed memory in bytes",
+          NEU_METRIC_TYPE_COUNTER, metrics->mem_total_bytes },
+        { "mem_used_bytes", "Used memory in bytes", NEU_METRIC_TYPE_GAUAGE,
+          metrics->mem_used_bytes },
+        { "mem_cache_bytes", "Memory buffer/cache size in bytes",
+          NEU_METRIC_TYPE_GAUAGE, metrics->mem_cache_bytes },
+        { "rss_bytes", "RSS (Resident Set Size) in bytes",
+          NEU_METRIC_TYPE_GAUAGE, metrics->mem_used_bytes },
+        { "disk_size_gibibytes", "Disk size in gibibytes",
+          NEU_METRIC_TYPE_COUNTER, metrics->disk_size_gibibytes },
+        { "disk_used_gibibytes", "Used disk size in gibibytes",
+          NEU_METRIC_TYPE_GAUAGE, metrics->disk_used_gibibytes },
+        { "disk_avail_gibibytes", "Available disk size in gibibytes",
+          NEU_METRIC_TYPE_GAUAGE, metrics->disk_avail_gibibytes },
+        { "core_dumped", "Whether there is any core dump",
+          NEU_METRIC_TYPE_GAUAGE, metrics->core_dumped },
+        { "uptime_seconds", "Uptime in seconds", NEU_METRIC_TYPE_COUNTER,
+          metrics->uptime_seconds },
+        { "license_max_tags", "License tags limit", NEU_METRIC_TYPE_GAUAGE,
+          metrics->license_max_tags },
+        { "license_used_tags", "License total used tags",
+          NEU_METRIC_TYPE_GAUAGE, metrics->license_used_tags },
+        { "north_nodes_total", "Number of north nodes",
+          NEU_METRIC_TYPE_GAUAGE, metrics->north_nodes },
+        { "north_running_nodes_total",
+          "Number of north nodes in running state", NEU_METRIC_TYPE_GAUAGE,
+          metrics->north_running_nodes },
+        { "north_disconnected_nodes_total",
+          "Number of north nodes disconnected", NEU_METRIC_TYPE_GAUAGE,
+          metrics->north_disconnected_nodes },
+        { "south_nodes_total", "Number of south nodes",
+          NEU_METRIC_TYPE_GAUAGE, metrics->south_nodes },
+        { "south_running_nodes_total",
+          "Number of south nodes in running state", NEU_METRIC_TYPE_GAUAGE,
+          metrics->south_running_nodes },
+        { "south_disconnected_nodes_total",
+          "Number of south nodes disconnected", NEU_METRIC_TYPE_GAUAGE,
+          metrics->south_disconnected_nodes },
+    };
+
+    put_header(b, "os_info", "OS distro, kernel version, machine and clib",
+               NEU_METRIC_TYPE_GAUAGE, fmt);
+    buf_printf(b,
+               "os_info{version=\"%s\"} 0\n"
+               "os_info{kernel=\"%s\"} 0\n"
+               "os_info{machine=\"%s\", clib=\"%s-%s\"} 0\n",
+               metrics->distro, metrics->kernel, metrics->machine,
+               metrics->clib, metrics->clib_version);
+
+    for (size_t i = 0; i < sizeof(entries) / sizeof(entries[0]); ++i) {
+        put_header(b, entries[i].name, entries[i].help, entries[i].type, fmt);
+        buf_puts(b, entries[i].name);
+        buf_append(b, " ", 1);
+        buf_put_value(b, entries[i].value);
+    }
+
+    gen_event_loop_metrics(b, fmt);
+}
+
+/**
+ * @brief 单次遍历节点输出度量。
+ *
+ * 每个节点的样本按度量项追加到对应的 samples 中，遍历结束后按注册顺序拼接，
+ * 同一度量项只输出一次 HELP/TYPE。only 不为 NULL 时只输出该节点。
+ */
+static int gen_nodes_metrics(int filter, const neu_node_metrics_t *only,
+                             metric_buf_t *b, metric_format_e fmt)
+{
+    bool found = false;
+
+    buf_reset(&g_exporter.types);
+    for (size_t i = 0; i < g_exporter.n_families; ++i) {
+        buf_reset(&g_exporter.families[i].samples);
+    }
+
+    for (int t = 0; t < 2; ++t) {
+        if (!(filter & (t + 1))) {
+            continue;
+        }
+
+        for (size_t i = 0; i < g_exporter.n_nodes[t]; ++i) {
+            node_cache_t *c = &g_exporter.nodes[t][i];
+
+            if (NULL != only && only != c->node) {
                 continue;
             }
+            found = true;
 
-            if (!has_entry(n, r->name)) {
+            if (0 != node_cache_sync(c)) {
+                b->oom = true;
                 continue;
             }
 
-            if (!commented) {
-                commented = true;
-                fprintf(stream, "# HELP %s %s\n# TYPE %s %s\n", r->name,
-                        r->help, r->name, neu_metric_type_str(r->type));
-            }
+            buf_append(&g_exporter.types, c->labels.data, c->type_len);
+            buf_put_value(&g_exporter.types, c->node->type);
 
-            pthread_mutex_lock(&n->lock);
-            HASH_FIND_STR(n->entries, r->name, e);
-            if (e) {
-                if (neu_metric_type_is_rolling_counter(e->type)) {
-                    // force clean stale value
-                    e->value =
-                        neu_rolling_counter_inc(e->rcnt, global_timestamp, 0);
-                }
-                fprintf(stream, "%s{node=\"%s\"} %" PRIu64 "\n", e->name,
-                        n->name, e->value);
-
-                pthread_mutex_unlock(&n->lock);
-                continue;
-            }
+            for (size_t j = 0; j < c->n_series; ++j) {
+                metric_series_t *s = &c->series[j];
+                metric_family_t *f = &g_exporter.families[s->family];
 
-            HASH_LOOP(hh, n->group_metrics, g)
-            {
-                HASH_FIND_STR(g->entries, r->name, e);
-                if (e) {
-                    if (neu_metric_type_is_rolling_counter(e->type)) {
-                        // force clean stale value
-                        e->value = neu_rolling_counter_inc(e->rcnt,
-                                                           global_timestamp, 0);
-                    }
-                    fprintf(stream,
-                            "%s{node=\"%s\",group=\"%s\"} %" PRIu64 "\n",
-                            e->name, n->name, g->name, e->value);
-                }
+                buf_append(&f->samples, c->labels.data + s->offset, s->len);
+                buf_put_value(&f->samples, c->values[j]);
             }
-            pthread_mutex_unlock(&n->lock);
         }
     }
+
+    if (NULL != only && !found) {
+        return -1;
+    }
+
+    if (g_exporter.types.len > 0) {
+        put_header(b, "node_type", "Driver(1) or APP(2)",
+                   NEU_METRIC_TYPE_GAUAGE, fmt);
+        buf_append(b, g_exporter.types.data, g_exporter.types.len);
+    }
+    b->oom |= g_exporter.types.oom;
+
+    for (size_t i = 0; i < g_exporter.n_families; ++i) {
+        metric_family_t *f = &g_exporter.families[i];
+        if (f->samples.len > 0) {
+            buf_append(b, f->header[fmt].data, f->header[fmt].len);
+            buf_append(b, f->samples.data, f->samples.len);
+        }
+        b->oom |= f->samples.oom;
+    }
+
+    return 0;
 }
 
 struct context {
-    int         filter;
-    int *       status;
-    FILE *      stream;
-    const char *node;
+    neu_metrics_category_e cat;
+    metric_format_e        fmt;
+    int                    filter;
+    int *                  status;
+    const char *           node;
 };
 
-static void gen_node_metrics(neu_metrics_t *metrics, struct context *ctx)
+static void gen_metrics(const neu_metrics_t *metrics, void *data)
 {
+    struct context *ctx = data;
+    metric_buf_t *  b   = &g_exporter.out;
+
+    if (!g_exporter.valid || g_exporter.version != metrics->version) {
+        if (0 != exporter_rebuild(metrics)) {
+            *ctx->status = NNG_HTTP_STATUS_INTERNAL_SERVER_ERROR;
+            return;
+        }
+    }
+
+    if (NEU_METRICS_CATEGORY_GLOBAL == ctx->cat ||
+        NEU_METRICS_CATEGORY_ALL == ctx->cat) {
+        gen_global_metrics(metrics, b, ctx->fmt);
+    }
+
+    if (NEU_METRICS_CATEGORY_GLOBAL == ctx->cat) {
+        return;
+    }
+
+    neu_node_metrics_t *n = NULL;
     if (ctx->node[0]) {
-        neu_node_metrics_t *n = NULL;
         HASH_FIND_STR(metrics->node_metrics, ctx->node, n);
         if (NULL == n || 0 == (ctx->filter & n->type)) {
             *ctx->status = NNG_HTTP_STATUS_NOT_FOUND;
             return;
         }
-        gen_single_node_metrics(n, ctx->stream);
-    } else {
-        gen_all_node_metrics(metrics, ctx->filter, ctx->stream);
+    }
+
+    if (0 != gen_nodes_metrics(ctx->filter, n, b, ctx->fmt)) {
+        *ctx->status = NNG_HTTP_STATUS_NOT_FOUND;
     }
 }
 
 void handle_get_metric(nng_aio *aio)
 {
-    int    status = NNG_HTTP_STATUS_OK;
-    char * result = NULL;
-    size_t len    = 0;
-    FILE * stream = NULL;
+    int             status = NNG_HTTP_STATUS_OK;
+    metric_format_e fmt    = METRIC_FORMAT_PROMETHEUS;
 
     neu_metrics_category_e cat           = NEU_METRICS_CATEGORY_ALL;
     size_t                 cat_param_len = 0;
@@ -346,7 +882,12 @@ void handle_get_metric(nng_aio *aio)
         nlog_error("invalid metrics category: %.*s", (int) cat_param_len,
                    cat_param);
         status = NNG_HTTP_STATUS_BAD_REQUEST;
-        goto end;
+        goto error;
+    }
+
+    if (!parse_metrics_format(aio, &fmt)) {
+        status = NNG_HTTP_STATUS_BAD_REQUEST;
+        goto error;
     }
 
     char    node_name[NEU_NODE_NAME_LEN] = { 0 };
@@ -355,44 +896,61 @@ void handle_get_metric(nng_aio *aio)
     if (-1 == rv || rv >= NEU_NODE_NAME_LEN ||
         (0 < rv && NEU_METRICS_CATEGORY_GLOBAL == cat)) {
         status = NNG_HTTP_STATUS_BAD_REQUEST;
-        goto end;
-    }
-
-    stream = open_memstream(&result, &len);
-    if (NULL == stream) {
-        status = NNG_HTTP_STATUS_INTERNAL_SERVER_ERROR;
-        goto end;
+        goto error;
     }
 
     struct context ctx = {
+        .cat    = cat,
+        .fmt    = fmt,
         .status = &status,
-        .stream = stream,
         .node   = node_name,
     };
 
     switch (cat) {
-    case NEU_METRICS_CATEGORY_GLOBAL:
-        neu_metrics_visist((neu_metrics_cb_t) gen_global_metrics, stream);
-        break;
     case NEU_METRICS_CATEGORY_DRIVER:
         ctx.filter = NEU_NA_TYPE_DRIVER;
-        neu_metrics_visist((neu_metrics_cb_t) gen_node_metrics, &ctx);
         break;
     case NEU_METRICS_CATEGORY_APP:
         ctx.filter = NEU_NA_TYPE_APP;
-        neu_metrics_visist((neu_metrics_cb_t) gen_node_metrics, &ctx);
         break;
-    case NEU_METRICS_CATEGORY_ALL:
+    default:
         ctx.filter = NEU_NA_TYPE_DRIVER | NEU_NA_TYPE_APP;
-        neu_metrics_visist((neu_metrics_cb_t) gen_global_metrics, stream);
-        neu_metrics_visist((neu_metrics_cb_t) gen_node_metrics, &ctx);
         break;
     }
 
-end:
-    if (NULL != stream) {
-        fclose(stream);
+    pthread_mutex_lock(&g_exporter.mtx);
+
+    metric_buf_t *body     = &g_exporter.out;
+    const char *  encoding = NULL;
+
+    buf_reset(body);
+    neu_metrics_visist(gen_metrics, &ctx);
+    if (METRIC_FORMAT_OPENMETRICS == fmt) {
+        buf_puts(body, "# EOF\n");
+    }
+
+    if (NNG_HTTP_STATUS_OK == status && body->oom) {
+        status = NNG_HTTP_STATUS_INTERNAL_SERVER_ERROR;
+    }
+
+    if (NNG_HTTP_STATUS_OK == status && body->len >= METRIC_GZIP_MIN_SIZE &&
+        accept_gzip(aio) && 0 == gzip_buf(body, &g_exporter.gz)) {
+        body     = &g_exporter.gz;
+        encoding = "gzip";
     }
-    response(aio, NNG_HTTP_STATUS_OK == status ? result : NULL, status);
-    free(result);
+
+    if (NNG_HTTP_STATUS_OK == status) {
+        response(aio,
+                 METRIC_FORMAT_OPENMETRICS == fmt
+                     ? METRIC_CONTENT_TYPE_OPENMETRICS
+                     : METRIC_CONTENT_TYPE_TEXT,
+                 encoding, body->data, body->len, status);
+    } else {
+        response(aio, METRIC_CONTENT_TYPE_TEXT, NULL, NULL, 0, status);
+    }
+    pthread_mutex_unlock(&g_exporter.mtx);
+    return;
+
+error:
+    response(aio, METRIC_CONTENT_TYPE_TEXT, NULL, NULL, 0, status);
 }
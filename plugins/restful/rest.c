@@ -33,6 +33,7 @@
 #include "handle.h"
 #include "normal_handle.h"
 #include "otel/otel_manager.h"
+#include "persist/persist.h"
 #include "plugin_handle.h"
 #include "rest.h"
 #include "rw_handle.h"
@@ -232,11 +233,96 @@ static int dashb_plugin_config(neu_plugin_t *plugin, const char *configs)
     return rv;
 }
 
+/**
+ * @brief 取配置修改类应答的错误码，其他应答返回 NULL。
+ */
+static int *persist_resp_error(neu_reqresp_head_t *header, void *data)
+{
+    switch (header->type) {
+    case NEU_RESP_ERROR:
+        return &((neu_resp_error_t *) data)->error;
+    case NEU_RESP_ADD_TAG:
+    case NEU_RESP_ADD_GTAG:
+    case NEU_RESP_UPDATE_TAG:
+        return &((neu_resp_add_tag_t *) data)->error;
+    default:
+        return NULL;
+    }
+}
+
+static int dashb_plugin_response(neu_reqresp_head_t *header, void *data);
+
+/**
+ * @brief 请求入队的持久化命令执行完成后发送暂存的应答。
+ *
+ * 持久化失败时把原本成功的应答改为 NEU_ERR_EINTERNAL，已有的错误保持不变。
+ */
+static void persist_resp_cb(int error, void *arg)
+{
+    neu_reqresp_head_t *header     = (neu_reqresp_head_t *) arg;
+    int *               resp_error = persist_resp_error(header, &header[1]);
+
+    if (0 != error) {
+        nlog_error("persist fail before response %s, error: %d",
+                   neu_reqresp_type_string(header->type), error);
+        if (NEU_ERR_SUCCESS == *resp_error) {
+            *resp_error = NEU_ERR_EINTERNAL;
+        }
+    }
+
+    dashb_plugin_response(header, &header[1]);
+    free(header);
+}
+
+/**
+ * @brief 配置修改类请求的应答等请求自己入队的持久化命令完成后再回复。
+ *
+ * 应答连同消息体暂存下来，由持久化完成时的回调发送，不阻塞事件循环。
+ * @return 应答已暂存返回 true，需要立即回复返回 false。
+ */
+static bool defer_response(neu_reqresp_head_t *header, void *data)
+{
+    neu_persist_ticket_t *ticket = neu_persister_track_take();
+
+    if (NULL == ticket) {
+        return false;
+    }
+
+    if (NULL == header->ctx || NULL == persist_resp_error(header, data)) {
+        neu_persister_ticket_release(ticket);
+        return false;
+    }
+
+    size_t              body = header->len - sizeof(neu_reqresp_head_t);
+    neu_reqresp_head_t *copy = malloc(header->len);
+    if (NULL == copy) {
+        nlog_warn("response %s without waiting for persist",
+                  neu_reqresp_type_string(header->type));
+        neu_persister_ticket_release(ticket);
+        return false;
+    }
+
+    *copy                = *header;
+    copy->persist_ticket = NULL;
+    memcpy(&copy[1], data, body);
+    neu_persister_ticket_wait(ticket, persist_resp_cb, copy);
+    return true;
+}
+
 static int dashb_plugin_request(neu_plugin_t *      plugin,
                                 neu_reqresp_head_t *header, void *data)
 {
     (void) plugin;
 
+    if (defer_response(header, data)) {
+        return 0;
+    }
+
+    return dashb_plugin_response(header, data);
+}
+
+static int dashb_plugin_response(neu_reqresp_head_t *header, void *data)
+{
     if (header->ctx && nng_aio_get_input(header->ctx, 3)) {
         // catch all response messages for global config request
         handle_global_config_resp(header->ctx, header->type, data);
@@ -358,6 +444,14 @@ static int dashb_plugin_request(neu_plugin_t *      plugin,
             neu_otel_scope_set_status_code2(scope, NEU_OTEL_STATUS_OK, 0);
         }
         break;
+    case NEU_RESP_IMPORT_CONFIG:
+        handle_import_global_config_resp(header->ctx,
+                                         (neu_resp_import_config_t *) data);
+        if (neu_otel_control_is_started() && trace) {
+            neu_otel_scope_add_span_attr_int(
+                scope, "error", ((neu_resp_import_config_t *) data)->error);
+        }
+        break;
     case NEU_RESP_GET_NODES_STATE:
         handle_get_nodes_state_resp(header->ctx,
                                     (neu_resp_get_nodes_state_t *) data);
@@ -991,8 +991,19 @@ void handle_test_read_tag_resp(nng_aio *aio, neu_resp_test_read_tag_t *resp)
 void handle_write_tags_resp(nng_aio *aio, neu_resp_write_tags_t *resp)
 {
     char *result = NULL;
+    int   error  = NEU_ERR_SUCCESS;
+
+    // 与整体写失败时一样，按第一个失败点位的错误码返回 HTTP 状态
+    utarray_foreach(resp->tags, neu_resp_write_tags_ele_t *, ele)
+    {
+        if (ele->error != NEU_ERR_SUCCESS) {
+            error = ele->error;
+            break;
+        }
+    }
+
     neu_json_encode_by_fn(resp, neu_json_encode_write_tags_resp, &result);
-    neu_http_ok(aio, result);
+    neu_http_response(aio, error, result);
     free(result);
     utarray_free(resp->tags);
 }
\ No newline at end of file
@@ -426,4 +426,391 @@ static void modbus_write(struct modbus_register *reg, uint8_t function,
         assert(1 != 0);
     }
     pthread_mutex_unlock(&reg->mutex);
-}
\ No newline at end of file
+}
+
+/* ---------------------------- 压测模式 ---------------------------- */
+
+#define LOAD_PDU_BUCKETS 32  // PDU 长度分布，每 8 字节一个桶
+#define LOAD_RATE_BUCKETS 24 // 每秒请求数分布，按 2 的幂分桶
+
+struct load_slave {
+    uint64_t  tick; // 最近一次应用变化规律的周期号
+    uint16_t *input_register;
+    uint16_t *hold_register;
+    uint8_t * input;
+    uint8_t * coil;
+};
+
+struct load_stats {
+    uint64_t requests;
+    uint64_t exceptions; // 注入的与真实的异常响应
+    uint64_t injected;   // 其中注入的异常响应
+    uint64_t dropped;
+    uint64_t function[256];
+    uint64_t req_pdu[LOAD_PDU_BUCKETS];
+    uint64_t res_pdu[LOAD_PDU_BUCKETS];
+    uint64_t rate[LOAD_RATE_BUCKETS];
+    uint64_t last_requests; // 仅 modbus_s_load_tick 访问
+    uint64_t max_rate;
+};
+
+static modbus_s_load_param_t load_param  = { 0 };
+static struct load_slave **  load_slaves = NULL;
+static struct load_stats     load_stats  = { 0 };
+static int64_t               load_start  = 0;
+
+static __thread uint64_t load_rand = 0;
+
+static inline uint64_t load_next_rand(uint16_t port)
+{
+    if (load_rand == 0) {
+        load_rand = 0x9E3779B97F4A7C15ULL ^ (port + 1);
+    }
+
+    load_rand ^= load_rand << 13;
+    load_rand ^= load_rand >> 7;
+    load_rand ^= load_rand << 17;
+    return load_rand;
+}
+
+static inline void load_count(uint64_t *counter, uint64_t n)
+{
+    __atomic_fetch_add(counter, n, __ATOMIC_RELAXED);
+}
+
+static inline uint32_t load_pdu_bucket(uint32_t len)
+{
+    uint32_t bucket = len / 8;
+    return bucket < LOAD_PDU_BUCKETS ? bucket : LOAD_PDU_BUCKETS - 1;
+}
+
+int modbus_s_load_init(const modbus_s_load_param_t *param)
+{
+    if (param->n_port == 0 || param->n_slave == 0 || param->n_slave > 247 ||
+        param->n_register == 0 || param->n_register > 65536 ||
+        param->tick_ms == 0) {
+        return -1;
+    }
+
+    load_param  = *param;
+    load_slaves = calloc((size_t) param->n_port * param->n_slave,
+                         sizeof(struct load_slave *));
+    load_start  = neu_time_mono_ns() / 1000000;
+
+    return load_slaves == NULL ? -1 : 0;
+}
+
+/**
+ * 从站的寄存器表在第一次被访问时分配，未被访问的从站不占内存。
+ */
+static struct load_slave *load_get_slave(uint16_t port, uint8_t slave_id)
+{
+    struct load_slave **slot =
+        &load_slaves[(size_t) port * load_param.n_slave + slave_id - 1];
+
+    if (*slot == NULL) {
+        uint32_t           n     = load_param.n_register;
+        struct load_slave *slave = calloc(1, sizeof(struct load_slave));
+
+        slave->input_register = calloc(n, sizeof(uint16_t));
+        slave->hold_register  = calloc(n, sizeof(uint16_t));
+        slave->input          = calloc(n, sizeof(uint8_t));
+        slave->coil           = calloc(n, sizeof(uint8_t));
+        slave->tick = neu_time_mono_ms_coarse() / load_param.tick_ms;
+
+        // 初值与站号、地址相关，便于核对读到的数据来自哪个从站
+        for (uint32_t i = 0; i < n; i++) {
+            slave->input_register[i] = (uint16_t)(slave_id * 1000 + i);
+            slave->hold_register[i]  = slave->input_register[i];
+            slave->input[i]          = slave->input_register[i] & 0x1;
+        }
+
+        *slot = slave;
+    }
+
+    return *slot;
+}
+
+/**
+ * 按经过的周期数补齐输入寄存器和离散输入的变化，只在读取时计算。
+ */
+static void load_apply_pattern(uint16_t port, struct load_slave *slave)
+{
+    uint64_t tick  = neu_time_mono_ms_coarse() / load_param.tick_ms;
+    uint64_t steps = tick - slave->tick;
+
+    if (steps == 0 || load_param.pattern == MODBUS_S_PATTERN_STATIC) {
+        slave->tick = tick;
+        return;
+    }
+    slave->tick = tick;
+
+    for (uint32_t i = 0; i < load_param.n_register; i++) {
+        if (load_param.pattern == MODBUS_S_PATTERN_RAMP) {
+            slave->input_register[i] += (uint16_t) steps;
+        } else {
+            // 随机游走最多补 16 步，避免长时间未访问后一次计算过多
+            for (uint64_t k = 0; k < steps && k < 16; k++) {
+                slave->input_register[i] += load_next_rand(port) % 3 - 1;
+            }
+        }
+        slave->input[i] = slave->input_register[i] & 0x1;
+    }
+}
+
+static int load_exception(uint8_t *pdu, uint8_t function, uint8_t code)
+{
+    pdu[0] = function | 0x80;
+    pdu[1] = code;
+    load_count(&load_stats.exceptions, 1);
+    return 2;
+}
+
+/**
+ * @brief 处理一个 PDU，响应写入 res，返回响应 PDU 长度。
+ */
+static int load_handle_pdu(struct load_slave *slave, const uint8_t *pdu,
+                           uint16_t pdu_len, uint8_t *res)
+{
+    uint8_t  function = pdu[0];
+    uint16_t start    = 0;
+    uint16_t n        = 0;
+    uint32_t limit    = load_param.n_register;
+
+    if (pdu_len < 5) {
+        return load_exception(res, function, 0x03);
+    }
+
+    start = (uint16_t)(pdu[1] << 8 | pdu[2]);
+    n     = (uint16_t)(pdu[3] << 8 | pdu[4]);
+
+    switch (function) {
+    case MODBUS_READ_COIL:
+    case MODBUS_READ_INPUT: {
+        const uint8_t *bits =
+            function == MODBUS_READ_COIL ? slave->coil : slave->input;
+
+        if (n == 0 || n > 2000) {
+            return load_exception(res, function, 0x03);
+        }
+        if ((uint32_t) start + n > limit) {
+            return load_exception(res, function, 0x02);
+        }
+
+        res[0] = function;
+        res[1] = (uint8_t)((n + 7) / 8);
+        memset(&res[2], 0, res[1]);
+        for (uint16_t i = 0; i < n; i++) {
+            res[2 + i / 8] |= (bits[start + i] & 0x1) << (i % 8);
+        }
+        return 2 + res[1];
+    }
+    case MODBUS_READ_HOLD_REG:
+    case MODBUS_READ_INPUT_REG: {
+        const uint16_t *regs = function == MODBUS_READ_HOLD_REG
+            ? slave->hold_register
+            : slave->input_register;
+
+        if (n == 0 || n > 125) {
+            return load_exception(res, function, 0x03);
+        }
+        if ((uint32_t) start + n > limit) {
+            return load_exception(res, function, 0x02);
+        }
+
+        res[0] = function;
+        res[1] = (uint8_t)(n * 2);
+        for (uint16_t i = 0; i < n; i++) {
+            res[2 + i * 2] = regs[start + i] >> 8;
+            res[3 + i * 2] = regs[start + i] & 0xff;
+        }
+        return 2 + res[1];
+    }
+    case MODBUS_WRITE_S_COIL:
+    case MODBUS_WRITE_S_HOLD_REG:
+        if (start >= limit) {
+            return load_exception(res, function, 0x02);
+        }
+        if (function == MODBUS_WRITE_S_COIL) {
+            if (n != 0xff00 && n != 0x0000) {
+                return load_exception(res, function, 0x03);
+            }
+            slave->coil[start] = n == 0xff00;
+        } else {
+            slave->hold_register[start] = n;
+        }
+
+        memcpy(res, pdu, 5);
+        return 5;
+    case MODBUS_WRITE_M_COIL:
+    case MODBUS_WRITE_M_HOLD_REG: {
+        uint16_t max_n = function == MODBUS_WRITE_M_COIL ? 1968 : 123;
+        uint8_t  bytes = function == MODBUS_WRITE_M_COIL ? (n + 7) / 8 : n * 2;
+
+        if (n == 0 || n > max_n || pdu_len < 6 || pdu[5] != bytes ||
+            pdu_len < 6 + bytes) {
+            return load_exception(res, function, 0x03);
+        }
+        if ((uint32_t) start + n > limit) {
+            return load_exception(res, function, 0x02);
+        }
+
+        for (uint16_t i = 0; i < n; i++) {
+            if (function == MODBUS_WRITE_M_COIL) {
+                slave->coil[start + i] = (pdu[6 + i / 8] >> (i % 8)) & 0x1;
+            } else {
+                slave->hold_register[start + i] =
+                    (uint16_t)(pdu[6 + i * 2] << 8 | pdu[7 + i * 2]);
+            }
+        }
+
+        memcpy(res, pdu, 5);
+        return 5;
+    }
+    default:
+        return load_exception(res, function, 0x01);
+    }
+}
+
+ssize_t modbus_s_load_tcp_req(uint16_t port, uint8_t *req, uint16_t req_len,
+                              uint8_t *res, int res_mlen, int *res_len,
+                              uint32_t *delay_us)
+{
+    struct modbus_header *header     = (struct modbus_header *) req;
+    struct modbus_code *  code       = (struct modbus_code *) &header[1];
+    struct modbus_header *res_header = (struct modbus_header *) res;
+    struct modbus_code *  res_code   = (struct modbus_code *) &res_header[1];
+    uint8_t *             res_pdu    = (uint8_t *) &res_code->function;
+    uint16_t              len        = 0;
+    uint16_t              pdu_len    = 0;
+    int                   out        = 0;
+
+    *res_len  = 0;
+    *delay_us = 0;
+
+    if (req_len < sizeof(struct modbus_header)) {
+        return 0;
+    }
+
+    len = ntohs(header->len);
+    if (header->protocol != 0x0000 || len < 2 || len > 254) {
+        return -1;
+    }
+    if (req_len < sizeof(struct modbus_header) + len) {
+        return 0;
+    }
+
+    // PDU 为功能码加数据，不含单元标识
+    pdu_len = len - 1;
+    load_count(&load_stats.requests, 1);
+    load_count(&load_stats.function[code->function], 1);
+    load_count(&load_stats.req_pdu[load_pdu_bucket(pdu_len)], 1);
+
+    if (load_param.drop_ppm > 0 &&
+        load_next_rand(port) % 1000000 < load_param.drop_ppm) {
+        load_count(&load_stats.dropped, 1);
+        return sizeof(struct modbus_header) + len;
+    }
+
+    if (code->slave_id == 0 || code->slave_id > load_param.n_slave) {
+        // 网关类设备对不存在的站号返回 0x0B
+        out = load_exception(res_pdu, code->function, 0x0B);
+    } else if (load_param.exception_ppm > 0 &&
+               load_next_rand(port) % 1000000 < load_param.exception_ppm) {
+        out = load_exception(res_pdu, code->function,
+                             load_param.exception_code);
+        load_count(&load_stats.injected, 1);
+    } else {
+        struct load_slave *slave = load_get_slave(port, code->slave_id);
+
+        load_apply_pattern(port, slave);
+        out = load_handle_pdu(slave, &code->function, pdu_len, res_pdu);
+    }
+
+    res_header->seq      = header->seq;
+    res_header->protocol = 0;
+    res_header->len      = htons(out + 1);
+    res_code->slave_id   = code->slave_id;
+    *res_len = sizeof(struct modbus_header) + sizeof(uint8_t) + out;
+    assert(res_mlen >= *res_len);
+
+    load_count(&load_stats.res_pdu[load_pdu_bucket(out)], 1);
+
+    if (load_param.latency_us > 0 || load_param.jitter_us > 0) {
+        int64_t delay = load_param.latency_us;
+
+        if (load_param.jitter_us > 0) {
+            delay += (int64_t)(load_next_rand(port) %
+                               (2 * (uint64_t) load_param.jitter_us + 1)) -
+                load_param.jitter_us;
+        }
+        *delay_us = delay > 0 ? (uint32_t) delay : 0;
+    }
+
+    return sizeof(struct modbus_header) + len;
+}
+
+void modbus_s_load_tick()
+{
+    uint64_t requests =
+        __atomic_load_n(&load_stats.requests, __ATOMIC_RELAXED);
+    uint64_t rate   = requests - load_stats.last_requests;
+    uint32_t bucket = rate == 0 ? 0 : 64 - __builtin_clzll(rate);
+
+    load_stats.last_requests = requests;
+    if (rate > load_stats.max_rate) {
+        load_stats.max_rate = rate;
+    }
+    if (bucket >= LOAD_RATE_BUCKETS) {
+        bucket = LOAD_RATE_BUCKETS - 1;
+    }
+    load_stats.rate[bucket] += 1;
+}
+
+static void load_dump_array(FILE *fp, const char *name, uint64_t *array,
+                            int n)
+{
+    fprintf(fp, "\"%s\":[", name);
+    for (int i = 0; i < n; i++) {
+        fprintf(fp, "%s%" PRIu64, i == 0 ? "" : ",",
+                __atomic_load_n(&array[i], __ATOMIC_RELAXED));
+    }
+    fprintf(fp, "]");
+}
+
+void modbus_s_load_dump(FILE *fp)
+{
+    int64_t  elapsed  = neu_time_mono_ns() / 1000000 - load_start;
+    uint64_t requests = __atomic_load_n(&load_stats.requests, __ATOMIC_RELAXED);
+    bool     first    = true;
+
+    fprintf(fp,
+            "{\"uptime_ms\":%" PRId64 ",\"requests\":%" PRIu64
+            ",\"avg_rate\":%.1f,\"max_rate\":%" PRIu64
+            ",\"exceptions\":%" PRIu64 ",\"injected\":%" PRIu64
+            ",\"dropped\":%" PRIu64 ",\"function\":{",
+            elapsed, requests,
+            elapsed > 0 ? requests * 1000.0 / elapsed : 0.0,
+            load_stats.max_rate,
+            __atomic_load_n(&load_stats.exceptions, __ATOMIC_RELAXED),
+            __atomic_load_n(&load_stats.injected, __ATOMIC_RELAXED),
+            __atomic_load_n(&load_stats.dropped, __ATOMIC_RELAXED));
+    for (int i = 0; i < 256; i++) {
+        uint64_t n = __atomic_load_n(&load_stats.function[i], __ATOMIC_RELAXED);
+        if (n > 0) {
+            fprintf(fp, "%s\"%d\":%" PRIu64, first ? "" : ",", i, n);
+            first = false;
+        }
+    }
+    fprintf(fp, "},");
+
+    // rate[i] 为每秒请求数落在 [2^(i-1), 2^i) 的秒数，rate[0] 为空闲秒数
+    load_dump_array(fp, "rate_hist", load_stats.rate, LOAD_RATE_BUCKETS);
+    fprintf(fp, ",");
+    // pdu[i] 为 PDU 长度落在 [8i, 8i+8) 字节的报文数
+    load_dump_array(fp, "req_pdu_hist", load_stats.req_pdu, LOAD_PDU_BUCKETS);
+    fprintf(fp, ",");
+    load_dump_array(fp, "res_pdu_hist", load_stats.res_pdu, LOAD_PDU_BUCKETS);
+    fprintf(fp, "}\n");
+    fflush(fp);
+}
@@ -32,4 +32,50 @@ ssize_t modbus_s_rtu_req(uint8_t *req, uint16_t req_len, uint8_t *res,
 ssize_t modbus_s_tcp_req(uint8_t *req, uint16_t req_len, uint8_t *res,
                          int res_mlen, int *res_len);
 
+/**
+ * 压测模式：多端口、多从站、按需分配的寄存器表，可配置响应延迟、异常注入、
+ * 丢包和数值变化规律，并统计请求速率与 PDU 长度分布。
+ */
+
+typedef enum {
+    MODBUS_S_PATTERN_STATIC = 0, ///< 数值不变
+    MODBUS_S_PATTERN_RAMP   = 1, ///< 每个周期加 1
+    MODBUS_S_PATTERN_WALK   = 2, ///< 每个周期随机加减 1
+} modbus_s_pattern_e;
+
+typedef struct {
+    uint16_t           n_port;        ///< 监听端口数
+    uint8_t            n_slave;       ///< 每个端口的从站数，站号 1..n_slave
+    uint32_t           n_register;    ///< 每个从站每个区的地址数
+    uint32_t           latency_us;    ///< 响应延迟
+    uint32_t           jitter_us;     ///< 延迟抖动，均匀分布在 ±jitter_us
+    uint32_t           exception_ppm; ///< 异常响应注入概率，百万分之一
+    uint8_t            exception_code;
+    uint32_t           drop_ppm; ///< 不响应概率，百万分之一
+    modbus_s_pattern_e pattern;  ///< 输入寄存器和离散输入的变化规律
+    uint32_t           tick_ms;  ///< 变化周期
+} modbus_s_load_param_t;
+
+int modbus_s_load_init(const modbus_s_load_param_t *param);
+
+/**
+ * @brief 处理 port 号端口上收到的一个 Modbus TCP 请求。
+ *
+ * @return 0 报文不完整；-1 报文非法，应关闭连接；大于 0 为消耗的字节数，
+ * 此时 *res_len 为 0 表示不响应，*delay_us 为响应前应等待的时间。
+ */
+ssize_t modbus_s_load_tcp_req(uint16_t port, uint8_t *req, uint16_t req_len,
+                              uint8_t *res, int res_mlen, int *res_len,
+                              uint32_t *delay_us);
+
+/**
+ * @brief 每秒调用一次，采样请求速率。
+ */
+void modbus_s_load_tick();
+
+/**
+ * @brief 以一行 JSON 输出累计统计。
+ */
+void modbus_s_load_dump(FILE *fp);
+
 #endif
\ No newline at end of file
@@ -16,6 +16,8 @@
  * along with this program; if not, write to the Free Software Foundation,
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  **/
+#include <errno.h>
+#include <getopt.h>
 #include <memory.h>
 #include <signal.h>
 #include <stdbool.h>
@@ -31,7 +33,6 @@ zlog_category_t *neuron           = NULL;
 neu_events_t *   events           = NULL;
 neu_event_io_t * tcp_server_event = NULL;
 neu_conn_t *     conn             = NULL;
-int64_t          global_timestamp = 0;
 bool             exiting          = false;
 
 static void start_listen(void *data, int fd);
@@ -42,6 +43,10 @@ static int  new_client(enum neu_event_io_type type, int fd, void *usr_data);
 static int  recv_msg(enum neu_event_io_type type, int fd, void *usr_data);
 static bool mode_tcp = true;
 
+static int new_load_client(enum neu_event_io_type type, int fd,
+                           void *usr_data);
+static int recv_load_msg(enum neu_event_io_type type, int fd, void *usr_data);
+
 struct client_event {
     neu_event_io_t *client;
     int             fd;
@@ -100,8 +105,14 @@ static void sig_handler(int sig)
     exit(0);
 }
 
+static int load_main(int argc, char *argv[]);
+
 int main(int argc, char *argv[])
 {
+    if (argc >= 2 && strcmp(argv[1], "load") == 0) {
+        return load_main(argc - 1, argv + 1);
+    }
+
     if (argc != 4) {
         printf("./modbus_simulator rtu/tcp port ip_v4/ip_v6\n");
         return -1;
@@ -304,4 +315,370 @@ static int recv_msg(enum neu_event_io_type type, int fd, void *usr_data)
     }
 
     return 0;
-}
\ No newline at end of file
+}
+
+/* ---------------------------- 压测模式 ---------------------------- */
+
+#define LOAD_MAX_LINK 64
+
+struct load_port {
+    uint16_t        index; // 端口序号，对应 modbus_s_load_tcp_req 的 port
+    uint16_t        port;
+    neu_events_t *  events;
+    neu_conn_t *    conn;
+    neu_event_io_t *server;
+};
+
+struct load_client {
+    struct load_port *lport;
+    neu_event_io_t *  io;
+    uint16_t          len;
+    uint8_t           buf[4096];
+};
+
+static void load_usage(void)
+{
+    printf("./modbus_simulator load [options]\n"
+           "  -p, --port <port>            first listening port, default 5020\n"
+           "  -n, --ports <n>              number of listening ports, default 1\n"
+           "  -s, --slaves <n>             slave ids per port (1-247), default 1\n"
+           "  -r, --registers <n>          registers per table, default 1000\n"
+           "  -L, --latency <ms>           response latency, default 0\n"
+           "  -j, --jitter <ms>            latency jitter (+/-), default 0\n"
+           "  -e, --exception-rate <pct>   injected exception rate, default 0\n"
+           "  -E, --exception-code <code>  injected exception code, default 4\n"
+           "  -d, --drop-rate <pct>        dropped request rate, default 0\n"
+           "  -P, --pattern <pattern>      static|ramp|walk, default static\n"
+           "  -k, --tick <ms>              pattern step interval, default 1000\n"
+           "  -t, --threads <n>            event loop threads, default 4\n"
+           "  -S, --stats <s>              stats interval, default 10\n"
+           "  -6, --ipv6                   listen on ipv6\n");
+}
+
+/**
+ * @brief 解析整数参数，非数字、带多余字符或超出 [min, max] 时返回 false。
+ */
+static bool load_parse_int(const char *arg, long min, long max, long *value)
+{
+    char *end = NULL;
+
+    errno  = 0;
+    *value = strtol(arg, &end, 0);
+    return errno == 0 && end != arg && *end == '\0' && *value >= min &&
+        *value <= max;
+}
+
+static void load_sig_handler(int sig)
+{
+    (void) sig;
+    exiting = true;
+}
+
+static void load_start_listen(void *data, int fd)
+{
+    struct load_port *   lport = (struct load_port *) data;
+    neu_event_io_param_t io    = {
+        .fd       = fd,
+        .usr_data = lport,
+        .cb       = new_load_client,
+    };
+
+    lport->server = neu_event_add_io(lport->events, io);
+}
+
+static void load_stop_listen(void *data, int fd)
+{
+    struct load_port *lport = (struct load_port *) data;
+    (void) fd;
+
+    if (lport->server != NULL) {
+        neu_event_del_io(lport->events, lport->server);
+        lport->server = NULL;
+    }
+}
+
+static void load_close_client(struct load_client *client, int fd)
+{
+    struct load_port *lport = client->lport;
+
+    neu_event_del_io(lport->events, client->io);
+    neu_conn_tcp_server_close_client(lport->conn, fd);
+    free(client);
+}
+
+static int new_load_client(enum neu_event_io_type type, int fd, void *usr_data)
+{
+    struct load_port *lport = (struct load_port *) usr_data;
+    (void) fd;
+
+    if (type != NEU_EVENT_IO_READ) {
+        return 0;
+    }
+
+    int client_fd = neu_conn_tcp_server_accept(lport->conn);
+    if (client_fd > 0) {
+        struct load_client * client = calloc(1, sizeof(struct load_client));
+        neu_event_io_param_t io     = {
+            .fd       = client_fd,
+            .usr_data = (void *) client,
+            .cb       = recv_load_msg,
+        };
+
+        client->lport = lport;
+        client->io    = neu_event_add_io(lport->events, io);
+    }
+
+    return 0;
+}
+
+/**
+ * 一次读取可能包含多个流水线请求，逐个处理完整帧后再等待后续数据。
+ * 响应延迟在事件线程内等待，同一线程上其他端口的请求随之排队，
+ * 与单个串行处理请求的从站行为一致。
+ */
+static int recv_load_msg(enum neu_event_io_type type, int fd, void *usr_data)
+{
+    struct load_client *client = (struct load_client *) usr_data;
+    struct load_port *  lport  = client->lport;
+
+    if (exiting) {
+        return 0;
+    }
+
+    if (type != NEU_EVENT_IO_READ) {
+        load_close_client(client, fd);
+        return 0;
+    }
+
+    uint8_t res[512] = { 0 };
+    ssize_t len      = neu_conn_tcp_server_recv(
+        lport->conn, fd, client->buf + client->len,
+        sizeof(client->buf) - client->len);
+    if (len <= 0) {
+        load_close_client(client, fd);
+        return 0;
+    }
+    client->len += len;
+
+    while (client->len > 0) {
+        int      res_len  = 0;
+        uint32_t delay_us = 0;
+
+        len = modbus_s_load_tcp_req(lport->index, client->buf, client->len,
+                                    res, sizeof(res), &res_len, &delay_us);
+        if (len == 0) {
+            break;
+        }
+        if (len < 0) {
+            load_close_client(client, fd);
+            return 0;
+        }
+
+        memmove(client->buf, client->buf + len, client->len - len);
+        client->len -= len;
+
+        if (res_len > 0) {
+            if (delay_us > 0) {
+                usleep(delay_us);
+            }
+            neu_conn_tcp_server_send(lport->conn, fd, res, res_len);
+        }
+    }
+
+    return 0;
+}
+
+static int load_main(int argc, char *argv[])
+{
+    static struct option long_options[] = {
+        { "port", required_argument, NULL, 'p' },
+        { "ports", required_argument, NULL, 'n' },
+        { "slaves", required_argument, NULL, 's' },
+        { "registers", required_argument, NULL, 'r' },
+        { "latency", required_argument, NULL, 'L' },
+        { "jitter", required_argument, NULL, 'j' },
+        { "exception-rate", required_argument, NULL, 'e' },
+        { "exception-code", required_argument, NULL, 'E' },
+        { "drop-rate", required_argument, NULL, 'd' },
+        { "pattern", required_argument, NULL, 'P' },
+        { "tick", required_argument, NULL, 'k' },
+        { "threads", required_argument, NULL, 't' },
+        { "stats", required_argument, NULL, 'S' },
+        { "ipv6", no_argument, NULL, '6' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+    modbus_s_load_param_t param = {
+        .n_port         = 1,
+        .n_slave        = 1,
+        .n_register     = 1000,
+        .exception_code = 0x04,
+        .pattern        = MODBUS_S_PATTERN_STATIC,
+        .tick_ms        = 1000,
+    };
+    int                first_port = 5020;
+    int                n_thread   = 4;
+    int                stats_s    = 10;
+    bool               mode_ipv6  = false;
+    int                c          = 0;
+    neu_events_t **    loops      = NULL;
+    struct load_port * ports      = NULL;
+
+    while ((c = getopt_long(argc, argv, "p:n:s:r:L:j:e:E:d:P:k:t:S:6h",
+                            long_options, NULL)) != -1) {
+        long v = 0;
+
+        switch (c) {
+        case 'p':
+            if (!load_parse_int(optarg, 1025, 65535, &v)) {
+                load_usage();
+                return -1;
+            }
+            first_port = (int) v;
+            break;
+        case 'n':
+            if (!load_parse_int(optarg, 1, 65535, &v)) {
+                load_usage();
+                return -1;
+            }
+            param.n_port = (uint16_t) v;
+            break;
+        case 's':
+            if (!load_parse_int(optarg, 1, 247, &v)) {
+                load_usage();
+                return -1;
+            }
+            param.n_slave = (uint8_t) v;
+            break;
+        case 'r':
+            if (!load_parse_int(optarg, 1, 65536, &v)) {
+                load_usage();
+                return -1;
+            }
+            param.n_register = (uint32_t) v;
+            break;
+        case 'L':
+            param.latency_us = (uint32_t)(atof(optarg) * 1000);
+            break;
+        case 'j':
+            param.jitter_us = (uint32_t)(atof(optarg) * 1000);
+            break;
+        case 'e':
+            param.exception_ppm = (uint32_t)(atof(optarg) * 10000);
+            break;
+        case 'E':
+            if (!load_parse_int(optarg, 1, 255, &v)) {
+                load_usage();
+                return -1;
+            }
+            param.exception_code = (uint8_t) v;
+            break;
+        case 'd':
+            param.drop_ppm = (uint32_t)(atof(optarg) * 10000);
+            break;
+        case 'P':
+            if (strcmp(optarg, "static") == 0) {
+                param.pattern = MODBUS_S_PATTERN_STATIC;
+            } else if (strcmp(optarg, "ramp") == 0) {
+                param.pattern = MODBUS_S_PATTERN_RAMP;
+            } else if (strcmp(optarg, "walk") == 0) {
+                param.pattern = MODBUS_S_PATTERN_WALK;
+            } else {
+                load_usage();
+                return -1;
+            }
+            break;
+        case 'k':
+            if (!load_parse_int(optarg, 1, 86400000, &v)) {
+                load_usage();
+                return -1;
+            }
+            param.tick_ms = (uint32_t) v;
+            break;
+        case 't':
+            if (!load_parse_int(optarg, 1, 1024, &v)) {
+                load_usage();
+                return -1;
+            }
+            n_thread = (int) v;
+            break;
+        case 'S':
+            if (!load_parse_int(optarg, 1, 86400, &v)) {
+                load_usage();
+                return -1;
+            }
+            stats_s = (int) v;
+            break;
+        case '6':
+            mode_ipv6 = true;
+            break;
+        default:
+            load_usage();
+            return c == 'h' ? 0 : -1;
+        }
+    }
+
+    if (first_port <= 1024 || first_port + param.n_port > 65536 ||
+        n_thread <= 0 || stats_s <= 0 || modbus_s_load_init(&param) != 0) {
+        load_usage();
+        return -1;
+    }
+    if (n_thread > param.n_port) {
+        n_thread = param.n_port;
+    }
+
+    zlog_init("./config/dev.conf");
+    neuron = zlog_get_category("neuron");
+
+    loops = calloc(n_thread, sizeof(neu_events_t *));
+    ports = calloc(param.n_port, sizeof(struct load_port));
+    for (int i = 0; i < n_thread; i++) {
+        loops[i] = neu_event_new();
+    }
+
+    for (uint16_t i = 0; i < param.n_port; i++) {
+        neu_conn_param_t conn_param = {
+            .log                            = neuron,
+            .type                           = NEU_CONN_TCP_SERVER,
+            .params.tcp_server.ip           = mode_ipv6 ? "::" : "0.0.0.0",
+            .params.tcp_server.port         = (uint16_t)(first_port + i),
+            .params.tcp_server.timeout      = 0,
+            .params.tcp_server.max_link     = LOAD_MAX_LINK,
+            .params.tcp_server.start_listen = load_start_listen,
+            .params.tcp_server.stop_listen  = load_stop_listen,
+        };
+
+        ports[i].index  = i;
+        ports[i].port   = (uint16_t)(first_port + i);
+        ports[i].events = loops[i % n_thread];
+        ports[i].conn =
+            neu_conn_new(&conn_param, &ports[i], connected, disconnected);
+    }
+
+    nlog_notice("load mode: %d ports from %d, %d slaves, %u registers",
+                param.n_port, first_port, param.n_slave, param.n_register);
+
+    signal(SIGINT, load_sig_handler);
+    signal(SIGTERM, load_sig_handler);
+
+    for (int elapsed = 1; !exiting; elapsed++) {
+        sleep(1);
+        modbus_s_load_tick();
+        if (elapsed % stats_s == 0) {
+            modbus_s_load_dump(stdout);
+        }
+    }
+
+    modbus_s_load_dump(stdout);
+
+    for (uint16_t i = 0; i < param.n_port; i++) {
+        neu_conn_destory(ports[i].conn);
+    }
+    for (int i = 0; i < n_thread; i++) {
+        neu_event_close(loops[i]);
+    }
+    free(ports);
+    free(loops);
+
+    return 0;
+}
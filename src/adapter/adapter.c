@@ -61,6 +61,9 @@ static int adapter_register_metric(neu_adapter_t *adapter, const char *name,
 static int adapter_update_metric(neu_adapter_t *adapter,
                                  const char *metric_name, uint64_t n,
                                  const char *group);
+static neu_metric_handle_t *adapter_metric_handle(neu_adapter_t *adapter,
+                                                  const char *   metric_name,
+                                                  const char *   group);
 inline static void reply(neu_adapter_t *adapter, neu_reqresp_head_t *header,
                          void *data);
 inline static void notify_monitor(neu_adapter_t *    adapter,
@@ -80,6 +83,7 @@ static const adapter_callbacks_t callback_funs = {
     .responseto      = adapter_responseto,
     .register_metric = adapter_register_metric,
     .update_metric   = adapter_update_metric,
+    .metric_handle   = adapter_metric_handle,
 };
 
 /**
@@ -103,18 +107,19 @@ static __thread int create_adapter_error = 0;
     adapter_register_metric(adapter, name, name##_HELP, name##_TYPE, init);
 
 //宏的参数传递，adapter 这个实参就会被传递给宏定义中的每一个 REGISTER_METRIC 调用。
-#define REGISTER_DRIVER_METRICS(adapter)                     \
-    REGISTER_METRIC(adapter, NEU_METRIC_LINK_STATE,          \
-                    NEU_NODE_LINK_STATE_DISCONNECTED);       \
-    REGISTER_METRIC(adapter, NEU_METRIC_RUNNING_STATE,       \
-                    NEU_NODE_RUNNING_STATE_INIT);            \
-    REGISTER_METRIC(adapter, NEU_METRIC_LAST_RTT_MS,         \
-                    NEU_METRIC_LAST_RTT_MS_MAX);             \
-    REGISTER_METRIC(adapter, NEU_METRIC_SEND_BYTES, 0);      \
-    REGISTER_METRIC(adapter, NEU_METRIC_RECV_BYTES, 0);      \
-    REGISTER_METRIC(adapter, NEU_METRIC_TAGS_TOTAL, 0);      \
-    REGISTER_METRIC(adapter, NEU_METRIC_TAG_READS_TOTAL, 0); \
-    REGISTER_METRIC(adapter, NEU_METRIC_TAG_READ_ERRORS_TOTAL, 0);
+#define REGISTER_DRIVER_METRICS(adapter)                           \
+    REGISTER_METRIC(adapter, NEU_METRIC_LINK_STATE,                \
+                    NEU_NODE_LINK_STATE_DISCONNECTED);             \
+    REGISTER_METRIC(adapter, NEU_METRIC_RUNNING_STATE,             \
+                    NEU_NODE_RUNNING_STATE_INIT);                  \
+    REGISTER_METRIC(adapter, NEU_METRIC_LAST_RTT_MS,               \
+                    NEU_METRIC_LAST_RTT_MS_MAX);                   \
+    REGISTER_METRIC(adapter, NEU_METRIC_SEND_BYTES, 0);            \
+    REGISTER_METRIC(adapter, NEU_METRIC_RECV_BYTES, 0);            \
+    REGISTER_METRIC(adapter, NEU_METRIC_TAGS_TOTAL, 0);            \
+    REGISTER_METRIC(adapter, NEU_METRIC_TAG_READS_TOTAL, 0);       \
+    REGISTER_METRIC(adapter, NEU_METRIC_TAG_READ_ERRORS_TOTAL, 0); \
+    REGISTER_METRIC(adapter, NEU_METRIC_TAG_SUPPRESSED_TOTAL, 0);
 
 #define REGISTER_APP_METRICS(adapter)                              \
     REGISTER_METRIC(adapter, NEU_METRIC_LINK_STATE,                \
@@ -203,7 +208,8 @@ neu_adapter_t *neu_adapter_create(neu_adapter_info_t *info, bool load)
     // 根据适配器类型创建适配器实例
     switch (info->module->type) {
     case NEU_NA_TYPE_DRIVER: // 创建驱动类型的适配器
-        adapter = (neu_adapter_t *) neu_adapter_driver_create();
+        adapter = (neu_adapter_t *) neu_adapter_driver_create(
+            info->module->dedicated_events);
         break;
     case NEU_NA_TYPE_APP:    // 为应用类型的适配器分配内存
         adapter = calloc(1, sizeof(neu_adapter_t));
@@ -249,7 +255,6 @@ neu_adapter_t *neu_adapter_create(neu_adapter_info_t *info, bool load)
 
     // 初始化适配器结构体成员
     adapter->name                    = strdup(info->name);
-    adapter->events                  = neu_event_new();
     adapter->state                   = NEU_NODE_RUNNING_STATE_INIT;
     adapter->handle                  = info->handle;
     adapter->cb_funs.command         = callback_funs.command;
@@ -257,11 +262,16 @@ neu_adapter_t *neu_adapter_create(neu_adapter_info_t *info, bool load)
     adapter->cb_funs.responseto      = callback_funs.responseto;
     adapter->cb_funs.register_metric = callback_funs.register_metric;
     adapter->cb_funs.update_metric   = callback_funs.update_metric;
+    adapter->cb_funs.metric_handle   = callback_funs.metric_handle;
     adapter->module                  = info->module;
     adapter->timestamp_lev           = 0;
     adapter->trans_data_port         = 0;
     adapter->log_level               = ZLOG_LEVEL_NOTICE;
 
+    // 插件有阻塞 I/O 时使用独占事件循环，否则取自共享事件循环池
+    adapter->events = info->module->dedicated_events ? neu_event_new()
+                                                     : neu_event_pool_get();
+
     //获取端口号
     uint16_t           port  = neu_manager_get_port();
 
@@ -402,6 +412,7 @@ neu_adapter_t *neu_adapter_create(neu_adapter_info_t *info, bool load)
             neu_adapter_driver_destroy((neu_adapter_driver_t *) adapter);
         } else {
             neu_event_del_io(adapter->events, adapter->trans_data_io);
+            adapter->trans_data_io = NULL;
         }
         neu_event_del_io(adapter->events, adapter->control_io);
 
@@ -584,6 +595,17 @@ static int adapter_update_metric(neu_adapter_t *adapter,
     return neu_node_metrics_update(adapter->metrics, group, metric_name, n);
 }
 
+static neu_metric_handle_t *adapter_metric_handle(neu_adapter_t *adapter,
+                                                  const char *   metric_name,
+                                                  const char *   group)
+{
+    if (NULL == adapter->metrics) {
+        return NULL;
+    }
+
+    return neu_node_metrics_handle(adapter->metrics, group, metric_name);
+}
+
 /**
  * @brief 处理并发送适配器命令。
  *
@@ -959,6 +981,10 @@ static int adapter_loop(enum neu_event_io_type type, int fd, void *usr_data)
               header->sender, header->ctx,
               neu_reqresp_type_string(header->type));
 
+    // 接管请求已入队的持久化命令，处理期间入队的命令也记在其上，随应答带回
+    neu_persister_track_begin(header->persist_ticket);
+    header->persist_ticket = NULL;
+
     // 根据消息类型做不同的处理
     switch (header->type) {
     case NEU_REQ_SUBSCRIBE_GROUP: {
@@ -1326,7 +1352,7 @@ static int adapter_loop(enum neu_event_io_type type, int fd, void *usr_data)
             pthread_mutex_lock(&adapter->metrics->lock);
             neu_metric_entry_t *e = NULL;
             HASH_FIND_STR(adapter->metrics->entries, NEU_METRIC_LAST_RTT_MS, e);
-            resp->rtt = NULL != e ? e->value : 0;
+            resp->rtt = NULL != e ? neu_metric_entry_value(e) : 0;
             pthread_mutex_unlock(&adapter->metrics->lock);
         }
         resp->state  = neu_adapter_get_state(adapter);
@@ -1818,6 +1844,7 @@ static int adapter_loop(enum neu_event_io_type type, int fd, void *usr_data)
         break;
     }
 
+    neu_persister_track_end();
     return 0;
 }
 
@@ -1937,6 +1964,11 @@ int neu_adapter_add_gtags(neu_adapter_t *adapter, neu_req_add_gtag_t *cmd,
 void neu_adapter_destroy(neu_adapter_t *adapter)
 {
     nlog_notice("adapter %s destroy", adapter->name);
+    // 共享事件循环在节点销毁后继续运行，需先移除数据通道的 I/O 事件
+    if (adapter->trans_data_io != NULL) {
+        neu_event_del_io(adapter->events, adapter->trans_data_io);
+        adapter->trans_data_io = NULL;
+    }
     close(adapter->control_fd);
     close(adapter->trans_data_fd);
 
@@ -1971,6 +2003,8 @@ void neu_adapter_destroy(neu_adapter_t *adapter)
     neu_event_close(adapter->events);
 #ifdef NEU_RELEASE
     if (adapter->handle != NULL) {
+        // 缓冲的日志引用插件库中的文件名与函数名字符串
+        neu_log_flush();
         dlclose(adapter->handle);
     }
 #endif
@@ -2222,6 +2256,9 @@ void neu_adapter_del_group_metrics(neu_adapter_t *adapter,
 inline static void reply(neu_adapter_t *adapter, neu_reqresp_head_t *header,
                          void *data)
 {
+    if (NULL != header->ctx) {
+        header->persist_ticket = neu_persister_track_take();
+    }
     neu_msg_gen(header, data);
     int ret = neu_send_msg(adapter->control_fd, (neu_msg_t *) header);
     if (0 != ret) {
@@ -26,6 +26,7 @@
 
 #include "utils/uthash.h"
 
+#include "cvalue.h"
 #include "define.h"
 #include "tag.h"
 
@@ -44,11 +45,20 @@ typedef struct {
     char tag[NEU_TAG_NAME_LEN];
 } tkey_t;
 
+/**
+ * @brief 缓存中的元数据，只保存实际写入的条目。
+ */
+struct cache_meta {
+    char         name[NEU_TAG_NAME_LEN];
+    neu_cvalue_t value;
+};
+
 /**
  * @struct elem
  * @brief 该结构体用于表示缓存中的具体元素数据。
  *
  * 包含时间戳、变更标志、当前值与旧值、元数据数组、键以及UTHash句柄，主要用于管理和保护缓存中的具体数据项。
+ * 值以紧凑值（neu_cvalue_t）保存，元数据按实际个数分配，单个元素约两百字节。
  */
 struct elem {
     /**
@@ -68,23 +78,37 @@ struct elem {
     /**
      * @brief 缓存元素当前值。
      *
-     * 包含该元素当前的数据值。
+     * 包含该元素当前的数据值，精度来自 neu_driver_cache_add。
      */
-    neu_dvalue_t value;
+    neu_cvalue_t value;
 
     /**
      * @brief 旧值。
      *
-     * 包含该元素上一次更新前的数据值，可用于比较或回滚操作。
+     * 开启 sub_filter_err 时记录最近一次非错误值，用于从错误恢复时判断是否变化。
      */
-    neu_dvalue_t value_old;
+    neu_cvalue_t value_old;
 
     /**
-     * @brief 元数据数组。
+     * @brief 元数据个数与数组。
+     */
+    int                n_meta;
+    struct cache_meta *metas;
+
+    /**
+     * @brief 死区配置与上次上报时的状态。
      *
-     * 存储与该元素相关的元数据信息，如单位、数据类型等，大小由 NEU_TAG_META_SIZE 定义。
+     * db_ref 为上次标记变化时的数值，db_dir 为该次变化的方向（-1、0、1），
+     * db_ts 为该次变化的时间戳；db_valid 为 false 时下一个数值作为新的基准。
+     * 缓存中为原始值，按 db_scale、db_bias 换算为上报值后再与死区比较。
      */
-    neu_tag_meta_t metas[NEU_TAG_META_SIZE];
+    neu_datatag_deadband_t deadband;
+    double                 db_scale;
+    double                 db_bias;
+    bool                   db_valid;
+    int8_t                 db_dir;
+    double                 db_ref;
+    int64_t                db_ts;
 
     /**
      * @brief 键。
@@ -172,6 +196,190 @@ inline static tkey_t to_key(const char *group, const char *tag)
     return key;
 }
 
+static void elem_free_metas(struct elem *elem)
+{
+    for (int i = 0; i < elem->n_meta; i++) {
+        neu_cvalue_release(&elem->metas[i].value);
+    }
+
+    free(elem->metas);
+    elem->metas  = NULL;
+    elem->n_meta = 0;
+}
+
+static void elem_free(struct elem *elem)
+{
+    neu_cvalue_release(&elem->value);
+    neu_cvalue_release(&elem->value_old);
+    elem_free_metas(elem);
+    free(elem);
+}
+
+/**
+ * @brief 判断新值相对旧值是否变化，浮点数按旧值的精度比较。
+ */
+static bool value_changed(const neu_cvalue_t *old, const neu_cvalue_t *value)
+{
+    if (old->type == value->type && old->precision != 0) {
+        if (value->type == NEU_TYPE_FLOAT) {
+            return fabs(old->value.f32 - value->value.f32) >
+                pow(0.1, old->precision);
+        }
+        if (value->type == NEU_TYPE_DOUBLE) {
+            return fabs(old->value.d64 - value->value.d64) >
+                pow(0.1, old->precision);
+        }
+    }
+
+    return !neu_cvalue_equal(old, value);
+}
+
+/**
+ * @brief 取数值类型的值，非数值类型返回 false。
+ */
+static bool cvalue_number(const neu_cvalue_t *value, double *number)
+{
+    switch (value->type) {
+    case NEU_TYPE_INT8:
+        *number = value->value.i8;
+        return true;
+    case NEU_TYPE_UINT8:
+        *number = value->value.u8;
+        return true;
+    case NEU_TYPE_INT16:
+        *number = value->value.i16;
+        return true;
+    case NEU_TYPE_UINT16:
+        *number = value->value.u16;
+        return true;
+    case NEU_TYPE_INT32:
+        *number = value->value.i32;
+        return true;
+    case NEU_TYPE_UINT32:
+        *number = value->value.u32;
+        return true;
+    case NEU_TYPE_INT64:
+        *number = (double) value->value.i64;
+        return true;
+    case NEU_TYPE_UINT64:
+        *number = (double) value->value.u64;
+        return true;
+    case NEU_TYPE_FLOAT:
+        *number = value->value.f32;
+        return true;
+    case NEU_TYPE_DOUBLE:
+        *number = value->value.d64;
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * @brief 按上次上报值计算死区宽度，reverse 表示变化方向与上次相反。
+ */
+static double deadband_width(const neu_datatag_deadband_t *deadband,
+                             double ref, bool reverse)
+{
+    double width      = deadband->value;
+    double hysteresis = deadband->hysteresis;
+
+    switch (deadband->type) {
+    case NEU_DEADBAND_SPAN:
+        width      = deadband->span * deadband->value / 100;
+        hysteresis = deadband->span * deadband->hysteresis / 100;
+        break;
+    case NEU_DEADBAND_VALUE:
+        width      = fabs(ref) * deadband->value / 100;
+        hysteresis = fabs(ref) * deadband->hysteresis / 100;
+        break;
+    case NEU_DEADBAND_ABSOLUTE:
+        break;
+    default:
+        return 0;
+    }
+
+    return reverse ? width + hysteresis : width;
+}
+
+/**
+ * @brief 对已判定的变化应用死区与心跳，调用时需持有缓存锁。
+ *
+ * 数值与上次上报值之差不超过死区时不上报，suppressed 置为 true；距上次
+ * 上报超过心跳时间时即使数值未变也上报。非数值（如错误值）不过滤，上报
+ * 后以下一个数值作为新的基准。
+ *
+ * @return 是否标记为变化。
+ */
+static bool deadband_filter(struct elem *elem, const neu_cvalue_t *value,
+                            bool changed, bool force, int64_t timestamp,
+                            bool *suppressed)
+{
+    const neu_datatag_deadband_t *deadband = &elem->deadband;
+    double                        number   = 0;
+
+    if (!cvalue_number(value, &number)) {
+        if (changed || force) {
+            elem->db_valid = false;
+            elem->db_ts    = timestamp;
+        }
+        return changed;
+    }
+
+    number = number * elem->db_scale + elem->db_bias;
+    if (!elem->db_valid) {
+        elem->db_valid = true;
+        elem->db_ref   = number;
+        elem->db_dir   = 0;
+        elem->db_ts    = timestamp;
+        return changed;
+    }
+
+    double delta     = number - elem->db_ref;
+    int8_t dir       = delta > 0 ? 1 : (delta < 0 ? -1 : 0);
+    bool   exceed    = changed;
+    bool   heartbeat = deadband->heartbeat > 0 &&
+        timestamp - elem->db_ts >= (int64_t) deadband->heartbeat;
+
+    if (changed && deadband->type != NEU_DEADBAND_NONE) {
+        bool reverse = dir != 0 && elem->db_dir != 0 && dir != elem->db_dir;
+        exceed = fabs(delta) > deadband_width(deadband, elem->db_ref, reverse);
+    }
+
+    if (force || exceed || heartbeat) {
+        elem->db_ref = number;
+        elem->db_dir = dir != 0 ? dir : elem->db_dir;
+        elem->db_ts  = timestamp;
+        return true;
+    }
+
+    if (changed) {
+        *suppressed = true;
+    }
+    return false;
+}
+
+/**
+ * @brief 复制当前值与元数据到调用者的结构中，调用时需持有缓存锁。
+ */
+static void elem_read(struct elem *elem, neu_driver_cache_value_t *value,
+                      neu_tag_meta_t *metas, int n_meta)
+{
+    assert(n_meta <= NEU_TAG_META_SIZE);
+
+    value->timestamp = elem->timestamp;
+    neu_cvalue_to_dvalue(&elem->value, &value->value);
+
+    for (int i = 0; i < n_meta; i++) {
+        if (i < elem->n_meta) {
+            strcpy(metas[i].name, elem->metas[i].name);
+            neu_cvalue_to_dvalue(&elem->metas[i].value, &metas[i].value);
+        } else {
+            metas[i].name[0] = '\0';
+        }
+    }
+}
+
 neu_driver_cache_t *neu_driver_cache_new()
 {
     neu_driver_cache_t *cache = calloc(1, sizeof(neu_driver_cache_t));
@@ -198,24 +406,7 @@ void neu_driver_cache_destroy(neu_driver_cache_t *cache)
     {
         // 每个元素从哈希表中删除，并释放其占用的内存
         HASH_DEL(cache->table, elem);
-        if (elem->value.type == NEU_TYPE_PTR) {
-            if (elem->value.value.ptr.ptr != NULL) {
-                free(elem->value.value.ptr.ptr);
-                elem->value.value.ptr.ptr = NULL;
-            }
-        } else if (elem->value.type == NEU_TYPE_CUSTOM) {
-            if (elem->value.value.json != NULL) {
-                json_decref(elem->value.value.json);
-                elem->value.value.json = NULL;
-            }
-        } else if (elem->value.type == NEU_TYPE_ARRAY_STRING) {
-            for (int i = 0; i < elem->value.value.strs.length; i++) {
-                free(elem->value.value.strs.strs[i]);
-                elem->value.value.strs.strs[i] = NULL;
-            }
-        }
-
-        free(elem);
+        elem_free(elem);
     }
 
     group_trace_t *elem1 = NULL;
@@ -274,7 +465,43 @@ void neu_driver_cache_add(neu_driver_cache_t *cache, const char *group,
 
     elem->timestamp = 0;
     elem->changed   = false;
-    elem->value     = value;
+    elem->db_valid  = false;
+    neu_cvalue_release(&elem->value);
+    neu_cvalue_from_dvalue(&elem->value, &value);
+
+    pthread_mutex_unlock(&cache->mtx);
+}
+
+/**
+ * @brief 设置标签的死区配置，并以下一个数值作为新的上报基准。
+ *
+ * 死区按上报值配置，缓存中的原始值先乘以 decimal（为 0 时不缩放）再加上
+ * bias，与驱动读取时的换算一致。
+ *
+ * @param cache 驱动缓存。
+ * @param group 组名称。
+ * @param tag 标签名称，需已通过 neu_driver_cache_add 加入缓存。
+ * @param deadband 死区配置。
+ * @param decimal 标签的缩放系数。
+ * @param bias 标签的偏移量。
+ */
+void neu_driver_cache_set_deadband(neu_driver_cache_t *cache, const char *group,
+                                   const char *                  tag,
+                                   const neu_datatag_deadband_t *deadband,
+                                   double decimal, double bias)
+{
+    struct elem *elem = NULL;
+    tkey_t       key  = to_key(group, tag);
+
+    pthread_mutex_lock(&cache->mtx);
+    HASH_FIND(hh, cache->table, &key, sizeof(tkey_t), elem);
+
+    if (elem != NULL) {
+        elem->deadband = *deadband;
+        elem->db_scale = decimal != 0 ? decimal : 1;
+        elem->db_bias  = bias;
+        elem->db_valid = false;
+    }
 
     pthread_mutex_unlock(&cache->mtx);
 }
@@ -355,15 +582,31 @@ void *neu_driver_cache_get_trace(neu_driver_cache_t *cache, const char *group)
  * @param metas 元数据数组，包含与该值相关的元数据信息。
  * @param n_meta 元数据的数量。
  * @param change 如果为 true，则表示这是一个变化事件；否则不是。
+ * @return 值发生变化但被死区过滤时返回 true。
  */
-void neu_driver_cache_update_change(neu_driver_cache_t *cache,
+bool neu_driver_cache_update_change(neu_driver_cache_t *cache,
                                     const char *group, const char *tag,
                                     int64_t timestamp, neu_dvalue_t value,
                                     neu_tag_meta_t *metas, int n_meta,
                                     bool change)
 {
-    struct elem *elem = NULL;
-    tkey_t       key  = to_key(group, tag); //tag为nul,后续elem为null
+    struct elem *elem       = NULL;
+    tkey_t       key        = to_key(group, tag); //tag为nul,后续elem为null
+    neu_cvalue_t cvalue     = { 0 };
+    bool         suppressed = false;
+
+    // 转换为紧凑值在锁外完成
+    neu_cvalue_from_dvalue(&cvalue, &value);
+
+    // 缓存接管 NEU_TYPE_CUSTOM 的 json 引用和字符串数组的内存，
+    // 紧凑值已持有自己的副本，这里释放调用者交出的部分
+    if (value.type == NEU_TYPE_CUSTOM) {
+        json_decref(value.value.json);
+    } else if (value.type == NEU_TYPE_ARRAY_STRING) {
+        for (int i = 0; i < value.value.strs.length; i++) {
+            free(value.value.strs.strs[i]);
+        }
+    }
 
     // 锁定缓存以确保线程安全
     pthread_mutex_lock(&cache->mtx);
@@ -371,6 +614,9 @@ void neu_driver_cache_update_change(neu_driver_cache_t *cache,
     // 查找哈希表中是否存在对应键的元素
     HASH_FIND(hh, cache->table, &key, sizeof(tkey_t), elem);
     if (elem != NULL) {
+        uint8_t precision = elem->value.precision;
+        bool    changed   = false;
+
         elem->timestamp = timestamp;
 
         // 若启用错误过滤且新值类型为错误类型，则不报告变化
@@ -386,468 +632,36 @@ void neu_driver_cache_update_change(neu_driver_cache_t *cache,
          *      或者启用了错误过滤且元素的旧类型既不是错误类型也和新类型不同时，
          *      将 elem->changed 标记为 true，表示元素发生了变化。
          *  -2.旧类型为错误类型，新类型不同
-         *      当启用了错误过滤，元素的旧类型为错误类型且和新类型不同时，进入此分支。
-         *      根据新值的类型，使用 memcmp 或其他比较方法比较实际值是否发生变化，
-         *      如果变化则将 elem->changed 标记为 true。
+         *      当启用了错误过滤，元素的旧类型为错误类型且和新类型不同时，
+         *      与出错前的最后一个有效值（value_old）比较。
          *  -3.其他情况
-         *      在其他情况下，同样根据新值的类型，使用 memcmp 或其他比较方法比较实际值是否发生变化，
-         *      如果变化则将 elem->changed 标记为 true。 
+         *      与当前值比较；错误值总是视为变化。
+         *  配置了死区或心跳时，再按上次上报值过滤。
          */
-        if ((!sub_filter_err && elem->value.type != value.type) ||
-            (sub_filter_err && elem->value.type != value.type &&
+        if ((!sub_filter_err && elem->value.type != cvalue.type) ||
+            (sub_filter_err && elem->value.type != cvalue.type &&
              elem->value.type != NEU_TYPE_ERROR)) {
+            changed = true;
+        } else if (sub_filter_err && elem->value.type != cvalue.type &&
+                   elem->value.type == NEU_TYPE_ERROR) {
+            changed = value_changed(&elem->value_old, &cvalue);
+        } else if (cvalue.type == NEU_TYPE_ERROR ||
+                   value_changed(&elem->value, &cvalue)) {
+            changed = true;
+        }
+
+        if (neu_tag_deadband_enabled(&elem->deadband)) {
+            changed = deadband_filter(elem, &cvalue, changed, change,
+                                      timestamp, &suppressed);
+        }
+        if (changed) {
             elem->changed = true;
-        } else if (sub_filter_err && elem->value.type != value.type &&
-                   elem->value.type == NEU_TYPE_ERROR) { 
-            switch (value.type) {
-            case NEU_TYPE_INT8:
-            case NEU_TYPE_UINT8:
-            case NEU_TYPE_INT16:
-            case NEU_TYPE_UINT16:
-            case NEU_TYPE_INT32:
-            case NEU_TYPE_UINT32:
-            case NEU_TYPE_INT64:
-            case NEU_TYPE_UINT64:
-            case NEU_TYPE_BIT:
-            case NEU_TYPE_BOOL:
-            case NEU_TYPE_STRING:
-            case NEU_TYPE_TIME:
-            case NEU_TYPE_DATA_AND_TIME:
-            case NEU_TYPE_WORD:
-            case NEU_TYPE_DWORD:
-            case NEU_TYPE_LWORD:
-            case NEU_TYPE_ARRAY_CHAR:
-                if (memcmp(&elem->value_old.value, &value.value,
-                           sizeof(value.value)) != 0) {
-                    elem->changed = true;
-                }
-                break;
-            case NEU_TYPE_BYTES:
-                if (elem->value_old.value.bytes.length !=
-                    value.value.bytes.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value_old.value.bytes.bytes,
-                               value.value.bytes.bytes,
-                               value.value.bytes.length) != 0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_BOOL:
-                if (elem->value_old.value.bools.length !=
-                    value.value.bools.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value_old.value.bools.bools,
-                               value.value.bools.bools,
-                               value.value.bools.length) != 0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_INT8:
-                if (elem->value_old.value.i8s.length !=
-                    value.value.i8s.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value_old.value.i8s.i8s,
-                               value.value.i8s.i8s,
-                               value.value.i8s.length) != 0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_UINT8:
-                if (elem->value_old.value.u8s.length !=
-                    value.value.u8s.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value_old.value.u8s.u8s,
-                               value.value.u8s.u8s,
-                               value.value.u8s.length) != 0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_INT16:
-                if (elem->value_old.value.i16s.length !=
-                    value.value.i16s.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value_old.value.i16s.i16s,
-                               value.value.i16s.i16s,
-                               value.value.i16s.length * sizeof(int16_t)) !=
-                        0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_UINT16:
-                if (elem->value_old.value.u16s.length !=
-                    value.value.u16s.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value_old.value.u16s.u16s,
-                               value.value.u16s.u16s,
-                               value.value.u16s.length * sizeof(uint16_t)) !=
-                        0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_INT32:
-                if (elem->value_old.value.i32s.length !=
-                    value.value.i32s.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value_old.value.i32s.i32s,
-                               value.value.i32s.i32s,
-                               value.value.i32s.length * sizeof(int32_t)) !=
-                        0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_UINT32:
-                if (elem->value_old.value.u32s.length !=
-                    value.value.u32s.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value_old.value.u32s.u32s,
-                               value.value.u32s.u32s,
-                               value.value.u32s.length * sizeof(uint32_t)) !=
-                        0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_INT64:
-                if (elem->value_old.value.i64s.length !=
-                    value.value.i64s.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value_old.value.i64s.i64s,
-                               value.value.i64s.i64s,
-                               value.value.i64s.length * sizeof(int64_t)) !=
-                        0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_UINT64:
-                if (elem->value_old.value.u64s.length !=
-                    value.value.u64s.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value_old.value.u64s.u64s,
-                               value.value.u64s.u64s,
-                               value.value.u64s.length * sizeof(uint64_t)) !=
-                        0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_FLOAT:
-                if (elem->value_old.value.f32s.length !=
-                    value.value.f32s.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value_old.value.f32s.f32s,
-                               value.value.f32s.f32s,
-                               value.value.f32s.length * sizeof(float)) != 0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_DOUBLE:
-                if (elem->value_old.value.f64s.length !=
-                    value.value.f64s.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value_old.value.f64s.f64s,
-                               value.value.f64s.f64s,
-                               value.value.f64s.length * sizeof(double)) != 0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_STRING:
-                if (elem->value_old.value.strs.length !=
-                    value.value.strs.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value_old.value.strs.strs,
-                               value.value.strs.strs,
-                               value.value.strs.length * sizeof(char *)) != 0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_CUSTOM: {
-                if (json_equal(elem->value_old.value.json, value.value.json) !=
-                    0) {
-                    elem->changed = true;
-                }
-                break;
-            }
-            case NEU_TYPE_PTR: {
-                if (elem->value_old.value.ptr.length !=
-                    value.value.ptr.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value_old.value.ptr.ptr,
-                               value.value.ptr.ptr,
-                               value.value.ptr.length) != 0) {
-                        elem->changed = true;
-                    }
-                }
-
-                break;
-            }
-            case NEU_TYPE_FLOAT:
-                if (elem->value_old.precision == 0) {
-                    elem->changed =
-                        elem->value_old.value.f32 != value.value.f32;
-                } else {
-                    if (fabs(elem->value_old.value.f32 - value.value.f32) >
-                        pow(0.1, elem->value_old.precision)) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_DOUBLE:
-                if (elem->value_old.precision == 0) {
-                    elem->changed =
-                        elem->value_old.value.d64 != value.value.d64;
-                } else {
-                    if (fabs(elem->value_old.value.d64 - value.value.d64) >
-                        pow(0.1, elem->value_old.precision)) {
-                        elem->changed = true;
-                    }
-                }
-
-                break;
-            case NEU_TYPE_ERROR:
-                break;
-            }
-        } else {
-            switch (value.type) {
-            case NEU_TYPE_INT8:
-            case NEU_TYPE_UINT8:
-            case NEU_TYPE_INT16:
-            case NEU_TYPE_UINT16:
-            case NEU_TYPE_INT32:
-            case NEU_TYPE_UINT32:
-            case NEU_TYPE_INT64:
-            case NEU_TYPE_UINT64:
-            case NEU_TYPE_BIT:
-            case NEU_TYPE_BOOL:
-            case NEU_TYPE_STRING:
-            case NEU_TYPE_TIME:
-            case NEU_TYPE_DATA_AND_TIME:
-            case NEU_TYPE_WORD:
-            case NEU_TYPE_DWORD:
-            case NEU_TYPE_LWORD:
-            case NEU_TYPE_ARRAY_CHAR:
-                if (memcmp(&elem->value.value, &value.value,
-                           sizeof(value.value)) != 0) {
-                    elem->changed = true;
-                }
-                break;
-            case NEU_TYPE_BYTES:
-                if (elem->value.value.bytes.length !=
-                    value.value.bytes.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value.value.bytes.bytes,
-                               value.value.bytes.bytes,
-                               value.value.bytes.length) != 0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_BOOL:
-                if (elem->value.value.bools.length !=
-                    value.value.bools.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value.value.bools.bools,
-                               value.value.bools.bools,
-                               value.value.bools.length) != 0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_INT8:
-                if (elem->value.value.i8s.length != value.value.i8s.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value.value.i8s.i8s, value.value.i8s.i8s,
-                               value.value.i8s.length) != 0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_UINT8:
-                if (elem->value.value.u8s.length != value.value.u8s.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value.value.u8s.u8s, value.value.u8s.u8s,
-                               value.value.u8s.length) != 0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_INT16:
-                if (elem->value.value.i16s.length != value.value.i16s.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(
-                            elem->value.value.i16s.i16s, value.value.i16s.i16s,
-                            value.value.i16s.length * sizeof(int16_t)) != 0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_UINT16:
-                if (elem->value.value.u16s.length != value.value.u16s.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(
-                            elem->value.value.u16s.u16s, value.value.u16s.u16s,
-                            value.value.u16s.length * sizeof(uint16_t)) != 0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_INT32:
-                if (elem->value.value.i32s.length != value.value.i32s.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(
-                            elem->value.value.i32s.i32s, value.value.i32s.i32s,
-                            value.value.i32s.length * sizeof(int32_t)) != 0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_UINT32:
-                if (elem->value.value.u32s.length != value.value.u32s.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(
-                            elem->value.value.u32s.u32s, value.value.u32s.u32s,
-                            value.value.u32s.length * sizeof(uint32_t)) != 0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_INT64:
-                if (elem->value.value.i64s.length != value.value.i64s.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(
-                            elem->value.value.i64s.i64s, value.value.i64s.i64s,
-                            value.value.i64s.length * sizeof(int64_t)) != 0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_UINT64:
-                if (elem->value.value.u64s.length != value.value.u64s.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(
-                            elem->value.value.u64s.u64s, value.value.u64s.u64s,
-                            value.value.u64s.length * sizeof(uint64_t)) != 0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_FLOAT:
-                if (elem->value.value.f32s.length != value.value.f32s.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value.value.f32s.f32s,
-                               value.value.f32s.f32s,
-                               value.value.f32s.length * sizeof(float)) != 0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_DOUBLE:
-                if (elem->value.value.f64s.length != value.value.f64s.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value.value.f64s.f64s,
-                               value.value.f64s.f64s,
-                               value.value.f64s.length * sizeof(double)) != 0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_ARRAY_STRING:
-                if (elem->value.value.strs.length != value.value.strs.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value.value.strs.strs,
-                               value.value.strs.strs,
-                               value.value.strs.length * sizeof(char *)) != 0) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_PTR: {
-                if (elem->value.value.ptr.length != value.value.ptr.length) {
-                    elem->changed = true;
-                } else {
-                    if (memcmp(elem->value.value.ptr.ptr, value.value.ptr.ptr,
-                               value.value.ptr.length) != 0) {
-                        elem->changed = true;
-                    }
-                }
-
-                break;
-            }
-            case NEU_TYPE_CUSTOM: {
-                if (json_equal(elem->value.value.json, value.value.json) != 0) {
-                    elem->changed = true;
-                }
-                break;
-            }
-            case NEU_TYPE_FLOAT:
-                if (elem->value.precision == 0) {
-                    elem->changed = elem->value.value.f32 != value.value.f32;
-                } else {
-                    if (fabs(elem->value.value.f32 - value.value.f32) >
-                        pow(0.1, elem->value.precision)) {
-                        elem->changed = true;
-                    }
-                }
-                break;
-            case NEU_TYPE_DOUBLE:
-                if (elem->value.precision == 0) {
-                    elem->changed = elem->value.value.d64 != value.value.d64;
-                } else {
-                    if (fabs(elem->value.value.d64 - value.value.d64) >
-                        pow(0.1, elem->value.precision)) {
-                        elem->changed = true;
-                    }
-                }
-
-                break;
-            case NEU_TYPE_ERROR:
-                elem->changed = true;
-                break;
-            }
         }
 
         //更新旧值
         if (sub_filter_err && value.type != NEU_TYPE_ERROR) {
-            elem->value_old.type      = value.type;
-            elem->value_old.value     = value.value;
-            elem->value_old.precision = value.precision;
+            neu_cvalue_release(&elem->value_old);
+            neu_cvalue_copy(&elem->value_old, &cvalue);
         }
 
     error_not_report:
@@ -856,87 +670,33 @@ void neu_driver_cache_update_change(neu_driver_cache_t *cache,
         if (change) {
             elem->changed = true;
         }
-        
-        //根据新值类型进行相应的内存管理和数据更新
-
-        // 根据新值的类型进行不同的处理
-        if (value.type == NEU_TYPE_PTR) {
-            elem->value.value.ptr.length = value.value.ptr.length;
-            elem->value.value.ptr.type   = value.value.ptr.type;
-            if (elem->value.value.ptr.ptr != NULL) {
-                // 释放旧指针指向的内存
-                free(elem->value.value.ptr.ptr);
-            }
-            elem->value.value.ptr.ptr = calloc(1, value.value.ptr.length);
-            memcpy(elem->value.value.ptr.ptr, value.value.ptr.ptr,
-                   value.value.ptr.length);
-        } else if (value.type == NEU_TYPE_CUSTOM) {
-            if (elem->value.type == NEU_TYPE_CUSTOM) {
-                if (elem->value.value.json != NULL) {
-                    // 减少旧JSON对象的引用计数
-                    json_decref(elem->value.value.json);
-
-                    // 将旧JSON对象指针置空
-                    elem->value.value.json = NULL;
-                }
-            }
-
-            // 更新为新的JSON对象
-            elem->value.value.json = value.value.json;
 
-        } else if (value.type == NEU_TYPE_ARRAY_STRING) {
-            if (elem->value.type == NEU_TYPE_ARRAY_STRING) {
-                for (int i = 0; i < elem->value.value.strs.length; i++) {
-                    free(elem->value.value.strs.strs[i]);
-                    elem->value.value.strs.strs[i] = NULL;
-                }
+        // 替换当前值，外部存储的所有权转移给缓存，精度保持 add 时的设置
+        neu_cvalue_release(&elem->value);
+        elem->value           = cvalue;
+        elem->value.precision = precision;
+        cvalue.flags          = 0;
+
+        if (n_meta != elem->n_meta) {
+            elem_free_metas(elem);
+            if (n_meta > 0) {
+                elem->metas  = calloc(n_meta, sizeof(struct cache_meta));
+                elem->n_meta = n_meta;
             }
-            elem->value.value.strs.length = value.value.strs.length;
-            for (int i = 0; i < value.value.strs.length; i++) {
-                elem->value.value.strs.strs[i] = value.value.strs.strs[i];
-            }
-
-        } else if (value.type == NEU_TYPE_ERROR) {
-            //处理自定义类型
-            if (elem->value.type == NEU_TYPE_CUSTOM) {
-                //该自定义类型的值所包含的 JSON 对象指针不为空。
-                if (elem->value.value.json != NULL) {
-                    //减少 JSON 对象的引用计数,当引用计数降为 0 时，JSON 对象可能会被释放。
-                    json_decref(elem->value.value.json);
-                    elem->value.value.json = NULL;
-                }
-            }
-
-            if (elem->value.type == NEU_TYPE_PTR) {
-                if (elem->value.value.ptr.ptr != NULL) {
-                    free(elem->value.value.ptr.ptr);
-                    elem->value.value.ptr.ptr = NULL;
-                }
-            }
-
-            //处理字符串数组类型
-            if (elem->value.type == NEU_TYPE_ARRAY_STRING) {
-                for (int i = 0; i < elem->value.value.strs.length; i++) {
-                    //释放每个字符串所占用的内存
-                    free(elem->value.value.strs.strs[i]);
-                    //将释放后的指针置为 NULL，避免悬空指针。
-                    elem->value.value.strs.strs[i] = NULL;
-                }
-            }
-            //将 elem 的值更新为新的错误值 value,反映当前出现错误的状态。
-            elem->value.value = value.value;
-        } else {
-            elem->value.value = value.value;
         }
-        elem->value.type = value.type;
-
-        memset(elem->metas, 0, sizeof(neu_tag_meta_t) * NEU_TAG_META_SIZE);
-        for (int i = 0; i < n_meta; i++) {
-            memcpy(&elem->metas[i], &metas[i], sizeof(neu_tag_meta_t));
+        for (int i = 0; i < elem->n_meta; i++) {
+            neu_cvalue_release(&elem->metas[i].value);
+            strcpy(elem->metas[i].name, metas[i].name);
+            neu_cvalue_from_dvalue(&elem->metas[i].value, &metas[i].value);
         }
     }
 
     pthread_mutex_unlock(&cache->mtx);
+
+    // 未找到元素时释放转换出的紧凑值
+    neu_cvalue_release(&cvalue);
+
+    return suppressed;
 }
 
 /**
@@ -952,14 +712,15 @@ void neu_driver_cache_update_change(neu_driver_cache_t *cache,
  * @param value 包含新值及类型的 neu_dvalue_t 结构体。
  * @param metas 元数据数组，包含与该值相关的元数据信息。
  * @param n_meta 元数据的数量。
+ * @return 值发生变化但被死区过滤时返回 true。
  */
-void neu_driver_cache_update(neu_driver_cache_t *cache, const char *group,
+bool neu_driver_cache_update(neu_driver_cache_t *cache, const char *group,
                              const char *tag, int64_t timestamp,
                              neu_dvalue_t value, neu_tag_meta_t *metas,
                              int n_meta)
 {
-    neu_driver_cache_update_change(cache, group, tag, timestamp, value, metas,
-                                   n_meta, false);
+    return neu_driver_cache_update_change(cache, group, tag, timestamp, value,
+                                          metas, n_meta, false);
 }
 
 /**
@@ -990,140 +751,7 @@ int neu_driver_cache_meta_get(neu_driver_cache_t *cache, const char *group,
     HASH_FIND(hh, cache->table, &key, sizeof(tkey_t), elem);
 
     if (elem != NULL) { // 如果找到了元素
-        // 更新时间戳和值类型及精度
-        value->timestamp       = elem->timestamp;
-        value->value.type      = elem->value.type;
-        value->value.precision = elem->value.precision;
-
-        // 确保元数据数组足够大
-        assert(n_meta <= NEU_TAG_META_SIZE);
-        memcpy(metas, elem->metas, sizeof(neu_tag_meta_t) * NEU_TAG_META_SIZE);
-
-        // 根据值类型处理不同的值
-        switch (elem->value.type) {
-        case NEU_TYPE_INT8:
-        case NEU_TYPE_UINT8:
-        case NEU_TYPE_BIT:
-            value->value.value.u8 = elem->value.value.u8;
-            break;
-        case NEU_TYPE_INT16:
-        case NEU_TYPE_UINT16:
-        case NEU_TYPE_WORD:
-            value->value.value.u16 = elem->value.value.u16;
-            break;
-        case NEU_TYPE_INT32:
-        case NEU_TYPE_UINT32:
-        case NEU_TYPE_DWORD:
-        case NEU_TYPE_FLOAT:
-        case NEU_TYPE_ERROR:
-            value->value.value.u32 = elem->value.value.u32;
-            break;
-        case NEU_TYPE_INT64:
-        case NEU_TYPE_UINT64:
-        case NEU_TYPE_DOUBLE:
-        case NEU_TYPE_LWORD:
-            value->value.value.u64 = elem->value.value.u64;
-            break;
-        case NEU_TYPE_BOOL:
-            value->value.value.boolean = elem->value.value.boolean;
-            break;
-        case NEU_TYPE_STRING:
-        case NEU_TYPE_TIME:
-        case NEU_TYPE_DATA_AND_TIME:
-        case NEU_TYPE_ARRAY_CHAR:
-            memcpy(value->value.value.str, elem->value.value.str,
-                   sizeof(elem->value.value.str));
-            break;
-        case NEU_TYPE_BYTES:
-            value->value.value.bytes.length = elem->value.value.bytes.length;
-            memcpy(value->value.value.bytes.bytes,
-                   elem->value.value.bytes.bytes,
-                   elem->value.value.bytes.length);
-            break;
-        case NEU_TYPE_ARRAY_BOOL:
-            value->value.value.bools.length = elem->value.value.bools.length;
-            memcpy(value->value.value.bools.bools,
-                   elem->value.value.bools.bools,
-                   elem->value.value.bools.length);
-            break;
-        case NEU_TYPE_ARRAY_INT8:
-            value->value.value.i8s.length = elem->value.value.i8s.length;
-            memcpy(value->value.value.i8s.i8s, elem->value.value.i8s.i8s,
-                   elem->value.value.i8s.length);
-            break;
-        case NEU_TYPE_ARRAY_UINT8:
-            value->value.value.u8s.length = elem->value.value.u8s.length;
-            memcpy(value->value.value.u8s.u8s, elem->value.value.u8s.u8s,
-                   elem->value.value.u8s.length);
-            break;
-        case NEU_TYPE_ARRAY_INT16:
-            value->value.value.i16s.length = elem->value.value.i16s.length;
-            memcpy(value->value.value.i16s.i16s, elem->value.value.i16s.i16s,
-                   elem->value.value.i16s.length * sizeof(int16_t));
-            break;
-        case NEU_TYPE_ARRAY_UINT16:
-            value->value.value.u16s.length = elem->value.value.u16s.length;
-            memcpy(value->value.value.u16s.u16s, elem->value.value.u16s.u16s,
-                   elem->value.value.u16s.length * sizeof(uint16_t));
-            break;
-        case NEU_TYPE_ARRAY_INT32:
-            value->value.value.i32s.length = elem->value.value.i32s.length;
-            memcpy(value->value.value.i32s.i32s, elem->value.value.i32s.i32s,
-                   elem->value.value.i32s.length * sizeof(int32_t));
-            break;
-        case NEU_TYPE_ARRAY_UINT32:
-            value->value.value.u32s.length = elem->value.value.u32s.length;
-            memcpy(value->value.value.u32s.u32s, elem->value.value.u32s.u32s,
-                   elem->value.value.u32s.length * sizeof(uint32_t));
-            break;
-        case NEU_TYPE_ARRAY_INT64:
-            value->value.value.i64s.length = elem->value.value.i64s.length;
-            memcpy(value->value.value.i64s.i64s, elem->value.value.i64s.i64s,
-                   elem->value.value.i64s.length * sizeof(int64_t));
-            break;
-        case NEU_TYPE_ARRAY_UINT64:
-            value->value.value.u64s.length = elem->value.value.u64s.length;
-            memcpy(value->value.value.u64s.u64s, elem->value.value.u64s.u64s,
-                   elem->value.value.u64s.length * sizeof(uint64_t));
-            break;
-        case NEU_TYPE_ARRAY_FLOAT:
-            value->value.value.f32s.length = elem->value.value.f32s.length;
-            memcpy(value->value.value.f32s.f32s, elem->value.value.f32s.f32s,
-                   elem->value.value.f32s.length * sizeof(float));
-            break;
-        case NEU_TYPE_ARRAY_DOUBLE:
-            value->value.value.f64s.length = elem->value.value.f64s.length;
-            memcpy(value->value.value.f64s.f64s, elem->value.value.f64s.f64s,
-                   elem->value.value.f64s.length * sizeof(double));
-            break;
-        case NEU_TYPE_ARRAY_STRING:
-            value->value.value.strs.length = elem->value.value.strs.length;
-            for (int i = 0; i < elem->value.value.strs.length; i++) {
-                value->value.value.strs.strs[i] =
-                    strdup(elem->value.value.strs.strs[i]);
-            }
-            break;
-        case NEU_TYPE_PTR:
-            value->value.value.ptr.length = elem->value.value.ptr.length;
-            value->value.value.ptr.type   = elem->value.value.ptr.type;
-            value->value.value.ptr.ptr =
-                calloc(1, elem->value.value.ptr.length);
-            memcpy(value->value.value.ptr.ptr, elem->value.value.ptr.ptr,
-                   elem->value.value.ptr.length);
-            break;
-        case NEU_TYPE_CUSTOM:
-            value->value.value.json = json_deep_copy(elem->value.value.json);
-            break;
-        }
-
-        // 复制元数据
-        for (int i = 0; i < NEU_TAG_META_SIZE; i++) {
-            if (strlen(elem->metas[i].name) > 0) {
-                memcpy(&value->metas[i], &elem->metas[i],
-                       sizeof(neu_tag_meta_t));
-            }
-        }
-
+        elem_read(elem, value, metas, n_meta);
         ret = 0;
     }
 
@@ -1164,138 +792,8 @@ int neu_driver_cache_meta_get_changed(neu_driver_cache_t *cache,
     // 查找哈希表中的元素
     HASH_FIND(hh, cache->table, &key, sizeof(tkey_t), elem);
 
-    if (elem != NULL && elem->changed) {                 // 如果找到元素且已更改
-        value->timestamp       = elem->timestamp;        // 更新时间戳
-        value->value.type      = elem->value.type;       // 更新类型
-        value->value.precision = elem->value.precision;  // 更新精度
-
-        // 确保元数据数组足够大
-        assert(n_meta <= NEU_TAG_META_SIZE);
-        memcpy(metas, elem->metas, sizeof(neu_tag_meta_t) * NEU_TAG_META_SIZE);
-
-        // 根据类型处理不同的值
-        switch (elem->value.type) {
-        case NEU_TYPE_INT8:
-        case NEU_TYPE_UINT8:
-        case NEU_TYPE_BIT:
-            value->value.value.u8 = elem->value.value.u8;
-            break;
-        case NEU_TYPE_INT16:
-        case NEU_TYPE_UINT16:
-        case NEU_TYPE_WORD:
-            value->value.value.u16 = elem->value.value.u16;
-            break;
-        case NEU_TYPE_INT32:
-        case NEU_TYPE_UINT32:
-        case NEU_TYPE_FLOAT:
-        case NEU_TYPE_ERROR:
-        case NEU_TYPE_DWORD:
-            value->value.value.u32 = elem->value.value.u32;
-            break;
-        case NEU_TYPE_INT64:
-        case NEU_TYPE_UINT64:
-        case NEU_TYPE_DOUBLE:
-        case NEU_TYPE_LWORD:
-            value->value.value.u64 = elem->value.value.u64;
-            break;
-        case NEU_TYPE_BOOL:
-            value->value.value.boolean = elem->value.value.boolean;
-            break;
-        case NEU_TYPE_STRING:
-        case NEU_TYPE_TIME:
-        case NEU_TYPE_DATA_AND_TIME:
-        case NEU_TYPE_ARRAY_CHAR:
-            memcpy(value->value.value.str, elem->value.value.str,
-                   sizeof(elem->value.value.str));
-            break;
-        case NEU_TYPE_BYTES:
-            value->value.value.bytes.length = elem->value.value.bytes.length;
-            memcpy(value->value.value.bytes.bytes,
-                   elem->value.value.bytes.bytes,
-                   elem->value.value.bytes.length);
-            break;
-        case NEU_TYPE_ARRAY_BOOL:
-            value->value.value.bools.length = elem->value.value.bools.length;
-            memcpy(value->value.value.bools.bools,
-                   elem->value.value.bools.bools,
-                   elem->value.value.bools.length);
-            break;
-        case NEU_TYPE_ARRAY_INT8:
-            value->value.value.i8s.length = elem->value.value.i8s.length;
-            memcpy(value->value.value.i8s.i8s, elem->value.value.i8s.i8s,
-                   elem->value.value.i8s.length);
-            break;
-        case NEU_TYPE_ARRAY_UINT8:
-            value->value.value.u8s.length = elem->value.value.u8s.length;
-            memcpy(value->value.value.u8s.u8s, elem->value.value.u8s.u8s,
-                   elem->value.value.u8s.length);
-            break;
-        case NEU_TYPE_ARRAY_INT16:
-            value->value.value.i16s.length = elem->value.value.i16s.length;
-            memcpy(value->value.value.i16s.i16s, elem->value.value.i16s.i16s,
-                   elem->value.value.i16s.length * sizeof(int16_t));
-            break;
-        case NEU_TYPE_ARRAY_UINT16:
-            value->value.value.u16s.length = elem->value.value.u16s.length;
-            memcpy(value->value.value.u16s.u16s, elem->value.value.u16s.u16s,
-                   elem->value.value.u16s.length * sizeof(uint16_t));
-            break;
-        case NEU_TYPE_ARRAY_INT32:
-            value->value.value.i32s.length = elem->value.value.i32s.length;
-            memcpy(value->value.value.i32s.i32s, elem->value.value.i32s.i32s,
-                   elem->value.value.i32s.length * sizeof(int32_t));
-            break;
-        case NEU_TYPE_ARRAY_UINT32:
-            value->value.value.u32s.length = elem->value.value.u32s.length;
-            memcpy(value->value.value.u32s.u32s, elem->value.value.u32s.u32s,
-                   elem->value.value.u32s.length * sizeof(uint32_t));
-            break;
-        case NEU_TYPE_ARRAY_INT64:
-            value->value.value.i64s.length = elem->value.value.i64s.length;
-            memcpy(value->value.value.i64s.i64s, elem->value.value.i64s.i64s,
-                   elem->value.value.i64s.length * sizeof(int64_t));
-            break;
-        case NEU_TYPE_ARRAY_UINT64:
-            value->value.value.u64s.length = elem->value.value.u64s.length;
-            memcpy(value->value.value.u64s.u64s, elem->value.value.u64s.u64s,
-                   elem->value.value.u64s.length * sizeof(uint64_t));
-            break;
-        case NEU_TYPE_ARRAY_FLOAT:
-            value->value.value.f32s.length = elem->value.value.f32s.length;
-            memcpy(value->value.value.f32s.f32s, elem->value.value.f32s.f32s,
-                   elem->value.value.f32s.length * sizeof(float));
-            break;
-        case NEU_TYPE_ARRAY_DOUBLE:
-            value->value.value.f64s.length = elem->value.value.f64s.length;
-            memcpy(value->value.value.f64s.f64s, elem->value.value.f64s.f64s,
-                   elem->value.value.f64s.length * sizeof(double));
-            break;
-        case NEU_TYPE_ARRAY_STRING:
-            value->value.value.strs.length = elem->value.value.strs.length;
-            for (int i = 0; i < elem->value.value.strs.length; i++) {
-                value->value.value.strs.strs[i] =
-                    strdup(elem->value.value.strs.strs[i]);
-            }
-            break;
-        case NEU_TYPE_PTR:
-            value->value.value.ptr.length = elem->value.value.ptr.length;
-            value->value.value.ptr.type   = elem->value.value.ptr.type;
-            value->value.value.ptr.ptr =
-                calloc(1, elem->value.value.ptr.length);
-            memcpy(value->value.value.ptr.ptr, elem->value.value.ptr.ptr,
-                   elem->value.value.ptr.length);
-            break;
-        case NEU_TYPE_CUSTOM:
-            value->value.value.json = json_deep_copy(elem->value.value.json);
-            break;
-        }
-
-        for (int i = 0; i < NEU_TAG_META_SIZE; i++) {
-            if (strlen(elem->metas[i].name) > 0) {
-                memcpy(&value->metas[i], &elem->metas[i],
-                       sizeof(neu_tag_meta_t));
-            }
-        }
+    if (elem != NULL && elem->changed) { // 如果找到元素且已更改
+        elem_read(elem, value, metas, n_meta);
 
         // 如果不是错误类型，重置changed标志
         if (elem->value.type != NEU_TYPE_ERROR) {
@@ -1337,26 +835,8 @@ void neu_driver_cache_del(neu_driver_cache_t *cache, const char *group,
         // 将元素从哈希表中删除
         HASH_DEL(cache->table, elem);
 
-        // 根据元素的值类型，释放其占用的内存
-        if (elem->value.type == NEU_TYPE_PTR) {
-            if (elem->value.value.ptr.ptr != NULL) {
-                free(elem->value.value.ptr.ptr);
-                elem->value.value.ptr.ptr = NULL;
-            }
-        } else if (elem->value.type == NEU_TYPE_CUSTOM) {
-            if (elem->value.value.json != NULL) {
-                json_decref(elem->value.value.json);
-                elem->value.value.json = NULL;
-            }
-        } else if (elem->value.type == NEU_TYPE_ARRAY_STRING) {
-            for (int i = 0; i < elem->value.value.strs.length; i++) {
-                free(elem->value.value.strs.strs[i]);
-                elem->value.value.strs.strs[i] = NULL;
-            }
-        }
-        
-        // 释放元素本身的内存
-        free(elem);
+        // 释放元素及其值占用的内存
+        elem_free(elem);
     }
 
     pthread_mutex_unlock(&cache->mtx);
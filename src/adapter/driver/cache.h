@@ -22,6 +22,7 @@
 
 #include <stdint.h>
 
+#include "tag.h"
 #include "type.h"
 
 typedef struct neu_driver_cache neu_driver_cache_t;
@@ -31,11 +32,19 @@ void                neu_driver_cache_destroy(neu_driver_cache_t *cache);
 
 void neu_driver_cache_add(neu_driver_cache_t *cache, const char *group,
                           const char *tag, neu_dvalue_t value);
-void neu_driver_cache_update(neu_driver_cache_t *cache, const char *group,
+void neu_driver_cache_set_deadband(neu_driver_cache_t *cache, const char *group,
+                                   const char *                  tag,
+                                   const neu_datatag_deadband_t *deadband,
+                                   double decimal, double bias);
+
+/**
+ * @brief 更新标签值，值发生变化但被死区过滤时返回 true。
+ */
+bool neu_driver_cache_update(neu_driver_cache_t *cache, const char *group,
                              const char *tag, int64_t timestamp,
                              neu_dvalue_t value, neu_tag_meta_t *metas,
                              int n_meta);
-void neu_driver_cache_update_change(neu_driver_cache_t *cache,
+bool neu_driver_cache_update_change(neu_driver_cache_t *cache,
                                     const char *group, const char *tag,
                                     int64_t timestamp, neu_dvalue_t value,
                                     neu_tag_meta_t *metas, int n_meta,
@@ -52,7 +61,7 @@ void *neu_driver_cache_get_trace(neu_driver_cache_t *cache, const char *group);
 /**
  * @brief 缓存值结构体，用于存储标签值的相关信息。
  *
- * 此结构体包含了缓存中的数据值、获取或更新该值的时间戳以及与该值相关的元数据数组。
+ * 此结构体包含了缓存中的数据值以及获取或更新该值的时间戳，元数据由调用者单独传入的数组返回。
  * 它被广泛应用于处理不同类型的数值及其相关的附加信息（如精度、单位等）。
  * 
  * @note
@@ -77,14 +86,6 @@ typedef struct {
      * 用于判断数据的新鲜度或是否过期。
      */
     int64_t        timestamp;
-
-    /**
-     * @brief 元数据数组。
-     *
-     * 存储与该值相关的元数据。元数据可以包括精度、单位述等信息，
-     * 有助于更全面地理解和使用该值。NEU_TAG_META_SIZE 定义了该数组的最大长度。
-     */
-    neu_tag_meta_t metas[NEU_TAG_META_SIZE];
 } neu_driver_cache_value_t;
 
 int neu_driver_cache_meta_get(neu_driver_cache_t *cache, const char *group,
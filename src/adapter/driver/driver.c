@@ -205,6 +205,15 @@ struct neu_adapter_driver {
      * 存储了该驱动适配器管理的所有组的信息，每个组可能包含多个标签。
      */
     struct group       *groups;
+
+    /**
+     * @brief 点位读取计数的度量项句柄。
+     *
+     * 每个点位更新都会累加，初始化时解析一次，节点不可见时为 NULL。
+     */
+    neu_metric_handle_t *tag_reads_metric;
+    neu_metric_handle_t *tag_read_errors_metric;
+    neu_metric_handle_t *tag_suppressed_metric;
 };
 
 static void report_to_app(neu_adapter_driver_t *driver, group_t *group,
@@ -308,13 +317,43 @@ static void format_tag_value(neu_dvalue_t *value)
     value->value.d64 *= negative;
 }
 
+/**
+ * @brief 在写请求中查找第 index 个点位所属的组。
+ *
+ * 插件只拿到点位本身，不知道点位属于哪个组，由请求补全。驱动按请求中组与点位
+ * 的顺序展开点位交给插件，插件按同样的顺序返回结果；点位名只在组内唯一，
+ * 因此按位置而不是按名字对应，名字对不上时不填写。
+ */
+static const char *write_tag_group(neu_reqresp_head_t *req, int index,
+                                   const char *tag)
+{
+    if (NEU_REQ_WRITE_TAGS == req->type) {
+        return ((neu_req_write_tags_t *) &req[1])->group;
+    }
+
+    if (NEU_REQ_WRITE_GTAGS == req->type) {
+        neu_req_write_gtags_t *cmd = (neu_req_write_gtags_t *) &req[1];
+
+        for (int i = 0; i < cmd->n_group; i++) {
+            if (index < cmd->groups[i].n_tag) {
+                if (strcmp(cmd->groups[i].tags[index].tag, tag) == 0) {
+                    return cmd->groups[i].group;
+                }
+                break;
+            }
+            index -= cmd->groups[i].n_tag;
+        }
+    }
+
+    return "";
+}
+
 static void write_responses(neu_adapter_t *adapter, void *r,
                             neu_driver_write_responses_t *response,
                             int                           n_response)
 {
     neu_reqresp_head_t *  req   = (neu_reqresp_head_t *) r;
     neu_resp_write_tags_t nresp = { 0 };
-    req->type                   = NEU_RESP_WRITE_TAGS;
     UT_icd    icd   = { sizeof(neu_resp_write_tags_ele_t), NULL, NULL, NULL };
     UT_array *array = NULL;
 
@@ -324,12 +363,25 @@ static void write_responses(neu_adapter_t *adapter, void *r,
         neu_driver_write_responses_t *resp = &response[i];
         neu_resp_write_tags_ele_t     ele  = { 0 };
 
-        strcpy(ele.group, resp->group);
+        if (resp->group[0] == '\0') {
+            strncpy(ele.group, write_tag_group(req, i, resp->name),
+                    sizeof(ele.group) - 1);
+        } else {
+            strcpy(ele.group, resp->group);
+        }
         strcpy(ele.tag, resp->name);
         ele.error = resp->error;
         utarray_push_back(array, &ele);
     }
 
+    // 与 write_response 一样释放请求内容，响应复用请求头
+    if (NEU_REQ_WRITE_TAGS == req->type) {
+        neu_req_write_tags_fini((neu_req_write_tags_t *) &req[1]);
+    } else if (NEU_REQ_WRITE_GTAGS == req->type) {
+        neu_req_write_gtags_fini((neu_req_write_gtags_t *) &req[1]);
+    }
+    req->type = NEU_RESP_WRITE_TAGS;
+
     nresp.tags = array;
     adapter->cb_funs.response(adapter, req, &nresp);
 }
@@ -570,12 +622,15 @@ static void update_with_meta(neu_adapter_t *adapter, const char *group,
     neu_adapter_update_metric_cb_t update_metric =
         driver->adapter.cb_funs.update_metric;
 
+    // 标签时间戳取精确时钟，同一次更新内的所有标签共用一个时间戳
+    int64_t timestamp = neu_time_ms();
+
     // 如果值的类型是错误类型，更新错误码和时间戳指标
     if (value.type == NEU_TYPE_ERROR) {
         update_metric(&driver->adapter, NEU_METRIC_GROUP_LAST_ERROR_CODE,
                       value.value.i32, group);
         update_metric(&driver->adapter, NEU_METRIC_GROUP_LAST_ERROR_TS,
-                      global_timestamp, group);
+                      timestamp, group);
     }
 
     // 如果值的类型是错误且标签为空，则遍历组中的所有属性符合的标签进行错误处理
@@ -590,22 +645,23 @@ static void update_with_meta(neu_adapter_t *adapter, const char *group,
             utarray_foreach(tags, neu_datatag_t *, t)
             {
                 neu_driver_cache_update(driver->cache, group, t->name,
-                                        global_timestamp, value, NULL, 0);
+                                        timestamp, value, NULL, 0);
                 ++err_count;
             }
 
             // 更新读取总数和错误总数指标
-            update_metric(&driver->adapter, NEU_METRIC_TAG_READS_TOTAL,
-                          err_count, NULL);
-            update_metric(&driver->adapter, NEU_METRIC_TAG_READ_ERRORS_TOTAL,
-                          err_count, NULL);
+            neu_metric_handle_update(driver->tag_reads_metric, err_count);
+            neu_metric_handle_update(driver->tag_read_errors_metric,
+                                     err_count);
             
             utarray_free(tags);
         }
     } else {
-        // 对于正常值或者有特定标签的错误值，更新缓存
-        neu_driver_cache_update(driver->cache, group, tag, global_timestamp,
-                                value, metas, n_meta);
+        // 对于正常值或者有特定标签的错误值，更新缓存，被死区过滤的变化单独计数
+        if (neu_driver_cache_update(driver->cache, group, tag, timestamp,
+                                    value, metas, n_meta)) {
+            neu_metric_handle_update(driver->tag_suppressed_metric, 1);
+        }
         
         /**
          * @bug
@@ -614,17 +670,18 @@ static void update_with_meta(neu_adapter_t *adapter, const char *group,
          */
 
         // 更新读取总数指标
-        update_metric(&driver->adapter, NEU_METRIC_TAG_READS_TOTAL, 1, NULL);
+        neu_metric_handle_update(driver->tag_reads_metric, 1);
 
         // 如果值的类型是错误，更新错误总数指标
-        update_metric(&driver->adapter, NEU_METRIC_TAG_READ_ERRORS_TOTAL,
-                      NEU_TYPE_ERROR == value.type, NULL);
+        if (NEU_TYPE_ERROR == value.type) {
+            neu_metric_handle_update(driver->tag_read_errors_metric, 1);
+        }
     }
     nlog_debug(
         "update driver: %s, group: %s, tag: %s, type: %s, timestamp: %" PRId64
         " n_meta: %d",
         driver->adapter.name, group, tag, neu_type_string(value.type),
-        global_timestamp, n_meta);
+        timestamp, n_meta);
 }
 
 /**
@@ -675,7 +732,8 @@ static void update_im(neu_adapter_t *adapter, const char *group,
                       const char *tag, neu_dvalue_t value,
                       neu_tag_meta_t *metas, int n_meta)
 {
-    neu_adapter_driver_t *driver = (neu_adapter_driver_t *) adapter;
+    neu_adapter_driver_t *driver    = (neu_adapter_driver_t *) adapter;
+    int64_t               timestamp = neu_time_ms();
 
     if (tag == NULL) {
         nlog_warn("update_im tag is null");
@@ -683,8 +741,8 @@ static void update_im(neu_adapter_t *adapter, const char *group,
     }
 
     // 更新驱动缓存中的更改
-    neu_driver_cache_update_change(driver->cache, group, tag, global_timestamp,
-                                   value, metas, n_meta, true);
+    neu_driver_cache_update_change(driver->cache, group, tag, timestamp, value,
+                                   metas, n_meta, true);
     
     // 调用回调函数更新度量
     driver->adapter.cb_funs.update_metric(&driver->adapter,
@@ -711,7 +769,7 @@ static void update_im(neu_adapter_t *adapter, const char *group,
                    "group: %s, tag: %s, type: %s, "
                    "timestamp: %" PRId64,
                    driver->adapter.name, group, tag,
-                   neu_type_string(value.type), global_timestamp);
+                   neu_type_string(value.type), timestamp);
         return;
     }
 
@@ -719,7 +777,7 @@ static void update_im(neu_adapter_t *adapter, const char *group,
                "group: %s, tag: %s, type: %s, "
                "timestamp: %" PRId64,
                driver->adapter.name, group, tag, neu_type_string(value.type),
-               global_timestamp);
+               timestamp);
 
     // 初始化响应头和数据结构
     neu_reqresp_head_t header = {
@@ -733,7 +791,7 @@ static void update_im(neu_adapter_t *adapter, const char *group,
     utarray_new(data->tags, neu_resp_tag_value_meta_icd());
 
     // 读取并报告组数据
-    read_report_group(global_timestamp, 0,
+    read_report_group(timestamp, 0,
                       neu_adapter_get_tag_cache_type(&driver->adapter),
                       driver->cache, group, tags, data->tags);
 
@@ -864,17 +922,19 @@ static void test_read_tag_response(neu_adapter_t *adapter, void *r,
  * 该函数分配内存并初始化一个新的 `neu_adapter_driver_t` 实例，包括设置缓存、事件处理机制以及回调函数等。
  * 它主要用于创建驱动类型的适配器，这些适配器通常用于与硬件设备进行交互。
  *
+ * @param dedicated_events 组采集定时器是否使用独占的事件循环，否则取用共享事件循环。
  * @return 成功时返回指向新创建的驱动适配器的指针；失败时返回 `NULL`。
  */
-neu_adapter_driver_t *neu_adapter_driver_create()
+neu_adapter_driver_t *neu_adapter_driver_create(bool dedicated_events)
 {
     neu_adapter_driver_t *driver = calloc(1, sizeof(neu_adapter_driver_t));
 
     // 初始化驱动适配器的缓存
     driver->cache                                      = neu_driver_cache_new();
 
-    // 创建新的事件对象，用于驱动适配器的事件处理
-    driver->driver_events                              = neu_event_new();
+    // 组采集定时器的事件循环：插件有阻塞 I/O 时独占，否则取自共享事件循环池
+    driver->driver_events =
+        dedicated_events ? neu_event_new() : neu_event_pool_get();
 
     // 设置驱动适配器的北向回调函数集
     driver->adapter.cb_funs.driver.update              = update;
@@ -911,7 +971,15 @@ void neu_adapter_driver_destroy(neu_adapter_driver_t *driver)
  */
 int neu_adapter_driver_init(neu_adapter_driver_t *driver)
 {
-    (void) driver;
+    neu_adapter_metric_handle_cb_t metric_handle =
+        driver->adapter.cb_funs.metric_handle;
+
+    driver->tag_reads_metric =
+        metric_handle(&driver->adapter, NEU_METRIC_TAG_READS_TOTAL, NULL);
+    driver->tag_read_errors_metric = metric_handle(
+        &driver->adapter, NEU_METRIC_TAG_READ_ERRORS_TOTAL, NULL);
+    driver->tag_suppressed_metric = metric_handle(
+        &driver->adapter, NEU_METRIC_TAG_SUPPRESSED_TOTAL, NULL);
 
     return 0;
 }
@@ -1110,7 +1178,7 @@ void neu_adapter_driver_read_group(neu_adapter_driver_t *driver,
             driver->adapter.module->intf_funs->driver.group_sync(
                 driver->adapter.plugin, &g->grp);
             // fetch updated data from cache
-            read_group(global_timestamp,
+            read_group(neu_time_ms_coarse(),
                        neu_group_get_interval(group) *
                            NEU_DRIVER_TAG_CACHE_EXPIRE_TIME,
                        neu_adapter_get_tag_cache_type(&driver->adapter),
@@ -1118,7 +1186,7 @@ void neu_adapter_driver_read_group(neu_adapter_driver_t *driver,
             start_group_timer(driver, g);
         }
     } else {
-        read_group(global_timestamp,
+        read_group(neu_time_ms_coarse(),
                    neu_group_get_interval(group) *
                        NEU_DRIVER_TAG_CACHE_EXPIRE_TIME,
                    neu_adapter_get_tag_cache_type(&driver->adapter),
@@ -1218,7 +1286,7 @@ void neu_adapter_driver_read_group_paginate(neu_adapter_driver_t *driver,
                 driver->adapter.plugin, &g->grp);
             // fetch updated data from cache
             read_group_paginate(
-                global_timestamp,
+                neu_time_ms_coarse(),
                 neu_group_get_interval(group) *
                     NEU_DRIVER_TAG_CACHE_EXPIRE_TIME,
                 neu_adapter_get_tag_cache_type(&driver->adapter), driver->cache,
@@ -1226,7 +1294,7 @@ void neu_adapter_driver_read_group_paginate(neu_adapter_driver_t *driver,
             start_group_timer(driver, g);
         }
     } else {
-        read_group_paginate(global_timestamp,
+        read_group_paginate(neu_time_ms_coarse(),
                             neu_group_get_interval(group) *
                                 NEU_DRIVER_TAG_CACHE_EXPIRE_TIME,
                             neu_adapter_get_tag_cache_type(&driver->adapter),
@@ -2174,7 +2242,7 @@ int neu_adapter_driver_update_group(neu_adapter_driver_t *driver,
         }
     }
 
-    find->timestamp    = global_timestamp; // trigger group_change
+    find->timestamp    = neu_time_ms(); // trigger group_change
     find->grp.interval = interval;
     neu_group_set_interval(find->group, interval);
 
@@ -2358,6 +2426,42 @@ int neu_adapter_driver_try_del_tag(neu_adapter_driver_t *driver, int n_tag)
     return ret;
 }
 
+/**
+ * @brief 检查标签的死区配置，死区只能用于数值类型且宽度与回差不能为负。
+ */
+static int validate_deadband(const neu_datatag_t *tag)
+{
+    const neu_datatag_deadband_t *deadband = &tag->deadband;
+
+    if (!neu_tag_deadband_enabled(deadband)) {
+        return NEU_ERR_SUCCESS;
+    }
+
+    switch (tag->type) {
+    case NEU_TYPE_INT8:
+    case NEU_TYPE_UINT8:
+    case NEU_TYPE_INT16:
+    case NEU_TYPE_UINT16:
+    case NEU_TYPE_INT32:
+    case NEU_TYPE_UINT32:
+    case NEU_TYPE_INT64:
+    case NEU_TYPE_UINT64:
+    case NEU_TYPE_FLOAT:
+    case NEU_TYPE_DOUBLE:
+        break;
+    default:
+        return NEU_ERR_TAG_DEADBAND_INVALID;
+    }
+
+    if (deadband->type > NEU_DEADBAND_VALUE || !(deadband->value >= 0) ||
+        !(deadband->hysteresis >= 0) ||
+        (deadband->type == NEU_DEADBAND_SPAN && !(deadband->span > 0))) {
+        return NEU_ERR_TAG_DEADBAND_INVALID;
+    }
+
+    return NEU_ERR_SUCCESS;
+}
+
 int neu_adapter_driver_validate_tag(neu_adapter_driver_t *driver,
                                     const char *group, neu_datatag_t *tag)
 {
@@ -2401,7 +2505,12 @@ int neu_adapter_driver_validate_tag(neu_adapter_driver_t *driver,
         }
     }
 
-    int ret = driver->adapter.module->intf_funs->driver.validate_tag(
+    int ret = validate_deadband(tag);
+    if (ret != NEU_ERR_SUCCESS) {
+        return ret;
+    }
+
+    ret = driver->adapter.module->intf_funs->driver.validate_tag(
         driver->adapter.plugin, tag);
     if (ret != NEU_ERR_SUCCESS) {
         return ret;
@@ -2472,6 +2581,51 @@ int neu_adapter_driver_add_tag(neu_adapter_driver_t *driver, const char *group,
     return ret;
 }
 
+/**
+ * @brief 启动时批量加载已持久化的组内点位。
+ *
+ * 点位在写入持久化存储前已通过插件校验，这里只解析地址选项，不再逐个调用
+ * 插件的 validate_tag；整组点位一次加锁写入组表，指标只更新一次，插件的
+ * load_tags 也只调用一次。
+ *
+ * @param tags 元素为 neu_datatag_t 的数组，函数内会解析其中的地址选项。
+ * @return 组不存在时返回 NEU_ERR_GROUP_NOT_EXIST，否则返回 NEU_ERR_SUCCESS。
+ */
+int neu_adapter_driver_load_group_tags(neu_adapter_driver_t *driver,
+                                       const char *group, UT_array *tags)
+{
+    group_t *find  = NULL;
+    int      n_tag = utarray_len(tags);
+
+    HASH_FIND_STR(driver->groups, group, find);
+    if (find == NULL) {
+        return NEU_ERR_GROUP_NOT_EXIST;
+    }
+
+    if (n_tag == 0) {
+        return NEU_ERR_SUCCESS;
+    }
+
+    utarray_foreach(tags, neu_datatag_t *, tag)
+    {
+        neu_datatag_parse_addr_option(tag, &tag->option);
+    }
+
+    driver->tag_cnt += neu_group_add_tags(
+        find->group, (neu_datatag_t *) utarray_front(tags), n_tag);
+
+    driver->adapter.cb_funs.update_metric(
+        &driver->adapter, NEU_METRIC_TAGS_TOTAL, driver->tag_cnt, NULL);
+    neu_adapter_update_group_metric(&driver->adapter, group,
+                                    NEU_METRIC_GROUP_TAGS_TOTAL,
+                                    neu_group_tag_size(find->group));
+
+    neu_adapter_driver_load_tag(driver, group,
+                                (neu_datatag_t *) utarray_front(tags), n_tag);
+
+    return NEU_ERR_SUCCESS;
+}
+
 int neu_adapter_driver_del_tag(neu_adapter_driver_t *driver, const char *group,
                                const char *tag)
 {
@@ -2520,6 +2674,11 @@ int neu_adapter_driver_update_tag(neu_adapter_driver_t *driver,
         return NEU_ERR_TAG_PRECISION_INVALID;
     }
 
+    ret = validate_deadband(tag);
+    if (ret != NEU_ERR_SUCCESS) {
+        return ret;
+    }
+
     ret = driver->adapter.module->intf_funs->driver.validate_tag(
         driver->adapter.plugin, tag);
     if (ret != NEU_ERR_SUCCESS) {
@@ -2675,7 +2834,7 @@ static void report_to_app(neu_adapter_driver_t *driver, group_t *group,
     data->group  = strdup(group->name);
     utarray_new(data->tags, neu_resp_tag_value_meta_icd());
 
-    read_group(global_timestamp,
+    read_group(neu_time_ms_coarse(),
                neu_group_get_interval(group->group) *
                    NEU_DRIVER_TAG_CACHE_EXPIRE_TIME,
                neu_adapter_get_tag_cache_type(&driver->adapter), driver->cache,
@@ -2785,7 +2944,7 @@ static int report_callback(void *usr_data)
     }
 
     // 读取报告数据
-    read_report_group(global_timestamp,
+    read_report_group(neu_time_ms_coarse(),
                       neu_group_get_interval(group->group) *
                           NEU_DRIVER_TAG_CACHE_EXPIRE_TIME,
                       neu_adapter_get_tag_cache_type(&group->driver->adapter),
@@ -2939,6 +3098,11 @@ static void group_change(void *arg, int64_t timestamp, UT_array *tags,
 
         neu_driver_cache_add(group->driver->cache, group->name, tag->name,
                              value);
+        if (neu_tag_deadband_enabled(&tag->deadband)) {
+            neu_driver_cache_set_deadband(group->driver->cache, group->name,
+                                          tag->name, &tag->deadband,
+                                          tag->decimal, tag->bias);
+        }
     }
 
     // 组数据变化可能伴随着标签的添加、删除或修改；和配置信息更改
@@ -3086,13 +3250,13 @@ static int read_callback(void *usr_data)
 
     // 检查组中是否存在标签
     if (group->grp.tags != NULL && utarray_len(group->grp.tags) > 0) {
-        int64_t spend = global_timestamp;
+        int64_t spend = neu_time_mono_ns();
 
         // 调用驱动适配器模块，执行组定时器操作
         group->driver->adapter.module->intf_funs->driver.group_timer(
             group->driver->adapter.plugin, &group->grp);
 
-        spend = global_timestamp - spend;
+        spend = (neu_time_mono_ns() - spend) / 1000000;
         nlog_debug("%s-%s timer: %" PRId64, group->driver->adapter.name,
                    group->name, spend);
 
@@ -22,7 +22,7 @@
 
 #include "adapter.h"
 
-neu_adapter_driver_t *neu_adapter_driver_create();
+neu_adapter_driver_t *neu_adapter_driver_create(bool dedicated_events);
 
 void neu_adapter_driver_destroy(neu_adapter_driver_t *driver);
 int  neu_adapter_driver_init(neu_adapter_driver_t *driver);
@@ -71,6 +71,8 @@ int neu_adapter_driver_validate_tag(neu_adapter_driver_t *driver,
 
 int neu_adapter_driver_add_tag(neu_adapter_driver_t *driver, const char *group,
                                neu_datatag_t *tag, uint16_t interval);
+int neu_adapter_driver_load_group_tags(neu_adapter_driver_t *driver,
+                                       const char *group, UT_array *tags);
 int neu_adapter_driver_del_tag(neu_adapter_driver_t *driver, const char *group,
                                const char *tag);
 int neu_adapter_driver_update_tag(neu_adapter_driver_t *driver,
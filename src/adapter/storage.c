@@ -17,8 +17,11 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  **/
 
+#include <inttypes.h>
+
 #include "utils/cid.h"
 #include "utils/log.h"
+#include "utils/time.h"
 
 #include "adapter_internal.h"
 #include "driver/driver_internal.h"
@@ -157,7 +160,8 @@ int adapter_load_setting(const char *node, char **setting)
  * @brief 从持久化存储中加载适配器驱动的组和标签信息。
  *
  * 该函数用于从持久化存储中读取与适配器驱动相关的组和标签信息，并将其添加到适配器驱动中。
- * 它首先加载组信息，然后针对每个组加载相应的标签信息，并将这些信息添加到适配器驱动的内部结构中。
+ * 组信息加载一次，节点下全部点位也只查询一次（按组分好），每个组的点位整批
+ * 写入组表，避免点位数量大时逐个查询、逐个加锁带来的启动耗时。
  *
  * @param driver 指向 neu_adapter_driver_t 类型的指针，代表要加载组和标签信息的适配器驱动实例。
  * @return 函数的返回值为整数类型。
@@ -168,7 +172,11 @@ int adapter_load_setting(const char *node, char **setting)
 int adapter_load_group_and_tag(neu_adapter_driver_t *driver)
 {
     UT_array *     group_infos = NULL;
+    UT_array *     group_tags  = NULL;
     neu_adapter_t *adapter     = (neu_adapter_t *) driver;
+    int64_t        start       = neu_time_mono_ns();
+    int64_t        loaded      = 0;
+    int            n_tag       = 0;
 
     // 加载组信息：持久化存储中加载与 adapter 名称对应的组信息，并将结果存储在 group_infos 数组中
     int rv = neu_persister_load_groups(adapter->name, &group_infos);
@@ -177,10 +185,15 @@ int adapter_load_group_and_tag(neu_adapter_driver_t *driver)
         return rv;
     }
 
+    // 一次查询加载节点下全部点位，按组归类
+    rv = neu_persister_load_node_tags(adapter->name, &group_tags);
+    if (0 != rv) {
+        nlog_warn("load %s tags fail", adapter->name);
+    }
+    loaded = neu_time_mono_ns();
+
     utarray_foreach(group_infos, neu_persist_group_info_t *, p)
     {
-        UT_array *tags = NULL;
-
         // 添加组信息到适配器驱动，并启动组定时器
         if (p->context == NULL) {
             neu_adapter_driver_add_group(driver, p->name, p->interval, NULL);
@@ -188,24 +201,30 @@ int adapter_load_group_and_tag(neu_adapter_driver_t *driver)
             cid_dataset_info_t *info = neu_cid_info_from_string(p->context);
             neu_adapter_driver_add_group(driver, p->name, p->interval, info);
         }
+    }
 
-        // 加载标签信息
-        rv = neu_persister_load_tags(adapter->name, p->name, &tags);
-        if (0 != rv) {
-            nlog_warn("load %s:%s tags fail", adapter->name, p->name);
-            continue;
-        }
-
-        // 添加标签信息到适配器驱动并加载标签：
-        utarray_foreach(tags, neu_datatag_t *, tag)
+    if (group_tags != NULL) {
+        utarray_foreach(group_tags, neu_persist_group_tags_t *, gt)
         {
-            neu_adapter_driver_add_tag(driver, p->name, tag, -1);
-            neu_adapter_driver_load_tag(driver, p->name, tag, 1);
+            // 组已被删除而点位残留时跳过
+            if (0 !=
+                neu_adapter_driver_load_group_tags(driver, gt->group_name,
+                                                   gt->tags)) {
+                nlog_warn("load %s:%s tags fail, group not exist",
+                          adapter->name, gt->group_name);
+                continue;
+            }
+            n_tag += utarray_len(gt->tags);
         }
-
-        utarray_free(tags);
+        utarray_free(group_tags);
     }
 
+    nlog_notice("load %s groups: %u, tags: %d, query: %" PRId64
+                " ms, build: %" PRId64 " ms",
+                adapter->name, utarray_len(group_infos), n_tag,
+                (loaded - start) / 1000000,
+                (neu_time_mono_ns() - loaded) / 1000000);
+
     utarray_free(group_infos);
     return rv;
 }
\ No newline at end of file
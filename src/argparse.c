@@ -81,6 +81,7 @@ const char *usage_text =
 "    --syslog_host <HOST> syslog server host to which neuron will send logs\n"
 "    --syslog_port <PORT> syslog server port (default 541 if not provided)\n"
 "    --sub_filter_error The subscribe attribute only detects the last read value and does not report any error tags\n"
+"    --event_threads <N>  number of shared event loop threads (default cpu cores)\n"
 "\n";
 // clang-format on
 
@@ -183,6 +184,7 @@ static inline int load_spec_arg(int argc, char *argv[], neu_cli_args_t *args)
  *                  - NEU_ENV_LOG: 开发日志功能（"1"启用，"0"禁用）
  *                  - NEU_ENV_LOG_LEVEL: 日志级别字符串（如"debug"|"info"）
  *                  - NEU_ENV_CONFIG_DIR: 配置文件目录路径
+ *                  - NEU_ENV_EVENT_THREADS: 共享事件循环线程数（0 为 CPU 核数）
  *               3. 如何设置环境变量
  *                  - 通过 shell 设置环境变量: export NEURON_DAEMON=1
  *               4. 错误处理：
@@ -309,6 +311,18 @@ static inline int load_env(neu_cli_args_t *args, char **log_level_out,
             }
             args->syslog_port = port;
         }
+
+        // -------------------- 解析共享事件循环线程数 --------------------
+        char *event_threads = getenv(NEU_ENV_EVENT_THREADS);
+        if (NULL != event_threads) {
+            int n = atoi(event_threads);
+            if (n < 0 || 1024 < n) {
+                printf("neuron %s setting invalid!\n", NEU_ENV_EVENT_THREADS);
+                ret = -1;
+                break;
+            }
+            args->event_threads = n;
+        }
     } while (0);
 
     return ret;
@@ -578,6 +592,7 @@ void neu_cli_args_init(neu_cli_args_t *args, int argc, char *argv[])
         { "syslog_host", required_argument, NULL, 'S' },
         { "syslog_port", required_argument, NULL, 'P' },
         { "sub_filter_error", no_argument, NULL, 'f' },
+        { "event_threads", required_argument, NULL, 'e' },
         { NULL, 0, NULL, 0 }, 
     };
 
@@ -676,6 +691,17 @@ void neu_cli_args_init(neu_cli_args_t *args, int argc, char *argv[])
         case 'f':
             args->sub_filter_err = true;  // 设置子过滤器错误标志
             break;
+        case 'e': {
+            int event_threads = atoi(optarg);
+            if (event_threads < 0 || 1024 < event_threads) {
+                fprintf(stderr, "%s: option '--event_threads' invalid : `%s`\n",
+                        argv[0], optarg);
+                ret = 1;
+                goto quit;
+            }
+            args->event_threads = event_threads; // 设置共享事件循环线程数
+            break;
+        }
         case '?':
         default:
             usage(); // 打印使用说明
@@ -36,6 +36,7 @@
 #define NEU_ENV_SYSLOG_HOST "NEURON_SYSLOG_HOST"
 #define NEU_ENV_SYSLOG_PORT "NEURON_SYSLOG_PORT"
 #define NEU_ENV_SUB_FILTER_ERROR "NEURON_SUB_FILTER_ERROR"
+#define NEU_ENV_EVENT_THREADS "NEURON_EVENT_THREADS"
 
 #define NEURON_CONFIG_FNAME "./config/neuron.json"
 
@@ -148,6 +149,13 @@ typedef struct {
      * 当解析到 `-f` 或 `--sub_filter_error` 命令行选项时，此标志被设置为 true。
      */
     bool sub_filter_err;
+
+    /**
+     * @brief 共享事件循环池的线程数，0 表示使用 CPU 核数。
+     *
+     * 可以通过 `--event_threads` 命令行选项或 NEURON_EVENT_THREADS 环境变量设置。
+     */
+    int event_threads;
 } neu_cli_args_t;
 
 /** Parse command line arguments.
@@ -0,0 +1,303 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <jansson.h>
+
+#include "cvalue.h"
+
+typedef char neu_cvalue_size_check[sizeof(neu_cvalue_t) == 16 ? 1 : -1];
+
+/**
+ * @brief 数组类成员在 neu_value_u 中的数据起始地址、元素大小与长度字段。
+ * 非数组类型返回 NULL。
+ */
+static uint8_t *array_layout(const neu_value_u *v, uint8_t type, size_t *elem,
+                             const uint8_t **length)
+{
+    switch (type) {
+    case NEU_TYPE_BYTES:
+        *elem   = 1;
+        *length = &v->bytes.length;
+        return (uint8_t *) v->bytes.bytes;
+    case NEU_TYPE_ARRAY_BOOL:
+        *elem   = sizeof(bool);
+        *length = &v->bools.length;
+        return (uint8_t *) v->bools.bools;
+    case NEU_TYPE_ARRAY_INT8:
+    case NEU_TYPE_ARRAY_UINT8:
+        *elem   = 1;
+        *length = &v->u8s.length;
+        return (uint8_t *) v->u8s.u8s;
+    case NEU_TYPE_ARRAY_INT16:
+    case NEU_TYPE_ARRAY_UINT16:
+        *elem   = sizeof(uint16_t);
+        *length = &v->u16s.length;
+        return (uint8_t *) v->u16s.u16s;
+    case NEU_TYPE_ARRAY_INT32:
+    case NEU_TYPE_ARRAY_UINT32:
+        *elem   = sizeof(uint32_t);
+        *length = &v->u32s.length;
+        return (uint8_t *) v->u32s.u32s;
+    case NEU_TYPE_ARRAY_FLOAT:
+        *elem   = sizeof(float);
+        *length = &v->f32s.length;
+        return (uint8_t *) v->f32s.f32s;
+    case NEU_TYPE_ARRAY_INT64:
+    case NEU_TYPE_ARRAY_UINT64:
+        *elem   = sizeof(uint64_t);
+        *length = &v->u64s.length;
+        return (uint8_t *) v->u64s.u64s;
+    case NEU_TYPE_ARRAY_DOUBLE:
+        *elem   = sizeof(double);
+        *length = &v->f64s.length;
+        return (uint8_t *) v->f64s.f64s;
+    default:
+        return NULL;
+    }
+}
+
+static neu_cvalue_blob_t *blob_new(const void *data, size_t size)
+{
+    neu_cvalue_blob_t *blob = malloc(sizeof(neu_cvalue_blob_t) + size);
+
+    blob->ref  = 1;
+    blob->size = (uint32_t) size;
+    if (data != NULL && size > 0) {
+        memcpy(blob->data, data, size);
+    }
+
+    return blob;
+}
+
+static void set_str(neu_cvalue_t *cv, const char *str, size_t len)
+{
+    if (len <= NEU_CVALUE_INLINE_STR) {
+        memcpy((char *) cv, str, len);
+        ((char *) cv)[len] = '\0';
+    } else {
+        // 外部存储带上结尾 '\0'，可直接作为 C 字符串使用
+        cv->value.blob = blob_new(str, len + 1);
+        cv->flags |= NEU_CVALUE_F_BLOB;
+    }
+}
+
+void neu_cvalue_from_dvalue(neu_cvalue_t *cv, const neu_dvalue_t *dv)
+{
+    const uint8_t *length = NULL;
+    size_t         elem   = 0;
+    uint8_t *      data   = NULL;
+
+    memset(cv, 0, sizeof(neu_cvalue_t));
+    cv->type      = (uint8_t) dv->type;
+    cv->precision = dv->precision;
+
+    switch (dv->type) {
+    case NEU_TYPE_INT8:
+    case NEU_TYPE_UINT8:
+    case NEU_TYPE_BIT:
+        cv->value.u8 = dv->value.u8;
+        break;
+    case NEU_TYPE_INT16:
+    case NEU_TYPE_UINT16:
+    case NEU_TYPE_WORD:
+        cv->value.u16 = dv->value.u16;
+        break;
+    case NEU_TYPE_INT32:
+    case NEU_TYPE_UINT32:
+    case NEU_TYPE_FLOAT:
+    case NEU_TYPE_DWORD:
+    case NEU_TYPE_ERROR:
+        cv->value.u32 = dv->value.u32;
+        break;
+    case NEU_TYPE_INT64:
+    case NEU_TYPE_UINT64:
+    case NEU_TYPE_DOUBLE:
+    case NEU_TYPE_LWORD:
+        cv->value.u64 = dv->value.u64;
+        break;
+    case NEU_TYPE_BOOL:
+        cv->value.boolean = dv->value.boolean;
+        break;
+    case NEU_TYPE_STRING:
+    case NEU_TYPE_TIME:
+    case NEU_TYPE_DATA_AND_TIME:
+    case NEU_TYPE_ARRAY_CHAR:
+        set_str(cv, dv->value.str, strnlen(dv->value.str, NEU_VALUE_SIZE - 1));
+        break;
+    case NEU_TYPE_ARRAY_STRING: {
+        // 各字符串依次存放，以 '\0' 分隔
+        size_t size = 0;
+        for (int i = 0; i < dv->value.strs.length; i++) {
+            size += strlen(dv->value.strs.strs[i]) + 1;
+        }
+
+        cv->value.blob = blob_new(NULL, size);
+        cv->flags |= NEU_CVALUE_F_BLOB;
+        cv->length = dv->value.strs.length;
+
+        size = 0;
+        for (int i = 0; i < dv->value.strs.length; i++) {
+            size_t len = strlen(dv->value.strs.strs[i]) + 1;
+            memcpy(cv->value.blob->data + size, dv->value.strs.strs[i], len);
+            size += len;
+        }
+        break;
+    }
+    case NEU_TYPE_PTR:
+        cv->value.blob = blob_new(dv->value.ptr.ptr, dv->value.ptr.length);
+        cv->flags |= NEU_CVALUE_F_BLOB;
+        cv->length = (uint8_t) dv->value.ptr.type;
+        break;
+    case NEU_TYPE_CUSTOM:
+        cv->value.ptr = json_incref(dv->value.json);
+        cv->flags |= NEU_CVALUE_F_JSON;
+        break;
+    default:
+        data = array_layout(&dv->value, cv->type, &elem, &length);
+        if (data != NULL) {
+            cv->value.blob = blob_new(data, *length * elem);
+            cv->flags |= NEU_CVALUE_F_BLOB;
+            cv->length = *length;
+        }
+        break;
+    }
+}
+
+void neu_cvalue_to_dvalue(const neu_cvalue_t *cv, neu_dvalue_t *dv)
+{
+    const uint8_t *length = NULL;
+    size_t         elem   = 0;
+    uint8_t *      data   = NULL;
+
+    dv->type      = (neu_type_e) cv->type;
+    dv->precision = cv->precision;
+
+    switch (cv->type) {
+    case NEU_TYPE_INT8:
+    case NEU_TYPE_UINT8:
+    case NEU_TYPE_BIT:
+        dv->value.u8 = cv->value.u8;
+        break;
+    case NEU_TYPE_INT16:
+    case NEU_TYPE_UINT16:
+    case NEU_TYPE_WORD:
+        dv->value.u16 = cv->value.u16;
+        break;
+    case NEU_TYPE_INT32:
+    case NEU_TYPE_UINT32:
+    case NEU_TYPE_FLOAT:
+    case NEU_TYPE_DWORD:
+    case NEU_TYPE_ERROR:
+        dv->value.u32 = cv->value.u32;
+        break;
+    case NEU_TYPE_INT64:
+    case NEU_TYPE_UINT64:
+    case NEU_TYPE_DOUBLE:
+    case NEU_TYPE_LWORD:
+        dv->value.u64 = cv->value.u64;
+        break;
+    case NEU_TYPE_BOOL:
+        dv->value.boolean = cv->value.boolean;
+        break;
+    case NEU_TYPE_STRING:
+    case NEU_TYPE_TIME:
+    case NEU_TYPE_DATA_AND_TIME:
+    case NEU_TYPE_ARRAY_CHAR: {
+        strcpy(dv->value.str, neu_cvalue_str(cv));
+        break;
+    }
+    case NEU_TYPE_ARRAY_STRING: {
+        const char *str = (const char *) cv->value.blob->data;
+
+        dv->value.strs.length = cv->length;
+        for (int i = 0; i < cv->length; i++) {
+            dv->value.strs.strs[i] = strdup(str);
+            str += strlen(str) + 1;
+        }
+        break;
+    }
+    case NEU_TYPE_PTR:
+        dv->value.ptr.type   = (neu_type_e) cv->length;
+        dv->value.ptr.length = (uint16_t) cv->value.blob->size;
+        dv->value.ptr.ptr    = calloc(1, cv->value.blob->size);
+        memcpy(dv->value.ptr.ptr, cv->value.blob->data, cv->value.blob->size);
+        break;
+    case NEU_TYPE_CUSTOM:
+        dv->value.json = json_deep_copy((json_t *) cv->value.ptr);
+        break;
+    default:
+        data = array_layout(&dv->value, cv->type, &elem, &length);
+        if (data != NULL) {
+            *(uint8_t *) length = cv->length;
+            memcpy(data, cv->value.blob->data, cv->value.blob->size);
+        }
+        break;
+    }
+}
+
+void neu_cvalue_copy(neu_cvalue_t *dst, const neu_cvalue_t *src)
+{
+    *dst = *src;
+
+    if (src->flags & NEU_CVALUE_F_BLOB) {
+        __atomic_fetch_add(&src->value.blob->ref, 1, __ATOMIC_RELAXED);
+    } else if (src->flags & NEU_CVALUE_F_JSON) {
+        json_incref((json_t *) src->value.ptr);
+    }
+}
+
+void neu_cvalue_release(neu_cvalue_t *cv)
+{
+    if (cv->flags & NEU_CVALUE_F_BLOB) {
+        if (__atomic_sub_fetch(&cv->value.blob->ref, 1, __ATOMIC_ACQ_REL) ==
+            0) {
+            free(cv->value.blob);
+        }
+    } else if (cv->flags & NEU_CVALUE_F_JSON) {
+        json_decref((json_t *) cv->value.ptr);
+    }
+
+    memset(cv, 0, sizeof(neu_cvalue_t));
+}
+
+bool neu_cvalue_equal(const neu_cvalue_t *a, const neu_cvalue_t *b)
+{
+    if (a->type != b->type || a->flags != b->flags || a->length != b->length) {
+        return false;
+    }
+
+    if (a->flags & NEU_CVALUE_F_BLOB) {
+        return a->value.blob == b->value.blob ||
+            (a->value.blob->size == b->value.blob->size &&
+             memcmp(a->value.blob->data, b->value.blob->data,
+                    a->value.blob->size) == 0);
+    }
+
+    if (a->flags & NEU_CVALUE_F_JSON) {
+        return json_equal((json_t *) a->value.ptr, (json_t *) b->value.ptr) !=
+            0;
+    }
+
+    // 内联值构造时整体清零，未使用的字节都为 0，可以直接比较 12 字节
+    return memcmp(a, b, offsetof(neu_cvalue_t, type)) == 0;
+}
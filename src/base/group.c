@@ -214,6 +214,33 @@ int neu_group_add_tag(neu_group_t *group, const neu_datatag_t *tag)
     return 0;
 }
 
+int neu_group_add_tags(neu_group_t *group, const neu_datatag_t *tags, int n)
+{
+    tag_elem_t *el    = NULL;
+    int         added = 0;
+
+    pthread_mutex_lock(&group->mtx);
+    for (int i = 0; i < n; i++) {
+        HASH_FIND_STR(group->tags, tags[i].name, el);
+        if (el != NULL) {
+            continue;
+        }
+
+        el       = calloc(1, sizeof(tag_elem_t));
+        el->name = strdup(tags[i].name);
+        el->tag  = neu_tag_dup(&tags[i]);
+
+        HASH_ADD_STR(group->tags, name, el);
+        added += 1;
+    }
+    if (added > 0) {
+        update_timestamp(group);
+    }
+    pthread_mutex_unlock(&group->mtx);
+
+    return added;
+}
+
 int neu_group_update_tag(neu_group_t *group, const neu_datatag_t *tag)
 {
     tag_elem_t *el  = NULL;
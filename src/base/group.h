@@ -36,6 +36,12 @@ void         neu_group_set_interval(neu_group_t *group, uint32_t interval);
 void         neu_group_destroy(neu_group_t *group);
 int          neu_group_update(neu_group_t *group, uint32_t interval);
 int          neu_group_add_tag(neu_group_t *group, const neu_datatag_t *tag);
+/**
+ * @brief 批量添加点位，只加锁一次并只更新一次时间戳，同名点位跳过。
+ *
+ * @return 实际添加的点位个数。
+ */
+int neu_group_add_tags(neu_group_t *group, const neu_datatag_t *tags, int n);
 int          neu_group_update_tag(neu_group_t *group, const neu_datatag_t *tag);
 int          neu_group_del_tag(neu_group_t *group, const char *tag_name);
 UT_array *   neu_group_get_tag(neu_group_t *group);
@@ -326,6 +326,7 @@ static inline void metrics_unregister_entry(const char *name)
         HASH_DEL(g_metrics_.registered_metrics, e);
         nlog_notice("del entry:%s", e->name);
         neu_metric_entry_free(e);
+        ++g_metrics_.version;
     }
 }
 
@@ -427,6 +428,7 @@ void neu_metrics_add_node(const neu_adapter_t *adapter)
 {
     pthread_rwlock_wrlock(&g_metrics_mtx_);
     HASH_ADD_STR(g_metrics_.node_metrics, name, adapter->metrics);
+    ++g_metrics_.version;
     pthread_rwlock_unlock(&g_metrics_mtx_);
 }
 
@@ -434,6 +436,7 @@ void neu_metrics_del_node(const neu_adapter_t *adapter)
 {
     pthread_rwlock_wrlock(&g_metrics_mtx_);
     HASH_DEL(g_metrics_.node_metrics, adapter->metrics);
+    ++g_metrics_.version;
     pthread_rwlock_unlock(&g_metrics_mtx_);
 }
 
@@ -459,6 +462,9 @@ int neu_metrics_register_entry(const char *name, const char *help,
     // and we don't need to allocate rolling counter for register entries
     rv = neu_metric_entries_add(&g_metrics_.registered_metrics, name, help,
                                 type, 0);
+    if (0 == rv) {
+        ++g_metrics_.version;
+    }
     if (-1 != rv) {
         HASH_FIND_STR(g_metrics_.registered_metrics, name, e);
         ++e->value;
@@ -29,6 +29,7 @@ extern "C" {
 #include <sys/un.h>
 
 #include "msg.h"
+#include "persist/persist.h"
 
 /**
  * @brief NEU_REQRESP_TYPE_MAP 宏展开
@@ -100,6 +101,8 @@ extern "C" {
     XX(NEU_REQRESP_NODES_STATE, neu_reqresp_nodes_state_t)           \
     XX(NEU_REQRESP_NODE_DELETED, neu_reqresp_node_deleted_t)         \
     XX(NEU_REQ_ADD_DRIVERS, neu_req_driver_array_t)                  \
+    XX(NEU_REQ_IMPORT_CONFIG, neu_req_import_config_t)               \
+    XX(NEU_RESP_IMPORT_CONFIG, neu_resp_import_config_t)             \
     XX(NEU_REQ_UPDATE_LOG_LEVEL, neu_req_update_log_level_t)         \
     XX(NEU_REQ_PRGFILE_UPLOAD, neu_req_prgfile_upload_t)             \
     XX(NEU_REQ_PRGFILE_PROCESS, neu_req_prgfile_process_t)           \
@@ -242,6 +245,9 @@ static inline neu_msg_t *neu_msg_new(neu_reqresp_type_e t, void *ctx,
     case NEU_REQ_GET_NODES_STATE:
         body_size = neu_reqresp_size(NEU_RESP_GET_NODES_STATE);
         break;
+    case NEU_REQ_IMPORT_CONFIG:
+        body_size = neu_reqresp_size(NEU_RESP_IMPORT_CONFIG);
+        break;
     default:
         body_size = data_size;
     }
@@ -249,7 +255,7 @@ static inline neu_msg_t *neu_msg_new(neu_reqresp_type_e t, void *ctx,
     //计算消息对象的总大小: sizeof(neu_msg_t)只计算柔性输入之前的大小即neu_msg_s
     size_t     total = sizeof(neu_msg_t) + body_size;
 
-    neu_msg_t *msg   = calloc(1, total);
+    neu_msg_t *msg   = (neu_msg_t *) calloc(1, total);
     if (msg) {
         msg->head.type = t;                      // 设置为传入的消息类型
         msg->head.len  = total;                  // 设置为消息对象的总大小
@@ -263,9 +269,11 @@ static inline neu_msg_t *neu_msg_new(neu_reqresp_type_e t, void *ctx,
 
 static inline neu_msg_t *neu_msg_copy(const neu_msg_t *other)
 {
-    neu_msg_t *msg = calloc(1, other->head.len);
+    neu_msg_t *msg = (neu_msg_t *) calloc(1, other->head.len);
     if (msg) {
         memcpy(msg, other, other->head.len);
+        // 持久化命令只随原消息传递
+        msg->head.persist_ticket = NULL;
     }
     return msg;
 }
@@ -274,7 +282,8 @@ static inline neu_msg_t *neu_msg_copy(const neu_msg_t *other)
  * @brief 释放消息对象占用的内存。
  *
  * 此函数用于释放由 `neu_msg_new` 或其他类似函数分配的消息对象所占用的内存。
- * 它首先检查传入的消息指针是否非空，然后调用 `free` 函数释放该消息对象。
+ * 它首先检查传入的消息指针是否非空，释放消息携带的持久化记录，然后调用 `free`
+ * 函数释放该消息对象。
  *
  * @param msg 指向 `neu_msg_t` 结构体的指针，表示要释放的消息对象。
  *            可以为 `NULL`，此时函数不做任何操作。
@@ -282,6 +291,9 @@ static inline neu_msg_t *neu_msg_copy(const neu_msg_t *other)
 static inline void neu_msg_free(neu_msg_t *msg)
 {
     if (msg) {
+        if (msg->head.persist_ticket) {
+            neu_persister_ticket_release(msg->head.persist_ticket);
+        }
         free(msg);
     }
 }
@@ -48,6 +48,7 @@ static void tag_array_copy(void *_dst, const void *_src)
     dst->decimal     = src->decimal;
     dst->bias        = src->bias;
     dst->option      = src->option;
+    dst->deadband    = src->deadband;
 
     // 使用strdup复制字符串字段
     dst->address     = strdup(src->address);
@@ -114,6 +115,40 @@ int neu_format_from_str(const char *format_str, uint8_t *formats)
     return n;
 }
 
+void neu_tag_deadband_str(const neu_datatag_deadband_t *deadband, char *buf,
+                          int len)
+{
+    if (!neu_tag_deadband_enabled(deadband)) {
+        buf[0] = '\0';
+        return;
+    }
+
+    snprintf(buf, len, "%d,%.17g,%.17g,%.17g,%u", (int) deadband->type,
+             deadband->value, deadband->span, deadband->hysteresis,
+             deadband->heartbeat);
+}
+
+int neu_deadband_from_str(const char *str, neu_datatag_deadband_t *deadband)
+{
+    int type = NEU_DEADBAND_NONE;
+
+    memset(deadband, 0, sizeof(*deadband));
+    if (str == NULL || strlen(str) == 0) {
+        return 0;
+    }
+
+    if (sscanf(str, "%d,%lf,%lf,%lf,%u", &type, &deadband->value,
+               &deadband->span, &deadband->hysteresis,
+               &deadband->heartbeat) != 5 ||
+        type < NEU_DEADBAND_NONE || type > NEU_DEADBAND_VALUE) {
+        memset(deadband, 0, sizeof(*deadband));
+        return -1;
+    }
+
+    deadband->type = type;
+    return 0;
+}
+
 /**
  * @brief 定义用于管理neu_datatag_t类型数据的UT_icd接口。
  *
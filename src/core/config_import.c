@@ -0,0 +1,608 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2023 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+/**
+ * 全局配置的批量导入。
+ *
+ * 导入替换全部非单例节点：先在一个事务中写入持久化存储（同时保留旧配置的
+ * 快照），再卸载旧节点、按存储并行加载新节点，最后由插件校验设置与点位并
+ * 建立订阅。写入失败时运行中的节点不受影响；加载或校验失败时卸载新节点，
+ * 用快照恢复存储并重新加载旧配置。
+ */
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "utils/log.h"
+#include "utils/set.h"
+#include "utils/time.h"
+
+#include "adapter.h"
+#include "errcodes.h"
+
+#include "adapter/adapter_internal.h"
+#include "adapter/driver/driver_internal.h"
+
+#include "config_import.h"
+#include "manager_internal.h"
+#include "storage.h"
+
+#define IMPORT_KEY_LEN (NEU_NODE_NAME_LEN * 2 + NEU_GROUP_NAME_LEN)
+
+static pthread_mutex_t       g_progress_mtx = PTHREAD_MUTEX_INITIALIZER;
+static neu_import_progress_t g_progress     = { 0 };
+
+static void progress_start(bool dry_run)
+{
+    pthread_mutex_lock(&g_progress_mtx);
+    memset(&g_progress, 0, sizeof(g_progress));
+    g_progress.phase   = NEU_IMPORT_PHASE_VALIDATE;
+    g_progress.dry_run = dry_run;
+    g_progress.start   = neu_time_ms();
+    pthread_mutex_unlock(&g_progress_mtx);
+}
+
+static void progress_phase(neu_import_phase_e phase, uint64_t total)
+{
+    pthread_mutex_lock(&g_progress_mtx);
+    g_progress.phase = phase;
+    g_progress.total = total;
+    g_progress.done  = 0;
+    pthread_mutex_unlock(&g_progress_mtx);
+}
+
+static void progress_done(uint64_t done)
+{
+    pthread_mutex_lock(&g_progress_mtx);
+    g_progress.done = done;
+    pthread_mutex_unlock(&g_progress_mtx);
+}
+
+static void progress_end(int error)
+{
+    pthread_mutex_lock(&g_progress_mtx);
+    g_progress.phase =
+        0 == error ? NEU_IMPORT_PHASE_DONE : NEU_IMPORT_PHASE_FAILED;
+    g_progress.error   = error;
+    g_progress.elapsed = neu_time_ms() - g_progress.start;
+    pthread_mutex_unlock(&g_progress_mtx);
+}
+
+void neu_import_get_progress(neu_import_progress_t *progress)
+{
+    pthread_mutex_lock(&g_progress_mtx);
+    *progress = g_progress;
+    if (NEU_IMPORT_PHASE_IDLE != progress->phase &&
+        NEU_IMPORT_PHASE_DONE != progress->phase &&
+        NEU_IMPORT_PHASE_FAILED != progress->phase) {
+        progress->elapsed = neu_time_ms() - progress->start;
+    }
+    pthread_mutex_unlock(&g_progress_mtx);
+}
+
+const char *neu_import_phase_str(neu_import_phase_e phase)
+{
+    switch (phase) {
+    case NEU_IMPORT_PHASE_IDLE:
+        return "idle";
+    case NEU_IMPORT_PHASE_VALIDATE:
+        return "validate";
+    case NEU_IMPORT_PHASE_PERSIST:
+        return "persist";
+    case NEU_IMPORT_PHASE_LOAD:
+        return "load";
+    case NEU_IMPORT_PHASE_VERIFY:
+        return "verify";
+    case NEU_IMPORT_PHASE_SUBSCRIBE:
+        return "subscribe";
+    case NEU_IMPORT_PHASE_ROLLBACK:
+        return "rollback";
+    case NEU_IMPORT_PHASE_DONE:
+        return "done";
+    case NEU_IMPORT_PHASE_FAILED:
+        return "failed";
+    }
+
+    return "unknown";
+}
+
+static void make_key(char *key, const char *a, const char *b, const char *c)
+{
+    snprintf(key, IMPORT_KEY_LEN, "%s\x1f%s\x1f%s", a, b, c ? c : "");
+}
+
+static int find_node(neu_req_import_config_t *req, const char *name)
+{
+    for (uint16_t i = 0; i < req->n_node; ++i) {
+        if (0 == strcmp(req->nodes[i].node, name)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int import_validate(neu_manager_t *manager, neu_req_import_config_t *req,
+                           int *types, neu_resp_import_config_t *resp)
+{
+    int rv = 0;
+
+    for (uint16_t i = 0; i < req->n_node; ++i) {
+        neu_req_driver_t *     node = &req->nodes[i];
+        neu_resp_plugin_info_t info = { 0 };
+
+        if (0 !=
+            neu_plugin_manager_find(manager->plugin_manager, node->plugin,
+                                    &info)) {
+            rv = NEU_ERR_LIBRARY_NOT_FOUND;
+        } else if (info.single) {
+            rv = NEU_ERR_LIBRARY_NOT_ALLOW_CREATE_INSTANCE;
+        } else if (node->n_group > 0 && NEU_NA_TYPE_DRIVER != info.type) {
+            rv = NEU_ERR_PLUGIN_TYPE_NOT_SUPPORT;
+        } else if (node->n_group > NEU_GROUP_MAX_PER_NODE) {
+            rv = NEU_ERR_GROUP_MAX_GROUPS;
+        }
+
+        if (0 != rv) {
+            strcpy(resp->node, node->node);
+            return rv;
+        }
+        types[i] = info.type;
+    }
+
+    for (uint32_t i = 0; i < req->n_subscription; ++i) {
+        neu_req_subscribe_t *sub    = &req->subscriptions[i];
+        int                  app    = find_node(req, sub->app);
+        int                  driver = find_node(req, sub->driver);
+
+        if (app < 0 || driver < 0) {
+            strcpy(resp->node, app < 0 ? sub->app : sub->driver);
+            return NEU_ERR_NODE_NOT_EXIST;
+        }
+
+        if (NEU_NA_TYPE_APP != types[app] ||
+            NEU_NA_TYPE_DRIVER != types[driver]) {
+            strcpy(resp->node, sub->app);
+            return NEU_ERR_NODE_NOT_ALLOW_SUBSCRIBE;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief 比较导入的配置与运行中的配置，并收集当前的非单例节点。
+ *
+ * @param current 输出当前的非单例节点名，应用节点在前。
+ */
+static int import_diff(neu_manager_t *manager, neu_req_import_config_t *req,
+                       neu_resp_import_config_t *resp, UT_array *current)
+{
+    int          rv           = 0;
+    uint32_t     n_cur_group  = 0;
+    uint32_t     n_cur_sub    = 0;
+    neu_strset_t import_nodes = NULL;
+    neu_strset_t cur_nodes    = NULL;
+    neu_strset_t cur_groups   = NULL;
+    neu_strset_t cur_subs     = NULL;
+    char         key[IMPORT_KEY_LEN];
+
+    utarray_new(resp->add_nodes, &ut_str_icd);
+    utarray_new(resp->del_nodes, &ut_str_icd);
+    utarray_new(resp->update_nodes, &ut_str_icd);
+
+    for (uint16_t i = 0; i < req->n_node; ++i) {
+        if (neu_strset_add(&import_nodes, req->nodes[i].node) < 0) {
+            rv = NEU_ERR_EINTERNAL;
+            goto end;
+        }
+    }
+
+    const int types[] = { NEU_NA_TYPE_APP, NEU_NA_TYPE_DRIVER };
+    for (size_t t = 0; t < sizeof(types) / sizeof(types[0]); ++t) {
+        UT_array *nodes = neu_node_manager_get(manager->node_manager, types[t]);
+
+        utarray_foreach(nodes, neu_resp_node_info_t *, info)
+        {
+            char *name = info->node;
+
+            if (neu_node_manager_is_single(manager->node_manager, name)) {
+                continue;
+            }
+            utarray_push_back(current, &name);
+            if (neu_strset_add_dup(&cur_nodes, name) < 0) {
+                rv = NEU_ERR_EINTERNAL;
+                break;
+            }
+            if (neu_strset_test(&import_nodes, name)) {
+                utarray_push_back(resp->update_nodes, &name);
+            } else {
+                utarray_push_back(resp->del_nodes, &name);
+            }
+
+            if (NEU_NA_TYPE_APP != types[t]) {
+                continue;
+            }
+
+            UT_array *subs = neu_subscribe_manager_get(
+                manager->subscribe_manager, name, NULL, NULL);
+            utarray_foreach(subs, neu_resp_subscribe_info_t *, sub)
+            {
+                make_key(key, sub->app, sub->driver, sub->group);
+                if (neu_strset_add_dup(&cur_subs, key) > 0) {
+                    n_cur_sub += 1;
+                }
+            }
+            utarray_free(subs);
+        }
+        utarray_free(nodes);
+
+        if (0 != rv) {
+            goto end;
+        }
+    }
+
+    UT_array *groups = neu_manager_get_driver_group(manager);
+    utarray_foreach(groups, neu_resp_driver_group_info_t *, group)
+    {
+        if (!neu_strset_test(&cur_nodes, group->driver)) {
+            continue;
+        }
+        make_key(key, group->driver, group->group, NULL);
+        if (neu_strset_add_dup(&cur_groups, key) > 0) {
+            n_cur_group += 1;
+            resp->current_tags += group->tag_count;
+        }
+    }
+    utarray_free(groups);
+
+    for (uint16_t i = 0; i < req->n_node; ++i) {
+        neu_req_driver_t *node = &req->nodes[i];
+
+        if (!neu_strset_test(&cur_nodes, node->node)) {
+            utarray_push_back(resp->add_nodes, &node->node);
+        }
+
+        for (uint16_t j = 0; j < node->n_group; ++j) {
+            make_key(key, node->node, node->groups[j].group, NULL);
+            if (neu_strset_test(&cur_groups, key)) {
+                resp->update_groups += 1;
+            } else {
+                resp->add_groups += 1;
+            }
+            resp->import_tags += node->groups[j].n_tag;
+        }
+    }
+    resp->del_groups = n_cur_group - resp->update_groups;
+
+    for (uint32_t i = 0; i < req->n_subscription; ++i) {
+        neu_req_subscribe_t *sub = &req->subscriptions[i];
+
+        make_key(key, sub->app, sub->driver, sub->group);
+        if (neu_strset_test(&cur_subs, key)) {
+            resp->update_subscriptions += 1;
+        } else {
+            resp->add_subscriptions += 1;
+        }
+    }
+    resp->del_subscriptions = n_cur_sub - resp->update_subscriptions;
+
+end:
+    neu_strset_free(&import_nodes);
+    neu_strset_free_dup(&cur_nodes);
+    neu_strset_free_dup(&cur_groups);
+    neu_strset_free_dup(&cur_subs);
+    return rv;
+}
+
+static int import_persist(neu_req_import_config_t *req, const int *types,
+                          UT_array *current)
+{
+    int                         rv       = 0;
+    size_t                      n_group  = 0;
+    neu_persist_import_t        import   = { 0 };
+    neu_persist_import_node_t * nodes    = NULL;
+    neu_persist_import_group_t *groups   = NULL;
+    neu_persist_import_sub_t *  subs     = NULL;
+    size_t                      group_at = 0;
+
+    for (uint16_t i = 0; i < req->n_node; ++i) {
+        n_group += req->nodes[i].n_group;
+    }
+
+    nodes  = calloc(req->n_node + 1, sizeof(*nodes));
+    groups = calloc(n_group + 1, sizeof(*groups));
+    subs   = calloc(req->n_subscription + 1, sizeof(*subs));
+    if (NULL == nodes || NULL == groups || NULL == subs) {
+        rv = NEU_ERR_EINTERNAL;
+        goto end;
+    }
+
+    for (uint16_t i = 0; i < req->n_node; ++i) {
+        neu_req_driver_t *node = &req->nodes[i];
+
+        nodes[i].info.name        = node->node;
+        nodes[i].info.type        = types[i];
+        nodes[i].info.plugin_name = node->plugin;
+        // 有设置的节点加载后自动启动
+        nodes[i].info.state = node->setting ? NEU_NODE_RUNNING_STATE_RUNNING
+                                            : NEU_NODE_RUNNING_STATE_INIT;
+        nodes[i].setting    = node->setting;
+
+        for (uint16_t j = 0; j < node->n_group; ++j, ++group_at) {
+            groups[group_at].driver_name = node->node;
+            groups[group_at].name        = node->groups[j].group;
+            groups[group_at].interval    = node->groups[j].interval;
+            groups[group_at].tags        = node->groups[j].tags;
+            groups[group_at].n_tag       = node->groups[j].n_tag;
+        }
+    }
+
+    for (uint32_t i = 0; i < req->n_subscription; ++i) {
+        subs[i].app_name    = req->subscriptions[i].app;
+        subs[i].driver_name = req->subscriptions[i].driver;
+        subs[i].group_name  = req->subscriptions[i].group;
+        subs[i].params      = req->subscriptions[i].params;
+        subs[i].static_tags = req->subscriptions[i].static_tags;
+    }
+
+    import.del_nodes      = (const char *const *) utarray_front(current);
+    import.n_del_node     = utarray_len(current);
+    import.nodes          = nodes;
+    import.n_node         = req->n_node;
+    import.groups         = groups;
+    import.n_group        = n_group;
+    import.subscriptions  = subs;
+    import.n_subscription = req->n_subscription;
+
+    rv = neu_persister_import(&import);
+
+end:
+    free(nodes);
+    free(groups);
+    free(subs);
+    return rv;
+}
+
+static void import_load(neu_manager_t *manager, neu_req_import_config_t *req,
+                        const int *types)
+{
+    UT_array *node_infos = NULL;
+    UT_icd    icd = { sizeof(neu_persist_node_info_t), NULL, NULL, NULL };
+
+    utarray_new(node_infos, &icd);
+    for (uint16_t i = 0; i < req->n_node; ++i) {
+        neu_persist_node_info_t info = {
+            .name        = req->nodes[i].node,
+            .type        = types[i],
+            .plugin_name = req->nodes[i].plugin,
+            .state       = req->nodes[i].setting
+                ? NEU_NODE_RUNNING_STATE_RUNNING
+                : NEU_NODE_RUNNING_STATE_INIT,
+        };
+        utarray_push_back(node_infos, &info);
+    }
+
+    // 设置、组与点位在创建节点时从持久化存储加载
+    neu_manager_load_nodes(manager, node_infos);
+    utarray_free(node_infos);
+}
+
+static int import_verify(neu_manager_t *manager, neu_req_import_config_t *req,
+                         neu_resp_import_config_t *resp)
+{
+    uint64_t done = 0;
+
+    progress_phase(NEU_IMPORT_PHASE_VERIFY, resp->import_tags);
+
+    for (uint16_t i = 0; i < req->n_node; ++i) {
+        neu_req_driver_t *node = &req->nodes[i];
+        neu_adapter_t *   adapter =
+            neu_node_manager_find(manager->node_manager, node->node);
+        int rv = 0;
+
+        if (NULL == adapter) {
+            strcpy(resp->node, node->node);
+            return NEU_ERR_NODE_NOT_EXIST;
+        }
+
+        if (node->setting) {
+            char *setting = NULL;
+
+            // 插件拒绝设置时节点中不保留设置
+            if (0 != neu_adapter_get_setting(adapter, &setting)) {
+                strcpy(resp->node, node->node);
+                return NEU_ERR_NODE_SETTING_INVALID;
+            }
+            free(setting);
+        }
+
+        // 加载时不再校验点位，这里逐个交给插件校验
+        for (uint16_t j = 0; j < node->n_group; ++j) {
+            neu_gdatatag_t *group = &node->groups[j];
+
+            for (int k = 0; k < group->n_tag; ++k) {
+                rv = neu_adapter_driver_validate_tag(
+                    (neu_adapter_driver_t *) adapter, group->group,
+                    &group->tags[k]);
+                if (0 != rv) {
+                    nlog_warn("import %s:%s tag %s invalid, error: %d",
+                              node->node, group->group, group->tags[k].name,
+                              rv);
+                    strcpy(resp->node, node->node);
+                    return rv;
+                }
+            }
+            done += group->n_tag;
+        }
+        progress_done(done);
+    }
+
+    return 0;
+}
+
+static int import_subscribe(neu_manager_t *           manager,
+                            neu_req_import_config_t * req, uint16_t *ports,
+                            neu_resp_import_config_t *resp)
+{
+    progress_phase(NEU_IMPORT_PHASE_SUBSCRIBE, req->n_subscription);
+
+    for (uint32_t i = 0; i < req->n_subscription; ++i) {
+        neu_req_subscribe_t *sub = &req->subscriptions[i];
+
+        int rv =
+            neu_manager_subscribe(manager, sub->app, sub->driver, sub->group,
+                                  sub->params, sub->static_tags, &ports[i]);
+        if (0 != rv) {
+            nlog_warn("import subscription app:%s driver:%s grp:%s fail, "
+                      "error: %d",
+                      sub->app, sub->driver, sub->group, rv);
+            strcpy(resp->node, sub->app);
+            return rv;
+        }
+        progress_done(i + 1);
+    }
+
+    return 0;
+}
+
+static void unload_nodes(neu_manager_t *manager, neu_req_import_config_t *req,
+                         const int *types)
+{
+    // 先卸载应用，取消订阅后再卸载驱动
+    for (uint16_t i = 0; i < req->n_node; ++i) {
+        if (NEU_NA_TYPE_APP == types[i]) {
+            neu_manager_remove_node(manager, req->nodes[i].node);
+        }
+    }
+    for (uint16_t i = 0; i < req->n_node; ++i) {
+        if (NEU_NA_TYPE_APP != types[i]) {
+            neu_manager_remove_node(manager, req->nodes[i].node);
+        }
+    }
+}
+
+static void import_rollback(neu_manager_t *          manager,
+                            neu_req_import_config_t *req, const int *types)
+{
+    progress_phase(NEU_IMPORT_PHASE_ROLLBACK, 1);
+
+    unload_nodes(manager, req, types);
+    if (0 != neu_persister_import_end(true)) {
+        nlog_error("restore configuration fail");
+    }
+    manager_load_node(manager);
+    manager_load_subscribe(manager);
+
+    progress_done(1);
+}
+
+static int import_apply(neu_manager_t *manager, neu_req_import_config_t *req,
+                        const int *types, UT_array *current,
+                        neu_resp_import_config_t *resp)
+{
+    int       rv    = 0;
+    uint16_t *ports = calloc(req->n_subscription + 1, sizeof(uint16_t));
+
+    if (NULL == ports) {
+        return NEU_ERR_EINTERNAL;
+    }
+
+    progress_phase(NEU_IMPORT_PHASE_PERSIST, 1);
+    rv = import_persist(req, types, current);
+    if (0 != rv) {
+        // 存储未改动，运行中的节点不受影响
+        nlog_error("persist imported configuration fail");
+        free(ports);
+        return rv;
+    }
+    progress_done(1);
+
+    progress_phase(NEU_IMPORT_PHASE_LOAD, req->n_node);
+    utarray_foreach(current, char **, name)
+    {
+        neu_manager_remove_node(manager, *name);
+    }
+    import_load(manager, req, types);
+    progress_done(req->n_node);
+
+    rv = import_verify(manager, req, resp);
+    if (0 == rv) {
+        rv = import_subscribe(manager, req, ports, resp);
+    }
+
+    if (0 != rv) {
+        import_rollback(manager, req, types);
+        free(ports);
+        return rv;
+    }
+
+    if (0 != neu_persister_import_end(false)) {
+        nlog_warn("drop import snapshot fail");
+    }
+
+    for (uint32_t i = 0; i < req->n_subscription; ++i) {
+        neu_req_subscribe_t *sub = &req->subscriptions[i];
+        neu_manager_send_subscribe(manager, sub->app, sub->driver, sub->group,
+                                   ports[i], sub->params, sub->static_tags);
+    }
+
+    free(ports);
+    return 0;
+}
+
+int neu_manager_import_config(neu_manager_t *           manager,
+                              neu_req_import_config_t * req,
+                              neu_resp_import_config_t *resp)
+{
+    int       rv      = 0;
+    int *     types   = calloc(req->n_node + 1, sizeof(int));
+    UT_array *current = NULL;
+
+    resp->dry_run = req->dry_run;
+    progress_start(req->dry_run);
+
+    utarray_new(current, &ut_str_icd);
+    if (NULL == types) {
+        rv = NEU_ERR_EINTERNAL;
+        goto end;
+    }
+
+    rv = import_validate(manager, req, types, resp);
+    if (0 == rv) {
+        rv = import_diff(manager, req, resp, current);
+    }
+    if (0 == rv && !req->dry_run) {
+        rv = import_apply(manager, req, types, current, resp);
+    }
+
+end:
+    progress_end(rv);
+    nlog_notice("import config%s nodes: %" PRIu16 ", tags: %" PRIu64
+                ", subscriptions: %" PRIu32 ", error: %d",
+                req->dry_run ? " (dry run)" : "", req->n_node,
+                resp->import_tags, req->n_subscription, rv);
+
+    resp->error = rv;
+    utarray_free(current);
+    free(types);
+    return rv;
+}
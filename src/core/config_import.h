@@ -0,0 +1,56 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2023 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+#ifndef _NEU_MANAGER_CONFIG_IMPORT_H_
+#define _NEU_MANAGER_CONFIG_IMPORT_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum {
+    NEU_IMPORT_PHASE_IDLE,
+    NEU_IMPORT_PHASE_VALIDATE,  ///< 检查插件与引用
+    NEU_IMPORT_PHASE_PERSIST,   ///< 单个事务写入持久化存储
+    NEU_IMPORT_PHASE_LOAD,      ///< 卸载旧节点并加载新节点
+    NEU_IMPORT_PHASE_VERIFY,    ///< 插件校验点位与设置
+    NEU_IMPORT_PHASE_SUBSCRIBE, ///< 建立订阅
+    NEU_IMPORT_PHASE_ROLLBACK,  ///< 恢复导入前的配置
+    NEU_IMPORT_PHASE_DONE,
+    NEU_IMPORT_PHASE_FAILED,
+} neu_import_phase_e;
+
+/**
+ * @brief 最近一次批量导入的进度。
+ *
+ * 导入在管理器线程中同步执行，其它线程通过 neu_import_get_progress 读取。
+ */
+typedef struct {
+    neu_import_phase_e phase;
+    bool               dry_run;
+    uint64_t           total;   ///< 当前阶段的条目数
+    uint64_t           done;    ///< 当前阶段已完成的条目数
+    int                error;   ///< 失败时的错误码
+    int64_t            start;   ///< 开始时间，毫秒
+    int64_t            elapsed; ///< 已用时间，毫秒
+} neu_import_progress_t;
+
+void        neu_import_get_progress(neu_import_progress_t *progress);
+const char *neu_import_phase_str(neu_import_phase_e phase);
+
+#endif
@@ -17,6 +17,7 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  **/
 #include <errno.h>
+#include <inttypes.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/stat.h>
@@ -28,7 +29,6 @@
 
 #include "event/event.h"
 #include "persist/persist.h"
-#include "utils/base64.h"
 #include "utils/http.h"
 #include "utils/log.h"
 #include "utils/time.h"
@@ -66,7 +66,6 @@ inline static void forward_msg_copy(neu_manager_t *     manager,
 inline static void notify_monitor(neu_manager_t *    manager,
                                   neu_reqresp_type_e event, void *data);
 static void start_static_adapter(neu_manager_t *manager, const char *name);
-static int  update_timestamp(void *usr_data);
 static void start_single_adapter(neu_manager_t *manager, const char *name,
                                  const char *plugin_name, bool display);
 
@@ -79,7 +78,7 @@ static bool  mv_tmp_schema_file(neu_plugin_kind_e kind, const char *tmp_path,
 /**
  * @brief 获取并递增端口号。
  *
- * 此函数用于从静态变量中获取一个端口号，并在每次调用时将其递增。初始值为10000。
+ * 此函数用于从静态变量中获取一个端口号，并在每次调用时将其原子递增。初始值为10000。
  * 
  * @warning
  * 此函数不检查端口是否已被占用或是否超出有效范围。
@@ -89,16 +88,16 @@ static bool  mv_tmp_schema_file(neu_plugin_kind_e kind, const char *tmp_path,
 uint16_t neu_manager_get_port()
 {
     static uint16_t port = 10000;
-    return port++;
+    // 启动时多个线程并行创建节点，需原子递增
+    return __atomic_fetch_add(&port, 1, __ATOMIC_RELAXED);
 }
 
 /**
  * @brief 创建并初始化一个 neu_manager 实例。
  *
  * 该函数负责创建和初始化一个 neu_manager 实例，并设置其事件循环、插件管理器、
- * 节点管理器等关键组件。它还配置了一个 Unix 域套接字用于进程间通信，并启动定
- * 时器来更新时间戳。如果任何步骤失败，则会记录警告或错误日志，并可能终止程序执
- * 行（通过 assert）。
+ * 节点管理器等关键组件。它还配置了一个 Unix 域套接字用于进程间通信。如果任何步
+ * 骤失败，则会记录警告或错误日志，并可能终止程序执行（通过 assert）。
  *
  * @return 
  * - neu_manager_t* 成功时返回指向新创建的 neu_manager 实例的指针；
@@ -119,13 +118,6 @@ neu_manager_t *neu_manager_create()
         .cb       = manager_loop,
     };
 
-    neu_event_timer_param_t timestamp_timer_param = {
-        .second      = 0,
-        .millisecond = 10,
-        .cb          = update_timestamp,
-        .type        = NEU_EVENT_TIMER_NOBLOCK,
-    };
-
     // 初始化 manager 的各个组件
 
     // 创建事件管理组件
@@ -190,6 +182,10 @@ neu_manager_t *neu_manager_create()
     // 设置全局状态为 "loading"
     strncpy(g_status, "loading", sizeof(g_status));
 
+    // 启动各阶段耗时，毫秒
+    int64_t ts[6] = { 0 };
+    ts[0]         = neu_time_mono_ns();
+
     // 初始化指标和静态适配器
     neu_metrics_init();
 
@@ -197,10 +193,12 @@ neu_manager_t *neu_manager_create()
     start_static_adapter(manager, DEFAULT_DASHBOARD_PLUGIN_NAME);
 
     // 加载插件
+    ts[1] = neu_time_mono_ns();
     if (manager_load_plugin(manager) != 0) {
         nlog_warn("load plugin error");
     }
 
+    ts[2] = neu_time_mono_ns();
     UT_array *single_plugins =
         neu_plugin_manager_get_single(manager->plugin_manager);
 
@@ -212,18 +210,25 @@ neu_manager_t *neu_manager_create()
     utarray_free(single_plugins);
 
     // 加载节点
+    ts[3] = neu_time_mono_ns();
     manager_load_node(manager);
+    ts[4] = neu_time_mono_ns();
     while (neu_node_manager_exist_uninit(manager->node_manager)) {
         usleep(1000 * 100);
     }
 
     // 加载订阅信息
+    ts[5] = neu_time_mono_ns();
     manager_load_subscribe(manager);
 
-    // 添加定时器事件以更新时间戳
-    timestamp_timer_param.usr_data = (void *) manager;
-    manager->timer_timestamp =
-        neu_event_add_timer(manager->events, timestamp_timer_param);
+    nlog_notice("startup static: %" PRId64 " ms, plugins: %" PRId64
+                " ms, single: %" PRId64 " ms, nodes: %" PRId64
+                " ms, nodes init: %" PRId64 " ms, subscribe: %" PRId64
+                " ms",
+                (ts[1] - ts[0]) / 1000000, (ts[2] - ts[1]) / 1000000,
+                (ts[3] - ts[2]) / 1000000, (ts[4] - ts[3]) / 1000000,
+                (ts[5] - ts[4]) / 1000000,
+                (neu_time_mono_ns() - ts[5]) / 1000000);
 
     strncpy(g_status, "ready", sizeof(g_status));
     nlog_notice("manager start");
@@ -259,10 +264,7 @@ void neu_manager_destroy(neu_manager_t *manager)
     // 步骤1：获取所有已注册节点的UNIX域套接字地址
     UT_array *addrs = neu_node_manager_get_addrs_all(manager->node_manager);
 
-    // 步骤2：移除定时器事件（停止周期任务）
-    neu_event_del_timer(manager->events, manager->timer_timestamp);
-
-    // 步骤3：向所有节点发送卸载请求
+    // 步骤2：向所有节点发送卸载请求
     utarray_foreach(addrs, struct sockaddr_un *, addr)
     {
         // 构造节点卸载请求消息（NEU_REQ_NODE_UNINIT类型）
@@ -286,7 +288,7 @@ void neu_manager_destroy(neu_manager_t *manager)
     // 释放地址数组内存
     utarray_free(addrs);
 
-    // 步骤4：等待所有节点卸载完成（仅当消息全部发送成功时）
+    // 步骤3：等待所有节点卸载完成（仅当消息全部发送成功时）
     if (send_msg_success) {
         while (1) {
             usleep(1000 * 100);
@@ -296,17 +298,17 @@ void neu_manager_destroy(neu_manager_t *manager)
         }
     }
 
-    // 步骤5：销毁子模块
+    // 步骤4：销毁子模块
     neu_subscribe_manager_destroy(manager->subscribe_manager);  // 销毁订阅管理
     neu_node_manager_destroy(manager->node_manager);            // 销毁节点管理 
     neu_plugin_manager_destroy(manager->plugin_manager);        // 销毁插件管理
 
-    // 步骤6：关闭网络连接
+    // 步骤5：关闭网络连接
     close(manager->server_fd);                          // 关闭服务端socket
     neu_event_del_io(manager->events, manager->loop);   // 移除epoll监听
     neu_event_close(manager->events);                   // 关闭事件循环实例
 
-    // 步骤7：释放管理器本体内存
+    // 步骤6：释放管理器本体内存
     free(manager);
     nlog_notice("manager exit");
 }
@@ -347,6 +349,10 @@ static int manager_loop(enum neu_event_io_type type, int fd, void *usr_data)
     header          = neu_msg_get_header(msg);
     header->monitor = neu_node_manager_find(manager->node_manager, "monitor");
 
+    // 接管请求已入队的持久化命令，处理期间入队的命令也记在其上
+    neu_persister_track_begin(header->persist_ticket);
+    header->persist_ticket = NULL;
+
     nlog_info("manager recv msg from: %s to %s, type: %s, monitor: %d",
               header->sender, header->receiver,
               neu_reqresp_type_string(header->type), header->monitor);
@@ -1543,6 +1549,19 @@ static int manager_loop(enum neu_event_io_type type, int fd, void *usr_data)
         break;
     }
 
+    case NEU_REQ_IMPORT_CONFIG: {
+        neu_req_import_config_t *cmd = (neu_req_import_config_t *) &header[1];
+        neu_resp_import_config_t resp = { 0 };
+
+        neu_manager_import_config(manager, cmd, &resp);
+
+        neu_req_import_config_fini(cmd);
+        header->type = NEU_RESP_IMPORT_CONFIG;
+        strcpy(header->receiver, header->sender);
+        reply(manager, header, &resp);
+        break;
+    }
+
     case NEU_REQ_UPDATE_LOG_LEVEL: {
         neu_req_update_log_level_t *cmd =
             (neu_req_update_log_level_t *) &header[1];
@@ -1605,6 +1624,7 @@ static int manager_loop(enum neu_event_io_type type, int fd, void *usr_data)
         break;
     }
 
+    neu_persister_track_end();
     return 0;
 }
 
@@ -1613,7 +1633,8 @@ inline static void forward_msg_copy(neu_manager_t *     manager,
                                     const char *        node)
 {
     neu_msg_t *msg = neu_msg_copy((neu_msg_t *) header);
-    forward_msg(manager, neu_msg_get_header(msg), node);
+    // 副本只是通知，请求的持久化命令仍随原消息应答
+    send_to_node(manager, neu_msg_get_header(msg), node);
 }
 
 /**
@@ -1714,6 +1735,9 @@ static void start_single_adapter(neu_manager_t *manager, const char *name,
 inline static void reply(neu_manager_t *manager, neu_reqresp_head_t *header,
                          void *data)
 {
+    if (NULL != header->ctx) {
+        header->persist_ticket = neu_persister_track_take();
+    }
     neu_msg_gen(header, data);
     struct sockaddr_un addr =
         neu_node_manager_get_addr(manager->node_manager, header->receiver);
@@ -1735,38 +1759,16 @@ inline static void reply(neu_manager_t *manager, neu_reqresp_head_t *header,
     }
 }
 
-static int update_timestamp(void *usr_data)
-{
-    (void) usr_data;
-    global_timestamp = neu_time_ms();
-    return 0;
-}
-
 static char *file_save_tmp(const char *data, const char *suffix)
 {
-    int   d_len = 0;
-    char *file  = (char *) neu_decode64(&d_len, data);
-
-    if (file == NULL) {
-        nlog_warn("library so file decode64 ret is NULL");
-        return NULL;
-    }
-
-    if (d_len == 0) {
-        nlog_warn("library so file decode64 len is 0");
-        free(file);
-        return NULL;
-    }
-
-    char *tmp_path = neu_persister_save_file_tmp(file, d_len, suffix);
+    // 插件库文件可能较大，直接解码写入临时文件
+    char *tmp_path = neu_persister_save_file_tmp_decode64(data, suffix);
 
     if (tmp_path == NULL) {
-        free(file);
+        nlog_warn("library %s file decode64 fail", suffix);
         return NULL;
     }
 
-    free(file);
-
     return tmp_path;
 }
 
@@ -17,8 +17,12 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  **/
 #include <dlfcn.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <unistd.h>
 
 #include "utils/log.h"
+#include "utils/time.h"
 #include "json/neu_json_param.h"
 
 #include "adapter.h"
@@ -143,6 +147,183 @@ int neu_manager_add_node(neu_manager_t *manager, const char *node_name,
     return NEU_ERR_SUCCESS;
 }
 
+/**
+ * @brief 启动时待创建的节点，prepare 阶段串行填写，create 阶段可在工作线程中
+ * 执行，init 阶段回到调用线程按原始顺序处理。
+ */
+typedef struct {
+    neu_persist_node_info_t *node_info;
+    neu_adapter_info_t       adapter_info;
+    neu_adapter_t *          adapter;
+    int                      error;
+    bool                     parallel;
+} load_node_job_t;
+
+typedef struct {
+    load_node_job_t *jobs;
+    int              n_job;
+    int              next;
+} load_node_ctx_t;
+
+static void load_node_create(load_node_job_t *job)
+{
+    job->adapter = neu_adapter_create(&job->adapter_info, true);
+    if (job->adapter == NULL) {
+        // 错误码是线程局部的，必须在创建所在线程中读取
+        job->error = neu_adapter_error();
+    }
+}
+
+static void *load_node_worker(void *arg)
+{
+    load_node_ctx_t *ctx = (load_node_ctx_t *) arg;
+
+    while (true) {
+        int i = __atomic_fetch_add(&ctx->next, 1, __ATOMIC_RELAXED);
+        if (i >= ctx->n_job) {
+            break;
+        }
+
+        if (ctx->jobs[i].parallel) {
+            load_node_create(&ctx->jobs[i]);
+        }
+    }
+
+    return NULL;
+}
+
+static int load_node_prepare(neu_manager_t *manager, load_node_job_t *job)
+{
+    neu_resp_plugin_info_t info     = { 0 };
+    neu_plugin_instance_t  instance = { 0 };
+
+    if (0 !=
+        neu_plugin_manager_find(manager->plugin_manager,
+                                job->node_info->plugin_name, &info)) {
+        return NEU_ERR_LIBRARY_NOT_FOUND;
+    }
+
+    if (info.single) {
+        return NEU_ERR_LIBRARY_NOT_ALLOW_CREATE_INSTANCE;
+    }
+
+    if (NULL != neu_node_manager_find(manager->node_manager,
+                                      job->node_info->name)) {
+        return NEU_ERR_NODE_EXIST;
+    }
+
+    if (0 !=
+        neu_plugin_manager_create_instance(manager->plugin_manager, info.name,
+                                           &instance)) {
+        return NEU_ERR_LIBRARY_FAILED_TO_OPEN;
+    }
+
+    job->adapter_info.name   = job->node_info->name;
+    job->adapter_info.handle = instance.handle;
+    job->adapter_info.module = instance.module;
+    job->parallel            = instance.module->type == NEU_NA_TYPE_DRIVER;
+
+    return NEU_ERR_SUCCESS;
+}
+
+/**
+ * @brief 按持久化的节点信息批量创建节点。
+ *
+ * 插件查找与实例化串行进行；驱动节点彼此独立，其构造（打开插件、加载配置、
+ * 组与点位）由至多 NEU_MANAGER_LOAD_THREADS_MAX 个线程并行完成；应用节点
+ * 仍在调用线程中串行创建。全部构造完成后按原始顺序加入节点管理器并初始化，
+ * 与逐个调用 neu_manager_add_node 的结果一致。
+ *
+ * @return 最后一个节点的创建结果。
+ */
+int neu_manager_load_nodes(neu_manager_t *manager, UT_array *node_infos)
+{
+    int             rv         = 0;
+    int             n_parallel = 0;
+    int             n_thread   = 0;
+    int64_t         start      = neu_time_mono_ns();
+    int64_t         prepared   = 0;
+    int64_t         created    = 0;
+    load_node_ctx_t ctx        = {
+        .n_job = utarray_len(node_infos),
+    };
+
+    if (ctx.n_job == 0) {
+        return 0;
+    }
+
+    ctx.jobs = calloc(ctx.n_job, sizeof(load_node_job_t));
+
+    for (int i = 0; i < ctx.n_job; i++) {
+        load_node_job_t *job = &ctx.jobs[i];
+
+        job->node_info =
+            (neu_persist_node_info_t *) utarray_eltptr(node_infos, (unsigned) i);
+        job->error = load_node_prepare(manager, job);
+        if (job->error == NEU_ERR_SUCCESS) {
+            if (job->parallel) {
+                n_parallel += 1;
+            } else {
+                load_node_create(job);
+            }
+        }
+    }
+    prepared = neu_time_mono_ns();
+
+    n_thread = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (n_thread > NEU_MANAGER_LOAD_THREADS_MAX) {
+        n_thread = NEU_MANAGER_LOAD_THREADS_MAX;
+    }
+    if (n_thread > n_parallel) {
+        n_thread = n_parallel;
+    }
+
+    if (n_thread <= 1) {
+        load_node_worker(&ctx);
+    } else {
+        pthread_t *tids = calloc(n_thread, sizeof(pthread_t));
+        int        n    = 0;
+
+        for (; n < n_thread; n++) {
+            if (0 != pthread_create(&tids[n], NULL, load_node_worker, &ctx)) {
+                break;
+            }
+        }
+        // 线程创建失败时由调用线程补位，剩余任务不会遗漏
+        load_node_worker(&ctx);
+        for (int i = 0; i < n; i++) {
+            pthread_join(tids[i], NULL);
+        }
+        free(tids);
+    }
+    created = neu_time_mono_ns();
+
+    for (int i = 0; i < ctx.n_job; i++) {
+        load_node_job_t *job = &ctx.jobs[i];
+
+        if (job->adapter != NULL) {
+            neu_node_manager_add(manager->node_manager, job->adapter);
+            neu_adapter_init(job->adapter, job->node_info->state);
+        }
+
+        rv                    = job->adapter != NULL ? NEU_ERR_SUCCESS
+                                                     : job->error;
+        const char *ok_or_err = (0 == rv) ? "success" : "fail";
+        nlog_notice("load adapter %s type:%d, name:%s plugin:%s state:%d",
+                    ok_or_err, job->node_info->type, job->node_info->name,
+                    job->node_info->plugin_name, job->node_info->state);
+    }
+
+    nlog_notice("load nodes: %d, parallel: %d, threads: %d, prepare: %" PRId64
+                " ms, create: %" PRId64 " ms, init: %" PRId64 " ms",
+                ctx.n_job, n_parallel, n_thread, (prepared - start) / 1000000,
+                (created - prepared) / 1000000,
+                (neu_time_mono_ns() - created) / 1000000);
+
+    free(ctx.jobs);
+    return rv;
+}
+
 int neu_manager_del_node(neu_manager_t *manager, const char *node_name)
 {
     neu_adapter_t *adapter =
@@ -509,7 +690,10 @@ int neu_manager_get_node_info(neu_manager_t *manager, const char *name,
     return -1;
 }
 
-static int del_node(neu_manager_t *manager, const char *node)
+/**
+ * @brief 取消节点的订阅、通知相关应用并销毁节点，不修改持久化存储。
+ */
+int neu_manager_remove_node(neu_manager_t *manager, const char *node)
 {
     neu_adapter_t *adapter = neu_node_manager_find(manager->node_manager, node);
     if (NULL == adapter) {
@@ -563,10 +747,20 @@ static int del_node(neu_manager_t *manager, const char *node)
 
     neu_adapter_uninit(adapter);
     neu_manager_del_node(manager, node);
-    manager_storage_del_node(manager, node);
     return 0;
 }
 
+static int del_node(neu_manager_t *manager, const char *node)
+{
+    bool exist = NULL != neu_node_manager_find(manager->node_manager, node);
+    int  ret   = neu_manager_remove_node(manager, node);
+
+    if (0 == ret && exist) {
+        manager_storage_del_node(manager, node);
+    }
+    return ret;
+}
+
 static inline int add_driver(neu_manager_t *manager, neu_req_driver_t *driver)
 {
     int ret = del_node(manager, driver->node);
@@ -30,6 +30,9 @@
 #include "subscribe.h"
 #include "utils/log.h"
 
+/** 启动时并行构造驱动节点的最大线程数 */
+#define NEU_MANAGER_LOAD_THREADS_MAX 16
+
 /**
  * @brief neu_manager 结构体用于管理和协调多个子系统，如插件管理器、节点管理器和事件循环。
  *
@@ -37,7 +40,6 @@
  * 事件循环 (`events`, `loop`)，用于处理异步事件；
  * 插件管理器 (`plugin_manager`)、节点管理器 (`node_manager`) 
  * 和订阅管理器 (`subscribe_manager`)，用于管理不同的功能模块；
- * 定时器 (`timer_timestamp`)，用于定期更新时间戳；
  * 时间戳级别管理器 (`timestamp_lev_manager`)，用于记录时间戳级别的信息；
  * 日志级别 (`log_level`)，用于设置日志输出的详细程度。
  */
@@ -85,21 +87,6 @@ typedef struct neu_manager {
      */
     neu_event_io_t *loop;        
     
-    /**
-     * @brief neu_manager的定时器对象，用于定期更新时间戳。
-     *
-     * 处理定时器事件，通过设置定时器来定期触发特定的操作。它为系统提供了时间驱动的事件机制，
-     * 确保某些任务能够按照预定的时间间隔执行。
-     * 
-     * @note
-     *  - 定时器设置：允许用户设置定时器的触发时间和周期，例如设置每隔一段时间更新一次时间戳。
-     *  - 时间监测：不断监测时间的流逝，当定时器到达设定的触发时间时，生成定时器事件并将其传
-     *            递给 events
-     *  - 周期性任务执行：对于周期性的定时器事件，timer_timestamp 会在每次触发后重新设置
-     *                 定时器，确保任务能够持续按照预定的周期执行。
-     */
-    neu_event_timer_t *timer_timestamp;
-
     /**
      * @brief 插件管理器，用于加载、管理和卸载插件。
      *
@@ -144,7 +131,9 @@ UT_array *neu_manager_get_plugins(neu_manager_t *manager);
 int       neu_manager_add_node(neu_manager_t *manager, const char *node_name,
                                const char *plugin_name, const char *setting,
                                neu_node_running_state_e state, bool load);
+int       neu_manager_load_nodes(neu_manager_t *manager, UT_array *node_infos);
 int       neu_manager_del_node(neu_manager_t *manager, const char *node_name);
+int       neu_manager_remove_node(neu_manager_t *manager, const char *node);
 UT_array *neu_manager_get_nodes(neu_manager_t *manager, int type,
                                 const char *plugin, const char *node,
                                 bool sort_delay, bool q_state, int state,
@@ -180,9 +169,12 @@ int neu_manager_get_node_info(neu_manager_t *manager, const char *name,
 
 int neu_manager_add_drivers(neu_manager_t *         manager,
                             neu_req_driver_array_t *req);
+int neu_manager_import_config(neu_manager_t *           manager,
+                              neu_req_import_config_t * req,
+                              neu_resp_import_config_t *resp);
 
-inline static void forward_msg(neu_manager_t *     manager,
-                               neu_reqresp_head_t *header, const char *node)
+inline static void send_to_node(neu_manager_t *     manager,
+                                neu_reqresp_head_t *header, const char *node)
 {
     struct sockaddr_un addr =
         neu_node_manager_get_addr(manager->node_manager, node);
@@ -203,4 +195,14 @@ inline static void forward_msg(neu_manager_t *     manager,
     }
 }
 
+inline static void forward_msg(neu_manager_t *     manager,
+                               neu_reqresp_head_t *header, const char *node)
+{
+    if (NULL != header->ctx) {
+        // 请求已入队的持久化命令随消息交给下一个处理者
+        header->persist_ticket = neu_persister_track_take();
+    }
+    send_to_node(manager, header, node);
+}
+
 #endif
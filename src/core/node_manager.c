@@ -358,7 +358,7 @@ UT_array *neu_node_manager_filter(neu_node_manager_t *mgr, int type,
                         HASH_FIND_STR(el->adapter->metrics->entries,
                                       NEU_METRIC_LAST_RTT_MS, e);
                     }
-                    info.delay = NULL != e ? e->value : 0;
+                    info.delay = NULL != e ? neu_metric_entry_value(e) : 0;
                 } else {
                     info.delay = 0;
                 }
@@ -546,7 +546,7 @@ UT_array *neu_node_manager_get_state(neu_node_manager_t *mgr)
                 HASH_FIND_STR(el->adapter->metrics->entries,
                               NEU_METRIC_LAST_RTT_MS, e);
             }
-            state.rtt = NULL != e ? e->value : 0;
+            state.rtt = NULL != e ? neu_metric_entry_value(e) : 0;
 
             utarray_push_back(states, &state);
         }
@@ -180,16 +180,8 @@ int manager_load_node(neu_manager_t *manager)
         return -1;
     }
 
-    utarray_foreach(node_infos, neu_persist_node_info_t *, node_info)
-    {
-        rv                    = neu_manager_add_node(manager, node_info->name,
-                                  node_info->plugin_name, NULL,
-                                  node_info->state, true);
-        const char *ok_or_err = (0 == rv) ? "success" : "fail";
-        nlog_notice("load adapter %s type:%d, name:%s plugin:%s state:%d",
-                    ok_or_err, node_info->type, node_info->name,
-                    node_info->plugin_name, node_info->state);
-    }
+    // 驱动节点并行构造，结果与逐个添加一致
+    rv = neu_manager_load_nodes(manager, node_infos);
 
     // 释放存储节点信息的数组
     utarray_free(node_infos);
@@ -28,9 +28,11 @@
 
 #include "event/event.h"
 #include "utils/log.h"
+#include "utils/time.h"
 
 #ifdef NEU_PLATFORM_LINUX
 #include <sys/epoll.h>
+#include <sys/eventfd.h>
 #include <sys/timerfd.h>
 
 /**
@@ -86,6 +88,16 @@ typedef struct neu_event_timer {
      * 当设置为 true 时，定时器将停止运行。
      */
     bool stop;
+
+    /**
+     * @brief 定时器周期（纳秒）。
+     */
+    int64_t interval;
+
+    /**
+     * @brief 下一次应到期的单调时钟时间（纳秒），用于统计定时器触发延迟。
+     */
+    int64_t deadline;
 } neu_event_timer_t;
 
 /**
@@ -155,10 +167,12 @@ typedef struct event_data {
      *
      * - TIMER: 定时器事件。
      * - IO: I/O 事件。
+     * - WAKE: 共享循环内部的唤醒事件，不对外暴露。
      */
     enum {
         TIMER = 0,  ///< 定时器事件
         IO    = 1,  ///< I/O 事件
+        WAKE  = 2,  ///< 唤醒事件
     } type;
 
     /**
@@ -214,6 +228,12 @@ typedef struct event_data {
 
 #define EVENT_SIZE 1400
 
+/** 共享事件循环承载多个节点，事件槽位数相应放大 */
+#define EVENT_POOL_SIZE 8192
+
+/** 事件循环利用率与定时器延迟的统计周期（纳秒） */
+#define EVENT_STATS_WINDOW (1000 * 1000 * 1000LL)
+
 /**
  * @brief 管理和处理事件的核心结构体。
  *
@@ -258,14 +278,79 @@ typedef struct neu_events {
      */
     int n_event;
 
+    /**
+     * @brief 事件数据数组容量，独占循环为 EVENT_SIZE，共享循环为 EVENT_POOL_SIZE。
+     */
+    int capacity;
+
     /**
      * @brief 事件数据数组，用于存储和管理注册的事件。
      *
      * 每个元素代表一个事件，包含与该事件相关的所有必要信息（如回调函数、用户数据等）。
+     * 数组创建后不再扩容，定时器和 I/O 句柄直接指向其中的元素。
+     */
+    struct event_data *event_datas;
+
+    /**
+     * @brief 是否为共享事件循环池中的循环。
+     *
+     * 共享循环由多个节点使用，neu_event_close 只归还引用，不停止线程。
+     */
+    bool shared;
+
+    /**
+     * @brief 使用该共享循环的节点数，受事件循环池的锁保护。
+     */
+    uint32_t users;
+
+    /**
+     * @brief 分发序号，每分发完一个事件加一。
+     *
+     * 节点归还共享循环时据此等待正在执行的回调返回，保证归还后不再有该节点的
+     * 回调在循环线程上运行，与独占循环关闭时 pthread_join 的语义一致。
+     */
+    uint64_t seq;
+
+    /**
+     * @brief 共享循环的唤醒 eventfd 及其事件数据，归还循环时用于打断 epoll_wait。
+     */
+    int               wake_fd;
+    struct event_data wake;
+
+    /**
+     * @brief 统计周期内的累计数据，仅由循环线程读写。
+     */
+    int64_t  window_start;
+    int64_t  window_busy;
+    int64_t  window_lag_max;
+    int64_t  window_lag_sum;
+    uint64_t window_lag_n;
+
+    /**
+     * @brief 上一个统计周期的结果及累计分发次数，由循环线程原子写入，其他线程随时读取。
      */
-    struct event_data event_datas[EVENT_SIZE];
+    uint32_t busy_percent;
+    uint64_t lag_max_us;
+    uint64_t lag_avg_us;
+    uint64_t dispatched;
 } neu_events_t;
 
+/**
+ * @brief 共享事件循环池。
+ *
+ * 节点默认从池中取用当前使用者最少的循环，池在第一次取用时启动。
+ */
+static struct {
+    pthread_mutex_t mtx;
+    int             n_loop;
+    neu_events_t ** loops;
+} event_pool = {
+    .mtx = PTHREAD_MUTEX_INITIALIZER,
+};
+
+/** 当前线程运行的事件循环，非事件循环线程为 NULL */
+static __thread neu_events_t *current_events = NULL;
+
 /**
  * @brief 获取一个空闲的事件索引。
  *
@@ -278,7 +363,7 @@ typedef struct neu_events {
  *
  * @note 
  * - 此函数在访问共享资源时使用了互斥锁来确保线程安全。
- * - EVENT_SIZE 应当是一个宏或常量，定义了事件数据数组的最大大小。
+ * - events->capacity 为事件数据数组的大小，由循环类型决定。
  */
 static int get_free_event(neu_events_t *events)
 {
@@ -288,11 +373,12 @@ static int get_free_event(neu_events_t *events)
     pthread_mutex_lock(&events->mtx);
 
     // 遍历所有事件数据，寻找第一个未被使用的事件
-    for (int i = 0; i < EVENT_SIZE; i++) {
+    for (int i = 0; i < events->capacity; i++) {
         if (events->event_datas[i].use == false) {
             events->event_datas[i].use   = true;
             events->event_datas[i].index = i;
             ret                          = i;
+            events->n_event += 1;
             break;
         }
     }
@@ -327,11 +413,67 @@ static void free_event(neu_events_t *events, int index)
 
     // 重置其索引值为 0
     events->event_datas[index].index = 0;
+    events->n_event -= 1;
 
     // 解锁互斥锁
     pthread_mutex_unlock(&events->mtx);
 }
 
+/**
+ * @brief 结束一个统计周期：发布上一周期的利用率与定时器延迟并清零累计值。
+ *
+ * 仅由循环线程调用，周期不足 EVENT_STATS_WINDOW 时直接返回。
+ */
+static void event_stats_window(neu_events_t *events, int64_t now)
+{
+    int64_t elapsed = now - events->window_start;
+
+    if (elapsed < EVENT_STATS_WINDOW) {
+        return;
+    }
+
+    __atomic_store_n(&events->busy_percent,
+                     (uint32_t)(events->window_busy * 100 / elapsed),
+                     __ATOMIC_RELAXED);
+    __atomic_store_n(&events->lag_max_us, events->window_lag_max / 1000,
+                     __ATOMIC_RELAXED);
+    __atomic_store_n(&events->lag_avg_us,
+                     events->window_lag_n > 0
+                         ? events->window_lag_sum / events->window_lag_n / 1000
+                         : 0,
+                     __ATOMIC_RELAXED);
+
+    events->window_start   = now;
+    events->window_busy    = 0;
+    events->window_lag_max = 0;
+    events->window_lag_sum = 0;
+    events->window_lag_n   = 0;
+}
+
+/**
+ * @brief 记录一次定时器触发相对应到期时间的延迟，并推进下一次到期时间。
+ *
+ * 延迟包含 epoll 就绪后排在同一循环中其他回调之后等待的时间，
+ * 是衡量共享循环是否过载的主要指标。
+ */
+static void event_timer_lag(neu_events_t *events, neu_event_timer_t *timer,
+                            int64_t now, uint64_t expirations)
+{
+    int64_t lag = now - timer->deadline;
+
+    if (lag < 0) {
+        lag = 0;
+    }
+
+    if (lag > events->window_lag_max) {
+        events->window_lag_max = lag;
+    }
+    events->window_lag_sum += lag;
+    events->window_lag_n += 1;
+
+    timer->deadline += timer->interval * (int64_t) expirations;
+}
+
 /**
  * @brief 事件循环线程的主函数。
  *
@@ -353,6 +495,9 @@ static void *event_loop(void *arg)
     neu_events_t *events   = (neu_events_t *) arg;
     int           epoll_fd = events->epoll_fd;
 
+    current_events       = events;
+    events->window_start = neu_time_mono_ns();
+
     // 主循环，持续运行直到 stop 标志被设置为 true
     while (!events->stop) {
         struct epoll_event event = { 0 };
@@ -361,6 +506,7 @@ static void *event_loop(void *arg)
         // 等待事件发生，超时时间为 1000 毫秒
         int ret = epoll_wait(epoll_fd, &event, 1, 1000);
         if (ret == 0) {
+            event_stats_window(events, neu_time_mono_ns());
             continue;
         }
 
@@ -379,6 +525,8 @@ static void *event_loop(void *arg)
         // 获取事件数据
         data = (struct event_data *) event.data.ptr;
 
+        int64_t start = neu_time_mono_ns();
+
         switch (data->type) {
         case TIMER:
             // 锁定定时器相关的互斥锁，确保线程安全
@@ -386,12 +534,13 @@ static void *event_loop(void *arg)
 
             // 检查事件是否包含 EPOLLIN 标志（即定时器到期）
             if ((event.events & EPOLLIN) == EPOLLIN) {
-                uint64_t t;
+                uint64_t t = 0;
 
                 // 从定时器文件描述符读取触发次数
                 ssize_t size = read(data->fd, &t, sizeof(t));
-                // 忽略返回值，因为已经确认了 EPOLLIN 事件
-                (void) size; 
+                if (size == sizeof(t)) {
+                    event_timer_lag(events, &data->ctx.timer, start, t);
+                }
 
                 // 如果定时器未被停止
                 if (!data->ctx.timer.stop) {
@@ -406,6 +555,8 @@ static void *event_loop(void *arg)
                         // 重设定时器的时间间隔
                         timerfd_settime(data->fd, 0, &data->ctx.timer.value,
                                         NULL);
+                        data->ctx.timer.deadline =
+                            neu_time_mono_ns() + data->ctx.timer.interval;
                         
                         // 将定时器文件描述符重新添加到 epoll 实例中
                         epoll_ctl(epoll_fd, EPOLL_CTL_ADD, data->fd, &event);
@@ -443,27 +594,27 @@ static void *event_loop(void *arg)
             }
 
             break;
+        case WAKE: {
+            uint64_t t    = 0;
+            ssize_t  size = read(data->fd, &t, sizeof(t));
+            (void) size;
+            break;
+        }
         }
+
+        int64_t end = neu_time_mono_ns();
+
+        events->window_busy += end - start;
+        __atomic_fetch_add(&events->dispatched, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&events->seq, 1, __ATOMIC_RELEASE);
+
+        event_stats_window(events, end);
     }
 
     return NULL;
 };
 
-/**
- * @brief 创建并初始化一个新的事件管理器实例。
- *
- * 该函数分配内存并初始化一个 neu_events_t 结构体实例，创建一个 epoll 文件描述符，
- * 并启动一个后台线程来处理事件循环。
- *
- * @return 返回一个指向新创建的 neu_events_t 实例的指针。
- *         如果内存分配失败或 epoll 文件描述符创建失败，则程序将终止（通过 assert）。
- *
- * @note 
- * - 此函数使用 calloc 分配内存，并确保所有字段都被初始化为零。
- * - epoll_create(1) 用于创建一个新的 epoll 实例。参数 '1' 是提示内核分配的大小，但实际大小是动态调整的。
- * - 该函数还初始化了一个互斥锁和一个后台线程，用于处理事件循环。
- */
-neu_events_t *neu_event_new(void)
+static neu_events_t *event_new(int capacity, bool shared)
 {
     // 分配内存并初始化 neu_events_t 结构体
     neu_events_t *events = calloc(1, sizeof(struct neu_events));
@@ -472,51 +623,253 @@ neu_events_t *neu_event_new(void)
     events->epoll_fd = epoll_create(1);
 
     // 记录日志并断言确保 epoll 文件描述符有效
-    nlog_notice("create epoll: %d(%d)", events->epoll_fd, errno);
+    nlog_notice("create epoll: %d(%d), shared: %d", events->epoll_fd, errno,
+                shared);
     assert(events->epoll_fd > 0);
 
     // 初始化其他字段
-    events->stop    = false;
-    events->n_event = 0;
+    events->stop        = false;
+    events->n_event     = 0;
+    events->capacity    = capacity;
+    events->event_datas = calloc(capacity, sizeof(struct event_data));
+    events->shared      = shared;
+    events->wake_fd     = -1;
     pthread_mutex_init(&events->mtx, NULL);
 
+    if (shared) {
+        struct epoll_event event = {
+            .events   = EPOLLIN,
+            .data.ptr = &events->wake,
+        };
+
+        events->wake_fd   = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        events->wake.type = WAKE;
+        events->wake.fd   = events->wake_fd;
+        assert(events->wake_fd > 0);
+        epoll_ctl(events->epoll_fd, EPOLL_CTL_ADD, events->wake_fd, &event);
+    }
+
     // 启动后台线程运行事件循环
     pthread_create(&events->thread, NULL, event_loop, events);
 
     return events;
 }
 
+static void event_wake(neu_events_t *events)
+{
+    uint64_t one  = 1;
+    ssize_t  size = write(events->wake_fd, &one, sizeof(one));
+    (void) size;
+}
+
+static void event_free(neu_events_t *events)
+{
+    // 设置停止标志
+    events->stop = true;
+    if (events->shared) {
+        event_wake(events);
+    }
+
+    // 等待后台线程结束
+    pthread_join(events->thread, NULL);
+
+    // 关闭 epoll 文件描述符
+    close(events->epoll_fd);
+    if (events->wake_fd > 0) {
+        close(events->wake_fd);
+    }
+
+    // 销毁互斥锁
+    pthread_mutex_destroy(&events->mtx);
+
+    // 释放分配的内存
+    free(events->event_datas);
+    free(events);
+}
+
+/**
+ * @brief 等待共享循环上正在执行的回调返回。
+ *
+ * 调用前节点已把自己的 fd 从 epoll 中删除，此后循环不会再取到这些 fd 的事件；
+ * 唤醒循环后等到分发序号变化，即可确认删除前已取到的事件（若有）处理完毕。
+ * 删除节点时 neu_event_close 通常在管理器的循环线程上调用，也需要等待；
+ * 只有在被归还的循环自身上调用时不等待，此时不可能有其他回调正在执行。
+ * 节点的删除由管理器串行处理，不会出现两个循环互相等待。
+ */
+static void event_quiesce(neu_events_t *events)
+{
+    if (current_events == events) {
+        return;
+    }
+
+    uint64_t seq = __atomic_load_n(&events->seq, __ATOMIC_ACQUIRE);
+
+    event_wake(events);
+    while (__atomic_load_n(&events->seq, __ATOMIC_ACQUIRE) == seq &&
+           !events->stop) {
+        struct timespec t = {
+            .tv_sec  = 0,
+            .tv_nsec = 100 * 1000,
+        };
+        nanosleep(&t, NULL);
+    }
+}
+
+/**
+ * @brief 启动事件循环池，调用者需持有池锁。
+ */
+static void event_pool_start(int n_loop)
+{
+    if (n_loop <= 0) {
+        long n = sysconf(_SC_NPROCESSORS_ONLN);
+        n_loop = n > 0 ? (int) n : 1;
+    }
+
+    event_pool.loops = calloc(n_loop, sizeof(neu_events_t *));
+    for (int i = 0; i < n_loop; i++) {
+        event_pool.loops[i] = event_new(EVENT_POOL_SIZE, true);
+    }
+    event_pool.n_loop = n_loop;
+
+    nlog_notice("start event loop pool, loops: %d", n_loop);
+}
+
+static void event_pool_put(neu_events_t *events)
+{
+    pthread_mutex_lock(&event_pool.mtx);
+    assert(events->users > 0);
+    events->users -= 1;
+    pthread_mutex_unlock(&event_pool.mtx);
+
+    event_quiesce(events);
+}
+
+/**
+ * @brief 创建并初始化一个新的事件管理器实例。
+ *
+ * 该函数分配内存并初始化一个 neu_events_t 结构体实例，创建一个 epoll 文件描述符，
+ * 并启动一个后台线程来处理事件循环。
+ *
+ * @return 返回一个指向新创建的 neu_events_t 实例的指针。
+ *         如果内存分配失败或 epoll 文件描述符创建失败，则程序将终止（通过 assert）。
+ */
+neu_events_t *neu_event_new(void)
+{
+    return event_new(EVENT_SIZE, false);
+}
+
 /**
  * @brief 关闭并释放一个事件管理器实例。
  *
- * 该函数设置停止标志，关闭 epoll 文件描述符，等待后台线程结束，销毁互斥锁，并释放分配的内存。
+ * 独占循环：设置停止标志，等待后台线程结束，关闭 epoll 文件描述符并释放内存。
+ * 共享循环：只把循环归还给事件循环池，并等待正在执行的回调返回，线程继续运行。
  *
  * @param events 指向要关闭的 neu_events_t 实例的指针。
  *
  * @return 成功时返回 0。
  *
  * @note 
- * - 此函数确保所有资源都被正确释放，包括关闭 epoll 文件描述符、等待线程结束和销毁互斥锁。
  * - 调用此函数后，`events` 指针将不再有效，不应再对其进行访问。
  */
 int neu_event_close(neu_events_t *events)
 {
-    // 设置停止标志
-    events->stop = true;
+    if (events->shared) {
+        event_pool_put(events);
+    } else {
+        event_free(events);
+    }
 
-    // 关闭 epoll 文件描述符
-    close(events->epoll_fd);
+    return 0;
+}
 
-    // 等待后台线程结束
-    pthread_join(events->thread, NULL);
+int neu_event_pool_init(int n_loop)
+{
+    int ret = 0;
 
-    // 销毁互斥锁
-    pthread_mutex_destroy(&events->mtx);
+    pthread_mutex_lock(&event_pool.mtx);
+    if (event_pool.loops != NULL) {
+        ret = -1;
+    } else {
+        event_pool_start(n_loop);
+    }
+    pthread_mutex_unlock(&event_pool.mtx);
 
-    // 释放分配的内存
-    free(events);
+    return ret;
+}
 
-    return 0;
+void neu_event_pool_fini(void)
+{
+    pthread_mutex_lock(&event_pool.mtx);
+    for (int i = 0; i < event_pool.n_loop; i++) {
+        if (event_pool.loops[i]->users > 0) {
+            nlog_warn("event loop %d still has %" PRIu32 " users", i,
+                      event_pool.loops[i]->users);
+        }
+        event_free(event_pool.loops[i]);
+    }
+    free(event_pool.loops);
+    event_pool.loops  = NULL;
+    event_pool.n_loop = 0;
+    pthread_mutex_unlock(&event_pool.mtx);
+}
+
+neu_events_t *neu_event_pool_get(void)
+{
+    neu_events_t *events = NULL;
+
+    pthread_mutex_lock(&event_pool.mtx);
+    if (event_pool.loops == NULL) {
+        event_pool_start(0);
+    }
+
+    for (int i = 0; i < event_pool.n_loop; i++) {
+        if (events == NULL || event_pool.loops[i]->users < events->users) {
+            events = event_pool.loops[i];
+        }
+    }
+    events->users += 1;
+    pthread_mutex_unlock(&event_pool.mtx);
+
+    return events;
+}
+
+int neu_event_pool_size(void)
+{
+    int n = 0;
+
+    pthread_mutex_lock(&event_pool.mtx);
+    n = event_pool.n_loop;
+    pthread_mutex_unlock(&event_pool.mtx);
+
+    return n;
+}
+
+int neu_event_pool_stats(int index, neu_event_loop_stats_t *stats)
+{
+    int ret = -1;
+
+    pthread_mutex_lock(&event_pool.mtx);
+    if (index >= 0 && index < event_pool.n_loop) {
+        neu_events_t *events = event_pool.loops[index];
+
+        pthread_mutex_lock(&events->mtx);
+        stats->events = events->n_event;
+        pthread_mutex_unlock(&events->mtx);
+
+        stats->users = events->users;
+        stats->busy_percent =
+            __atomic_load_n(&events->busy_percent, __ATOMIC_RELAXED);
+        stats->lag_max_us =
+            __atomic_load_n(&events->lag_max_us, __ATOMIC_RELAXED);
+        stats->lag_avg_us =
+            __atomic_load_n(&events->lag_avg_us, __ATOMIC_RELAXED);
+        stats->dispatched =
+            __atomic_load_n(&events->dispatched, __ATOMIC_RELAXED);
+        ret = 0;
+    }
+    pthread_mutex_unlock(&event_pool.mtx);
+
+    return ret;
 }
 
 /**
@@ -592,6 +945,9 @@ neu_event_timer_t *neu_event_add_timer(neu_events_t *          events,
     timer_ctx->fd    = timer_fd;
     timer_ctx->type  = timer.type;
     timer_ctx->stop  = false;
+    timer_ctx->interval =
+        timer.second * 1000 * 1000 * 1000 + timer.millisecond * 1000 * 1000;
+    timer_ctx->deadline = neu_time_mono_ns() + timer_ctx->interval;
     pthread_mutex_init(&timer_ctx->mtx, NULL);
 
     // 将定时器文件描述符添加到 epoll 实例中
@@ -158,4 +158,30 @@ int neu_event_del_io(neu_events_t *events, neu_event_io_t *io)
     return 0;
 }
 
+// kqueue 实现暂不支持共享事件循环，每次取用都创建独占循环
+int neu_event_pool_init(int n_loop)
+{
+    (void) n_loop;
+    return 0;
+}
+
+void neu_event_pool_fini(void) {}
+
+neu_events_t *neu_event_pool_get(void)
+{
+    return neu_event_new();
+}
+
+int neu_event_pool_size(void)
+{
+    return 0;
+}
+
+int neu_event_pool_stats(int index, neu_event_loop_stats_t *stats)
+{
+    (void) index;
+    (void) stats;
+    return -1;
+}
+
 #endif
@@ -28,6 +28,7 @@
 #include <unistd.h>
 
 #include "core/manager.h"
+#include "event/event.h"
 #include "utils/log.h"
 #include "utils/time.h"
 
@@ -45,8 +46,6 @@ char                  host_port[32]     = { 0 };
 char                  g_status[32]      = { 0 };
 static bool           sig_trigger       = false;
 
-int64_t global_timestamp = 0;
-
 struct {
     struct sockaddr_in addr;
     int                fd;
@@ -60,6 +59,7 @@ static void sig_handler(int sig)
         if (sig == SIGINT || sig == SIGTERM) {
             neu_manager_destroy(g_manager);
             neu_persister_destroy();
+            neu_log_stop();
             zlog_fini();
         }
         sig_trigger = true;
@@ -166,6 +166,11 @@ static int neuron_run(const neu_cli_args_t *args)
     struct rlimit rl = { 0 };
     int           rv = 0;
 
+    // 日志写线程在守护进程 fork 之后启动
+    if (neu_log_start() != 0) {
+        nlog_warn("neuron process failed to start log writer, ignore");
+    }
+
     // try to enable core dump
     rl.rlim_cur = rl.rlim_max = RLIM_INFINITY;
     if (setrlimit(RLIMIT_CORE, &rl) < 0) {
@@ -180,6 +185,10 @@ static int neuron_run(const neu_cli_args_t *args)
                 args->daemonized, NEURON_VERSION,
                 NEURON_GIT_REV NEURON_GIT_DIFF, NEURON_BUILD_DATE);
     
+    // 启动共享事件循环池，节点创建时从池中取用事件循环
+    neu_event_pool_init(args->event_threads);
+    nlog_notice("event loop pool threads: %d", neu_event_pool_size());
+
     //创建并初始化一个 neu_manager 实例
     g_manager = neu_manager_create();
     if (g_manager == NULL) {
@@ -225,7 +234,6 @@ int main(int argc, char *argv[])
     pid_t          pid    = 0;
     neu_cli_args_t args   = { 0 };
 
-    global_timestamp = neu_time_ms();
     neu_cli_args_init(&args, argc, argv);
 
     disable_jwt    = args.disable_auth;
@@ -358,6 +366,7 @@ int main(int argc, char *argv[])
 
 main_end:
     neu_cli_args_fini(&args);
+    neu_log_stop();
     zlog_fini();
     return rv;
 }
@@ -22,7 +22,6 @@
 #include <time.h>
 
 #include "define.h"
-#include "event/event.h"
 #include "metrics.h"
 #include "parser/neu_json_otel.h"
 #include "plugin.h"
@@ -39,6 +38,13 @@
 #define ID_CHARSET "0123456789abcdef"
 #define TRACE_TIME_OUT (3 * 60 * 1000)
 
+#define OTEL_EXPORT_INTERVAL_MS 80
+#define OTEL_MAX_TRACES 10000 // 表中的追踪数上限，超出后不再创建
+#define OTEL_QUEUE_MAX_BYTES (16 * 1024 * 1024) // 待导出数据的编码长度上限
+#define OTEL_BATCH_MAX_BYTES (1024 * 1024)      // 单次导出的长度上限
+#define OTEL_RETRY_MIN_MS 100
+#define OTEL_RETRY_MAX_MS 5000
+
 bool   otel_flag               = false;
 char   otel_collector_url[128] = { 0 };
 bool   otel_control_flag       = false;
@@ -154,8 +160,39 @@ trace_ctx_table_ele_t *traces_table = NULL;
 
 pthread_mutex_t table_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-neu_events_t *     otel_event = NULL;
-neu_event_timer_t *otel_timer = NULL;
+/**
+ * @brief 一个已完成并编码的追踪，在导出队列中等待发送。
+ */
+typedef struct export_item {
+    struct export_item *next;
+    size_t              len;
+    uint8_t             data[];
+} export_item_t;
+
+/**
+ * @brief 导出线程的状态。
+ *
+ * 导出线程定期从追踪表中摘下已完成的追踪，在表锁之外编码并放入自己的队列，
+ * 再把队列中的多个追踪合并成一次 OTLP 请求发送。追踪表只在摘取时短暂加锁，
+ * 发送期间数据路径创建、查找追踪不受影响。队列只由导出线程访问。
+ */
+static struct {
+    pthread_mutex_t mtx;
+    pthread_cond_t  cond; // 通知导出线程停止
+    pthread_t       tid;
+    bool            running;
+    bool            stop;
+
+    export_item_t *head;
+    export_item_t *tail;
+    int64_t        retry_at; // 发送失败后，到该时间之前不再发送
+    int            backoff;
+
+    neu_otel_stats_t stats;
+} g_exporter = {
+    .mtx  = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+};
 
 static int hex_char_to_int(char c)
 {
@@ -284,6 +321,14 @@ neu_otel_trace_ctx neu_otel_create_trace(const char *trace_id, void *req_ctx,
         free(find);
     }
 
+    // 导出跟不上或采集器不可用时不再记录新的追踪，调用者按未采样处理
+    if (HASH_COUNT(traces_table) >= OTEL_MAX_TRACES) {
+        pthread_mutex_unlock(&table_mutex);
+        __atomic_fetch_add(&g_exporter.stats.dropped_limit, 1,
+                           __ATOMIC_RELAXED);
+        return NULL;
+    }
+
     pthread_mutex_unlock(&table_mutex);
 
     trace_ctx_t *ctx = calloc(1, sizeof(trace_ctx_t));
@@ -585,18 +630,30 @@ neu_otel_trace_ctx neu_otel_find_trace(void *req_ctx)
 
 void neu_otel_trace_set_final(neu_otel_trace_ctx ctx)
 {
+    if (ctx == NULL) {
+        return;
+    }
+
     trace_ctx_t *trace_ctx = (trace_ctx_t *) ctx;
     trace_ctx->final       = true;
 }
 
 void neu_otel_trace_set_expected_span_num(neu_otel_trace_ctx ctx, uint32_t num)
 {
+    if (ctx == NULL) {
+        return;
+    }
+
     trace_ctx_t *trace_ctx       = (trace_ctx_t *) ctx;
     trace_ctx->expected_span_num = num;
 }
 
 uint8_t *neu_otel_get_trace_id(neu_otel_trace_ctx ctx)
 {
+    if (ctx == NULL) {
+        return NULL;
+    }
+
     trace_ctx_t *trace_ctx = (trace_ctx_t *) ctx;
     pthread_mutex_lock(&trace_ctx->mutex);
     uint8_t *id = trace_ctx->trace_data.resource_spans[0]
@@ -677,6 +734,10 @@ void neu_otel_free_trace(neu_otel_trace_ctx ctx)
  */
 neu_otel_scope_ctx neu_otel_add_span(neu_otel_trace_ctx ctx)
 {
+    if (ctx == NULL) {
+        return NULL;
+    }
+
     // 分配新的scope结构体内存
     trace_scope_t *scope     = calloc(1, sizeof(trace_scope_t));
     trace_ctx_t *  trace_ctx = (trace_ctx_t *) ctx;
@@ -780,6 +841,10 @@ neu_otel_scope_ctx neu_otel_add_span2(neu_otel_trace_ctx ctx,
                                       const char *       span_name,
                                       const char *       span_id)
 {
+    if (ctx == NULL) {
+        return NULL;
+    }
+
     trace_scope_t *scope     = calloc(1, sizeof(trace_scope_t));
     trace_ctx_t *  trace_ctx = (trace_ctx_t *) ctx;
     
@@ -890,6 +955,10 @@ neu_otel_scope_ctx neu_otel_add_span2(neu_otel_trace_ctx ctx,
 void neu_otel_scope_set_parent_span_id(neu_otel_scope_ctx ctx,
                                        const char *       parent_span_id)
 {
+    if (ctx == NULL) {
+        return;
+    }
+
     trace_scope_t *scope   = (trace_scope_t *) ctx;
     uint8_t *      p_sp_id = calloc(1, 8);
     if (hex_string_to_binary(parent_span_id, p_sp_id, 8) > 0) {
@@ -915,6 +984,10 @@ void neu_otel_scope_set_parent_span_id(neu_otel_scope_ctx ctx,
 void neu_otel_scope_set_parent_span_id2(neu_otel_scope_ctx ctx,
                                         uint8_t *parent_span_id, int len)
 {
+    if (ctx == NULL) {
+        return;
+    }
+
     trace_scope_t *scope = (trace_scope_t *) ctx;
 
     uint8_t *p_sp_id = calloc(1, 8);
@@ -927,6 +1000,10 @@ void neu_otel_scope_set_parent_span_id2(neu_otel_scope_ctx ctx,
 
 void neu_otel_scope_set_span_name(neu_otel_scope_ctx ctx, const char *span_name)
 {
+    if (ctx == NULL) {
+        return;
+    }
+
     trace_scope_t *scope = (trace_scope_t *) ctx;
     scope->span->name    = strdup(span_name);
 }
@@ -943,6 +1020,10 @@ void neu_otel_scope_set_span_name(neu_otel_scope_ctx ctx, const char *span_name)
  */
 void neu_otel_scope_set_span_id(neu_otel_scope_ctx ctx, const char *span_id)
 {
+    if (ctx == NULL) {
+        return;
+    }
+
     // 将上下文转换为trace_scope_t类型指针
     trace_scope_t *scope = (trace_scope_t *) ctx;
 
@@ -961,6 +1042,10 @@ void neu_otel_scope_set_span_id(neu_otel_scope_ctx ctx, const char *span_id)
 
 void neu_otel_scope_set_span_flags(neu_otel_scope_ctx ctx, uint32_t flags)
 {
+    if (ctx == NULL) {
+        return;
+    }
+
     trace_scope_t *scope = (trace_scope_t *) ctx;
     scope->span->flags   = flags;
 }
@@ -978,6 +1063,10 @@ void neu_otel_scope_set_span_flags(neu_otel_scope_ctx ctx, uint32_t flags)
 void neu_otel_scope_add_span_attr_int(neu_otel_scope_ctx ctx, const char *key,
                                       int64_t val)
 {
+    if (ctx == NULL) {
+        return;
+    }
+
     trace_scope_t *scope = (trace_scope_t *) ctx;
 
     // 保存原属性数组
@@ -1019,6 +1108,10 @@ void neu_otel_scope_add_span_attr_int(neu_otel_scope_ctx ctx, const char *key,
 void neu_otel_scope_add_span_attr_double(neu_otel_scope_ctx ctx,
                                          const char *key, double val)
 {
+    if (ctx == NULL) {
+        return;
+    }
+
     trace_scope_t *scope = (trace_scope_t *) ctx;
 
     Opentelemetry__Proto__Common__V1__KeyValue **t_kvs =
@@ -1050,6 +1143,10 @@ void neu_otel_scope_add_span_attr_double(neu_otel_scope_ctx ctx,
 void neu_otel_scope_add_span_attr_string(neu_otel_scope_ctx ctx,
                                          const char *key, const char *val)
 {
+    if (ctx == NULL) {
+        return;
+    }
+
     trace_scope_t *scope = (trace_scope_t *) ctx;
 
     Opentelemetry__Proto__Common__V1__KeyValue **t_kvs =
@@ -1081,6 +1178,10 @@ void neu_otel_scope_add_span_attr_string(neu_otel_scope_ctx ctx,
 void neu_otel_scope_add_span_attr_bool(neu_otel_scope_ctx ctx, const char *key,
                                        bool val)
 {
+    if (ctx == NULL) {
+        return;
+    }
+
     trace_scope_t *scope = (trace_scope_t *) ctx;
 
     Opentelemetry__Proto__Common__V1__KeyValue **t_kvs =
@@ -1120,6 +1221,10 @@ void neu_otel_scope_add_span_attr_bool(neu_otel_scope_ctx ctx, const char *key,
  */
 void neu_otel_scope_set_span_start_time(neu_otel_scope_ctx ctx, int64_t ns)
 {
+    if (ctx == NULL) {
+        return;
+    }
+
     trace_scope_t *scope              = (trace_scope_t *) ctx;
     scope->span->start_time_unix_nano = ((uint64_t) ns);
 }
@@ -1127,6 +1232,10 @@ void neu_otel_scope_set_span_start_time(neu_otel_scope_ctx ctx, int64_t ns)
 void neu_otel_scope_set_span_end_time(neu_otel_scope_ctx ctx, int64_t ns)
 
 {
+    if (ctx == NULL) {
+        return;
+    }
+
     trace_scope_t *scope            = (trace_scope_t *) ctx;
     scope->span->end_time_unix_nano = ((uint64_t) ns);
     trace_ctx_t *trace_ctx          = (trace_ctx_t *) scope->trace_ctx;
@@ -1138,6 +1247,10 @@ void neu_otel_scope_set_status_code(neu_otel_scope_ctx     ctx,
                                     neu_otel_status_code_e code,
                                     const char *           desc)
 {
+    if (ctx == NULL) {
+        return;
+    }
+
     trace_scope_t *scope = (trace_scope_t *) ctx;
     scope->span->status =
         calloc(1, sizeof(Opentelemetry__Proto__Trace__V1__Status));
@@ -1150,6 +1263,10 @@ void neu_otel_scope_set_status_code(neu_otel_scope_ctx     ctx,
 void neu_otel_scope_set_status_code2(neu_otel_scope_ctx     ctx,
                                      neu_otel_status_code_e code, int errorno)
 {
+    if (ctx == NULL) {
+        return;
+    }
+
     trace_scope_t *scope = (trace_scope_t *) ctx;
     scope->span->status =
         calloc(1, sizeof(Opentelemetry__Proto__Trace__V1__Status));
@@ -1173,6 +1290,10 @@ void neu_otel_scope_set_status_code2(neu_otel_scope_ctx     ctx,
  */
 uint8_t *neu_otel_scope_get_pre_span_id(neu_otel_scope_ctx ctx)
 {
+    if (ctx == NULL) {
+        return NULL;
+    }
+
     trace_scope_t *scope     = (trace_scope_t *) ctx;
     trace_ctx_t *  trace_ctx = (trace_ctx_t *) scope->trace_ctx;
     pthread_mutex_lock(&trace_ctx->mutex);
@@ -1194,6 +1315,10 @@ uint8_t *neu_otel_scope_get_pre_span_id(neu_otel_scope_ctx ctx)
 
 int neu_otel_trace_pack_size(neu_otel_trace_ctx ctx)
 {
+    if (ctx == NULL) {
+        return 0;
+    }
+
     trace_ctx_t *trace_ctx = (trace_ctx_t *) ctx;
     return opentelemetry__proto__trace__v1__traces_data__get_packed_size(
         &trace_ctx->trace_data);
@@ -1201,6 +1326,10 @@ int neu_otel_trace_pack_size(neu_otel_trace_ctx ctx)
 
 int neu_otel_trace_pack(neu_otel_trace_ctx ctx, uint8_t *out)
 {
+    if (ctx == NULL) {
+        return 0;
+    }
+
     trace_ctx_t *trace_ctx = (trace_ctx_t *) ctx;
     return opentelemetry__proto__trace__v1__traces_data__pack(
         &trace_ctx->trace_data, out);
@@ -1267,83 +1396,245 @@ void neu_otel_split_traceparent(const char *in, char *trace_id, char *span_id,
     free(copy);
 }
 
-static int otel_timer_cb(void *data)
+static bool trace_is_done(trace_ctx_t *ctx)
+{
+    return ctx->final &&
+        ctx->span_num ==
+        ctx->trace_data.resource_spans[0]->scope_spans[0]->n_spans &&
+        ctx->expected_span_num <= 0;
+}
+
+static void stats_add(uint64_t *counter, uint64_t n)
 {
-    (void) data;
+    __atomic_fetch_add(counter, n, __ATOMIC_RELAXED);
+}
+
+static void stats_sub(uint64_t *counter, uint64_t n)
+{
+    __atomic_fetch_sub(counter, n, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 编码一个已完成的追踪并放入导出队列。
+ *
+ * 队列超过 OTEL_QUEUE_MAX_BYTES 时丢弃最早的追踪。
+ */
+static void exporter_enqueue(trace_ctx_t *ctx)
+{
+    size_t         len  = neu_otel_trace_pack_size(ctx);
+    export_item_t *item = NULL;
+
+    if (len > OTEL_QUEUE_MAX_BYTES ||
+        (item = malloc(sizeof(export_item_t) + len)) == NULL) {
+        stats_add(&g_exporter.stats.dropped_queue, 1);
+        return;
+    }
+
+    item->next = NULL;
+    item->len  = neu_otel_trace_pack(ctx, item->data);
+
+    while (g_exporter.head != NULL &&
+           g_exporter.stats.queued_bytes + item->len > OTEL_QUEUE_MAX_BYTES) {
+        export_item_t *old = g_exporter.head;
+        g_exporter.head    = old->next;
+        stats_sub(&g_exporter.stats.queued_traces, 1);
+        stats_sub(&g_exporter.stats.queued_bytes, old->len);
+        stats_add(&g_exporter.stats.dropped_queue, 1);
+        free(old);
+    }
+
+    if (g_exporter.head == NULL) {
+        g_exporter.head = item;
+    } else {
+        g_exporter.tail->next = item;
+    }
+    g_exporter.tail = item;
+    stats_add(&g_exporter.stats.queued_traces, 1);
+    stats_add(&g_exporter.stats.queued_bytes, item->len);
+}
 
+/**
+ * @brief 从追踪表中摘下已完成和超时的追踪。
+ *
+ * 表锁内只做摘除，编码与释放都在锁外进行。
+ */
+static void exporter_collect(void)
+{
     trace_ctx_table_ele_t *el = NULL, *tmp = NULL;
+    UT_array *             done    = NULL;
+    UT_array *             expired = NULL;
+    int64_t                now     = neu_time_ms();
 
-    pthread_mutex_lock(&table_mutex);
+    utarray_new(done, &ut_ptr_icd);
+    utarray_new(expired, &ut_ptr_icd);
 
+    pthread_mutex_lock(&table_mutex);
     HASH_ITER(hh, traces_table, el, tmp)
     {
-        if (el->ctx->final &&
-            el->ctx->span_num ==
-                el->ctx->trace_data.resource_spans[0]
-                    ->scope_spans[0]
-                    ->n_spans &&
-            el->ctx->expected_span_num <= 0) {
-            int data_size = neu_otel_trace_pack_size(el->ctx);
-
-            uint8_t *data_buf = calloc(1, data_size);
-            neu_otel_trace_pack(el->ctx, data_buf);
-            int status = neu_http_post_otel_trace(data_buf, data_size);
-            free(data_buf);
-            nlog_debug("send trace:%s status:%d", (char *) el->ctx->trace_id,
-                       status);
-            if (status == 200 || status == 400) {
-                HASH_DEL(traces_table, el);
-                neu_otel_free_trace(el->ctx);
-                free(el);
-            } else {
-                break;
-            }
-        } else if (neu_time_ms() - el->ctx->ts >= TRACE_TIME_OUT) {
-            nlog_debug("trace:%s time out", (char *) el->ctx->trace_id);
+        if (trace_is_done(el->ctx)) {
             HASH_DEL(traces_table, el);
-            neu_otel_free_trace(el->ctx);
+            utarray_push_back(done, &el->ctx);
+            free(el);
+        } else if (now - el->ctx->ts >= TRACE_TIME_OUT) {
+            HASH_DEL(traces_table, el);
+            utarray_push_back(expired, &el->ctx);
             free(el);
         }
     }
-
     pthread_mutex_unlock(&table_mutex);
 
-    return 0;
+    utarray_foreach(done, trace_ctx_t **, ctx)
+    {
+        exporter_enqueue(*ctx);
+        neu_otel_free_trace(*ctx);
+    }
+
+    utarray_foreach(expired, trace_ctx_t **, ctx)
+    {
+        nlog_debug("trace:%s time out", (char *) (*ctx)->trace_id);
+        neu_otel_free_trace(*ctx);
+    }
+    stats_add(&g_exporter.stats.dropped_timeout, utarray_len(expired));
+
+    utarray_free(done);
+    utarray_free(expired);
 }
 
-void neu_otel_start()
+/**
+ * @brief 把导出队列中的追踪合并发送。
+ *
+ * 编码后的 TracesData 只有 resource_spans 一个重复字段，多个追踪的编码直接
+ * 拼接即是包含全部 resource_spans 的一个 OTLP 请求。发送失败时按指数退避
+ * 等待后重试，队列由 exporter_enqueue 限制长度。
+ */
+static void exporter_send(void)
 {
-    if (otel_event == NULL) {
-        otel_event = neu_event_new();
+    while (g_exporter.head != NULL && neu_time_ms() >= g_exporter.retry_at) {
+        size_t         len = 0;
+        int            n   = 0;
+        export_item_t *end = g_exporter.head;
+
+        for (; end != NULL &&
+             (n == 0 || len + end->len <= OTEL_BATCH_MAX_BYTES);
+             end = end->next) {
+            len += end->len;
+            n += 1;
+        }
+
+        uint8_t *buf = malloc(len);
+        if (buf == NULL) {
+            return;
+        }
+
+        size_t off = 0;
+        for (export_item_t *it = g_exporter.head; it != end; it = it->next) {
+            memcpy(buf + off, it->data, it->len);
+            off += it->len;
+        }
+
+        int status = neu_http_post_otel_trace(buf, len);
+        free(buf);
+        nlog_debug("send %d traces, %zu bytes, status:%d", n, len, status);
+
+        if (status != 200 && status != 400) {
+            stats_add(&g_exporter.stats.export_failures, 1);
+            g_exporter.backoff = g_exporter.backoff == 0
+                ? OTEL_RETRY_MIN_MS
+                : g_exporter.backoff * 2;
+            if (g_exporter.backoff > OTEL_RETRY_MAX_MS) {
+                g_exporter.backoff = OTEL_RETRY_MAX_MS;
+            }
+            g_exporter.retry_at = neu_time_ms() + g_exporter.backoff;
+            return;
+        }
+
+        // 400 表示采集器无法解析，重发也不会成功
+        stats_add(status == 200 ? &g_exporter.stats.exported
+                                : &g_exporter.stats.dropped_rejected,
+                  n);
+        stats_sub(&g_exporter.stats.queued_traces, n);
+        stats_sub(&g_exporter.stats.queued_bytes, len);
+        while (g_exporter.head != end) {
+            export_item_t *it = g_exporter.head;
+            g_exporter.head   = it->next;
+            free(it);
+        }
+        g_exporter.backoff = 0;
     }
+}
 
-    if (otel_timer == NULL) {
-        neu_event_timer_param_t param = { 0 };
+static void exporter_clear(void)
+{
+    while (g_exporter.head != NULL) {
+        export_item_t *it = g_exporter.head;
+        g_exporter.head   = it->next;
+        free(it);
+    }
+    g_exporter.tail = NULL;
+    __atomic_store_n(&g_exporter.stats.queued_traces, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_exporter.stats.queued_bytes, 0, __ATOMIC_RELAXED);
+}
 
-        param.usr_data = NULL;
+static void *otel_exporter(void *arg)
+{
+    (void) arg;
+
+    pthread_mutex_lock(&g_exporter.mtx);
+    while (!g_exporter.stop) {
+        pthread_mutex_unlock(&g_exporter.mtx);
+
+        exporter_collect();
+        exporter_send();
+
+        pthread_mutex_lock(&g_exporter.mtx);
+        if (!g_exporter.stop) {
+            struct timespec ts = { 0 };
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_nsec += OTEL_EXPORT_INTERVAL_MS * 1000000L;
+            if (ts.tv_nsec >= 1000000000L) {
+                ts.tv_sec += 1;
+                ts.tv_nsec -= 1000000000L;
+            }
+            pthread_cond_timedwait(&g_exporter.cond, &g_exporter.mtx, &ts);
+        }
+    }
+    pthread_mutex_unlock(&g_exporter.mtx);
 
-        param.second      = 0;
-        param.millisecond = 80;
-        param.cb          = otel_timer_cb;
-        param.type        = NEU_EVENT_TIMER_BLOCK;
+    return NULL;
+}
 
-        otel_timer = neu_event_add_timer(otel_event, param);
+void neu_otel_start()
+{
+    pthread_mutex_lock(&g_exporter.mtx);
+    if (!g_exporter.running) {
+        g_exporter.stop     = false;
+        g_exporter.retry_at = 0;
+        g_exporter.backoff  = 0;
+        if (0 == pthread_create(&g_exporter.tid, NULL, otel_exporter, NULL)) {
+            g_exporter.running = true;
+        } else {
+            nlog_error("create otel exporter thread fail");
+        }
     }
+    pthread_mutex_unlock(&g_exporter.mtx);
 
     nlog_debug("otel_start");
 }
 
 void neu_otel_stop()
 {
-    if (otel_timer) {
-        neu_event_del_timer(otel_event, otel_timer);
-        otel_timer = NULL;
+    pthread_mutex_lock(&g_exporter.mtx);
+    bool running       = g_exporter.running;
+    g_exporter.stop    = true;
+    g_exporter.running = false;
+    pthread_cond_signal(&g_exporter.cond);
+    pthread_mutex_unlock(&g_exporter.mtx);
+
+    if (running) {
+        pthread_join(g_exporter.tid, NULL);
     }
+    exporter_clear();
 
-    if (otel_event) {
-        neu_event_close(otel_event);
-        otel_event = NULL;
-    }
     trace_ctx_table_ele_t *el = NULL, *tmp = NULL;
 
     pthread_mutex_lock(&table_mutex);
@@ -1361,6 +1652,55 @@ void neu_otel_stop()
     nlog_debug("otel_stop");
 }
 
+void neu_otel_get_stats(neu_otel_stats_t *stats)
+{
+    neu_otel_stats_t *s = &g_exporter.stats;
+
+    pthread_mutex_lock(&table_mutex);
+    stats->traces = HASH_COUNT(traces_table);
+    pthread_mutex_unlock(&table_mutex);
+
+    stats->queued_traces = __atomic_load_n(&s->queued_traces, __ATOMIC_RELAXED);
+    stats->queued_bytes  = __atomic_load_n(&s->queued_bytes, __ATOMIC_RELAXED);
+    stats->exported      = __atomic_load_n(&s->exported, __ATOMIC_RELAXED);
+    stats->export_failures =
+        __atomic_load_n(&s->export_failures, __ATOMIC_RELAXED);
+    stats->dropped_limit = __atomic_load_n(&s->dropped_limit, __ATOMIC_RELAXED);
+    stats->dropped_queue = __atomic_load_n(&s->dropped_queue, __ATOMIC_RELAXED);
+    stats->dropped_timeout =
+        __atomic_load_n(&s->dropped_timeout, __ATOMIC_RELAXED);
+    stats->dropped_rejected =
+        __atomic_load_n(&s->dropped_rejected, __ATOMIC_RELAXED);
+}
+
+/**
+ * @brief 按 data_sample_rate 决定是否为一次数据采集创建追踪。
+ *
+ * 在追踪开始时独立地按比例随机决定，比例不必是 1/N。每个线程使用自己的
+ * xorshift 状态，不需要加锁。
+ */
+bool neu_otel_data_sampled()
+{
+    static __thread uint64_t state = 0;
+
+    double rate = otel_data_sample_rate;
+    if (rate <= 0.0) {
+        return false;
+    }
+    if (rate >= 1.0) {
+        return true;
+    }
+
+    if (state == 0) {
+        state = ((uint64_t) neu_time_ns() ^ (uint64_t) pthread_self()) | 1;
+    }
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    return (double) (state >> 11) * (1.0 / 9007199254740992.0) < rate;
+}
+
 bool neu_otel_control_is_started()
 {
     return otel_flag && otel_control_flag;
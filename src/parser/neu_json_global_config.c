@@ -583,3 +583,125 @@ void neu_json_decode_drivers_req_free(neu_json_drivers_req_t *req)
         free(req);
     }
 }
+
+static json_t *encode_names(char **names, int n)
+{
+    json_t *array = json_array();
+    if (NULL == array) {
+        return NULL;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        if (0 != json_array_append_new(array, json_string(names[i]))) {
+            json_decref(array);
+            return NULL;
+        }
+    }
+
+    return array;
+}
+
+static int encode_diff(json_t *root, const char *name, json_t *add,
+                       json_t *del, json_t *update)
+{
+    int     rv   = -1;
+    json_t *diff = json_object();
+
+    if (NULL != diff && NULL != add && NULL != del && NULL != update &&
+        0 == json_object_set(diff, "add", add) &&
+        0 == json_object_set(diff, "delete", del) &&
+        0 == json_object_set(diff, "update", update)) {
+        rv = json_object_set(root, name, diff);
+    }
+
+    json_decref(add);
+    json_decref(del);
+    json_decref(update);
+    json_decref(diff);
+    return rv;
+}
+
+int neu_json_encode_import_config_resp(void *obj_json, void *param)
+{
+    json_t *                       root = obj_json;
+    neu_json_import_config_resp_t *resp = param;
+    json_t *                       tags = json_object();
+
+    if (NULL == tags ||
+        0 != json_object_set_new(tags, "current",
+                                 json_integer(resp->current_tags)) ||
+        0 != json_object_set_new(tags, "import",
+                                 json_integer(resp->import_tags))) {
+        json_decref(tags);
+        return -1;
+    }
+
+    if (0 != json_object_set_new(root, "tags", tags) ||
+        0 !=
+            json_object_set_new(root, "dry_run", json_boolean(resp->dry_run)) ||
+        0 !=
+            encode_diff(root, "nodes",
+                        encode_names(resp->add_nodes, resp->n_add_node),
+                        encode_names(resp->del_nodes, resp->n_del_node),
+                        encode_names(resp->update_nodes,
+                                     resp->n_update_node)) ||
+        0 !=
+            encode_diff(root, "groups", json_integer(resp->add_groups),
+                        json_integer(resp->del_groups),
+                        json_integer(resp->update_groups)) ||
+        0 !=
+            encode_diff(root, "subscriptions",
+                        json_integer(resp->add_subscriptions),
+                        json_integer(resp->del_subscriptions),
+                        json_integer(resp->update_subscriptions))) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int neu_json_encode_import_progress_resp(void *json_object, void *param)
+{
+    neu_json_import_progress_resp_t *resp = param;
+
+    neu_json_elem_t resp_elems[] = {
+        {
+            .name      = "phase",
+            .t         = NEU_JSON_STR,
+            .v.val_str = (char *) resp->phase,
+        },
+        {
+            .name       = "dry_run",
+            .t          = NEU_JSON_BOOL,
+            .v.val_bool = resp->dry_run,
+        },
+        {
+            .name      = "total",
+            .t         = NEU_JSON_INT,
+            .v.val_int = (int64_t) resp->total,
+        },
+        {
+            .name      = "done",
+            .t         = NEU_JSON_INT,
+            .v.val_int = (int64_t) resp->done,
+        },
+        {
+            .name      = "error",
+            .t         = NEU_JSON_INT,
+            .v.val_int = resp->error,
+        },
+        {
+            .name      = "start",
+            .t         = NEU_JSON_INT,
+            .v.val_int = resp->start,
+        },
+        {
+            .name      = "elapsed",
+            .t         = NEU_JSON_INT,
+            .v.val_int = resp->elapsed,
+        },
+    };
+
+    return neu_json_encode_field(json_object, resp_elems,
+                                 NEU_JSON_ELEM_SIZE(resp_elems));
+}
@@ -97,6 +97,38 @@ int  neu_json_encode_drivers_req(void *obj_json, void *param);
 int  neu_json_decode_drivers_req(char *buf, neu_json_drivers_req_t **result);
 void neu_json_decode_drivers_req_free(neu_json_drivers_req_t *req);
 
+typedef struct {
+    bool     dry_run;
+    int      n_add_node;
+    char **  add_nodes;
+    int      n_del_node;
+    char **  del_nodes;
+    int      n_update_node;
+    char **  update_nodes;
+    uint32_t add_groups;
+    uint32_t del_groups;
+    uint32_t update_groups;
+    uint64_t current_tags;
+    uint64_t import_tags;
+    uint32_t add_subscriptions;
+    uint32_t del_subscriptions;
+    uint32_t update_subscriptions;
+} neu_json_import_config_resp_t;
+
+int neu_json_encode_import_config_resp(void *obj_json, void *param);
+
+typedef struct {
+    const char *phase;
+    bool        dry_run;
+    uint64_t    total;
+    uint64_t    done;
+    int         error;
+    int64_t     start;
+    int64_t     elapsed;
+} neu_json_import_progress_resp_t;
+
+int neu_json_encode_import_progress_resp(void *json_object, void *param);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1445,9 +1445,15 @@ int neu_json_encode_write_tags_resp(void *json_object, void *param)
     int                         ret   = 0;
     neu_json_write_tags_resp_t *resp  = (neu_json_write_tags_resp_t *) param;
     void *                      array = json_array();
+    int                         error = NEU_ERR_SUCCESS;
 
     utarray_foreach(resp->tags, neu_resp_write_tags_ele_t *, ele)
     {
+        // 整体结果取第一个失败点位的错误码，兼容只看 error 的调用方
+        if (error == NEU_ERR_SUCCESS) {
+            error = ele->error;
+        }
+
         neu_json_elem_t node_elems[] = {
             {
                 .name      = "group",
@@ -1469,11 +1475,18 @@ int neu_json_encode_write_tags_resp(void *json_object, void *param)
                                       NEU_JSON_ELEM_SIZE(node_elems));
     }
 
-    neu_json_elem_t resp_elems[] = { {
-        .name         = "tags",
-        .t            = NEU_JSON_OBJECT,
-        .v.val_object = array,
-    } };
+    neu_json_elem_t resp_elems[] = {
+        {
+            .name      = "error",
+            .t         = NEU_JSON_INT,
+            .v.val_int = error,
+        },
+        {
+            .name         = "tags",
+            .t            = NEU_JSON_OBJECT,
+            .v.val_object = array,
+        },
+    };
     ret = neu_json_encode_field(json_object, resp_elems,
                                 NEU_JSON_ELEM_SIZE(resp_elems));
 
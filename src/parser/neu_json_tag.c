@@ -33,6 +33,63 @@
 #include "tag.h"
 #include "type.h"
 
+static json_t *encode_deadband(const neu_datatag_deadband_t *deadband)
+{
+    return json_pack("{s:i, s:f, s:f, s:f, s:I}", "type", deadband->type,
+                     "value", deadband->value, "span", deadband->span,
+                     "hysteresis", deadband->hysteresis, "heartbeat",
+                     (json_int_t) deadband->heartbeat);
+}
+
+static int decode_deadband(json_t *json_obj, neu_datatag_deadband_t *deadband)
+{
+    neu_json_elem_t elems[] = {
+        {
+            .name = "type",
+            .t    = NEU_JSON_INT,
+        },
+        {
+            .name      = "value",
+            .t         = NEU_JSON_DOUBLE,
+            .attribute = NEU_JSON_ATTRIBUTE_OPTIONAL,
+        },
+        {
+            .name      = "span",
+            .t         = NEU_JSON_DOUBLE,
+            .attribute = NEU_JSON_ATTRIBUTE_OPTIONAL,
+        },
+        {
+            .name      = "hysteresis",
+            .t         = NEU_JSON_DOUBLE,
+            .attribute = NEU_JSON_ATTRIBUTE_OPTIONAL,
+        },
+        {
+            .name      = "heartbeat",
+            .t         = NEU_JSON_INT,
+            .attribute = NEU_JSON_ATTRIBUTE_OPTIONAL,
+        },
+    };
+
+    if (!json_is_object(json_obj) ||
+        0 != neu_json_decode_by_json(json_obj, NEU_JSON_ELEM_SIZE(elems),
+                                     elems)) {
+        return -1;
+    }
+
+    if (elems[0].v.val_int < NEU_DEADBAND_NONE ||
+        elems[0].v.val_int > NEU_DEADBAND_VALUE || elems[4].v.val_int < 0 ||
+        elems[4].v.val_int > UINT32_MAX) {
+        return -1;
+    }
+
+    deadband->type       = elems[0].v.val_int;
+    deadband->value      = elems[1].v.val_double;
+    deadband->span       = elems[2].v.val_double;
+    deadband->hysteresis = elems[3].v.val_double;
+    deadband->heartbeat  = elems[4].v.val_int;
+    return 0;
+}
+
 int neu_json_encode_tag(void *json_obj, void *param)
 {
     int             ret = 0;
@@ -89,6 +146,12 @@ int neu_json_encode_tag(void *json_obj, void *param)
     ret = neu_json_encode_field(json_obj, tag_elems,
                                 NEU_JSON_ELEM_SIZE(tag_elems));
 
+    // 死区只在配置后输出，未配置的标签保持原有格式
+    if (0 == ret && neu_tag_deadband_enabled(&tag->deadband)) {
+        ret = json_object_set_new(json_obj, "deadband",
+                                  encode_deadband(&tag->deadband));
+    }
+
     return ret;
 }
 
@@ -140,6 +203,11 @@ int neu_json_decode_tag_json(void *json_obj, neu_json_tag_t *tag_p)
             .t         = NEU_JSON_DOUBLE,
             .attribute = NEU_JSON_ATTRIBUTE_OPTIONAL,
         },
+        {
+            .name      = "deadband",
+            .t         = NEU_JSON_OBJECT,
+            .attribute = NEU_JSON_ATTRIBUTE_OPTIONAL,
+        },
     };
 
     int ret = neu_json_decode_by_json(json_obj, NEU_JSON_ELEM_SIZE(tag_elems),
@@ -163,6 +231,11 @@ int neu_json_decode_tag_json(void *json_obj, neu_json_tag_t *tag_p)
         goto decode_fail;
     }
 
+    if (NULL != tag_elems[9].v.val_object &&
+        0 != decode_deadband(tag_elems[9].v.val_object, &tag.deadband)) {
+        goto decode_fail;
+    }
+
     if (!neu_json_tag_check_type(&tag)) {
         goto decode_fail;
     }
@@ -25,6 +25,7 @@
 #ifndef _NEU_JSON_API_NEU_JSON_TAG_H_
 #define _NEU_JSON_API_NEU_JSON_TAG_H_
 
+#include "tag.h"
 #include "json/json.h"
 
 #ifdef __cplusplus
@@ -32,16 +33,17 @@ extern "C" {
 #endif
 
 typedef struct {
-    char *           address;
-    char *           name;
-    char *           description;
-    int64_t          type;
-    int64_t          attribute;
-    int64_t          precision;
-    double           decimal;
-    double           bias;
-    neu_json_type_e  t;
-    neu_json_value_u value;
+    char *                 address;
+    char *                 name;
+    char *                 description;
+    int64_t                type;
+    int64_t                attribute;
+    int64_t                precision;
+    double                 decimal;
+    double                 bias;
+    neu_datatag_deadband_t deadband;
+    neu_json_type_e        t;
+    neu_json_value_u       value;
 } neu_json_tag_t;
 
 int  neu_json_encode_tag(void *json_obj, void *param);
@@ -0,0 +1,678 @@
+#include "async_writer.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <dirent.h>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+using steady_clock = std::chrono::steady_clock;
+
+struct Row {
+    uint64_t    seq;
+    ValueType   type;
+    int64_t     timestamp;
+    std::string node_name;
+    std::string group_name;
+    std::string tag;
+    ValueUnion  value;
+    std::string str; ///< STRING_TYPE 的值，value.string_value 在写入前指向它
+    bool        null_str;
+};
+
+int64_t now_ms()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+bool valid_type(ValueType type)
+{
+    return type == INT_TYPE || type == FLOAT_TYPE || type == BOOL_TYPE ||
+        type == STRING_TYPE;
+}
+
+/*
+ * 落盘文件格式：魔数之后逐行存放
+ *   u8 类型 | i64 时间戳 | str 节点 | str 组 | str 点位 | 值
+ * str 为 u32 长度加内容；值按类型为 i32、f32、u8 或 str，空字符串值的长度为
+ * UINT32_MAX。
+ */
+const char SPILL_MAGIC[4] = { 'N', 'D', 'L', '1' };
+
+void put(std::string &buf, const void *data, size_t len)
+{
+    buf.append((const char *) data, len);
+}
+
+void put_str(std::string &buf, const std::string &str)
+{
+    uint32_t len = str.size();
+    put(buf, &len, sizeof(len));
+    buf.append(str);
+}
+
+bool get(const std::string &buf, size_t &off, void *data, size_t len)
+{
+    if (buf.size() - off < len) {
+        return false;
+    }
+    memcpy(data, buf.data() + off, len);
+    off += len;
+    return true;
+}
+
+bool get_str(const std::string &buf, size_t &off, std::string &str,
+             bool *null_str = nullptr)
+{
+    uint32_t len = 0;
+    if (!get(buf, off, &len, sizeof(len))) {
+        return false;
+    }
+    if (null_str) {
+        *null_str = len == UINT32_MAX;
+        if (*null_str) {
+            str.clear();
+            return true;
+        }
+    }
+    if (buf.size() - off < len) {
+        return false;
+    }
+    str.assign(buf, off, len);
+    off += len;
+    return true;
+}
+
+void encode_row(std::string &buf, const Row &row)
+{
+    uint8_t type = row.type;
+    put(buf, &type, sizeof(type));
+    put(buf, &row.timestamp, sizeof(row.timestamp));
+    put_str(buf, row.node_name);
+    put_str(buf, row.group_name);
+    put_str(buf, row.tag);
+
+    switch (row.type) {
+    case INT_TYPE:
+        put(buf, &row.value.int_value, sizeof(row.value.int_value));
+        break;
+    case FLOAT_TYPE:
+        put(buf, &row.value.float_value, sizeof(row.value.float_value));
+        break;
+    case BOOL_TYPE: {
+        uint8_t b = row.value.bool_value;
+        put(buf, &b, sizeof(b));
+        break;
+    }
+    case STRING_TYPE:
+        if (row.null_str) {
+            uint32_t len = UINT32_MAX;
+            put(buf, &len, sizeof(len));
+        } else {
+            put_str(buf, row.str);
+        }
+        break;
+    }
+}
+
+bool decode_row(const std::string &buf, size_t &off, Row &row)
+{
+    uint8_t type = 0;
+    if (!get(buf, off, &type, sizeof(type)) ||
+        !valid_type((ValueType) type) ||
+        !get(buf, off, &row.timestamp, sizeof(row.timestamp)) ||
+        !get_str(buf, off, row.node_name) ||
+        !get_str(buf, off, row.group_name) || !get_str(buf, off, row.tag)) {
+        return false;
+    }
+
+    row.type     = (ValueType) type;
+    row.null_str = false;
+    switch (row.type) {
+    case INT_TYPE:
+        return get(buf, off, &row.value.int_value,
+                   sizeof(row.value.int_value));
+    case FLOAT_TYPE:
+        return get(buf, off, &row.value.float_value,
+                   sizeof(row.value.float_value));
+    case BOOL_TYPE: {
+        uint8_t b = 0;
+        if (!get(buf, off, &b, sizeof(b))) {
+            return false;
+        }
+        row.value.bool_value = b != 0;
+        return true;
+    }
+    case STRING_TYPE:
+        return get_str(buf, off, row.str, &row.null_str);
+    }
+    return false;
+}
+
+bool read_file(const std::string &path, std::string &buf)
+{
+    FILE *fp = fopen(path.c_str(), "rb");
+    if (!fp) {
+        return false;
+    }
+
+    char   chunk[8192];
+    size_t n = 0;
+    buf.clear();
+    while ((n = fread(chunk, 1, sizeof(chunk), fp)) > 0) {
+        buf.append(chunk, n);
+    }
+    bool ok = !ferror(fp);
+    fclose(fp);
+    return ok;
+}
+
+} // namespace
+
+struct AsyncWriter {
+    async_writer_config config;
+    std::string         host;
+    std::string         username;
+    std::string         password;
+    std::string         spill_dir;
+
+    std::mutex              mtx;
+    std::condition_variable cond;      // 有新数据或需要停止
+    std::condition_variable done_cond; // 有批次写完
+    std::deque<Row>         queue;
+    std::multiset<uint64_t> inflight;  // 写线程正在写的批次的首行序号
+    uint64_t                next_seq  = 1;
+    int                     flushing  = 0; // 等待刷新的调用者数，此时不攒批
+    bool                    stop      = false;
+    bool                    replaying = false;
+    async_writer_stats      stats     = {};
+
+    std::mutex spill_mtx; // 串行化落盘文件的写入与命名
+    uint64_t   spill_seq = 0;
+
+    std::vector<std::thread> workers;
+
+    // 该序号之前的行都已写完，调用者持有 mtx
+    uint64_t Watermark() const
+    {
+        uint64_t mark = queue.empty() ? next_seq : queue.front().seq;
+        if (!inflight.empty()) {
+            mark = std::min(mark, *inflight.begin());
+        }
+        return mark;
+    }
+
+    bool Stopping()
+    {
+        std::lock_guard<std::mutex> lk(mtx);
+        return stop;
+    }
+
+    bool Spill(const std::vector<Row> &rows);
+    bool ReplayOne(Client **client);
+    int  WriteType(Client **client, ValueType type, std::vector<datatag> &tags,
+                   int max_retries);
+    void WriteRows(Client **client, std::vector<Row> &rows,
+                   std::vector<Row> *failed);
+    void Run();
+};
+
+/**
+ * @brief 把写不出去的行写入 spill_dir 下的一个新文件。
+ *
+ * 先写临时文件再改名，重新写入时只会看到完整的文件。文件名按时间与序号
+ * 递增，按名称排序即按落盘先后重新写入。
+ */
+bool AsyncWriter::Spill(const std::vector<Row> &rows)
+{
+    if (spill_dir.empty() || rows.empty()) {
+        return false;
+    }
+
+    std::string buf(SPILL_MAGIC, sizeof(SPILL_MAGIC));
+    for (const Row &row : rows) {
+        encode_row(buf, row);
+    }
+
+    std::lock_guard<std::mutex> lk(spill_mtx);
+    char                        name[64] = { 0 };
+    snprintf(name, sizeof(name), "datalayer-%013lld-%06llu.spill",
+             (long long) now_ms(), (unsigned long long) ++spill_seq % 1000000);
+    std::string path = spill_dir + "/" + name;
+    std::string tmp  = path + ".tmp";
+
+    FILE *fp = fopen(tmp.c_str(), "wb");
+    if (!fp) {
+        std::cerr << "Failed to open spill file " << tmp << ": "
+                  << strerror(errno) << std::endl;
+        return false;
+    }
+    bool ok = fwrite(buf.data(), 1, buf.size(), fp) == buf.size();
+    ok      = fclose(fp) == 0 && ok;
+    if (!ok || rename(tmp.c_str(), path.c_str()) != 0) {
+        std::cerr << "Failed to write spill file " << path << ": "
+                  << strerror(errno) << std::endl;
+        unlink(tmp.c_str());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> stats_lk(mtx);
+    stats.spilled_rows += rows.size();
+    stats.spill_files += 1;
+    return true;
+}
+
+/**
+ * @brief 重新写入最早的一个落盘文件，成功后删除。
+ * @return 写入了一个文件返回 true，没有文件或写入失败返回 false。
+ */
+bool AsyncWriter::ReplayOne(Client **client)
+{
+    std::string oldest;
+    DIR *       dir = opendir(spill_dir.c_str());
+    if (!dir) {
+        return false;
+    }
+    for (struct dirent *ent = readdir(dir); ent; ent = readdir(dir)) {
+        size_t len = strlen(ent->d_name);
+        if (len > 6 && 0 == strcmp(ent->d_name + len - 6, ".spill") &&
+            (oldest.empty() || oldest > ent->d_name)) {
+            oldest = ent->d_name;
+        }
+    }
+    closedir(dir);
+    if (oldest.empty()) {
+        return false;
+    }
+
+    std::string      path = spill_dir + "/" + oldest;
+    std::string      buf;
+    std::vector<Row> rows;
+    size_t           off = sizeof(SPILL_MAGIC);
+    bool             ok  = read_file(path, buf) && buf.size() >= off &&
+        0 == memcmp(buf.data(), SPILL_MAGIC, sizeof(SPILL_MAGIC));
+    while (ok && off < buf.size()) {
+        rows.emplace_back();
+        ok = decode_row(buf, off, rows.back());
+    }
+
+    if (!ok) {
+        // 损坏的文件改名保留，不再重试
+        std::cerr << "Corrupted spill file " << path << std::endl;
+        rename(path.c_str(), (path + ".bad").c_str());
+        std::lock_guard<std::mutex> lk(mtx);
+        stats.spill_files -= std::min<uint64_t>(stats.spill_files, 1);
+        return false;
+    }
+
+    std::vector<Row> failed;
+    WriteRows(client, rows, &failed);
+    if (!failed.empty()) {
+        return false;
+    }
+
+    unlink(path.c_str());
+    std::lock_guard<std::mutex> lk(mtx);
+    stats.replayed_rows += rows.size();
+    stats.spill_files -= std::min<uint64_t>(stats.spill_files, 1);
+    return true;
+}
+
+/**
+ * @brief 写入一种类型的行，失败时按指数退避重试。
+ *
+ * 连接不可用时断开重连；参数错误不重试。停止过程中不再等待重试。
+ */
+int AsyncWriter::WriteType(Client **client, ValueType type,
+                           std::vector<datatag> &tags, int max_retries)
+{
+    int backoff = config.retry_backoff_ms;
+    int rv      = CLIENT_OK;
+
+    for (int attempt = 0;; ++attempt) {
+        if (!*client) {
+            *client = client_create(host.c_str(), config.port,
+                                    username.c_str(), password.c_str());
+        }
+
+        rv = *client ? client_insert(*client, type, tags.data(), tags.size())
+                     : CLIENT_ERR_UNAVAILABLE;
+        if (rv == CLIENT_OK || rv == CLIENT_ERR_INVALID ||
+            attempt >= max_retries) {
+            break;
+        }
+
+        if (rv == CLIENT_ERR_UNAVAILABLE && *client) {
+            client_destroy(*client);
+            *client = nullptr;
+        }
+
+        std::unique_lock<std::mutex> lk(mtx);
+        stats.retries += 1;
+        if (cond.wait_for(lk, std::chrono::milliseconds(backoff),
+                          [this] { return stop; })) {
+            break;
+        }
+        backoff = std::min(backoff * 2, config.max_backoff_ms);
+    }
+
+    return rv;
+}
+
+/**
+ * @brief 按类型分组写入一批行，写入失败的行放入 failed。
+ */
+void AsyncWriter::WriteRows(Client **client, std::vector<Row> &rows,
+                            std::vector<Row> *failed)
+{
+    static const ValueType types[] = { INT_TYPE, FLOAT_TYPE, BOOL_TYPE,
+                                       STRING_TYPE };
+    uint64_t               written = 0;
+    uint64_t               dropped = 0;
+    auto                   start   = steady_clock::now();
+    int                    max_retries = Stopping() ? 0 : config.max_retries;
+
+    for (ValueType type : types) {
+        std::vector<datatag> tags;
+        std::vector<size_t>  index;
+
+        for (size_t i = 0; i < rows.size(); ++i) {
+            Row &row = rows[i];
+            if (row.type != type) {
+                continue;
+            }
+
+            datatag tag    = {};
+            tag.node_name  = row.node_name.c_str();
+            tag.group_name = row.group_name.c_str();
+            tag.tag        = row.tag.c_str();
+            tag.value      = row.value;
+            tag.value_type = row.type;
+            tag.timestamp  = row.timestamp;
+            if (type == STRING_TYPE) {
+                tag.value.string_value =
+                    row.null_str ? nullptr : row.str.c_str();
+            }
+            tags.push_back(tag);
+            index.push_back(i);
+        }
+
+        if (tags.empty()) {
+            continue;
+        }
+
+        int rv = WriteType(client, type, tags, max_retries);
+        if (rv == CLIENT_OK) {
+            written += tags.size();
+        } else if (rv == CLIENT_ERR_INVALID) {
+            dropped += tags.size();
+        } else {
+            for (size_t i : index) {
+                failed->push_back(std::move(rows[i]));
+            }
+        }
+    }
+
+    uint64_t us = std::chrono::duration_cast<std::chrono::microseconds>(
+                      steady_clock::now() - start)
+                      .count();
+
+    std::lock_guard<std::mutex> lk(mtx);
+    stats.written_rows += written;
+    stats.dropped_rows += dropped;
+    stats.flushes += 1;
+    stats.last_flush_us = us;
+    stats.max_flush_us  = std::max(stats.max_flush_us, us);
+    stats.total_flush_us += us;
+}
+
+void AsyncWriter::Run()
+{
+    Client *                     client = nullptr;
+    std::unique_lock<std::mutex> lk(mtx);
+
+    while (true) {
+        // 攒够一批、到达刷新时间或停止时写入
+        auto deadline = steady_clock::now() +
+            std::chrono::milliseconds(config.flush_interval_ms);
+        // 队列为空时即使有调用者在等待刷新也要等待，否则写线程空转
+        while (!stop && queue.size() < config.batch_rows &&
+               (flushing == 0 || queue.empty())) {
+            if (cond.wait_until(lk, deadline) == std::cv_status::timeout) {
+                break;
+            }
+        }
+
+        if (queue.empty()) {
+            if (stop) {
+                break;
+            }
+
+            // 空闲时由一个写线程重新写入落盘的数据
+            if (stats.spill_files > 0 && !replaying) {
+                replaying = true;
+                lk.unlock();
+                while (ReplayOne(&client)) {
+                    std::lock_guard<std::mutex> guard(mtx);
+                    if (stop || queue.size() >= config.batch_rows) {
+                        break;
+                    }
+                }
+                lk.lock();
+                replaying = false;
+            }
+            continue;
+        }
+
+        size_t           n = std::min(queue.size(), config.batch_rows);
+        std::vector<Row> rows;
+        rows.reserve(n);
+        auto first = inflight.insert(queue.front().seq);
+        for (size_t i = 0; i < n; ++i) {
+            rows.push_back(std::move(queue.front()));
+            queue.pop_front();
+        }
+        lk.unlock();
+
+        std::vector<Row> failed;
+        WriteRows(&client, rows, &failed);
+
+        uint64_t dropped = 0;
+        if (!failed.empty() && !Spill(failed)) {
+            dropped = failed.size();
+            std::cerr << "Drop " << dropped << " rows after write failure"
+                      << std::endl;
+        }
+
+        lk.lock();
+        stats.dropped_rows += dropped;
+        inflight.erase(first);
+        done_cond.notify_all();
+    }
+
+    lk.unlock();
+    if (client) {
+        client_destroy(client);
+    }
+}
+
+extern "C" void async_writer_config_default(async_writer_config *config)
+{
+    if (config->pool_size == 0)
+        config->pool_size = 2;
+    if (config->queue_capacity == 0)
+        config->queue_capacity = 100000;
+    if (config->batch_rows == 0)
+        config->batch_rows = 5000;
+    if (config->flush_interval_ms <= 0)
+        config->flush_interval_ms = 1000;
+    if (config->max_retries < 0)
+        config->max_retries = 0;
+    if (config->retry_backoff_ms <= 0)
+        config->retry_backoff_ms = 100;
+    if (config->max_backoff_ms < config->retry_backoff_ms)
+        config->max_backoff_ms =
+            std::max(5000, config->retry_backoff_ms);
+}
+
+extern "C" AsyncWriter *async_writer_create(const async_writer_config *config)
+{
+    if (!config || !config->host)
+        return nullptr;
+
+    auto writer    = new AsyncWriter();
+    writer->config = *config;
+    async_writer_config_default(&writer->config);
+    writer->host     = config->host;
+    writer->username = config->username ? config->username : "";
+    writer->password = config->password ? config->password : "";
+
+    if (config->spill_dir) {
+        writer->spill_dir = config->spill_dir;
+        if (mkdir(config->spill_dir, 0755) != 0 && errno != EEXIST) {
+            std::cerr << "Failed to create spill dir " << config->spill_dir
+                      << ": " << strerror(errno) << std::endl;
+        }
+
+        // 上次退出前落盘的文件，空闲时重新写入
+        DIR *dir = opendir(config->spill_dir);
+        if (dir) {
+            for (struct dirent *ent = readdir(dir); ent; ent = readdir(dir)) {
+                size_t len = strlen(ent->d_name);
+                if (len > 6 && 0 == strcmp(ent->d_name + len - 6, ".spill")) {
+                    writer->stats.spill_files += 1;
+                }
+            }
+            closedir(dir);
+        }
+    }
+
+    for (size_t i = 0; i < writer->config.pool_size; ++i) {
+        writer->workers.emplace_back(&AsyncWriter::Run, writer);
+    }
+
+    return writer;
+}
+
+extern "C" void async_writer_destroy(AsyncWriter *writer)
+{
+    if (!writer)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lk(writer->mtx);
+        writer->stop = true;
+    }
+    writer->cond.notify_all();
+
+    for (std::thread &t : writer->workers) {
+        t.join();
+    }
+    delete writer;
+}
+
+extern "C" int async_writer_insert(AsyncWriter *writer, const datatag *tags,
+                                   size_t tag_count)
+{
+    if (!writer || (!tags && tag_count > 0))
+        return CLIENT_ERR_INVALID;
+
+    int64_t          now = now_ms();
+    std::vector<Row> rows(tag_count);
+
+    for (size_t i = 0; i < tag_count; ++i) {
+        const datatag &tag = tags[i];
+        Row &          row = rows[i];
+
+        if (!tag.node_name || !tag.group_name || !tag.tag ||
+            !valid_type(tag.value_type)) {
+            return CLIENT_ERR_INVALID;
+        }
+
+        row.type       = tag.value_type;
+        row.timestamp  = tag.timestamp ? tag.timestamp : now;
+        row.node_name  = tag.node_name;
+        row.group_name = tag.group_name;
+        row.tag        = tag.tag;
+        row.value      = tag.value;
+        row.null_str   = false;
+        if (tag.value_type == STRING_TYPE) {
+            row.null_str = !tag.value.string_value;
+            row.str      = row.null_str ? "" : tag.value.string_value;
+            row.value.string_value = nullptr;
+        }
+    }
+
+    std::vector<Row> overflow;
+    {
+        std::lock_guard<std::mutex> lk(writer->mtx);
+        if (writer->stop) {
+            return CLIENT_ERR_UNAVAILABLE;
+        }
+
+        size_t room = writer->config.queue_capacity -
+            std::min(writer->queue.size(), writer->config.queue_capacity);
+        size_t n = std::min(room, rows.size());
+        for (size_t i = 0; i < n; ++i) {
+            rows[i].seq = writer->next_seq++;
+            writer->queue.push_back(std::move(rows[i]));
+        }
+        for (size_t i = n; i < rows.size(); ++i) {
+            overflow.push_back(std::move(rows[i]));
+        }
+
+        if (writer->queue.size() >= writer->config.batch_rows) {
+            writer->cond.notify_one();
+        }
+    }
+
+    if (overflow.empty() || writer->Spill(overflow)) {
+        return CLIENT_OK;
+    }
+
+    std::lock_guard<std::mutex> lk(writer->mtx);
+    writer->stats.dropped_rows += overflow.size();
+    return CLIENT_ERR_UNAVAILABLE;
+}
+
+extern "C" void async_writer_flush(AsyncWriter *writer)
+{
+    if (!writer)
+        return;
+
+    std::unique_lock<std::mutex> lk(writer->mtx);
+    uint64_t                     target = writer->next_seq;
+
+    // 等待期间不攒批，空闲的写线程立即写出不足一批的数据
+    writer->flushing += 1;
+    writer->cond.notify_all();
+    while (writer->Watermark() < target) {
+        writer->done_cond.wait(lk);
+    }
+    writer->flushing -= 1;
+}
+
+extern "C" void async_writer_stats_get(AsyncWriter *       writer,
+                                       async_writer_stats *stats)
+{
+    if (!writer || !stats)
+        return;
+
+    std::lock_guard<std::mutex> lk(writer->mtx);
+    *stats            = writer->stats;
+    stats->queue_rows = writer->queue.size();
+}
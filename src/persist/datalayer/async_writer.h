@@ -0,0 +1,88 @@
+#ifndef ASYNC_WRITER_H
+#define ASYNC_WRITER_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "flight_sql_client.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    const char *host;
+    int         port;
+    const char *username;
+    const char *password;
+
+    size_t pool_size;         ///< 连接数，每个连接由一个写线程独占
+    size_t queue_capacity;    ///< 队列最多缓存的行数
+    size_t batch_rows;        ///< 攒够该行数立即写入，也是单次写入的上限
+    int    flush_interval_ms; ///< 不足 batch_rows 时最多等待的时间
+    int    max_retries;       ///< 单批写入失败后的重试次数
+    int    retry_backoff_ms;  ///< 首次重试的等待时间，之后每次加倍
+    int    max_backoff_ms;    ///< 重试等待时间的上限
+    const char *spill_dir; ///< 队列满或重试耗尽时落盘的目录，NULL 表示丢弃
+} async_writer_config;
+
+typedef struct {
+    uint64_t queue_rows;     ///< 当前队列中的行数
+    uint64_t written_rows;   ///< 已写入的行数
+    uint64_t dropped_rows;   ///< 丢弃的行数
+    uint64_t spilled_rows;   ///< 写入磁盘的行数
+    uint64_t replayed_rows;  ///< 从磁盘重新写入的行数
+    uint64_t spill_files;    ///< 磁盘上待重新写入的文件数
+    uint64_t flushes;        ///< 写入批次数
+    uint64_t retries;        ///< 重试次数
+    uint64_t last_flush_us;  ///< 最近一批的写入耗时
+    uint64_t max_flush_us;   ///< 最大单批写入耗时
+    uint64_t total_flush_us; ///< 写入耗时之和，除以 flushes 得到平均值
+} async_writer_stats;
+
+typedef struct AsyncWriter AsyncWriter;
+
+/**
+ * @brief 为值为 0 的参数填入默认值。
+ */
+void async_writer_config_default(async_writer_config *config);
+
+/**
+ * @brief 创建后台写入器并启动 pool_size 个写线程。
+ *
+ * 写线程各自建立连接，连接失败时在写入前重连，因此服务端暂不可用时创建
+ * 仍然成功。
+ */
+AsyncWriter *async_writer_create(const async_writer_config *config);
+
+/**
+ * @brief 停止接收新数据，写完队列中的数据后退出写线程。
+ *
+ * 退出时仍未写入的数据落盘（配置了 spill_dir 时），下次创建后重新写入。
+ */
+void async_writer_destroy(AsyncWriter *writer);
+
+/**
+ * @brief 复制点位并放入队列，不等待写入。
+ *
+ * 点位的 timestamp 为 0 时取入队时间。队列已满时，超出的点位落盘，未配置
+ * spill_dir 或落盘失败时丢弃。
+ *
+ * @return 全部入队或落盘返回 CLIENT_OK，参数错误返回 CLIENT_ERR_INVALID，
+ *         有点位被丢弃时返回 CLIENT_ERR_UNAVAILABLE。
+ */
+int async_writer_insert(AsyncWriter *writer, const datatag *tags,
+                        size_t tag_count);
+
+/**
+ * @brief 等待调用前入队的数据写入完成（成功、落盘或丢弃）。
+ */
+void async_writer_flush(AsyncWriter *writer);
+
+void async_writer_stats_get(AsyncWriter *writer, async_writer_stats *stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -1,27 +1,36 @@
 #include "flight_sql_client.h"
 #include <arrow/array.h>
+#include <arrow/builder.h>
 #include <arrow/flight/client.h>
 #include <arrow/flight/sql/client.h>
+#include <arrow/record_batch.h>
 #include <arrow/status.h>
 #include <arrow/table.h>
 #include <arrow/type_fwd.h>
+#include <arrow/util/config.h>
 #include <chrono>
 #include <cstring>
 #include <ctime>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <unordered_map>
 
 namespace flight    = arrow::flight;
 namespace flightsql = arrow::flight::sql;
 
 struct Client {
 public:
-    Client(const std::string &host, int port, const std::string &username,
-           const std::string &password);
-    ~Client() = default;
+    Client() = default;
+    ~Client();
 
+    arrow::Status Connect(const std::string &host, int port,
+                          const std::string &username,
+                          const std::string &password);
     arrow::Status Execute(const std::string &sql);
     arrow::Result<std::shared_ptr<arrow::Table>> Query(const std::string &sql);
+    arrow::Status Ingest(const std::string &schema, const std::string &table,
+                         const std::shared_ptr<arrow::RecordBatch> &batch);
 
 private:
     flight::Location                            location_;
@@ -29,53 +38,125 @@ private:
     std::unique_ptr<flightsql::FlightSqlClient> client_;
     std::string                                 bearer_token_;
 
+    // 服务端是否支持批量写入，第一次返回未实现后不再尝试
+    bool bulk_ingest_ = true;
+    // 以表名为键的 INSERT 预编译语句，执行失败时丢弃，下次重新创建
+    std::unordered_map<std::string,
+                       std::shared_ptr<flightsql::PreparedStatement>>
+        prepared_;
+
+    flight::FlightCallOptions CallOptions() const;
+    arrow::Status
+    IngestPrepared(const std::string &schema, const std::string &table,
+                   const std::shared_ptr<arrow::RecordBatch> &batch);
+
     arrow::Result<std::string>
     AuthenticateBasicToken(const flight::FlightCallOptions &options,
                            const std::string &              username,
                            const std::string &              password);
 };
 
-Client::Client(const std::string &host, int port, const std::string &username,
-               const std::string &password)
+Client::~Client()
 {
-    arrow::Result<flight::Location> location_result =
-        flight::Location::ForGrpcTcp(host, port);
-    if (!location_result.ok()) {
-        std::cerr << "Failed to create Flight location: "
-                  << location_result.status().ToString() << std::endl;
-        exit(EXIT_FAILURE);
+    for (auto &it : prepared_) {
+        (void) it.second->Close(CallOptions());
     }
-    location_ = location_result.ValueOrDie();
+}
+
+arrow::Status Client::Connect(const std::string &host, int port,
+                              const std::string &username,
+                              const std::string &password)
+{
+    ARROW_ASSIGN_OR_RAISE(location_, flight::Location::ForGrpcTcp(host, port));
 
     flight::FlightClientOptions client_options;
     client_options.disable_server_verification = true;
-    arrow::Result<std::shared_ptr<flight::FlightClient>> flight_client_result =
-        flight::FlightClient::Connect(location_, client_options);
-    if (!flight_client_result.ok()) {
-        std::cerr << "Failed to connect to Flight client: "
-                  << flight_client_result.status().ToString() << std::endl;
-        exit(EXIT_FAILURE);
+    ARROW_ASSIGN_OR_RAISE(flight_client_, flight::FlightClient::Connect(
+                                              location_, client_options));
+
+    // 未配置用户名时不认证，请求不带 authorization 头
+    if (!username.empty()) {
+        flight::FlightCallOptions call_options;
+        ARROW_ASSIGN_OR_RAISE(
+            bearer_token_,
+            AuthenticateBasicToken(call_options, username, password));
     }
-    flight_client_ = flight_client_result.ValueOrDie();
 
-    flight::FlightCallOptions call_options;
-    auto auth_result = AuthenticateBasicToken(call_options, username, password);
-    if (!auth_result.ok()) {
-        std::cerr << "Authentication failed: "
-                  << auth_result.status().ToString() << std::endl;
-        exit(EXIT_FAILURE);
-    }
-    bearer_token_ = auth_result.ValueOrDie();
     client_ = std::make_unique<flightsql::FlightSqlClient>(flight_client_);
+    return arrow::Status::OK();
 }
 
-arrow::Status Client::Execute(const std::string &sql)
+flight::FlightCallOptions Client::CallOptions() const
 {
     flight::FlightCallOptions call_options;
-    call_options.headers.push_back(
-        std::make_pair("authorization", "Bearer " + bearer_token_));
+    if (!bearer_token_.empty()) {
+        call_options.headers.push_back(
+            std::make_pair("authorization", "Bearer " + bearer_token_));
+    }
+    return call_options;
+}
+
+arrow::Status Client::Ingest(const std::string &                        schema,
+                             const std::string &                        table,
+                             const std::shared_ptr<arrow::RecordBatch> &batch)
+{
+#if ARROW_VERSION_MAJOR >= 16
+    if (bulk_ingest_) {
+        ARROW_ASSIGN_OR_RAISE(auto reader, arrow::RecordBatchReader::Make(
+                                               { batch }, batch->schema()));
+
+        flightsql::TableDefinitionOptions table_options;
+        table_options.if_not_exist =
+            flightsql::TableDefinitionOptionsTableNotExistOption::kFail;
+        table_options.if_exists =
+            flightsql::TableDefinitionOptionsTableExistsOption::kAppend;
+
+        auto result = client_->ExecuteIngest(CallOptions(), reader,
+                                             table_options, table, schema);
+        if (result.ok() || !result.status().IsNotImplemented()) {
+            return result.status();
+        }
 
-    std::cout << "Executing SQL: " << sql << std::endl;
+        // 服务端不支持批量写入，改用预编译语句绑定整批参数
+        std::cerr << "Bulk ingest not supported, fallback to prepared "
+                     "statement: "
+                  << result.status().ToString() << std::endl;
+        bulk_ingest_ = false;
+    }
+#endif
+    return IngestPrepared(schema, table, batch);
+}
+
+arrow::Status
+Client::IngestPrepared(const std::string &                        schema,
+                       const std::string &                        table,
+                       const std::shared_ptr<arrow::RecordBatch> &batch)
+{
+    std::string name = schema + "." + table;
+    auto        it   = prepared_.find(name);
+
+    if (it == prepared_.end()) {
+        std::string sql = "INSERT INTO " + name +
+            " (time, node_name, group_name, tag, value) VALUES (?, ?, ?, ?, ?)";
+        ARROW_ASSIGN_OR_RAISE(auto stmt, client_->Prepare(CallOptions(), sql));
+        it = prepared_.emplace(name, std::move(stmt)).first;
+    }
+
+    arrow::Status status = it->second->SetParameters(batch);
+    if (status.ok()) {
+        status = it->second->ExecuteUpdate(CallOptions()).status();
+    }
+    if (!status.ok()) {
+        (void) it->second->Close(CallOptions());
+        prepared_.erase(it);
+    }
+
+    return status;
+}
+
+arrow::Status Client::Execute(const std::string &sql)
+{
+    flight::FlightCallOptions call_options = CallOptions();
 
     arrow::Result<std::unique_ptr<flight::FlightInfo>> flight_info_result =
         client_->Execute(call_options, sql);
@@ -119,9 +200,7 @@ Client::AuthenticateBasicToken(const flight::FlightCallOptions &options,
 arrow::Result<std::shared_ptr<arrow::Table>>
 Client::Query(const std::string &sql)
 {
-    flight::FlightCallOptions call_options;
-    call_options.headers.push_back(
-        std::make_pair("authorization", "Bearer " + bearer_token_));
+    flight::FlightCallOptions call_options = CallOptions();
 
     arrow::Result<std::unique_ptr<flight::FlightInfo>> flight_info_result =
         client_->Execute(call_options, sql);
@@ -153,62 +232,266 @@ Client::Query(const std::string &sql)
     return arrow::ConcatenateTables(tables);
 }
 
-extern "C" Client *client_create(const char *host, int port,
-                                 const char *username, const char *password)
+static int status_to_code(const arrow::Status &status)
+{
+    if (status.ok()) {
+        return CLIENT_OK;
+    } else if (status.IsInvalid() || status.IsTypeError()) {
+        return CLIENT_ERR_INVALID;
+    } else if (status.IsIOError()) {
+        return CLIENT_ERR_UNAVAILABLE;
+    } else if (status.IsOutOfMemory() || status.IsCapacityError()) {
+        return CLIENT_ERR_INTERNAL;
+    }
+    return CLIENT_ERR_EXECUTE;
+}
+
+static const char *table_of(ValueType type)
 {
-    try {
-        return new Client(host, port, username, password);
-    } catch (const std::exception &e) {
-        std::cerr << "Error creating client: " << e.what() << std::endl;
+    switch (type) {
+    case INT_TYPE:
+        return "neuron_int";
+    case FLOAT_TYPE:
+        return "neuron_float";
+    case BOOL_TYPE:
+        return "neuron_bool";
+    case STRING_TYPE:
+        return "neuron_string";
+    default:
         return nullptr;
     }
 }
 
-extern "C" int client_execute(Client *client, const char *sql)
+// 与 client_query 读取时的列类型一致
+static std::shared_ptr<arrow::Schema> ingest_schema(ValueType type)
 {
-    if (!client)
-        return -1;
-    auto status = client->Execute(sql);
-    return status.ok() ? 0 : 1;
+    std::shared_ptr<arrow::DataType> value_type;
+    switch (type) {
+    case INT_TYPE:
+        value_type = arrow::int64();
+        break;
+    case FLOAT_TYPE:
+        value_type = arrow::float64();
+        break;
+    case BOOL_TYPE:
+        value_type = arrow::boolean();
+        break;
+    default:
+        value_type = arrow::utf8();
+        break;
+    }
+
+    return arrow::schema({
+        arrow::field("time", arrow::timestamp(arrow::TimeUnit::MILLI), false),
+        arrow::field("node_name", arrow::utf8(), false),
+        arrow::field("group_name", arrow::utf8(), false),
+        arrow::field("tag", arrow::utf8(), false),
+        arrow::field("value", value_type),
+    });
 }
 
-extern "C" void client_destroy(Client *client)
+template <typename BuilderType, typename Getter>
+static arrow::Result<std::shared_ptr<arrow::Array>>
+build_column(const datatag *tags, size_t n, Getter get)
 {
-    delete client;
+    BuilderType builder;
+    ARROW_RETURN_NOT_OK(builder.Reserve(n));
+    for (size_t i = 0; i < n; ++i) {
+        builder.UnsafeAppend(get(tags[i]));
+    }
+    return builder.Finish();
 }
 
-extern "C" int client_insert(Client *client, ValueType type, datatag *tags,
-                             size_t tag_count)
+static arrow::Result<std::shared_ptr<arrow::Array>>
+build_string_column(const datatag *tags, size_t n,
+                    const char *(*get)(const datatag &))
 {
-    if (!client || !tags)
-        return -1;
-    std::string table_name;
+    arrow::StringBuilder builder;
+    int64_t              bytes = 0;
+
+    for (size_t i = 0; i < n; ++i) {
+        const char *str = get(tags[i]);
+        bytes += str ? strlen(str) : 0;
+    }
+
+    ARROW_RETURN_NOT_OK(builder.Reserve(n));
+    ARROW_RETURN_NOT_OK(builder.ReserveData(bytes));
+    for (size_t i = 0; i < n; ++i) {
+        const char *str = get(tags[i]);
+        if (str) {
+            builder.UnsafeAppend(str, strlen(str));
+        } else {
+            builder.UnsafeAppendNull();
+        }
+    }
+    return builder.Finish();
+}
+
+/**
+ * @brief 按列把点位构造为一个 RecordBatch，每列一次性预留空间。
+ */
+static arrow::Result<std::shared_ptr<arrow::RecordBatch>>
+build_batch(ValueType type, const datatag *tags, size_t n)
+{
+    int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::system_clock::now().time_since_epoch())
+                      .count();
+
+    for (size_t i = 0; i < n; ++i) {
+        if (tags[i].value_type != type || !tags[i].node_name ||
+            !tags[i].group_name || !tags[i].tag) {
+            return arrow::Status::Invalid("invalid tag at ", i);
+        }
+    }
+
+    std::vector<std::shared_ptr<arrow::Array>> columns(5);
+
+    arrow::TimestampBuilder time_builder(
+        arrow::timestamp(arrow::TimeUnit::MILLI), arrow::default_memory_pool());
+    ARROW_RETURN_NOT_OK(time_builder.Reserve(n));
+    for (size_t i = 0; i < n; ++i) {
+        time_builder.UnsafeAppend(tags[i].timestamp ? tags[i].timestamp : now);
+    }
+    ARROW_ASSIGN_OR_RAISE(columns[0], time_builder.Finish());
+
+    ARROW_ASSIGN_OR_RAISE(
+        columns[1], build_string_column(tags, n, [](const datatag &t) {
+            return t.node_name;
+        }));
+    ARROW_ASSIGN_OR_RAISE(
+        columns[2], build_string_column(tags, n, [](const datatag &t) {
+            return t.group_name;
+        }));
+    ARROW_ASSIGN_OR_RAISE(columns[3],
+                          build_string_column(tags, n, [](const datatag &t) {
+                              return t.tag;
+                          }));
 
     switch (type) {
     case INT_TYPE:
-        table_name = "neuronex.neuron_int";
+        ARROW_ASSIGN_OR_RAISE(
+            columns[4],
+            build_column<arrow::Int64Builder>(tags, n, [](const datatag &t) {
+                return (int64_t) t.value.int_value;
+            }));
         break;
     case FLOAT_TYPE:
-        table_name = "neuronex.neuron_float";
+        ARROW_ASSIGN_OR_RAISE(
+            columns[4],
+            build_column<arrow::DoubleBuilder>(tags, n, [](const datatag &t) {
+                return (double) t.value.float_value;
+            }));
         break;
     case BOOL_TYPE:
-        table_name = "neuronex.neuron_bool";
+        ARROW_ASSIGN_OR_RAISE(
+            columns[4],
+            build_column<arrow::BooleanBuilder>(tags, n, [](const datatag &t) {
+                return t.value.bool_value;
+            }));
         break;
     case STRING_TYPE:
-        table_name = "neuronex.neuron_string";
+        ARROW_ASSIGN_OR_RAISE(
+            columns[4], build_string_column(tags, n, [](const datatag &t) {
+                return t.value.string_value;
+            }));
         break;
-    default:
-        return -1;
     }
 
-    std::string sql = "INSERT INTO " + table_name +
+    return arrow::RecordBatch::Make(ingest_schema(type), (int64_t) n,
+                                    std::move(columns));
+}
+
+extern "C" Client *client_create(const char *host, int port,
+                                 const char *username, const char *password)
+{
+    if (!host) {
+        return nullptr;
+    }
+
+    auto client = std::make_unique<Client>();
+    auto status = client->Connect(host, port, username ? username : "",
+                                  password ? password : "");
+    if (!status.ok()) {
+        std::cerr << "Error creating client: " << status.ToString()
+                  << std::endl;
+        return nullptr;
+    }
+
+    return client.release();
+}
+
+extern "C" int client_execute(Client *client, const char *sql)
+{
+    if (!client || !sql)
+        return CLIENT_ERR_INVALID;
+    auto status = client->Execute(sql);
+    if (!status.ok()) {
+        std::cerr << "Error executing SQL: " << status.ToString() << std::endl;
+    }
+    return status_to_code(status);
+}
+
+extern "C" void client_destroy(Client *client)
+{
+    delete client;
+}
+
+extern "C" int client_insert(Client *client, ValueType type, datatag *tags,
+                             size_t tag_count)
+{
+    const char *table = table_of(type);
+
+    if (!client || !tags || !table)
+        return CLIENT_ERR_INVALID;
+    if (tag_count == 0)
+        return CLIENT_OK;
+
+    auto batch = build_batch(type, tags, tag_count);
+    if (!batch.ok()) {
+        std::cerr << "Error building record batch: "
+                  << batch.status().ToString() << std::endl;
+        return status_to_code(batch.status());
+    }
+
+    auto status = client->Ingest("neuronex", table, batch.ValueOrDie());
+    if (!status.ok()) {
+        std::cerr << "Error ingesting " << tag_count
+                  << " rows: " << status.ToString() << std::endl;
+    }
+    return status_to_code(status);
+}
+
+static std::string quote(const char *str)
+{
+    std::string quoted = "'";
+    for (; *str; ++str) {
+        if (*str == '\'') {
+            quoted += '\'';
+        }
+        quoted += *str;
+    }
+    return quoted + "'";
+}
+
+extern "C" int client_insert_sql(Client *client, ValueType type, datatag *tags,
+                                 size_t tag_count)
+{
+    const char *table = table_of(type);
+
+    if (!client || !tags || !table)
+        return CLIENT_ERR_INVALID;
+    if (tag_count == 0)
+        return CLIENT_OK;
+
+    std::string sql = std::string("INSERT INTO neuronex.") + table +
         " (time, node_name, group_name, tag, value) VALUES ";
 
     for (size_t i = 0; i < tag_count; ++i) {
-        if (i > 0) {
-            sql += ", ";
-        }
         datatag &tag = tags[i];
+        if (tag.value_type != type || !tag.node_name || !tag.group_name ||
+            !tag.tag) {
+            return CLIENT_ERR_INVALID;
+        }
 
         std::string value_str;
         switch (tag.value_type) {
@@ -222,24 +505,21 @@ extern "C" int client_insert(Client *client, ValueType type, datatag *tags,
             value_str = tag.value.bool_value ? "true" : "false";
             break;
         case STRING_TYPE:
-            value_str = "'" + std::string(tag.value.string_value) + "'";
-            break;
-        default:
-            value_str = "NULL";
+            value_str = tag.value.string_value
+                ? quote(tag.value.string_value)
+                : std::string("NULL");
             break;
         }
 
-        sql += "(CURRENT_TIMESTAMP, '" + std::string(tag.node_name) + "', '" +
-            std::string(tag.group_name) + "', '" + std::string(tag.tag) +
-            "', " + value_str + ")";
-    }
-
-    int status = client_execute(client, sql.c_str());
-    if (status != 0) {
-        std::cerr << "Error executing SQL: " << status << std::endl;
+        if (i > 0) {
+            sql += ", ";
+        }
+        sql += "(CURRENT_TIMESTAMP, " + quote(tag.node_name) + ", " +
+            quote(tag.group_name) + ", " + quote(tag.tag) + ", " + value_str +
+            ")";
     }
 
-    return status;
+    return client_execute(client, sql.c_str());
 }
 
 std::string convert_timestamp_to_utc8(int64_t timestamp)
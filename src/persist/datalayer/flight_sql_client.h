@@ -1,7 +1,9 @@
 #ifndef FLIGHT_SQL_CLIENT_H
 #define FLIGHT_SQL_CLIENT_H
 
+#include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -9,6 +11,14 @@ extern "C" {
 
 typedef enum { INT_TYPE, FLOAT_TYPE, BOOL_TYPE, STRING_TYPE } ValueType;
 
+typedef enum {
+    CLIENT_OK              = 0,
+    CLIENT_ERR_INVALID     = -1, ///< 参数错误，或点位的值类型与表不符
+    CLIENT_ERR_EXECUTE     = 1,  ///< 服务端执行失败
+    CLIENT_ERR_UNAVAILABLE = 2,  ///< 连接断开或服务端不可用
+    CLIENT_ERR_INTERNAL    = 3,  ///< 构造 Arrow 数据失败
+} client_error_e;
+
 typedef union {
     int         int_value;
     float       float_value;
@@ -22,6 +32,7 @@ typedef struct {
     const char *tag;
     ValueUnion  value;
     ValueType   value_type;
+    int64_t     timestamp; ///< 毫秒时间戳，0 表示写入时间
 } datatag;
 
 typedef struct {
@@ -47,9 +58,25 @@ int client_execute(Client *client, const char *sql);
 
 void client_destroy(Client *client);
 
+/**
+ * @brief 把一批同类型点位写入对应的表。
+ *
+ * 点位按列构造为一个 Arrow RecordBatch，通过 Flight SQL 批量写入接口发送；
+ * 服务端不支持批量写入时退回到绑定参数的预编译 INSERT 语句。
+ *
+ * @return 成功返回 CLIENT_OK，失败返回 client_error_e 中的错误码。
+ */
 int client_insert(Client *client, ValueType type, datatag *tags,
                   size_t tag_count);
 
+/**
+ * @brief 拼接一条 INSERT 语句写入，仅用于不支持参数绑定的服务端。
+ *
+ * 时间列取服务端的 CURRENT_TIMESTAMP，忽略点位的 timestamp。
+ */
+int client_insert_sql(Client *client, ValueType type, datatag *tags,
+                      size_t tag_count);
+
 query_result *client_query(Client *client, ValueType type,
                            const char *node_name, const char *group_name,
                            const char *tag);
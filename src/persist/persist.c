@@ -32,6 +32,7 @@
 
 #include "errcodes.h"
 #include "utils/asprintf.h"
+#include "utils/base64.h"
 #include "utils/log.h"
 #include "utils/time.h"
 
@@ -39,6 +40,7 @@
 #include "persist/json/persist_json_plugin.h"
 #include "persist/persist.h"
 #include "persist/persist_impl.h"
+#include "persist/queue.h"
 #include "persist/sqlite.h"
 
 #include "json/neu_json_fn.h"
@@ -287,8 +289,7 @@ int neu_persister_load_plugins(UT_array **plugin_infos)
     return 0;
 }
 
-char *neu_persister_save_file_tmp(const char *file_data, uint32_t len,
-                                  const char *suffix)
+static FILE *open_file_tmp(const char *suffix, char **file_name)
 {
     struct stat st;
 
@@ -299,15 +300,28 @@ char *neu_persister_save_file_tmp(const char *file_data, uint32_t len,
         }
     }
 
-    char *file_name = calloc(1, 128);
-    snprintf(file_name, 128, "%s/%" PRId64 ".%s", tmp_path, neu_time_ms(),
+    *file_name = calloc(1, 128);
+    snprintf(*file_name, 128, "%s/%" PRId64 ".%s", tmp_path, neu_time_ms(),
              suffix);
     FILE *fp = NULL;
-    fp       = fopen(file_name, "wb+");
+    fp       = fopen(*file_name, "wb+");
     if (fp == NULL) {
-        nlog_error("not create tmp file: %s, err:%s", file_name,
+        nlog_error("not create tmp file: %s, err:%s", *file_name,
                    strerror(errno));
-        free(file_name);
+        free(*file_name);
+        *file_name = NULL;
+        return NULL;
+    }
+
+    return fp;
+}
+
+char *neu_persister_save_file_tmp(const char *file_data, uint32_t len,
+                                  const char *suffix)
+{
+    char *file_name = NULL;
+    FILE *fp        = open_file_tmp(suffix, &file_name);
+    if (fp == NULL) {
         return NULL;
     }
 
@@ -324,6 +338,27 @@ char *neu_persister_save_file_tmp(const char *file_data, uint32_t len,
     return file_name;
 }
 
+char *neu_persister_save_file_tmp_decode64(const char *data,
+                                           const char *suffix)
+{
+    char *file_name = NULL;
+    FILE *fp        = open_file_tmp(suffix, &file_name);
+    if (fp == NULL) {
+        return NULL;
+    }
+
+    // 边解码边写入，不在内存中保留解码后的完整文件
+    int64_t len = neu_decode64_to_file(data, fp);
+    if (fclose(fp) != 0 || len <= 0) {
+        nlog_warn("decode64 tmp file %s fail, len: %" PRId64, file_name, len);
+        remove(file_name);
+        free(file_name);
+        return NULL;
+    }
+
+    return file_name;
+}
+
 bool neu_persister_library_exists(const char *library)
 {
     bool      ret          = false;
@@ -363,6 +398,7 @@ bool neu_persister_library_exists(const char *library)
  * @note 
  * - `g_impl` 是一个全局变量，用于存储持久化实例的引用。
  * - 确保 `schema_dir` 指向有效的目录路径，且该目录中包含所需的 SQL 模式文件。
+ * - 同时启动持久化线程，此后所有数据库访问都经由写队列在该线程中执行。
  */
 int neu_persister_create(const char *schema_dir)
 {
@@ -370,6 +406,12 @@ int neu_persister_create(const char *schema_dir)
     if (NULL == g_impl) {
         return -1;
     }
+
+    if (0 != persist_queue_start(g_impl)) {
+        g_impl->vtbl->destroy(g_impl);
+        g_impl = NULL;
+        return -1;
+    }
     return 0;
 }
 
@@ -380,69 +422,271 @@ sqlite3 *neu_persister_get_db()
 
 void neu_persister_destroy()
 {
+    // 先写完队列中积压的命令
+    persist_queue_stop();
     g_impl->vtbl->destroy(g_impl);
 }
 
+int neu_persister_sync()
+{
+    return persist_queue_sync();
+}
+
+void neu_persister_track_begin(neu_persist_ticket_t *ticket)
+{
+    persist_queue_track_begin(ticket);
+}
+
+neu_persist_ticket_t *neu_persister_track_take()
+{
+    return persist_queue_track_take();
+}
+
+void neu_persister_track_end()
+{
+    persist_queue_track_end();
+}
+
+void neu_persister_ticket_wait(neu_persist_ticket_t *ticket,
+                               neu_persist_ticket_cb cb, void *arg)
+{
+    persist_ticket_wait(ticket, cb, arg);
+}
+
+void neu_persister_ticket_release(neu_persist_ticket_t *ticket)
+{
+    persist_ticket_release(ticket);
+}
+
+static inline char *str_dup(const char *s)
+{
+    return NULL == s ? NULL : strdup(s);
+}
+
+static persist_cmd_t *cmd_new(persist_exec_fn exec)
+{
+    persist_cmd_t *cmd = calloc(1, sizeof(persist_cmd_t));
+    cmd->exec          = exec;
+    return cmd;
+}
+
+static UT_array *tags_dup(const neu_datatag_t *tags, size_t n)
+{
+    UT_array *arr = NULL;
+
+    utarray_new(arr, neu_tag_get_icd());
+    utarray_reserve(arr, n);
+    for (size_t i = 0; i < n; i++) {
+        utarray_push_back(arr, &tags[i]);
+    }
+    return arr;
+}
+
+static int exec_store_node(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    neu_persist_node_info_t info = {
+        .name        = cmd->str[0],
+        .plugin_name = cmd->str[1],
+        .type        = (int) cmd->num[0],
+        .state       = (int) cmd->num[1],
+    };
+    return impl->vtbl->store_node(impl, &info);
+}
+
 int neu_persister_store_node(neu_persist_node_info_t *info)
 {
-    return g_impl->vtbl->store_node(g_impl, info);
+    persist_cmd_t *cmd = cmd_new(exec_store_node);
+    cmd->str[0]        = str_dup(info->name);
+    cmd->str[1]        = str_dup(info->plugin_name);
+    cmd->num[0]        = info->type;
+    cmd->num[1]        = info->state;
+    persist_queue_push(cmd);
+    return 0;
+}
+
+static int exec_load_nodes(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->load_nodes(impl, (UT_array **) cmd->out);
 }
 
 int neu_persister_load_nodes(UT_array **node_infos)
 {
-    return g_impl->vtbl->load_nodes(g_impl, node_infos);
+    persist_cmd_t cmd = { .exec = exec_load_nodes, .out = node_infos };
+    return persist_queue_call(&cmd);
+}
+
+static int exec_delete_node(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->delete_node(impl, cmd->str[0]);
 }
 
 int neu_persister_delete_node(const char *node_name)
 {
-    return g_impl->vtbl->delete_node(g_impl, node_name);
+    persist_cmd_t *cmd = cmd_new(exec_delete_node);
+    cmd->str[0]        = str_dup(node_name);
+    persist_queue_push(cmd);
+    return 0;
+}
+
+static int exec_update_node(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->update_node(impl, cmd->str[0], cmd->str[1]);
 }
 
 int neu_persister_update_node(const char *node_name, const char *new_name)
 {
-    return g_impl->vtbl->update_node(g_impl, node_name, new_name);
+    persist_cmd_t *cmd = cmd_new(exec_update_node);
+    cmd->str[0]        = str_dup(node_name);
+    cmd->str[1]        = str_dup(new_name);
+    persist_queue_push(cmd);
+    return 0;
+}
+
+static int exec_update_node_state(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->update_node_state(impl, cmd->str[0], (int) cmd->num[0]);
 }
 
 int neu_persister_update_node_state(const char *node_name, int state)
 {
-    return g_impl->vtbl->update_node_state(g_impl, node_name, state);
+    persist_cmd_t *cmd = cmd_new(exec_update_node_state);
+    cmd->str[0]        = str_dup(node_name);
+    cmd->num[0]        = state;
+    // 同一节点连续的状态更新只保留最后一次
+    neu_asprintf(&cmd->key, "state\x1f%s", node_name);
+    persist_queue_push(cmd);
+    return 0;
+}
+
+static int exec_store_tags(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->store_tags(impl, cmd->str[0], cmd->str[1],
+                                  (neu_datatag_t *) utarray_front(cmd->tags),
+                                  utarray_len(cmd->tags));
+}
+
+static int exec_store_tag(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->store_tag(impl, cmd->str[0], cmd->str[1],
+                                 (neu_datatag_t *) utarray_front(cmd->tags));
 }
 
 int neu_persister_store_tag(const char *driver_name, const char *group_name,
                             const neu_datatag_t *tag)
 {
-    return g_impl->vtbl->store_tag(g_impl, driver_name, group_name, tag);
+    persist_cmd_t *cmd = cmd_new(exec_store_tag);
+    cmd->str[0]        = str_dup(driver_name);
+    cmd->str[1]        = str_dup(group_name);
+    cmd->tags          = tags_dup(tag, 1);
+    persist_queue_push(cmd);
+    return 0;
 }
 
 int neu_persister_store_tags(const char *driver_name, const char *group_name,
                              const neu_datatag_t *tags, size_t n)
 {
-    return g_impl->vtbl->store_tags(g_impl, driver_name, group_name, tags, n);
+    persist_cmd_t *cmd = cmd_new(exec_store_tags);
+    cmd->str[0]        = str_dup(driver_name);
+    cmd->str[1]        = str_dup(group_name);
+    cmd->tags          = tags_dup(tags, n);
+    persist_queue_push(cmd);
+    return 0;
+}
+
+static int exec_load_tags(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->load_tags(impl, cmd->str[0], cmd->str[1],
+                                 (UT_array **) cmd->out);
 }
 
 int neu_persister_load_tags(const char *driver_name, const char *group_name,
                             UT_array **tags)
 {
-    return g_impl->vtbl->load_tags(g_impl, driver_name, group_name, tags);
+    persist_cmd_t cmd = {
+        .exec = exec_load_tags,
+        .str  = { (char *) driver_name, (char *) group_name },
+        .out  = tags,
+    };
+    return persist_queue_call(&cmd);
+}
+
+static int exec_load_node_tags(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->load_node_tags(impl, cmd->str[0],
+                                      (UT_array **) cmd->out);
+}
+
+int neu_persister_load_node_tags(const char *driver_name, UT_array **group_tags)
+{
+    persist_cmd_t cmd = {
+        .exec = exec_load_node_tags,
+        .str  = { (char *) driver_name },
+        .out  = group_tags,
+    };
+    return persist_queue_call(&cmd);
+}
+
+static int exec_update_tag(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->update_tag(impl, cmd->str[0], cmd->str[1],
+                                  (neu_datatag_t *) utarray_front(cmd->tags));
 }
 
 int neu_persister_update_tag(const char *driver_name, const char *group_name,
                              const neu_datatag_t *tag)
 {
-    return g_impl->vtbl->update_tag(g_impl, driver_name, group_name, tag);
+    persist_cmd_t *cmd = cmd_new(exec_update_tag);
+    cmd->str[0]        = str_dup(driver_name);
+    cmd->str[1]        = str_dup(group_name);
+    cmd->tags          = tags_dup(tag, 1);
+    persist_queue_push(cmd);
+    return 0;
+}
+
+static int exec_update_tag_value(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->update_tag_value(
+        impl, cmd->str[0], cmd->str[1],
+        (neu_datatag_t *) utarray_front(cmd->tags));
 }
 
 int neu_persister_update_tag_value(const char *         driver_name,
                                    const char *         group_name,
                                    const neu_datatag_t *tag)
 {
-    return g_impl->vtbl->update_tag_value(g_impl, driver_name, group_name, tag);
+    persist_cmd_t *cmd = cmd_new(exec_update_tag_value);
+    cmd->str[0]        = str_dup(driver_name);
+    cmd->str[1]        = str_dup(group_name);
+    cmd->tags          = tags_dup(tag, 1);
+    // 同一点位连续的值更新只保留最后一次
+    neu_asprintf(&cmd->key, "value\x1f%s\x1f%s\x1f%s", driver_name,
+                 group_name, tag->name);
+    persist_queue_push(cmd);
+    return 0;
+}
+
+static int exec_delete_tag(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->delete_tag(impl, cmd->str[0], cmd->str[1],
+                                  cmd->str[2]);
 }
 
 int neu_persister_delete_tag(const char *driver_name, const char *group_name,
                              const char *tag_name)
 {
-    return g_impl->vtbl->delete_tag(g_impl, driver_name, group_name, tag_name);
+    persist_cmd_t *cmd = cmd_new(exec_delete_tag);
+    cmd->str[0]        = str_dup(driver_name);
+    cmd->str[1]        = str_dup(group_name);
+    cmd->str[2]        = str_dup(tag_name);
+    persist_queue_push(cmd);
+    return 0;
+}
+
+static int exec_store_subscription(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->store_subscription(impl, cmd->str[0], cmd->str[1],
+                                          cmd->str[2], cmd->str[3],
+                                          cmd->str[4]);
 }
 
 int neu_persister_store_subscription(const char *app_name,
@@ -450,8 +694,21 @@ int neu_persister_store_subscription(const char *app_name,
                                      const char *group_name, const char *params,
                                      const char *static_tags)
 {
-    return g_impl->vtbl->store_subscription(g_impl, app_name, driver_name,
-                                            group_name, params, static_tags);
+    persist_cmd_t *cmd = cmd_new(exec_store_subscription);
+    cmd->str[0]        = str_dup(app_name);
+    cmd->str[1]        = str_dup(driver_name);
+    cmd->str[2]        = str_dup(group_name);
+    cmd->str[3]        = str_dup(params);
+    cmd->str[4]        = str_dup(static_tags);
+    persist_queue_push(cmd);
+    return 0;
+}
+
+static int exec_update_subscription(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->update_subscription(impl, cmd->str[0], cmd->str[1],
+                                           cmd->str[2], cmd->str[3],
+                                           cmd->str[4]);
 }
 
 int neu_persister_update_subscription(const char *app_name,
@@ -460,59 +717,151 @@ int neu_persister_update_subscription(const char *app_name,
                                       const char *params,
                                       const char *static_tags)
 {
-    return g_impl->vtbl->update_subscription(g_impl, app_name, driver_name,
-                                             group_name, params, static_tags);
+    persist_cmd_t *cmd = cmd_new(exec_update_subscription);
+    cmd->str[0]        = str_dup(app_name);
+    cmd->str[1]        = str_dup(driver_name);
+    cmd->str[2]        = str_dup(group_name);
+    cmd->str[3]        = str_dup(params);
+    cmd->str[4]        = str_dup(static_tags);
+    persist_queue_push(cmd);
+    return 0;
+}
+
+static int exec_load_subscriptions(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->load_subscriptions(impl, cmd->str[0],
+                                          (UT_array **) cmd->out);
 }
 
 int neu_persister_load_subscriptions(const char *app_name,
                                      UT_array ** subscription_infos)
 {
-    return g_impl->vtbl->load_subscriptions(g_impl, app_name,
-                                            subscription_infos);
+    persist_cmd_t cmd = {
+        .exec = exec_load_subscriptions,
+        .str  = { (char *) app_name },
+        .out  = subscription_infos,
+    };
+    return persist_queue_call(&cmd);
+}
+
+static int exec_delete_subscription(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->delete_subscription(impl, cmd->str[0], cmd->str[1],
+                                           cmd->str[2]);
 }
 
 int neu_persister_delete_subscription(const char *app_name,
                                       const char *driver_name,
                                       const char *group_name)
 {
-    return g_impl->vtbl->delete_subscription(g_impl, app_name, driver_name,
-                                             group_name);
+    persist_cmd_t *cmd = cmd_new(exec_delete_subscription);
+    cmd->str[0]        = str_dup(app_name);
+    cmd->str[1]        = str_dup(driver_name);
+    cmd->str[2]        = str_dup(group_name);
+    persist_queue_push(cmd);
+    return 0;
+}
+
+static int exec_store_group(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    neu_persist_group_info_t info = {
+        .name     = cmd->str[1],
+        .interval = (uint32_t) cmd->num[0],
+    };
+    return impl->vtbl->store_group(impl, cmd->str[0], &info, cmd->str[2]);
 }
 
 int neu_persister_store_group(const char *              driver_name,
                               neu_persist_group_info_t *group_info,
                               const char *              context)
 {
-    return g_impl->vtbl->store_group(g_impl, driver_name, group_info, context);
+    persist_cmd_t *cmd = cmd_new(exec_store_group);
+    cmd->str[0]        = str_dup(driver_name);
+    cmd->str[1]        = str_dup(group_info->name);
+    cmd->str[2]        = str_dup(context);
+    cmd->num[0]        = group_info->interval;
+    persist_queue_push(cmd);
+    return 0;
+}
+
+static int exec_update_group(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    neu_persist_group_info_t info = {
+        .name     = cmd->str[2],
+        .interval = (uint32_t) cmd->num[0],
+    };
+    return impl->vtbl->update_group(impl, cmd->str[0], cmd->str[1], &info);
 }
 
 int neu_persister_update_group(const char *driver_name, const char *group_name,
                                neu_persist_group_info_t *group_info)
 {
-    return g_impl->vtbl->update_group(g_impl, driver_name, group_name,
-                                      group_info);
+    persist_cmd_t *cmd = cmd_new(exec_update_group);
+    cmd->str[0]        = str_dup(driver_name);
+    cmd->str[1]        = str_dup(group_name);
+    cmd->str[2]        = str_dup(group_info->name);
+    cmd->num[0]        = group_info->interval;
+    persist_queue_push(cmd);
+    return 0;
+}
+
+static int exec_load_groups(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->load_groups(impl, cmd->str[0], (UT_array **) cmd->out);
 }
 
 int neu_persister_load_groups(const char *driver_name, UT_array **group_infos)
 {
-    return g_impl->vtbl->load_groups(g_impl, driver_name, group_infos);
+    persist_cmd_t cmd = {
+        .exec = exec_load_groups,
+        .str  = { (char *) driver_name },
+        .out  = group_infos,
+    };
+    return persist_queue_call(&cmd);
+}
+
+static int exec_delete_group(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->delete_group(impl, cmd->str[0], cmd->str[1]);
 }
 
 int neu_persister_delete_group(const char *driver_name, const char *group_name)
 {
-    return g_impl->vtbl->delete_group(g_impl, driver_name, group_name);
+    persist_cmd_t *cmd = cmd_new(exec_delete_group);
+    cmd->str[0]        = str_dup(driver_name);
+    cmd->str[1]        = str_dup(group_name);
+    persist_queue_push(cmd);
+    return 0;
+}
+
+static int exec_store_node_setting(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->store_node_setting(impl, cmd->str[0], cmd->str[1]);
 }
 
 int neu_persister_store_node_setting(const char *node_name, const char *setting)
 {
-    return g_impl->vtbl->store_node_setting(g_impl, node_name, setting);
+    persist_cmd_t *cmd = cmd_new(exec_store_node_setting);
+    cmd->str[0]        = str_dup(node_name);
+    cmd->str[1]        = str_dup(setting);
+    // 同一节点连续的配置更新只保留最后一次
+    neu_asprintf(&cmd->key, "setting\x1f%s", node_name);
+    persist_queue_push(cmd);
+    return 0;
+}
+
+static int exec_load_node_setting(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->load_node_setting(impl, cmd->str[0],
+                                         (const char **) cmd->out);
 }
 
 /**
  * @brief 从持久化存储中加载指定节点的设置信息。
  *
- * 该函数通过调用由全局变量 `g_impl` 所指向的结构体中 `vtbl` 成员（函数指针表）
- * 里的 `load_node_setting` 函数，来实现从持久化存储中读取指定节点的设置信息的功能。
+ * 该函数以同步命令提交给持久化线程，由 `g_impl` 所指向的结构体中 `vtbl` 成员
+ * （函数指针表）里的 `load_node_setting` 函数读取指定节点的设置信息。之前入队
+ * 的写操作会先执行，因此总能读到最近一次保存的设置。
  *
  * @param node_name 指向一个表示节点名称的字符串的指针，用于唯一标识要加载设置信息的节点。
  * @param setting 指向一个常量字符指针的常量指针。函数会将从持久化存储中读取到的节点设置
@@ -524,36 +873,116 @@ int neu_persister_store_node_setting(const char *node_name, const char *setting)
 int neu_persister_load_node_setting(const char *       node_name,
                                     const char **const setting)
 {
-    return g_impl->vtbl->load_node_setting(g_impl, node_name, setting);
+    persist_cmd_t cmd = {
+        .exec = exec_load_node_setting,
+        .str  = { (char *) node_name },
+        .out  = (void *) setting,
+    };
+    return persist_queue_call(&cmd);
+}
+
+static int exec_delete_node_setting(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->delete_node_setting(impl, cmd->str[0]);
 }
 
 int neu_persister_delete_node_setting(const char *node_name)
 {
-    return g_impl->vtbl->delete_node_setting(g_impl, node_name);
+    persist_cmd_t *cmd = cmd_new(exec_delete_node_setting);
+    cmd->str[0]        = str_dup(node_name);
+    persist_queue_push(cmd);
+    return 0;
+}
+
+// 用户信息的修改由 REST 接口直接调用并依赖返回值，以同步命令执行
+
+static int exec_store_user(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->store_user(impl,
+                                  (const neu_persist_user_info_t *) cmd->in);
 }
 
 int neu_persister_store_user(const neu_persist_user_info_t *user)
 {
-    return g_impl->vtbl->store_user(g_impl, user);
+    persist_cmd_t cmd = { .exec = exec_store_user, .in = user };
+    return persist_queue_call(&cmd);
+}
+
+static int exec_update_user(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->update_user(impl,
+                                   (const neu_persist_user_info_t *) cmd->in);
 }
 
 int neu_persister_update_user(const neu_persist_user_info_t *user)
 {
-    return g_impl->vtbl->update_user(g_impl, user);
+    persist_cmd_t cmd = { .exec = exec_update_user, .in = user };
+    return persist_queue_call(&cmd);
+}
+
+static int exec_load_user(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->load_user(impl, cmd->str[0],
+                                 (neu_persist_user_info_t **) cmd->out);
 }
 
 int neu_persister_load_user(const char *              user_name,
                             neu_persist_user_info_t **user_p)
 {
-    return g_impl->vtbl->load_user(g_impl, user_name, user_p);
+    persist_cmd_t cmd = {
+        .exec = exec_load_user,
+        .str  = { (char *) user_name },
+        .out  = user_p,
+    };
+    return persist_queue_call(&cmd);
+}
+
+static int exec_delete_user(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->delete_user(impl, cmd->str[0]);
 }
 
 int neu_persister_delete_user(const char *user_name)
 {
-    return g_impl->vtbl->delete_user(g_impl, user_name);
+    persist_cmd_t cmd = {
+        .exec = exec_delete_user,
+        .str  = { (char *) user_name },
+    };
+    return persist_queue_call(&cmd);
+}
+
+static int exec_load_users(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->load_users(impl, (UT_array **) cmd->out);
 }
 
 int neu_persister_load_users(UT_array **user_infos)
 {
-    return g_impl->vtbl->load_users(g_impl, user_infos);
+    persist_cmd_t cmd = { .exec = exec_load_users, .out = user_infos };
+    return persist_queue_call(&cmd);
+}
+
+static int exec_import(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->import(impl, (const neu_persist_import_t *) cmd->in);
+}
+
+int neu_persister_import(const neu_persist_import_t *import)
+{
+    persist_cmd_t cmd = { .exec = exec_import, .in = import };
+    return persist_queue_call(&cmd);
+}
+
+static int exec_import_end(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    return impl->vtbl->import_end(impl, 0 != cmd->num[0]);
+}
+
+int neu_persister_import_end(bool rollback)
+{
+    persist_cmd_t cmd = {
+        .exec = exec_import_end,
+        .num  = { rollback },
+    };
+    return persist_queue_call(&cmd);
 }
@@ -124,6 +124,15 @@ struct neu_persister_vtbl_s {
     int (*load_tags)(neu_persister_t *self, const char *driver_name,
                      const char *group_name, UT_array **tag_infos);
 
+    /**
+     * 一次查询加载节点下所有组的标签信息。
+     * @param driver_name               驱动程序名称。
+     * @param[out] group_tags           用于返回指向堆分配的 neu_persist_group_tags_t 向量的指针。
+     * @return 成功返回 0，失败返回非零值。
+     */
+    int (*load_node_tags)(neu_persister_t *self, const char *driver_name,
+                          UT_array **group_tags);
+
     /**
      * 更新节点标签。
      * @param driver_name               驱动程序名称。
@@ -277,6 +286,20 @@ struct neu_persister_vtbl_s {
      * @return 成功返回 0，失败返回非零值。
      */
     int (*delete_user)(neu_persister_t *self, const char *user_name);
+
+    /**
+     * 导入全局配置，导入前的配置保留为快照。
+     * @param import                    导入的配置。
+     * @return 成功返回 0，失败返回非零值且不做任何修改。
+     */
+    int (*import)(neu_persister_t *self, const neu_persist_import_t *import);
+
+    /**
+     * 结束导入。
+     * @param rollback                  为 true 时恢复导入前的快照，否则丢弃。
+     * @return 成功返回 0，失败返回非零值。
+     */
+    int (*import_end)(neu_persister_t *self, bool rollback);
 };
 
 
@@ -0,0 +1,495 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <sqlite3.h>
+
+#include "errcodes.h"
+#include "utils/log.h"
+
+#include "persist/queue.h"
+
+struct neu_persist_ticket {
+    uint32_t          pending;   // 尚未执行的命令数
+    int               rv;        // 第一个失败命令的结果
+    bool              abandoned; // 持有者已放弃等待
+    persist_ticket_cb cb;
+    void *            arg;
+
+    persist_ticket_t *next;
+};
+
+static struct {
+    pthread_mutex_t mtx;
+    pthread_cond_t  cond;      // 有新命令或需要停止
+    pthread_cond_t  done_cond; // 有命令执行完成
+    pthread_t       tid;
+    bool            running;
+    bool            stop;
+
+    neu_persister_t *impl;
+
+    persist_cmd_t *head;
+    persist_cmd_t *tail;
+    persist_cmd_t *index; // 队列中可合并命令的 key 索引
+
+    uint64_t seq;      // 最后入队命令的序号
+    uint64_t done_seq; // 最后执行完成命令的序号
+    uint64_t fail_seq; // 最后执行失败命令的序号
+
+    persist_queue_stats_t stats;
+} g_queue = {
+    .mtx       = PTHREAD_MUTEX_INITIALIZER,
+    .cond      = PTHREAD_COND_INITIALIZER,
+    .done_cond = PTHREAD_COND_INITIALIZER,
+};
+
+// 当前线程正在处理的请求的记录
+static __thread bool              t_tracking = false;
+static __thread persist_ticket_t *t_ticket   = NULL;
+
+static void cmd_free(persist_cmd_t *cmd)
+{
+    free(cmd->key);
+    for (size_t i = 0; i < sizeof(cmd->str) / sizeof(cmd->str[0]); i++) {
+        free(cmd->str[i]);
+    }
+    if (cmd->tags != NULL) {
+        utarray_free(cmd->tags);
+    }
+    free(cmd);
+}
+
+// 把 cmd 的参数与 other 交换，key 相同无需交换
+static void cmd_swap_args(persist_cmd_t *cmd, persist_cmd_t *other)
+{
+    persist_cmd_t tmp = *cmd;
+
+    cmd->exec = other->exec;
+    memcpy(cmd->str, other->str, sizeof(cmd->str));
+    memcpy(cmd->num, other->num, sizeof(cmd->num));
+    cmd->tags = other->tags;
+
+    other->exec = tmp.exec;
+    memcpy(other->str, tmp.str, sizeof(other->str));
+    memcpy(other->num, tmp.num, sizeof(other->num));
+    other->tags = tmp.tags;
+}
+
+// 调用者持有 g_queue.mtx
+static void cmd_append(persist_cmd_t *cmd)
+{
+    cmd->seq  = ++g_queue.seq;
+    cmd->next = NULL;
+
+    if (g_queue.tail == NULL) {
+        g_queue.head = cmd;
+    } else {
+        g_queue.tail->next = cmd;
+    }
+    g_queue.tail = cmd;
+
+    if (cmd->key != NULL) {
+        HASH_ADD_KEYPTR(hh, g_queue.index, cmd->key, strlen(cmd->key), cmd);
+    } else {
+        // 不可合并的命令之后入队的命令不能越过它与之前的命令合并
+        HASH_CLEAR(hh, g_queue.index);
+    }
+
+    g_queue.stats.pending += 1;
+    pthread_cond_signal(&g_queue.cond);
+}
+
+// 调用者持有 g_queue.mtx，记录上的命令全部完成且已有等待者时加入 fired
+static void ticket_done(persist_ticket_t *ticket, int rv,
+                        persist_ticket_t **fired)
+{
+    if (rv != 0 && ticket->rv == 0) {
+        ticket->rv = rv;
+    }
+
+    ticket->pending -= 1;
+    if (ticket->pending > 0) {
+        return;
+    }
+
+    if (ticket->abandoned) {
+        free(ticket);
+    } else if (ticket->cb != NULL) {
+        ticket->next = *fired;
+        *fired       = ticket;
+    }
+}
+
+static inline void exec_sql(sqlite3 *db, const char *sql)
+{
+    char *err_msg = NULL;
+
+    if (SQLITE_OK != sqlite3_exec(db, sql, NULL, NULL, &err_msg)) {
+        nlog_error("persist queue `%s` fail: %s", sql, err_msg);
+    }
+    sqlite3_free(err_msg);
+}
+
+/**
+ * @brief 在一个事务中执行一批命令。
+ *
+ * 每个命令包在一个保存点中，单个命令失败只回滚它自己的修改，不影响同批的
+ * 其他命令；事务提交失败时整批命令视为失败。
+ */
+static void batch_exec(persist_cmd_t *batch)
+{
+    neu_persister_t *impl = g_queue.impl;
+    sqlite3 *        db   = impl->vtbl->native_handle(impl);
+    bool             tx   = false;
+
+    if (SQLITE_OK == sqlite3_exec(db, "BEGIN", NULL, NULL, NULL)) {
+        tx = true;
+    } else {
+        // 开启事务失败时退化为逐条自动提交
+        nlog_error("persist queue begin fail: %s", sqlite3_errmsg(db));
+    }
+
+    for (persist_cmd_t *cmd = batch; cmd != NULL; cmd = cmd->next) {
+        if (tx) {
+            exec_sql(db, "SAVEPOINT persist_cmd");
+        }
+
+        cmd->rv = cmd->exec(impl, cmd);
+
+        // 严重错误时 SQLite 会自动回滚整个事务，此时保存点已不存在
+        if (tx && !sqlite3_get_autocommit(db)) {
+            if (cmd->rv != 0) {
+                exec_sql(db, "ROLLBACK TO persist_cmd");
+            }
+            exec_sql(db, "RELEASE persist_cmd");
+        }
+    }
+
+    if (tx && !sqlite3_get_autocommit(db) &&
+        SQLITE_OK != sqlite3_exec(db, "COMMIT", NULL, NULL, NULL)) {
+        nlog_error("persist queue commit fail: %s", sqlite3_errmsg(db));
+        exec_sql(db, "ROLLBACK");
+
+        for (persist_cmd_t *cmd = batch; cmd != NULL; cmd = cmd->next) {
+            cmd->rv = NEU_ERR_EINTERNAL;
+        }
+    }
+}
+
+static void *persist_queue_loop(void *arg)
+{
+    (void) arg;
+
+    pthread_mutex_lock(&g_queue.mtx);
+    while (true) {
+        while (g_queue.head == NULL && !g_queue.stop) {
+            pthread_cond_wait(&g_queue.cond, &g_queue.mtx);
+        }
+
+        if (g_queue.head == NULL) {
+            break;
+        }
+
+        // 取走积压的全部命令，执行期间新入队的命令进入下一批
+        persist_cmd_t *batch = g_queue.head;
+        uint64_t       last  = g_queue.tail->seq;
+        uint64_t       n     = g_queue.stats.pending;
+
+        g_queue.head          = NULL;
+        g_queue.tail          = NULL;
+        g_queue.stats.pending = 0;
+        HASH_CLEAR(hh, g_queue.index);
+        pthread_mutex_unlock(&g_queue.mtx);
+
+        batch_exec(batch);
+
+        persist_ticket_t *fired = NULL;
+        pthread_mutex_lock(&g_queue.mtx);
+        for (persist_cmd_t *cmd = batch; cmd != NULL; cmd = cmd->next) {
+            if (cmd->ticket != NULL) {
+                ticket_done(cmd->ticket, cmd->rv, &fired);
+            }
+        }
+        pthread_mutex_unlock(&g_queue.mtx);
+
+        // 回调可能发送应答，不能持有锁
+        while (fired != NULL) {
+            persist_ticket_t *ticket = fired;
+            fired                    = ticket->next;
+            ticket->cb(ticket->rv, ticket->arg);
+            free(ticket);
+        }
+
+        persist_cmd_t *waits     = NULL;
+        uint64_t       fail_seq  = 0;
+        uint64_t       n_failed  = 0;
+        persist_cmd_t *cmd       = batch;
+        persist_cmd_t *next      = NULL;
+        persist_cmd_t *last_wait = NULL;
+
+        for (; cmd != NULL; cmd = next) {
+            next = cmd->next;
+
+            if (cmd->rv != 0) {
+                fail_seq = cmd->seq;
+                n_failed += 1;
+            }
+
+            if (cmd->wait) {
+                // 同步命令由调用者释放，置 done 之后不能再访问
+                cmd->next = NULL;
+                if (last_wait == NULL) {
+                    waits = cmd;
+                } else {
+                    last_wait->next = cmd;
+                }
+                last_wait = cmd;
+            } else {
+                cmd_free(cmd);
+            }
+        }
+
+        if (n > 1) {
+            nlog_debug("persist queue commit %" PRIu64 " cmds, %" PRIu64
+                       " failed",
+                       n, n_failed);
+        }
+
+        pthread_mutex_lock(&g_queue.mtx);
+        g_queue.done_seq = last;
+        if (fail_seq > g_queue.fail_seq) {
+            g_queue.fail_seq = fail_seq;
+        }
+        g_queue.stats.executed += n;
+        g_queue.stats.failed += n_failed;
+        g_queue.stats.batches += 1;
+
+        for (cmd = waits; cmd != NULL; cmd = next) {
+            next      = cmd->next;
+            cmd->done = true;
+        }
+        pthread_cond_broadcast(&g_queue.done_cond);
+    }
+    pthread_mutex_unlock(&g_queue.mtx);
+
+    return NULL;
+}
+
+int persist_queue_start(neu_persister_t *impl)
+{
+    int rv = 0;
+
+    pthread_mutex_lock(&g_queue.mtx);
+    if (g_queue.running) {
+        pthread_mutex_unlock(&g_queue.mtx);
+        return -1;
+    }
+
+    g_queue.impl = impl;
+    g_queue.stop = false;
+    if (0 != pthread_create(&g_queue.tid, NULL, persist_queue_loop, NULL)) {
+        nlog_error("persist queue fail to create thread");
+        rv = -1;
+    } else {
+        g_queue.running = true;
+    }
+    pthread_mutex_unlock(&g_queue.mtx);
+
+    return rv;
+}
+
+void persist_queue_stop(void)
+{
+    pthread_mutex_lock(&g_queue.mtx);
+    if (!g_queue.running) {
+        pthread_mutex_unlock(&g_queue.mtx);
+        return;
+    }
+    // 此后入队的命令被拒绝，已入队的命令执行完线程才退出
+    g_queue.stop    = true;
+    g_queue.running = false;
+    pthread_cond_signal(&g_queue.cond);
+    pthread_mutex_unlock(&g_queue.mtx);
+
+    pthread_join(g_queue.tid, NULL);
+}
+
+void persist_queue_push(persist_cmd_t *cmd)
+{
+    persist_cmd_t *   find   = NULL;
+    persist_ticket_t *ticket = NULL;
+
+    cmd->wait   = false;
+    cmd->ticket = NULL;
+
+    if (t_tracking && t_ticket == NULL) {
+        t_ticket = calloc(1, sizeof(persist_ticket_t));
+    }
+    ticket = t_tracking ? t_ticket : NULL;
+
+    pthread_mutex_lock(&g_queue.mtx);
+    if (!g_queue.running) {
+        pthread_mutex_unlock(&g_queue.mtx);
+        nlog_warn("persist queue is not running, drop cmd");
+        cmd_free(cmd);
+        return;
+    }
+
+    if (cmd->key != NULL) {
+        HASH_FIND_STR(g_queue.index, cmd->key, find);
+    }
+
+    if (find != NULL && ticket != NULL && find->ticket != NULL &&
+        find->ticket != ticket) {
+        // 属于另一个请求的命令不合并，否则两个请求会拿到对方的结果
+        HASH_DEL(g_queue.index, find);
+        find = NULL;
+    }
+
+    if (find != NULL) {
+        // 尚未执行的同 key 命令直接改用新参数，队列中的位置不变
+        cmd_swap_args(find, cmd);
+        if (ticket != NULL && find->ticket == NULL) {
+            find->ticket = ticket;
+            ticket->pending += 1;
+        }
+        g_queue.stats.coalesced += 1;
+        pthread_mutex_unlock(&g_queue.mtx);
+
+        cmd_free(cmd);
+        return;
+    }
+
+    if (ticket != NULL) {
+        cmd->ticket = ticket;
+        ticket->pending += 1;
+    }
+    cmd_append(cmd);
+    pthread_mutex_unlock(&g_queue.mtx);
+}
+
+int persist_queue_call(persist_cmd_t *cmd)
+{
+    cmd->key    = NULL;
+    cmd->wait   = true;
+    cmd->done   = false;
+    cmd->ticket = NULL;
+
+    pthread_mutex_lock(&g_queue.mtx);
+    if (!g_queue.running) {
+        pthread_mutex_unlock(&g_queue.mtx);
+        nlog_warn("persist queue is not running");
+        return NEU_ERR_EINTERNAL;
+    }
+
+    cmd_append(cmd);
+    while (!cmd->done) {
+        pthread_cond_wait(&g_queue.done_cond, &g_queue.mtx);
+    }
+    pthread_mutex_unlock(&g_queue.mtx);
+
+    return cmd->rv;
+}
+
+int persist_queue_sync(void)
+{
+    int rv = 0;
+
+    pthread_mutex_lock(&g_queue.mtx);
+    uint64_t start  = g_queue.done_seq;
+    uint64_t target = g_queue.seq;
+
+    while (g_queue.done_seq < target) {
+        pthread_cond_wait(&g_queue.done_cond, &g_queue.mtx);
+    }
+
+    if (g_queue.fail_seq > start) {
+        rv = NEU_ERR_EINTERNAL;
+    }
+    pthread_mutex_unlock(&g_queue.mtx);
+
+    return rv;
+}
+
+void persist_queue_stats(persist_queue_stats_t *stats)
+{
+    pthread_mutex_lock(&g_queue.mtx);
+    *stats = g_queue.stats;
+    pthread_mutex_unlock(&g_queue.mtx);
+}
+
+void persist_queue_track_begin(persist_ticket_t *ticket)
+{
+    persist_queue_track_end();
+
+    t_tracking = true;
+    t_ticket   = ticket;
+}
+
+persist_ticket_t *persist_queue_track_take(void)
+{
+    persist_ticket_t *ticket = t_ticket;
+
+    t_ticket = NULL;
+    return ticket;
+}
+
+void persist_queue_track_end(void)
+{
+    if (t_ticket != NULL) {
+        persist_ticket_release(t_ticket);
+    }
+
+    t_tracking = false;
+    t_ticket   = NULL;
+}
+
+void persist_ticket_wait(persist_ticket_t *ticket, persist_ticket_cb cb,
+                         void *arg)
+{
+    pthread_mutex_lock(&g_queue.mtx);
+    if (ticket->pending > 0) {
+        ticket->cb  = cb;
+        ticket->arg = arg;
+        pthread_mutex_unlock(&g_queue.mtx);
+        return;
+    }
+    pthread_mutex_unlock(&g_queue.mtx);
+
+    cb(ticket->rv, arg);
+    free(ticket);
+}
+
+void persist_ticket_release(persist_ticket_t *ticket)
+{
+    pthread_mutex_lock(&g_queue.mtx);
+    if (ticket->pending > 0) {
+        // 由持久化线程在最后一个命令完成时释放
+        ticket->abandoned = true;
+        ticket = NULL;
+    }
+    pthread_mutex_unlock(&g_queue.mtx);
+
+    free(ticket);
+}
@@ -0,0 +1,158 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+#ifndef NEU_PERSIST_QUEUE_H
+#define NEU_PERSIST_QUEUE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "utils/utarray.h"
+#include "utils/uthash.h"
+
+#include "persist/persist_impl.h"
+
+/**
+ * @brief 持久化写队列。
+ *
+ * 所有数据库访问都在一个专用线程中执行：写操作入队后立即返回，线程把队列中
+ * 积压的命令放进同一个事务提交；带 key 的命令与队列中尚未执行的同 key 命令
+ * 合并，只保留最后一次的参数。读操作与需要结果的写操作以同步命令入队，按入队
+ * 顺序执行，因此总能读到调用者之前提交的写入。
+ */
+
+typedef struct persist_cmd persist_cmd_t;
+
+/**
+ * @brief 一个请求入队的异步命令的执行记录。
+ *
+ * 处理请求的线程在 persist_queue_track_begin 与 persist_queue_track_end
+ * 之间入队的异步命令都记在同一个 ticket 上，等待 ticket 只等这些命令，
+ * 结果也只取这些命令的结果。
+ */
+typedef struct neu_persist_ticket persist_ticket_t;
+
+typedef void (*persist_ticket_cb)(int rv, void *arg);
+
+typedef int (*persist_exec_fn)(neu_persister_t *impl, persist_cmd_t *cmd);
+
+struct persist_cmd {
+    persist_exec_fn exec;
+
+    /**
+     * 合并键，NULL 表示不可合并；不可合并的命令同时是合并的边界，
+     * 其后入队的命令不会与其之前的命令合并。异步命令的 key 由队列释放。
+     */
+    char *key;
+
+    char *    str[5]; ///< 字符串参数，异步命令时由队列释放
+    int64_t   num[2]; ///< 整数参数
+    UT_array *tags;   ///< 异步命令拥有的点位参数，由队列释放
+
+    const void *in;  ///< 同步命令的输入，由调用者持有
+    void *      out; ///< 同步命令的输出
+
+    int               rv;
+    bool              wait;
+    bool              done;
+    uint64_t          seq;
+    persist_ticket_t *ticket; ///< 命令所属请求的记录，NULL 表示不属于任何请求
+
+    persist_cmd_t *next;
+    UT_hash_handle hh;
+};
+
+typedef struct {
+    uint64_t pending;   ///< 当前积压的命令数
+    uint64_t executed;  ///< 已执行的命令数
+    uint64_t coalesced; ///< 因合并而省去的命令数
+    uint64_t batches;   ///< 已提交的事务数
+    uint64_t failed;    ///< 执行失败的命令数
+} persist_queue_stats_t;
+
+/**
+ * @brief 启动持久化线程。
+ * @return 成功返回 0，失败返回 -1。
+ */
+int persist_queue_start(neu_persister_t *impl);
+
+/**
+ * @brief 执行完队列中的全部命令后停止持久化线程。
+ */
+void persist_queue_stop(void);
+
+/**
+ * @brief 异步命令入队，cmd 必须由 calloc 分配，所有权转移给队列。
+ */
+void persist_queue_push(persist_cmd_t *cmd);
+
+/**
+ * @brief 同步命令入队并等待其执行完成，cmd 可位于调用者栈上。
+ * @return 命令的执行结果；命令所在事务提交失败时返回 NEU_ERR_EINTERNAL。
+ */
+int persist_queue_call(persist_cmd_t *cmd);
+
+/**
+ * @brief 等待调用前入队的全部命令提交。
+ * @return 这些命令均成功时返回 0，否则返回 NEU_ERR_EINTERNAL。
+ */
+int persist_queue_sync(void);
+
+void persist_queue_stats(persist_queue_stats_t *stats);
+
+/**
+ * @brief 开始在当前线程记录入队的异步命令。
+ * @param ticket 请求已有的记录，由当前线程接管；NULL 时在首次入队时创建。
+ */
+void persist_queue_track_begin(persist_ticket_t *ticket);
+
+/**
+ * @brief 取走当前线程的记录，之后入队的命令记在新的记录上。
+ * @return 当前线程的记录，未入队过命令时返回 NULL。
+ */
+persist_ticket_t *persist_queue_track_take(void);
+
+/**
+ * @brief 停止在当前线程记录，释放未被取走的记录。
+ */
+void persist_queue_track_end(void);
+
+/**
+ * @brief 等待记录上的命令全部执行完成后回调，回调之后记录被释放。
+ *
+ * 命令已全部完成时在调用线程中直接回调，否则在持久化线程中回调，因此回调中
+ * 不能执行同步命令。rv 为第一个失败命令的结果，全部成功时为 0。
+ */
+void persist_ticket_wait(persist_ticket_t *ticket, persist_ticket_cb cb,
+                         void *arg);
+
+/**
+ * @brief 放弃等待并释放记录。
+ */
+void persist_ticket_release(persist_ticket_t *ticket);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
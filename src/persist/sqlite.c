@@ -17,6 +17,7 @@
  * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
  **/
 
+#include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -29,6 +30,7 @@
 
 #include "errcodes.h"
 #include "utils/log.h"
+#include "utils/uthash.h"
 
 #include "sqlite.h"
 
@@ -68,7 +70,8 @@ static int path_cat(char *dst, size_t len, size_t size, const char *src)
         dst[i++] = PATH_SEP_CHAR;
     }
 
-    if (*src && PATH_SEP_CHAR == *src) {
+    // 只在拼接时去掉开头的分隔符，保留绝对路径的根
+    if (0 < i && *src && PATH_SEP_CHAR == *src) {
         ++src;
     }
 
@@ -140,6 +143,175 @@ static inline int execute_sql(sqlite3 *db, const char *sql, ...)
     return rv;
 }
 
+/**
+ * @brief 各操作的 SQL 语句，下标为 neu_sqlite_stmt_e，参数一律用 `?` 绑定。
+ */
+static const char *g_sqls[NEU_SQLITE_STMT_MAX] = {
+    [NEU_SQLITE_STMT_STORE_NODE] = "INSERT INTO nodes (name, type, state, "
+                                   "plugin_name) VALUES (?, ?, ?, ?)",
+    [NEU_SQLITE_STMT_LOAD_NODES] =
+        "SELECT name, type, state, plugin_name FROM nodes",
+    [NEU_SQLITE_STMT_DELETE_NODE] = "DELETE FROM nodes WHERE name=?",
+    [NEU_SQLITE_STMT_UPDATE_NODE] = "UPDATE nodes SET name=? WHERE name=?",
+    [NEU_SQLITE_STMT_UPDATE_NODE_STATE] =
+        "UPDATE nodes SET state=? WHERE name=?",
+    [NEU_SQLITE_STMT_STORE_TAG] =
+        "INSERT INTO tags ("
+        " driver_name, group_name, name, address, attribute,"
+        " precision, type, decimal, bias, description, value, format,"
+        " deadband"
+        ") VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12, ?13)",
+    [NEU_SQLITE_STMT_LOAD_TAGS] =
+        "SELECT name, address, attribute, precision, type, decimal, bias, "
+        "description, value, format, deadband FROM tags "
+        "WHERE driver_name=? AND group_name=? ORDER BY rowid ASC",
+    [NEU_SQLITE_STMT_LOAD_NODE_TAGS] =
+        "SELECT group_name, name, address, attribute, precision, type, "
+        "decimal, bias, description, value, format, deadband FROM tags "
+        "WHERE driver_name=? ORDER BY rowid ASC",
+    [NEU_SQLITE_STMT_UPDATE_TAG] =
+        "UPDATE tags SET address=?, attribute=?, precision=?, type=?, "
+        "decimal=?, bias=?, description=?, value=?, deadband=? "
+        "WHERE driver_name=? AND group_name=? AND name=?",
+    [NEU_SQLITE_STMT_UPDATE_TAG_VALUE] =
+        "UPDATE tags SET value=? "
+        "WHERE driver_name=? AND group_name=? AND name=?",
+    [NEU_SQLITE_STMT_DELETE_TAG] =
+        "DELETE FROM tags WHERE driver_name=? AND group_name=? AND name=?",
+    [NEU_SQLITE_STMT_STORE_SUBSCRIPTION] =
+        "INSERT INTO subscriptions (app_name, driver_name, group_name, "
+        "params, static_tags) VALUES (?, ?, ?, ?, ?)",
+    [NEU_SQLITE_STMT_UPDATE_SUBSCRIPTION] =
+        "UPDATE subscriptions SET params=?, static_tags=? "
+        "WHERE app_name=? AND driver_name=? AND group_name=?",
+    [NEU_SQLITE_STMT_LOAD_SUBSCRIPTIONS] =
+        "SELECT driver_name, group_name, params, static_tags "
+        "FROM subscriptions WHERE app_name=?",
+    [NEU_SQLITE_STMT_DELETE_SUBSCRIPTION] =
+        "DELETE FROM subscriptions "
+        "WHERE app_name=? AND driver_name=? AND group_name=?",
+    [NEU_SQLITE_STMT_STORE_GROUP] = "INSERT INTO groups (driver_name, name, "
+                                    "interval, context) VALUES (?, ?, ?, ?)",
+    [NEU_SQLITE_STMT_UPDATE_GROUP] =
+        "UPDATE groups SET name=?, interval=? WHERE driver_name=? AND name=?",
+    [NEU_SQLITE_STMT_UPDATE_GROUP_NAME] =
+        "UPDATE groups SET name=? WHERE driver_name=? AND name=?",
+    [NEU_SQLITE_STMT_UPDATE_GROUP_INTERVAL] =
+        "UPDATE groups SET interval=? WHERE driver_name=? AND name=?",
+    [NEU_SQLITE_STMT_LOAD_GROUPS] =
+        "SELECT name, interval, context FROM groups WHERE driver_name=?",
+    [NEU_SQLITE_STMT_DELETE_GROUP] =
+        "DELETE FROM groups WHERE driver_name=? AND name=?",
+    [NEU_SQLITE_STMT_STORE_NODE_SETTING] =
+        "INSERT OR REPLACE INTO settings (node_name, setting) VALUES (?, ?)",
+    [NEU_SQLITE_STMT_LOAD_NODE_SETTING] =
+        "SELECT setting FROM settings WHERE node_name=?",
+    [NEU_SQLITE_STMT_DELETE_NODE_SETTING] =
+        "DELETE FROM settings WHERE node_name=?",
+    [NEU_SQLITE_STMT_LOAD_USERS]  = "SELECT name, password FROM users",
+    [NEU_SQLITE_STMT_STORE_USER]  = "INSERT INTO users (name, password) "
+                                   "VALUES (?, ?)",
+    [NEU_SQLITE_STMT_UPDATE_USER] = "UPDATE users SET password=? WHERE name=?",
+    [NEU_SQLITE_STMT_LOAD_USER]   = "SELECT password FROM users WHERE name=?",
+    [NEU_SQLITE_STMT_DELETE_USER] = "DELETE FROM users WHERE name=?",
+};
+
+/**
+ * @brief 取得操作 id 的预编译语句，首次使用时编译并缓存在连接上。
+ *
+ * 所有数据库访问都在持久化线程中串行执行，缓存无需加锁；语句用完后必须
+ * 调用 stmt_put 复位，否则会一直持有读事务。
+ *
+ * @return 成功返回语句，编译失败返回 NULL。
+ */
+static sqlite3_stmt *stmt_get(neu_sqlite_persister_t *persister,
+                              neu_sqlite_stmt_e       id)
+{
+    sqlite3_stmt **stmt = &persister->stmts[id];
+
+    if (NULL == *stmt &&
+        SQLITE_OK !=
+            sqlite3_prepare_v3(persister->db, g_sqls[id], -1,
+                               SQLITE_PREPARE_PERSISTENT, stmt, NULL)) {
+        nlog_error("prepare `%s` fail: %s", g_sqls[id],
+                   sqlite3_errmsg(persister->db));
+        sqlite3_finalize(*stmt);
+        *stmt = NULL;
+    }
+
+    return *stmt;
+}
+
+/**
+ * @brief 复位语句并清除绑定，供下次使用。
+ */
+static inline void stmt_put(sqlite3_stmt *stmt)
+{
+    if (NULL != stmt) {
+        sqlite3_reset(stmt);
+        sqlite3_clear_bindings(stmt);
+    }
+}
+
+/**
+ * @brief 用缓存的预编译语句执行一条不返回结果的 SQL。
+ *
+ * @param types 依次描述可变参数的类型：`s` 为字符串，NULL 绑定为 SQL NULL；
+ *              `i` 为 int；`d` 为 double。
+ * @return 成功返回 0，失败返回 NEU_ERR_EINTERNAL。
+ */
+static int execute_stmt(neu_sqlite_persister_t *persister, neu_sqlite_stmt_e id,
+                        const char *types, ...)
+{
+    int           rv   = 0;
+    sqlite3_stmt *stmt = stmt_get(persister, id);
+
+    if (NULL == stmt) {
+        return NEU_ERR_EINTERNAL;
+    }
+
+    va_list args;
+    va_start(args, types);
+    for (int i = 1; 0 == rv && '\0' != types[i - 1]; ++i) {
+        int ret = SQLITE_OK;
+
+        switch (types[i - 1]) {
+        case 's': {
+            const char *str = va_arg(args, const char *);
+            ret             = NULL == str
+                ? sqlite3_bind_null(stmt, i)
+                : sqlite3_bind_text(stmt, i, str, -1, SQLITE_STATIC);
+            break;
+        }
+        case 'i':
+            ret = sqlite3_bind_int(stmt, i, va_arg(args, int));
+            break;
+        case 'd':
+            ret = sqlite3_bind_double(stmt, i, va_arg(args, double));
+            break;
+        default:
+            ret = SQLITE_MISUSE;
+            break;
+        }
+
+        if (SQLITE_OK != ret) {
+            nlog_error("bind `%s` parameter %d fail: %s", g_sqls[id], i,
+                       sqlite3_errmsg(persister->db));
+            rv = NEU_ERR_EINTERNAL;
+        }
+    }
+    va_end(args);
+
+    if (0 == rv && SQLITE_DONE != sqlite3_step(stmt)) {
+        nlog_error("query `%s` fail: %s", g_sqls[id],
+                   sqlite3_errmsg(persister->db));
+        rv = NEU_ERR_EINTERNAL;
+    }
+
+    stmt_put(stmt);
+    return rv;
+}
+
 static int get_schema_version(sqlite3 *db, char **version_p, bool *dirty_p)
 {
     sqlite3_stmt *stmt  = NULL;
@@ -481,6 +653,7 @@ static struct neu_persister_vtbl_s g_sqlite_persister_vtbl = {
     .store_tag           = neu_sqlite_persister_store_tag,
     .store_tags          = neu_sqlite_persister_store_tags,
     .load_tags           = neu_sqlite_persister_load_tags,
+    .load_node_tags      = neu_sqlite_persister_load_node_tags,
     .update_tag          = neu_sqlite_persister_update_tag,
     .update_tag_value    = neu_sqlite_persister_update_tag_value,
     .delete_tag          = neu_sqlite_persister_delete_tag,
@@ -500,6 +673,8 @@ static struct neu_persister_vtbl_s g_sqlite_persister_vtbl = {
     .update_user         = neu_sqlite_persister_update_user,
     .load_user           = neu_sqlite_persister_load_user,
     .delete_user         = neu_sqlite_persister_delete_user,
+    .import              = neu_sqlite_persister_import,
+    .import_end          = neu_sqlite_persister_import_end,
 };
 
 /**
@@ -584,6 +759,11 @@ void neu_sqlite_persister_destroy(neu_persister_t *self)
 {
     neu_sqlite_persister_t *persister = (neu_sqlite_persister_t *) self;
     if (persister) {
+        // 未释放的语句会使 sqlite3_close 失败
+        for (int i = 0; i < NEU_SQLITE_STMT_MAX; ++i) {
+            sqlite3_finalize(persister->stmts[i]);
+        }
+
         // 关闭 SQLite 数据库连接
         sqlite3_close(persister->db);
 
@@ -614,12 +794,9 @@ void neu_sqlite_persister_destroy(neu_persister_t *self)
 int neu_sqlite_persister_store_node(neu_persister_t *        self,
                                     neu_persist_node_info_t *info)
 {
-    int rv = 0;
-    rv     = execute_sql(((neu_sqlite_persister_t *) self)->db,
-                     "INSERT INTO nodes (name, type, state, plugin_name) "
-                     "VALUES (%Q, %i, %i, %Q)",
-                     info->name, info->type, info->state, info->plugin_name);
-    return rv;
+    return execute_stmt((neu_sqlite_persister_t *) self,
+                        NEU_SQLITE_STMT_STORE_NODE, "siis", info->name,
+                        info->type, info->state, info->plugin_name);
 }
 
 static UT_icd node_info_icd = {
@@ -659,12 +836,12 @@ int neu_sqlite_persister_load_nodes(neu_persister_t *self,
 
     int           rv    = 0;
     sqlite3_stmt *stmt  = NULL;
-    const char *  query = "SELECT name, type, state, plugin_name FROM nodes;";
+    const char *  query = g_sqls[NEU_SQLITE_STMT_LOAD_NODES];
 
     utarray_new(*node_infos, &node_info_icd);
 
-    if (SQLITE_OK !=
-        sqlite3_prepare_v2(persister->db, query, -1, &stmt, NULL)) {
+    stmt = stmt_get(persister, NEU_SQLITE_STMT_LOAD_NODES);
+    if (NULL == stmt) {
         nlog_error("prepare `%s` fail: %s", query,
                    sqlite3_errmsg(persister->db));
         utarray_free(*node_infos);
@@ -700,7 +877,7 @@ int neu_sqlite_persister_load_nodes(neu_persister_t *self,
         // do not set return code, return partial or empty result
     }
 
-    sqlite3_finalize(stmt);
+    stmt_put(stmt);
     return rv;
 }
 
@@ -709,61 +886,40 @@ int neu_sqlite_persister_delete_node(neu_persister_t *self,
 {
     // rely on foreign key constraints to remove settings, groups, tags and
     // subscriptions
-    int rv = execute_sql(((neu_sqlite_persister_t *) self)->db,
-                         "DELETE FROM nodes WHERE name=%Q;", node_name);
-    return rv;
+    return execute_stmt((neu_sqlite_persister_t *) self,
+                        NEU_SQLITE_STMT_DELETE_NODE, "s", node_name);
 }
 
 int neu_sqlite_persister_update_node(neu_persister_t *self,
                                      const char *     node_name,
                                      const char *     new_name)
 {
-    return execute_sql(((neu_sqlite_persister_t *) self)->db,
-                       "UPDATE nodes SET name=%Q WHERE name=%Q;", new_name,
-                       node_name);
+    return execute_stmt((neu_sqlite_persister_t *) self,
+                        NEU_SQLITE_STMT_UPDATE_NODE, "ss", new_name, node_name);
 }
 
 int neu_sqlite_persister_update_node_state(neu_persister_t *self,
                                            const char *node_name, int state)
 {
-    return execute_sql(((neu_sqlite_persister_t *) self)->db,
-                       "UPDATE nodes SET state=%i WHERE name=%Q;", state,
-                       node_name);
+    return execute_stmt((neu_sqlite_persister_t *) self,
+                        NEU_SQLITE_STMT_UPDATE_NODE_STATE, "is", state,
+                        node_name);
 }
 
-int neu_sqlite_persister_store_tag(neu_persister_t *    self,
-                                   const char *         driver_name,
-                                   const char *         group_name,
-                                   const neu_datatag_t *tag)
-{
-    char format_buf[128] = { 0 };
-    if (tag->n_format > 0) {
-        neu_tag_format_str(tag, format_buf, sizeof(format_buf));
-    }
-
-    int rv = execute_sql(
-        ((neu_sqlite_persister_t *) self)->db,
-        "INSERT INTO tags ("
-        " driver_name, group_name, name, address, attribute,"
-        " precision, type, decimal, bias, description, value, format"
-        ") VALUES (%Q, %Q, %Q, %Q, %i, %i, %i, %lf, %lf, %Q, %Q, %Q)",
-        driver_name, group_name, tag->name, tag->address, tag->attribute,
-        tag->precision, tag->type, tag->decimal, tag->bias, tag->description,
-        "", format_buf);
-
-    return rv;
-}
 
 static int put_tags(sqlite3 *db, const char *query, sqlite3_stmt *stmt,
                     const neu_datatag_t *tags, size_t n)
 {
     for (size_t i = 0; i < n; ++i) {
-        const neu_datatag_t *tag             = &tags[i];
-        char                 format_buf[128] = { 0 };
+        const neu_datatag_t *tag               = &tags[i];
+        char                 format_buf[128]   = { 0 };
+        char                 deadband_buf[128] = { 0 };
 
         if (tag->n_format > 0) {
             neu_tag_format_str(tag, format_buf, sizeof(format_buf));
         }
+        neu_tag_deadband_str(&tag->deadband, deadband_buf,
+                             sizeof(deadband_buf));
 
         sqlite3_reset(stmt);
 
@@ -828,6 +984,13 @@ static int put_tags(sqlite3 *db, const char *query, sqlite3_stmt *stmt,
             return -1;
         }
 
+        if (SQLITE_OK !=
+            sqlite3_bind_text(stmt, 13, deadband_buf, -1, NULL)) {
+            nlog_error("bind `%s` with deadband=`%s` fail: %s", query,
+                       deadband_buf, sqlite3_errmsg(db));
+            return -1;
+        }
+
         if (SQLITE_DONE != sqlite3_step(stmt)) {
             nlog_error("sqlite3_step fail: %s", sqlite3_errmsg(db));
             return -1;
@@ -837,61 +1000,78 @@ static int put_tags(sqlite3 *db, const char *query, sqlite3_stmt *stmt,
     return 0;
 }
 
-int neu_sqlite_persister_store_tags(neu_persister_t *    self,
-                                    const char *         driver_name,
-                                    const char *         group_name,
-                                    const neu_datatag_t *tags, size_t n)
+/**
+ * @brief 用缓存的插入语句写入一组标签，调用者负责事务。
+ */
+static int insert_tags(neu_sqlite_persister_t *persister,
+                       const char *driver_name, const char *group_name,
+                       const neu_datatag_t *tags, size_t n)
 {
-    neu_sqlite_persister_t *persister = (neu_sqlite_persister_t *) self;
-
-    sqlite3_stmt *stmt = NULL;
-    const char *  query =
-        "INSERT INTO tags ("
-        " driver_name, group_name, name, address, attribute,"
-        " precision, type, decimal, bias, description, value, format"
-        ") VALUES (?1, ?2, ?3, ?4, ?5, ?6, ?7, ?8, ?9, ?10, ?11, ?12)";
+    int           rv    = 0;
+    const char *  query = g_sqls[NEU_SQLITE_STMT_STORE_TAG];
+    sqlite3_stmt *stmt  = stmt_get(persister, NEU_SQLITE_STMT_STORE_TAG);
 
-    if (SQLITE_OK != sqlite3_exec(persister->db, "BEGIN", NULL, NULL, NULL)) {
-        nlog_error("begin transaction fail: %s", sqlite3_errmsg(persister->db));
+    if (NULL == stmt) {
         return NEU_ERR_EINTERNAL;
     }
 
-    if (SQLITE_OK !=
-        sqlite3_prepare_v2(persister->db, query, -1, &stmt, NULL)) {
-        nlog_error("prepare `%s` fail: %s", query,
-                   sqlite3_errmsg(persister->db));
-        goto error;
-    }
-
     if (SQLITE_OK != sqlite3_bind_text(stmt, 1, driver_name, -1, NULL)) {
         nlog_error("bind `%s` with driver_name=`%s` fail: %s", query,
                    driver_name, sqlite3_errmsg(persister->db));
-        goto error;
-    }
-
-    if (SQLITE_OK != sqlite3_bind_text(stmt, 2, group_name, -1, NULL)) {
+        rv = NEU_ERR_EINTERNAL;
+    } else if (SQLITE_OK != sqlite3_bind_text(stmt, 2, group_name, -1, NULL)) {
         nlog_error("bind `%s` with group_name=`%s` fail: %s", query, group_name,
                    sqlite3_errmsg(persister->db));
-        goto error;
+        rv = NEU_ERR_EINTERNAL;
+    } else if (0 != put_tags(persister->db, query, stmt, tags, n)) {
+        rv = NEU_ERR_EINTERNAL;
+    }
+
+    stmt_put(stmt);
+    return rv;
+}
+
+int neu_sqlite_persister_store_tag(neu_persister_t *    self,
+                                   const char *         driver_name,
+                                   const char *         group_name,
+                                   const neu_datatag_t *tag)
+{
+    return insert_tags((neu_sqlite_persister_t *) self, driver_name,
+                       group_name, tag, 1);
+}
+
+int neu_sqlite_persister_store_tags(neu_persister_t *    self,
+                                    const char *         driver_name,
+                                    const char *         group_name,
+                                    const neu_datatag_t *tags, size_t n)
+{
+    neu_sqlite_persister_t *persister = (neu_sqlite_persister_t *) self;
+
+    // 使用保存点，可嵌套在写队列的批量事务中
+    if (SQLITE_OK !=
+        sqlite3_exec(persister->db, "SAVEPOINT store_tags", NULL, NULL,
+                     NULL)) {
+        nlog_error("begin transaction fail: %s", sqlite3_errmsg(persister->db));
+        return NEU_ERR_EINTERNAL;
     }
 
-    if (0 != put_tags(persister->db, query, stmt, tags, n)) {
+    if (0 != insert_tags(persister, driver_name, group_name, tags, n)) {
         goto error;
     }
 
-    if (SQLITE_OK != sqlite3_exec(persister->db, "COMMIT", NULL, NULL, NULL)) {
+    if (SQLITE_OK !=
+        sqlite3_exec(persister->db, "RELEASE store_tags", NULL, NULL, NULL)) {
         nlog_error("commit transaction fail: %s",
                    sqlite3_errmsg(persister->db));
         goto error;
     }
 
-    sqlite3_finalize(stmt);
     return 0;
 
 error:
     nlog_warn("rollback transaction");
-    sqlite3_exec(persister->db, "ROLLBACK", NULL, NULL, NULL);
-    sqlite3_finalize(stmt);
+    sqlite3_exec(persister->db, "ROLLBACK TO store_tags", NULL, NULL, NULL);
+    sqlite3_exec(persister->db, "RELEASE store_tags", NULL, NULL, NULL);
     return NEU_ERR_EINTERNAL;
 }
 
@@ -899,7 +1079,8 @@ static int collect_tag_info(sqlite3_stmt *stmt, UT_array **tags)
 {
     int step = sqlite3_step(stmt);
     while (SQLITE_ROW == step) {
-        const char *format = (const char *) sqlite3_column_text(stmt, 9);
+        const char *format   = (const char *) sqlite3_column_text(stmt, 9);
+        const char *deadband = (const char *) sqlite3_column_text(stmt, 10);
 
         neu_datatag_t tag = {
             .name        = (char *) sqlite3_column_text(stmt, 0),
@@ -913,6 +1094,7 @@ static int collect_tag_info(sqlite3_stmt *stmt, UT_array **tags)
         };
 
         tag.n_format = neu_format_from_str(format, tag.format);
+        neu_deadband_from_str(deadband, &tag.deadband);
 
         utarray_push_back(*tags, &tag);
 
@@ -933,15 +1115,12 @@ int neu_sqlite_persister_load_tags(neu_persister_t *self,
     neu_sqlite_persister_t *persister = (neu_sqlite_persister_t *) self;
 
     sqlite3_stmt *stmt  = NULL;
-    const char *  query = "SELECT name, address, attribute, precision, type, "
-                        "decimal, bias, description, value, format "
-                        "FROM tags WHERE driver_name=? AND group_name=? "
-                        "ORDER BY rowid ASC";
+    const char *  query = g_sqls[NEU_SQLITE_STMT_LOAD_TAGS];
 
     utarray_new(*tags, neu_tag_get_icd());
 
-    if (SQLITE_OK !=
-        sqlite3_prepare_v2(persister->db, query, -1, &stmt, NULL)) {
+    stmt = stmt_get(persister, NEU_SQLITE_STMT_LOAD_TAGS);
+    if (NULL == stmt) {
         nlog_error("prepare `%s` fail: %s", query,
                    sqlite3_errmsg(persister->db));
         goto error;
@@ -964,29 +1143,155 @@ int neu_sqlite_persister_load_tags(neu_persister_t *self,
         // do not set return code, return partial or empty result
     }
 
-    sqlite3_finalize(stmt);
+    stmt_put(stmt);
     return 0;
 
 error:
+    stmt_put(stmt);
     utarray_free(*tags);
     *tags = NULL;
     return NEU_ERR_EINTERNAL;
 }
 
+static UT_icd group_tags_icd = {
+    sizeof(neu_persist_group_tags_t),
+    NULL,
+    NULL,
+    (dtor_f *) neu_persist_group_tags_fini,
+};
+
+/**
+ * @brief 组名到 group_tags 向量下标的索引，仅在加载过程中使用。
+ */
+struct group_tags_index {
+    const char *   name;
+    unsigned       index;
+    UT_hash_handle hh;
+};
+
+/**
+ * @brief 按组归集一个节点的全部标签。
+ *
+ * 结果行按 rowid 排序，同一组的标签在组内保持写入顺序；组之间可能交错，
+ * 因此用组名索引定位所属的组，而不是依赖行的相邻关系。
+ */
+static int collect_node_tag_info(sqlite3_stmt *stmt, UT_array *group_tags)
+{
+    struct group_tags_index *index = NULL, *el = NULL, *tmp = NULL;
+
+    int step = sqlite3_step(stmt);
+    while (SQLITE_ROW == step) {
+        const char *group    = (const char *) sqlite3_column_text(stmt, 0);
+        const char *format   = (const char *) sqlite3_column_text(stmt, 10);
+        const char *deadband = (const char *) sqlite3_column_text(stmt, 11);
+
+        if (NULL == group) {
+            step = sqlite3_step(stmt);
+            continue;
+        }
+
+        HASH_FIND_STR(index, group, el);
+        if (NULL == el) {
+            neu_persist_group_tags_t gt = { 0 };
+
+            gt.group_name = strdup(group);
+            utarray_new(gt.tags, neu_tag_get_icd());
+            utarray_push_back(group_tags, &gt);
+
+            el        = calloc(1, sizeof(*el));
+            el->index = utarray_len(group_tags) - 1;
+            el->name  = ((neu_persist_group_tags_t *) utarray_back(group_tags))
+                           ->group_name;
+            HASH_ADD_KEYPTR(hh, index, el->name, strlen(el->name), el);
+        }
+
+        neu_persist_group_tags_t *gt =
+            (neu_persist_group_tags_t *) utarray_eltptr(group_tags, el->index);
+
+        neu_datatag_t tag = {
+            .name        = (char *) sqlite3_column_text(stmt, 1),
+            .address     = (char *) sqlite3_column_text(stmt, 2),
+            .attribute   = sqlite3_column_int(stmt, 3),
+            .precision   = sqlite3_column_int64(stmt, 4),
+            .type        = sqlite3_column_int(stmt, 5),
+            .decimal     = sqlite3_column_double(stmt, 6),
+            .bias        = sqlite3_column_double(stmt, 7),
+            .description = (char *) sqlite3_column_text(stmt, 8),
+        };
+
+        tag.n_format = neu_format_from_str(format, tag.format);
+        neu_deadband_from_str(deadband, &tag.deadband);
+
+        utarray_push_back(gt->tags, &tag);
+
+        step = sqlite3_step(stmt);
+    }
+
+    HASH_ITER(hh, index, el, tmp)
+    {
+        HASH_DEL(index, el);
+        free(el);
+    }
+
+    if (SQLITE_DONE != step) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int neu_sqlite_persister_load_node_tags(neu_persister_t *self,
+                                        const char *     driver_name,
+                                        UT_array **      group_tags)
+{
+    neu_sqlite_persister_t *persister = (neu_sqlite_persister_t *) self;
+
+    sqlite3_stmt *stmt  = NULL;
+    const char *  query = g_sqls[NEU_SQLITE_STMT_LOAD_NODE_TAGS];
+
+    utarray_new(*group_tags, &group_tags_icd);
+
+    stmt = stmt_get(persister, NEU_SQLITE_STMT_LOAD_NODE_TAGS);
+    if (NULL == stmt) {
+        nlog_error("prepare `%s` fail: %s", query,
+                   sqlite3_errmsg(persister->db));
+        goto error;
+    }
+
+    if (SQLITE_OK != sqlite3_bind_text(stmt, 1, driver_name, -1, NULL)) {
+        nlog_error("bind `%s` with `%s` fail: %s", query, driver_name,
+                   sqlite3_errmsg(persister->db));
+        goto error;
+    }
+
+    if (0 != collect_node_tag_info(stmt, *group_tags)) {
+        nlog_warn("query `%s` fail: %s", query, sqlite3_errmsg(persister->db));
+        // do not set return code, return partial or empty result
+    }
+
+    stmt_put(stmt);
+    return 0;
+
+error:
+    stmt_put(stmt);
+    utarray_free(*group_tags);
+    *group_tags = NULL;
+    return NEU_ERR_EINTERNAL;
+}
+
 int neu_sqlite_persister_update_tag(neu_persister_t *    self,
                                     const char *         driver_name,
                                     const char *         group_name,
                                     const neu_datatag_t *tag)
 {
-    int rv = execute_sql(((neu_sqlite_persister_t *) self)->db,
-                         "UPDATE tags SET"
-                         " address=%Q, attribute=%i, precision=%i, type=%i,"
-                         " decimal=%lf, bias=%lf, description=%Q, value=%Q "
-                         "WHERE driver_name=%Q AND group_name=%Q AND name=%Q",
-                         tag->address, tag->attribute, tag->precision,
-                         tag->type, tag->decimal, tag->bias, tag->description,
-                         "", driver_name, group_name, tag->name);
-    return rv;
+    char deadband[128] = { 0 };
+
+    neu_tag_deadband_str(&tag->deadband, deadband, sizeof(deadband));
+    return execute_stmt((neu_sqlite_persister_t *) self,
+                        NEU_SQLITE_STMT_UPDATE_TAG, "siiiddssssss",
+                        tag->address, tag->attribute, tag->precision,
+                        tag->type, tag->decimal, tag->bias, tag->description,
+                        "", deadband, driver_name, group_name, tag->name);
 }
 
 int neu_sqlite_persister_update_tag_value(neu_persister_t *    self,
@@ -994,11 +1299,9 @@ int neu_sqlite_persister_update_tag_value(neu_persister_t *    self,
                                           const char *         group_name,
                                           const neu_datatag_t *tag)
 {
-    int rv = execute_sql(((neu_sqlite_persister_t *) self)->db,
-                         "UPDATE tags SET value=%Q "
-                         "WHERE driver_name=%Q AND group_name=%Q AND name=%Q",
-                         "", driver_name, group_name, tag->name);
-    return rv;
+    return execute_stmt((neu_sqlite_persister_t *) self,
+                        NEU_SQLITE_STMT_UPDATE_TAG_VALUE, "ssss", "",
+                        driver_name, group_name, tag->name);
 }
 
 int neu_sqlite_persister_delete_tag(neu_persister_t *self,
@@ -1006,32 +1309,27 @@ int neu_sqlite_persister_delete_tag(neu_persister_t *self,
                                     const char *     group_name,
                                     const char *     tag_name)
 {
-    int rv = execute_sql(
-        ((neu_sqlite_persister_t *) self)->db,
-        "DELETE FROM tags WHERE driver_name=%Q AND group_name=%Q AND name=%Q",
-        driver_name, group_name, tag_name);
-    return rv;
+    return execute_stmt((neu_sqlite_persister_t *) self,
+                        NEU_SQLITE_STMT_DELETE_TAG, "sss", driver_name,
+                        group_name, tag_name);
 }
 
 int neu_sqlite_persister_store_subscription(
     neu_persister_t *self, const char *app_name, const char *driver_name,
     const char *group_name, const char *params, const char *static_tags)
 {
-    return execute_sql(((neu_sqlite_persister_t *) self)->db,
-                       "INSERT INTO subscriptions (app_name, driver_name, "
-                       "group_name, params, static_tags) "
-                       "VALUES (%Q, %Q, %Q, %Q, %Q)",
-                       app_name, driver_name, group_name, params, static_tags);
+    return execute_stmt((neu_sqlite_persister_t *) self,
+                        NEU_SQLITE_STMT_STORE_SUBSCRIPTION, "sssss", app_name,
+                        driver_name, group_name, params, static_tags);
 }
 
 int neu_sqlite_persister_update_subscription(
     neu_persister_t *self, const char *app_name, const char *driver_name,
     const char *group_name, const char *params, const char *static_tags)
 {
-    return execute_sql(((neu_sqlite_persister_t *) self)->db,
-                       "UPDATE subscriptions SET params=%Q, static_tags=%Q "
-                       "WHERE app_name=%Q AND driver_name=%Q AND group_name=%Q",
-                       params, static_tags, app_name, driver_name, group_name);
+    return execute_stmt((neu_sqlite_persister_t *) self,
+                        NEU_SQLITE_STMT_UPDATE_SUBSCRIPTION, "sssss", params,
+                        static_tags, app_name, driver_name, group_name);
 }
 
 static UT_icd subscription_info_icd = {
@@ -1048,13 +1346,12 @@ int neu_sqlite_persister_load_subscriptions(neu_persister_t *self,
     neu_sqlite_persister_t *persister = (neu_sqlite_persister_t *) self;
 
     sqlite3_stmt *stmt  = NULL;
-    const char *  query = "SELECT driver_name, group_name, params, static_tags "
-                        "FROM subscriptions WHERE app_name=?";
+    const char *  query = g_sqls[NEU_SQLITE_STMT_LOAD_SUBSCRIPTIONS];
 
     utarray_new(*subscription_infos, &subscription_info_icd);
 
-    if (SQLITE_OK !=
-        sqlite3_prepare_v2(persister->db, query, -1, &stmt, NULL)) {
+    stmt = stmt_get(persister, NEU_SQLITE_STMT_LOAD_SUBSCRIPTIONS);
+    if (NULL == stmt) {
         nlog_error("prepare `%s` fail: %s", query,
                    sqlite3_errmsg(persister->db));
         goto error;
@@ -1112,10 +1409,11 @@ int neu_sqlite_persister_load_subscriptions(neu_persister_t *self,
         // do not set return code, return partial or empty result
     }
 
-    sqlite3_finalize(stmt);
+    stmt_put(stmt);
     return 0;
 
 error:
+    stmt_put(stmt);
     utarray_free(*subscription_infos);
     *subscription_infos = NULL;
     return NEU_ERR_EINTERNAL;
@@ -1126,10 +1424,9 @@ int neu_sqlite_persister_delete_subscription(neu_persister_t *self,
                                              const char *     driver_name,
                                              const char *     group_name)
 {
-    return execute_sql(((neu_sqlite_persister_t *) self)->db,
-                       "DELETE FROM subscriptions WHERE app_name=%Q AND "
-                       "driver_name=%Q AND group_name=%Q",
-                       app_name, driver_name, group_name);
+    return execute_stmt((neu_sqlite_persister_t *) self,
+                        NEU_SQLITE_STMT_DELETE_SUBSCRIPTION, "sss", app_name,
+                        driver_name, group_name);
 }
 
 int neu_sqlite_persister_store_group(neu_persister_t *         self,
@@ -1137,11 +1434,9 @@ int neu_sqlite_persister_store_group(neu_persister_t *         self,
                                      neu_persist_group_info_t *group_info,
                                      const char *              context)
 {
-    return execute_sql(((neu_sqlite_persister_t *) self)->db,
-                       "INSERT INTO groups (driver_name, name, interval, "
-                       "context) VALUES (%Q, %Q, %u, %Q)",
-                       driver_name, group_info->name,
-                       (unsigned) group_info->interval, context);
+    return execute_stmt((neu_sqlite_persister_t *) self,
+                        NEU_SQLITE_STMT_STORE_GROUP, "ssis", driver_name,
+                        group_info->name, (int) group_info->interval, context);
 }
 
 int neu_sqlite_persister_update_group(neu_persister_t *         self,
@@ -1156,21 +1451,16 @@ int neu_sqlite_persister_update_group(neu_persister_t *         self,
     bool update_interval = (NEU_GROUP_INTERVAL_LIMIT <= group_info->interval);
 
     if (update_name && update_interval) {
-        ret = execute_sql(persister->db,
-                          "UPDATE groups SET name=%Q, interval=%i "
-                          "WHERE driver_name=%Q AND name=%Q",
-                          group_info->name, group_info->interval, driver_name,
-                          group_name);
+        ret = execute_stmt(persister, NEU_SQLITE_STMT_UPDATE_GROUP, "siss",
+                           group_info->name, (int) group_info->interval,
+                           driver_name, group_name);
     } else if (update_name) {
-        ret = execute_sql(persister->db,
-                          "UPDATE groups SET name=%Q "
-                          "WHERE driver_name=%Q AND name=%Q",
-                          group_info->name, driver_name, group_name);
+        ret = execute_stmt(persister, NEU_SQLITE_STMT_UPDATE_GROUP_NAME, "sss",
+                           group_info->name, driver_name, group_name);
     } else if (update_interval) {
-        ret = execute_sql(persister->db,
-                          "UPDATE groups SET interval=%i "
-                          "WHERE driver_name=%Q AND name=%Q",
-                          group_info->interval, driver_name, group_name);
+        ret = execute_stmt(persister, NEU_SQLITE_STMT_UPDATE_GROUP_INTERVAL,
+                           "iss", (int) group_info->interval, driver_name,
+                           group_name);
     }
 
     return ret;
@@ -1253,7 +1543,7 @@ int neu_sqlite_persister_load_groups(neu_persister_t *self,
     // 用于存储 SQLite 语句句柄，初始化为 NULL
     sqlite3_stmt *stmt = NULL;
     const char *  query =
-        "SELECT name, interval, context FROM groups WHERE driver_name=?";
+        g_sqls[NEU_SQLITE_STMT_LOAD_GROUPS];
 
     /**
      * @brief
@@ -1268,8 +1558,8 @@ int neu_sqlite_persister_load_groups(neu_persister_t *self,
     utarray_new(*group_infos, &group_info_icd);
 
     // 准备 SQL 语句
-    if (SQLITE_OK !=
-        sqlite3_prepare_v2(persister->db, query, -1, &stmt, NULL)) {
+    stmt = stmt_get(persister, NEU_SQLITE_STMT_LOAD_GROUPS);
+    if (NULL == stmt) {
         nlog_error("prepare `%s` fail: %s", query,
                    sqlite3_errmsg(persister->db));
         goto error;
@@ -1287,10 +1577,11 @@ int neu_sqlite_persister_load_groups(neu_persister_t *self,
         // do not set return code, return partial or empty result
     }
 
-    sqlite3_finalize(stmt);
+    stmt_put(stmt);
     return 0;
 
 error:
+    stmt_put(stmt);
     utarray_free(*group_infos);
     *group_infos = NULL;
     return NEU_ERR_EINTERNAL;
@@ -1301,20 +1592,18 @@ int neu_sqlite_persister_delete_group(neu_persister_t *self,
                                       const char *     group_name)
 {
     // rely on foreign key constraints to delete tags and subscriptions
-    int rv = execute_sql(((neu_sqlite_persister_t *) self)->db,
-                         "DELETE FROM groups WHERE driver_name=%Q AND name=%Q",
-                         driver_name, group_name);
-    return rv;
+    return execute_stmt((neu_sqlite_persister_t *) self,
+                        NEU_SQLITE_STMT_DELETE_GROUP, "ss", driver_name,
+                        group_name);
 }
 
 int neu_sqlite_persister_store_node_setting(neu_persister_t *self,
                                             const char *     node_name,
                                             const char *     setting)
 {
-    return execute_sql(
-        ((neu_sqlite_persister_t *) self)->db,
-        "INSERT OR REPLACE INTO settings (node_name, setting) VALUES (%Q, %Q)",
-        node_name, setting);
+    return execute_stmt((neu_sqlite_persister_t *) self,
+                        NEU_SQLITE_STMT_STORE_NODE_SETTING, "ss", node_name,
+                        setting);
 }
 
 /**
@@ -1342,11 +1631,11 @@ int neu_sqlite_persister_load_node_setting(neu_persister_t *  self,
 
     int           rv    = 0;
     sqlite3_stmt *stmt  = NULL; // 表示 SQLite 数据库的预编译语句对象
-    const char *  query = "SELECT setting FROM settings WHERE node_name=?";
+    const char *  query = g_sqls[NEU_SQLITE_STMT_LOAD_NODE_SETTING];
 
     // 预编译 SQL 语句, &stmt 用于接收预编译后的语句对象指针
-    if (SQLITE_OK !=
-        sqlite3_prepare_v2(persister->db, query, -1, &stmt, NULL)) {
+    stmt = stmt_get(persister, NEU_SQLITE_STMT_LOAD_NODE_SETTING);
+    if (NULL == stmt) {
         nlog_error("prepare `%s` with `%s` fail: %s", query, node_name,
                    sqlite3_errmsg(persister->db));
         return NEU_ERR_EINTERNAL;
@@ -1379,15 +1668,15 @@ int neu_sqlite_persister_load_node_setting(neu_persister_t *  self,
     *setting = s;
 
 end:
-    sqlite3_finalize(stmt);
+    stmt_put(stmt);
     return rv;
 }
 
 int neu_sqlite_persister_delete_node_setting(neu_persister_t *self,
                                              const char *     node_name)
 {
-    return execute_sql(((neu_sqlite_persister_t *) self)->db,
-                       "DELETE FROM settings WHERE node_name=%Q", node_name);
+    return execute_stmt((neu_sqlite_persister_t *) self,
+                        NEU_SQLITE_STMT_DELETE_NODE_SETTING, "s", node_name);
 }
 
 static UT_icd user_info_icd = {
@@ -1430,12 +1719,12 @@ int neu_sqlite_persister_load_users(neu_persister_t *self,
     neu_sqlite_persister_t *persister = (neu_sqlite_persister_t *) self;
 
     sqlite3_stmt *stmt  = NULL;
-    const char *  query = "SELECT name, password FROM users";
+    const char *  query = g_sqls[NEU_SQLITE_STMT_LOAD_USERS];
 
     utarray_new(*user_infos, &user_info_icd);
 
-    if (SQLITE_OK !=
-        sqlite3_prepare_v2(persister->db, query, -1, &stmt, NULL)) {
+    stmt = stmt_get(persister, NEU_SQLITE_STMT_LOAD_USERS);
+    if (NULL == stmt) {
         nlog_error("prepare `%s` fail: %s", query,
                    sqlite3_errmsg(persister->db));
         goto error;
@@ -1446,10 +1735,11 @@ int neu_sqlite_persister_load_users(neu_persister_t *self,
         // do not set return code, return partial or empty result
     }
 
-    sqlite3_finalize(stmt);
+    stmt_put(stmt);
     return 0;
 
 error:
+    stmt_put(stmt);
     utarray_free(*user_infos);
     *user_infos = NULL;
     return NEU_ERR_EINTERNAL;
@@ -1458,17 +1748,17 @@ error:
 int neu_sqlite_persister_store_user(neu_persister_t *              self,
                                     const neu_persist_user_info_t *user)
 {
-    return execute_sql(((neu_sqlite_persister_t *) self)->db,
-                       "INSERT INTO users (name, password) VALUES (%Q, %Q)",
-                       user->name, user->hash);
+    return execute_stmt((neu_sqlite_persister_t *) self,
+                        NEU_SQLITE_STMT_STORE_USER, "ss", user->name,
+                        user->hash);
 }
 
 int neu_sqlite_persister_update_user(neu_persister_t *              self,
                                      const neu_persist_user_info_t *user)
 {
-    return execute_sql(((neu_sqlite_persister_t *) self)->db,
-                       "UPDATE users SET password=%Q WHERE name=%Q", user->hash,
-                       user->name);
+    return execute_stmt((neu_sqlite_persister_t *) self,
+                        NEU_SQLITE_STMT_UPDATE_USER, "ss", user->hash,
+                        user->name);
 }
 
 int neu_sqlite_persister_load_user(neu_persister_t *self, const char *user_name,
@@ -1478,10 +1768,10 @@ int neu_sqlite_persister_load_user(neu_persister_t *self, const char *user_name,
 
     neu_persist_user_info_t *user  = NULL;
     sqlite3_stmt *           stmt  = NULL;
-    const char *             query = "SELECT password FROM users WHERE name=?";
+    const char *             query = g_sqls[NEU_SQLITE_STMT_LOAD_USER];
 
-    if (SQLITE_OK !=
-        sqlite3_prepare_v2(persister->db, query, -1, &stmt, NULL)) {
+    stmt = stmt_get(persister, NEU_SQLITE_STMT_LOAD_USER);
+    if (NULL == stmt) {
         nlog_error("prepare `%s` with `%s` fail: %s", query, user_name,
                    sqlite3_errmsg(persister->db));
         return NEU_ERR_EINTERNAL;
@@ -1517,7 +1807,7 @@ int neu_sqlite_persister_load_user(neu_persister_t *self, const char *user_name,
     }
 
     *user_p = user;
-    sqlite3_finalize(stmt);
+    stmt_put(stmt);
     return 0;
 
 error:
@@ -1525,13 +1815,184 @@ error:
         neu_persist_user_info_fini(user);
         free(user);
     }
-    sqlite3_finalize(stmt);
+    stmt_put(stmt);
     return NEU_ERR_EINTERNAL;
 }
 
 int neu_sqlite_persister_delete_user(neu_persister_t *self,
                                      const char *     user_name)
 {
-    return execute_sql(((neu_sqlite_persister_t *) self)->db,
-                       "DELETE FROM users WHERE name=%Q", user_name);
+    return execute_stmt((neu_sqlite_persister_t *) self,
+                        NEU_SQLITE_STMT_DELETE_USER, "s", user_name);
+}
+
+/**
+ * @brief 导入前建立快照的表，父表在前。
+ */
+static const char *g_import_tables[] = {
+    "nodes", "settings", "groups", "tags", "subscriptions", "node_cache",
+};
+
+#define IMPORT_TABLE_N (sizeof(g_import_tables) / sizeof(g_import_tables[0]))
+
+static int import_snapshot(sqlite3 *db)
+{
+    for (size_t i = 0; i < IMPORT_TABLE_N; ++i) {
+        const char *t = g_import_tables[i];
+
+        // 临时表只对本连接可见，表名加前缀以免遮蔽主库中的同名表
+        if (0 !=
+            execute_sql(db,
+                        "DROP TABLE IF EXISTS temp.import_%s;"
+                        "CREATE TEMP TABLE import_%s AS SELECT * FROM main.%s",
+                        t, t, t)) {
+            return NEU_ERR_EINTERNAL;
+        }
+    }
+
+    return 0;
+}
+
+static int import_config(neu_sqlite_persister_t *    persister,
+                         const neu_persist_import_t *import)
+{
+    int rv = import_snapshot(persister->db);
+
+    // 设置、组、点位与订阅随节点级联删除
+    for (size_t i = 0; 0 == rv && i < import->n_del_node; ++i) {
+        rv = execute_stmt(persister, NEU_SQLITE_STMT_DELETE_NODE, "s",
+                          import->del_nodes[i]);
+    }
+
+    for (size_t i = 0; 0 == rv && i < import->n_node; ++i) {
+        const neu_persist_import_node_t *node = &import->nodes[i];
+
+        // 库中可能残留启动时未能加载的同名节点
+        rv = execute_stmt(persister, NEU_SQLITE_STMT_DELETE_NODE, "s",
+                          node->info.name);
+        if (0 == rv) {
+            rv = execute_stmt(persister, NEU_SQLITE_STMT_STORE_NODE, "siis",
+                              node->info.name, node->info.type,
+                              node->info.state, node->info.plugin_name);
+        }
+        if (0 == rv && NULL != node->setting) {
+            rv = execute_stmt(persister, NEU_SQLITE_STMT_STORE_NODE_SETTING,
+                              "ss", node->info.name, node->setting);
+        }
+    }
+
+    for (size_t i = 0; 0 == rv && i < import->n_group; ++i) {
+        const neu_persist_import_group_t *group = &import->groups[i];
+
+        rv = execute_stmt(persister, NEU_SQLITE_STMT_STORE_GROUP, "ssis",
+                          group->driver_name, group->name,
+                          (int) group->interval, NULL);
+        if (0 == rv && group->n_tag > 0) {
+            rv = insert_tags(persister, group->driver_name, group->name,
+                             group->tags, group->n_tag);
+        }
+    }
+
+    for (size_t i = 0; 0 == rv && i < import->n_subscription; ++i) {
+        const neu_persist_import_sub_t *sub = &import->subscriptions[i];
+
+        rv = execute_stmt(persister, NEU_SQLITE_STMT_STORE_SUBSCRIPTION,
+                          "sssss", sub->app_name, sub->driver_name,
+                          sub->group_name, sub->params, sub->static_tags);
+    }
+
+    return rv;
+}
+
+int neu_sqlite_persister_import(neu_persister_t *           self,
+                                const neu_persist_import_t *import)
+{
+    neu_sqlite_persister_t *persister = (neu_sqlite_persister_t *) self;
+
+    // 使用保存点，可嵌套在写队列的批量事务中
+    if (SQLITE_OK !=
+        sqlite3_exec(persister->db, "SAVEPOINT import_config", NULL, NULL,
+                     NULL)) {
+        nlog_error("begin transaction fail: %s", sqlite3_errmsg(persister->db));
+        return NEU_ERR_EINTERNAL;
+    }
+
+    if (0 != import_config(persister, import)) {
+        goto error;
+    }
+
+    if (SQLITE_OK !=
+        sqlite3_exec(persister->db, "RELEASE import_config", NULL, NULL,
+                     NULL)) {
+        nlog_error("commit transaction fail: %s",
+                   sqlite3_errmsg(persister->db));
+        goto error;
+    }
+
+    return 0;
+
+error:
+    nlog_warn("rollback import");
+    sqlite3_exec(persister->db, "ROLLBACK TO import_config", NULL, NULL, NULL);
+    sqlite3_exec(persister->db, "RELEASE import_config", NULL, NULL, NULL);
+    return NEU_ERR_EINTERNAL;
+}
+
+static int import_restore(sqlite3 *db)
+{
+    // 其余各表的记录随节点级联删除
+    if (0 != execute_sql(db, "DELETE FROM main.nodes")) {
+        return NEU_ERR_EINTERNAL;
+    }
+
+    for (size_t i = 0; i < IMPORT_TABLE_N; ++i) {
+        const char *t = g_import_tables[i];
+
+        if (0 !=
+            execute_sql(db, "INSERT INTO main.%s SELECT * FROM temp.import_%s",
+                        t, t)) {
+            return NEU_ERR_EINTERNAL;
+        }
+    }
+
+    return 0;
+}
+
+int neu_sqlite_persister_import_end(neu_persister_t *self, bool rollback)
+{
+    neu_sqlite_persister_t *persister = (neu_sqlite_persister_t *) self;
+    int                     rv        = 0;
+
+    if (SQLITE_OK !=
+        sqlite3_exec(persister->db, "SAVEPOINT import_end", NULL, NULL,
+                     NULL)) {
+        nlog_error("begin transaction fail: %s", sqlite3_errmsg(persister->db));
+        return NEU_ERR_EINTERNAL;
+    }
+
+    if (rollback) {
+        rv = import_restore(persister->db);
+    }
+
+    for (size_t i = 0; 0 == rv && i < IMPORT_TABLE_N; ++i) {
+        rv = execute_sql(persister->db, "DROP TABLE IF EXISTS temp.import_%s",
+                         g_import_tables[i]);
+    }
+
+    if (0 == rv &&
+        SQLITE_OK !=
+            sqlite3_exec(persister->db, "RELEASE import_end", NULL, NULL,
+                         NULL)) {
+        nlog_error("commit transaction fail: %s",
+                   sqlite3_errmsg(persister->db));
+        rv = NEU_ERR_EINTERNAL;
+    }
+
+    if (0 != rv) {
+        nlog_warn("rollback import end");
+        sqlite3_exec(persister->db, "ROLLBACK TO import_end", NULL, NULL, NULL);
+        sqlite3_exec(persister->db, "RELEASE import_end", NULL, NULL, NULL);
+    }
+
+    return rv;
 }
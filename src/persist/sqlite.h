@@ -26,6 +26,42 @@ extern "C" {
 
 #include "persist/persist_impl.h"
 
+/**
+ * @brief 预编译语句缓存的下标，每种操作对应一条语句。
+ */
+typedef enum {
+    NEU_SQLITE_STMT_STORE_NODE,
+    NEU_SQLITE_STMT_LOAD_NODES,
+    NEU_SQLITE_STMT_DELETE_NODE,
+    NEU_SQLITE_STMT_UPDATE_NODE,
+    NEU_SQLITE_STMT_UPDATE_NODE_STATE,
+    NEU_SQLITE_STMT_STORE_TAG,
+    NEU_SQLITE_STMT_LOAD_TAGS,
+    NEU_SQLITE_STMT_LOAD_NODE_TAGS,
+    NEU_SQLITE_STMT_UPDATE_TAG,
+    NEU_SQLITE_STMT_UPDATE_TAG_VALUE,
+    NEU_SQLITE_STMT_DELETE_TAG,
+    NEU_SQLITE_STMT_STORE_SUBSCRIPTION,
+    NEU_SQLITE_STMT_UPDATE_SUBSCRIPTION,
+    NEU_SQLITE_STMT_LOAD_SUBSCRIPTIONS,
+    NEU_SQLITE_STMT_DELETE_SUBSCRIPTION,
+    NEU_SQLITE_STMT_STORE_GROUP,
+    NEU_SQLITE_STMT_UPDATE_GROUP,
+    NEU_SQLITE_STMT_UPDATE_GROUP_NAME,
+    NEU_SQLITE_STMT_UPDATE_GROUP_INTERVAL,
+    NEU_SQLITE_STMT_LOAD_GROUPS,
+    NEU_SQLITE_STMT_DELETE_GROUP,
+    NEU_SQLITE_STMT_STORE_NODE_SETTING,
+    NEU_SQLITE_STMT_LOAD_NODE_SETTING,
+    NEU_SQLITE_STMT_DELETE_NODE_SETTING,
+    NEU_SQLITE_STMT_LOAD_USERS,
+    NEU_SQLITE_STMT_STORE_USER,
+    NEU_SQLITE_STMT_UPDATE_USER,
+    NEU_SQLITE_STMT_LOAD_USER,
+    NEU_SQLITE_STMT_DELETE_USER,
+    NEU_SQLITE_STMT_MAX,
+} neu_sqlite_stmt_e;
+
 /**
  * @brief 用于表示 SQLite 持久化器的结构体。
  *
@@ -37,6 +73,9 @@ extern "C" {
 typedef struct {
     struct neu_persister_vtbl_s *vtbl;
     sqlite3 *                    db;
+
+    /** 按操作缓存的预编译语句，首次使用时编译，销毁时释放 */
+    sqlite3_stmt *stmts[NEU_SQLITE_STMT_MAX];
 } neu_sqlite_persister_t;
 
 neu_persister_t *neu_sqlite_persister_create(const char *schema_dir);
@@ -67,6 +106,9 @@ int neu_sqlite_persister_load_tags(neu_persister_t *self,
                                    const char *     driver_name,
                                    const char *     group_name,
                                    UT_array **      tag_infos);
+int neu_sqlite_persister_load_node_tags(neu_persister_t *self,
+                                        const char *     driver_name,
+                                        UT_array **      group_tags);
 int neu_sqlite_persister_update_tag(neu_persister_t *    self,
                                     const char *         driver_name,
                                     const char *         group_name,
@@ -124,6 +166,9 @@ int neu_sqlite_persister_load_user(neu_persister_t *self, const char *user_name,
                                    neu_persist_user_info_t **user_p);
 int neu_sqlite_persister_delete_user(neu_persister_t *self,
                                      const char *     user_name);
+int neu_sqlite_persister_import(neu_persister_t *           self,
+                                const neu_persist_import_t *import);
+int neu_sqlite_persister_import_end(neu_persister_t *self, bool rollback);
 
 #ifdef __cplusplus
 }
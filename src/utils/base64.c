@@ -18,6 +18,7 @@
  **/
 
 #include <assert.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -85,4 +86,40 @@ unsigned char *neu_decode64(int *length, const char *input)
     unsigned char *output;
     Base64Decode(input, &output, length);
     return output;
-}
\ No newline at end of file
+}
+int64_t neu_decode64_to_file(const char *input, FILE *fp)
+{
+    // 每次解码 4K 输入，输出不超过 3K
+    unsigned char   out[4096] = { 0 };
+    int             out_len   = 0;
+    int64_t         total     = 0;
+    size_t          len       = strlen(input);
+    EVP_ENCODE_CTX *ctx       = EVP_ENCODE_CTX_new();
+
+    if (ctx == NULL) {
+        return -1;
+    }
+
+    EVP_DecodeInit(ctx);
+    for (size_t i = 0; i < len; i += 4096) {
+        int n = len - i < 4096 ? len - i : 4096;
+
+        if (EVP_DecodeUpdate(ctx, out, &out_len,
+                             (const unsigned char *) input + i, n) < 0 ||
+            fwrite(out, 1, out_len, fp) != (size_t) out_len) {
+            EVP_ENCODE_CTX_free(ctx);
+            return -1;
+        }
+        total += out_len;
+    }
+
+    if (EVP_DecodeFinal(ctx, out, &out_len) < 0 ||
+        fwrite(out, 1, out_len, fp) != (size_t) out_len) {
+        EVP_ENCODE_CTX_free(ctx);
+        return -1;
+    }
+    total += out_len;
+
+    EVP_ENCODE_CTX_free(ctx);
+    return total;
+}
@@ -18,77 +18,133 @@
  **/
 
 #include <jansson.h>
-#include <libxml/parser.h>
-#include <libxml/tree.h>
+#include <libxml/xmlreader.h>
 
 #include "define.h"
 #include "utils/cid.h"
 #include "utils/log.h"
+#include "utils/uthash.h"
 #include "json/json.h"
 
-static int parse_ied(xmlNode *xml_ied, cid_ied_t *ied);
-static int parse_template(xmlNode *xml_template, cid_template_t *template);
-static int parse_ldevice(xmlNode *xml_server, cid_access_point_t *ap);
-static int parse_lnode(xmlNode *xml_ldevice, cid_ldevice_t *ldev);
-static int parse_dataset(xmlNode *xml_dataset, cid_ln_t *ln);
-static int parse_report(xmlNode *xml_report, cid_ln_t *ln);
-static int parse_doi(xmlNode *xml_doi, cid_ln_t *ln);
+/**
+ * @brief 流式解析时元素的类别。
+ *
+ * 只有需要继续读取子元素的元素才有类别，其余元素解析完属性后整棵子树跳过，
+ * 因此栈中只会出现下列类别。
+ */
+typedef enum {
+    CID_NODE_SKIP = 0,
+    CID_NODE_SCL,
+    CID_NODE_IED,
+    CID_NODE_ACCESS_POINT,
+    CID_NODE_SERVER,
+    CID_NODE_LDEVICE,
+    CID_NODE_LN,
+    CID_NODE_DATASET,
+    CID_NODE_DOI,
+    CID_NODE_SDI,
+    CID_NODE_TEMPLATE,
+    CID_NODE_LNOTYPE,
+    CID_NODE_DOTYPE,
+    CID_NODE_DATYPE,
+} cid_node_e;
+
+#define CID_MAX_DEPTH 16
+#define CID_ATTR_LEN 128
+
+typedef struct {
+    const char *name;
+    char        value[CID_ATTR_LEN];
+    bool        set;
+} cid_attr_t;
+
+typedef struct {
+    xmlTextReaderPtr reader;
+    cid_t *          cid;
+    cid_node_e       stack[CID_MAX_DEPTH]; ///< 按深度记录祖先元素的类别
+
+    bool has_access_point; ///< 当前 IED 已解析过 AccessPoint
+    bool has_server;       ///< 当前 AccessPoint 已解析过 Server
+    char sdi_name[NEU_CID_LEN16];
+
+    bool ied_parsed;
+    bool templates_parsed;
+} cid_reader_t;
+
+typedef struct {
+    const char *   id;
+    void *         type;
+    UT_hash_handle hh;
+} cid_type_index_t;
+
+typedef struct {
+    const cid_ldevice_t *ldev;
+    char                 prefix[NEU_CID_FCDA_PREFIX_LEN];
+    char                 lnclass[NEU_CID_LNCLASS_LEN];
+    char                 lninst[NEU_CID_FCDA_INST_LEN];
+} cid_ln_key_t;
+
+typedef struct {
+    cid_ln_key_t   key;
+    const char *   lntype;
+    UT_hash_handle hh;
+} cid_ln_index_t;
+
+/**
+ * @brief 解析完成后建立的类型与 LN 索引，替代按 id 的线性查找。
+ */
+typedef struct {
+    cid_type_index_t *lnotypes;
+    cid_type_index_t *dotypes;
+    cid_type_index_t *datypes;
+    cid_ln_index_t *  lns;
+
+    cid_type_index_t *type_entries;
+    cid_ln_index_t *  ln_entries;
+} cid_index_t;
+
+// 追加一个清零的元素并返回其地址，数组容量按 2 的幂增长
+#define CID_APPEND(array, n)                                  \
+    ((array) = cid_grow((array), (n), sizeof(*(array))),      \
+     memset(&(array)[(n)], 0, sizeof(*(array))), &(array)[(n)++])
 
-static void fill_fcda_type(cid_t *cid);
-static void fill_doi_ctls(cid_t *cid);
+static int  read_scl(cid_reader_t *ctx);
+static void build_index(cid_index_t *index, cid_t *cid);
+static void free_index(cid_index_t *index);
+
+static void fill_fcda_type(cid_t *cid, cid_index_t *index);
+static void fill_doi_ctls(cid_t *cid, cid_index_t *index);
 
 int neu_cid_parse(const char *path, cid_t *cid)
 {
     memset(cid, 0, sizeof(cid_t));
-    xmlDoc *doc = xmlReadFile(path, NULL, 0);
-    if (doc == NULL) {
+    cid_reader_t ctx = { .cid = cid };
+
+    ctx.reader = xmlReaderForFile(path, NULL, 0);
+    if (ctx.reader == NULL) {
         nlog_warn("Failed to read icd file %s", path);
         return -1;
     }
-    xmlNode *root = xmlDocGetRootElement(doc);
-    if (root == NULL || strcmp((const char *) root->name, "SCL") != 0) {
-        nlog_warn("Failed to get root element(SCL)");
-        xmlFreeDoc(doc);
-        return -1;
-    }
-
-    xmlNode *find             = root->children;
-    bool     ied_parsed       = false;
-    bool     templates_parsed = false;
-    while (find != NULL) {
-        if (find->type == XML_ELEMENT_NODE &&
-            strcmp((const char *) find->name, "DataTypeTemplates") == 0) {
-            int ret = parse_template(find, &cid->cid_template);
-            if (ret == 0) {
-                templates_parsed = true;
-            }
-        }
-
-        find = find->next;
-    }
-    xmlNode *find_ied = root->children;
-    while (find_ied != NULL) {
-        if (find_ied->type == XML_ELEMENT_NODE &&
-            strcmp((const char *) find_ied->name, "IED") == 0) {
-            int ret = parse_ied(find_ied, &cid->ied);
-            if (ret == 0) {
-                ied_parsed = true;
-            }
-        }
 
-        find_ied = find_ied->next;
+    int ret = read_scl(&ctx);
+    xmlFreeTextReader(ctx.reader);
+    if (ret != 0) {
+        nlog_warn("Failed to read icd file %s", path);
+        neu_cid_free(cid);
+        return -1;
     }
 
-    if (ied_parsed && templates_parsed) {
-        xmlFreeDoc(doc);
-        fill_fcda_type(cid);
-        fill_doi_ctls(cid);
+    if (ctx.ied_parsed && ctx.templates_parsed) {
+        cid_index_t index = { 0 };
+        build_index(&index, cid);
+        fill_fcda_type(cid, &index);
+        fill_doi_ctls(cid, &index);
+        free_index(&index);
         return 0;
     } else {
         neu_cid_free(cid);
         nlog_warn("Failed to parse IED or DataTypeTemplates, %d, %d",
-                  ied_parsed, templates_parsed);
-        xmlFreeDoc(doc);
+                  ctx.ied_parsed, ctx.templates_parsed);
         return -1;
     }
 }
@@ -191,34 +247,138 @@ void neu_cid_free(cid_t *cid)
     }
 }
 
-static const char *find_type_id(cid_ldevice_t *ldev, const char *prefix,
-                                const char *ln_class, const char *ln_inst)
+static void *cid_grow(void *array, int n, size_t size)
 {
-    for (int i = 0; i < ldev->n_lns; i++) {
-        if (strcmp(ldev->lns[i].lnprefix, prefix) == 0 &&
-            strcmp(ldev->lns[i].lnclass, ln_class) == 0 &&
-            strcmp(ldev->lns[i].lninst, ln_inst) == 0) {
-            return (const char *) ldev->lns[i].lntype;
-        }
+    // n 为 0 或 2 的幂时数组已满
+    if (n > 0 && (n & (n - 1)) != 0) {
+        return array;
     }
-    return NULL;
+    return realloc(array, (n > 0 ? n * 2 : 1) * size);
 }
 
-static cid_tm_do_type_t *find_do_type(cid_template_t *template,
-                                      const char *type_id, const char *do_name)
+static void cid_copy(char *dst, size_t size, const char *src)
 {
-    cid_tm_lno_type_t *lno      = NULL;
-    cid_tm_do_type_t * dotype   = NULL;
-    char *             ref_type = NULL;
+    size_t len = strnlen(src, size - 1);
+    memcpy(dst, src, len);
+    dst[len] = '\0';
+}
 
-    char *do_name_end = strchr(do_name, '.');
+static void ln_key(cid_ln_key_t *key, const cid_ldevice_t *ldev,
+                   const char *prefix, const char *ln_class,
+                   const char *ln_inst)
+{
+    memset(key, 0, sizeof(cid_ln_key_t));
+    key->ldev = ldev;
+    // 键的各字段不短于 LN 与 FCDA 中对应的字段
+    strcpy(key->prefix, prefix);
+    strcpy(key->lnclass, ln_class);
+    strcpy(key->lninst, ln_inst);
+}
+
+static void index_type(cid_type_index_t **head, cid_type_index_t *entry,
+                       const char *id, void *type)
+{
+    cid_type_index_t *find = NULL;
+
+    // 与原先的线性查找一致，id 重复时以第一个为准
+    HASH_FIND_STR(*head, id, find);
+    if (find == NULL) {
+        entry->id   = id;
+        entry->type = type;
+        HASH_ADD_KEYPTR(hh, *head, entry->id, strlen(entry->id), entry);
+    }
+}
+
+static void build_index(cid_index_t *index, cid_t *cid)
+{
+    cid_template_t *template = &cid->cid_template;
+    int             n_types  = template->n_lnotypes + template->n_dotypes +
+        template->n_datypes;
+    int n_lns = 0;
 
+    for (int i = 0; i < cid->ied.n_access_points; i++) {
+        for (int j = 0; j < cid->ied.access_points[i].n_ldevices; j++) {
+            n_lns += cid->ied.access_points[i].ldevices[j].n_lns;
+        }
+    }
+
+    index->type_entries = calloc(n_types + 1, sizeof(cid_type_index_t));
+    index->ln_entries   = calloc(n_lns + 1, sizeof(cid_ln_index_t));
+
+    cid_type_index_t *entry = index->type_entries;
     for (int i = 0; i < template->n_lnotypes; i++) {
-        if (strcmp(template->lnotypes[i].id, type_id) == 0) {
-            lno = &template->lnotypes[i];
-            break;
+        index_type(&index->lnotypes, entry++, template->lnotypes[i].id,
+                   &template->lnotypes[i]);
+    }
+    for (int i = 0; i < template->n_dotypes; i++) {
+        index_type(&index->dotypes, entry++, template->dotypes[i].id,
+                   &template->dotypes[i]);
+    }
+    for (int i = 0; i < template->n_datypes; i++) {
+        index_type(&index->datypes, entry++, template->datypes[i].id,
+                   &template->datypes[i]);
+    }
+
+    cid_ln_index_t *ln_entry = index->ln_entries;
+    for (int i = 0; i < cid->ied.n_access_points; i++) {
+        for (int j = 0; j < cid->ied.access_points[i].n_ldevices; j++) {
+            cid_ldevice_t *ldev = &cid->ied.access_points[i].ldevices[j];
+            for (int k = 0; k < ldev->n_lns; k++) {
+                cid_ln_index_t *find = NULL;
+
+                ln_key(&ln_entry->key, ldev, ldev->lns[k].lnprefix,
+                       ldev->lns[k].lnclass, ldev->lns[k].lninst);
+                HASH_FIND(hh, index->lns, &ln_entry->key, sizeof(cid_ln_key_t),
+                          find);
+                if (find == NULL) {
+                    ln_entry->lntype = ldev->lns[k].lntype;
+                    HASH_ADD(hh, index->lns, key, sizeof(cid_ln_key_t),
+                             ln_entry);
+                    ln_entry += 1;
+                }
+            }
         }
     }
+}
+
+static void free_index(cid_index_t *index)
+{
+    HASH_CLEAR(hh, index->lnotypes);
+    HASH_CLEAR(hh, index->dotypes);
+    HASH_CLEAR(hh, index->datypes);
+    HASH_CLEAR(hh, index->lns);
+    free(index->type_entries);
+    free(index->ln_entries);
+}
+
+static void *find_type(cid_type_index_t *head, const char *id)
+{
+    cid_type_index_t *find = NULL;
+
+    HASH_FIND_STR(head, id, find);
+    return find != NULL ? find->type : NULL;
+}
+
+static const char *find_type_id(cid_index_t *index, cid_ldevice_t *ldev,
+                                const char *prefix, const char *ln_class,
+                                const char *ln_inst)
+{
+    cid_ln_key_t    key  = { 0 };
+    cid_ln_index_t *find = NULL;
+
+    ln_key(&key, ldev, prefix, ln_class, ln_inst);
+    HASH_FIND(hh, index->lns, &key, sizeof(cid_ln_key_t), find);
+    return find != NULL ? find->lntype : NULL;
+}
+
+static cid_tm_do_type_t *find_do_type(cid_index_t *index, const char *type_id,
+                                      const char *do_name)
+{
+    cid_tm_lno_type_t *lno      = find_type(index->lnotypes, type_id);
+    cid_tm_do_type_t * dotype   = NULL;
+    char *             ref_type = NULL;
+
+    char *do_name_end = strchr(do_name, '.');
 
     if (lno != NULL) {
         for (int i = 0; i < lno->n_dos; i++) {
@@ -240,12 +400,7 @@ static cid_tm_do_type_t *find_do_type(cid_template_t *template,
     }
 
     if (ref_type != NULL) {
-        for (int i = 0; i < template->n_dotypes; i++) {
-            if (strcmp(template->dotypes[i].id, ref_type) == 0) {
-                dotype = &template->dotypes[i];
-                break;
-            }
-        }
+        dotype = find_type(index->dotypes, ref_type);
     } else {
         nlog_warn("Failed to find ref type %s, %s", type_id, do_name);
     }
@@ -253,12 +408,10 @@ static cid_tm_do_type_t *find_do_type(cid_template_t *template,
     if (dotype != NULL && do_name_end != NULL) {
         for (int i = 0; i < dotype->n_sdos; i++) {
             if (strcmp(dotype->sdos[i].name, do_name_end + 1) == 0) {
-                ref_type = dotype->sdos[i].ref_type;
-                for (int j = 0; j < template->n_dotypes; j++) {
-                    if (strcmp(template->dotypes[j].id, ref_type) == 0) {
-                        dotype = &template->dotypes[j];
-                        break;
-                    }
+                cid_tm_do_type_t *sdo_type =
+                    find_type(index->dotypes, dotype->sdos[i].ref_type);
+                if (sdo_type != NULL) {
+                    dotype = sdo_type;
                 }
                 break;
             }
@@ -273,47 +426,46 @@ typedef struct {
     cid_basictype_e btype;
 } da_basic_type_t;
 
-static int find_da_basic_type(cid_template_t *template, const char *datype_id,
+static int find_da_basic_type(cid_index_t *index, const char *datype_id,
                               const char *seg_name, da_basic_type_t *da_types)
 {
-    char name[NEU_CID_LEN64] = { 0 };
-    int  index               = 0;
-    for (int i = 0; i < template->n_datypes; i++) {
-        if (strcmp(template->datypes[i].id, datype_id) == 0) {
-            for (int j = 0; j < template->datypes[i].n_bdas; j++) {
-                if (strlen(seg_name) > 0) {
-                    snprintf(name, sizeof(name), "%s.%s", seg_name,
-                             template->datypes[i].bdas[j].name);
-                } else {
-                    snprintf(name, sizeof(name), "%s",
-                             template->datypes[i].bdas[j].name);
-                }
-                if (template->datypes[i].bdas[j].btype == Struct) {
-                    index += find_da_basic_type(
-                        template, template->datypes[i].bdas[j].ref_type, name,
-                        da_types + index);
-                } else {
-                    strcpy(da_types[index].all_name, name);
-                    da_types[index].btype = template->datypes[i].bdas[j].btype;
-                    index += 1;
-                }
-            }
-            break;
+    cid_tm_da_type_t *datype = find_type(index->datypes, datype_id);
+    char              name[NEU_CID_LEN64] = { 0 };
+    int               n                   = 0;
+
+    if (datype == NULL) {
+        return 0;
+    }
+
+    for (int j = 0; j < datype->n_bdas; j++) {
+        if (strlen(seg_name) > 0) {
+            snprintf(name, sizeof(name), "%s.%s", seg_name,
+                     datype->bdas[j].name);
+        } else {
+            snprintf(name, sizeof(name), "%s", datype->bdas[j].name);
+        }
+        if (datype->bdas[j].btype == Struct) {
+            n += find_da_basic_type(index, datype->bdas[j].ref_type, name,
+                                    da_types + n);
+        } else {
+            strcpy(da_types[n].all_name, name);
+            da_types[n].btype = datype->bdas[j].btype;
+            n += 1;
         }
     }
 
-    return index;
+    return n;
 }
 
-static int find_basic_type(cid_template_t *template, const char *type_id,
+static int find_basic_type(cid_index_t *index, const char *type_id,
                            const char *do_name, const char *da_name,
                            cid_fc_e fc, cid_basictype_e **btypes)
 {
     *btypes                  = NULL;
     cid_tm_do_type_t *dotype = NULL;
-    int               index  = 0;
+    int               n      = 0;
 
-    dotype = find_do_type(template, type_id, do_name);
+    dotype = find_do_type(index, type_id, do_name);
     if (dotype == NULL) {
         nlog_warn("Failed to find do type %s", type_id);
         return 0;
@@ -325,46 +477,46 @@ static int find_basic_type(cid_template_t *template, const char *type_id,
         }
 
         if (dotype->das[i].btype != Struct) {
-            index += 1;
-            *btypes = realloc(*btypes, index * sizeof(cid_basictype_e));
-            (*btypes)[index - 1] = dotype->das[i].btype;
+            n += 1;
+            *btypes          = realloc(*btypes, n * sizeof(cid_basictype_e));
+            (*btypes)[n - 1] = dotype->das[i].btype;
             continue;
         }
 
         da_basic_type_t da_types[32] = { 0 };
-        int n_da_types = find_da_basic_type(template, dotype->das[i].ref_type,
+        int n_da_types = find_da_basic_type(index, dotype->das[i].ref_type,
                                             dotype->das[i].name, da_types);
         for (int j = 0; j < n_da_types; j++) {
             if (strlen(da_name) > 0) {
                 if (strcmp(da_types[j].all_name, da_name) == 0) {
-                    index += 1;
-                    *btypes = realloc(*btypes, index * sizeof(cid_basictype_e));
-                    (*btypes)[index - 1] = da_types[j].btype | 0x80;
+                    n += 1;
+                    *btypes = realloc(*btypes, n * sizeof(cid_basictype_e));
+                    (*btypes)[n - 1] = da_types[j].btype | 0x80;
                     break;
                 }
             } else {
-                index += 1;
-                *btypes = realloc(*btypes, index * sizeof(cid_basictype_e));
-                (*btypes)[index - 1] = da_types[j].btype | 0x80;
+                n += 1;
+                *btypes = realloc(*btypes, n * sizeof(cid_basictype_e));
+                (*btypes)[n - 1] = da_types[j].btype | 0x80;
             }
         }
     }
 
-    return index;
+    return n;
 }
 
 static void update_dataset(cid_dataset_t *dataset, cid_ldevice_t *ldev,
-                           cid_template_t *template)
+                           cid_index_t *index)
 {
     for (int i = 0; i < dataset->n_fcda; i++) {
         // LN lnType
         const char *type_id =
-            find_type_id(ldev, dataset->fcdas[i].prefix,
+            find_type_id(index, ldev, dataset->fcdas[i].prefix,
                          dataset->fcdas[i].lnclass, dataset->fcdas[i].lninst);
         if (type_id != NULL) {
             cid_basictype_e *bs  = NULL;
             int              ret = find_basic_type(
-                template, type_id, dataset->fcdas[i].do_name,
+                index, type_id, dataset->fcdas[i].do_name,
                 dataset->fcdas[i].da_name, dataset->fcdas[i].fc, &bs);
             if (ret > 0) {
                 if (ret <= 16) {
@@ -382,15 +534,15 @@ static void update_dataset(cid_dataset_t *dataset, cid_ldevice_t *ldev,
                 free(bs);
             }
         } else {
-            nlog_warn("Failed to find LN lnType for %s %s %s %s %s %d %s",
+            nlog_warn("Failed to find LN lnType for %s %s %s %s %s %d",
                       dataset->fcdas[i].da_name, dataset->fcdas[i].do_name,
                       dataset->fcdas[i].lnclass, dataset->fcdas[i].lninst,
-                      dataset->fcdas[i].prefix, dataset->fcdas[i].fc, type_id);
+                      dataset->fcdas[i].prefix, dataset->fcdas[i].fc);
         }
     }
 }
 
-static void fill_fcda_type(cid_t *cid)
+static void fill_fcda_type(cid_t *cid, cid_index_t *index)
 {
     for (int i = 0; i < cid->ied.n_access_points; i++) {
         for (int j = 0; j < cid->ied.access_points[i].n_ldevices; j++) {
@@ -408,7 +560,7 @@ static void fill_fcda_type(cid_t *cid)
                                             .ldevices[j]
                                             .lns[k]
                                             .datasets[l],
-                                       ldev, &cid->cid_template);
+                                       ldev, index);
                     }
                 }
             }
@@ -417,11 +569,10 @@ static void fill_fcda_type(cid_t *cid)
 }
 
 static void update_doi(const char *ref_type, cid_doi_t *dois, int n_dois,
-                       cid_template_t *template)
+                       cid_index_t *index)
 {
     for (int i = 0; i < n_dois; i++) {
-        cid_tm_do_type_t *tm_do =
-            find_do_type(template, ref_type, dois[i].name);
+        cid_tm_do_type_t *tm_do = find_do_type(index, ref_type, dois[i].name);
 
         if (tm_do == NULL) {
             continue;
@@ -433,11 +584,8 @@ static void update_doi(const char *ref_type, cid_doi_t *dois, int n_dois,
             if (da->btype != Struct) {
                 // CO must be Struct
                 if (da->fc == SP || da->fc == SG) {
-                    dois[i].n_ctls += 1;
-                    dois[i].ctls = realloc(
-                        dois[i].ctls, dois[i].n_ctls * sizeof(cid_doi_ctl_t));
-                    cid_doi_ctl_t *ctl = &dois[i].ctls[dois[i].n_ctls - 1];
-                    memset(ctl, 0, sizeof(cid_doi_ctl_t));
+                    cid_doi_ctl_t *ctl =
+                        CID_APPEND(dois[i].ctls, dois[i].n_ctls);
 
                     ctl->btype = da->btype;
                     ctl->fc    = da->fc;
@@ -447,15 +595,12 @@ static void update_doi(const char *ref_type, cid_doi_t *dois, int n_dois,
 
             da_basic_type_t da_types[32] = { 0 };
             int             n_da_types   = find_da_basic_type(
-                template, tm_do->das[k].ref_type, tm_do->das[k].name, da_types);
+                index, tm_do->das[k].ref_type, tm_do->das[k].name, da_types);
 
             if (da->fc == SP || da->fc == SG) {
                 for (int j = 0; j < n_da_types; j++) {
-                    dois[i].n_ctls += 1;
-                    dois[i].ctls = realloc(
-                        dois[i].ctls, dois[i].n_ctls * sizeof(cid_doi_ctl_t));
-                    cid_doi_ctl_t *ctl = &dois[i].ctls[dois[i].n_ctls - 1];
-                    memset(ctl, 0, sizeof(cid_doi_ctl_t));
+                    cid_doi_ctl_t *ctl =
+                        CID_APPEND(dois[i].ctls, dois[i].n_ctls);
 
                     ctl->btype = da_types[j].btype;
                     ctl->fc    = da->fc;
@@ -464,11 +609,7 @@ static void update_doi(const char *ref_type, cid_doi_t *dois, int n_dois,
             }
 
             if (da->fc == CO) {
-                dois[i].n_ctls += 1;
-                dois[i].ctls       = realloc(dois[i].ctls,
-                                       dois[i].n_ctls * sizeof(cid_doi_ctl_t));
-                cid_doi_ctl_t *ctl = &dois[i].ctls[dois[i].n_ctls - 1];
-                memset(ctl, 0, sizeof(cid_doi_ctl_t));
+                cid_doi_ctl_t *ctl = CID_APPEND(dois[i].ctls, dois[i].n_ctls);
 
                 ctl->btype = da_types[0].btype;
                 ctl->fc    = da->fc;
@@ -482,7 +623,7 @@ static void update_doi(const char *ref_type, cid_doi_t *dois, int n_dois,
     }
 }
 
-static void fill_doi_ctls(cid_t *cid)
+static void fill_doi_ctls(cid_t *cid, cid_index_t *index)
 {
     for (int i = 0; i < cid->ied.n_access_points; i++) {
         for (int j = 0; j < cid->ied.access_points[i].n_ldevices; j++) {
@@ -491,624 +632,509 @@ static void fill_doi_ctls(cid_t *cid)
                 update_doi(cid->ied.access_points[i].ldevices[j].lns[k].lntype,
                            cid->ied.access_points[i].ldevices[j].lns[k].dois,
                            cid->ied.access_points[i].ldevices[j].lns[k].n_dois,
-                           &cid->cid_template);
+                           index);
             }
         }
     }
 }
 
-static int parse_ied(xmlNode *xml_ied, cid_ied_t *ied)
+static void read_attrs(xmlTextReaderPtr reader, cid_attr_t *attrs, int n)
 {
-    int   ret      = -1;
-    char *ied_name = (char *) xmlGetProp(xml_ied, (const xmlChar *) "name");
-    if (strlen(ied_name) >= NEU_CID_IED_NAME_LEN) {
-        xmlFree(ied_name);
-        nlog_warn("IED name is too long");
-        return -1;
-    } else {
-        strcpy(ied->name, ied_name);
-        xmlFree(ied_name);
-    }
-    xmlNode *access_point = xml_ied->children;
-    while (access_point != NULL) {
-        if (access_point->type == XML_ELEMENT_NODE &&
-            strcmp((const char *) access_point->name, "AccessPoint") == 0) {
-            char *name =
-                (char *) xmlGetProp(access_point, (const xmlChar *) "name");
-            ied->n_access_points += 1;
-            ied->access_points =
-                realloc(ied->access_points,
-                        ied->n_access_points * sizeof(cid_access_point_t));
-            cid_access_point_t *ap =
-                &ied->access_points[ied->n_access_points - 1];
-            memset(ap, 0, sizeof(cid_access_point_t));
-
-            if (name != NULL) {
-                strcpy(ap->name, name);
-                xmlFree(name);
-            }
-
-            xmlNode *server = access_point->children;
-            while (server != NULL) {
-                if (server->type == XML_ELEMENT_NODE &&
-                    strcmp((const char *) server->name, "Server") == 0) {
-                    ret = parse_ldevice(server, ap);
-                    break;
-                }
-
-                server = server->next;
+    while (xmlTextReaderMoveToNextAttribute(reader) == 1) {
+        const char *name = (const char *) xmlTextReaderConstLocalName(reader);
+        for (int i = 0; i < n; i++) {
+            if (!attrs[i].set && strcmp(name, attrs[i].name) == 0) {
+                const char *value =
+                    (const char *) xmlTextReaderConstValue(reader);
+                snprintf(attrs[i].value, sizeof(attrs[i].value), "%s",
+                         value != NULL ? value : "");
+                attrs[i].set = true;
+                break;
             }
-            break;
         }
-        access_point = access_point->next;
     }
+    xmlTextReaderMoveToElement(reader);
+}
 
-    return ret;
+static int reader_line(cid_reader_t *ctx)
+{
+    return xmlTextReaderGetParserLineNumber(ctx->reader);
 }
 
-static int parse_ldevice(xmlNode *xml_server, cid_access_point_t *ap)
+static cid_access_point_t *current_ap(cid_reader_t *ctx)
 {
-    ap->ldevices     = NULL;
-    ap->n_ldevices   = 0;
-    xmlNode *ldevice = xml_server->children;
+    return &ctx->cid->ied.access_points[ctx->cid->ied.n_access_points - 1];
+}
 
-    while (ldevice != NULL) {
-        if (ldevice->type != XML_ELEMENT_NODE) {
-            ldevice = ldevice->next;
-            continue;
-        }
-        if (strcmp((const char *) ldevice->name, "LDevice") == 0) {
-            ap->n_ldevices += 1;
-            ap->ldevices =
-                realloc(ap->ldevices, ap->n_ldevices * sizeof(cid_ldevice_t));
-            cid_ldevice_t *ldev = &ap->ldevices[ap->n_ldevices - 1];
-            memset(ldev, 0, sizeof(cid_ldevice_t));
-            char *inst = (char *) xmlGetProp(ldevice, (const xmlChar *) "inst");
-            if (inst != NULL) {
-                strcpy(ldev->inst, inst);
-                xmlFree(inst);
-            }
-            int ret = parse_lnode(ldevice, ldev);
-            if (ret != 0) {
-                return ret;
-            }
-        }
+static cid_ldevice_t *current_ldevice(cid_reader_t *ctx)
+{
+    cid_access_point_t *ap = current_ap(ctx);
+    return &ap->ldevices[ap->n_ldevices - 1];
+}
 
-        ldevice = ldevice->next;
+static cid_ln_t *current_ln(cid_reader_t *ctx)
+{
+    cid_ldevice_t *ldev = current_ldevice(ctx);
+    return &ldev->lns[ldev->n_lns - 1];
+}
+
+static cid_node_e open_ied(cid_reader_t *ctx)
+{
+    cid_attr_t attrs[] = { { .name = "name" } };
+
+    read_attrs(ctx->reader, attrs, 1);
+    if (!attrs[0].set || strlen(attrs[0].value) >= NEU_CID_IED_NAME_LEN) {
+        nlog_warn("IED name is too long");
+        return CID_NODE_SKIP;
     }
 
-    return 0;
+    strcpy(ctx->cid->ied.name, attrs[0].value);
+    ctx->has_access_point = false;
+    return CID_NODE_IED;
 }
 
-static int parse_lnode(xmlNode *xml_ldevice, cid_ldevice_t *ldev)
+static cid_node_e open_access_point(cid_reader_t *ctx)
 {
-    xmlNode *lnode = xml_ldevice->children;
-    while (lnode != NULL) {
-        if (lnode->type == XML_ELEMENT_NODE &&
-            strncmp((const char *) lnode->name, "LN", 2) == 0) {
-            char *ln_class =
-                (char *) xmlGetProp(lnode, (const xmlChar *) "lnClass");
-            char *ln_type =
-                (char *) xmlGetProp(lnode, (const xmlChar *) "lnType");
-            char *ln_prefix =
-                (char *) xmlGetProp(lnode, (const xmlChar *) "prefix");
-            char *ln_inst =
-                (char *) xmlGetProp(lnode, (const xmlChar *) "inst");
-
-            ldev->n_lns += 1;
-            ldev->lns    = realloc(ldev->lns, ldev->n_lns * sizeof(cid_ln_t));
-            cid_ln_t *ln = &ldev->lns[ldev->n_lns - 1];
-            memset(ln, 0, sizeof(cid_ln_t));
-
-            if (ln_class != NULL) {
-                strncpy(ln->lnclass, ln_class, sizeof(ln->lnclass) - 1);
-                xmlFree(ln_class);
-            }
-            if (ln_type != NULL) {
-                strncpy(ln->lntype, ln_type, sizeof(ln->lntype) - 1);
-                xmlFree(ln_type);
-            }
-            if (ln_prefix != NULL) {
-                strncpy(ln->lnprefix, ln_prefix, sizeof(ln->lnprefix) - 1);
-                xmlFree(ln_prefix);
-            }
-            if (ln_inst != NULL) {
-                strncpy(ln->lninst, ln_inst, sizeof(ln->lninst) - 1);
-                xmlFree(ln_inst);
-            }
+    cid_attr_t attrs[] = { { .name = "name" } };
 
-            xmlNode *child = lnode->children;
-            while (child != NULL) {
-                if (child->type != XML_ELEMENT_NODE) {
-                    child = child->next;
-                    continue;
-                }
+    // 每个 IED 只解析第一个 AccessPoint
+    if (ctx->has_access_point) {
+        return CID_NODE_SKIP;
+    }
+    ctx->has_access_point = true;
+    ctx->has_server       = false;
+
+    read_attrs(ctx->reader, attrs, 1);
+    cid_access_point_t *ap =
+        CID_APPEND(ctx->cid->ied.access_points, ctx->cid->ied.n_access_points);
+    cid_copy(ap->name, sizeof(ap->name), attrs[0].value);
+    return CID_NODE_ACCESS_POINT;
+}
 
-                if (strcmp((const char *) child->name, "DataSet") == 0) {
-                    int ret = parse_dataset(child, ln);
-                    if (ret != 0) {
-                        return ret;
-                    }
-                }
-                if (strcmp((const char *) child->name, "ReportControl") == 0) {
-                    int ret = parse_report(child, ln);
-                    if (ret != 0) {
-                        return ret;
-                    }
-                }
-                if (strcmp((const char *) child->name, "DOI") == 0) {
-                    int ret = parse_doi(child, ln);
-                    if (ret != 0) {
-                        return ret;
-                    }
-                }
+static cid_node_e open_server(cid_reader_t *ctx)
+{
+    // 每个 AccessPoint 只解析第一个 Server
+    if (ctx->has_server) {
+        return CID_NODE_SKIP;
+    }
+    ctx->has_server = true;
+    ctx->ied_parsed = true;
+    return CID_NODE_SERVER;
+}
 
-                child = child->next;
-            }
-        }
+static cid_node_e open_ldevice(cid_reader_t *ctx)
+{
+    cid_attr_t attrs[] = { { .name = "inst" } };
+
+    read_attrs(ctx->reader, attrs, 1);
+    cid_access_point_t *ap   = current_ap(ctx);
+    cid_ldevice_t *     ldev = CID_APPEND(ap->ldevices, ap->n_ldevices);
+    cid_copy(ldev->inst, sizeof(ldev->inst), attrs[0].value);
+    return CID_NODE_LDEVICE;
+}
 
-        lnode = lnode->next;
+static cid_node_e open_ln(cid_reader_t *ctx)
+{
+    cid_attr_t attrs[] = {
+        { .name = "lnClass" },
+        { .name = "lnType" },
+        { .name = "prefix" },
+        { .name = "inst" },
+    };
+
+    read_attrs(ctx->reader, attrs, 4);
+    cid_ldevice_t *ldev = current_ldevice(ctx);
+    cid_ln_t *     ln   = CID_APPEND(ldev->lns, ldev->n_lns);
+    cid_copy(ln->lnclass, sizeof(ln->lnclass), attrs[0].value);
+    cid_copy(ln->lntype, sizeof(ln->lntype), attrs[1].value);
+    cid_copy(ln->lnprefix, sizeof(ln->lnprefix), attrs[2].value);
+    cid_copy(ln->lninst, sizeof(ln->lninst), attrs[3].value);
+    return CID_NODE_LN;
+}
+
+static cid_node_e open_dataset(cid_reader_t *ctx)
+{
+    cid_attr_t attrs[] = { { .name = "name" } };
+
+    read_attrs(ctx->reader, attrs, 1);
+    if (!attrs[0].set) {
+        return CID_NODE_SKIP;
     }
 
-    return 0;
+    cid_ln_t *     ln      = current_ln(ctx);
+    cid_dataset_t *dataset = CID_APPEND(ln->datasets, ln->n_datasets);
+    cid_copy(dataset->name, sizeof(dataset->name), attrs[0].value);
+    return CID_NODE_DATASET;
 }
 
-static int parse_dataset(xmlNode *xml_dataset, cid_ln_t *ln)
+static void add_fcda(cid_reader_t *ctx)
 {
-    char *dataset_name =
-        (char *) xmlGetProp(xml_dataset, (const xmlChar *) "name");
-    if (dataset_name != NULL) {
-        ln->n_datasets += 1;
-        ln->datasets =
-            realloc(ln->datasets, ln->n_datasets * sizeof(cid_dataset_t));
-        cid_dataset_t *dataset = &ln->datasets[ln->n_datasets - 1];
-        memset(dataset, 0, sizeof(cid_dataset_t));
-
-        strncpy(dataset->name, dataset_name, sizeof(dataset->name) - 1);
-        xmlFree(dataset_name);
-
-        xmlNode *xfcda = xml_dataset->children;
-        while (xfcda != NULL) {
-            if (xfcda->type != XML_ELEMENT_NODE) {
-                xfcda = xfcda->next;
-                continue;
-            }
+    cid_attr_t attrs[] = {
+        { .name = "daName" }, { .name = "doName" }, { .name = "fc" },
+        { .name = "lnInst" }, { .name = "lnClass" }, { .name = "ldInst" },
+        { .name = "prefix" },
+    };
 
-            if (strcmp((const char *) xfcda->name, "FCDA") == 0) {
-                char *da_name =
-                    (char *) xmlGetProp(xfcda, (const xmlChar *) "daName");
-                char *do_name =
-                    (char *) xmlGetProp(xfcda, (const xmlChar *) "doName");
-                char *fc = (char *) xmlGetProp(xfcda, (const xmlChar *) "fc");
-                char *ln_inst =
-                    (char *) xmlGetProp(xfcda, (const xmlChar *) "lnInst");
-                char *ln_class =
-                    (char *) xmlGetProp(xfcda, (const xmlChar *) "lnClass");
-                char *ld_inst =
-                    (char *) xmlGetProp(xfcda, (const xmlChar *) "ldInst");
-                char *prefix =
-                    (char *) xmlGetProp(xfcda, (const xmlChar *) "prefix");
-
-                dataset->n_fcda += 1;
-                dataset->fcdas   = realloc(dataset->fcdas,
-                                         dataset->n_fcda * sizeof(cid_fcda_t));
-                cid_fcda_t *fcda = &dataset->fcdas[dataset->n_fcda - 1];
-                memset(fcda, 0, sizeof(cid_fcda_t));
-
-                if (da_name != NULL) {
-                    strncpy(fcda->da_name, da_name, sizeof(fcda->da_name) - 1);
-                    xmlFree(da_name);
-                }
-                if (do_name != NULL) {
-                    strncpy(fcda->do_name, do_name, sizeof(fcda->do_name) - 1);
-                    xmlFree(do_name);
-                }
-                if (ln_class != NULL) {
-                    strncpy(fcda->lnclass, ln_class, sizeof(fcda->lnclass) - 1);
-                    xmlFree(ln_class);
-                }
-                if (prefix != NULL) {
-                    strncpy(fcda->prefix, prefix, sizeof(fcda->prefix) - 1);
-                    xmlFree(prefix);
-                }
-                if (ln_inst != NULL) {
-                    strncpy(fcda->lninst, ln_inst, sizeof(fcda->lninst) - 1);
-                    xmlFree(ln_inst);
-                }
-                if (ld_inst != NULL) {
-                    strncpy(fcda->ldinst, ld_inst, sizeof(fcda->ldinst) - 1);
-                    xmlFree(ld_inst);
-                }
-                fcda->fc = F_UNKNOWN;
-                if (fc != NULL) {
-                    fcda->fc = decode_fc((const char *) fc);
-                    xmlFree(fc);
-                }
-                if (fcda->fc == F_UNKNOWN) {
-                    nlog_warn("Unknown FC %d", (int) xfcda->line);
-                }
-            }
+    read_attrs(ctx->reader, attrs, 7);
+    cid_ln_t *     ln      = current_ln(ctx);
+    cid_dataset_t *dataset = &ln->datasets[ln->n_datasets - 1];
+    cid_fcda_t *   fcda    = CID_APPEND(dataset->fcdas, dataset->n_fcda);
+
+    cid_copy(fcda->da_name, sizeof(fcda->da_name), attrs[0].value);
+    cid_copy(fcda->do_name, sizeof(fcda->do_name), attrs[1].value);
+    cid_copy(fcda->lninst, sizeof(fcda->lninst), attrs[3].value);
+    cid_copy(fcda->lnclass, sizeof(fcda->lnclass), attrs[4].value);
+    cid_copy(fcda->ldinst, sizeof(fcda->ldinst), attrs[5].value);
+    cid_copy(fcda->prefix, sizeof(fcda->prefix), attrs[6].value);
+    fcda->fc = F_UNKNOWN;
+    if (attrs[2].set) {
+        fcda->fc = decode_fc(attrs[2].value);
+    }
+    if (fcda->fc == F_UNKNOWN) {
+        nlog_warn("Unknown FC %d", reader_line(ctx));
+    }
+}
 
-            xfcda = xfcda->next;
-        }
+static void add_report(cid_reader_t *ctx)
+{
+    cid_attr_t attrs[] = {
+        { .name = "name" },     { .name = "rptID" },  { .name = "datSet" },
+        { .name = "buffered" }, { .name = "intgPd" },
+    };
+
+    read_attrs(ctx->reader, attrs, 5);
+    cid_ln_t *    ln     = current_ln(ctx);
+    cid_report_t *report = CID_APPEND(ln->reports, ln->n_reports);
+
+    cid_copy(report->name, sizeof(report->name), attrs[0].value);
+    cid_copy(report->id, sizeof(report->id), attrs[1].value);
+    cid_copy(report->dataset, sizeof(report->dataset), attrs[2].value);
+    report->buffered = strcmp(attrs[3].value, "true") == 0;
+    if (attrs[4].set) {
+        int interval    = atoi(attrs[4].value);
+        report->intg_pd = interval > 0 ? interval : 15000;
     }
-    return 0;
 }
 
-static int parse_report(xmlNode *xml_report, cid_ln_t *ln)
+static cid_node_e open_doi(cid_reader_t *ctx)
 {
-    char *report_name =
-        (char *) xmlGetProp(xml_report, (const xmlChar *) "name");
-    char *report_id =
-        (char *) xmlGetProp(xml_report, (const xmlChar *) "rptID");
-    char *dataset = (char *) xmlGetProp(xml_report, (const xmlChar *) "datSet");
-    char *buffered =
-        (char *) xmlGetProp(xml_report, (const xmlChar *) "buffered");
-    char *intg_pd = (char *) xmlGetProp(xml_report, (const xmlChar *) "intgPd");
-
-    ln->n_reports += 1;
-    ln->reports = realloc(ln->reports, ln->n_reports * sizeof(cid_report_t));
-    cid_report_t *report = &ln->reports[ln->n_reports - 1];
-    memset(report, 0, sizeof(cid_report_t));
-
-    if (report_name != NULL) {
-        strncpy(report->name, report_name, sizeof(report->name) - 1);
-        xmlFree(report_name);
+    cid_attr_t attrs[] = { { .name = "name" } };
+
+    read_attrs(ctx->reader, attrs, 1);
+    if (!attrs[0].set) {
+        return CID_NODE_SKIP;
     }
-    if (report_id != NULL) {
-        strncpy(report->id, report_id, sizeof(report->id) - 1);
-        xmlFree(report_id);
+
+    cid_ln_t * ln  = current_ln(ctx);
+    cid_doi_t *doi = CID_APPEND(ln->dois, ln->n_dois);
+    cid_copy(doi->name, sizeof(doi->name), attrs[0].value);
+    return CID_NODE_DOI;
+}
+
+static cid_node_e open_sdi(cid_reader_t *ctx)
+{
+    cid_attr_t attrs[] = { { .name = "name" } };
+
+    read_attrs(ctx->reader, attrs, 1);
+    if (!attrs[0].set) {
+        return CID_NODE_SKIP;
     }
-    if (dataset != NULL) {
-        strncpy(report->dataset, dataset, sizeof(report->dataset) - 1);
-        xmlFree(dataset);
+
+    cid_copy(ctx->sdi_name, sizeof(ctx->sdi_name), attrs[0].value);
+    return CID_NODE_SDI;
+}
+
+static void add_dai(cid_reader_t *ctx, const char *sdi_name)
+{
+    cid_attr_t attrs[] = { { .name = "name" } };
+
+    read_attrs(ctx->reader, attrs, 1);
+    if (!attrs[0].set) {
+        return;
     }
-    if (buffered != NULL) {
-        if (strcmp(buffered, "true") == 0) {
-            report->buffered = true;
-        } else {
-            report->buffered = false;
-        }
-        xmlFree(buffered);
+
+    cid_ln_t * ln  = current_ln(ctx);
+    cid_doi_t *doi = &ln->dois[ln->n_dois - 1];
+    cid_dai_t *dai = CID_APPEND(doi->dais, doi->n_dais);
+    cid_copy(dai->name, sizeof(dai->name), attrs[0].value);
+    if (sdi_name != NULL) {
+        cid_copy(dai->sdi_name, sizeof(dai->sdi_name), sdi_name);
     }
-    if (intg_pd != NULL) {
-        int interval = atoi(intg_pd);
-        if (interval > 0) {
-            report->intg_pd = interval;
-        } else {
-            report->intg_pd = 15000;
-        }
-        xmlFree(intg_pd);
+}
+
+static cid_node_e open_lnotype(cid_reader_t *ctx)
+{
+    cid_template_t *template = &ctx->cid->cid_template;
+    cid_attr_t      attrs[]  = { { .name = "id" }, { .name = "lnClass" } };
+
+    read_attrs(ctx->reader, attrs, 2);
+    if (!attrs[0].set || !attrs[1].set) {
+        return CID_NODE_SKIP;
     }
 
-    return 0;
+    cid_tm_lno_type_t *tm_lno =
+        CID_APPEND(template->lnotypes, template->n_lnotypes);
+    cid_copy(tm_lno->id, sizeof(tm_lno->id), attrs[0].value);
+    cid_copy(tm_lno->ln_class, sizeof(tm_lno->ln_class), attrs[1].value);
+    return CID_NODE_LNOTYPE;
 }
 
-static int parse_doi(xmlNode *xml_doi, cid_ln_t *ln)
+static void add_lno_do(cid_reader_t *ctx)
 {
-    char *name = (char *) xmlGetProp(xml_doi, (const xmlChar *) "name");
-    if (name != NULL) {
-        ln->n_dois += 1;
-        ln->dois       = realloc(ln->dois, ln->n_dois * sizeof(cid_doi_t));
-        cid_doi_t *doi = &ln->dois[ln->n_dois - 1];
-        memset(doi, 0, sizeof(cid_doi_t));
-
-        strncpy(doi->name, name, sizeof(doi->name) - 1);
-        xmlFree(name);
-
-        xmlNode *child = xml_doi->children;
-        while (child != NULL) {
-            if (child->type != XML_ELEMENT_NODE) {
-                child = child->next;
-                continue;
-            }
-            if (strcmp((const char *) child->name, "DAI") == 0) {
-                char *dai_name =
-                    (char *) xmlGetProp(child, (const xmlChar *) "name");
-                if (dai_name != NULL) {
-                    doi->n_dais += 1;
-                    doi->dais =
-                        realloc(doi->dais, doi->n_dais * sizeof(cid_dai_t));
-                    cid_dai_t *dai = &doi->dais[doi->n_dais - 1];
-                    memset(dai, 0, sizeof(cid_dai_t));
-
-                    strncpy(dai->name, dai_name, sizeof(dai->name) - 1);
-                    xmlFree(dai_name);
-                }
-            }
+    cid_template_t *   template = &ctx->cid->cid_template;
+    cid_tm_lno_type_t *tm_lno   = &template->lnotypes[template->n_lnotypes - 1];
+    cid_attr_t         attrs[]  = { { .name = "name" }, { .name = "type" } };
 
-            if (strcmp((const char *) child->name, "SDI") == 0) {
-                char *sdi_name =
-                    (char *) xmlGetProp(child, (const xmlChar *) "name");
-                if (sdi_name != NULL) {
-                    xmlNode *dai = child->children;
-                    while (dai != NULL) {
-                        if (dai->type != XML_ELEMENT_NODE) {
-                            dai = dai->next;
-                            continue;
-                        }
+    read_attrs(ctx->reader, attrs, 2);
+    if (!attrs[0].set || !attrs[1].set) {
+        return;
+    }
 
-                        if (strcmp((const char *) dai->name, "DAI") == 0) {
-                            char *dai_name = (char *) xmlGetProp(
-                                dai, (const xmlChar *) "name");
-                            if (dai_name != NULL) {
-                                doi->n_dais += 1;
-                                doi->dais = realloc(
-                                    doi->dais, doi->n_dais * sizeof(cid_dai_t));
-                                cid_dai_t *t_dai = &doi->dais[doi->n_dais - 1];
-                                memset(t_dai, 0, sizeof(cid_dai_t));
-
-                                strncpy(t_dai->name, dai_name,
-                                        sizeof(t_dai->name) - 1);
-                                strncpy(t_dai->sdi_name, sdi_name,
-                                        sizeof(t_dai->sdi_name) - 1);
-                                xmlFree(dai_name);
-                            }
-                        }
+    cid_tm_lno_do_t *tm_do = CID_APPEND(tm_lno->dos, tm_lno->n_dos);
+    cid_copy(tm_do->name, sizeof(tm_do->name), attrs[0].value);
+    cid_copy(tm_do->ref_type, sizeof(tm_do->ref_type), attrs[1].value);
+}
 
-                        dai = dai->next;
-                    }
-                    xmlFree(sdi_name);
-                }
-            }
+static cid_node_e open_dotype(cid_reader_t *ctx)
+{
+    cid_template_t *template = &ctx->cid->cid_template;
+    cid_attr_t      attrs[]  = { { .name = "id" } };
 
-            child = child->next;
-        }
+    read_attrs(ctx->reader, attrs, 1);
+    if (!attrs[0].set || strlen(attrs[0].value) >= NEU_CID_ID_LEN) {
+        return CID_NODE_SKIP;
     }
-    return 0;
+
+    cid_tm_do_type_t *tm_do =
+        CID_APPEND(template->dotypes, template->n_dotypes);
+    strcpy(tm_do->id, attrs[0].value);
+    return CID_NODE_DOTYPE;
 }
 
-static int parse_template(xmlNode *xml_template, cid_template_t *template)
+static void add_sdo(cid_reader_t *ctx)
 {
-    template->lnotypes   = NULL;
-    template->n_lnotypes = 0;
-    template->dotypes    = NULL;
-    template->n_dotypes  = 0;
-    template->datypes    = NULL;
-    template->n_datypes  = 0;
-
-    xmlNode *child = xml_template->children;
-
-    while (child != NULL) {
-        if (child->type != XML_ELEMENT_NODE) {
-            child = child->next;
-            continue;
-        }
-        if (strcmp((const char *) child->name, "LNodeType") == 0) {
-            char *id = (char *) xmlGetProp(child, (const xmlChar *) "id");
-            char *ln_class =
-                (char *) xmlGetProp(child, (const xmlChar *) "lnClass");
-            if (id != NULL && ln_class != NULL) {
-                template->n_lnotypes += 1;
-                template->lnotypes =
-                    realloc(template->lnotypes,
-                            template->n_lnotypes * sizeof(cid_tm_lno_type_t));
-                cid_tm_lno_type_t *tm_lno =
-                    &template->lnotypes[template->n_lnotypes - 1];
-                memset(tm_lno, 0, sizeof(cid_tm_lno_type_t));
-
-                strcpy(tm_lno->id, id);
-                strcpy(tm_lno->ln_class, ln_class);
-
-                xmlNode *xdo = child->children;
-                while (xdo != NULL) {
-                    if (xdo->type != XML_ELEMENT_NODE) {
-                        xdo = xdo->next;
-                        continue;
-                    }
-                    char *name =
-                        (char *) xmlGetProp(xdo, (const xmlChar *) "name");
-                    char *ref_type =
-                        (char *) xmlGetProp(xdo, (const xmlChar *) "type");
-
-                    if (name != NULL && ref_type != NULL) {
-                        tm_lno->n_dos += 1;
-                        tm_lno->dos =
-                            realloc(tm_lno->dos,
-                                    tm_lno->n_dos * sizeof(cid_tm_lno_do_t));
-                        cid_tm_lno_do_t *tm_do =
-                            &tm_lno->dos[tm_lno->n_dos - 1];
-                        memset(tm_do, 0, sizeof(cid_tm_lno_do_t));
-
-                        strcpy(tm_do->name, name);
-                        strcpy(tm_do->ref_type, ref_type);
-                    }
+    cid_template_t *  template = &ctx->cid->cid_template;
+    cid_tm_do_type_t *tm_do    = &template->dotypes[template->n_dotypes - 1];
+    cid_attr_t        attrs[]  = { { .name = "name" }, { .name = "type" } };
 
-                    if (name != NULL) {
-                        xmlFree(name);
-                    }
-                    if (ref_type != NULL) {
-                        xmlFree(ref_type);
-                    }
+    read_attrs(ctx->reader, attrs, 2);
+    if (!attrs[0].set || !attrs[1].set) {
+        return;
+    }
 
-                    xdo = xdo->next;
-                }
-            }
+    cid_tm_sdo_t *tm_sdo = CID_APPEND(tm_do->sdos, tm_do->n_sdos);
+    cid_copy(tm_sdo->name, sizeof(tm_sdo->name), attrs[0].value);
+    cid_copy(tm_sdo->ref_type, sizeof(tm_sdo->ref_type), attrs[1].value);
+}
 
-            if (id != NULL) {
-                xmlFree(id);
-            }
-            if (ln_class != NULL) {
-                xmlFree(ln_class);
-            }
-        }
+static void add_da(cid_reader_t *ctx)
+{
+    cid_template_t *  template = &ctx->cid->cid_template;
+    cid_tm_do_type_t *tm_do    = &template->dotypes[template->n_dotypes - 1];
+    cid_attr_t        attrs[]  = {
+        { .name = "bType" },
+        { .name = "fc" },
+        { .name = "name" },
+        { .name = "type" },
+    };
 
-        if (strcmp((const char *) child->name, "DOType") == 0) {
-            char *id = (char *) xmlGetProp(child, (const xmlChar *) "id");
-            if (id != NULL && strlen(id) < NEU_CID_ID_LEN) {
-                template->n_dotypes += 1;
-                template->dotypes =
-                    realloc(template->dotypes,
-                            template->n_dotypes * sizeof(cid_tm_do_type_t));
-                cid_tm_do_type_t *tm_do =
-                    &template->dotypes[template->n_dotypes - 1];
-                memset(tm_do, 0, sizeof(cid_tm_do_type_t));
-
-                strcpy(tm_do->id, id);
-                xmlNode *da = child->children;
-                while (da != NULL) {
-                    if (da->type != XML_ELEMENT_NODE) {
-                        da = da->next;
-                        continue;
-                    }
+    read_attrs(ctx->reader, attrs, 4);
+    if (!attrs[0].set || !attrs[1].set || !attrs[2].set) {
+        return;
+    }
 
-                    if (strcmp((const char *) da->name, "SDO") == 0) {
-                        char *sdo_name =
-                            (char *) xmlGetProp(da, (const xmlChar *) "name");
-                        char *sdo_ref_type =
-                            (char *) xmlGetProp(da, (const xmlChar *) "type");
-                        if (sdo_name != NULL && sdo_ref_type != NULL) {
-                            tm_do->n_sdos += 1;
-                            tm_do->sdos =
-                                realloc(tm_do->sdos,
-                                        tm_do->n_sdos * sizeof(cid_tm_sdo_t));
-                            cid_tm_sdo_t *tm_sdo =
-                                &tm_do->sdos[tm_do->n_sdos - 1];
-                            memset(tm_sdo, 0, sizeof(cid_tm_sdo_t));
-
-                            strcpy(tm_sdo->name, sdo_name);
-                            strcpy(tm_sdo->ref_type, sdo_ref_type);
-                        }
+    cid_tm_do_da_t *tm_da = CID_APPEND(tm_do->das, tm_do->n_das);
+    cid_copy(tm_da->name, sizeof(tm_da->name), attrs[2].value);
+    cid_copy(tm_da->ref_type, sizeof(tm_da->ref_type), attrs[3].value);
+    tm_da->btype = decode_basictype(attrs[0].value);
+    tm_da->fc    = decode_fc(attrs[1].value);
+    if (tm_da->btype == T_UNKNOWN) {
+        nlog_warn("Unknown btype %s, %d", attrs[0].value, reader_line(ctx));
+    }
+    if (tm_da->fc == F_UNKNOWN) {
+        nlog_warn("Unknown fc %s, %d", attrs[1].value, reader_line(ctx));
+    }
+}
 
-                        if (sdo_name != NULL) {
-                            xmlFree(sdo_name);
-                        }
-                        if (sdo_ref_type != NULL) {
-                            xmlFree(sdo_ref_type);
-                        }
-                    }
+static cid_node_e open_datype(cid_reader_t *ctx)
+{
+    cid_template_t *template = &ctx->cid->cid_template;
+    cid_attr_t      attrs[]  = { { .name = "id" } };
 
-                    if (strcmp((const char *) da->name, "DA") == 0) {
-                        char *btype =
-                            (char *) xmlGetProp(da, (const xmlChar *) "bType");
-                        char *fc =
-                            (char *) xmlGetProp(da, (const xmlChar *) "fc");
-                        char *name =
-                            (char *) xmlGetProp(da, (const xmlChar *) "name");
-                        char *ref_type =
-                            (char *) xmlGetProp(da, (const xmlChar *) "type");
-
-                        if (btype != NULL && fc != NULL && name != NULL) {
-                            tm_do->n_das += 1;
-                            tm_do->das =
-                                realloc(tm_do->das,
-                                        tm_do->n_das * sizeof(cid_tm_do_da_t));
-                            cid_tm_do_da_t *tm_da =
-                                &tm_do->das[tm_do->n_das - 1];
-                            memset(tm_da, 0, sizeof(cid_tm_do_da_t));
-
-                            strcpy(tm_da->name, name);
-                            if (ref_type != NULL) {
-                                strcpy(tm_da->ref_type, ref_type);
-                            }
-                            tm_da->btype = T_UNKNOWN;
-                            tm_da->btype =
-                                decode_basictype((const char *) btype);
-                            tm_da->fc = F_UNKNOWN;
-                            tm_da->fc = decode_fc((const char *) fc);
-                            if (tm_da->btype == T_UNKNOWN) {
-                                nlog_warn("Unknown btype %s, %d", btype,
-                                          (int) da->line);
-                            }
-                            if (tm_da->fc == F_UNKNOWN) {
-                                nlog_warn("Unknown fc %s, %d", fc,
-                                          (int) da->line);
-                            }
-                        }
+    read_attrs(ctx->reader, attrs, 1);
+    if (!attrs[0].set || strlen(attrs[0].value) >= NEU_CID_ID_LEN) {
+        nlog_warn("skip, DAType id is null or too long %d", reader_line(ctx));
+        return CID_NODE_SKIP;
+    }
 
-                        if (btype != NULL) {
-                            xmlFree(btype);
-                        }
-                        if (fc != NULL) {
-                            xmlFree(fc);
-                        }
-                        if (name != NULL) {
-                            xmlFree(name);
-                        }
-                        if (ref_type != NULL) {
-                            xmlFree(ref_type);
-                        }
-                    }
+    cid_tm_da_type_t *tm_dat =
+        CID_APPEND(template->datypes, template->n_datypes);
+    strcpy(tm_dat->id, attrs[0].value);
+    return CID_NODE_DATYPE;
+}
 
-                    da = da->next;
-                }
-            }
+static void add_bda(cid_reader_t *ctx)
+{
+    cid_template_t *  template = &ctx->cid->cid_template;
+    cid_tm_da_type_t *tm_dat   = &template->datypes[template->n_datypes - 1];
+    cid_attr_t        attrs[]  = {
+        { .name = "bType" },
+        { .name = "name" },
+        { .name = "type" },
+    };
 
-            if (id != NULL) {
-                xmlFree(id);
-            }
+    read_attrs(ctx->reader, attrs, 3);
+    if (!attrs[0].set || !attrs[1].set) {
+        return;
+    }
+
+    cid_tm_bda_type_t *tm_bda = CID_APPEND(tm_dat->bdas, tm_dat->n_bdas);
+    cid_copy(tm_bda->name, sizeof(tm_bda->name), attrs[1].value);
+    cid_copy(tm_bda->ref_type, sizeof(tm_bda->ref_type), attrs[2].value);
+    tm_bda->btype = decode_basictype(attrs[0].value);
+    if (tm_bda->btype == T_UNKNOWN) {
+        nlog_warn("Unknown btype %s, %d", attrs[0].value, reader_line(ctx));
+    }
+}
+
+/**
+ * @brief 处理父元素类别为 parent 的元素 name。
+ *
+ * @return 需要继续读取子元素时返回该元素的类别，否则返回 CID_NODE_SKIP，
+ *         由调用者跳过整棵子树。
+ */
+static cid_node_e open_element(cid_reader_t *ctx, cid_node_e parent,
+                               const char *name)
+{
+    switch (parent) {
+    case CID_NODE_SCL:
+        if (strcmp(name, "IED") == 0) {
+            return open_ied(ctx);
         }
+        if (strcmp(name, "DataTypeTemplates") == 0) {
+            ctx->templates_parsed = true;
+            return CID_NODE_TEMPLATE;
+        }
+        break;
+    case CID_NODE_IED:
+        if (strcmp(name, "AccessPoint") == 0) {
+            return open_access_point(ctx);
+        }
+        break;
+    case CID_NODE_ACCESS_POINT:
+        if (strcmp(name, "Server") == 0) {
+            return open_server(ctx);
+        }
+        break;
+    case CID_NODE_SERVER:
+        if (strcmp(name, "LDevice") == 0) {
+            return open_ldevice(ctx);
+        }
+        break;
+    case CID_NODE_LDEVICE:
+        // LN0 与 LN
+        if (strncmp(name, "LN", 2) == 0) {
+            return open_ln(ctx);
+        }
+        break;
+    case CID_NODE_LN:
+        if (strcmp(name, "DataSet") == 0) {
+            return open_dataset(ctx);
+        }
+        if (strcmp(name, "ReportControl") == 0) {
+            add_report(ctx);
+        } else if (strcmp(name, "DOI") == 0) {
+            return open_doi(ctx);
+        }
+        break;
+    case CID_NODE_DATASET:
+        if (strcmp(name, "FCDA") == 0) {
+            add_fcda(ctx);
+        }
+        break;
+    case CID_NODE_DOI:
+        if (strcmp(name, "DAI") == 0) {
+            add_dai(ctx, NULL);
+        } else if (strcmp(name, "SDI") == 0) {
+            return open_sdi(ctx);
+        }
+        break;
+    case CID_NODE_SDI:
+        if (strcmp(name, "DAI") == 0) {
+            add_dai(ctx, ctx->sdi_name);
+        }
+        break;
+    case CID_NODE_TEMPLATE:
+        if (strcmp(name, "LNodeType") == 0) {
+            return open_lnotype(ctx);
+        }
+        if (strcmp(name, "DOType") == 0) {
+            return open_dotype(ctx);
+        }
+        if (strcmp(name, "DAType") == 0) {
+            return open_datype(ctx);
+        }
+        break;
+    case CID_NODE_LNOTYPE:
+        add_lno_do(ctx);
+        break;
+    case CID_NODE_DOTYPE:
+        if (strcmp(name, "SDO") == 0) {
+            add_sdo(ctx);
+        } else if (strcmp(name, "DA") == 0) {
+            add_da(ctx);
+        }
+        break;
+    case CID_NODE_DATYPE:
+        add_bda(ctx);
+        break;
+    default:
+        break;
+    }
 
-        if (strcmp((const char *) child->name, "DAType") == 0) {
-            char *id = (char *) xmlGetProp(child, (const xmlChar *) "id");
-            if (id != NULL && strlen(id) < NEU_CID_ID_LEN) {
-                template->n_datypes += 1;
-                template->datypes =
-                    realloc(template->datypes,
-                            template->n_datypes * sizeof(cid_tm_da_type_t));
-                cid_tm_da_type_t *tm_dat =
-                    &template->datypes[template->n_datypes - 1];
-                memset(tm_dat, 0, sizeof(cid_tm_da_type_t));
-
-                strcpy(tm_dat->id, id);
-                xmlNode *bda = child->children;
-                while (bda != NULL) {
-                    if (bda->type != XML_ELEMENT_NODE) {
-                        bda = bda->next;
-                        continue;
-                    }
-                    char *btype =
-                        (char *) xmlGetProp(bda, (const xmlChar *) "bType");
-                    char *name =
-                        (char *) xmlGetProp(bda, (const xmlChar *) "name");
-                    char *ref_type =
-                        (char *) xmlGetProp(bda, (const xmlChar *) "type");
-
-                    if (btype != NULL && name != NULL) {
-                        tm_dat->n_bdas += 1;
-                        tm_dat->bdas =
-                            realloc(tm_dat->bdas,
-                                    tm_dat->n_bdas * sizeof(cid_tm_bda_type_t));
-                        cid_tm_bda_type_t *tm_bda =
-                            &tm_dat->bdas[tm_dat->n_bdas - 1];
-                        memset(tm_bda, 0, sizeof(cid_tm_bda_type_t));
-                        strcpy(tm_bda->name, name);
-                        if (ref_type != NULL) {
-                            strcpy(tm_bda->ref_type, ref_type);
-                        }
-                        tm_bda->btype = T_UNKNOWN;
-                        tm_bda->btype = decode_basictype((const char *) btype);
-                        if (tm_bda->btype == T_UNKNOWN) {
-                            nlog_warn("Unknown btype %s, %d", btype,
-                                      (int) bda->line);
-                        }
-                    }
+    return CID_NODE_SKIP;
+}
 
-                    if (btype != NULL) {
-                        xmlFree(btype);
-                    }
-                    if (name != NULL) {
-                        xmlFree(name);
-                    }
-                    if (ref_type != NULL) {
-                        xmlFree(ref_type);
-                    }
+/**
+ * @brief 用 xmlTextReader 顺序读取 SCL 文件，不建立 DOM。
+ *
+ * 读到的元素直接写入 cid_t 中对应数组的末尾，不需要的子树（Communication、
+ * Private、Val 等）整体跳过，内存占用只与解析结果有关。
+ */
+static int read_scl(cid_reader_t *ctx)
+{
+    xmlTextReaderPtr reader = ctx->reader;
+    int              ret    = xmlTextReaderRead(reader);
 
-                    bda = bda->next;
-                }
-            } else {
-                nlog_warn("skip, DAType id is null or too long %d",
-                          (int) child->line);
-            }
-            if (id != NULL) {
-                xmlFree(id);
+    while (ret == 1) {
+        if (xmlTextReaderNodeType(reader) != XML_READER_TYPE_ELEMENT) {
+            ret = xmlTextReaderRead(reader);
+            continue;
+        }
+
+        int         depth = xmlTextReaderDepth(reader);
+        const char *name  = (const char *) xmlTextReaderConstLocalName(reader);
+        cid_node_e  node  = CID_NODE_SKIP;
+
+        if (depth == 0) {
+            if (strcmp(name, "SCL") != 0) {
+                nlog_warn("Failed to get root element(SCL)");
+                return -1;
             }
+            node = CID_NODE_SCL;
+        } else if (depth < CID_MAX_DEPTH) {
+            node = open_element(ctx, ctx->stack[depth - 1], name);
         }
 
-        child = child->next;
+        if (node == CID_NODE_SKIP || xmlTextReaderIsEmptyElement(reader) == 1) {
+            ret = xmlTextReaderNext(reader);
+        } else {
+            ctx->stack[depth] = node;
+            ret               = xmlTextReaderRead(reader);
+        }
     }
 
-    return 0;
+    return ret == 0 ? 0 : -1;
 }
 
 char *neu_cid_info_to_string(cid_dataset_info_t *info)
@@ -1246,10 +1272,7 @@ static void ld_ctrl_do_to_group(const char *ied_name, const char *ap_name,
         return;
     }
 
-    cmd->n_group += 1;
-    cmd->groups = realloc(cmd->groups, cmd->n_group * sizeof(neu_gdatatag_t));
-    neu_gdatatag_t *group = &cmd->groups[cmd->n_group - 1];
-    memset(group, 0, sizeof(neu_gdatatag_t));
+    neu_gdatatag_t *group = CID_APPEND(cmd->groups, cmd->n_group);
 
     cid_dataset_info_t *g_info = calloc(1, sizeof(cid_dataset_info_t));
 
@@ -1280,11 +1303,7 @@ static void ld_ctrl_do_to_group(const char *ied_name, const char *ap_name,
                                        "%s", ld->lns[i].lninst);
                 }
 
-                group->n_tag += 1;
-                group->tags =
-                    realloc(group->tags, group->n_tag * sizeof(neu_datatag_t));
-                neu_datatag_t *tag = &group->tags[group->n_tag - 1];
-                memset(tag, 0, sizeof(neu_datatag_t));
+                neu_datatag_t *tag = CID_APPEND(group->tags, group->n_tag);
 
                 tag->name = calloc(1, NEU_TAG_NAME_LEN);
                 snprintf(tag->name, NEU_TAG_NAME_LEN, "%s$%s$%s", ln_name,
@@ -1408,11 +1427,7 @@ static void ln_dataset_to_group(const char *ied_name, const char *ap_name,
                     break;
                 }
 
-                cmd->n_group += 1;
-                cmd->groups =
-                    realloc(cmd->groups, cmd->n_group * sizeof(neu_gdatatag_t));
-                neu_gdatatag_t *group = &cmd->groups[cmd->n_group - 1];
-                memset(group, 0, sizeof(neu_gdatatag_t));
+                neu_gdatatag_t *group = CID_APPEND(cmd->groups, cmd->n_group);
 
                 cid_dataset_info_t *g_info =
                     calloc(1, sizeof(cid_dataset_info_t));
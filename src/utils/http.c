@@ -19,14 +19,19 @@
 
 #include <assert.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <inttypes.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include <nng/nng.h>
 #include <nng/supplemental/http/http.h>
+#include <zlib.h>
 
 #include "define.h"
 #include "errcodes.h"
@@ -274,6 +279,9 @@ int neu_http_response(nng_aio *aio, neu_err_code_e code, char *content)
     case NEU_ERR_IS_BUSY:
         status = NNG_HTTP_STATUS_INTERNAL_SERVER_ERROR;
         break;
+    case NEU_ERR_PLUGIN_DEVICE_NOT_RESPONSE:
+        status = NNG_HTTP_STATUS_GATEWAY_TIMEOUT;
+        break;
     case NEU_ERR_EXPIRED_TOKEN:
     case NEU_ERR_VALIDATE_TOKEN:
     case NEU_ERR_INVALID_TOKEN:
@@ -326,6 +334,7 @@ int neu_http_response(nng_aio *aio, neu_err_code_e code, char *content)
     case NEU_ERR_PLUGIN_TAG_TYPE_MISMATCH:
     case NEU_ERR_PLUGIN_TAG_VALUE_OUT_OF_RANGE:
     case NEU_ERR_TAG_BIAS_INVALID:
+    case NEU_ERR_TAG_DEADBAND_INVALID:
     case NEU_ERR_GROUP_MAX_GROUPS:
     case NEU_ERR_LICENSE_MAX_TAGS:
     case NEU_ERR_LICENSE_BAD_CLOCK:
@@ -423,6 +432,363 @@ int neu_http_internal_error(nng_aio *aio, char *content)
     return response(aio, content, NNG_HTTP_STATUS_INTERNAL_SERVER_ERROR);
 }
 
+int neu_http_parse_range(const char *range, uint64_t size, uint64_t *start,
+                         uint64_t *end)
+{
+    const char *spec = NULL;
+    char *      p    = NULL;
+
+    if (range == NULL || strncasecmp(range, "bytes=", 6) != 0 ||
+        strchr(range, ',') != NULL) {
+        return 1;
+    }
+
+    spec = range + 6;
+    while (*spec == ' ') {
+        spec++;
+    }
+
+    if (*spec == '-') {
+        // bytes=-N, the last N bytes
+        uint64_t n = strtoull(spec + 1, &p, 10);
+        if (p == spec + 1 || *p != '\0') {
+            return 1;
+        }
+        if (n == 0 || size == 0) {
+            return -1;
+        }
+        *start = n < size ? size - n : 0;
+        *end   = size - 1;
+        return 0;
+    }
+
+    if (*spec < '0' || *spec > '9') {
+        return 1;
+    }
+
+    *start = strtoull(spec, &p, 10);
+    if (*p != '-') {
+        return 1;
+    }
+
+    if (*(p + 1) == '\0') {
+        *end = size - 1;
+    } else {
+        const char *last = p + 1;
+        *end             = strtoull(last, &p, 10);
+        if (p == last || *p != '\0' || *end < *start) {
+            return 1;
+        }
+        if (*end >= size) {
+            *end = size - 1;
+        }
+    }
+
+    return *start < size ? 0 : -1;
+}
+
+// 每次读取与发送的块大小，决定了一个下载占用的内存
+#define STREAM_CHUNK_SIZE (64 * 1024)
+// chunked 编码的块头固定为 6 位十六进制长度，块尾可能带上结束块
+#define STREAM_CHUNK_HEAD 8
+#define STREAM_CHUNK_TAIL (sizeof("\r\n0\r\n\r\n") - 1)
+
+typedef struct {
+    nng_http_conn *conn;
+    nng_aio *      aio;
+    int            fd;
+    uint64_t       offset; // 下次读取的文件偏移
+    uint64_t       remain; // 还未读取的字节数
+    bool           gzip;
+    bool           last; // 缓冲区中是最后一段数据
+    z_stream       zs;
+
+    uint8_t  in[STREAM_CHUNK_SIZE];
+    uint8_t  out[STREAM_CHUNK_HEAD + STREAM_CHUNK_SIZE + STREAM_CHUNK_TAIL];
+    uint8_t *pending; // out 中尚未写出的数据
+    size_t   n_pending;
+} http_stream_t;
+
+static void stream_free(http_stream_t *s)
+{
+    if (s->gzip) {
+        deflateEnd(&s->zs);
+    }
+    if (s->conn != NULL) {
+        nng_http_conn_close(s->conn);
+    }
+    if (s->aio != NULL) {
+        nng_aio_reap(s->aio);
+    }
+    close(s->fd);
+    free(s);
+}
+
+static ssize_t stream_read(http_stream_t *s, uint8_t *buf, size_t size)
+{
+    size_t  n  = s->remain < size ? s->remain : size;
+    ssize_t rv = 0;
+
+    do {
+        rv = pread(s->fd, buf, n, s->offset);
+    } while (rv < 0 && errno == EINTR);
+
+    if (rv <= 0) {
+        // 文件在发送过程中被截断
+        return -1;
+    }
+
+    s->offset += rv;
+    s->remain -= rv;
+    return rv;
+}
+
+// 读取下一段数据到 s->out，返回 -1 表示读取失败
+static int stream_fill_plain(http_stream_t *s)
+{
+    ssize_t n = stream_read(s, s->out, STREAM_CHUNK_SIZE);
+
+    if (n < 0) {
+        return -1;
+    }
+
+    s->pending   = s->out;
+    s->n_pending = n;
+    s->last      = s->remain == 0;
+    return 0;
+}
+
+// 压缩出下一个非空的块到 s->out，返回 -1 表示读取或压缩失败
+static int stream_fill_gzip(http_stream_t *s)
+{
+    uint8_t *data = s->out + STREAM_CHUNK_HEAD;
+    int      rv   = Z_OK;
+
+    s->zs.next_out  = data;
+    s->zs.avail_out = STREAM_CHUNK_SIZE;
+
+    while (s->zs.avail_out > 0) {
+        if (s->zs.avail_in == 0 && s->remain > 0) {
+            ssize_t n = stream_read(s, s->in, sizeof(s->in));
+            if (n < 0) {
+                return -1;
+            }
+            s->zs.next_in  = s->in;
+            s->zs.avail_in = n;
+        }
+
+        int flush = s->remain == 0 ? Z_FINISH : Z_NO_FLUSH;
+        rv        = deflate(&s->zs, flush);
+        if (rv == Z_STREAM_END) {
+            break;
+        }
+        if (rv != Z_OK && rv != Z_BUF_ERROR) {
+            return -1;
+        }
+    }
+
+    size_t n = STREAM_CHUNK_SIZE - s->zs.avail_out;
+    size_t len = 0;
+
+    s->last = rv == Z_STREAM_END;
+    if (n == 0) {
+        // 压缩流恰好在上一块结束，只剩结束块
+        memcpy(s->out, "0\r\n\r\n", 5);
+        s->pending   = s->out;
+        s->n_pending = 5;
+        return 0;
+    }
+
+    char head[STREAM_CHUNK_HEAD + 1] = { 0 };
+    snprintf(head, sizeof(head), "%06zx\r\n", n);
+    memcpy(s->out, head, STREAM_CHUNK_HEAD);
+    len = STREAM_CHUNK_HEAD + n;
+
+    if (s->last) {
+        memcpy(s->out + len, "\r\n0\r\n\r\n", STREAM_CHUNK_TAIL);
+        len += STREAM_CHUNK_TAIL;
+    } else {
+        memcpy(s->out + len, "\r\n", 2);
+        len += 2;
+    }
+
+    s->pending   = s->out;
+    s->n_pending = len;
+    return 0;
+}
+
+static void stream_write(http_stream_t *s)
+{
+    nng_iov iov = {
+        .iov_buf = s->pending,
+        .iov_len = s->n_pending,
+    };
+
+    nng_aio_set_iov(s->aio, 1, &iov);
+    nng_http_conn_write(s->conn, s->aio);
+}
+
+static void stream_cb(void *arg)
+{
+    http_stream_t *s  = (http_stream_t *) arg;
+    int            rv = nng_aio_result(s->aio);
+
+    if (rv != 0) {
+        nlog_warn("http stream write fail: %s", nng_strerror(rv));
+        stream_free(s);
+        return;
+    }
+
+    size_t n = nng_aio_count(s->aio);
+    s->pending += n;
+    s->n_pending -= n;
+    if (s->n_pending > 0) {
+        stream_write(s);
+        return;
+    }
+
+    if (s->last) {
+        stream_free(s);
+        return;
+    }
+
+    rv = s->gzip ? stream_fill_gzip(s) : stream_fill_plain(s);
+    if (rv != 0) {
+        nlog_warn("http stream read fail");
+        stream_free(s);
+        return;
+    }
+
+    stream_write(s);
+}
+
+static bool accept_gzip(nng_http_req *req)
+{
+    const char *encoding = nng_http_req_get_header(req, "Accept-Encoding");
+    const char *version  = nng_http_req_get_version(req);
+
+    // HTTP/1.0 不支持 chunked 编码
+    return encoding != NULL && strstr(encoding, "gzip") != NULL &&
+        version != NULL && strcmp(version, "HTTP/1.0") != 0;
+}
+
+int neu_http_response_file_stream(nng_aio *aio, const char *path,
+                                  const char *content_type,
+                                  const char *disposition)
+{
+    nng_http_req * req    = nng_aio_get_input(aio, 0);
+    nng_http_conn *conn   = nng_aio_get_input(aio, 2);
+    http_stream_t *s      = NULL;
+    struct stat    st     = { 0 };
+    uint64_t       start  = 0;
+    uint64_t       end    = 0;
+    int            ranged = 1;
+    int            fd     = open(path, O_RDONLY | O_CLOEXEC);
+
+    if (fd < 0) {
+        return NEU_ERR_FILE_NOT_EXIST;
+    }
+
+    if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode)) {
+        close(fd);
+        return NEU_ERR_FILE_NOT_EXIST;
+    }
+
+    ranged = neu_http_parse_range(nng_http_req_get_header(req, "Range"),
+                                  st.st_size, &start, &end);
+    if (ranged < 0) {
+        nng_http_res *res           = NULL;
+        char          content[64]   = { 0 };
+
+        close(fd);
+        snprintf(content, sizeof(content), "bytes */%" PRIu64,
+                 (uint64_t) st.st_size);
+        nng_http_res_alloc(&res);
+        nng_http_res_set_header(res, "Content-Range", content);
+        nng_http_res_set_header(res, "Access-Control-Allow-Origin", "*");
+        nng_http_res_set_status(res, NNG_HTTP_STATUS_RANGE_NOT_SATISFIABLE);
+        nlog_notice("<%p> %s %s [%d]", aio, nng_http_req_get_method(req),
+                    nng_http_req_get_uri(req),
+                    NNG_HTTP_STATUS_RANGE_NOT_SATISFIABLE);
+        nng_aio_set_output(aio, 0, res);
+        nng_aio_finish(aio, 0);
+        return 0;
+    }
+
+    s = calloc(1, sizeof(http_stream_t));
+    if (s == NULL || nng_aio_alloc(&s->aio, stream_cb, s) != 0) {
+        free(s);
+        close(fd);
+        return NEU_ERR_EINTERNAL;
+    }
+
+    s->fd = fd;
+    if (ranged == 0) {
+        s->offset = start;
+        s->remain = end - start + 1;
+    } else {
+        s->remain = st.st_size;
+    }
+
+    // 分段请求按原始字节返回，不再压缩
+    if (ranged != 0 && accept_gzip(req)) {
+        // windowBits 加 16 输出 gzip 格式
+        if (deflateInit2(&s->zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED,
+                         MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY) == Z_OK) {
+            s->gzip = true;
+        }
+    }
+
+    int n = snprintf((char *) s->out, sizeof(s->out),
+                     "HTTP/1.1 %d %s\r\n"
+                     "Content-Type: %s\r\n"
+                     "Accept-Ranges: bytes\r\n"
+                     "Access-Control-Allow-Origin: *\r\n"
+                     "Connection: close\r\n",
+                     ranged == 0 ? 206 : 200,
+                     ranged == 0 ? "Partial Content" : "OK", content_type);
+    if (s->gzip) {
+        n += snprintf((char *) s->out + n, sizeof(s->out) - n,
+                      "Content-Encoding: gzip\r\n"
+                      "Transfer-Encoding: chunked\r\n");
+    } else {
+        n += snprintf((char *) s->out + n, sizeof(s->out) - n,
+                      "Content-Length: %" PRIu64 "\r\n", s->remain);
+    }
+    if (ranged == 0) {
+        n += snprintf((char *) s->out + n, sizeof(s->out) - n,
+                      "Content-Range: bytes %" PRIu64 "-%" PRIu64
+                      "/%" PRIu64 "\r\n",
+                      start, end, (uint64_t) st.st_size);
+    }
+    if (disposition != NULL) {
+        n += snprintf((char *) s->out + n, sizeof(s->out) - n,
+                      "Content-Disposition: %s\r\n", disposition);
+    }
+    n += snprintf((char *) s->out + n, sizeof(s->out) - n, "\r\n");
+
+    s->pending   = s->out;
+    s->n_pending = n;
+    // 空文件以非压缩方式发送时只有响应头
+    s->last = !s->gzip && s->remain == 0;
+
+    // 接管连接后由 stream_cb 逐块写出，写完关闭连接
+    if (nng_http_hijack(conn) != 0) {
+        s->conn = NULL;
+        stream_free(s);
+        return NEU_ERR_EINTERNAL;
+    }
+    s->conn = conn;
+
+    nlog_notice("<%p> %s %s [%d] stream %" PRIu64 " bytes%s", aio,
+                nng_http_req_get_method(req), nng_http_req_get_uri(req),
+                ranged == 0 ? 206 : 200, s->remain, s->gzip ? " gzip" : "");
+    nng_aio_finish(aio, 0);
+
+    stream_write(s);
+    return 0;
+}
+
 int neu_http_post_otel_trace(uint8_t *data, int len)
 {
     nng_url *        url    = NULL;
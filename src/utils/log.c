@@ -18,10 +18,17 @@
  **/
 
 #include <dirent.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdbool.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #include "define.h"
 #include "utils/log.h"
+#include "utils/time.h"
 #include "utils/utarray.h"
 #include "utils/utextend.h"
 
@@ -70,3 +77,483 @@ void remove_logs(const char *node)
         utarray_free(files);
     }
 }
+
+_Static_assert((NEU_LOG_RING_SIZE & (NEU_LOG_RING_SIZE - 1)) == 0,
+               "NEU_LOG_RING_SIZE must be a power of 2");
+
+#define LOG_ALIGN(n) (((n) + 7) & ~(size_t) 7)
+#define LOG_BUCKET_TIME_MASK ((UINT64_C(1) << 48) - 1)
+#define LOG_BUCKET_TOKEN_MAX 0xFFFF
+
+/**
+ * @brief 缓冲区中的一条记录，消息紧随其后；size 为 0 表示缓冲区末尾的填充。
+ */
+typedef struct {
+    uint32_t         size; // 含头部与消息，按 8 字节对齐
+    uint32_t         len;
+    uint32_t         suppressed;
+    int32_t          level;
+    long             line;
+    zlog_category_t *category;
+    const char *     file;
+    const char *     func;
+    uint32_t         file_len;
+    uint32_t         func_len;
+} log_record_t;
+
+/**
+ * @brief 线程日志缓冲区，所属线程写入、写线程读出的单生产者单消费者环。
+ *
+ * 记录连续存放，末尾放不下时跳到开头；剩余空间不足一个记录头时两端都直接
+ * 跳过，否则在原位置写一个 size 为 0 的填充头。
+ */
+typedef struct log_ring {
+    uint64_t head __attribute__((aligned(64))); // 写线程的读位置
+    uint64_t tail __attribute__((aligned(64))); // 所属线程的写位置
+    bool     orphan; // 所属线程已退出，读空后由写线程释放
+    struct log_ring *next;
+    char             buf[NEU_LOG_RING_SIZE] __attribute__((aligned(64)));
+} log_ring_t;
+
+static struct {
+    pthread_mutex_t mtx;
+    pthread_cond_t  cond;       // 写线程等待新记录、刷新或停止
+    pthread_cond_t  flush_cond; // 刷新完成
+    pthread_t       tid;
+    bool            running; // 写线程运行中，日志异步写出
+    bool            stop;
+    bool            sleeping; // 写线程即将或正在等待
+
+    log_ring_t *rings;
+
+    uint64_t flush_req;
+    uint64_t flush_done;
+
+    uint32_t rate;
+    uint32_t burst;
+
+    neu_log_stats_t stats;
+} g_log = {
+    .mtx        = PTHREAD_MUTEX_INITIALIZER,
+    .cond       = PTHREAD_COND_INITIALIZER,
+    .flush_cond = PTHREAD_COND_INITIALIZER,
+    .rate       = NEU_LOG_SITE_RATE,
+    .burst      = NEU_LOG_SITE_BURST,
+};
+
+static pthread_once_t         g_log_key_once = PTHREAD_ONCE_INIT;
+static pthread_key_t          g_log_key;
+static __thread log_ring_t *  t_ring = NULL;
+static __thread char          t_msg[NEU_LOG_RECORD_MAX];
+
+static void ring_release(void *arg)
+{
+    // 线程退出后如仍有日志，会重新分配缓冲区
+    t_ring = NULL;
+    __atomic_store_n(&((log_ring_t *) arg)->orphan, true, __ATOMIC_RELEASE);
+}
+
+static void log_key_create(void)
+{
+    pthread_key_create(&g_log_key, ring_release);
+}
+
+static log_ring_t *ring_get(void)
+{
+    log_ring_t *ring = t_ring;
+
+    if (NULL != ring) {
+        return ring;
+    }
+
+    if (0 != posix_memalign((void **) &ring, 64, sizeof(log_ring_t))) {
+        return NULL;
+    }
+    memset(ring, 0, offsetof(log_ring_t, buf));
+
+    pthread_once(&g_log_key_once, log_key_create);
+    pthread_setspecific(g_log_key, ring);
+
+    pthread_mutex_lock(&g_log.mtx);
+    ring->next = g_log.rings;
+    __atomic_store_n(&g_log.rings, ring, __ATOMIC_RELEASE);
+    __atomic_fetch_add(&g_log.stats.rings, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&g_log.mtx);
+
+    t_ring = ring;
+    return ring;
+}
+
+static bool ring_push(log_ring_t *ring, const log_record_t *rec,
+                      const char *msg)
+{
+    uint64_t tail = ring->tail;
+    uint64_t head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+    size_t   size = LOG_ALIGN(sizeof(log_record_t) + rec->len + 1);
+    size_t   off  = tail & (NEU_LOG_RING_SIZE - 1);
+    size_t   room = NEU_LOG_RING_SIZE - off;
+    size_t   need = room < size ? room + size : size;
+
+    if (NEU_LOG_RING_SIZE - (tail - head) < need) {
+        return false;
+    }
+
+    if (room < size) {
+        if (room >= sizeof(log_record_t)) {
+            ((log_record_t *) (ring->buf + off))->size = 0;
+        }
+        off = 0;
+    }
+
+    log_record_t *dst = (log_record_t *) (ring->buf + off);
+    *dst              = *rec;
+    dst->size         = size;
+    memcpy(dst + 1, msg, rec->len);
+    ((char *) (dst + 1))[rec->len] = '\0';
+
+    __atomic_store_n(&ring->tail, tail + need, __ATOMIC_RELEASE);
+    return true;
+}
+
+static bool ring_empty(log_ring_t *ring)
+{
+    return __atomic_load_n(&ring->head, __ATOMIC_RELAXED) ==
+        __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+}
+
+static void record_write(const log_record_t *rec)
+{
+    const char *msg = (const char *) (rec + 1);
+
+    if (rec->suppressed > 0) {
+        zlog(rec->category, rec->file, rec->file_len, rec->func,
+             rec->func_len, rec->line, rec->level,
+             "%s (%" PRIu32 " similar logs suppressed)", msg, rec->suppressed);
+    } else {
+        zlog(rec->category, rec->file, rec->file_len, rec->func,
+             rec->func_len, rec->line, rec->level, "%s", msg);
+    }
+}
+
+static uint64_t ring_drain(log_ring_t *ring)
+{
+    uint64_t head = ring->head;
+    uint64_t tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+    uint64_t n    = 0;
+
+    while (head != tail) {
+        size_t        off  = head & (NEU_LOG_RING_SIZE - 1);
+        size_t        room = NEU_LOG_RING_SIZE - off;
+        log_record_t *rec  = (log_record_t *) (ring->buf + off);
+
+        if (room < sizeof(log_record_t) || 0 == rec->size) {
+            head += room;
+            continue;
+        }
+
+        record_write(rec);
+        head += rec->size;
+        n += 1;
+
+        // 边写边归还空间，缓冲区接近写满时生产者不必等整批写完
+        __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+    }
+
+    __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+    return n;
+}
+
+static void ring_unlink(log_ring_t *ring)
+{
+    pthread_mutex_lock(&g_log.mtx);
+    for (log_ring_t **p = &g_log.rings; *p != NULL; p = &(*p)->next) {
+        if (*p == ring) {
+            *p = ring->next;
+            break;
+        }
+    }
+    __atomic_fetch_sub(&g_log.stats.rings, 1, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&g_log.mtx);
+
+    free(ring);
+}
+
+// 只由写线程调用，或在写线程退出后由 neu_log_stop 调用
+static uint64_t drain_all(void)
+{
+    uint64_t    n    = 0;
+    log_ring_t *next = NULL;
+
+    for (log_ring_t *ring = __atomic_load_n(&g_log.rings, __ATOMIC_ACQUIRE);
+         ring != NULL; ring = next) {
+        next = ring->next;
+        n += ring_drain(ring);
+
+        if (__atomic_load_n(&ring->orphan, __ATOMIC_ACQUIRE) &&
+            ring_empty(ring)) {
+            ring_unlink(ring);
+        }
+    }
+
+    __atomic_fetch_add(&g_log.stats.written, n, __ATOMIC_RELAXED);
+    return n;
+}
+
+static bool rings_pending(void)
+{
+    for (log_ring_t *ring = __atomic_load_n(&g_log.rings, __ATOMIC_ACQUIRE);
+         ring != NULL; ring = ring->next) {
+        if (!ring_empty(ring)) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void report_dropped(uint64_t *reported)
+{
+    uint64_t limited =
+        __atomic_load_n(&g_log.stats.rate_limited, __ATOMIC_RELAXED);
+    uint64_t full = __atomic_load_n(&g_log.stats.ring_full, __ATOMIC_RELAXED);
+
+    if (limited + full > *reported) {
+        *reported = limited + full;
+        zlog(neuron, __FILE__, sizeof(__FILE__) - 1, __func__,
+             sizeof(__func__) - 1, __LINE__, ZLOG_LEVEL_WARN,
+             "log dropped %" PRIu64 " records in total, rate limited: %" PRIu64
+             ", buffer full: %" PRIu64,
+             limited + full, limited, full);
+    }
+}
+
+static void *log_writer(void *arg)
+{
+    (void) arg;
+
+    uint64_t reported = 0;
+
+    while (true) {
+        uint64_t flush_req = __atomic_load_n(&g_log.flush_req, __ATOMIC_ACQUIRE);
+        bool     stop      = __atomic_load_n(&g_log.stop, __ATOMIC_ACQUIRE);
+
+        if (drain_all() > 0) {
+            continue;
+        }
+
+        // 一轮没有读到记录，刷新请求之前的记录都已写出
+        report_dropped(&reported);
+
+        pthread_mutex_lock(&g_log.mtx);
+        if (flush_req > g_log.flush_done) {
+            g_log.flush_done = flush_req;
+            pthread_cond_broadcast(&g_log.flush_cond);
+        }
+
+        if (stop) {
+            g_log.flush_done = g_log.flush_req;
+            pthread_cond_broadcast(&g_log.flush_cond);
+            pthread_mutex_unlock(&g_log.mtx);
+            break;
+        }
+
+        // 与 neu_log 中先发布记录、再读 sleeping 的顺序配对，避免漏掉唤醒
+        __atomic_store_n(&g_log.sleeping, true, __ATOMIC_SEQ_CST);
+        if (!rings_pending() && flush_req == g_log.flush_req && !g_log.stop) {
+            struct timespec ts = { 0 };
+            clock_gettime(CLOCK_REALTIME, &ts);
+            ts.tv_sec += 1;
+            pthread_cond_timedwait(&g_log.cond, &g_log.mtx, &ts);
+        }
+        __atomic_store_n(&g_log.sleeping, false, __ATOMIC_RELAXED);
+        pthread_mutex_unlock(&g_log.mtx);
+    }
+
+    return NULL;
+}
+
+static bool site_allow(neu_log_site_t *site)
+{
+    uint64_t rate  = __atomic_load_n(&g_log.rate, __ATOMIC_RELAXED);
+    uint64_t burst = __atomic_load_n(&g_log.burst, __ATOMIC_RELAXED);
+
+    if (0 == rate) {
+        return true;
+    }
+
+    uint64_t now  = (uint64_t) neu_time_mono_ns() / 1000000;
+    uint64_t old  = __atomic_load_n(&site->bucket, __ATOMIC_RELAXED);
+    uint64_t next = 0;
+
+    now &= LOG_BUCKET_TIME_MASK;
+
+    do {
+        uint64_t last    = old >> 16;
+        uint64_t tokens  = old & LOG_BUCKET_TOKEN_MAX;
+        uint64_t elapsed = (now - last) & LOG_BUCKET_TIME_MASK;
+        uint64_t refill  = elapsed >= burst * 1000 / rate + 1
+             ? burst
+             : elapsed * rate / 1000;
+
+        if (0 == old || tokens + refill >= burst) {
+            // 首次使用或已补满
+            tokens = burst;
+            last   = now;
+        } else if (refill > 0) {
+            // 只推进补充令牌所对应的时间，保留不足一个令牌的余量
+            tokens += refill;
+            last = (last + refill * 1000 / rate) & LOG_BUCKET_TIME_MASK;
+        }
+
+        if (0 == tokens) {
+            return false;
+        }
+
+        next = (last << 16) | (tokens - 1);
+    } while (!__atomic_compare_exchange_n(&site->bucket, &old, next, true,
+                                          __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+
+    return true;
+}
+
+void neu_log(neu_log_site_t *site, zlog_category_t *category, const char *file,
+             size_t file_len, const char *func, size_t func_len, long line,
+             int level, const char *format, ...)
+{
+    log_ring_t *ring = NULL;
+    int         len  = -1;
+    va_list     args;
+
+    if (!zlog_level_enabled(category, level)) {
+        return;
+    }
+
+    if (level < ZLOG_LEVEL_FATAL && !site_allow(site)) {
+        __atomic_fetch_add(&site->suppressed, 1, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&g_log.stats.rate_limited, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    va_start(args, format);
+    if (level < ZLOG_LEVEL_FATAL &&
+        __atomic_load_n(&g_log.running, __ATOMIC_ACQUIRE) &&
+        NULL != (ring = ring_get())) {
+        va_list copy;
+        va_copy(copy, args);
+        len = vsnprintf(t_msg, sizeof(t_msg), format, copy);
+        va_end(copy);
+    }
+
+    if (len < 0 || len >= (int) sizeof(t_msg)) {
+        __atomic_fetch_add(&g_log.stats.direct, 1, __ATOMIC_RELAXED);
+        vzlog(category, file, file_len, func, func_len, line, level, format,
+              args);
+        va_end(args);
+        return;
+    }
+    va_end(args);
+
+    log_record_t rec = {
+        .len        = len,
+        .suppressed = __atomic_exchange_n(&site->suppressed, 0, __ATOMIC_RELAXED),
+        .level      = level,
+        .line       = line,
+        .category   = category,
+        .file       = file,
+        .func       = func,
+        .file_len   = file_len,
+        .func_len   = func_len,
+    };
+
+    if (!ring_push(ring, &rec, t_msg)) {
+        __atomic_fetch_add(&site->suppressed, rec.suppressed, __ATOMIC_RELAXED);
+        __atomic_fetch_add(&g_log.stats.ring_full, 1, __ATOMIC_RELAXED);
+        return;
+    }
+
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+    if (__atomic_load_n(&g_log.sleeping, __ATOMIC_RELAXED)) {
+        pthread_mutex_lock(&g_log.mtx);
+        pthread_cond_signal(&g_log.cond);
+        pthread_mutex_unlock(&g_log.mtx);
+    }
+}
+
+int neu_log_start(void)
+{
+    int rv = 0;
+
+    pthread_mutex_lock(&g_log.mtx);
+    if (g_log.running) {
+        pthread_mutex_unlock(&g_log.mtx);
+        return -1;
+    }
+
+    __atomic_store_n(&g_log.stop, false, __ATOMIC_RELAXED);
+    if (0 != pthread_create(&g_log.tid, NULL, log_writer, NULL)) {
+        rv = -1;
+    } else {
+        __atomic_store_n(&g_log.running, true, __ATOMIC_RELEASE);
+    }
+    pthread_mutex_unlock(&g_log.mtx);
+
+    return rv;
+}
+
+void neu_log_stop(void)
+{
+    pthread_mutex_lock(&g_log.mtx);
+    if (!g_log.running) {
+        pthread_mutex_unlock(&g_log.mtx);
+        return;
+    }
+
+    // 此后的日志同步写出，写线程写完缓冲的记录后退出
+    __atomic_store_n(&g_log.running, false, __ATOMIC_RELEASE);
+    __atomic_store_n(&g_log.stop, true, __ATOMIC_RELEASE);
+    pthread_cond_signal(&g_log.cond);
+    pthread_mutex_unlock(&g_log.mtx);
+
+    pthread_join(g_log.tid, NULL);
+
+    // 停止前刚写入缓冲区的记录
+    drain_all();
+}
+
+void neu_log_flush(void)
+{
+    pthread_mutex_lock(&g_log.mtx);
+    if (g_log.running) {
+        uint64_t req = g_log.flush_req + 1;
+
+        __atomic_store_n(&g_log.flush_req, req, __ATOMIC_RELEASE);
+        pthread_cond_signal(&g_log.cond);
+        while (g_log.flush_done < req) {
+            pthread_cond_wait(&g_log.flush_cond, &g_log.mtx);
+        }
+    }
+    pthread_mutex_unlock(&g_log.mtx);
+}
+
+void neu_log_set_limit(uint32_t rate, uint32_t burst)
+{
+    if (burst > LOG_BUCKET_TOKEN_MAX) {
+        burst = LOG_BUCKET_TOKEN_MAX;
+    }
+    if (burst == 0) {
+        burst = 1;
+    }
+
+    __atomic_store_n(&g_log.burst, burst, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_log.rate, rate, __ATOMIC_RELAXED);
+}
+
+void neu_log_stats(neu_log_stats_t *stats)
+{
+    stats->written = __atomic_load_n(&g_log.stats.written, __ATOMIC_RELAXED);
+    stats->direct  = __atomic_load_n(&g_log.stats.direct, __ATOMIC_RELAXED);
+    stats->rate_limited =
+        __atomic_load_n(&g_log.stats.rate_limited, __ATOMIC_RELAXED);
+    stats->ring_full = __atomic_load_n(&g_log.stats.ring_full, __ATOMIC_RELAXED);
+    stats->rings     = __atomic_load_n(&g_log.stats.rings, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,318 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+/**
+ * 驱动缓存变化检测微基准：对每种类型，用确定性生成器按给定变化率和错误率
+ * 更新一组点位，统计 neu_driver_cache_update_change（含变化比较）和
+ * neu_driver_cache_meta_get_changed（订阅上报路径）的单点耗时，并校验缓存
+ * 判定的变化个数与生成器一致。
+ *
+ * 用法：cache_change_bench [options]，每种类型输出一行 JSON。
+ */
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <neuron.h>
+
+#include "adapter/driver/cache.h"
+#include "bench_plugin.h"
+
+zlog_category_t *neuron         = NULL;
+bool             sub_filter_err = false;
+
+struct bench_type {
+    const char *name;
+    neu_type_e  type;
+};
+
+static const struct bench_type bench_types[] = {
+    { "int16", NEU_TYPE_INT16 },        { "uint32", NEU_TYPE_UINT32 },
+    { "int64", NEU_TYPE_INT64 },        { "float", NEU_TYPE_FLOAT },
+    { "double", NEU_TYPE_DOUBLE },      { "bool", NEU_TYPE_BOOL },
+    { "bit", NEU_TYPE_BIT },            { "string", NEU_TYPE_STRING },
+    { "bytes", NEU_TYPE_BYTES },        { "int8s", NEU_TYPE_ARRAY_INT8 },
+    { "int16s", NEU_TYPE_ARRAY_INT16 }, { "int32s", NEU_TYPE_ARRAY_INT32 },
+    { "int64s", NEU_TYPE_ARRAY_INT64 }, { "floats", NEU_TYPE_ARRAY_FLOAT },
+    { "doubles", NEU_TYPE_ARRAY_DOUBLE }, { "bools", NEU_TYPE_ARRAY_BOOL },
+};
+
+struct bench_args {
+    int         tags;
+    int         cycles;
+    int         change_rate;
+    int         error_rate;
+    int         array_size;
+    int         string_length;
+    int         seed;
+    const char *types;
+};
+
+struct bench_result {
+    int64_t  update_ns;
+    int64_t  get_ns;
+    uint64_t generated;
+    uint64_t changed; // 生成器给出的变化个数
+    uint64_t errors;  // 生成器注入的错误个数
+    uint64_t reported;
+};
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -t, --tags <n>           tags in the cache, default 10000\n"
+            "  -n, --cycles <n>         update cycles, default 100\n"
+            "  -r, --change-rate <pct>  tags changed per cycle, default 10\n"
+            "  -e, --error-rate <pct>   tags reading an error per cycle, "
+            "default 0\n"
+            "  -A, --array-size <n>     array and bytes length, default 8\n"
+            "  -s, --string-length <n>  string length, default 16\n"
+            "  -F, --filter-err         enable sub_filter_err\n"
+            "  -S, --seed <n>           generator seed, default 1\n"
+            "  -T, --types <list>       comma separated types, default all of "
+            "int16,uint32,int64,float,double,bool,bit,string,bytes,int8s,"
+            "int16s,int32s,int64s,floats,doubles,bools\n",
+            prog);
+}
+
+static int parse_args(int argc, char *argv[], struct bench_args *args)
+{
+    static const struct option long_options[] = {
+        { "tags", required_argument, NULL, 't' },
+        { "cycles", required_argument, NULL, 'n' },
+        { "change-rate", required_argument, NULL, 'r' },
+        { "error-rate", required_argument, NULL, 'e' },
+        { "array-size", required_argument, NULL, 'A' },
+        { "string-length", required_argument, NULL, 's' },
+        { "filter-err", no_argument, NULL, 'F' },
+        { "seed", required_argument, NULL, 'S' },
+        { "types", required_argument, NULL, 'T' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+
+    *args = (struct bench_args){
+        .tags          = 10000,
+        .cycles        = 100,
+        .change_rate   = 10,
+        .error_rate    = 0,
+        .array_size    = 8,
+        .string_length = 16,
+        .seed          = 1,
+        .types         = NULL,
+    };
+
+    int c = 0;
+    while ((c = getopt_long(argc, argv, "t:n:r:e:A:s:FS:T:h", long_options,
+                            NULL)) != -1) {
+        switch (c) {
+        case 't':
+            args->tags = atoi(optarg);
+            break;
+        case 'n':
+            args->cycles = atoi(optarg);
+            break;
+        case 'r':
+            args->change_rate = atoi(optarg);
+            break;
+        case 'e':
+            args->error_rate = atoi(optarg);
+            break;
+        case 'A':
+            args->array_size = atoi(optarg);
+            break;
+        case 's':
+            args->string_length = atoi(optarg);
+            break;
+        case 'F':
+            sub_filter_err = true;
+            break;
+        case 'S':
+            args->seed = atoi(optarg);
+            break;
+        case 'T':
+            args->types = optarg;
+            break;
+        default:
+            return -1;
+        }
+    }
+
+    if (args->tags <= 0 || args->cycles <= 0 || args->change_rate < 0 ||
+        args->change_rate > 100 || args->error_rate < 0 ||
+        args->error_rate > 100 || args->array_size < 1 ||
+        args->array_size > BENCH_ARRAY_MAX || args->string_length < 0 ||
+        args->string_length >= NEU_VALUE_SIZE) {
+        return -1;
+    }
+
+    return 0;
+}
+
+static const struct bench_type *find_type(const char *name, size_t len)
+{
+    for (size_t i = 0; i < sizeof(bench_types) / sizeof(bench_types[0]); i++) {
+        if (strlen(bench_types[i].name) == len &&
+            strncmp(bench_types[i].name, name, len) == 0) {
+            return &bench_types[i];
+        }
+    }
+
+    return NULL;
+}
+
+static void run(const struct bench_args *args, neu_type_e type,
+                struct bench_result *result)
+{
+    neu_driver_cache_t *      cache    = neu_driver_cache_new();
+    uint32_t *                versions = calloc(args->tags, sizeof(uint32_t));
+    neu_dvalue_t *            values   = calloc(args->tags, sizeof(neu_dvalue_t));
+    neu_driver_cache_value_t *out = calloc(1, sizeof(neu_driver_cache_value_t));
+    neu_tag_meta_t            metas[NEU_TAG_META_SIZE] = { 0 };
+    bench_gen_t               gen                      = { 0 };
+    // 点位名在计时外生成一次，计时只包含缓存本身的开销
+    char(*names)[NEU_TAG_NAME_LEN] = calloc(args->tags, NEU_TAG_NAME_LEN);
+
+    bench_gen_init(&gen, args->seed);
+    gen.change_rate   = args->change_rate;
+    gen.error_rate    = args->error_rate;
+    gen.array_size    = args->array_size;
+    gen.string_length = args->string_length;
+
+    memset(result, 0, sizeof(*result));
+
+    for (int i = 0; i < args->tags; i++) {
+        snprintf(names[i], NEU_TAG_NAME_LEN, "tag-%d", i);
+        neu_driver_cache_add(cache, "group", names[i], values[i]);
+    }
+
+    // 第 0 轮为全部点位的首次写入，不计入结果
+    for (int cycle = 0; cycle <= args->cycles; cycle++) {
+        uint64_t changed = 0;
+        uint64_t errors  = 0;
+        uint64_t reported = 0;
+
+        for (int i = 0; i < args->tags; i++) {
+            if (bench_gen_next(&gen, type, i, &versions[i], &values[i])) {
+                changed += 1;
+            } else if (values[i].type == NEU_TYPE_ERROR) {
+                errors += 1;
+            }
+        }
+
+        int64_t start = neu_time_mono_ns();
+        for (int i = 0; i < args->tags; i++) {
+            neu_driver_cache_update_change(cache, "group", names[i], 0,
+                                           values[i], NULL, 0, false);
+        }
+        int64_t update_ns = neu_time_mono_ns() - start;
+
+        start = neu_time_mono_ns();
+        for (int i = 0; i < args->tags; i++) {
+            if (neu_driver_cache_meta_get_changed(cache, "group", names[i], out,
+                                                  metas,
+                                                  NEU_TAG_META_SIZE) == 0) {
+                reported += 1;
+            }
+        }
+        int64_t get_ns = neu_time_mono_ns() - start;
+
+        if (cycle > 0) {
+            result->update_ns += update_ns;
+            result->get_ns += get_ns;
+            result->generated += args->tags;
+            result->changed += changed;
+            result->errors += errors;
+            result->reported += reported;
+        }
+    }
+
+    neu_driver_cache_destroy(cache);
+    free(names);
+    free(out);
+    free(values);
+    free(versions);
+}
+
+int main(int argc, char *argv[])
+{
+    struct bench_args   args   = { 0 };
+    struct bench_result result = { 0 };
+    char                all[256] = { 0 };
+
+    if (parse_args(argc, argv, &args) != 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (args.types == NULL) {
+        for (size_t i = 0; i < sizeof(bench_types) / sizeof(bench_types[0]);
+             i++) {
+            strcat(all, i == 0 ? "" : ",");
+            strcat(all, bench_types[i].name);
+        }
+        args.types = all;
+    }
+
+    for (const char *p = args.types; *p != '\0';) {
+        size_t                   len = strcspn(p, ",");
+        const struct bench_type *bt  = find_type(p, len);
+
+        if (bt == NULL) {
+            fprintf(stderr, "invalid type: %.*s\n", (int) len, p);
+            return 1;
+        }
+
+        run(&args, bt->type, &result);
+
+        // 未开启错误过滤时，错误值与从错误恢复都会被判定为变化，
+        // 缓存判定的变化数不应少于生成器的变化数
+        if (!sub_filter_err && result.reported < result.changed) {
+            fprintf(stderr, "%s: cache reported %" PRIu64 " < %" PRIu64
+                            " changed\n",
+                    bt->name, result.reported, result.changed);
+            return 1;
+        }
+
+        printf("{\"bench\":\"cache_change\",\"type\":\"%s\",\"tags\":%d,"
+               "\"cycles\":%d,\"change_rate\":%d,\"error_rate\":%d,"
+               "\"array_size\":%d,\"filter_err\":%s,\"value_size\":%zu,"
+               "\"cvalue_size\":%zu,"
+               "\"changed\":%" PRIu64 ",\"errors\":%" PRIu64
+               ",\"reported\":%" PRIu64 ",\"update_ns_per_tag\":%.1f,"
+               "\"get_changed_ns_per_tag\":%.1f}\n",
+               bt->name, args.tags, args.cycles, args.change_rate,
+               args.error_rate, args.array_size,
+               sub_filter_err ? "true" : "false", sizeof(neu_dvalue_t),
+               sizeof(neu_cvalue_t),
+               result.changed, result.errors, result.reported,
+               (double) result.update_ns / result.generated,
+               (double) result.get_ns / result.generated);
+
+        p += len;
+        if (*p == ',') {
+            p++;
+        }
+    }
+
+    return 0;
+}
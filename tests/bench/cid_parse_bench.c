@@ -0,0 +1,546 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+/**
+ * SCL/CID 导入基准：生成一个指定大小的合成 SCL 文件，用 neu_cid_parse 解析
+ * 并用 neu_cid_to_msg 生成点位，输出耗时与进程内存峰值。
+ *
+ * 合成文件中每个 LDevice 含 LLN0、若干 MMXU、CSWI、GGIO 与 PTOC，数据集与
+ * 报告控制块放在 LLN0 下。LDevice 按 --types 轮流引用不同的一组类型模板，
+ * 模板数量随之增加，用来衡量类型查找的代价。
+ *
+ * 用法：cid_parse_bench [options]，输出一行 JSON。
+ */
+
+#include <errno.h>
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <neuron.h>
+
+#include "utils/cid.h"
+#include "utils/time.h"
+
+zlog_category_t *neuron = NULL;
+
+#define BENCH_MMXU 8
+#define BENCH_CSWI 4
+
+struct bench_args {
+    int         size_mb;
+    int         types;
+    const char *file;
+    bool        keep;
+};
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -s, --size <mb>     size of the generated file, default 100\n"
+            "  -t, --types <n>     template families, default 500\n"
+            "  -f, --file <path>   parse this file instead of generating one\n"
+            "  -k, --keep          keep the generated file\n",
+            prog);
+}
+
+static int parse_args(int argc, char *argv[], struct bench_args *args)
+{
+    static const struct option long_options[] = {
+        { "size", required_argument, NULL, 's' },
+        { "types", required_argument, NULL, 't' },
+        { "file", required_argument, NULL, 'f' },
+        { "keep", no_argument, NULL, 'k' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+
+    *args = (struct bench_args){
+        .size_mb = 100,
+        .types   = 500,
+        .file    = NULL,
+        .keep    = false,
+    };
+
+    int c = 0;
+    while ((c = getopt_long(argc, argv, "s:t:f:kh", long_options, NULL)) !=
+           -1) {
+        switch (c) {
+        case 's':
+            args->size_mb = atoi(optarg);
+            break;
+        case 't':
+            args->types = atoi(optarg);
+            break;
+        case 'f':
+            args->file = optarg;
+            break;
+        case 'k':
+            args->keep = true;
+            break;
+        default:
+            return -1;
+        }
+    }
+
+    if (args->size_mb <= 0 || args->types <= 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+static void gen_header(FILE *fp)
+{
+    fprintf(fp,
+            "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+            "<SCL xmlns=\"http://www.iec.ch/61850/2003/SCL\" "
+            "version=\"2007\" revision=\"B\">\n"
+            "  <Header id=\"bench\" version=\"1\" revision=\"1\"/>\n"
+            "  <Communication>\n"
+            "    <SubNetwork name=\"W1\" type=\"8-MMS\">\n"
+            "      <ConnectedAP iedName=\"BENCH\" apName=\"S1\">\n"
+            "        <Address>\n"
+            "          <P type=\"IP\">192.168.1.10</P>\n"
+            "          <P type=\"IP-SUBNET\">255.255.255.0</P>\n"
+            "        </Address>\n"
+            "      </ConnectedAP>\n"
+            "    </SubNetwork>\n"
+            "  </Communication>\n"
+            "  <IED name=\"BENCH\" manufacturer=\"neuron\" type=\"bench\">\n"
+            "    <Services>\n"
+            "      <DynAssociation/>\n"
+            "      <GetDirectory/>\n"
+            "      <ReportSettings cbName=\"Conf\" rptID=\"Dyn\"/>\n"
+            "    </Services>\n"
+            "    <AccessPoint name=\"S1\">\n"
+            "      <Server>\n"
+            "        <Authentication none=\"true\"/>\n");
+}
+
+static void gen_fcda(FILE *fp, int ld, const char *ln_class, int inst,
+                     const char *do_name, const char *da_name, const char *fc)
+{
+    fprintf(fp,
+            "            <FCDA ldInst=\"LD%d\" prefix=\"\" lnClass=\"%s\" "
+            "lnInst=\"%d\" doName=\"%s\"",
+            ld, ln_class, inst, do_name);
+    if (da_name != NULL) {
+        fprintf(fp, " daName=\"%s\"", da_name);
+    }
+    fprintf(fp, " fc=\"%s\"/>\n", fc);
+}
+
+static void gen_report(FILE *fp, int ld, const char *name,
+                       const char *dataset, bool buffered)
+{
+    fprintf(fp,
+            "          <ReportControl name=\"%s\" rptID=\"LD%d/LLN0$%s\" "
+            "datSet=\"%s\" intgPd=\"5000\" buffered=\"%s\" confRev=\"1\">\n"
+            "            <TrgOps dchg=\"true\" qchg=\"true\" "
+            "period=\"true\"/>\n"
+            "            <OptFields seqNum=\"true\" timeStamp=\"true\" "
+            "dataSet=\"true\" reasonCode=\"true\"/>\n"
+            "            <RptEnabled max=\"4\"/>\n"
+            "          </ReportControl>\n",
+            name, ld, name, dataset, buffered ? "true" : "false");
+}
+
+static void gen_ldevice(FILE *fp, int ld, int family)
+{
+    fprintf(fp,
+            "        <LDevice inst=\"LD%d\">\n"
+            "          <LN0 lnClass=\"LLN0\" lnType=\"LLN0_%d\" inst=\"\">\n"
+            "          <DataSet name=\"dsMeas\">\n",
+            ld, family);
+    for (int i = 1; i <= BENCH_MMXU; i++) {
+        gen_fcda(fp, ld, "MMXU", i, "TotW", "mag.f", "MX");
+        gen_fcda(fp, ld, "MMXU", i, "Hz", NULL, "MX");
+        gen_fcda(fp, ld, "MMXU", i, "PhV.phsA", "cVal.mag.f", "MX");
+        gen_fcda(fp, ld, "MMXU", i, "PhV.phsB", NULL, "MX");
+    }
+    fprintf(fp,
+            "          </DataSet>\n"
+            "          <DataSet name=\"dsStatus\">\n");
+    for (int i = 1; i <= BENCH_CSWI; i++) {
+        gen_fcda(fp, ld, "CSWI", i, "Pos", "stVal", "ST");
+        gen_fcda(fp, ld, "CSWI", i, "Pos", NULL, "ST");
+    }
+    for (int i = 1; i <= 4; i++) {
+        char do_name[16] = { 0 };
+        snprintf(do_name, sizeof(do_name), "Ind%d", i);
+        gen_fcda(fp, ld, "GGIO", 1, do_name, "stVal", "ST");
+    }
+    fprintf(fp, "          </DataSet>\n");
+    gen_report(fp, ld, "brcbMeas", "dsMeas", true);
+    gen_report(fp, ld, "urcbStatus", "dsStatus", false);
+    fprintf(fp,
+            "          <DOI name=\"Mod\">\n"
+            "            <DAI name=\"ctlModel\"><Val>status-only</Val></DAI>\n"
+            "          </DOI>\n"
+            "          <DOI name=\"NamPlt\">\n"
+            "            <DAI name=\"vendor\"><Val>neuron</Val></DAI>\n"
+            "            <DAI name=\"swRev\"><Val>1.0</Val></DAI>\n"
+            "          </DOI>\n"
+            "          </LN0>\n");
+
+    for (int i = 1; i <= BENCH_MMXU; i++) {
+        fprintf(fp,
+                "          <LN lnClass=\"MMXU\" inst=\"%d\" "
+                "lnType=\"MMXU_%d\" prefix=\"\">\n"
+                "            <DOI name=\"TotW\">\n"
+                "              <DAI name=\"dU\"><Val>Total power</Val></DAI>\n"
+                "              <SDI name=\"units\">\n"
+                "                <DAI name=\"SIUnit\"><Val>W</Val></DAI>\n"
+                "                <DAI name=\"multiplier\"><Val>k</Val></DAI>\n"
+                "              </SDI>\n"
+                "            </DOI>\n"
+                "            <DOI name=\"Hz\">\n"
+                "              <SDI name=\"units\">\n"
+                "                <DAI name=\"SIUnit\"><Val>Hz</Val></DAI>\n"
+                "              </SDI>\n"
+                "            </DOI>\n"
+                "          </LN>\n",
+                i, family);
+    }
+    for (int i = 1; i <= BENCH_CSWI; i++) {
+        fprintf(fp,
+                "          <LN lnClass=\"CSWI\" inst=\"%d\" "
+                "lnType=\"CSWI_%d\" prefix=\"\">\n"
+                "            <DOI name=\"Pos\">\n"
+                "              <DAI name=\"ctlModel\">"
+                "<Val>direct-with-normal-security</Val></DAI>\n"
+                "            </DOI>\n"
+                "          </LN>\n",
+                i, family);
+    }
+    fprintf(fp,
+            "          <LN lnClass=\"GGIO\" inst=\"1\" lnType=\"GGIO_%d\" "
+            "prefix=\"\">\n"
+            "            <DOI name=\"SPCSO1\">\n"
+            "              <DAI name=\"ctlModel\">"
+            "<Val>direct-with-normal-security</Val></DAI>\n"
+            "            </DOI>\n"
+            "          </LN>\n"
+            "          <LN lnClass=\"PTOC\" inst=\"1\" lnType=\"PTOC_%d\" "
+            "prefix=\"\">\n"
+            "            <DOI name=\"StrVal\">\n"
+            "              <SDI name=\"setMag\">\n"
+            "                <DAI name=\"f\"><Val>100</Val></DAI>\n"
+            "              </SDI>\n"
+            "            </DOI>\n"
+            "            <DOI name=\"OpDlTmms\">\n"
+            "              <DAI name=\"setVal\"><Val>200</Val></DAI>\n"
+            "            </DOI>\n"
+            "          </LN>\n"
+            "        </LDevice>\n",
+            family, family);
+}
+
+static void gen_da(FILE *fp, const char *name, const char *fc,
+                   const char *btype, const char *type, int family)
+{
+    fprintf(fp, "      <DA name=\"%s\" fc=\"%s\" bType=\"%s\"", name, fc,
+            btype);
+    if (type != NULL) {
+        fprintf(fp, " type=\"%s_%d\"", type, family);
+    }
+    fprintf(fp, "/>\n");
+}
+
+static void gen_bda(FILE *fp, const char *name, const char *btype,
+                    const char *type, int family)
+{
+    fprintf(fp, "      <BDA name=\"%s\" bType=\"%s\"", name, btype);
+    if (type != NULL) {
+        fprintf(fp, " type=\"%s_%d\"", type, family);
+    }
+    fprintf(fp, "/>\n");
+}
+
+static void gen_status(FILE *fp, int family)
+{
+    gen_da(fp, "q", "ST", "Quality", NULL, family);
+    gen_da(fp, "t", "ST", "Timestamp", NULL, family);
+}
+
+static void gen_oper(FILE *fp, const char *id, const char *ctl_btype,
+                     int family)
+{
+    fprintf(fp, "    <DAType id=\"%s_%d\">\n", id, family);
+    gen_bda(fp, "ctlVal", ctl_btype, NULL, family);
+    gen_bda(fp, "origin", "Struct", "Originator", family);
+    gen_bda(fp, "ctlNum", "INT8U", NULL, family);
+    gen_bda(fp, "T", "Timestamp", NULL, family);
+    gen_bda(fp, "Test", "BOOLEAN", NULL, family);
+    gen_bda(fp, "Check", "Check", NULL, family);
+    fprintf(fp, "    </DAType>\n");
+}
+
+static void gen_lnotype(FILE *fp, const char *id, const char *ln_class,
+                        int family, const char *const *dos)
+{
+    fprintf(fp, "    <LNodeType id=\"%s_%d\" lnClass=\"%s\">\n", id, family,
+            ln_class);
+    for (int i = 0; dos[i] != NULL; i += 2) {
+        fprintf(fp, "      <DO name=\"%s\" type=\"%s_%d\"/>\n", dos[i],
+                dos[i + 1], family);
+    }
+    fprintf(fp, "    </LNodeType>\n");
+}
+
+static void gen_templates(FILE *fp, int family)
+{
+    static const char *const lln0[] = { "Mod", "ENC", "Beh", "ENS", "NamPlt",
+                                        "LPL", NULL };
+    static const char *const mmxu[] = { "Beh", "ENS", "TotW", "MV", "Hz",
+                                        "MV",  "PhV", "WYE", "A",  "WYE",
+                                        NULL };
+    static const char *const cswi[] = { "Beh", "ENS", "Pos", "DPC", NULL };
+    static const char *const ggio[] = { "Beh",  "ENS", "Ind1",   "SPS",
+                                        "Ind2", "SPS", "Ind3",   "SPS",
+                                        "Ind4", "SPS", "SPCSO1", "SPC",
+                                        NULL };
+    static const char *const ptoc[] = { "Beh", "ENS", "StrVal", "ASG",
+                                        "OpDlTmms", "ING", NULL };
+
+    gen_lnotype(fp, "LLN0", "LLN0", family, lln0);
+    gen_lnotype(fp, "MMXU", "MMXU", family, mmxu);
+    gen_lnotype(fp, "CSWI", "CSWI", family, cswi);
+    gen_lnotype(fp, "GGIO", "GGIO", family, ggio);
+    gen_lnotype(fp, "PTOC", "PTOC", family, ptoc);
+
+    fprintf(fp, "    <DOType id=\"ENC_%d\" cdc=\"ENC\">\n", family);
+    gen_da(fp, "Oper", "CO", "Struct", "ENC_Oper", family);
+    gen_da(fp, "stVal", "ST", "Enum", NULL, family);
+    gen_status(fp, family);
+    gen_da(fp, "ctlModel", "CF", "Enum", NULL, family);
+    fprintf(fp, "    </DOType>\n");
+
+    fprintf(fp, "    <DOType id=\"ENS_%d\" cdc=\"ENS\">\n", family);
+    gen_da(fp, "stVal", "ST", "Enum", NULL, family);
+    gen_status(fp, family);
+    fprintf(fp, "    </DOType>\n");
+
+    fprintf(fp, "    <DOType id=\"LPL_%d\" cdc=\"LPL\">\n", family);
+    gen_da(fp, "vendor", "DC", "VisString255", NULL, family);
+    gen_da(fp, "swRev", "DC", "VisString255", NULL, family);
+    gen_da(fp, "d", "DC", "VisString255", NULL, family);
+    fprintf(fp, "    </DOType>\n");
+
+    fprintf(fp, "    <DOType id=\"MV_%d\" cdc=\"MV\">\n", family);
+    gen_da(fp, "mag", "MX", "Struct", "AnalogueValue", family);
+    gen_da(fp, "q", "MX", "Quality", NULL, family);
+    gen_da(fp, "t", "MX", "Timestamp", NULL, family);
+    gen_da(fp, "units", "CF", "Struct", "Unit", family);
+    gen_da(fp, "dU", "DC", "Unicode255", NULL, family);
+    fprintf(fp, "    </DOType>\n");
+
+    fprintf(fp,
+            "    <DOType id=\"WYE_%d\" cdc=\"WYE\">\n"
+            "      <SDO name=\"phsA\" type=\"CMV_%d\"/>\n"
+            "      <SDO name=\"phsB\" type=\"CMV_%d\"/>\n"
+            "      <SDO name=\"phsC\" type=\"CMV_%d\"/>\n"
+            "    </DOType>\n",
+            family, family, family, family);
+
+    fprintf(fp, "    <DOType id=\"CMV_%d\" cdc=\"CMV\">\n", family);
+    gen_da(fp, "cVal", "MX", "Struct", "Vector", family);
+    gen_da(fp, "q", "MX", "Quality", NULL, family);
+    gen_da(fp, "t", "MX", "Timestamp", NULL, family);
+    fprintf(fp, "    </DOType>\n");
+
+    fprintf(fp, "    <DOType id=\"DPC_%d\" cdc=\"DPC\">\n", family);
+    gen_da(fp, "Oper", "CO", "Struct", "DPC_Oper", family);
+    gen_da(fp, "stVal", "ST", "Dbpos", NULL, family);
+    gen_status(fp, family);
+    gen_da(fp, "ctlModel", "CF", "Enum", NULL, family);
+    fprintf(fp, "    </DOType>\n");
+
+    fprintf(fp, "    <DOType id=\"SPS_%d\" cdc=\"SPS\">\n", family);
+    gen_da(fp, "stVal", "ST", "BOOLEAN", NULL, family);
+    gen_status(fp, family);
+    fprintf(fp, "    </DOType>\n");
+
+    fprintf(fp, "    <DOType id=\"SPC_%d\" cdc=\"SPC\">\n", family);
+    gen_da(fp, "Oper", "CO", "Struct", "SPC_Oper", family);
+    gen_da(fp, "stVal", "ST", "BOOLEAN", NULL, family);
+    gen_status(fp, family);
+    gen_da(fp, "ctlModel", "CF", "Enum", NULL, family);
+    fprintf(fp, "    </DOType>\n");
+
+    fprintf(fp, "    <DOType id=\"ASG_%d\" cdc=\"ASG\">\n", family);
+    gen_da(fp, "setMag", "SP", "Struct", "AnalogueValue", family);
+    gen_da(fp, "units", "CF", "Struct", "Unit", family);
+    fprintf(fp, "    </DOType>\n");
+
+    fprintf(fp, "    <DOType id=\"ING_%d\" cdc=\"ING\">\n", family);
+    gen_da(fp, "setVal", "SP", "INT32", NULL, family);
+    gen_da(fp, "minVal", "CF", "INT32", NULL, family);
+    gen_da(fp, "maxVal", "CF", "INT32", NULL, family);
+    fprintf(fp, "    </DOType>\n");
+
+    fprintf(fp, "    <DAType id=\"AnalogueValue_%d\">\n", family);
+    gen_bda(fp, "f", "FLOAT32", NULL, family);
+    fprintf(fp, "    </DAType>\n");
+
+    fprintf(fp, "    <DAType id=\"Vector_%d\">\n", family);
+    gen_bda(fp, "mag", "Struct", "AnalogueValue", family);
+    gen_bda(fp, "ang", "Struct", "AnalogueValue", family);
+    fprintf(fp, "    </DAType>\n");
+
+    fprintf(fp, "    <DAType id=\"Unit_%d\">\n", family);
+    gen_bda(fp, "SIUnit", "Enum", NULL, family);
+    gen_bda(fp, "multiplier", "Enum", NULL, family);
+    fprintf(fp, "    </DAType>\n");
+
+    fprintf(fp, "    <DAType id=\"Originator_%d\">\n", family);
+    gen_bda(fp, "orCat", "Enum", NULL, family);
+    gen_bda(fp, "orIdent", "Octet64", NULL, family);
+    fprintf(fp, "    </DAType>\n");
+
+    gen_oper(fp, "DPC_Oper", "BOOLEAN", family);
+    gen_oper(fp, "SPC_Oper", "BOOLEAN", family);
+    gen_oper(fp, "ENC_Oper", "Enum", family);
+}
+
+static int generate(const char *path, const struct bench_args *args)
+{
+    FILE *fp = fopen(path, "w");
+    if (fp == NULL) {
+        fprintf(stderr, "open %s fail: %s\n", path, strerror(errno));
+        return -1;
+    }
+
+    long target = (long) args->size_mb * 1024 * 1024;
+    int  ld     = 0;
+
+    gen_header(fp);
+    while (ftell(fp) < target) {
+        gen_ldevice(fp, ld, ld % args->types);
+        ld += 1;
+    }
+    fprintf(fp,
+            "      </Server>\n"
+            "    </AccessPoint>\n"
+            "  </IED>\n"
+            "  <DataTypeTemplates>\n");
+    for (int i = 0; i < args->types; i++) {
+        gen_templates(fp, i);
+    }
+    fprintf(fp,
+            "  </DataTypeTemplates>\n"
+            "</SCL>\n");
+
+    if (fclose(fp) != 0) {
+        fprintf(stderr, "write %s fail: %s\n", path, strerror(errno));
+        return -1;
+    }
+    return 0;
+}
+
+static long max_rss_kb(void)
+{
+    struct rusage usage = { 0 };
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+int main(int argc, char *argv[])
+{
+    struct bench_args  args   = { 0 };
+    char               path[] = "/tmp/cid-bench-XXXXXX";
+    const char *       file   = NULL;
+    cid_t              cid    = { 0 };
+    neu_req_add_gtag_t cmd    = { 0 };
+    int                n_tags = 0;
+    int                rv     = 1;
+
+    if (parse_args(argc, argv, &args) != 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (args.file != NULL) {
+        file = args.file;
+    } else {
+        int fd = mkstemp(path);
+        if (fd < 0) {
+            fprintf(stderr, "create %s fail: %s\n", path, strerror(errno));
+            return 1;
+        }
+        close(fd);
+        if (generate(path, &args) != 0) {
+            goto remove_file;
+        }
+        file = path;
+    }
+
+    FILE *fp = fopen(file, "r");
+    if (fp == NULL) {
+        fprintf(stderr, "open %s fail: %s\n", file, strerror(errno));
+        goto remove_file;
+    }
+    fseek(fp, 0, SEEK_END);
+    long file_bytes = ftell(fp);
+    fclose(fp);
+
+    long    rss_before = max_rss_kb();
+    int64_t start      = neu_time_mono_ns();
+    if (neu_cid_parse(file, &cid) != 0) {
+        fprintf(stderr, "parse %s fail\n", file);
+        goto remove_file;
+    }
+    int64_t parsed    = neu_time_mono_ns();
+    long    rss_parse = max_rss_kb();
+
+    neu_cid_to_msg("bench-driver", &cid, &cmd);
+    int64_t done = neu_time_mono_ns();
+
+    for (int i = 0; i < cmd.n_group; i++) {
+        n_tags += cmd.groups[i].n_tag;
+        for (int j = 0; j < cmd.groups[i].n_tag; j++) {
+            neu_tag_fini(&cmd.groups[i].tags[j]);
+        }
+        free(cmd.groups[i].tags);
+        free(cmd.groups[i].context);
+    }
+    free(cmd.groups);
+    neu_cid_free(&cid);
+
+    printf("{\"file_mb\":%.1f,\"parse_ms\":%.1f,\"to_msg_ms\":%.1f,"
+           "\"parse_rss_mb\":%.1f,\"max_rss_mb\":%.1f,\"groups\":%d,"
+           "\"tags\":%d}\n",
+           file_bytes / 1048576.0, (parsed - start) / 1e6,
+           (done - parsed) / 1e6, (rss_parse - rss_before) / 1024.0,
+           max_rss_kb() / 1024.0, cmd.n_group, n_tags);
+    rv = 0;
+
+remove_file:
+    if (args.file == NULL && !args.keep) {
+        unlink(path);
+    } else if (args.file == NULL) {
+        fprintf(stderr, "kept %s\n", path);
+    }
+    return rv;
+}
@@ -0,0 +1,338 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+/**
+ * datalayer Flight SQL 客户端写入吞吐基准：在进程内启动一个 Flight SQL 测试
+ * 服务端，分别用拼接 SQL（client_insert_sql）与按列批量写入（client_insert）
+ * 向其写入点位。服务端只解码收到的数据并计数、不落盘，结果反映客户端编码、
+ * 传输与服务端解码的开销。
+ *
+ * 用法：flight_sql_bench [options]，每个阶段输出一行 JSON。
+ */
+
+#include <getopt.h>
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <arrow/flight/server.h>
+#include <arrow/flight/sql/server.h>
+#include <arrow/record_batch.h>
+#include <arrow/util/config.h>
+
+#include "flight_sql_client.h"
+
+namespace flight    = arrow::flight;
+namespace flightsql = arrow::flight::sql;
+
+struct bench_args {
+    int       tags;
+    int       batches;
+    ValueType type;
+    bool      ingest;
+};
+
+class BenchServer : public flightsql::FlightSqlServerBase {
+public:
+    std::atomic<int64_t> sql_rows{ 0 };
+    std::atomic<int64_t> ingest_rows{ 0 };
+    std::atomic<int64_t> prepared_rows{ 0 };
+    bool                 ingest = true;
+
+    arrow::Result<std::unique_ptr<flight::FlightInfo>>
+    GetFlightInfoStatement(const flight::ServerCallContext &context,
+                           const flightsql::StatementQuery &command,
+                           const flight::FlightDescriptor & descriptor) override
+    {
+        (void) context;
+
+        // 只数 VALUES 中的元组，服务端解析 SQL 的代价按最低估计
+        const std::string &sql  = command.query;
+        int64_t            rows = 0;
+        for (size_t pos = sql.find("(CURRENT_TIMESTAMP");
+             pos != std::string::npos;
+             pos = sql.find("(CURRENT_TIMESTAMP", pos + 1)) {
+            rows += 1;
+        }
+        sql_rows += rows;
+
+        flight::FlightEndpoint endpoint;
+        ARROW_ASSIGN_OR_RAISE(endpoint.ticket.ticket,
+                              flightsql::CreateStatementQueryTicket("insert"));
+        ARROW_ASSIGN_OR_RAISE(
+            auto info,
+            flight::FlightInfo::Make(*arrow::schema({}), descriptor,
+                                     { endpoint }, 0, 0));
+        return std::make_unique<flight::FlightInfo>(std::move(info));
+    }
+
+    arrow::Result<std::unique_ptr<flight::FlightDataStream>>
+    DoGetStatement(const flight::ServerCallContext &      context,
+                   const flightsql::StatementQueryTicket &command) override
+    {
+        (void) context;
+        (void) command;
+
+        ARROW_ASSIGN_OR_RAISE(
+            auto reader, arrow::RecordBatchReader::Make({}, arrow::schema({})));
+        return std::make_unique<flight::RecordBatchStream>(reader);
+    }
+
+    arrow::Result<flightsql::ActionCreatePreparedStatementResult>
+    CreatePreparedStatement(
+        const flight::ServerCallContext &                   context,
+        const flightsql::ActionCreatePreparedStatementRequest &request) override
+    {
+        (void) context;
+        (void) request;
+
+        return flightsql::ActionCreatePreparedStatementResult{
+            arrow::schema({}), arrow::schema({}), "insert"
+        };
+    }
+
+    arrow::Status ClosePreparedStatement(
+        const flight::ServerCallContext &                  context,
+        const flightsql::ActionClosePreparedStatementRequest &request) override
+    {
+        (void) context;
+        (void) request;
+        return arrow::Status::OK();
+    }
+
+    arrow::Result<int64_t> DoPutPreparedStatementUpdate(
+        const flight::ServerCallContext &         context,
+        const flightsql::PreparedStatementUpdate &command,
+        flight::FlightMessageReader *             reader) override
+    {
+        (void) context;
+        (void) command;
+        return CountRows(reader, &prepared_rows);
+    }
+
+#if ARROW_VERSION_MAJOR >= 16
+    arrow::Result<int64_t>
+    DoPutCommandStatementIngest(const flight::ServerCallContext &context,
+                                const flightsql::StatementIngest &command,
+                                flight::FlightMessageReader *reader) override
+    {
+        (void) context;
+        (void) command;
+
+        if (!ingest) {
+            return arrow::Status::NotImplemented("bulk ingest disabled");
+        }
+        return CountRows(reader, &ingest_rows);
+    }
+#endif
+
+private:
+    static arrow::Result<int64_t> CountRows(flight::FlightMessageReader *reader,
+                                            std::atomic<int64_t> *       total)
+    {
+        int64_t rows = 0;
+
+        while (true) {
+            ARROW_ASSIGN_OR_RAISE(auto chunk, reader->Next());
+            if (!chunk.data) {
+                break;
+            }
+            rows += chunk.data->num_rows();
+        }
+
+        *total += rows;
+        return rows;
+    }
+};
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -t, --tags <n>      tags per insert, default 1000\n"
+            "  -b, --batches <n>   inserts per phase, default 100\n"
+            "  -T, --type <type>   int, float, bool or string, default float\n"
+            "  -n, --no-ingest     server rejects bulk ingest, so the client "
+            "falls back to prepared statements\n",
+            prog);
+}
+
+static int parse_args(int argc, char *argv[], struct bench_args *args)
+{
+    static const struct option long_options[] = {
+        { "tags", required_argument, NULL, 't' },
+        { "batches", required_argument, NULL, 'b' },
+        { "type", required_argument, NULL, 'T' },
+        { "no-ingest", no_argument, NULL, 'n' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+
+    args->tags    = 1000;
+    args->batches = 100;
+    args->type    = FLOAT_TYPE;
+    args->ingest  = true;
+
+    int c = 0;
+    while ((c = getopt_long(argc, argv, "t:b:T:nh", long_options, NULL)) !=
+           -1) {
+        switch (c) {
+        case 't':
+            args->tags = atoi(optarg);
+            break;
+        case 'b':
+            args->batches = atoi(optarg);
+            break;
+        case 'T':
+            if (0 == strcmp(optarg, "int")) {
+                args->type = INT_TYPE;
+            } else if (0 == strcmp(optarg, "float")) {
+                args->type = FLOAT_TYPE;
+            } else if (0 == strcmp(optarg, "bool")) {
+                args->type = BOOL_TYPE;
+            } else if (0 == strcmp(optarg, "string")) {
+                args->type = STRING_TYPE;
+            } else {
+                return -1;
+            }
+            break;
+        case 'n':
+            args->ingest = false;
+            break;
+        default:
+            return -1;
+        }
+    }
+
+    if (args->tags <= 0 || args->batches <= 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+typedef int (*insert_fn)(Client *client, ValueType type, datatag *tags,
+                         size_t tag_count);
+
+static int64_t server_rows(BenchServer *server)
+{
+    return server->sql_rows + server->ingest_rows + server->prepared_rows;
+}
+
+static int run(const char *phase, insert_fn insert, Client *client,
+               BenchServer *server, const struct bench_args *args,
+               std::vector<datatag> &tags)
+{
+    int64_t rows   = (int64_t) args->tags * args->batches;
+    int64_t before = server_rows(server);
+    int     failed = 0;
+    auto    start  = std::chrono::steady_clock::now();
+
+    for (int i = 0; i < args->batches; i++) {
+        if (0 != insert(client, args->type, tags.data(), tags.size())) {
+            failed += 1;
+        }
+    }
+
+    int64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                     std::chrono::steady_clock::now() - start)
+                     .count();
+
+    printf("{\"phase\":\"%s\",\"rows\":%" PRId64 ",\"failed\":%d,"
+           "\"ns_per_row\":%.1f,\"rows_per_sec\":%.0f,\"server_rows\":%" PRId64
+           "}\n",
+           phase, rows, failed, (double) ns / rows,
+           rows * 1e9 / (ns > 0 ? ns : 1), server_rows(server) - before);
+    return failed;
+}
+
+int main(int argc, char *argv[])
+{
+    struct bench_args args = {};
+    BenchServer       server;
+
+    if (parse_args(argc, argv, &args) != 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    auto location = flight::Location::ForGrpcTcp("127.0.0.1", 0);
+    if (!location.ok()) {
+        fprintf(stderr, "%s\n", location.status().ToString().c_str());
+        return 1;
+    }
+
+    flight::FlightServerOptions options(location.ValueOrDie());
+    arrow::Status               status = server.Init(options);
+    if (!status.ok()) {
+        fprintf(stderr, "start server fail: %s\n", status.ToString().c_str());
+        return 1;
+    }
+    server.ingest = args.ingest;
+
+    Client *client = client_create("127.0.0.1", server.port(), "", "");
+    if (client == NULL) {
+        (void) server.Shutdown();
+        return 1;
+    }
+
+    // 同一节点下每 100 个点位一个组，字符串值长度与点位名相当
+    std::vector<std::string> names(args.tags);
+    std::vector<std::string> groups(args.tags);
+    std::vector<datatag>     tags(args.tags);
+    for (int i = 0; i < args.tags; i++) {
+        names[i]  = "tag-" + std::to_string(i);
+        groups[i] = "group-" + std::to_string(i / 100);
+
+        tags[i].node_name  = "bench-node";
+        tags[i].group_name = groups[i].c_str();
+        tags[i].tag        = names[i].c_str();
+        tags[i].value_type = args.type;
+        switch (args.type) {
+        case INT_TYPE:
+            tags[i].value.int_value = i;
+            break;
+        case FLOAT_TYPE:
+            tags[i].value.float_value = i * 0.5f;
+            break;
+        case BOOL_TYPE:
+            tags[i].value.bool_value = i % 2;
+            break;
+        case STRING_TYPE:
+            tags[i].value.string_value = names[i].c_str();
+            break;
+        }
+    }
+
+    int rv = 0;
+    rv += run("sql", client_insert_sql, client, &server, &args, tags);
+    rv += run("bulk", client_insert, client, &server, &args, tags);
+    printf("{\"ingest_rows\":%" PRId64 ",\"prepared_rows\":%" PRId64 "}\n",
+           server.ingest_rows.load(), server.prepared_rows.load());
+
+    client_destroy(client);
+    (void) server.Shutdown();
+    return rv == 0 ? 0 : 1;
+}
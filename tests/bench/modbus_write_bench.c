@@ -0,0 +1,438 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+/**
+ * Modbus 批量写基准：对一次写多个点位的请求，比较逐点发送（每个点位一帧
+ * FC5/FC6/FC16）与 modbus_write_tags_sort 合并为 FC15/FC16 帧两种方式。
+ *
+ * 不指定 --port 时只统计帧数、字节数与合并耗时；指定 --port 时连接一个
+ * Modbus TCP 从站（例如 tests/ft 使用的 modbus_simulator），按两种方式各
+ * 发送 --rounds 次请求，输出每次请求的耗时。
+ *
+ * 用法：modbus_write_bench [options]，每个阶段输出一行 JSON。
+ */
+
+#include <arpa/inet.h>
+#include <getopt.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <neuron.h>
+
+#include "modbus.h"
+#include "modbus_point.h"
+
+zlog_category_t *neuron = NULL;
+
+#define BENCH_ADU_MAX 260
+
+struct bench_args {
+    int         tags;
+    int         gap;
+    neu_type_e  type;
+    const char *host;
+    int         port;
+    int         rounds;
+};
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -n, --tags <n>      tags per write request, default 1000\n"
+            "  -g, --gap <n>       leave one unused address after every n "
+            "tags,\n"
+            "                      0 for contiguous tags, default 0\n"
+            "  -t, --type <type>   int16, float or bit, default int16\n"
+            "  -h, --host <ip>     Modbus TCP slave, default 127.0.0.1\n"
+            "  -p, --port <port>   Modbus TCP slave port, plan only if "
+            "omitted\n"
+            "  -r, --rounds <n>    requests per mode, default 100\n",
+            prog);
+}
+
+static int parse_args(int argc, char *argv[], struct bench_args *args)
+{
+    static struct option long_options[] = {
+        { "tags", required_argument, NULL, 'n' },
+        { "gap", required_argument, NULL, 'g' },
+        { "type", required_argument, NULL, 't' },
+        { "host", required_argument, NULL, 'h' },
+        { "port", required_argument, NULL, 'p' },
+        { "rounds", required_argument, NULL, 'r' },
+        { NULL, 0, NULL, 0 },
+    };
+    int c = 0;
+
+    while ((c = getopt_long(argc, argv, "n:g:t:h:p:r:", long_options, NULL)) !=
+           -1) {
+        switch (c) {
+        case 'n':
+            args->tags = atoi(optarg);
+            break;
+        case 'g':
+            args->gap = atoi(optarg);
+            break;
+        case 't':
+            if (0 == strcmp(optarg, "int16")) {
+                args->type = NEU_TYPE_INT16;
+            } else if (0 == strcmp(optarg, "float")) {
+                args->type = NEU_TYPE_FLOAT;
+            } else if (0 == strcmp(optarg, "bit")) {
+                args->type = NEU_TYPE_BIT;
+            } else {
+                return -1;
+            }
+            break;
+        case 'h':
+            args->host = optarg;
+            break;
+        case 'p':
+            args->port = atoi(optarg);
+            break;
+        case 'r':
+            args->rounds = atoi(optarg);
+            break;
+        default:
+            return -1;
+        }
+    }
+
+    // 线圈与保持寄存器地址均不超过 65536
+    if (args->tags <= 0 || args->tags > 10000 || args->gap < 0 ||
+        args->rounds <= 0) {
+        return -1;
+    }
+    return 0;
+}
+
+static UT_array *points_new(const struct bench_args *args)
+{
+    UT_array *points  = NULL;
+    uint32_t  address = 0;
+
+    utarray_new(points, &ut_ptr_icd);
+    for (int i = 0; i < args->tags; i++) {
+        neu_datatag_t          tag      = { 0 };
+        neu_plugin_tag_value_t tv       = { 0 };
+        char                   addr[32] = { 0 };
+        modbus_point_write_t * p        = calloc(1, sizeof(*p));
+
+        if (args->gap > 0 && i > 0 && i % args->gap == 0) {
+            address += 1;
+        }
+
+        snprintf(addr, sizeof(addr), "1!%c%05u",
+                 NEU_TYPE_BIT == args->type ? '0' : '4', address + 1);
+        tag.name      = "tag";
+        tag.address   = addr;
+        tag.type      = args->type;
+        tag.attribute = NEU_ATTRIBUTE_WRITE;
+        tv.tag        = &tag;
+        switch (args->type) {
+        case NEU_TYPE_BIT:
+            tv.value.u8 = i % 2;
+            break;
+        case NEU_TYPE_FLOAT:
+            tv.value.f32 = i * 0.5f;
+            break;
+        default:
+            tv.value.i16 = (int16_t) i;
+            break;
+        }
+
+        modbus_write_tag_to_point(&tv, p, base_1);
+        utarray_push_back(points, &p);
+        address += p->point.n_register;
+    }
+
+    return points;
+}
+
+static void cmd_sort_free(modbus_write_cmd_sort_t *sort)
+{
+    for (uint16_t i = 0; i < sort->n_cmd; i++) {
+        utarray_free(sort->cmd[i].tags);
+        free(sort->cmd[i].bytes);
+    }
+    free(sort->cmd);
+    free(sort);
+}
+
+// modbus_write_tags_sort 会就地转换点位值的字节序，每次合并前恢复原值
+static modbus_write_cmd_sort_t *plan(UT_array *points, neu_value_u *values)
+{
+    int i = 0;
+
+    utarray_foreach(points, modbus_point_write_t **, p)
+    {
+        (*p)->value = values[i++];
+    }
+    return modbus_write_tags_sort(points, MODBUS_ABCD);
+}
+
+/**
+ * 逐点发送时每个点位单独成帧。
+ */
+static modbus_write_cmd_sort_t *plan_per_tag(UT_array *   points,
+                                             neu_value_u *values)
+{
+    modbus_write_cmd_sort_t *result = calloc(1, sizeof(*result));
+    UT_array *               one    = NULL;
+    int                      i      = 0;
+
+    result->n_cmd = utarray_len(points);
+    result->cmd   = calloc(result->n_cmd, sizeof(modbus_write_cmd_t));
+
+    utarray_new(one, &ut_ptr_icd);
+    utarray_foreach(points, modbus_point_write_t **, p)
+    {
+        utarray_clear(one);
+        utarray_push_back(one, p);
+        (*p)->value = values[i];
+
+        modbus_write_cmd_sort_t *s = modbus_write_tags_sort(one, MODBUS_ABCD);
+        result->cmd[i++]           = s->cmd[0];
+        free(s->cmd);
+        free(s);
+    }
+    utarray_free(one);
+
+    return result;
+}
+
+/**
+ * 按 modbus_stack_write 的方式组一帧 Modbus TCP 写请求，帧从 buf 的末尾向前
+ * 填充，frame 指向帧的起始位置。
+ */
+static uint16_t frame_build(const modbus_write_cmd_t *cmd, uint16_t seq,
+                            uint8_t *buf, uint8_t **frame)
+{
+    neu_protocol_pack_buf_t pbuf = { 0 };
+
+    neu_protocol_pack_buf_init(&pbuf, buf, BENCH_ADU_MAX);
+    if (MODBUS_AREA_COIL == cmd->area) {
+        if (cmd->n_byte > 1) {
+            modbus_data_wrap(&pbuf, (cmd->n_byte + 7) / 8, cmd->bytes,
+                             MODBUS_ACTION_DEFAULT);
+            modbus_address_wrap(&pbuf, cmd->start_address, cmd->n_byte,
+                                MODBUS_ACTION_DEFAULT);
+            modbus_code_wrap(&pbuf, cmd->slave_id, MODBUS_WRITE_M_COIL);
+        } else {
+            modbus_address_wrap(&pbuf, cmd->start_address,
+                                cmd->bytes[0] ? 0xff00 : 0,
+                                MODBUS_ACTION_DEFAULT);
+            modbus_code_wrap(&pbuf, cmd->slave_id, MODBUS_WRITE_S_COIL);
+        }
+    } else {
+        modbus_data_wrap(&pbuf, cmd->n_byte, cmd->bytes,
+                         MODBUS_ACTION_HOLD_REG_WRITE);
+        modbus_address_wrap(&pbuf, cmd->start_address, cmd->n_register,
+                            MODBUS_ACTION_HOLD_REG_WRITE);
+        modbus_code_wrap(&pbuf, cmd->slave_id,
+                         cmd->n_register > 1 ? MODBUS_WRITE_M_HOLD_REG
+                                             : MODBUS_WRITE_S_HOLD_REG);
+    }
+    modbus_header_wrap(&pbuf, seq);
+
+    *frame = neu_protocol_pack_buf_get(&pbuf);
+    return neu_protocol_pack_buf_used_size(&pbuf);
+}
+
+static int recv_full(int fd, uint8_t *buf, size_t size)
+{
+    size_t n = 0;
+
+    while (n < size) {
+        ssize_t ret = recv(fd, buf + n, size - n, 0);
+        if (ret <= 0) {
+            return -1;
+        }
+        n += ret;
+    }
+    return 0;
+}
+
+/**
+ * 依次发送各帧并等待响应。
+ *
+ * @return 设备返回异常响应的帧数，连接失败返回 -1。
+ */
+static int send_request(int fd, const modbus_write_cmd_sort_t *sort,
+                        uint16_t *seq, uint64_t *n_byte)
+{
+    uint8_t  buf[BENCH_ADU_MAX] = { 0 };
+    uint8_t *frame              = NULL;
+    int      n_err              = 0;
+
+    for (uint16_t i = 0; i < sort->n_cmd; i++) {
+        uint16_t size = frame_build(&sort->cmd[i], (*seq)++, buf, &frame);
+
+        *n_byte += size;
+        if (send(fd, frame, size, 0) != size) {
+            return -1;
+        }
+
+        // MBAP 头之后为单元标识与功能码，异常响应的功能码最高位为 1
+        if (recv_full(fd, buf, 6) != 0) {
+            return -1;
+        }
+        uint16_t len = ntohs(*(uint16_t *) (buf + 4));
+        if (len < 2 || len > BENCH_ADU_MAX - 6 ||
+            recv_full(fd, buf + 6, len) != 0) {
+            return -1;
+        }
+        if (buf[7] & 0x80) {
+            n_err += 1;
+        }
+    }
+
+    return n_err;
+}
+
+static int connect_slave(const char *host, int port)
+{
+    struct sockaddr_in addr = { 0 };
+    int                one  = 1;
+    int                fd   = socket(AF_INET, SOCK_STREAM, 0);
+
+    addr.sin_family      = AF_INET;
+    addr.sin_port        = htons(port);
+    addr.sin_addr.s_addr = inet_addr(host);
+
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    if (connect(fd, (struct sockaddr *) &addr, sizeof(addr)) != 0) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void print_plan(const char *mode, const struct bench_args *args,
+                       const modbus_write_cmd_sort_t *sort, double plan_us)
+{
+    uint8_t  buf[BENCH_ADU_MAX] = { 0 };
+    uint8_t *frame              = NULL;
+    uint64_t n_byte             = 0;
+
+    for (uint16_t i = 0; i < sort->n_cmd; i++) {
+        n_byte += frame_build(&sort->cmd[i], i, buf, &frame);
+    }
+
+    printf("{\"bench\":\"modbus_write\",\"phase\":\"plan\",\"mode\":\"%s\","
+           "\"tags\":%d,\"gap\":%d,\"frames\":%hu,\"request_bytes\":%" PRIu64
+           ",\"plan_us_per_request\":%.1f}\n",
+           mode, args->tags, args->gap, sort->n_cmd, n_byte, plan_us);
+}
+
+static int run_slave(const char *mode, const struct bench_args *args,
+                     const modbus_write_cmd_sort_t *sort)
+{
+    int      fd     = connect_slave(args->host, args->port);
+    uint16_t seq    = 0;
+    uint64_t n_byte = 0;
+    int      n_err  = 0;
+
+    if (fd < 0) {
+        fprintf(stderr, "connect %s:%d failed\n", args->host, args->port);
+        return -1;
+    }
+
+    int64_t start = neu_time_mono_ns();
+    for (int i = 0; i < args->rounds; i++) {
+        int ret = send_request(fd, sort, &seq, &n_byte);
+        if (ret < 0) {
+            fprintf(stderr, "%s: connection lost\n", mode);
+            close(fd);
+            return -1;
+        }
+        n_err += ret;
+    }
+    int64_t elapsed = neu_time_mono_ns() - start;
+
+    printf("{\"bench\":\"modbus_write\",\"phase\":\"slave\",\"mode\":\"%s\","
+           "\"tags\":%d,\"rounds\":%d,\"frames\":%hu,\"ms_per_request\":%.3f,"
+           "\"tags_per_sec\":%.0f,\"bytes_per_request\":%" PRIu64
+           ",\"exception_frames\":%d}\n",
+           mode, args->tags, args->rounds, sort->n_cmd,
+           (double) elapsed / args->rounds / 1000000,
+           (double) args->tags * args->rounds * 1000000000 / elapsed,
+           n_byte / args->rounds, n_err);
+
+    close(fd);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    struct bench_args args = {
+        .tags   = 1000,
+        .gap    = 0,
+        .type   = NEU_TYPE_INT16,
+        .host   = "127.0.0.1",
+        .port   = 0,
+        .rounds = 100,
+    };
+
+    if (parse_args(argc, argv, &args) != 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    UT_array *   points = points_new(&args);
+    neu_value_u *values = calloc(args.tags, sizeof(neu_value_u));
+    int          i      = 0;
+
+    utarray_foreach(points, modbus_point_write_t **, p)
+    {
+        values[i++] = (*p)->value;
+    }
+
+    int64_t start = neu_time_mono_ns();
+    for (int r = 0; r < args.rounds; r++) {
+        cmd_sort_free(plan(points, values));
+    }
+    double plan_us = (double) (neu_time_mono_ns() - start) / args.rounds / 1000;
+
+    modbus_write_cmd_sort_t *per_tag = plan_per_tag(points, values);
+    modbus_write_cmd_sort_t *batched = plan(points, values);
+
+    print_plan("per_tag", &args, per_tag, 0);
+    print_plan("batched", &args, batched, plan_us);
+
+    int rv = 0;
+    if (args.port > 0) {
+        if (run_slave("per_tag", &args, per_tag) != 0 ||
+            run_slave("batched", &args, batched) != 0) {
+            rv = 1;
+        }
+    }
+
+    cmd_sort_free(per_tag);
+    cmd_sort_free(batched);
+    utarray_foreach(points, modbus_point_write_t **, p) { free(*p); }
+    utarray_free(points);
+    free(values);
+    return rv;
+}
@@ -0,0 +1,768 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+/**
+ * 端到端吞吐基准：在同一进程内启动真实的 adapter/driver 组件，
+ * 由合成数据驱动（tests/plugins/bench）按配置的点位数、类型和变化率产生数据，
+ * 经驱动缓存、上报定时器、unix socket 和应用消息队列送达统计用的北向应用。
+ *
+ * 不启动 manager 和 REST 服务，本程序自己绑定 manager 的 socket 并丢弃
+ * 节点发来的控制消息，订阅关系直接在驱动上建立。运行时在临时目录中创建
+ * persistence 和 logs，结束后删除。
+ *
+ * 用法：neuron-bench [options]，结果以一行 JSON 输出到 stdout。
+ */
+
+#define _GNU_SOURCE
+#include <ctype.h>
+#include <errno.h>
+#include <ftw.h>
+#include <getopt.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <neuron.h>
+
+#include "adapter/adapter_internal.h"
+#include "adapter/driver/driver_internal.h"
+#include "base/msg_internal.h"
+#include "core/manager.h"
+#include "persist/persist.h"
+
+#include "bench_plugin.h"
+
+zlog_category_t *neuron            = NULL;
+bool             disable_jwt       = false;
+bool             sub_filter_err    = false;
+int              default_log_level = ZLOG_LEVEL_WARN;
+char             host_port[32]     = { 0 };
+char             g_status[32]      = { 0 };
+
+#define MAX_TYPES 16
+#define MAX_APPS 64
+#define MAX_CORES 1024
+
+struct bench_args {
+    int         groups;
+    int         tags;
+    int         interval;
+    int         change_rate;
+    int         string_length;
+    int         array_size;
+    int         error_rate;
+    bool        filter_err;
+    int         apps;
+    int         duration;
+    int         warmup;
+    int         seed;
+    const char *types;
+    const char *config_dir;
+    const char *log_level;
+};
+
+struct bench_type {
+    const char *name;
+    neu_type_e  type;
+};
+
+static const struct bench_type bench_types[] = {
+    { "int8", NEU_TYPE_INT8 },     { "uint8", NEU_TYPE_UINT8 },
+    { "int16", NEU_TYPE_INT16 },   { "uint16", NEU_TYPE_UINT16 },
+    { "int32", NEU_TYPE_INT32 },   { "uint32", NEU_TYPE_UINT32 },
+    { "int64", NEU_TYPE_INT64 },   { "uint64", NEU_TYPE_UINT64 },
+    { "float", NEU_TYPE_FLOAT },   { "double", NEU_TYPE_DOUBLE },
+    { "bool", NEU_TYPE_BOOL },     { "bit", NEU_TYPE_BIT },
+    { "string", NEU_TYPE_STRING }, { "bytes", NEU_TYPE_BYTES },
+    { "int8s", NEU_TYPE_ARRAY_INT8 },     { "uint8s", NEU_TYPE_ARRAY_UINT8 },
+    { "int16s", NEU_TYPE_ARRAY_INT16 },   { "uint16s", NEU_TYPE_ARRAY_UINT16 },
+    { "int32s", NEU_TYPE_ARRAY_INT32 },   { "uint32s", NEU_TYPE_ARRAY_UINT32 },
+    { "int64s", NEU_TYPE_ARRAY_INT64 },   { "uint64s", NEU_TYPE_ARRAY_UINT64 },
+    { "floats", NEU_TYPE_ARRAY_FLOAT },   { "doubles", NEU_TYPE_ARRAY_DOUBLE },
+    { "bools", NEU_TYPE_ARRAY_BOOL },
+};
+
+struct cpu_sample {
+    int                n_core;
+    unsigned long long busy[MAX_CORES];
+    unsigned long long total[MAX_CORES];
+    double             process; // 进程用户态加内核态 CPU 时间，秒
+    int64_t            wall_ns;
+};
+
+static volatile bool manager_exit = false;
+
+/**
+ * 本程序不启动 manager，端口分配规则与 manager 相同。
+ */
+uint16_t neu_manager_get_port()
+{
+    static uint16_t port = 10000;
+    return port++;
+}
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -g, --groups <n>         groups, default 10\n"
+            "  -t, --tags <n>           tags per group, default 100\n"
+            "  -i, --interval <ms>      group interval, default 100\n"
+            "  -r, --change-rate <pct>  tags changed per cycle, default 10\n"
+            "  -T, --types <list>       comma separated tag types, default "
+            "int16,uint16,int32,uint32,float,double,bool,string\n"
+            "  -s, --string-length <n>  string tag length, default 16\n"
+            "  -A, --array-size <n>     array and bytes tag length, default "
+            "8\n"
+            "  -e, --error-rate <pct>   tags reading an error per cycle, "
+            "default 0\n"
+            "  -F, --filter-err         do not report error values to "
+            "subscribers (sub_filter_err)\n"
+            "  -a, --apps <n>           sink apps subscribing every group, "
+            "default 1\n"
+            "  -d, --duration <s>       measured seconds, default 10\n"
+            "  -w, --warmup <s>         seconds before measuring, default 2\n"
+            "  -S, --seed <n>           change generator seed, default 1\n"
+            "  -c, --config <dir>       directory of sql schemas, default "
+            "./config\n"
+            "  -l, --log-level <level>  debug|info|notice|warn|error, "
+            "default warn\n",
+            prog);
+}
+
+static int parse_args(int argc, char *argv[], struct bench_args *args)
+{
+    static const struct option long_options[] = {
+        { "groups", required_argument, NULL, 'g' },
+        { "tags", required_argument, NULL, 't' },
+        { "interval", required_argument, NULL, 'i' },
+        { "change-rate", required_argument, NULL, 'r' },
+        { "types", required_argument, NULL, 'T' },
+        { "string-length", required_argument, NULL, 's' },
+        { "array-size", required_argument, NULL, 'A' },
+        { "error-rate", required_argument, NULL, 'e' },
+        { "filter-err", no_argument, NULL, 'F' },
+        { "apps", required_argument, NULL, 'a' },
+        { "duration", required_argument, NULL, 'd' },
+        { "warmup", required_argument, NULL, 'w' },
+        { "seed", required_argument, NULL, 'S' },
+        { "config", required_argument, NULL, 'c' },
+        { "log-level", required_argument, NULL, 'l' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+
+    *args = (struct bench_args){
+        .groups        = 10,
+        .tags          = 100,
+        .interval      = 100,
+        .change_rate   = 10,
+        .string_length = 16,
+        .array_size    = 8,
+        .error_rate    = 0,
+        .filter_err    = false,
+        .apps          = 1,
+        .duration      = 10,
+        .warmup        = 2,
+        .seed          = 1,
+        .types         = "int16,uint16,int32,uint32,float,double,bool,string",
+        .config_dir    = "./config",
+        .log_level     = "warn",
+    };
+
+    int c = 0;
+    while ((c = getopt_long(argc, argv, "g:t:i:r:T:s:A:e:Fa:d:w:S:c:l:h",
+                            long_options, NULL)) != -1) {
+        switch (c) {
+        case 'g':
+            args->groups = atoi(optarg);
+            break;
+        case 't':
+            args->tags = atoi(optarg);
+            break;
+        case 'i':
+            args->interval = atoi(optarg);
+            break;
+        case 'r':
+            args->change_rate = atoi(optarg);
+            break;
+        case 'T':
+            args->types = optarg;
+            break;
+        case 's':
+            args->string_length = atoi(optarg);
+            break;
+        case 'A':
+            args->array_size = atoi(optarg);
+            break;
+        case 'e':
+            args->error_rate = atoi(optarg);
+            break;
+        case 'F':
+            args->filter_err = true;
+            break;
+        case 'a':
+            args->apps = atoi(optarg);
+            break;
+        case 'd':
+            args->duration = atoi(optarg);
+            break;
+        case 'w':
+            args->warmup = atoi(optarg);
+            break;
+        case 'S':
+            args->seed = atoi(optarg);
+            break;
+        case 'c':
+            args->config_dir = optarg;
+            break;
+        case 'l':
+            args->log_level = optarg;
+            break;
+        default:
+            return -1;
+        }
+    }
+
+    if (args->groups <= 0 || args->tags <= 0 || args->interval <= 0 ||
+        args->change_rate < 0 || args->change_rate > 100 ||
+        args->string_length < 0 || args->string_length >= NEU_VALUE_SIZE ||
+        args->array_size < 1 || args->array_size > BENCH_ARRAY_MAX ||
+        args->error_rate < 0 || args->error_rate > 100 ||
+        args->apps <= 0 || args->apps > MAX_APPS || args->duration <= 0 ||
+        args->warmup < 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+static int parse_types(const char *list, neu_type_e *types)
+{
+    char *dup   = strdup(list);
+    char *save  = NULL;
+    int   count = 0;
+
+    for (char *name = strtok_r(dup, ",", &save); name != NULL;
+         name = strtok_r(NULL, ",", &save)) {
+        size_t i = 0;
+        for (; i < sizeof(bench_types) / sizeof(bench_types[0]); i++) {
+            if (strcmp(name, bench_types[i].name) == 0) {
+                break;
+            }
+        }
+        if (i == sizeof(bench_types) / sizeof(bench_types[0]) ||
+            count == MAX_TYPES) {
+            fprintf(stderr, "invalid tag type: %s\n", name);
+            count = -1;
+            break;
+        }
+        types[count++] = bench_types[i].type;
+    }
+
+    free(dup);
+    return count;
+}
+
+static int log_level(const char *name)
+{
+    if (strcmp(name, "debug") == 0) {
+        return ZLOG_LEVEL_DEBUG;
+    } else if (strcmp(name, "info") == 0) {
+        return ZLOG_LEVEL_INFO;
+    } else if (strcmp(name, "notice") == 0) {
+        return ZLOG_LEVEL_NOTICE;
+    } else if (strcmp(name, "error") == 0) {
+        return ZLOG_LEVEL_ERROR;
+    }
+    return ZLOG_LEVEL_WARN;
+}
+
+static int remove_entry(const char *path, const struct stat *sb, int flag,
+                        struct FTW *ftw)
+{
+    (void) sb;
+    (void) flag;
+    (void) ftw;
+    return remove(path);
+}
+
+/**
+ * @brief 在临时目录中准备 persistence、logs 和 zlog 配置，并切换工作目录。
+ */
+static int setup_workdir(char *workdir, char *level)
+{
+    if (mkdtemp(workdir) == NULL || chdir(workdir) != 0 ||
+        mkdir("persistence", 0755) != 0 || mkdir("logs", 0755) != 0) {
+        fprintf(stderr, "prepare %s fail: %s\n", workdir, strerror(errno));
+        return -1;
+    }
+
+    FILE *fp = fopen("bench.conf", "w");
+    if (fp == NULL) {
+        return -1;
+    }
+
+    for (char *p = level; *p; p++) {
+        *p = toupper(*p);
+    }
+    fprintf(fp,
+            "[global]\n"
+            "file perms = 666\n"
+            "[formats]\n"
+            "simple = \"%%d:%%ms [%%V] [%%c] %%f:%%L %%m%%n\"\n"
+            "[rules]\n"
+            "*.%s \"./logs/bench.log\"; simple\n",
+            level);
+    fclose(fp);
+
+    return zlog_init("bench.conf");
+}
+
+/**
+ * @brief 代替 manager 接收节点发往 "\0neuron-manager" 的控制消息并丢弃。
+ */
+static void *manager_drain(void *arg)
+{
+    int fd = *(int *) arg;
+
+    while (!manager_exit) {
+        neu_msg_t *msg = NULL;
+        if (neu_recv_msg(fd, &msg) == 0) {
+            neu_msg_free(msg);
+        }
+    }
+
+    return NULL;
+}
+
+static int manager_socket(void)
+{
+    struct sockaddr_un local = {
+        .sun_family = AF_UNIX,
+        .sun_path   = "#neuron-manager",
+    };
+    struct timeval timeout = {
+        .tv_sec  = 0,
+        .tv_usec = 100 * 1000,
+    };
+
+    local.sun_path[0] = '\0';
+
+    int fd = socket(AF_UNIX, SOCK_DGRAM, 0);
+    if (fd < 0) {
+        return -1;
+    }
+
+    if (setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout)) <
+            0 ||
+        bind(fd, (struct sockaddr *) &local, sizeof(local)) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+static void cpu_sample(struct cpu_sample *sample)
+{
+    struct rusage usage = { 0 };
+    char          line[256];
+
+    sample->wall_ns = neu_time_mono_ns();
+    sample->n_core  = 0;
+
+    getrusage(RUSAGE_SELF, &usage);
+    sample->process = usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+        (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+
+    FILE *fp = fopen("/proc/stat", "r");
+    if (fp == NULL) {
+        return;
+    }
+
+    while (fgets(line, sizeof(line), fp) != NULL &&
+           sample->n_core < MAX_CORES) {
+        unsigned long long v[8] = { 0 };
+        int                core = 0;
+
+        // 只取 cpuN 行，跳过汇总的 cpu 行
+        if (strncmp(line, "cpu", 3) != 0 || line[3] == ' ') {
+            continue;
+        }
+        if (sscanf(line, "cpu%d %llu %llu %llu %llu %llu %llu %llu %llu", &core,
+                   &v[0], &v[1], &v[2], &v[3], &v[4], &v[5], &v[6],
+                   &v[7]) != 9) {
+            continue;
+        }
+
+        unsigned long long total = 0;
+        for (int i = 0; i < 8; i++) {
+            total += v[i];
+        }
+
+        // idle 与 iowait 之外都算忙
+        sample->busy[sample->n_core]  = total - v[3] - v[4];
+        sample->total[sample->n_core] = total;
+        sample->n_core += 1;
+    }
+
+    fclose(fp);
+}
+
+static long status_kb(const char *key)
+{
+    char line[256];
+    long kb  = -1;
+    int  len = strlen(key);
+
+    FILE *fp = fopen("/proc/self/status", "r");
+    if (fp == NULL) {
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), fp) != NULL) {
+        if (strncmp(line, key, len) == 0 && line[len] == ':') {
+            kb = strtol(line + len + 1, NULL, 10);
+            break;
+        }
+    }
+
+    fclose(fp);
+    return kb;
+}
+
+static uint64_t percentile(const uint64_t *latency, uint64_t samples,
+                           double pct)
+{
+    uint64_t rank = (uint64_t)(samples * pct / 100.0);
+    uint64_t seen = 0;
+
+    if (rank >= samples) {
+        rank = samples - 1;
+    }
+
+    for (uint32_t i = 0; i < BENCH_LATENCY_BUCKETS; i++) {
+        seen += latency[i];
+        if (seen > rank) {
+            return bench_latency_value(i);
+        }
+    }
+
+    return 0;
+}
+
+static neu_adapter_t *create_node(const char *name, neu_plugin_module_t *module)
+{
+    neu_adapter_info_t info = {
+        .name   = name,
+        .handle = NULL,
+        .module = module,
+    };
+
+    neu_adapter_t *adapter = neu_adapter_create(&info, false);
+    if (adapter == NULL) {
+        fprintf(stderr, "create node %s fail: %d\n", name,
+                neu_adapter_error());
+    }
+    return adapter;
+}
+
+static void destroy_node(neu_adapter_t *adapter)
+{
+    neu_adapter_stop(adapter);
+    neu_adapter_uninit(adapter);
+    neu_adapter_destroy(adapter);
+}
+
+static int add_tags(neu_adapter_t *node, const struct bench_args *args,
+                    const neu_type_e *types, int n_type)
+{
+    neu_adapter_driver_t *driver = (neu_adapter_driver_t *) node;
+    char group[NEU_GROUP_NAME_LEN] = { 0 };
+    char name[NEU_TAG_NAME_LEN]    = { 0 };
+    char address[16]               = { 0 };
+    int  index                     = 0;
+
+    for (int g = 0; g < args->groups; g++) {
+        snprintf(group, sizeof(group), "group-%d", g);
+        if (neu_adapter_driver_add_group(driver, group, args->interval,
+                                         NULL) != NEU_ERR_SUCCESS) {
+            return -1;
+        }
+
+        for (int t = 0; t <= args->tags; t++) {
+            neu_datatag_t tag = {
+                .name      = name,
+                .address   = address,
+                .attribute = NEU_ATTRIBUTE_READ | NEU_ATTRIBUTE_SUBSCRIBE,
+            };
+
+            // 每组最后一个点位是时间戳点位
+            if (t == args->tags) {
+                snprintf(name, sizeof(name), "%s", BENCH_TS_TAG);
+                tag.type = NEU_TYPE_INT64;
+            } else {
+                snprintf(name, sizeof(name), "tag-%d", t);
+                tag.type = types[index++ % n_type];
+            }
+            snprintf(address, sizeof(address), "%d", t);
+
+            if (neu_adapter_driver_add_tag(driver, group, &tag,
+                                           args->interval) !=
+                NEU_ERR_SUCCESS) {
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static void subscribe(neu_adapter_t *node, neu_adapter_t *app,
+                      const struct bench_args *args)
+{
+    neu_adapter_driver_t *driver = (neu_adapter_driver_t *) node;
+    neu_req_subscribe_t   req    = { 0 };
+
+    strcpy(req.app, app->name);
+    strcpy(req.driver, node->name);
+    req.port = neu_adapter_trans_data_port(app);
+
+    for (int g = 0; g < args->groups; g++) {
+        snprintf(req.group, sizeof(req.group), "group-%d", g);
+        neu_adapter_driver_subscribe(driver, &req);
+    }
+}
+
+static void report(const struct bench_args *args, bench_driver_stats_t *d0,
+                   bench_driver_stats_t *d1, bench_sink_stats_t *sink,
+                   struct cpu_sample *c0, struct cpu_sample *c1)
+{
+    double   elapsed = (c1->wall_ns - c0->wall_ns) / 1e9;
+    uint64_t samples = 0;
+    uint64_t max     = 0;
+
+    for (uint32_t i = 0; i < BENCH_LATENCY_BUCKETS; i++) {
+        if (sink->latency[i] > 0) {
+            samples += sink->latency[i];
+            max = bench_latency_value(i);
+        }
+    }
+
+    printf("{\"bench\":\"neuron\",\"groups\":%d,\"tags_per_group\":%d,"
+           "\"interval_ms\":%d,\"change_rate\":%d,\"types\":\"%s\","
+           "\"array_size\":%d,\"error_rate\":%d,\"filter_err\":%s,"
+           "\"apps\":%d,\"duration_s\":%.3f,",
+           args->groups, args->tags, args->interval, args->change_rate,
+           args->types, args->array_size, args->error_rate,
+           args->filter_err ? "true" : "false", args->apps, elapsed);
+
+    printf("\"tags_per_sec\":%.1f,\"msgs_per_sec\":%.1f,"
+           "\"generated_per_sec\":%.1f,\"changed_per_sec\":%.1f,"
+           "\"injected_errors_per_sec\":%.1f,\"error_tags\":%" PRIu64 ",",
+           sink->tags / elapsed, sink->msgs / elapsed,
+           (d1->generated - d0->generated) / elapsed,
+           (d1->changed - d0->changed) / elapsed,
+           (d1->errors - d0->errors) / elapsed, sink->errors);
+
+    if (samples > 0) {
+        printf("\"latency_us\":{\"samples\":%" PRIu64 ",\"p50\":%" PRIu64
+               ",\"p90\":%" PRIu64 ",\"p99\":%" PRIu64 ",\"p999\":%" PRIu64
+               ",\"max\":%" PRIu64 "},",
+               samples, percentile(sink->latency, samples, 50),
+               percentile(sink->latency, samples, 90),
+               percentile(sink->latency, samples, 99),
+               percentile(sink->latency, samples, 99.9), max);
+    } else {
+        printf("\"latency_us\":{\"samples\":0},");
+    }
+
+    printf("\"cpu\":{\"process\":%.1f,\"cores\":[",
+           (c1->process - c0->process) * 100 / elapsed);
+    for (int i = 0; i < c1->n_core && i < c0->n_core; i++) {
+        unsigned long long total = c1->total[i] - c0->total[i];
+        unsigned long long busy  = c1->busy[i] - c0->busy[i];
+
+        printf("%s%.1f", i == 0 ? "" : ",",
+               total > 0 ? busy * 100.0 / total : 0.0);
+    }
+    printf("]},\"rss_kb\":%ld,\"rss_peak_kb\":%ld}\n", status_kb("VmRSS"),
+           status_kb("VmHWM"));
+}
+
+int main(int argc, char *argv[])
+{
+    struct bench_args     args                = { 0 };
+    neu_type_e            types[MAX_TYPES]    = { 0 };
+    char                  config_dir[PATH_MAX] = { 0 };
+    char                  workdir[]            = "/tmp/neuron-bench-XXXXXX";
+    char                  level[16]            = { 0 };
+    char                  setting[256]         = { 0 };
+    neu_adapter_t *       apps[MAX_APPS]       = { 0 };
+    neu_adapter_t *       driver               = NULL;
+    pthread_t             drain_tid            = 0;
+    int                   manager_fd           = -1;
+    int                   rv                   = 1;
+    bench_driver_stats_t  d0                   = { 0 };
+    bench_driver_stats_t  d1                   = { 0 };
+    bench_sink_stats_t *  sink                 = NULL;
+    bench_sink_stats_t *  one                  = NULL;
+    struct cpu_sample *   c0                   = NULL;
+    struct cpu_sample *   c1                   = NULL;
+
+    if (parse_args(argc, argv, &args) != 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    sub_filter_err = args.filter_err;
+
+    int n_type = parse_types(args.types, types);
+    if (n_type <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (realpath(args.config_dir, config_dir) == NULL) {
+        fprintf(stderr, "invalid config dir %s: %s\n", args.config_dir,
+                strerror(errno));
+        return 1;
+    }
+
+    snprintf(level, sizeof(level), "%s", args.log_level);
+    default_log_level = log_level(args.log_level);
+    if (setup_workdir(workdir, level) != 0) {
+        return 1;
+    }
+    neuron = zlog_get_category("neuron");
+
+    if (neu_persister_create(config_dir) != 0) {
+        fprintf(stderr, "create persistence with %s fail\n", config_dir);
+        goto remove_workdir;
+    }
+
+    manager_fd = manager_socket();
+    if (manager_fd < 0) {
+        fprintf(stderr,
+                "bind neuron-manager fail: %s, is neuron running on this "
+                "host?\n",
+                strerror(errno));
+        goto destroy_persister;
+    }
+    pthread_create(&drain_tid, NULL, manager_drain, &manager_fd);
+
+    neu_metrics_init();
+
+    driver = create_node("bench-driver",
+                         (neu_plugin_module_t *) &bench_driver_module);
+    if (driver == NULL) {
+        goto stop_manager;
+    }
+
+    if (add_tags(driver, &args, types, n_type) != 0) {
+        fprintf(stderr, "add tags fail\n");
+        goto destroy_nodes;
+    }
+
+    for (int i = 0; i < args.apps; i++) {
+        char name[NEU_NODE_NAME_LEN] = { 0 };
+
+        snprintf(name, sizeof(name), "bench-sink-%d", i);
+        apps[i] =
+            create_node(name, (neu_plugin_module_t *) &bench_sink_module);
+        if (apps[i] == NULL || neu_adapter_set_setting(apps[i], "{}") != 0) {
+            goto destroy_nodes;
+        }
+        subscribe(driver, apps[i], &args);
+    }
+
+    // 设置驱动配置后节点进入运行状态，开始采集和上报
+    snprintf(setting, sizeof(setting),
+             "{\"params\":{\"change_rate\":%d,\"string_length\":%d,"
+             "\"seed\":%d,\"array_size\":%d,\"error_rate\":%d}}",
+             args.change_rate, args.string_length, args.seed,
+             args.array_size, args.error_rate);
+    if (neu_adapter_set_setting(driver, setting) != 0) {
+        fprintf(stderr, "set driver setting fail\n");
+        goto destroy_nodes;
+    }
+
+    sleep(args.warmup);
+
+    sink = calloc(1, sizeof(bench_sink_stats_t));
+    one  = calloc(1, sizeof(bench_sink_stats_t));
+    c0   = calloc(1, sizeof(struct cpu_sample));
+    c1   = calloc(1, sizeof(struct cpu_sample));
+
+    for (int i = 0; i < args.apps; i++) {
+        bench_sink_reset(apps[i]->plugin);
+    }
+    bench_driver_stats(driver->plugin, &d0);
+    cpu_sample(c0);
+
+    sleep(args.duration);
+
+    cpu_sample(c1);
+    bench_driver_stats(driver->plugin, &d1);
+    for (int i = 0; i < args.apps; i++) {
+        bench_sink_stats(apps[i]->plugin, one);
+        sink->msgs += one->msgs;
+        sink->tags += one->tags;
+        sink->errors += one->errors;
+        for (int j = 0; j < BENCH_LATENCY_BUCKETS; j++) {
+            sink->latency[j] += one->latency[j];
+        }
+    }
+
+    report(&args, &d0, &d1, sink, c0, c1);
+    rv = 0;
+
+    free(sink);
+    free(one);
+    free(c0);
+    free(c1);
+
+destroy_nodes:
+    if (driver != NULL) {
+        destroy_node(driver);
+    }
+    for (int i = 0; i < args.apps; i++) {
+        if (apps[i] != NULL) {
+            destroy_node(apps[i]);
+        }
+    }
+stop_manager:
+    manager_exit = true;
+    pthread_join(drain_tid, NULL);
+    close(manager_fd);
+destroy_persister:
+    neu_persister_destroy();
+remove_workdir:
+    zlog_fini();
+    nftw(workdir, remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+    return rv;
+}
@@ -0,0 +1,290 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+
+/**
+ * SQLite 持久化器吞吐基准：在临时目录的数据库中为一个节点逐条写入、更新、
+ * 写值和删除一组点位，并整体加载一次。与写队列一致，每 --batch 条操作放进
+ * 一个事务提交。
+ *
+ * 用法：persist_bench [options]，每个阶段输出一行 JSON。
+ */
+
+#define _GNU_SOURCE
+
+#include <errno.h>
+#include <ftw.h>
+#include <getopt.h>
+#include <limits.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <sqlite3.h>
+
+#include <neuron.h>
+
+#include "persist/sqlite.h"
+#include "utils/time.h"
+
+zlog_category_t *neuron = NULL;
+
+#define BENCH_DRIVER "bench-driver"
+#define BENCH_GROUP "bench-group"
+
+struct bench_args {
+    int         tags;
+    int         batch;
+    const char *config_dir;
+};
+
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+            "usage: %s [options]\n"
+            "  -t, --tags <n>      tags to write, default 100000\n"
+            "  -b, --batch <n>     operations per transaction, default 1000\n"
+            "  -c, --config <dir>  directory of sql schemas, default "
+            "./config\n",
+            prog);
+}
+
+static int parse_args(int argc, char *argv[], struct bench_args *args)
+{
+    static const struct option long_options[] = {
+        { "tags", required_argument, NULL, 't' },
+        { "batch", required_argument, NULL, 'b' },
+        { "config", required_argument, NULL, 'c' },
+        { "help", no_argument, NULL, 'h' },
+        { NULL, 0, NULL, 0 },
+    };
+
+    *args = (struct bench_args){
+        .tags       = 100000,
+        .batch      = 1000,
+        .config_dir = "./config",
+    };
+
+    int c = 0;
+    while ((c = getopt_long(argc, argv, "t:b:c:h", long_options, NULL)) !=
+           -1) {
+        switch (c) {
+        case 't':
+            args->tags = atoi(optarg);
+            break;
+        case 'b':
+            args->batch = atoi(optarg);
+            break;
+        case 'c':
+            args->config_dir = optarg;
+            break;
+        default:
+            return -1;
+        }
+    }
+
+    if (args->tags <= 0 || args->batch <= 0) {
+        return -1;
+    }
+
+    return 0;
+}
+
+static int remove_entry(const char *path, const struct stat *sb, int flag,
+                        struct FTW *ftw)
+{
+    (void) sb;
+    (void) flag;
+    (void) ftw;
+    return remove(path);
+}
+
+static void make_tag(neu_datatag_t *tag, char *name, char *address, int i,
+                     int round)
+{
+    snprintf(name, NEU_TAG_NAME_LEN, "tag-%d", i);
+    snprintf(address, NEU_TAG_ADDRESS_LEN, "1!4%04d", (i + round) % 10000);
+
+    *tag = (neu_datatag_t){
+        .name        = name,
+        .address     = address,
+        .attribute   = NEU_ATTRIBUTE_READ,
+        .type        = NEU_TYPE_INT16,
+        .precision   = 0,
+        .decimal     = round,
+        .bias        = 0,
+        .description = "",
+    };
+}
+
+typedef int (*bench_op_fn)(neu_persister_t *persister, int i);
+
+static int op_store_tag(neu_persister_t *persister, int i)
+{
+    char          name[NEU_TAG_NAME_LEN]       = { 0 };
+    char          address[NEU_TAG_ADDRESS_LEN] = { 0 };
+    neu_datatag_t tag                          = { 0 };
+
+    make_tag(&tag, name, address, i, 0);
+    return persister->vtbl->store_tag(persister, BENCH_DRIVER, BENCH_GROUP,
+                                      &tag);
+}
+
+static int op_update_tag(neu_persister_t *persister, int i)
+{
+    char          name[NEU_TAG_NAME_LEN]       = { 0 };
+    char          address[NEU_TAG_ADDRESS_LEN] = { 0 };
+    neu_datatag_t tag                          = { 0 };
+
+    make_tag(&tag, name, address, i, 1);
+    return persister->vtbl->update_tag(persister, BENCH_DRIVER, BENCH_GROUP,
+                                       &tag);
+}
+
+static int op_update_tag_value(neu_persister_t *persister, int i)
+{
+    char          name[NEU_TAG_NAME_LEN]       = { 0 };
+    char          address[NEU_TAG_ADDRESS_LEN] = { 0 };
+    neu_datatag_t tag                          = { 0 };
+
+    make_tag(&tag, name, address, i, 1);
+    return persister->vtbl->update_tag_value(persister, BENCH_DRIVER,
+                                             BENCH_GROUP, &tag);
+}
+
+static int op_delete_tag(neu_persister_t *persister, int i)
+{
+    char name[NEU_TAG_NAME_LEN] = { 0 };
+
+    snprintf(name, sizeof(name), "tag-%d", i);
+    return persister->vtbl->delete_tag(persister, BENCH_DRIVER, BENCH_GROUP,
+                                       name);
+}
+
+static void report(const char *phase, int n, int failed, int64_t ns)
+{
+    printf("{\"phase\":\"%s\",\"ops\":%d,\"failed\":%d,\"ns_per_op\":%.1f,"
+           "\"ops_per_sec\":%.0f}\n",
+           phase, n, failed, (double) ns / n, n * 1e9 / (ns > 0 ? ns : 1));
+}
+
+static int run(neu_persister_t *persister, const struct bench_args *args,
+               const char *phase, bench_op_fn op)
+{
+    sqlite3 *db     = persister->vtbl->native_handle(persister);
+    int      failed = 0;
+    int64_t  start  = neu_time_mono_ns();
+
+    for (int i = 0; i < args->tags; i += args->batch) {
+        sqlite3_exec(db, "BEGIN", NULL, NULL, NULL);
+        for (int j = i; j < i + args->batch && j < args->tags; j++) {
+            if (0 != op(persister, j)) {
+                failed += 1;
+            }
+        }
+        sqlite3_exec(db, "COMMIT", NULL, NULL, NULL);
+    }
+
+    report(phase, args->tags, failed, neu_time_mono_ns() - start);
+    return failed;
+}
+
+static int run_load(neu_persister_t *persister, const struct bench_args *args)
+{
+    UT_array *group_tags = NULL;
+    int64_t   start      = neu_time_mono_ns();
+    int       n          = 0;
+
+    if (0 != persister->vtbl->load_node_tags(persister, BENCH_DRIVER,
+                                             &group_tags)) {
+        return -1;
+    }
+
+    utarray_foreach(group_tags, neu_persist_group_tags_t *, gt)
+    {
+        n += utarray_len(gt->tags);
+    }
+    utarray_free(group_tags);
+
+    report("load_node_tags", args->tags, args->tags - n,
+           neu_time_mono_ns() - start);
+    return n == args->tags ? 0 : -1;
+}
+
+int main(int argc, char *argv[])
+{
+    struct bench_args        args                 = { 0 };
+    char                     config_dir[PATH_MAX] = { 0 };
+    char                     workdir[]            = "/tmp/persist-bench-XXXXXX";
+    neu_persister_t *        persister            = NULL;
+    neu_persist_node_info_t  node                 = { 0 };
+    neu_persist_group_info_t group                = { 0 };
+    int                      rv                   = 1;
+
+    if (parse_args(argc, argv, &args) != 0) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    if (realpath(args.config_dir, config_dir) == NULL) {
+        fprintf(stderr, "invalid config dir %s: %s\n", args.config_dir,
+                strerror(errno));
+        return 1;
+    }
+
+    if (mkdtemp(workdir) == NULL || chdir(workdir) != 0 ||
+        mkdir("persistence", 0755) != 0) {
+        fprintf(stderr, "prepare %s fail: %s\n", workdir, strerror(errno));
+        return 1;
+    }
+
+    persister = neu_sqlite_persister_create(config_dir);
+    if (persister == NULL) {
+        fprintf(stderr, "create persistence with %s fail\n", config_dir);
+        goto remove_workdir;
+    }
+
+    node.name        = BENCH_DRIVER;
+    node.plugin_name = "Modbus TCP";
+    node.type        = NEU_NA_TYPE_DRIVER;
+    node.state       = NEU_NODE_RUNNING_STATE_INIT;
+    group.name       = BENCH_GROUP;
+    group.interval   = 1000;
+    if (0 != persister->vtbl->store_node(persister, &node) ||
+        0 != persister->vtbl->store_group(persister, BENCH_DRIVER, &group,
+                                          NULL)) {
+        fprintf(stderr, "store node fail\n");
+        goto destroy_persister;
+    }
+
+    if (0 == run(persister, &args, "store_tag", op_store_tag) &&
+        0 == run(persister, &args, "update_tag", op_update_tag) &&
+        0 == run(persister, &args, "update_tag_value", op_update_tag_value) &&
+        0 == run_load(persister, &args) &&
+        0 == run(persister, &args, "delete_tag", op_delete_tag)) {
+        rv = 0;
+    }
+
+destroy_persister:
+    persister->vtbl->destroy(persister);
+remove_workdir:
+    nftw(workdir, remove_entry, 16, FTW_DEPTH | FTW_PHYS);
+    return rv;
+}
@@ -1,5 +1,7 @@
 import subprocess
 import select
+import socket
+import threading
 import fcntl
 import re
 import os
@@ -379,6 +381,28 @@ hold_int16_slave100_1 = [{"name": "hold_int16_100_1", "address": "100!400001",
 hold_int16_slave100_2 = [{"name": "hold_int16_100_2", "address": "100!400003",
                "attribute": config.NEU_TAG_ATTRIBUTE_RW_SUBSCRIBE, "type": config.NEU_TYPE_INT16}]
 
+
+def start_silent_slave(port):
+    # accepts modbus tcp connections and never answers
+    server = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    server.setsockopt(socket.SOL_SOCKET, socket.SO_REUSEADDR, 1)
+    server.bind(('127.0.0.1', port))
+    server.listen(1)
+
+    def serve():
+        conns = []
+        while True:
+            try:
+                conns.append(server.accept()[0])
+            except OSError:
+                break
+        for conn in conns:
+            conn.close()
+
+    threading.Thread(target=serve, daemon=True).start()
+    return server
+
+
 class TestModbus:
 
     @description(given="created modbus node", when="add multiple tags", then="add success")
@@ -1494,12 +1518,45 @@ class TestModbus:
         response = api.write_gtags(json=modbus_write_gtags)
         assert 200 == response.status_code
         assert error.NEU_ERR_SUCCESS == response.json()['error']
+        # results follow the request order, a tag keeps its own group
+        assert [(g['group'], t['tag']) for g in modbus_write_gtags['groups'] for t in g['tags']] == [
+            (t['group'], t['name']) for t in response.json()['tags']]
         time.sleep(0.3)
         assert 1 == api.read_tag(
             node=param[0], group='group', tag=hold_uint16[0]['name'])
         assert 1 == api.read_tag(
             node=param[0], group='group1', tag=hold_int16[0]['name'])
 
+    @description(given="created modbus node on a slave that does not respond", when="write tags", then="error status with per-tag results")
+    def test_write_tags_device_not_response(self, param):
+        if param[0] != 'modbus-tcp':
+            pytest.skip("modbus tcp only")
+        node = param[0] + "_silent"
+        port = random_port()
+        server = start_silent_slave(port)
+        try:
+            response = api.add_node(node=node, plugin=param[1])
+            assert 200 == response.status_code
+            response = api.modbus_tcp_node_setting(
+                node=node, port=port, timeout=1000, max_retries=0)
+            assert 200 == response.status_code
+            response = api.add_group(node=node, group='group')
+            assert 200 == response.status_code
+            api.add_tags_check(node=node, group='group',
+                               tags=hold_int16 + hold_uint16)
+            time.sleep(0.5)
+
+            response = api.write_tags(node=node, group='group', tag_values=[
+                {"tag": hold_int16[0]['name'], "value": 1}, {"tag": hold_uint16[0]['name'], "value": 2}])
+            assert 504 == response.status_code
+            assert error.NEU_ERR_PLUGIN_DEVICE_NOT_RESPONSE == response.json()[
+                'error']
+            assert [{"group": "group", "name": hold_int16[0]['name'], "error": error.NEU_ERR_PLUGIN_DEVICE_NOT_RESPONSE},
+                    {"group": "group", "name": hold_uint16[0]['name'], "error": error.NEU_ERR_PLUGIN_DEVICE_NOT_RESPONSE}] == response.json()['tags']
+        finally:
+            api.del_node(node=node)
+            server.close()
+
     @description(given="created modbus device_error_test node/tag", when="read tag", then="read failed")
     def test_read_modbus_device_err(self, param):
         if param[0] == 'modbus-rtu-tty':
@@ -1510,6 +1567,14 @@ class TestModbus:
         assert error.NEU_ERR_PLUGIN_READ_FAILURE == api.read_tag_err(
             node=param[0], group='group', tag=hold_int16_device_err[0]['name'])
 
+    @description(given="created modbus rtu node on a serial link", when="get driver metrics", then="bus utilization is reported")
+    def test_modbus_rtu_bus_utilization(self, param):
+        if param[0] != 'modbus-rtu-tty':
+            pytest.skip("serial link only")
+        resp = api.get_metrics(category="driver", node=param[0])
+        assert 200 == resp.status_code
+        assert 'bus_utilization_percent' in resp.content.decode('utf-8')
+
     @description(given="created modbus node", when="create modbus retry_test tag, write and read tag", then="read/write success after retrying")
     def test_read_tag_retry(self, param):
         if param[0] == 'modbus-rtu-tty':
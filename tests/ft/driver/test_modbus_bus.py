@@ -0,0 +1,167 @@
+import os
+import select
+import struct
+import subprocess
+import threading
+import tty
+
+from prometheus_client.parser import text_string_to_metric_families
+
+import neuron.api as api
+import neuron.config as config
+from neuron.common import *
+from driver.test_modbus import start_socat
+
+node = 'modbus-bus'
+group = 'bus'
+
+# 1200 8N1: 10 bits per character, t3.5 = 3.5 * 10 / 1200 s
+baud_1200 = 8
+t35 = 7 * 10 / (2 * 1200)
+
+# 6 个从站各一个点位，每个从站一条读命令
+n_slave = 6
+tags = [{"name": f"slave{i}", "address": f"{i}!400001",
+         "attribute": config.NEU_TAG_ATTRIBUTE_READ, "type": config.NEU_TYPE_INT16}
+        for i in range(1, n_slave + 1)]
+
+
+def crc16(data):
+    crc = 0xFFFF
+    for b in data:
+        crc ^= b
+        for _ in range(8):
+            crc = (crc >> 1) ^ 0xA001 if crc & 1 else crc >> 1
+    return struct.pack('<H', crc)
+
+
+class RtuSlave(threading.Thread):
+    """
+    在 pty 上应答 03 读保持寄存器请求，记录每个请求第一个字节到达的时刻与
+    对应响应开始写入的时刻。
+    """
+
+    def __init__(self, dev, delay):
+        super().__init__(daemon=True)
+        self.fd = os.open(dev, os.O_RDWR | os.O_NOCTTY)
+        tty.setraw(self.fd)
+        self.delay = delay
+        self.frames = []  # (slave, request_time, response_done_time)
+        self.lock = threading.Lock()
+        self.running = True
+
+    def run(self):
+        buf = b''
+        start = 0
+        while self.running:
+            ready, _, _ = select.select([self.fd], [], [], 0.1)
+            if not ready:
+                continue
+            data = os.read(self.fd, 256)
+            if not buf:
+                start = time.monotonic()
+            buf += data
+            if len(buf) < 8:
+                continue
+
+            req, buf = buf[:8], buf[8:]
+            slave, qty = req[0], struct.unpack('>H', req[4:6])[0]
+            time.sleep(self.delay)
+            resp = bytes([slave, 0x03, qty * 2]) + b'\x00' * (qty * 2)
+            # 在写之前取时刻，保证不晚于 neuron 收到响应的时刻
+            done = time.monotonic()
+            os.write(self.fd, resp + crc16(resp))
+            with self.lock:
+                self.frames.append((slave, start, done))
+
+    def take(self):
+        with self.lock:
+            frames, self.frames = self.frames, []
+        return frames
+
+    def stop(self):
+        self.running = False
+        self.join()
+        os.close(self.fd)
+
+
+@pytest.fixture(scope='class')
+def slave():
+    socat_proc, neuron_dev, slave_dev = start_socat()
+    s = RtuSlave(slave_dev, 0.04)
+    s.neuron_dev = neuron_dev
+    s.start()
+
+    response = api.add_node(node=node, plugin=config.PLUGIN_MODBUS_RTU)
+    assert 200 == response.status_code
+    response = api.add_group(node=node, group=group, interval=100)
+    assert 200 == response.status_code
+    api.add_tags_check(node=node, group=group, tags=tags)
+    response = api.modbus_rtu_node_setting(
+        node=node, interval=0, device=neuron_dev, link=0, baud=baud_1200)
+    assert 200 == response.status_code
+
+    yield s
+
+    api.del_node(node)
+    s.stop()
+    socat_proc.terminate()
+    socat_proc.wait()
+
+
+def collect(slave, seconds):
+    slave.take()
+    time.sleep(seconds)
+    frames = slave.take()
+    assert len(frames) > 2 * n_slave
+    return frames
+
+
+def min_gap(frames):
+    return min(b[1] - a[2] for a, b in zip(frames, frames[1:]))
+
+
+def group_last_timer_ms():
+    resp = api.get_metrics(category="driver", node=node)
+    assert 200 == resp.status_code
+    for family in text_string_to_metric_families(resp.content.decode('utf-8')):
+        for sample in family.samples:
+            if sample.name == 'group_last_timer_ms' and sample.labels.get('group') == group:
+                return sample.value
+    raise ValueError("group_last_timer_ms not found")
+
+
+class TestModbusBus:
+
+    @description(given="modbus rtu node on a serial link with interval 0", when="read a group of 6 slaves",
+                 then="each request is sent at least t3.5 after the previous response")
+    def test_t35_gap(self, slave):
+        frames = collect(slave, 3)
+        assert min_gap(frames) >= t35
+
+    @description(given="a group whose commands take longer than the group interval", when="read the group",
+                 then="each cycle gives up the bus after one interval and the deferred commands go first next cycle")
+    def test_edf_order(self, slave):
+        frames = collect(slave, 3)
+        order = [f[0] for f in frames]
+
+        # 按截止时间轮转，任意连续 n_slave 个请求覆盖所有从站，顺序不变
+        for i in range(len(order) - n_slave):
+            assert order[i + n_slave] == order[i]
+        assert set(order[:n_slave]) == set(range(1, n_slave + 1))
+
+        # 每条命令约 70ms，一个周期执行 6 条需要 400ms 以上
+        for _ in range(5):
+            assert group_last_timer_ms() < 300
+            time.sleep(0.3)
+
+    @description(given="modbus rtu node on a serial link with interval 50", when="read the group",
+                 then="the configured interval is used as the frame gap")
+    def test_interval_gap(self, slave):
+        response = api.modbus_rtu_node_setting(
+            node=node, interval=50, device=slave.neuron_dev, link=0, baud=baud_1200)
+        assert 200 == response.status_code
+        time.sleep(1)
+
+        frames = collect(slave, 3)
+        assert min_gap(frames) >= 0.05
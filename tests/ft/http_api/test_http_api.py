@@ -284,6 +284,67 @@ class TestHttp:
         for node in global_config['nodes']:
             api.del_node(node['name'])
 
+    @description(given="running neuron", when="bulk import global config, then dry run an import that deletes the driver", then="dry run reports the diff without changing anything")
+    def test_put_global_config_bulk(self):
+        response = api.put_global_config_bulk(json=global_config)
+        assert 200 == response.status_code
+        assert [] == response.json()['nodes']['delete']
+        assert ['mqtt', 'modbus'] == response.json()['nodes']['add']
+        assert 2 == response.json()['tags']['import']
+
+        response = api.put_global_config_bulk(json=global_config_del_modbus, dry_run=True)
+        assert 200 == response.status_code
+        diff = response.json()
+        assert diff['dry_run']
+        assert [] == diff['nodes']['add']
+        assert ['modbus'] == diff['nodes']['delete']
+        assert ['mqtt'] == diff['nodes']['update']
+        assert {'add': 0, 'delete': 1, 'update': 0} == diff['groups']
+        assert {'add': 0, 'delete': 1, 'update': 0} == diff['subscriptions']
+        assert {'current': 2, 'import': 0} == diff['tags']
+
+        config_data = api.get_global_config().json()
+        assert 2 == len(config_data['nodes'])
+        assert 1 == len(config_data['groups'])
+        assert 1 == len(config_data['subscriptions'])
+
+        response = api.get_global_config_import()
+        assert 200 == response.status_code
+        assert 'done' == response.json()['phase']
+        assert response.json()['dry_run']
+
+        for node in global_config['nodes']:
+            api.del_node(node['name'])
+
+    @description(given="running neuron with an imported config", when="bulk import a config with a tag the driver rejects", then="the import is rolled back and the previous config is kept")
+    def test_put_global_config_bulk_rollback(self):
+        response = api.put_global_config_bulk(json=global_config)
+        assert 200 == response.status_code
+
+        bad_config = copy.deepcopy(global_config)
+        bad_config['nodes'].append({"plugin": "Modbus TCP", "name": "modbus-2"})
+        bad_config['tags'][0]['tags'][1]['address'] = 'invalid'
+        response = api.put_global_config_bulk(json=bad_config)
+        assert error.NEU_ERR_TAG_ADDRESS_FORMAT_INVALID == response.json()['error']
+
+        response = api.get_global_config_import()
+        assert 'failed' == response.json()['phase']
+        assert error.NEU_ERR_TAG_ADDRESS_FORMAT_INVALID == response.json()['error']
+
+        config_data = api.get_global_config().json()
+        assert ['mqtt', 'modbus'] == [node['name'] for node in config_data['nodes']]
+        assert 1 == len(config_data['groups'])
+        assert 1 == len(config_data['tags'])
+        assert ['1!400001', '1!400002'] == [tag['address'] for tag in config_data['tags'][0]['tags']]
+        assert 1 == len(config_data['subscriptions'])
+        assert 2 == len(config_data['settings'])
+
+        response = api.get_nodes(type=config.NEU_NODE_DRIVER)
+        assert ['modbus'] == [node['name'] for node in response.json()['nodes']]
+
+        for node in global_config['nodes']:
+            api.del_node(node['name'])
+
     @description(given="running neuron", when="put drivers with too long node name", then="should fail")
     def test_put_drivers_with_long_node_name(self):
         response = api.put_driver(
@@ -3,6 +3,7 @@ from neuron.config import *
 from neuron.common import *
 from neuron.error import *
 from prometheus_client.parser import text_string_to_metric_families
+from prometheus_client.openmetrics import parser as openmetrics_parser
 
 def assert_metrics(resp_content, expected_metrics):
     metrics_found = {metric: False for metric in expected_metrics}
@@ -143,6 +144,7 @@ class TestMetrics:
             "recv_bytes": (0, {}),
             "tag_reads_total": (0, {}),
             "tag_read_errors_total": (0, {}),
+            "tag_suppressed_updates_total": (0, {}),
             "tags_total": (0, {}),
             "group_tags_total": (0, {"group": "group", "node": "modbus"}),
             "group_last_error_code": (0, {"group": "group", "node": "modbus"}),
@@ -155,4 +157,22 @@ class TestMetrics:
 
         resp = api.get_metrics(category="driver")
         assert 200 == resp.status_code
-        assert_metrics(resp.content.decode('utf-8'), expected_metrics)
\ No newline at end of file
+        assert_metrics(resp.content.decode('utf-8'), expected_metrics)
+
+    @description(given="neuron is started",
+                 when="get metrics in OpenMetrics format with gzip encoding",
+                 then="success")
+    def test_openmetrics_gzip(self):
+        resp = api.get_metrics(category="global", headers={
+            "Accept": "application/openmetrics-text; version=1.0.0",
+            "Accept-Encoding": "gzip"})
+        assert 200 == resp.status_code
+        assert resp.headers['Content-Type'].startswith('application/openmetrics-text')
+        assert 'gzip' == resp.headers.get('Content-Encoding')
+
+        content = resp.content.decode('utf-8')
+        assert content.endswith('# EOF\n')
+        families = {f.name: f for f in openmetrics_parser.text_string_to_metric_families(content)}
+        assert 'counter' == families['event_loop_dispatched'].type
+        assert 'unknown' == families['uptime_seconds'].type
+        assert 0 < families['uptime_seconds'].samples[0].value < 1000
@@ -280,8 +280,8 @@ def unsubscribe_group(app, driver, group):
     return requests.delete(url=config.BASE_URL + "/api/v2/subscribe", headers={"Authorization": config.default_jwt}, json={"app": app, "driver": driver, "group": group})
 
 
-def get_metrics(category="global", node=""):
-    return requests.get(url=config.BASE_URL + "/api/v2/metrics?category=" + category + "&node=" + node, headers={"Authorization": config.default_jwt})
+def get_metrics(category="global", node="", headers=None):
+    return requests.get(url=config.BASE_URL + "/api/v2/metrics?category=" + category + "&node=" + node, headers={"Authorization": config.default_jwt, **(headers or {})})
 
 
 def get_global_config():
@@ -292,6 +292,14 @@ def put_global_config(json):
     return requests.put(url=config.BASE_URL + "/api/v2/global/config", headers={"Authorization": config.default_jwt}, json=json)
 
 
+def put_global_config_bulk(json, dry_run=False):
+    return requests.put(url=config.BASE_URL + "/api/v2/global/config", headers={"Authorization": config.default_jwt}, params={"mode": "bulk", "dry_run": "true" if dry_run else "false"}, json=json)
+
+
+def get_global_config_import():
+    return requests.get(url=config.BASE_URL + "/api/v2/global/config/import", headers={"Authorization": config.default_jwt})
+
+
 @gen_check
 def put_driver(name, plugin, params, groups=[], jwt=config.default_jwt):
     return put_drivers([{"name": name, "plugin": plugin, "params": params, "groups": groups}])
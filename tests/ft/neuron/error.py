@@ -55,6 +55,7 @@ NEU_ERR_TAG_PRECISION_INVALID = 2209
 NEU_ERR_TAG_EXIST = 2210
 NEU_ERR_TAG_DECIMAL_INVALID = 2211
 NEU_ERR_TAG_BIAS_INVALID = 2212
+NEU_ERR_TAG_DEADBAND_INVALID = 2213
 
 NEU_ERR_LIBRARY_NOT_FOUND = 2301
 NEU_ERR_LIBRARY_INFO_INVALID = 2302
@@ -18,6 +18,10 @@ hold_int16_decimal = [{"name": "hold_int16_decimal", "address": "1!400001",
                "attribute": NEU_TAG_ATTRIBUTE_RW, "type": NEU_TYPE_INT16, "decimal": 0.1}]
 hold_int16_bias = [{"name": "hold_int16_bias", "address": "1!400001",
                "attribute": NEU_TAG_ATTRIBUTE_READ, "type": NEU_TYPE_INT16, "bias": 1.0}]
+hold_int16_deadband = [{"name": "hold_int16_deadband", "address": "1!400001",
+               "attribute": NEU_TAG_ATTRIBUTE_READ, "type": NEU_TYPE_INT16,
+               "deadband": {"type": 2, "value": 0.5, "span": 1000,
+                            "hysteresis": 0.1, "heartbeat": 60000}}]
 none= [{"name": "none", "address": "1!400001",
                "attribute": NEU_TAG_ATTRIBUTE_RW, "type": NEU_TYPE_INT16}]
 
@@ -917,3 +921,46 @@ class TestTag:
         assert 400 == response.status_code
         assert NEU_ERR_TAG_DECIMAL_INVALID == response.json()['error']
         assert 1 == response.json()['index']
+
+    @description(
+        given="node group", when="add a tag with deadband", then="add success"
+    )
+    def test_add_tag_with_deadband(self):
+        try:
+            response = api.add_tags(
+                node="modbus-tcp", group="group1", tags=hold_int16_deadband
+            )
+            assert 200 == response.status_code
+            assert NEU_ERR_SUCCESS == response.json()["error"]
+
+            response = api.get_tags(node="modbus-tcp", group="group1")
+            assert 200 == response.status_code
+            assert "hold_int16_deadband" == response.json()["tags"][0]["name"]
+            assert (
+                hold_int16_deadband[0]["deadband"]
+                == response.json()["tags"][0]["deadband"]
+            )
+        finally:
+            api.del_tags(
+                node="modbus-tcp", group="group1", tags=["hold_int16_deadband"]
+            )
+
+    @description(
+        given="node group",
+        when="add a tag with deadband and non-numeral type",
+        then="add fail",
+    )
+    def test_add_tag_with_deadband_and_bad_type(self):
+        tag = {
+            **hold_int16_deadband[0],
+            "address": "1!400001.10",
+            "type": NEU_TYPE_STRING,
+        }
+        try:
+            response = api.add_tags(
+                node="modbus-tcp", group="group1", tags=[tag]
+            )
+            assert 400 == response.status_code
+            assert NEU_ERR_TAG_DEADBAND_INVALID == response.json()["error"]
+        finally:
+            api.del_tags(node="modbus-tcp", group="group1", tags=[tag["name"]])
@@ -0,0 +1,295 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <neuron.h>
+
+#include "errcodes.h"
+#include "json/neu_json_param.h"
+
+#include "bench_plugin.h"
+
+struct neu_plugin {
+    neu_plugin_common_t common;
+
+    bench_gen_t gen;
+
+    bench_driver_stats_t stats;
+};
+
+/**
+ * @brief 组私有数据：每个点位当前的版本号，版本号变化即点位值变化。
+ */
+struct bench_group_data {
+    uint32_t  n_tag;
+    uint32_t *versions;
+};
+
+static neu_plugin_t *driver_open(void);
+
+static int driver_close(neu_plugin_t *plugin);
+static int driver_init(neu_plugin_t *plugin, bool load);
+static int driver_uninit(neu_plugin_t *plugin);
+static int driver_start(neu_plugin_t *plugin);
+static int driver_stop(neu_plugin_t *plugin);
+static int driver_config(neu_plugin_t *plugin, const char *config);
+static int driver_request(neu_plugin_t *plugin, neu_reqresp_head_t *head,
+                          void *data);
+
+static int driver_tag_validator(const neu_datatag_t *tag);
+static int driver_validate_tag(neu_plugin_t *plugin, neu_datatag_t *tag);
+static int driver_group_timer(neu_plugin_t *plugin, neu_plugin_group_t *group);
+static int driver_write(neu_plugin_t *plugin, void *req, neu_datatag_t *tag,
+                        neu_value_u value);
+
+static const neu_plugin_intf_funs_t plugin_intf_funs = {
+    .open    = driver_open,
+    .close   = driver_close,
+    .init    = driver_init,
+    .uninit  = driver_uninit,
+    .start   = driver_start,
+    .stop    = driver_stop,
+    .setting = driver_config,
+    .request = driver_request,
+
+    .driver.validate_tag  = driver_validate_tag,
+    .driver.group_timer   = driver_group_timer,
+    .driver.group_sync    = NULL,
+    .driver.write_tag     = driver_write,
+    .driver.tag_validator = driver_tag_validator,
+    .driver.write_tags    = NULL,
+    .driver.test_read_tag = NULL,
+    .driver.add_tags      = NULL,
+    .driver.load_tags     = NULL,
+    .driver.del_tags      = NULL,
+};
+
+const neu_plugin_module_t bench_driver_module = {
+    .version         = NEURON_PLUGIN_VER_1_0,
+    .schema          = "bench-driver",
+    .module_name     = "bench-driver",
+    .module_descr    = "synthetic driver for neuron-bench",
+    .module_descr_zh = "neuron-bench 合成数据驱动",
+    .intf_funs       = &plugin_intf_funs,
+    .kind            = NEU_PLUGIN_KIND_SYSTEM,
+    .type            = NEU_NA_TYPE_DRIVER,
+    .display         = true,
+    .single          = false,
+};
+
+static void group_free(neu_plugin_group_t *pgp)
+{
+    struct bench_group_data *gd = (struct bench_group_data *) pgp->user_data;
+
+    free(gd->versions);
+    free(gd);
+}
+
+static neu_plugin_t *driver_open(void)
+{
+    neu_plugin_t *plugin = calloc(1, sizeof(neu_plugin_t));
+
+    neu_plugin_common_init(&plugin->common);
+
+    bench_gen_init(&plugin->gen, 1);
+
+    return plugin;
+}
+
+static int driver_close(neu_plugin_t *plugin)
+{
+    free(plugin);
+
+    return 0;
+}
+
+static int driver_init(neu_plugin_t *plugin, bool load)
+{
+    (void) load;
+    (void) plugin;
+
+    return 0;
+}
+
+static int driver_uninit(neu_plugin_t *plugin)
+{
+    (void) plugin;
+
+    return 0;
+}
+
+static int driver_start(neu_plugin_t *plugin)
+{
+    plugin->common.link_state = NEU_NODE_LINK_STATE_CONNECTED;
+
+    return 0;
+}
+
+static int driver_stop(neu_plugin_t *plugin)
+{
+    plugin->common.link_state = NEU_NODE_LINK_STATE_DISCONNECTED;
+
+    return 0;
+}
+
+/**
+ * @brief 配置格式：
+ * {"params": {"change_rate": 10, "string_length": 16, "seed": 1,
+ *             "array_size": 8, "error_rate": 0}}
+ * array_size 与 error_rate 可省略。
+ */
+static int driver_config(neu_plugin_t *plugin, const char *config)
+{
+    char *          err_param     = NULL;
+    neu_json_elem_t change_rate   = { .name = "change_rate",
+                                    .t    = NEU_JSON_INT };
+    neu_json_elem_t string_length = { .name = "string_length",
+                                      .t    = NEU_JSON_INT };
+    neu_json_elem_t seed          = { .name = "seed", .t = NEU_JSON_INT };
+    neu_json_elem_t array_size    = { .name = "array_size",
+                                   .t    = NEU_JSON_INT };
+    neu_json_elem_t error_rate    = { .name = "error_rate",
+                                   .t    = NEU_JSON_INT };
+
+    int ret = neu_parse_param((char *) config, &err_param, 3, &change_rate,
+                              &string_length, &seed);
+    if (ret != 0) {
+        plog_error(plugin, "config: %s, decode error: %s", config, err_param);
+        free(err_param);
+        return -1;
+    }
+
+    if (neu_parse_param((char *) config, NULL, 1, &array_size) != 0) {
+        array_size.v.val_int = 8;
+    }
+    if (neu_parse_param((char *) config, NULL, 1, &error_rate) != 0) {
+        error_rate.v.val_int = 0;
+    }
+
+    if (change_rate.v.val_int < 0 || change_rate.v.val_int > 100 ||
+        string_length.v.val_int < 0 ||
+        string_length.v.val_int >= NEU_VALUE_SIZE ||
+        array_size.v.val_int < 1 || array_size.v.val_int > BENCH_ARRAY_MAX ||
+        error_rate.v.val_int < 0 || error_rate.v.val_int > 100) {
+        plog_error(plugin, "config: %s, invalid param", config);
+        return -1;
+    }
+
+    bench_gen_init(&plugin->gen, seed.v.val_int);
+    plugin->gen.change_rate   = change_rate.v.val_int;
+    plugin->gen.string_length = string_length.v.val_int;
+    plugin->gen.array_size    = array_size.v.val_int;
+    plugin->gen.error_rate    = error_rate.v.val_int;
+
+    return 0;
+}
+
+static int driver_request(neu_plugin_t *plugin, neu_reqresp_head_t *head,
+                          void *data)
+{
+    (void) plugin;
+    (void) head;
+    (void) data;
+
+    return 0;
+}
+
+static int driver_tag_validator(const neu_datatag_t *tag)
+{
+    (void) tag;
+
+    return 0;
+}
+
+static int driver_validate_tag(neu_plugin_t *plugin, neu_datatag_t *tag)
+{
+    (void) plugin;
+    (void) tag;
+
+    return 0;
+}
+
+static int driver_group_timer(neu_plugin_t *plugin, neu_plugin_group_t *group)
+{
+    struct bench_group_data *gd = (struct bench_group_data *) group->user_data;
+    neu_dvalue_t             dvalue    = { 0 };
+    uint64_t                 generated = 0;
+    uint64_t                 changed   = 0;
+    uint64_t                 errors    = 0;
+    uint32_t                 index     = 0;
+
+    if (gd == NULL) {
+        gd        = calloc(1, sizeof(struct bench_group_data));
+        gd->n_tag = utarray_len(group->tags);
+        gd->versions = calloc(gd->n_tag, sizeof(uint32_t));
+
+        group->user_data  = gd;
+        group->group_free = group_free;
+    }
+
+    utarray_foreach(group->tags, neu_datatag_t *, tag)
+    {
+        if (strcmp(tag->name, BENCH_TS_TAG) == 0) {
+            dvalue.type      = NEU_TYPE_INT64;
+            dvalue.value.i64 = neu_time_mono_ns();
+            changed += 1;
+        } else if (bench_gen_next(&plugin->gen, tag->type, index,
+                                  &gd->versions[index], &dvalue)) {
+            changed += 1;
+        } else if (dvalue.type == NEU_TYPE_ERROR) {
+            errors += 1;
+        }
+
+        plugin->common.adapter_callbacks->driver.update(
+            plugin->common.adapter, group->group_name, tag->name, dvalue);
+
+        generated += 1;
+        index += 1;
+    }
+
+    __atomic_fetch_add(&plugin->stats.cycles, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&plugin->stats.generated, generated, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&plugin->stats.changed, changed, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&plugin->stats.errors, errors, __ATOMIC_RELAXED);
+
+    return 0;
+}
+
+static int driver_write(neu_plugin_t *plugin, void *req, neu_datatag_t *tag,
+                        neu_value_u value)
+{
+    (void) tag;
+    (void) value;
+
+    plugin->common.adapter_callbacks->driver.write_response(
+        plugin->common.adapter, req, NEU_ERR_SUCCESS);
+
+    return 0;
+}
+
+void bench_driver_stats(neu_plugin_t *plugin, bench_driver_stats_t *stats)
+{
+    stats->cycles = __atomic_load_n(&plugin->stats.cycles, __ATOMIC_RELAXED);
+    stats->generated =
+        __atomic_load_n(&plugin->stats.generated, __ATOMIC_RELAXED);
+    stats->changed = __atomic_load_n(&plugin->stats.changed, __ATOMIC_RELAXED);
+    stats->errors  = __atomic_load_n(&plugin->stats.errors, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,177 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#include <stdio.h>
+#include <string.h>
+
+#include <neuron.h>
+
+#include "errcodes.h"
+
+#include "bench_plugin.h"
+
+static inline uint64_t next_rand(bench_gen_t *gen)
+{
+    uint64_t x = gen->rand;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+
+    gen->rand = x;
+    return x;
+}
+
+void bench_gen_init(bench_gen_t *gen, uint64_t seed)
+{
+    gen->change_rate   = 100;
+    gen->error_rate    = 0;
+    gen->string_length = 16;
+    gen->array_size    = 8;
+    gen->rand          = seed != 0 ? seed : 1;
+}
+
+/**
+ * 数组元素中只有最后一个与版本号相关，比较时必须扫描整个数组才能发现变化，
+ * 即变化检测的最坏情况。
+ */
+#define FILL_ARRAY(arr, field, ctype, n, index, x)               \
+    do {                                                         \
+        (arr).length = (uint8_t)(n);                             \
+        for (uint32_t i = 0; i + 1 < (n); i++) {                 \
+            (arr).field[i] = (ctype)((index) + i);               \
+        }                                                        \
+        (arr).field[(n) - 1] = (ctype)(x);                        \
+    } while (0)
+
+void bench_gen_value(bench_gen_t *gen, neu_type_e type, uint32_t index,
+                     uint32_t version, neu_dvalue_t *dvalue)
+{
+    uint64_t x = (uint64_t) version * 2654435761u + index;
+    uint32_t n = gen->array_size;
+
+    dvalue->type = type;
+    switch (type) {
+    case NEU_TYPE_INT8:
+    case NEU_TYPE_UINT8:
+        dvalue->value.u8 = (uint8_t) x;
+        break;
+    case NEU_TYPE_INT16:
+    case NEU_TYPE_UINT16:
+    case NEU_TYPE_WORD:
+        dvalue->value.u16 = (uint16_t) x;
+        break;
+    case NEU_TYPE_INT32:
+    case NEU_TYPE_UINT32:
+    case NEU_TYPE_DWORD:
+        dvalue->value.u32 = (uint32_t) x;
+        break;
+    case NEU_TYPE_INT64:
+    case NEU_TYPE_UINT64:
+    case NEU_TYPE_LWORD:
+        dvalue->value.u64 = x;
+        break;
+    case NEU_TYPE_FLOAT:
+        dvalue->value.f32 = (float) (x % 100000) / 10;
+        break;
+    case NEU_TYPE_DOUBLE:
+        dvalue->value.d64 = (double) (x % 10000000) / 1000;
+        break;
+    case NEU_TYPE_BOOL:
+        dvalue->value.boolean = version & 1;
+        break;
+    case NEU_TYPE_BIT:
+        dvalue->value.u8 = version & 1;
+        break;
+    case NEU_TYPE_STRING: {
+        // 取 x 的低位数字右对齐填充，保证每次变化末位都不同
+        char     digits[24] = { 0 };
+        uint32_t len        = gen->string_length;
+        int      n_digit = snprintf(digits, sizeof(digits), "%020" PRIu64, x);
+        uint32_t copy    = len < (uint32_t) n_digit ? len : (uint32_t) n_digit;
+
+        memset(dvalue->value.str, '0', len);
+        memcpy(dvalue->value.str + len - copy, digits + n_digit - copy, copy);
+        dvalue->value.str[len] = '\0';
+        break;
+    }
+    case NEU_TYPE_BYTES:
+        FILL_ARRAY(dvalue->value.bytes, bytes, uint8_t, n, index, x);
+        break;
+    case NEU_TYPE_ARRAY_BOOL:
+        FILL_ARRAY(dvalue->value.bools, bools, bool, n, index & 1, version & 1);
+        break;
+    case NEU_TYPE_ARRAY_INT8:
+        FILL_ARRAY(dvalue->value.i8s, i8s, int8_t, n, index, x);
+        break;
+    case NEU_TYPE_ARRAY_UINT8:
+        FILL_ARRAY(dvalue->value.u8s, u8s, uint8_t, n, index, x);
+        break;
+    case NEU_TYPE_ARRAY_INT16:
+        FILL_ARRAY(dvalue->value.i16s, i16s, int16_t, n, index, x);
+        break;
+    case NEU_TYPE_ARRAY_UINT16:
+        FILL_ARRAY(dvalue->value.u16s, u16s, uint16_t, n, index, x);
+        break;
+    case NEU_TYPE_ARRAY_INT32:
+        FILL_ARRAY(dvalue->value.i32s, i32s, int32_t, n, index, x);
+        break;
+    case NEU_TYPE_ARRAY_UINT32:
+        FILL_ARRAY(dvalue->value.u32s, u32s, uint32_t, n, index, x);
+        break;
+    case NEU_TYPE_ARRAY_INT64:
+        FILL_ARRAY(dvalue->value.i64s, i64s, int64_t, n, index, x);
+        break;
+    case NEU_TYPE_ARRAY_UINT64:
+        FILL_ARRAY(dvalue->value.u64s, u64s, uint64_t, n, index, x);
+        break;
+    case NEU_TYPE_ARRAY_FLOAT:
+        FILL_ARRAY(dvalue->value.f32s, f32s, float, n, index, x % 100000);
+        break;
+    case NEU_TYPE_ARRAY_DOUBLE:
+        FILL_ARRAY(dvalue->value.f64s, f64s, double, n, index, x % 10000000);
+        break;
+    default:
+        dvalue->type      = NEU_TYPE_ERROR;
+        dvalue->value.i32 = NEU_ERR_TAG_TYPE_NOT_SUPPORT;
+        break;
+    }
+}
+
+bool bench_gen_next(bench_gen_t *gen, neu_type_e type, uint32_t index,
+                    uint32_t *version, neu_dvalue_t *dvalue)
+{
+    bool changed = false;
+
+    // 错误注入不改变版本号，恢复后仍输出出错前的值
+    if (*version != 0 && gen->error_rate > 0 &&
+        next_rand(gen) % 100 < gen->error_rate) {
+        dvalue->type      = NEU_TYPE_ERROR;
+        dvalue->value.i32 = NEU_ERR_PLUGIN_READ_FAILURE;
+        return false;
+    }
+
+    // 首个周期全部写入，之后按变化率递增版本号，未变化的点位写入旧值
+    if (*version == 0 || next_rand(gen) % 100 < gen->change_rate) {
+        *version += 1;
+        changed = true;
+    }
+
+    bench_gen_value(gen, type, index, *version, dvalue);
+    return changed;
+}
@@ -0,0 +1,121 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#ifndef _NEU_TEST_PLUGIN_BENCH_H_
+#define _NEU_TEST_PLUGIN_BENCH_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <neuron.h>
+
+/**
+ * @brief 压测专用插件：合成数据的南向驱动和只做统计的北向应用。
+ *
+ * 两个插件以静态库形式直接链接进 neuron-bench，不经过插件目录加载。
+ * 驱动在每个采集周期按配置的变化率更新组内点位，并写入一个时间戳点位
+ * （BENCH_TS_TAG），应用收到该点位时用当前单调时钟减去其值，得到从驱动
+ * 写入缓存到应用收到数据的端到端延迟。
+ */
+
+/** 每个组内的时间戳点位名，类型为 NEU_TYPE_INT64，值为写入时的单调时钟纳秒 */
+#define BENCH_TS_TAG "_ts"
+
+/** 延迟直方图桶数，覆盖 0 到 2^40 微秒，相对误差约 3% */
+#define BENCH_LATENCY_BUCKETS 1280
+
+/** 数组与 bytes 点位的最大元素个数，受 neu_value_u 中 uint8_t length 限制 */
+#define BENCH_ARRAY_MAX 255
+
+/**
+ * @brief 确定性的点位值生成器，给定种子和配置时输出序列完全可复现。
+ *
+ * 每个点位维护一个版本号，版本号变化即点位值变化；值只由类型、点位序号和
+ * 版本号决定，相邻版本的值一定不同。驱动插件和缓存微基准共用该生成器。
+ */
+typedef struct {
+    uint32_t change_rate;   ///< 每个周期每个点位发生变化的概率，百分比
+    uint32_t error_rate;    ///< 每个周期每个点位输出错误值的概率，百分比
+    uint32_t string_length; ///< 字符串点位的长度，小于 NEU_VALUE_SIZE
+    uint32_t array_size;    ///< 数组与 bytes 点位的元素个数，1 到 255
+    uint64_t rand;          ///< xorshift64 状态，由种子初始化
+} bench_gen_t;
+
+/**
+ * @brief 以默认配置初始化生成器：全部变化、无错误、16 字节字符串、
+ * 8 个元素的数组。
+ */
+void bench_gen_init(bench_gen_t *gen, uint64_t seed);
+
+/**
+ * @brief 由点位序号和版本号生成确定的点位值，不支持的类型输出
+ * NEU_ERR_TAG_TYPE_NOT_SUPPORT 错误值。
+ */
+void bench_gen_value(bench_gen_t *gen, neu_type_e type, uint32_t index,
+                     uint32_t version, neu_dvalue_t *dvalue);
+
+/**
+ * @brief 推进一个点位一个周期：按错误率输出 NEU_ERR_PLUGIN_READ_FAILURE
+ * 错误值，否则按变化率决定是否递增版本号并生成对应的值。
+ *
+ * @param[in,out] version 点位当前版本号，初始为 0，首个周期必定变化。
+ * @return 版本号是否递增，即本周期值是否变化；输出错误值时返回 false。
+ */
+bool bench_gen_next(bench_gen_t *gen, neu_type_e type, uint32_t index,
+                    uint32_t *version, neu_dvalue_t *dvalue);
+
+/**
+ * @brief 驱动侧计数，采集线程累加，主线程随时读取。
+ */
+typedef struct {
+    uint64_t cycles;    ///< 已执行的组采集周期数
+    uint64_t generated; ///< 写入缓存的点位值个数（含时间戳点位）
+    uint64_t changed;   ///< 其中值发生变化的个数
+    uint64_t errors;    ///< 其中注入的错误值个数
+} bench_driver_stats_t;
+
+/**
+ * @brief 应用侧计数，消费线程累加，主线程随时读取或清零。
+ */
+typedef struct {
+    uint64_t msgs;   ///< 收到的 NEU_REQRESP_TRANS_DATA 消息数
+    uint64_t tags;   ///< 收到的点位值个数
+    uint64_t errors; ///< 其中类型为 NEU_TYPE_ERROR 的个数
+    uint64_t latency[BENCH_LATENCY_BUCKETS]; ///< 端到端延迟直方图（微秒）
+} bench_sink_stats_t;
+
+extern const neu_plugin_module_t bench_driver_module;
+extern const neu_plugin_module_t bench_sink_module;
+
+void bench_driver_stats(neu_plugin_t *plugin, bench_driver_stats_t *stats);
+
+void bench_sink_stats(neu_plugin_t *plugin, bench_sink_stats_t *stats);
+void bench_sink_reset(neu_plugin_t *plugin);
+
+/**
+ * @brief 延迟直方图的桶映射：小于 64 的值一桶一值，其余按 2 的幂分段，
+ * 每段 32 个子桶。
+ */
+uint32_t bench_latency_bucket(uint64_t us);
+
+/**
+ * @brief 返回桶的代表值（桶区间中点）。
+ */
+uint64_t bench_latency_value(uint32_t bucket);
+
+#endif
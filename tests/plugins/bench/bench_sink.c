@@ -0,0 +1,199 @@
+/**
+ * NEURON IIoT System for Industry 4.0
+ * Copyright (C) 2020-2022 EMQ Technologies Co., Ltd All rights reserved.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 3 of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program; if not, write to the Free Software Foundation,
+ * Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ **/
+#include <stdlib.h>
+#include <string.h>
+
+#include <neuron.h>
+
+#include "errcodes.h"
+
+#include "bench_plugin.h"
+
+struct neu_plugin {
+    neu_plugin_common_t common;
+
+    bench_sink_stats_t stats;
+};
+
+static neu_plugin_t *sink_open(void);
+
+static int sink_close(neu_plugin_t *plugin);
+static int sink_init(neu_plugin_t *plugin, bool load);
+static int sink_uninit(neu_plugin_t *plugin);
+static int sink_start(neu_plugin_t *plugin);
+static int sink_stop(neu_plugin_t *plugin);
+static int sink_config(neu_plugin_t *plugin, const char *config);
+static int sink_request(neu_plugin_t *plugin, neu_reqresp_head_t *head,
+                        void *data);
+
+static const neu_plugin_intf_funs_t plugin_intf_funs = {
+    .open    = sink_open,
+    .close   = sink_close,
+    .init    = sink_init,
+    .uninit  = sink_uninit,
+    .start   = sink_start,
+    .stop    = sink_stop,
+    .setting = sink_config,
+    .request = sink_request,
+};
+
+const neu_plugin_module_t bench_sink_module = {
+    .version         = NEURON_PLUGIN_VER_1_0,
+    .schema          = "bench-sink",
+    .module_name     = "bench-sink",
+    .module_descr    = "counting sink app for neuron-bench",
+    .module_descr_zh = "neuron-bench 统计用北向应用",
+    .intf_funs       = &plugin_intf_funs,
+    .kind            = NEU_PLUGIN_KIND_SYSTEM,
+    .type            = NEU_NA_TYPE_APP,
+    .display         = true,
+    .single          = false,
+};
+
+uint32_t bench_latency_bucket(uint64_t us)
+{
+    if (us < 64) {
+        return (uint32_t) us;
+    }
+
+    uint32_t shift  = 63 - __builtin_clzll(us) - 5;
+    uint32_t bucket = shift * 32 + (uint32_t)(us >> shift);
+
+    return bucket < BENCH_LATENCY_BUCKETS ? bucket : BENCH_LATENCY_BUCKETS - 1;
+}
+
+uint64_t bench_latency_value(uint32_t bucket)
+{
+    if (bucket < 64) {
+        return bucket;
+    }
+
+    uint32_t shift = bucket / 32 - 1;
+    uint64_t low   = (uint64_t)(bucket - shift * 32) << shift;
+
+    return low + ((1ULL << shift) >> 1);
+}
+
+static neu_plugin_t *sink_open(void)
+{
+    neu_plugin_t *plugin = calloc(1, sizeof(neu_plugin_t));
+
+    neu_plugin_common_init(&plugin->common);
+
+    return plugin;
+}
+
+static int sink_close(neu_plugin_t *plugin)
+{
+    free(plugin);
+
+    return 0;
+}
+
+static int sink_init(neu_plugin_t *plugin, bool load)
+{
+    (void) load;
+    (void) plugin;
+
+    return 0;
+}
+
+static int sink_uninit(neu_plugin_t *plugin)
+{
+    (void) plugin;
+
+    return 0;
+}
+
+static int sink_start(neu_plugin_t *plugin)
+{
+    plugin->common.link_state = NEU_NODE_LINK_STATE_CONNECTED;
+
+    return 0;
+}
+
+static int sink_stop(neu_plugin_t *plugin)
+{
+    plugin->common.link_state = NEU_NODE_LINK_STATE_DISCONNECTED;
+
+    return 0;
+}
+
+static int sink_config(neu_plugin_t *plugin, const char *config)
+{
+    (void) plugin;
+    (void) config;
+
+    return 0;
+}
+
+static int sink_request(neu_plugin_t *plugin, neu_reqresp_head_t *head,
+                        void *data)
+{
+    if (head->type != NEU_REQRESP_TRANS_DATA) {
+        return 0;
+    }
+
+    neu_reqresp_trans_data_t *trans_data = (neu_reqresp_trans_data_t *) data;
+    int64_t                   now        = neu_time_mono_ns();
+    uint64_t                  errors     = 0;
+
+    utarray_foreach(trans_data->tags, neu_resp_tag_value_meta_t *, tag_value)
+    {
+        if (tag_value->value.type == NEU_TYPE_ERROR) {
+            errors += 1;
+        } else if (tag_value->value.type == NEU_TYPE_INT64 &&
+                   strcmp(tag_value->tag, BENCH_TS_TAG) == 0) {
+            int64_t  delay = now - tag_value->value.value.i64;
+            uint32_t bucket =
+                bench_latency_bucket(delay > 0 ? delay / 1000 : 0);
+
+            __atomic_fetch_add(&plugin->stats.latency[bucket], 1,
+                               __ATOMIC_RELAXED);
+        }
+    }
+
+    __atomic_fetch_add(&plugin->stats.msgs, 1, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&plugin->stats.tags, utarray_len(trans_data->tags),
+                       __ATOMIC_RELAXED);
+    __atomic_fetch_add(&plugin->stats.errors, errors, __ATOMIC_RELAXED);
+
+    return 0;
+}
+
+void bench_sink_stats(neu_plugin_t *plugin, bench_sink_stats_t *stats)
+{
+    stats->msgs   = __atomic_load_n(&plugin->stats.msgs, __ATOMIC_RELAXED);
+    stats->tags   = __atomic_load_n(&plugin->stats.tags, __ATOMIC_RELAXED);
+    stats->errors = __atomic_load_n(&plugin->stats.errors, __ATOMIC_RELAXED);
+    for (int i = 0; i < BENCH_LATENCY_BUCKETS; i++) {
+        stats->latency[i] =
+            __atomic_load_n(&plugin->stats.latency[i], __ATOMIC_RELAXED);
+    }
+}
+
+void bench_sink_reset(neu_plugin_t *plugin)
+{
+    __atomic_store_n(&plugin->stats.msgs, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&plugin->stats.tags, 0, __ATOMIC_RELAXED);
+    __atomic_store_n(&plugin->stats.errors, 0, __ATOMIC_RELAXED);
+    for (int i = 0; i < BENCH_LATENCY_BUCKETS; i++) {
+        __atomic_store_n(&plugin->stats.latency[i], 0, __ATOMIC_RELAXED);
+    }
+}
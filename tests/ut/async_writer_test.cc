@@ -0,0 +1,348 @@
+#include <dirent.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <arrow/flight/server.h>
+#include <arrow/flight/sql/server.h>
+#include <arrow/record_batch.h>
+#include <arrow/util/config.h>
+
+#include "async_writer.h"
+
+namespace flight    = arrow::flight;
+namespace flightsql = arrow::flight::sql;
+
+// 只计数写入行数的 Flight SQL 服务端，可让接下来几次写入返回不可用
+class TestServer : public flightsql::FlightSqlServerBase {
+public:
+    std::atomic<int64_t> rows{ 0 };
+    std::atomic<int>     puts{ 0 };
+    std::atomic<int>     fail_next{ 0 };
+    std::atomic<bool>    fail_all{ false };
+
+    arrow::Result<flightsql::ActionCreatePreparedStatementResult>
+    CreatePreparedStatement(
+        const flight::ServerCallContext &                   context,
+        const flightsql::ActionCreatePreparedStatementRequest &request) override
+    {
+        (void) context;
+        (void) request;
+
+        return flightsql::ActionCreatePreparedStatementResult{
+            arrow::schema({}), arrow::schema({}), "insert"
+        };
+    }
+
+    arrow::Status ClosePreparedStatement(
+        const flight::ServerCallContext &                  context,
+        const flightsql::ActionClosePreparedStatementRequest &request) override
+    {
+        (void) context;
+        (void) request;
+        return arrow::Status::OK();
+    }
+
+    arrow::Result<int64_t> DoPutPreparedStatementUpdate(
+        const flight::ServerCallContext &         context,
+        const flightsql::PreparedStatementUpdate &command,
+        flight::FlightMessageReader *             reader) override
+    {
+        (void) context;
+        (void) command;
+        return Put(reader);
+    }
+
+#if ARROW_VERSION_MAJOR >= 16
+    arrow::Result<int64_t>
+    DoPutCommandStatementIngest(const flight::ServerCallContext &context,
+                                const flightsql::StatementIngest &command,
+                                flight::FlightMessageReader *reader) override
+    {
+        (void) context;
+        (void) command;
+        return Put(reader);
+    }
+#endif
+
+private:
+    arrow::Result<int64_t> Put(flight::FlightMessageReader *reader)
+    {
+        int64_t n = 0;
+
+        while (true) {
+            ARROW_ASSIGN_OR_RAISE(auto chunk, reader->Next());
+            if (!chunk.data) {
+                break;
+            }
+            n += chunk.data->num_rows();
+        }
+
+        puts += 1;
+        int fail = fail_next.load();
+        while (fail > 0 && !fail_next.compare_exchange_weak(fail, fail - 1)) {
+        }
+        if (fail > 0 || fail_all) {
+            return flight::MakeFlightError(
+                flight::FlightStatusCode::Unavailable, "server down");
+        }
+
+        rows += n;
+        return n;
+    }
+};
+
+class AsyncWriterTest : public testing::Test {
+protected:
+    TestServer          server;
+    async_writer_config config = {};
+    char                spill_dir[64];
+
+    void SetUp() override
+    {
+        auto location = flight::Location::ForGrpcTcp("127.0.0.1", 0);
+        ASSERT_TRUE(location.ok());
+        flight::FlightServerOptions options(location.ValueOrDie());
+        ASSERT_TRUE(server.Init(options).ok());
+
+        strcpy(spill_dir, "/tmp/async_writer_test.XXXXXX");
+        ASSERT_NE(nullptr, mkdtemp(spill_dir));
+
+        config.host              = "127.0.0.1";
+        config.port              = server.port();
+        config.pool_size         = 1;
+        config.batch_rows        = 1000;
+        config.flush_interval_ms = 60000;
+        config.retry_backoff_ms  = 20;
+        config.max_backoff_ms    = 1000;
+    }
+
+    void TearDown() override
+    {
+        (void) server.Shutdown();
+
+        DIR *dir = opendir(spill_dir);
+        if (dir) {
+            for (struct dirent *ent = readdir(dir); ent; ent = readdir(dir)) {
+                std::string path = std::string(spill_dir) + "/" + ent->d_name;
+                if (ent->d_name[0] != '.') {
+                    unlink(path.c_str());
+                }
+            }
+            closedir(dir);
+        }
+        rmdir(spill_dir);
+    }
+
+    size_t spill_count()
+    {
+        size_t n   = 0;
+        DIR *  dir = opendir(spill_dir);
+
+        for (struct dirent *ent = readdir(dir); ent; ent = readdir(dir)) {
+            size_t len = strlen(ent->d_name);
+            if (len > 6 && 0 == strcmp(ent->d_name + len - 6, ".spill")) {
+                n += 1;
+            }
+        }
+        closedir(dir);
+        return n;
+    }
+};
+
+static void insert(AsyncWriter *writer, int count)
+{
+    std::vector<datatag> tags(count);
+
+    for (int i = 0; i < count; ++i) {
+        tags[i].node_name         = "node";
+        tags[i].group_name        = "group";
+        tags[i].tag               = "tag";
+        tags[i].value_type        = FLOAT_TYPE;
+        tags[i].value.float_value = i;
+    }
+    EXPECT_EQ(CLIENT_OK, async_writer_insert(writer, tags.data(), count));
+}
+
+static bool wait_until(std::function<bool()> cond, int timeout_ms)
+{
+    auto deadline = std::chrono::steady_clock::now() +
+        std::chrono::milliseconds(timeout_ms);
+
+    while (!cond()) {
+        if (std::chrono::steady_clock::now() > deadline) {
+            return false;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return true;
+}
+
+TEST_F(AsyncWriterTest, flush_watermark)
+{
+    config.pool_size  = 2;
+    config.batch_rows = 100;
+
+    AsyncWriter *      writer = async_writer_create(&config);
+    async_writer_stats stats  = {};
+
+    // 不足一批且远未到刷新时间，flush 仍需等到这些行写完
+    insert(writer, 10);
+    auto start = std::chrono::steady_clock::now();
+    async_writer_flush(writer);
+    EXPECT_LT(std::chrono::steady_clock::now() - start,
+              std::chrono::seconds(10));
+    EXPECT_EQ(10, server.rows.load());
+
+    // 两个写线程并发写多个批次，需等待调用前入队的所有批次
+    insert(writer, 250);
+    async_writer_flush(writer);
+    EXPECT_EQ(260, server.rows.load());
+
+    async_writer_stats_get(writer, &stats);
+    EXPECT_EQ(0, stats.queue_rows);
+    EXPECT_EQ(260, stats.written_rows);
+    EXPECT_EQ(0, stats.retries);
+
+    // 没有新数据时立即返回
+    async_writer_flush(writer);
+    async_writer_destroy(writer);
+}
+
+TEST_F(AsyncWriterTest, retry_backoff)
+{
+    config.max_retries = 3;
+
+    AsyncWriter *      writer = async_writer_create(&config);
+    async_writer_stats stats  = {};
+
+    // 前两次写入失败，等待 20ms 与 40ms 后第三次成功
+    server.fail_next = 2;
+    insert(writer, 10);
+    auto start = std::chrono::steady_clock::now();
+    async_writer_flush(writer);
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_GE(elapsed, std::chrono::milliseconds(60));
+    EXPECT_EQ(3, server.puts.load());
+    EXPECT_EQ(10, server.rows.load());
+
+    async_writer_stats_get(writer, &stats);
+    EXPECT_EQ(2, stats.retries);
+    EXPECT_EQ(10, stats.written_rows);
+    EXPECT_EQ(0, stats.spilled_rows);
+
+    async_writer_destroy(writer);
+}
+
+TEST_F(AsyncWriterTest, retry_exhausted_drop)
+{
+    config.max_retries = 1;
+
+    AsyncWriter *      writer = async_writer_create(&config);
+    async_writer_stats stats  = {};
+
+    server.fail_all = true;
+    insert(writer, 10);
+    async_writer_flush(writer);
+
+    async_writer_stats_get(writer, &stats);
+    EXPECT_EQ(2, server.puts.load());
+    EXPECT_EQ(1, stats.retries);
+    EXPECT_EQ(0, stats.written_rows);
+    EXPECT_EQ(10, stats.dropped_rows);
+
+    async_writer_destroy(writer);
+}
+
+TEST_F(AsyncWriterTest, spill_replay)
+{
+    config.max_retries       = 0;
+    config.flush_interval_ms = 50;
+    config.spill_dir         = spill_dir;
+
+    AsyncWriter *      writer = async_writer_create(&config);
+    async_writer_stats stats  = {};
+
+    // 写入失败的行落盘
+    server.fail_all = true;
+    insert(writer, 10);
+    async_writer_flush(writer);
+
+    async_writer_stats_get(writer, &stats);
+    EXPECT_EQ(0, server.rows.load());
+    EXPECT_EQ(10, stats.spilled_rows);
+    EXPECT_EQ(1, stats.spill_files);
+    EXPECT_EQ(1, spill_count());
+
+    // 服务端恢复后空闲的写线程重新写入并删除文件
+    server.fail_all = false;
+    EXPECT_TRUE(wait_until([&] { return server.rows == 10; }, 5000));
+    EXPECT_TRUE(wait_until(
+        [&] {
+            async_writer_stats_get(writer, &stats);
+            return stats.spill_files == 0;
+        },
+        5000));
+    EXPECT_EQ(10, stats.replayed_rows);
+    EXPECT_EQ(0, spill_count());
+
+    async_writer_destroy(writer);
+}
+
+TEST_F(AsyncWriterTest, spill_replay_after_restart)
+{
+    config.max_retries       = 0;
+    config.queue_capacity    = 10;
+    config.flush_interval_ms = 50;
+    config.spill_dir         = spill_dir;
+
+    AsyncWriter *      writer = async_writer_create(&config);
+    async_writer_stats stats  = {};
+
+    // 超出队列容量的行直接落盘，退出时写不出去的行也落盘
+    server.fail_all = true;
+    insert(writer, 25);
+    async_writer_destroy(writer);
+    EXPECT_EQ(2, spill_count());
+
+    server.fail_all = false;
+    writer          = async_writer_create(&config);
+    async_writer_stats_get(writer, &stats);
+    EXPECT_EQ(2, stats.spill_files);
+
+    EXPECT_TRUE(wait_until([&] { return server.rows == 25; }, 5000));
+    EXPECT_TRUE(wait_until([&] { return spill_count() == 0; }, 5000));
+    async_writer_stats_get(writer, &stats);
+    EXPECT_EQ(25, stats.replayed_rows);
+
+    async_writer_destroy(writer);
+}
+
+TEST_F(AsyncWriterTest, corrupted_spill_file)
+{
+    config.flush_interval_ms = 50;
+    config.spill_dir         = spill_dir;
+
+    std::string path = std::string(spill_dir) + "/datalayer-0-0.spill";
+    FILE *      fp   = fopen(path.c_str(), "wb");
+    ASSERT_NE(nullptr, fp);
+    fputs("NDL1garbage", fp);
+    fclose(fp);
+
+    AsyncWriter *writer = async_writer_create(&config);
+    EXPECT_TRUE(wait_until([&] { return spill_count() == 0; }, 5000));
+    EXPECT_EQ(0, access((path + ".bad").c_str(), F_OK));
+    EXPECT_EQ(0, server.rows.load());
+
+    async_writer_destroy(writer);
+}
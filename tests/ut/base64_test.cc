@@ -1,3 +1,5 @@
+#include <vector>
+
 #include <gtest/gtest.h>
 
 #include "utils/base64.h"
@@ -26,6 +28,30 @@ TEST(Base64Test, neu_decode64_test)
     EXPECT_EQ(len, strlen(output));
 }
 
+TEST(Base64Test, neu_decode64_to_file_test)
+{
+    std::vector<unsigned char> input(100 * 1024 + 7);
+    for (size_t i = 0; i < input.size(); i++) {
+        input[i] = (unsigned char) (i * 131 + i / 7);
+    }
+    char *b64 = neu_encode64(input.data(), input.size());
+
+    FILE *fp = tmpfile();
+    ASSERT_NE(nullptr, fp);
+    EXPECT_EQ((int64_t) input.size(), neu_decode64_to_file(b64, fp));
+
+    std::vector<unsigned char> output(input.size());
+    rewind(fp);
+    EXPECT_EQ(output.size(), fread(output.data(), 1, output.size(), fp));
+    EXPECT_EQ(input, output);
+    fclose(fp);
+    free(b64);
+
+    fp = tmpfile();
+    EXPECT_EQ(-1, neu_decode64_to_file("aGVs*G8=", fp));
+    fclose(fp);
+}
+
 int main(int argc, char **argv)
 {
     zlog_init("./config/dev.conf");
@@ -1,3 +1,6 @@
+#include <stdio.h>
+#include <unistd.h>
+
 #include <gtest/gtest.h>
 
 #include "neuron.h"
@@ -12,6 +15,142 @@ TEST(cid_parse, cid)
     neu_cid_free(&cid);
 }
 
+static const char *stream_scl =
+    "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+    "<SCL xmlns=\"http://www.iec.ch/61850/2003/SCL\">\n"
+    "  <Private><IED name=\"PRIVATE\"/></Private>\n"
+    "  <IED name=\"IED1\">\n"
+    "    <AccessPoint name=\"S1\"><Server><LDevice inst=\"LD0\">\n"
+    "      <LN0 lnClass=\"LLN0\" lnType=\"LLN0_T\" inst=\"\">\n"
+    "        <DataSet name=\"ds\">\n"
+    "          <FCDA ldInst=\"LD0\" prefix=\"\" lnClass=\"MMXU\" lnInst=\"1\" "
+    "doName=\"PhV.phsA\" daName=\"cVal.mag.f\" fc=\"MX\"/>\n"
+    "          <FCDA ldInst=\"LD0\" prefix=\"\" lnClass=\"GGIO\" lnInst=\"1\" "
+    "doName=\"Ind1\" daName=\"stVal\" fc=\"ST\"/>\n"
+    "        </DataSet>\n"
+    "        <ReportControl name=\"rcb\" rptID=\"rid\" datSet=\"ds\" "
+    "intgPd=\"1000\" buffered=\"true\"><TrgOps dchg=\"true\"/>"
+    "</ReportControl>\n"
+    "      </LN0>\n"
+    "      <LN lnClass=\"MMXU\" inst=\"1\" lnType=\"MMXU_T\" prefix=\"\">\n"
+    "        <DOI name=\"TotW\"><SDI name=\"units\">"
+    "<DAI name=\"SIUnit\"><Val>W</Val></DAI></SDI></DOI>\n"
+    "      </LN>\n"
+    "      <LN lnClass=\"GGIO\" inst=\"1\" lnType=\"GGIO_T\" prefix=\"\">\n"
+    "        <DOI name=\"SPCSO1\"/>\n"
+    "      </LN>\n"
+    "    </LDevice></Server></AccessPoint>\n"
+    "    <AccessPoint name=\"S2\"><Server/></AccessPoint>\n"
+    "  </IED>\n"
+    "  <DataTypeTemplates>\n"
+    "    <LNodeType id=\"LLN0_T\" lnClass=\"LLN0\"/>\n"
+    "    <LNodeType id=\"MMXU_T\" lnClass=\"MMXU\">"
+    "<DO name=\"TotW\" type=\"MV\"/><DO name=\"PhV\" type=\"WYE\"/>"
+    "</LNodeType>\n"
+    "    <LNodeType id=\"GGIO_T\" lnClass=\"GGIO\">"
+    "<DO name=\"Ind1\" type=\"SPS\"/><DO name=\"SPCSO1\" type=\"SPC\"/>"
+    "</LNodeType>\n"
+    "    <DOType id=\"MV\"><DA name=\"mag\" fc=\"MX\" bType=\"Struct\" "
+    "type=\"AV\"/></DOType>\n"
+    "    <DOType id=\"WYE\"><SDO name=\"phsA\" type=\"CMV\"/></DOType>\n"
+    "    <DOType id=\"CMV\"><DA name=\"cVal\" fc=\"MX\" bType=\"Struct\" "
+    "type=\"Vector\"/><DA name=\"q\" fc=\"MX\" bType=\"Quality\"/>"
+    "</DOType>\n"
+    "    <DOType id=\"SPS\"><DA name=\"stVal\" fc=\"ST\" "
+    "bType=\"BOOLEAN\"/></DOType>\n"
+    "    <DOType id=\"SPC\"><DA name=\"Oper\" fc=\"CO\" bType=\"Struct\" "
+    "type=\"Oper\"/></DOType>\n"
+    "    <DAType id=\"Vector\"><BDA name=\"mag\" bType=\"Struct\" "
+    "type=\"AV\"/></DAType>\n"
+    "    <DAType id=\"AV\"><BDA name=\"f\" bType=\"FLOAT32\"/></DAType>\n"
+    "    <DAType id=\"Oper\"><BDA name=\"ctlVal\" bType=\"BOOLEAN\"/>"
+    "<BDA name=\"T\" bType=\"Timestamp\"/></DAType>\n"
+    "  </DataTypeTemplates>\n"
+    "</SCL>\n";
+
+static void write_file(const char *path, const char *content)
+{
+    FILE *fp = fopen(path, "w");
+    ASSERT_NE(nullptr, fp);
+    fputs(content, fp);
+    fclose(fp);
+}
+
+TEST(cid_parse, stream)
+{
+    char path[] = "/tmp/cid_test_XXXXXX";
+    int  fd     = mkstemp(path);
+    ASSERT_LE(0, fd);
+    close(fd);
+    write_file(path, stream_scl);
+
+    cid_t cid = { 0 };
+    ASSERT_EQ(0, neu_cid_parse(path, &cid));
+    unlink(path);
+
+    // 只解析第一个 AccessPoint
+    EXPECT_STREQ("IED1", cid.ied.name);
+    ASSERT_EQ(1, cid.ied.n_access_points);
+    ASSERT_EQ(1, cid.ied.access_points[0].n_ldevices);
+    cid_ldevice_t *ldev = &cid.ied.access_points[0].ldevices[0];
+    ASSERT_EQ(3, ldev->n_lns);
+
+    ASSERT_EQ(1, ldev->lns[0].n_reports);
+    EXPECT_EQ(1000, ldev->lns[0].reports[0].intg_pd);
+    EXPECT_TRUE(ldev->lns[0].reports[0].buffered);
+
+    ASSERT_EQ(1, ldev->lns[1].n_dois);
+    ASSERT_EQ(1, ldev->lns[1].dois[0].n_dais);
+    EXPECT_STREQ("units", ldev->lns[1].dois[0].dais[0].sdi_name);
+    EXPECT_STREQ("SIUnit", ldev->lns[1].dois[0].dais[0].name);
+
+    // FCDA 经 LN、LNodeType、DOType、SDO 与 DAType 解析出基本类型
+    ASSERT_EQ(1, ldev->lns[0].n_datasets);
+    cid_fcda_t *fcdas = ldev->lns[0].datasets[0].fcdas;
+    ASSERT_EQ(2, ldev->lns[0].datasets[0].n_fcda);
+    ASSERT_EQ(2, fcdas[0].n_btypes);
+    EXPECT_EQ(FLOAT32 | 0x80, fcdas[0].btypes[0]);
+    EXPECT_EQ(Quality, fcdas[0].btypes[1]);
+    ASSERT_EQ(1, fcdas[1].n_btypes);
+    EXPECT_EQ(BOOLEAN, fcdas[1].btypes[0]);
+
+    ASSERT_EQ(1, ldev->lns[2].n_dois);
+    ASSERT_EQ(1, ldev->lns[2].dois[0].n_ctls);
+    cid_doi_ctl_t *ctl = &ldev->lns[2].dois[0].ctls[0];
+    EXPECT_EQ(CO, ctl->fc);
+    EXPECT_STREQ("Oper", ctl->da_name);
+    ASSERT_EQ(2, ctl->n_co_types);
+    EXPECT_EQ(BOOLEAN, ctl->co_types[0]);
+    EXPECT_EQ(Timestamp, ctl->co_types[1]);
+
+    neu_cid_free(&cid);
+}
+
+TEST(cid_parse, invalid)
+{
+    char path[] = "/tmp/cid_test_XXXXXX";
+    int  fd     = mkstemp(path);
+    ASSERT_LE(0, fd);
+    close(fd);
+
+    cid_t cid = { 0 };
+
+    // 文件不完整
+    write_file(path, "<SCL><IED name=\"IED1\"><AccessPoint><Server>");
+    EXPECT_EQ(-1, neu_cid_parse(path, &cid));
+
+    write_file(path, "<ICD><IED name=\"IED1\"/></ICD>");
+    EXPECT_EQ(-1, neu_cid_parse(path, &cid));
+
+    // 没有 DataTypeTemplates
+    write_file(path,
+               "<SCL><IED name=\"IED1\"><AccessPoint name=\"S1\"><Server/>"
+               "</AccessPoint></IED></SCL>");
+    EXPECT_EQ(-1, neu_cid_parse(path, &cid));
+
+    unlink(path);
+}
+
 TEST(cid_to_msg, cid)
 {
     cid_t cid = { 0 };
@@ -0,0 +1,657 @@
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <set>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "core/config_import.h"
+#include "core/manager_internal.h"
+#include "core/storage.h"
+#include "persist/persist.h"
+}
+#include "errcodes.h"
+#include "utils/log.h"
+
+zlog_category_t *neuron = NULL;
+
+/*
+ * 管理器的替身：运行中的节点、组与订阅由测试直接给出，节点的加载与卸载只
+ * 修改 g_nodes，其余写入都落到临时目录中的真实 SQLite 持久化存储。
+ */
+static std::vector<std::pair<std::string, int>> g_nodes;
+static std::vector<neu_resp_driver_group_info_t> g_groups;
+static std::vector<neu_resp_subscribe_info_t>    g_subs;
+static std::string                               g_bad_tag;
+static int                                       g_n_reload;
+
+static const UT_icd node_icd  = { sizeof(neu_resp_node_info_t), NULL, NULL,
+                                 NULL };
+static const UT_icd group_icd = { sizeof(neu_resp_driver_group_info_t), NULL,
+                                  NULL, NULL };
+static const UT_icd sub_icd   = { sizeof(neu_resp_subscribe_info_t), NULL,
+                                NULL, NULL };
+
+extern "C" {
+
+int neu_plugin_manager_find(neu_plugin_manager_t *mgr, const char *plugin_name,
+                            neu_resp_plugin_info_t *info)
+{
+    (void) mgr;
+
+    if (0 == strcmp(plugin_name, "driver")) {
+        info->type = NEU_NA_TYPE_DRIVER;
+    } else if (0 == strcmp(plugin_name, "app")) {
+        info->type = NEU_NA_TYPE_APP;
+    } else {
+        return -1;
+    }
+    info->single = false;
+    return 0;
+}
+
+UT_array *neu_node_manager_get(neu_node_manager_t *mgr, int type)
+{
+    UT_array *nodes = NULL;
+
+    (void) mgr;
+    utarray_new(nodes, &node_icd);
+    for (auto &node : g_nodes) {
+        if (node.second == type) {
+            neu_resp_node_info_t info = {};
+            strcpy(info.node, node.first.c_str());
+            utarray_push_back(nodes, &info);
+        }
+    }
+    return nodes;
+}
+
+bool neu_node_manager_is_single(neu_node_manager_t *mgr, const char *name)
+{
+    (void) mgr;
+    (void) name;
+    return false;
+}
+
+neu_adapter_t *neu_node_manager_find(neu_node_manager_t *mgr, const char *name)
+{
+    (void) mgr;
+
+    for (auto &node : g_nodes) {
+        if (node.first == name) {
+            return (neu_adapter_t *) &node;
+        }
+    }
+    return NULL;
+}
+
+UT_array *neu_subscribe_manager_get(neu_subscribe_mgr_t *mgr, const char *app,
+                                    const char *driver, const char *group)
+{
+    UT_array *subs = NULL;
+
+    (void) mgr;
+    (void) driver;
+    (void) group;
+    utarray_new(subs, &sub_icd);
+    for (auto &sub : g_subs) {
+        if (0 == strcmp(sub.app, app)) {
+            utarray_push_back(subs, &sub);
+        }
+    }
+    return subs;
+}
+
+UT_array *neu_manager_get_driver_group(neu_manager_t *manager)
+{
+    UT_array *groups = NULL;
+
+    (void) manager;
+    utarray_new(groups, &group_icd);
+    for (auto &group : g_groups) {
+        utarray_push_back(groups, &group);
+    }
+    return groups;
+}
+
+int neu_adapter_get_setting(neu_adapter_t *adapter, char **config)
+{
+    (void) adapter;
+    *config = strdup("{}");
+    return 0;
+}
+
+int neu_adapter_driver_validate_tag(neu_adapter_driver_t *driver,
+                                    const char *group, neu_datatag_t *tag)
+{
+    (void) driver;
+    (void) group;
+    return g_bad_tag == tag->name ? NEU_ERR_TAG_ADDRESS_FORMAT_INVALID : 0;
+}
+
+int neu_manager_remove_node(neu_manager_t *manager, const char *node)
+{
+    (void) manager;
+
+    for (auto it = g_nodes.begin(); it != g_nodes.end(); ++it) {
+        if (it->first == node) {
+            g_nodes.erase(it);
+            return 0;
+        }
+    }
+    return NEU_ERR_NODE_NOT_EXIST;
+}
+
+int neu_manager_load_nodes(neu_manager_t *manager, UT_array *node_infos)
+{
+    (void) manager;
+
+    utarray_foreach(node_infos, neu_persist_node_info_t *, info)
+    {
+        g_nodes.emplace_back(info->name, info->type);
+    }
+    return 0;
+}
+
+int manager_load_node(neu_manager_t *manager)
+{
+    UT_array *node_infos = NULL;
+
+    g_n_reload += 1;
+    if (0 != neu_persister_load_nodes(&node_infos)) {
+        return -1;
+    }
+    neu_manager_load_nodes(manager, node_infos);
+    utarray_free(node_infos);
+    return 0;
+}
+
+int manager_load_subscribe(neu_manager_t *manager)
+{
+    (void) manager;
+    return 0;
+}
+
+int neu_manager_subscribe(neu_manager_t *manager, const char *app,
+                          const char *driver, const char *group,
+                          const char *params, const char *static_tags,
+                          uint16_t *app_port)
+{
+    (void) manager;
+    (void) app;
+    (void) driver;
+    (void) group;
+    (void) params;
+    (void) static_tags;
+    *app_port = 0;
+    return 0;
+}
+
+int neu_manager_send_subscribe(neu_manager_t *manager, const char *app,
+                               const char *driver, const char *group,
+                               uint16_t app_port, const char *params,
+                               const char *static_tags)
+{
+    (void) manager;
+    (void) app;
+    (void) driver;
+    (void) group;
+    (void) app_port;
+    (void) params;
+    (void) static_tags;
+    return 0;
+}
+}
+
+static neu_datatag_t make_tag(const char *name)
+{
+    neu_datatag_t tag = {};
+
+    tag.name        = strdup(name);
+    tag.address     = strdup("1!400001");
+    tag.description = strdup("");
+    tag.type        = NEU_TYPE_INT16;
+    tag.attribute   = NEU_ATTRIBUTE_READ;
+    return tag;
+}
+
+static neu_req_driver_t make_node(const char *name, const char *plugin,
+                                  const char *setting)
+{
+    neu_req_driver_t node = {};
+
+    node.node    = strdup(name);
+    node.plugin  = strdup(plugin);
+    node.setting = setting ? strdup(setting) : NULL;
+    return node;
+}
+
+static void add_group(neu_req_driver_t *node, const char *group,
+                      std::vector<const char *> tags)
+{
+    node->groups = (neu_gdatatag_t *) realloc(
+        node->groups, (node->n_group + 1) * sizeof(neu_gdatatag_t));
+    neu_gdatatag_t *g = &node->groups[node->n_group++];
+
+    memset(g, 0, sizeof(*g));
+    strcpy(g->group, group);
+    g->interval = 1000;
+    g->n_tag    = tags.size();
+    g->tags     = (neu_datatag_t *) calloc(tags.size() + 1, sizeof(*g->tags));
+    for (size_t i = 0; i < tags.size(); ++i) {
+        g->tags[i] = make_tag(tags[i]);
+    }
+}
+
+static void add_sub(neu_req_import_config_t *req, const char *app,
+                    const char *driver, const char *group)
+{
+    req->subscriptions = (neu_req_subscribe_t *) realloc(
+        req->subscriptions,
+        (req->n_subscription + 1) * sizeof(neu_req_subscribe_t));
+    neu_req_subscribe_t *sub = &req->subscriptions[req->n_subscription++];
+
+    memset(sub, 0, sizeof(*sub));
+    strcpy(sub->app, app);
+    strcpy(sub->driver, driver);
+    strcpy(sub->group, group);
+}
+
+static void add_node(neu_req_import_config_t *req, neu_req_driver_t node)
+{
+    req->nodes = (neu_req_driver_t *) realloc(
+        req->nodes, (req->n_node + 1) * sizeof(neu_req_driver_t));
+    req->nodes[req->n_node++] = node;
+}
+
+static std::set<std::string> stored_nodes()
+{
+    std::set<std::string> names;
+    UT_array *            infos = NULL;
+
+    EXPECT_EQ(0, neu_persister_load_nodes(&infos));
+    utarray_foreach(infos, neu_persist_node_info_t *, info)
+    {
+        names.insert(info->name);
+    }
+    utarray_free(infos);
+    return names;
+}
+
+static std::set<std::string> stored_groups(const char *driver)
+{
+    std::set<std::string> names;
+    UT_array *            infos = NULL;
+
+    EXPECT_EQ(0, neu_persister_load_groups(driver, &infos));
+    utarray_foreach(infos, neu_persist_group_info_t *, info)
+    {
+        names.insert(info->name);
+    }
+    utarray_free(infos);
+    return names;
+}
+
+static size_t stored_tags(const char *driver, const char *group)
+{
+    UT_array *tags = NULL;
+
+    EXPECT_EQ(0, neu_persister_load_tags(driver, group, &tags));
+    size_t n = utarray_len(tags);
+    utarray_free(tags);
+    return n;
+}
+
+static std::set<std::string> stored_subs(const char *app)
+{
+    std::set<std::string> subs;
+    UT_array *            infos = NULL;
+
+    EXPECT_EQ(0, neu_persister_load_subscriptions(app, &infos));
+    utarray_foreach(infos, neu_persist_subscription_info_t *, info)
+    {
+        subs.insert(std::string(info->driver_name) + "/" + info->group_name);
+    }
+    utarray_free(infos);
+    return subs;
+}
+
+static std::string stored_setting(const char *node)
+{
+    const char *setting = NULL;
+
+    if (0 != neu_persister_load_node_setting(node, &setting)) {
+        return "";
+    }
+    std::string s = setting;
+    free((char *) setting);
+    return s;
+}
+
+class ConfigImportTest : public testing::Test {
+protected:
+    char          dir[64];
+    char          cwd[256];
+    neu_manager_t manager = {};
+
+    void SetUp() override
+    {
+        strcpy(dir, "/tmp/config_import_test.XXXXXX");
+        ASSERT_NE(nullptr, mkdtemp(dir));
+        ASSERT_NE(nullptr, getcwd(cwd, sizeof(cwd)));
+        ASSERT_EQ(0, chdir(dir));
+        ASSERT_EQ(0, mkdir("persistence", 0755));
+        ASSERT_EQ(0, neu_persister_create(SCHEMA_DIR));
+
+        g_nodes.clear();
+        g_groups.clear();
+        g_subs.clear();
+        g_bad_tag.clear();
+        g_n_reload = 0;
+
+        seed();
+    }
+
+    void TearDown() override
+    {
+        neu_persister_destroy();
+        ASSERT_EQ(0, chdir(cwd));
+        std::string cmd = std::string("rm -rf ") + dir;
+        EXPECT_EQ(0, system(cmd.c_str()));
+    }
+
+    // 运行中的配置：app 订阅 old/g1，old 有 g1（2 个点位）与 g2（1 个点位）
+    void seed()
+    {
+        neu_persist_node_info_t  app   = {};
+        neu_persist_node_info_t  old   = {};
+        neu_persist_group_info_t group = {};
+        neu_datatag_t            tags[] = { make_tag("t1"), make_tag("t2") };
+
+        app.name        = (char *) "app";
+        app.type        = NEU_NA_TYPE_APP;
+        app.plugin_name = (char *) "app";
+        app.state       = NEU_NODE_RUNNING_STATE_INIT;
+        old.name        = (char *) "old";
+        old.type        = NEU_NA_TYPE_DRIVER;
+        old.plugin_name = (char *) "driver";
+        old.state       = NEU_NODE_RUNNING_STATE_INIT;
+        ASSERT_EQ(0, neu_persister_store_node(&app));
+        ASSERT_EQ(0, neu_persister_store_node(&old));
+        ASSERT_EQ(0, neu_persister_store_node_setting("old", "{\"old\":1}"));
+
+        group.interval = 1000;
+        group.name     = (char *) "g1";
+        ASSERT_EQ(0, neu_persister_store_group("old", &group, NULL));
+        ASSERT_EQ(0, neu_persister_store_tags("old", "g1", tags, 2));
+        group.name = (char *) "g2";
+        ASSERT_EQ(0, neu_persister_store_group("old", &group, NULL));
+        ASSERT_EQ(0, neu_persister_store_tags("old", "g2", tags, 1));
+        ASSERT_EQ(0,
+                  neu_persister_store_subscription("app", "old", "g1", NULL,
+                                                   NULL));
+        ASSERT_EQ(0, neu_persister_sync());
+        neu_tag_fini(&tags[0]);
+        neu_tag_fini(&tags[1]);
+
+        g_nodes = { { "app", NEU_NA_TYPE_APP }, { "old", NEU_NA_TYPE_DRIVER } };
+
+        neu_resp_driver_group_info_t g = {};
+        strcpy(g.driver, "old");
+        strcpy(g.group, "g1");
+        g.tag_count = 2;
+        g_groups.push_back(g);
+        strcpy(g.group, "g2");
+        g.tag_count = 1;
+        g_groups.push_back(g);
+
+        neu_resp_subscribe_info_t sub = {};
+        strcpy(sub.app, "app");
+        strcpy(sub.driver, "old");
+        strcpy(sub.group, "g1");
+        g_subs.push_back(sub);
+    }
+
+    void expect_seed()
+    {
+        EXPECT_EQ((std::set<std::string>{ "app", "old" }), stored_nodes());
+        EXPECT_EQ((std::set<std::string>{ "g1", "g2" }), stored_groups("old"));
+        EXPECT_EQ(2, stored_tags("old", "g1"));
+        EXPECT_EQ(1, stored_tags("old", "g2"));
+        EXPECT_EQ("{\"old\":1}", stored_setting("old"));
+        EXPECT_EQ((std::set<std::string>{ "old/g1" }), stored_subs("app"));
+    }
+};
+
+// 导入的配置：删除 old，保留 app，新增 new（g3 含 3 个点位），app 订阅 new/g3
+static void build_import(neu_req_import_config_t *req, const char *bad_tag)
+{
+    neu_req_driver_t node = make_node("new", "driver", "{\"new\":1}");
+
+    add_group(&node, "g3", { "a", "b", bad_tag ? bad_tag : "c" });
+    add_node(req, make_node("app", "app", NULL));
+    add_node(req, node);
+    add_sub(req, "app", "new", "g3");
+}
+
+TEST_F(ConfigImportTest, persist_import)
+{
+    neu_persist_import_t       import  = {};
+    const char *               del[]   = { "app", "old" };
+    neu_persist_import_node_t  nodes[2] = {};
+    neu_datatag_t              tags[]  = { make_tag("a"), make_tag("b") };
+    neu_persist_import_group_t group   = {};
+    neu_persist_import_sub_t   sub     = {};
+
+    nodes[0].info.name        = (char *) "app";
+    nodes[0].info.type        = NEU_NA_TYPE_APP;
+    nodes[0].info.plugin_name = (char *) "app";
+    nodes[0].info.state       = NEU_NODE_RUNNING_STATE_INIT;
+    nodes[1].info.name        = (char *) "new";
+    nodes[1].info.type        = NEU_NA_TYPE_DRIVER;
+    nodes[1].info.plugin_name = (char *) "driver";
+    nodes[1].info.state       = NEU_NODE_RUNNING_STATE_INIT;
+    nodes[1].setting          = "{\"new\":1}";
+    group.driver_name         = "new";
+    group.name                = "g3";
+    group.interval            = 1000;
+    group.tags                = tags;
+    group.n_tag               = 2;
+    sub.app_name              = "app";
+    sub.driver_name           = "new";
+    sub.group_name            = "g3";
+
+    import.del_nodes      = del;
+    import.n_del_node     = 2;
+    import.nodes          = nodes;
+    import.n_node         = 2;
+    import.groups         = &group;
+    import.n_group        = 1;
+    import.subscriptions  = &sub;
+    import.n_subscription = 1;
+
+    ASSERT_EQ(0, neu_persister_import(&import));
+    EXPECT_EQ(0, neu_persister_import_end(false));
+
+    EXPECT_EQ((std::set<std::string>{ "app", "new" }), stored_nodes());
+    EXPECT_EQ((std::set<std::string>{ "g3" }), stored_groups("new"));
+    EXPECT_EQ(2, stored_tags("new", "g3"));
+    EXPECT_EQ("{\"new\":1}", stored_setting("new"));
+    EXPECT_EQ((std::set<std::string>{ "new/g3" }), stored_subs("app"));
+    EXPECT_TRUE(stored_groups("old").empty());
+
+    // 删除并写入节点后订阅写入失败（组不存在），整个导入不生效
+    sub.group_name = "missing";
+    EXPECT_NE(0, neu_persister_import(&import));
+    EXPECT_EQ((std::set<std::string>{ "app", "new" }), stored_nodes());
+    EXPECT_EQ(2, stored_tags("new", "g3"));
+
+    neu_tag_fini(&tags[0]);
+    neu_tag_fini(&tags[1]);
+}
+
+TEST_F(ConfigImportTest, persist_import_end_rollback)
+{
+    neu_persist_import_t      import = {};
+    const char *              del[]  = { "old" };
+    neu_persist_import_node_t node   = {};
+
+    node.info.name        = (char *) "new";
+    node.info.type        = NEU_NA_TYPE_DRIVER;
+    node.info.plugin_name = (char *) "driver";
+    node.info.state       = NEU_NODE_RUNNING_STATE_INIT;
+    import.del_nodes      = del;
+    import.n_del_node     = 1;
+    import.nodes          = &node;
+    import.n_node         = 1;
+
+    ASSERT_EQ(0, neu_persister_import(&import));
+    EXPECT_EQ((std::set<std::string>{ "app", "new" }), stored_nodes());
+
+    // 恢复快照，随节点级联删除的设置、组、点位与订阅一并恢复
+    EXPECT_EQ(0, neu_persister_import_end(true));
+    expect_seed();
+}
+
+TEST_F(ConfigImportTest, import_success)
+{
+    neu_req_import_config_t  req  = {};
+    neu_resp_import_config_t resp = {};
+    neu_import_progress_t    progress;
+
+    build_import(&req, NULL);
+    EXPECT_EQ(0, neu_manager_import_config(&manager, &req, &resp));
+    EXPECT_EQ(0, resp.error);
+
+    neu_import_get_progress(&progress);
+    EXPECT_EQ(NEU_IMPORT_PHASE_DONE, progress.phase);
+    EXPECT_FALSE(progress.dry_run);
+
+    EXPECT_EQ((std::set<std::string>{ "app", "new" }), stored_nodes());
+    EXPECT_EQ(3, stored_tags("new", "g3"));
+    EXPECT_EQ((std::set<std::string>{ "new/g3" }), stored_subs("app"));
+    EXPECT_TRUE(stored_groups("old").empty());
+    EXPECT_EQ(2, g_nodes.size());
+    EXPECT_EQ(nullptr, neu_node_manager_find(NULL, "old"));
+    EXPECT_EQ(0, g_n_reload);
+
+    neu_resp_import_config_fini(&resp);
+    neu_req_import_config_fini(&req);
+}
+
+TEST_F(ConfigImportTest, import_failure_restores_snapshot)
+{
+    neu_req_import_config_t  req  = {};
+    neu_resp_import_config_t resp = {};
+    neu_import_progress_t    progress;
+
+    // 写入成功后插件拒绝点位，卸载新节点并恢复导入前的配置
+    g_bad_tag = "bad";
+    build_import(&req, "bad");
+    EXPECT_EQ(NEU_ERR_TAG_ADDRESS_FORMAT_INVALID,
+              neu_manager_import_config(&manager, &req, &resp));
+    EXPECT_EQ(NEU_ERR_TAG_ADDRESS_FORMAT_INVALID, resp.error);
+    EXPECT_STREQ("new", resp.node);
+
+    neu_import_get_progress(&progress);
+    EXPECT_EQ(NEU_IMPORT_PHASE_FAILED, progress.phase);
+    EXPECT_EQ(NEU_ERR_TAG_ADDRESS_FORMAT_INVALID, progress.error);
+
+    expect_seed();
+    EXPECT_TRUE(stored_groups("new").empty());
+    EXPECT_EQ(1, g_n_reload);
+    EXPECT_NE(nullptr, neu_node_manager_find(NULL, "old"));
+    EXPECT_EQ(nullptr, neu_node_manager_find(NULL, "new"));
+
+    neu_resp_import_config_fini(&resp);
+    neu_req_import_config_fini(&req);
+}
+
+TEST_F(ConfigImportTest, dry_run_diff)
+{
+    neu_req_import_config_t  req  = {};
+    neu_resp_import_config_t resp = {};
+    neu_import_progress_t    progress;
+
+    // 同时保留 old 的 g1（改为 1 个点位）与订阅 app -> old/g1
+    build_import(&req, NULL);
+    neu_req_driver_t old = make_node("old", "driver", NULL);
+    add_group(&old, "g1", { "t1" });
+    add_node(&req, old);
+    add_sub(&req, "app", "old", "g1");
+    req.dry_run = true;
+
+    EXPECT_EQ(0, neu_manager_import_config(&manager, &req, &resp));
+    EXPECT_TRUE(resp.dry_run);
+
+    ASSERT_EQ(1, utarray_len(resp.add_nodes));
+    EXPECT_STREQ("new", *(char **) utarray_front(resp.add_nodes));
+    EXPECT_EQ(0, utarray_len(resp.del_nodes));
+    EXPECT_EQ(2, utarray_len(resp.update_nodes));
+    EXPECT_EQ(1, resp.add_groups);
+    EXPECT_EQ(1, resp.update_groups);
+    EXPECT_EQ(1, resp.del_groups);
+    EXPECT_EQ(1, resp.add_subscriptions);
+    EXPECT_EQ(1, resp.update_subscriptions);
+    EXPECT_EQ(0, resp.del_subscriptions);
+    EXPECT_EQ(3, resp.current_tags);
+    EXPECT_EQ(4, resp.import_tags);
+
+    neu_import_get_progress(&progress);
+    EXPECT_EQ(NEU_IMPORT_PHASE_DONE, progress.phase);
+    EXPECT_TRUE(progress.dry_run);
+
+    // 不修改存储与运行中的节点
+    expect_seed();
+    EXPECT_EQ(2, g_nodes.size());
+    EXPECT_EQ(nullptr, neu_node_manager_find(NULL, "new"));
+
+    neu_resp_import_config_fini(&resp);
+    neu_req_import_config_fini(&req);
+}
+
+TEST_F(ConfigImportTest, dry_run_delete)
+{
+    neu_req_import_config_t  req  = {};
+    neu_resp_import_config_t resp = {};
+
+    req.dry_run = true;
+    add_node(&req, make_node("app", "app", NULL));
+
+    EXPECT_EQ(0, neu_manager_import_config(&manager, &req, &resp));
+    EXPECT_EQ(0, utarray_len(resp.add_nodes));
+    ASSERT_EQ(1, utarray_len(resp.del_nodes));
+    EXPECT_STREQ("old", *(char **) utarray_front(resp.del_nodes));
+    EXPECT_EQ(1, utarray_len(resp.update_nodes));
+    EXPECT_EQ(2, resp.del_groups);
+    EXPECT_EQ(1, resp.del_subscriptions);
+    EXPECT_EQ(3, resp.current_tags);
+    EXPECT_EQ(0, resp.import_tags);
+    expect_seed();
+
+    neu_resp_import_config_fini(&resp);
+    neu_req_import_config_fini(&req);
+}
+
+TEST_F(ConfigImportTest, validate)
+{
+    neu_req_import_config_t  req  = {};
+    neu_resp_import_config_t resp = {};
+
+    // 订阅引用了导入配置之外的节点，不做任何修改
+    add_node(&req, make_node("app", "app", NULL));
+    add_sub(&req, "app", "old", "g1");
+    EXPECT_EQ(NEU_ERR_NODE_NOT_EXIST,
+              neu_manager_import_config(&manager, &req, &resp));
+    EXPECT_STREQ("old", resp.node);
+    expect_seed();
+    EXPECT_EQ(2, g_nodes.size());
+
+    neu_resp_import_config_fini(&resp);
+    neu_req_import_config_fini(&req);
+}
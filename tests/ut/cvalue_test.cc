@@ -0,0 +1,122 @@
+#include <string.h>
+
+#include <gtest/gtest.h>
+
+#include "cvalue.h"
+#include "utils/log.h"
+
+zlog_category_t *neuron = NULL;
+
+TEST(CValueTest, size)
+{
+    EXPECT_EQ(16, sizeof(neu_cvalue_t));
+}
+
+TEST(CValueTest, scalar)
+{
+    neu_dvalue_t dv = {};
+    neu_dvalue_t out = {};
+    neu_cvalue_t cv = {};
+
+    dv.type      = NEU_TYPE_DOUBLE;
+    dv.value.d64 = 3.25;
+    dv.precision = 2;
+    neu_cvalue_from_dvalue(&cv, &dv);
+    EXPECT_EQ(0, cv.flags);
+
+    neu_cvalue_to_dvalue(&cv, &out);
+    EXPECT_EQ(NEU_TYPE_DOUBLE, out.type);
+    EXPECT_EQ(2, out.precision);
+    EXPECT_EQ(3.25, out.value.d64);
+    neu_cvalue_release(&cv);
+}
+
+TEST(CValueTest, string)
+{
+    neu_dvalue_t dv = {};
+    neu_dvalue_t out = {};
+    neu_cvalue_t small = {};
+    neu_cvalue_t large = {};
+
+    dv.type = NEU_TYPE_STRING;
+    strcpy(dv.value.str, "hello world");
+    neu_cvalue_from_dvalue(&small, &dv);
+    EXPECT_EQ(0, small.flags);
+    EXPECT_STREQ("hello world", neu_cvalue_str(&small));
+
+    strcpy(dv.value.str, "hello world, longer than inline");
+    neu_cvalue_from_dvalue(&large, &dv);
+    EXPECT_EQ(NEU_CVALUE_F_BLOB, large.flags);
+    EXPECT_STREQ("hello world, longer than inline", neu_cvalue_str(&large));
+    EXPECT_FALSE(neu_cvalue_equal(&small, &large));
+
+    neu_cvalue_to_dvalue(&large, &out);
+    EXPECT_STREQ("hello world, longer than inline", out.value.str);
+
+    neu_cvalue_release(&small);
+    neu_cvalue_release(&large);
+}
+
+TEST(CValueTest, array)
+{
+    neu_dvalue_t dv = {};
+    neu_dvalue_t out = {};
+    neu_cvalue_t a = {};
+    neu_cvalue_t b = {};
+
+    dv.type              = NEU_TYPE_ARRAY_INT32;
+    dv.value.i32s.length = 3;
+    dv.value.i32s.i32s[0] = 1;
+    dv.value.i32s.i32s[1] = -2;
+    dv.value.i32s.i32s[2] = 3;
+    neu_cvalue_from_dvalue(&a, &dv);
+    EXPECT_EQ(3, a.length);
+
+    neu_cvalue_to_dvalue(&a, &out);
+    EXPECT_EQ(3, out.value.i32s.length);
+    EXPECT_EQ(-2, out.value.i32s.i32s[1]);
+    EXPECT_EQ(3, out.value.i32s.i32s[2]);
+
+    dv.value.i32s.i32s[2] = 4;
+    neu_cvalue_from_dvalue(&b, &dv);
+    EXPECT_FALSE(neu_cvalue_equal(&a, &b));
+
+    neu_cvalue_release(&b);
+    neu_cvalue_copy(&b, &a);
+    EXPECT_EQ(a.value.blob, b.value.blob);
+    EXPECT_EQ(2, a.value.blob->ref);
+    EXPECT_TRUE(neu_cvalue_equal(&a, &b));
+
+    neu_cvalue_release(&a);
+    EXPECT_EQ(1, b.value.blob->ref);
+    neu_cvalue_release(&b);
+}
+
+TEST(CValueTest, array_string)
+{
+    neu_dvalue_t dv = {};
+    neu_dvalue_t out = {};
+    neu_cvalue_t cv = {};
+    char         a[] = "a";
+    char         b[] = "bc";
+
+    dv.type              = NEU_TYPE_ARRAY_STRING;
+    dv.value.strs.length = 2;
+    dv.value.strs.strs[0] = a;
+    dv.value.strs.strs[1] = b;
+    neu_cvalue_from_dvalue(&cv, &dv);
+
+    neu_cvalue_to_dvalue(&cv, &out);
+    EXPECT_EQ(2, out.value.strs.length);
+    EXPECT_STREQ("a", out.value.strs.strs[0]);
+    EXPECT_STREQ("bc", out.value.strs.strs[1]);
+    free(out.value.strs.strs[0]);
+    free(out.value.strs.strs[1]);
+    neu_cvalue_release(&cv);
+}
+
+int main(int argc, char **argv)
+{
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
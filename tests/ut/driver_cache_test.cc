@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "adapter/driver/cache.h"
+}
+#include "errcodes.h"
+#include "utils/log.h"
+
+zlog_category_t *neuron         = NULL;
+bool             sub_filter_err = false;
+
+static neu_driver_cache_t *cache_new(const neu_datatag_deadband_t *deadband,
+                                     double decimal = 0, double bias = 0)
+{
+    neu_driver_cache_t *cache = neu_driver_cache_new();
+    neu_dvalue_t        value = {};
+
+    value.type      = NEU_TYPE_ERROR;
+    value.value.i32 = NEU_ERR_PLUGIN_TAG_NOT_READY;
+    neu_driver_cache_add(cache, "group", "tag", value);
+    if (deadband != NULL) {
+        neu_driver_cache_set_deadband(cache, "group", "tag", deadband,
+                                      decimal, bias);
+    }
+
+    return cache;
+}
+
+static bool update(neu_driver_cache_t *cache, int64_t timestamp, double v)
+{
+    neu_dvalue_t value = {};
+
+    value.type      = NEU_TYPE_DOUBLE;
+    value.value.d64 = v;
+    return neu_driver_cache_update(cache, "group", "tag", timestamp, value,
+                                   NULL, 0);
+}
+
+static bool changed(neu_driver_cache_t *cache)
+{
+    neu_driver_cache_value_t value = {};
+
+    return 0 ==
+        neu_driver_cache_meta_get_changed(cache, "group", "tag", &value,
+                                          NULL, 0);
+}
+
+TEST(DriverCacheTest, no_deadband)
+{
+    neu_driver_cache_t *cache = cache_new(NULL);
+
+    EXPECT_FALSE(update(cache, 1, 10.0));
+    EXPECT_TRUE(changed(cache));
+    EXPECT_FALSE(update(cache, 2, 10.001));
+    EXPECT_TRUE(changed(cache));
+    EXPECT_FALSE(update(cache, 3, 10.001));
+    EXPECT_FALSE(changed(cache));
+
+    neu_driver_cache_destroy(cache);
+}
+
+TEST(DriverCacheTest, absolute)
+{
+    neu_datatag_deadband_t deadband = {};
+    deadband.type                   = NEU_DEADBAND_ABSOLUTE;
+    deadband.value                  = 0.5;
+    neu_driver_cache_t *cache       = cache_new(&deadband);
+
+    EXPECT_FALSE(update(cache, 1, 10.0));
+    EXPECT_TRUE(changed(cache));
+
+    EXPECT_TRUE(update(cache, 2, 10.3));
+    EXPECT_FALSE(changed(cache));
+    EXPECT_TRUE(update(cache, 3, 10.5));
+    EXPECT_FALSE(changed(cache));
+
+    // 与上次上报值 10.0 比较，缓慢漂移最终也会上报
+    EXPECT_FALSE(update(cache, 4, 10.6));
+    EXPECT_TRUE(changed(cache));
+    EXPECT_TRUE(update(cache, 5, 10.2));
+    EXPECT_FALSE(changed(cache));
+
+    neu_driver_cache_destroy(cache);
+}
+
+TEST(DriverCacheTest, hysteresis)
+{
+    neu_datatag_deadband_t deadband = {};
+    deadband.type                   = NEU_DEADBAND_ABSOLUTE;
+    deadband.value                  = 1;
+    deadband.hysteresis             = 1;
+    neu_driver_cache_t *cache       = cache_new(&deadband);
+
+    update(cache, 1, 10);
+    EXPECT_TRUE(changed(cache));
+    EXPECT_FALSE(update(cache, 2, 11.5));
+    EXPECT_TRUE(changed(cache));
+
+    // 方向反转，需要超过 1 + 1
+    EXPECT_TRUE(update(cache, 3, 10));
+    EXPECT_FALSE(changed(cache));
+    EXPECT_FALSE(update(cache, 4, 9));
+    EXPECT_TRUE(changed(cache));
+
+    // 方向不变，只需超过 1
+    EXPECT_FALSE(update(cache, 5, 7.5));
+    EXPECT_TRUE(changed(cache));
+
+    neu_driver_cache_destroy(cache);
+}
+
+TEST(DriverCacheTest, percent)
+{
+    neu_datatag_deadband_t deadband = {};
+    deadband.type                   = NEU_DEADBAND_SPAN;
+    deadband.value                  = 1;
+    deadband.span                   = 200;
+    neu_driver_cache_t *cache       = cache_new(&deadband);
+
+    update(cache, 1, 100);
+    EXPECT_TRUE(changed(cache));
+    EXPECT_TRUE(update(cache, 2, 101.5));
+    EXPECT_FALSE(update(cache, 3, 102.5));
+    EXPECT_TRUE(changed(cache));
+    neu_driver_cache_destroy(cache);
+
+    deadband.type  = NEU_DEADBAND_VALUE;
+    deadband.value = 10;
+    cache          = cache_new(&deadband);
+
+    update(cache, 1, 100);
+    EXPECT_TRUE(changed(cache));
+    EXPECT_TRUE(update(cache, 2, 109));
+    EXPECT_FALSE(update(cache, 3, 111));
+    EXPECT_TRUE(changed(cache));
+    EXPECT_TRUE(update(cache, 4, 121));
+    EXPECT_FALSE(changed(cache));
+    neu_driver_cache_destroy(cache);
+}
+
+TEST(DriverCacheTest, decimal_bias)
+{
+    neu_datatag_deadband_t deadband = {};
+    deadband.type                   = NEU_DEADBAND_ABSOLUTE;
+    deadband.value                  = 1;
+    neu_driver_cache_t *cache       = cache_new(&deadband, 10, 5);
+
+    // 死区按换算后的值 raw * 10 + 5 比较
+    update(cache, 1, 10);
+    EXPECT_TRUE(changed(cache));
+    EXPECT_TRUE(update(cache, 2, 10.05));
+    EXPECT_FALSE(changed(cache));
+    EXPECT_FALSE(update(cache, 3, 10.2));
+    EXPECT_TRUE(changed(cache));
+    neu_driver_cache_destroy(cache);
+
+    // 百分比死区的基准为换算后的 1000，原始值为 0 时不会一直上报
+    deadband.type  = NEU_DEADBAND_VALUE;
+    deadband.value = 10;
+    cache          = cache_new(&deadband, 0, 1000);
+
+    update(cache, 1, 0);
+    EXPECT_TRUE(changed(cache));
+    EXPECT_TRUE(update(cache, 2, 50));
+    EXPECT_FALSE(changed(cache));
+    EXPECT_FALSE(update(cache, 3, 150));
+    EXPECT_TRUE(changed(cache));
+    neu_driver_cache_destroy(cache);
+}
+
+TEST(DriverCacheTest, heartbeat)
+{
+    neu_datatag_deadband_t deadband = {};
+    deadband.type                   = NEU_DEADBAND_ABSOLUTE;
+    deadband.value                  = 5;
+    deadband.heartbeat              = 1000;
+    neu_driver_cache_t *cache       = cache_new(&deadband);
+
+    update(cache, 0, 10);
+    EXPECT_TRUE(changed(cache));
+    EXPECT_FALSE(update(cache, 500, 10));
+    EXPECT_FALSE(changed(cache));
+    EXPECT_TRUE(update(cache, 900, 11));
+    EXPECT_FALSE(changed(cache));
+
+    EXPECT_FALSE(update(cache, 1000, 11));
+    EXPECT_TRUE(changed(cache));
+    EXPECT_FALSE(update(cache, 1500, 11));
+    EXPECT_FALSE(changed(cache));
+
+    neu_driver_cache_destroy(cache);
+}
+
+TEST(DriverCacheTest, error_resets_reference)
+{
+    neu_datatag_deadband_t deadband = {};
+    deadband.type                   = NEU_DEADBAND_ABSOLUTE;
+    deadband.value                  = 5;
+    neu_driver_cache_t *cache       = cache_new(&deadband);
+    neu_dvalue_t        error       = {};
+
+    update(cache, 1, 10);
+    EXPECT_TRUE(changed(cache));
+
+    error.type      = NEU_TYPE_ERROR;
+    error.value.i32 = NEU_ERR_PLUGIN_DISCONNECTED;
+    neu_driver_cache_update(cache, "group", "tag", 2, error, NULL, 0);
+    EXPECT_TRUE(changed(cache));
+
+    // 从错误恢复总是上报
+    EXPECT_FALSE(update(cache, 3, 11));
+    EXPECT_TRUE(changed(cache));
+
+    neu_driver_cache_destroy(cache);
+}
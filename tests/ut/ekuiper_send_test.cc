@@ -0,0 +1,303 @@
+#include <string.h>
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "ekuiper/pb_rw.h"
+#include "ekuiper/read_write.h"
+#include "ptformat.pb-c.h"
+}
+
+zlog_category_t *neuron = NULL;
+
+#define URL "inproc://ekuiper_send_test"
+
+// 没有对端时 pair0 套接字的发送挂起，据此控制发送队列中的组上报
+class EkuiperSendTest : public testing::Test {
+protected:
+    neu_plugin_t       plugin     = {};
+    nng_socket         peer       = NNG_SOCKET_INITIALIZER;
+    neu_metric_entry_t msgs       = {};
+    neu_metric_entry_t errors     = {};
+    neu_metric_entry_t drops      = {};
+    neu_metric_entry_t queue_size = {};
+
+    void SetUp() override
+    {
+        msgs.type       = NEU_METRIC_SEND_MSGS_TOTAL_TYPE;
+        errors.type     = NEU_METRIC_SEND_MSG_ERRORS_TOTAL_TYPE;
+        drops.type      = NEU_METRIC_SEND_MSG_DROPS_TOTAL_TYPE;
+        queue_size.type = NEU_METRIC_SEND_QUEUE_SIZE_TYPE;
+
+        plugin.format                        = EKUIPER_FORMAT_JSON;
+        plugin.batch_size                    = 1;
+        plugin.send_queue_size               = 16;
+        plugin.metrics.send_msgs_total       = &msgs;
+        plugin.metrics.send_msg_errors_total = &errors;
+        plugin.metrics.send_msg_drops_total  = &drops;
+        plugin.metrics.send_queue_size       = &queue_size;
+
+        ASSERT_EQ(0, nng_mtx_alloc(&plugin.mtx));
+        ASSERT_EQ(0, nng_pair0_open(&plugin.sock));
+        ASSERT_EQ(0, nng_listen(plugin.sock, URL, NULL, 0));
+        ASSERT_EQ(0,
+                  nng_aio_alloc(&plugin.send_aio, send_data_callback, &plugin));
+    }
+
+    void TearDown() override
+    {
+        nng_close(plugin.sock);
+        send_queue_drain(&plugin);
+        if (nng_socket_id(peer) > 0) {
+            nng_close(peer);
+        }
+        nng_aio_free(plugin.send_aio);
+        nng_mtx_free(plugin.mtx);
+    }
+
+    void report(const char *group)
+    {
+        neu_reqresp_trans_data_t  data = {};
+        neu_resp_tag_value_meta_t tag  = {};
+
+        strcpy(tag.tag, "tag");
+        tag.value.type      = NEU_TYPE_INT32;
+        tag.value.value.i32 = 1;
+
+        data.driver = (char *) "node";
+        data.group  = (char *) group;
+        utarray_new(data.tags, neu_resp_tag_value_meta_icd());
+        utarray_push_back(data.tags, &tag);
+        send_data(&plugin, &data);
+        utarray_free(data.tags);
+    }
+
+    void set_format(ekuiper_format_e format)
+    {
+        nng_mtx_lock(plugin.mtx);
+        plugin.format = format;
+        nng_mtx_unlock(plugin.mtx);
+    }
+
+    size_t queue_len()
+    {
+        nng_mtx_lock(plugin.mtx);
+        size_t len = plugin.queue_len;
+        nng_mtx_unlock(plugin.mtx);
+        return len;
+    }
+
+    void connect()
+    {
+        ASSERT_EQ(0, nng_pair0_open(&peer));
+        ASSERT_EQ(0, nng_socket_set_ms(peer, NNG_OPT_RECVTIMEO, 1000));
+        ASSERT_EQ(0, nng_dial(peer, URL, NULL, 0));
+    }
+
+    std::string recv()
+    {
+        nng_msg *msg = NULL;
+
+        if (0 != nng_recvmsg(peer, &msg, 0)) {
+            return "";
+        }
+        std::string body((char *) nng_msg_body(msg), nng_msg_len(msg));
+        nng_msg_free(msg);
+        return body;
+    }
+};
+
+// JSON 消息中依次出现的组名
+static std::vector<std::string> json_groups(const std::string &msg)
+{
+    std::vector<std::string> groups;
+    size_t                   pos = 0;
+
+    while (std::string::npos != (pos = msg.find("\"group_name\"", pos))) {
+        size_t begin = msg.find('"', msg.find(':', pos)) + 1;
+        size_t end   = msg.find('"', begin);
+        groups.push_back(msg.substr(begin, end - begin));
+        pos = end;
+    }
+    return groups;
+}
+
+// 按 DataReports 字段逐个解出 DataReport 的组名
+static std::vector<std::string> pb_groups(const std::string &msg)
+{
+    std::vector<std::string> groups;
+    const uint8_t *          p   = (const uint8_t *) msg.data();
+    const uint8_t *          end = p + msg.size();
+
+    while (p < end) {
+        size_t len   = 0;
+        int    shift = 0;
+
+        EXPECT_EQ(PB_DATA_REPORTS_KEY, *p++);
+        do {
+            len |= (size_t)(*p & 0x7F) << shift;
+            shift += 7;
+        } while (*p++ & 0x80);
+
+        Model__DataReport *report = model__data_report__unpack(NULL, len, p);
+        if (NULL == report) {
+            ADD_FAILURE() << "invalid DataReport";
+            break;
+        }
+        groups.push_back(report->group);
+        model__data_report__free_unpacked(report, NULL);
+        p += len;
+    }
+    return groups;
+}
+
+typedef std::vector<std::string> groups_t;
+
+TEST_F(EkuiperSendTest, queue_drop_oldest)
+{
+    plugin.send_queue_size = 2;
+
+    // g0 发送中，g1 g2 在队列中，g3 入队时丢弃最早的 g1
+    report("g0");
+    report("g1");
+    report("g2");
+    EXPECT_EQ(2, queue_len());
+    EXPECT_EQ(0, neu_metric_entry_value(&drops));
+
+    report("g3");
+    EXPECT_EQ(2, queue_len());
+    EXPECT_EQ(2, neu_metric_entry_value(&queue_size));
+    EXPECT_EQ(1, neu_metric_entry_value(&drops));
+
+    connect();
+    EXPECT_EQ(groups_t({ "g0" }), json_groups(recv()));
+    EXPECT_EQ(groups_t({ "g2" }), json_groups(recv()));
+    EXPECT_EQ(groups_t({ "g3" }), json_groups(recv()));
+    EXPECT_EQ("", recv());
+
+    EXPECT_EQ(0, queue_len());
+    EXPECT_EQ(0, neu_metric_entry_value(&queue_size));
+    EXPECT_EQ(3, neu_metric_entry_value(&msgs));
+    EXPECT_EQ(0, neu_metric_entry_value(&errors));
+}
+
+TEST_F(EkuiperSendTest, json_object)
+{
+    report("g0");
+    report("g1");
+
+    connect();
+    std::string msg = recv();
+    ASSERT_FALSE(msg.empty());
+    EXPECT_EQ('{', msg.front());
+    EXPECT_EQ('}', msg.back());
+    EXPECT_EQ(groups_t({ "g0" }), json_groups(msg));
+
+    msg = recv();
+    ASSERT_FALSE(msg.empty());
+    EXPECT_EQ('{', msg.front());
+    EXPECT_EQ(groups_t({ "g1" }), json_groups(msg));
+}
+
+TEST_F(EkuiperSendTest, json_array_batch)
+{
+    plugin.batch_size = 3;
+
+    for (const char *group : { "g0", "g1", "g2", "g3", "g4" }) {
+        report(group);
+    }
+    EXPECT_EQ(4, queue_len());
+
+    // 每条消息最多 batch_size 个组，batch_size 大于 1 时总是数组
+    connect();
+    std::string msg = recv();
+    ASSERT_FALSE(msg.empty());
+    EXPECT_EQ('[', msg.front());
+    EXPECT_EQ(']', msg.back());
+    EXPECT_EQ(groups_t({ "g0" }), json_groups(msg));
+
+    msg = recv();
+    ASSERT_FALSE(msg.empty());
+    EXPECT_EQ('[', msg.front());
+    EXPECT_EQ(']', msg.back());
+    EXPECT_NE(std::string::npos, msg.find("},{"));
+    EXPECT_EQ(groups_t({ "g1", "g2", "g3" }), json_groups(msg));
+
+    EXPECT_EQ(groups_t({ "g4" }), json_groups(recv()));
+    EXPECT_EQ("", recv());
+    EXPECT_EQ(3, neu_metric_entry_value(&msgs));
+}
+
+TEST_F(EkuiperSendTest, protobuf_batch)
+{
+    plugin.format     = EKUIPER_FORMAT_PROTOBUF;
+    plugin.batch_size = 2;
+
+    report("g0");
+    report("g1");
+    report("g2");
+
+    connect();
+    EXPECT_EQ(groups_t({ "g0" }), pb_groups(recv()));
+    EXPECT_EQ(groups_t({ "g1", "g2" }), pb_groups(recv()));
+    EXPECT_EQ("", recv());
+}
+
+TEST_F(EkuiperSendTest, format_per_report)
+{
+    plugin.batch_size = 3;
+
+    // 已入队的组上报保留入队时的格式，且不与其他格式合并
+    report("g0");
+    report("g1");
+    set_format(EKUIPER_FORMAT_PROTOBUF);
+    report("g2");
+    report("g3");
+
+    connect();
+    EXPECT_EQ(groups_t({ "g0" }), json_groups(recv()));
+    EXPECT_EQ(groups_t({ "g1" }), json_groups(recv()));
+    EXPECT_EQ(groups_t({ "g2", "g3" }), pb_groups(recv()));
+}
+
+TEST_F(EkuiperSendTest, drain)
+{
+    report("g0");
+    report("g1");
+    report("g2");
+    EXPECT_EQ(2, queue_len());
+
+    nng_close(plugin.sock);
+    send_queue_drain(&plugin);
+    EXPECT_EQ(0, queue_len());
+    EXPECT_FALSE(plugin.sending);
+    EXPECT_EQ(0, neu_metric_entry_value(&queue_size));
+    EXPECT_EQ(0, neu_metric_entry_value(&msgs));
+    EXPECT_EQ(0, neu_metric_entry_value(&drops));
+}
+
+TEST(EkuiperFrameTest, pb_report_frame)
+{
+    uint8_t report[300] = { 0 };
+    uint8_t frame[304]  = { 0 };
+
+    memset(report, 0xAB, sizeof(report));
+    EXPECT_EQ(2 + 10, pb_report_frame_size(10));
+    EXPECT_EQ(2 + 127, pb_report_frame_size(127));
+    EXPECT_EQ(3 + 128, pb_report_frame_size(128));
+    EXPECT_EQ(3 + 300, pb_report_frame_size(300));
+
+    // 长度以 varint 编码: 300 = 0xAC 0x02
+    EXPECT_EQ(3 + 300, pb_report_frame(frame, report, sizeof(report)));
+    EXPECT_EQ(PB_DATA_REPORTS_KEY, frame[0]);
+    EXPECT_EQ(0xAC, frame[1]);
+    EXPECT_EQ(0x02, frame[2]);
+    EXPECT_EQ(0, memcmp(frame + 3, report, sizeof(report)));
+
+    EXPECT_EQ(2 + 1, pb_report_frame(frame, report, 1));
+    EXPECT_EQ(1, frame[1]);
+    EXPECT_EQ(0xAB, frame[2]);
+}
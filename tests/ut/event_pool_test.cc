@@ -0,0 +1,196 @@
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "event/event.h"
+#include "utils/log.h"
+
+zlog_category_t *neuron = NULL;
+
+static int timer_cb(void *usr_data)
+{
+    __atomic_fetch_add((int *) usr_data, 1, __ATOMIC_RELAXED);
+    return 0;
+}
+
+static int io_cb(enum neu_event_io_type type, int fd, void *usr_data)
+{
+    char buf[16] = {};
+
+    if (type == NEU_EVENT_IO_READ) {
+        EXPECT_LT(0, read(fd, buf, sizeof(buf)));
+        usleep(50 * 1000);
+        __atomic_fetch_add((int *) usr_data, 1, __ATOMIC_RELAXED);
+    }
+    return 0;
+}
+
+TEST(EventPoolTest, assign)
+{
+    EXPECT_EQ(0, neu_event_pool_init(2));
+    EXPECT_EQ(-1, neu_event_pool_init(4));
+    EXPECT_EQ(2, neu_event_pool_size());
+
+    neu_events_t *e1 = neu_event_pool_get();
+    neu_events_t *e2 = neu_event_pool_get();
+    neu_events_t *e3 = neu_event_pool_get();
+
+    EXPECT_NE(e1, e2);
+    EXPECT_TRUE(e3 == e1 || e3 == e2);
+
+    neu_event_loop_stats_t stats = {};
+    EXPECT_EQ(0, neu_event_pool_stats(0, &stats));
+    EXPECT_EQ(2, stats.users);
+    EXPECT_EQ(0, neu_event_pool_stats(1, &stats));
+    EXPECT_EQ(1, stats.users);
+    EXPECT_EQ(-1, neu_event_pool_stats(2, &stats));
+
+    neu_event_close(e3);
+    neu_event_close(e2);
+    neu_event_close(e1);
+
+    EXPECT_EQ(0, neu_event_pool_stats(0, &stats));
+    EXPECT_EQ(0, stats.users);
+}
+
+TEST(EventPoolTest, timer)
+{
+    int                     count  = 0;
+    neu_events_t *          events = neu_event_pool_get();
+    neu_event_timer_param_t param  = {
+        .second      = 0,
+        .millisecond = 10,
+        .usr_data    = &count,
+        .cb          = timer_cb,
+        .type        = NEU_EVENT_TIMER_NOBLOCK,
+    };
+
+    neu_event_timer_t *timer = neu_event_add_timer(events, param);
+    usleep(1200 * 1000);
+    neu_event_del_timer(events, timer);
+    neu_event_close(events);
+
+    EXPECT_LT(50, __atomic_load_n(&count, __ATOMIC_RELAXED));
+
+    neu_event_loop_stats_t stats = {};
+    uint64_t               total = 0;
+    for (int i = 0; i < neu_event_pool_size(); i++) {
+        EXPECT_EQ(0, neu_event_pool_stats(i, &stats));
+        EXPECT_EQ(0, stats.events);
+        EXPECT_GE(100, stats.busy_percent);
+        total += stats.dispatched;
+    }
+    EXPECT_LE((uint64_t) count, total);
+}
+
+struct close_ctx {
+    neu_events_t *  events;
+    neu_event_io_t *io;
+    int             started;
+    int             done;
+    int             closed;
+    int             seen;
+};
+
+static int slow_io_cb(enum neu_event_io_type type, int fd, void *usr_data)
+{
+    struct close_ctx *ctx     = (struct close_ctx *) usr_data;
+    char              buf[16] = {};
+
+    if (type == NEU_EVENT_IO_READ) {
+        EXPECT_LT(0, read(fd, buf, sizeof(buf)));
+        __atomic_store_n(&ctx->started, 1, __ATOMIC_RELEASE);
+        usleep(100 * 1000);
+        __atomic_fetch_add(&ctx->done, 1, __ATOMIC_RELEASE);
+    }
+    return 0;
+}
+
+static int close_timer_cb(void *usr_data)
+{
+    struct close_ctx *ctx = (struct close_ctx *) usr_data;
+
+    if (!__atomic_load_n(&ctx->started, __ATOMIC_ACQUIRE) || ctx->closed) {
+        return 0;
+    }
+
+    // 在另一个共享循环的回调中归还循环，如同管理器线程删除节点
+    neu_event_del_io(ctx->events, ctx->io);
+    neu_event_close(ctx->events);
+    ctx->seen = __atomic_load_n(&ctx->done, __ATOMIC_ACQUIRE);
+    __atomic_store_n(&ctx->closed, 1, __ATOMIC_RELEASE);
+    return 0;
+}
+
+TEST(EventPoolTest, close_from_other_loop)
+{
+    struct close_ctx ctx    = {};
+    int              fds[2] = {};
+    neu_events_t *   loop   = neu_event_pool_get();
+
+    ctx.events = neu_event_pool_get();
+    ASSERT_NE(loop, ctx.events);
+    ASSERT_EQ(0, pipe(fds));
+
+    neu_event_io_param_t io_param = {
+        .fd       = fds[0],
+        .usr_data = &ctx,
+        .cb       = slow_io_cb,
+    };
+    ctx.io = neu_event_add_io(ctx.events, io_param);
+
+    neu_event_timer_param_t timer_param = {
+        .second      = 0,
+        .millisecond = 5,
+        .usr_data    = &ctx,
+        .cb          = close_timer_cb,
+        .type        = NEU_EVENT_TIMER_NOBLOCK,
+    };
+    neu_event_timer_t *timer = neu_event_add_timer(loop, timer_param);
+
+    EXPECT_EQ(1, write(fds[1], "x", 1));
+    for (int i = 0; i < 100 && !__atomic_load_n(&ctx.closed, __ATOMIC_ACQUIRE);
+         i++) {
+        usleep(10 * 1000);
+    }
+
+    neu_event_del_timer(loop, timer);
+    neu_event_close(loop);
+
+    // 归还返回时另一个循环上的回调必须已结束
+    EXPECT_EQ(1, __atomic_load_n(&ctx.closed, __ATOMIC_ACQUIRE));
+    EXPECT_EQ(1, ctx.seen);
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST(EventPoolTest, close_waits_callback)
+{
+    int           count  = 0;
+    int           fds[2] = {};
+    neu_events_t *events = neu_event_pool_get();
+
+    ASSERT_EQ(0, pipe(fds));
+
+    neu_event_io_param_t param = {
+        .fd       = fds[0],
+        .usr_data = &count,
+        .cb       = io_cb,
+    };
+    neu_event_io_t *io = neu_event_add_io(events, param);
+
+    EXPECT_EQ(1, write(fds[1], "x", 1));
+    usleep(10 * 1000);
+
+    // 回调执行中删除 fd 并归还循环，归还返回时回调必须已结束
+    neu_event_del_io(events, io);
+    neu_event_close(events);
+    EXPECT_EQ(1, __atomic_load_n(&count, __ATOMIC_RELAXED));
+
+    close(fds[0]);
+    close(fds[1]);
+
+    neu_event_pool_fini();
+    EXPECT_EQ(0, neu_event_pool_size());
+}
@@ -0,0 +1,180 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include "neuron.h"
+
+#include "file/file_cache.h"
+
+zlog_category_t *neuron = NULL;
+
+static void write_file(const char *path, const char *content, size_t len)
+{
+    FILE *fp = fopen(path, "w");
+    ASSERT_NE(nullptr, fp);
+    fwrite(content, 1, len, fp);
+    fclose(fp);
+}
+
+static void expect_value(file_cache_t *cache, const char *address,
+                         const char *expected)
+{
+    const char *value = NULL;
+    size_t      len   = 0;
+
+    ASSERT_EQ(0, file_cache_read(cache, address, &value, &len));
+    EXPECT_STREQ(expected, value);
+    EXPECT_EQ(strlen(expected), len);
+}
+
+TEST(file_address, parse)
+{
+    file_address_t addr = { 0 };
+
+    ASSERT_EQ(0, file_address_parse("/tmp/a#b.txt", &addr));
+    EXPECT_STREQ("/tmp/a#b.txt", addr.path);
+    EXPECT_EQ(FILE_SELECT_ALL, addr.select);
+    file_address_fini(&addr);
+
+    ASSERT_EQ(0, file_address_parse("/tmp/a.txt#line=3", &addr));
+    EXPECT_STREQ("/tmp/a.txt", addr.path);
+    EXPECT_EQ(FILE_SELECT_LINE, addr.select);
+    EXPECT_EQ(3, addr.line);
+    file_address_fini(&addr);
+
+    ASSERT_EQ(0, file_address_parse("/tmp/a.txt#bytes=4,8", &addr));
+    EXPECT_EQ(FILE_SELECT_BYTES, addr.select);
+    EXPECT_EQ(4, addr.offset);
+    EXPECT_EQ(8, addr.length);
+    file_address_fini(&addr);
+
+    EXPECT_EQ(NEU_ERR_TAG_ADDRESS_FORMAT_INVALID,
+              file_address_parse("/tmp/a.txt#line=0", &addr));
+    EXPECT_EQ(NEU_ERR_TAG_ADDRESS_FORMAT_INVALID,
+              file_address_parse("/tmp/a.txt#bytes=1,", &addr));
+    EXPECT_EQ(NEU_ERR_TAG_ADDRESS_FORMAT_INVALID,
+              file_address_parse("#line=1", &addr));
+}
+
+static void read_selectors(file_mode_e mode)
+{
+    char path[] = "/tmp/file_cache_test_XXXXXX";
+    int  fd     = mkstemp(path);
+    ASSERT_LE(0, fd);
+    close(fd);
+
+    char address[64] = { 0 };
+    write_file(path, "first\r\nsecond\nthird", 19);
+
+    file_cache_t *cache = file_cache_new(mode);
+    ASSERT_NE(nullptr, cache);
+    file_cache_begin(cache);
+
+    expect_value(cache, path, "first\r\nsecond\nthird");
+    snprintf(address, sizeof(address), "%s#line=1", path);
+    expect_value(cache, address, "first");
+    snprintf(address, sizeof(address), "%s#line=3", path);
+    expect_value(cache, address, "third");
+    snprintf(address, sizeof(address), "%s#bytes=7,3", path);
+    expect_value(cache, address, "sec");
+
+    const char *value = NULL;
+    size_t      len   = 0;
+    snprintf(address, sizeof(address), "%s#line=4", path);
+    EXPECT_EQ(NEU_ERR_FILE_READ_FAILURE,
+              file_cache_read(cache, address, &value, &len));
+
+    // 文件变化后在下一个周期读到新值
+    write_file(path, "changed\n", 8);
+    file_cache_begin(cache);
+    snprintf(address, sizeof(address), "%s#line=1", path);
+    expect_value(cache, address, "changed");
+
+    unlink(path);
+    file_cache_begin(cache);
+    EXPECT_EQ(NEU_ERR_FILE_NOT_EXIST,
+              file_cache_read(cache, path, &value, &len));
+
+    file_cache_free(cache);
+}
+
+TEST(file_cache, poll) { read_selectors(FILE_MODE_POLL); }
+
+TEST(file_cache, watch) { read_selectors(FILE_MODE_WATCH); }
+
+TEST(file_cache, large)
+{
+    char path[] = "/tmp/file_cache_test_XXXXXX";
+    int  fd     = mkstemp(path);
+    ASSERT_LE(0, fd);
+    close(fd);
+
+    // 超过按区间读取的阈值，第 2、4 行超过点位值上限
+    std::string content = "head\n";
+    content += std::string(70000, 'x') + "\n";
+    content += "mid\r\n";
+    content += std::string(60000, 'y') + "\n";
+    content += "tail";
+    write_file(path, content.data(), content.size());
+
+    file_cache_t *cache = file_cache_new(FILE_MODE_POLL);
+    file_cache_begin(cache);
+
+    char address[64] = { 0 };
+    snprintf(address, sizeof(address), "%s#line=1", path);
+    expect_value(cache, address, "head");
+    snprintf(address, sizeof(address), "%s#line=3", path);
+    expect_value(cache, address, "mid");
+    snprintf(address, sizeof(address), "%s#line=5", path);
+    expect_value(cache, address, "tail");
+    snprintf(address, sizeof(address), "%s#bytes=70006,3", path);
+    expect_value(cache, address, "mid");
+    snprintf(address, sizeof(address), "%s#bytes=%zu", path,
+             content.size() - 4);
+    expect_value(cache, address, "tail");
+
+    const char *value = NULL;
+    size_t      len   = 0;
+    ASSERT_EQ(0, file_cache_read(cache, path, &value, &len));
+    EXPECT_EQ(FILE_VALUE_MAX, len);
+    EXPECT_EQ(0, memcmp(value, "head\nxxx", 8));
+
+    snprintf(address, sizeof(address), "%s#line=2", path);
+    ASSERT_EQ(0, file_cache_read(cache, address, &value, &len));
+    EXPECT_EQ(FILE_VALUE_MAX, len);
+    EXPECT_EQ('x', value[len - 1]);
+
+    snprintf(address, sizeof(address), "%s#line=6", path);
+    EXPECT_EQ(NEU_ERR_FILE_READ_FAILURE,
+              file_cache_read(cache, address, &value, &len));
+    snprintf(address, sizeof(address), "%s#bytes=%zu", path,
+             content.size() + 1);
+    EXPECT_EQ(NEU_ERR_FILE_READ_FAILURE,
+              file_cache_read(cache, address, &value, &len));
+
+    // 文件变化后各选择器重新读取
+    content.replace(content.size() - 4, 4, "end\r\n");
+    write_file(path, content.data(), content.size());
+    file_cache_begin(cache);
+    snprintf(address, sizeof(address), "%s#line=5", path);
+    expect_value(cache, address, "end");
+    snprintf(address, sizeof(address), "%s#line=6", path);
+    EXPECT_EQ(NEU_ERR_FILE_READ_FAILURE,
+              file_cache_read(cache, address, &value, &len));
+
+    file_cache_free(cache);
+    unlink(path);
+}
+
+int main(int argc, char **argv)
+{
+    zlog_init("./config/dev.conf");
+    neuron = zlog_get_category("neuron");
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
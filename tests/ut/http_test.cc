@@ -123,6 +123,57 @@ TEST(HTTPTest, http_get_param_str)
     nng_url_free(url);
 }
 
+typedef struct {
+    const char *range;
+    uint64_t    size;
+    int         rv;
+    uint64_t    start;
+    uint64_t    end;
+} range_data_t;
+
+TEST(HTTPTest, http_parse_range)
+{
+    const range_data_t data[] = {
+        { .range = NULL, .size = 100, .rv = 1 },
+        { .range = "items=0-1", .size = 100, .rv = 1 },
+        { .range = "bytes=0-1,5-6", .size = 100, .rv = 1 },
+        { .range = "bytes=x-1", .size = 100, .rv = 1 },
+        { .range = "bytes=5-1", .size = 100, .rv = 1 },
+
+        { .range = "bytes=0-0", .size = 100, .rv = 0 },
+        { .range = "bytes=10-19",
+          .size  = 100,
+          .rv    = 0,
+          .start = 10,
+          .end   = 19 },
+        { .range = "bytes=90-", .size = 100, .rv = 0, .start = 90, .end = 99 },
+        { .range = "bytes=90-200",
+          .size  = 100,
+          .rv    = 0,
+          .start = 90,
+          .end   = 99 },
+        { .range = "bytes=-10", .size = 100, .rv = 0, .start = 90, .end = 99 },
+        { .range = "bytes=-200", .size = 100, .rv = 0, .start = 0, .end = 99 },
+
+        { .range = "bytes=100-", .size = 100, .rv = -1 },
+        { .range = "bytes=-0", .size = 100, .rv = -1 },
+        { .range = "bytes=0-", .size = 0, .rv = -1 },
+    };
+
+    for (size_t i = 0; i < sizeof(data) / sizeof(data[0]); i++) {
+        uint64_t start = 0;
+        uint64_t end   = 0;
+
+        EXPECT_EQ(data[i].rv, neu_http_parse_range(data[i].range, data[i].size,
+                                                   &start, &end))
+            << i;
+        if (data[i].rv == 0) {
+            EXPECT_EQ(data[i].start, start) << i;
+            EXPECT_EQ(data[i].end, end) << i;
+        }
+    }
+}
+
 int main(int argc, char **argv)
 {
     zlog_init("./config/dev.conf");
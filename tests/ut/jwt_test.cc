@@ -2,6 +2,7 @@
 
 #include <gtest/gtest.h>
 
+#include "errcodes.h"
 #include "jwt.h"
 #include "utils/neu_jwt.h"
 
@@ -34,6 +35,38 @@ TEST(JwtTest, JwtValidate)
 
     jwt_free_str(token);
 }
+
+TEST(JwtTest, JwtValidateCached)
+{
+    char *token         = NULL;
+    char  b_token[1024] = { 0 };
+    char  user[64]      = { 0 };
+
+    EXPECT_EQ(0, neu_jwt_init((char *) "./config"));
+    EXPECT_EQ(0, neu_jwt_new(&token, "user1"));
+
+    snprintf(b_token, sizeof(b_token), "Bearer %s", token);
+
+    // 第二次起命中缓存
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(0, neu_jwt_validate(b_token));
+    }
+
+    neu_jwt_decode_user_after_valid(b_token, user);
+    EXPECT_STREQ("user1", user);
+
+    // 签名被篡改的 token 不会命中已缓存的原 token
+    char *sig = strrchr(b_token, '.') + 8;
+    *sig      = *sig == 'A' ? 'B' : 'A';
+    EXPECT_EQ(NEU_ERR_DECODE_TOKEN, neu_jwt_validate(b_token));
+    EXPECT_EQ(NEU_ERR_DECODE_TOKEN, neu_jwt_validate(b_token));
+
+    EXPECT_EQ(NEU_ERR_DECODE_TOKEN, neu_jwt_validate((char *) "Bearer a.b"));
+    EXPECT_EQ(NEU_ERR_NEED_TOKEN, neu_jwt_validate(NULL));
+
+    jwt_free_str(token);
+}
+
 int main(int argc, char **argv)
 {
     zlog_init("./config/dev.conf");
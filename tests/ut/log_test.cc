@@ -0,0 +1,173 @@
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "utils/log.h"
+
+zlog_category_t *neuron   = NULL;
+zlog_category_t *flap_log = NULL;
+
+static char g_dir[] = "/tmp/neu-log-test-XXXXXX";
+
+static std::vector<std::string> read_lines(const char *name)
+{
+    std::vector<std::string> lines;
+    char                     path[128] = {};
+    char                     buf[1024] = {};
+
+    snprintf(path, sizeof(path), "%s/%s.log", g_dir, name);
+    FILE *fp = fopen(path, "r");
+    if (fp == NULL) {
+        return lines;
+    }
+
+    while (fgets(buf, sizeof(buf), fp) != NULL) {
+        buf[strcspn(buf, "\n")] = '\0';
+        lines.push_back(buf);
+    }
+    fclose(fp);
+    return lines;
+}
+
+static void flap(int i)
+{
+    neu_log_at(flap_log, ZLOG_LEVEL_WARN, "flapping %d", i);
+}
+
+static void *thread_log(void *arg)
+{
+    for (int i = 0; i < 100; i++) {
+        nlog_notice("thread %d record %d", *(int *) arg, i);
+    }
+    return NULL;
+}
+
+TEST(LogTest, start)
+{
+    char conf[128] = {};
+
+    ASSERT_NE(nullptr, mkdtemp(g_dir));
+    snprintf(conf, sizeof(conf), "%s/zlog.conf", g_dir);
+
+    FILE *fp = fopen(conf, "w");
+    ASSERT_NE(nullptr, fp);
+    fprintf(fp,
+            "[formats]\n"
+            "simple = \"%%m%%n\"\n"
+            "[rules]\n"
+            "*.* \"%s/%%c.log\"; simple\n",
+            g_dir);
+    fclose(fp);
+
+    ASSERT_EQ(0, zlog_init(conf));
+    neuron = zlog_get_category("neuron");
+    ASSERT_NE(nullptr, neuron);
+    flap_log = zlog_get_category("flap");
+
+    EXPECT_EQ(0, neu_log_start());
+    EXPECT_EQ(-1, neu_log_start());
+}
+
+TEST(LogTest, order)
+{
+    neu_log_stats_t stats = {};
+    neu_log_stats(&stats);
+
+    for (int i = 0; i < 500; i++) {
+        nlog_notice("record %d", i);
+    }
+    neu_log_flush();
+
+    std::vector<std::string> lines = read_lines("neuron");
+    ASSERT_EQ(500u, lines.size());
+    for (int i = 0; i < 500; i++) {
+        EXPECT_EQ("record " + std::to_string(i), lines[i]);
+    }
+
+    neu_log_stats_t after = {};
+    neu_log_stats(&after);
+    EXPECT_EQ(stats.written + 500, after.written);
+    EXPECT_EQ(stats.rate_limited, after.rate_limited);
+}
+
+TEST(LogTest, threads)
+{
+    pthread_t       tids[4] = {};
+    int             ids[4]  = { 0, 1, 2, 3 };
+    neu_log_stats_t stats   = {};
+
+    for (int i = 0; i < 4; i++) {
+        ASSERT_EQ(0, pthread_create(&tids[i], NULL, thread_log, &ids[i]));
+    }
+    for (int i = 0; i < 4; i++) {
+        pthread_join(tids[i], NULL);
+    }
+    neu_log_flush();
+
+    // 退出线程的缓冲区读空后被释放，只剩测试线程的缓冲区
+    neu_log_stats(&stats);
+    EXPECT_EQ(1u, stats.rings);
+    EXPECT_EQ(900u, read_lines("neuron").size());
+}
+
+TEST(LogTest, rate_limit)
+{
+    neu_log_stats_t stats = {};
+    neu_log_stats(&stats);
+
+    neu_log_set_limit(1, 5);
+    for (int i = 0; i < 100; i++) {
+        flap(i);
+    }
+    neu_log_flush();
+
+    std::vector<std::string> lines = read_lines("flap");
+    ASSERT_EQ(5u, lines.size());
+    EXPECT_EQ("flapping 4", lines.back());
+
+    neu_log_stats_t after = {};
+    neu_log_stats(&after);
+    EXPECT_EQ(stats.rate_limited + 95, after.rate_limited);
+
+    // 补充令牌后写出的记录带上期间被丢弃的条数
+    sleep(1);
+    flap(100);
+    flap(101);
+    neu_log_flush();
+
+    lines = read_lines("flap");
+    ASSERT_EQ(6u, lines.size());
+    EXPECT_EQ("flapping 100 (95 similar logs suppressed)", lines.back());
+
+    neu_log_set_limit(NEU_LOG_SITE_RATE, NEU_LOG_SITE_BURST);
+}
+
+TEST(LogTest, stop)
+{
+    nlog_notice("before stop");
+    neu_log_stop();
+    EXPECT_EQ("before stop", read_lines("neuron").back());
+
+    // 停止后同步写出
+    neu_log_stats_t stats = {};
+    neu_log_stats(&stats);
+    nlog_notice("after stop");
+    EXPECT_EQ("after stop", read_lines("neuron").back());
+
+    neu_log_stats_t after = {};
+    neu_log_stats(&after);
+    EXPECT_EQ(stats.direct + 1, after.direct);
+
+    zlog_fini();
+
+    char cmd[64] = {};
+    snprintf(cmd, sizeof(cmd), "rm -rf %s", g_dir);
+    EXPECT_EQ(0, system(cmd));
+}
@@ -3,11 +3,11 @@
 #include <neuron.h>
 extern "C" {
 #include "modbus.h"
+#include "modbus_bus.h"
 #include "modbus_point.h"
 }
 
-zlog_category_t *neuron           = NULL;
-int64_t          global_timestamp = 0;
+zlog_category_t *neuron = NULL;
 
 TEST(test_modbus_header_wrap, should_return_right_header_value)
 {
@@ -154,6 +154,307 @@ TEST(test_modbus_data_unwrap, should_return_right_data_value)
     EXPECT_EQ(0x44, *(bytes + 3));
 }
 
+static modbus_read_cmd_sort_t *read_cmd_sort(UT_array *points,
+                                             const char **addresses,
+                                             neu_type_e * types, int n)
+{
+    for (int i = 0; i < n; i++) {
+        neu_datatag_t   tag = { 0 };
+        modbus_point_t *p   = (modbus_point_t *) calloc(1, sizeof(*p));
+
+        tag.name      = (char *) "tag";
+        tag.address   = (char *) addresses[i];
+        tag.type      = types[i];
+        tag.attribute = NEU_ATTRIBUTE_READ;
+        EXPECT_EQ(0, modbus_tag_to_point(&tag, p, base_1));
+        utarray_push_back(points, &p);
+    }
+
+    return modbus_tag_sort(points, 0xfa);
+}
+
+static void read_cmd_sort_free(UT_array *points, modbus_read_cmd_sort_t *sort)
+{
+    modbus_tag_sort_free(sort);
+    utarray_foreach(points, modbus_point_t **, p)
+    {
+        free(*p);
+    }
+    utarray_free(points);
+}
+
+TEST(test_modbus_read_cmd_decode, should_decode_mixed_tags)
+{
+    UT_array *  points      = NULL;
+    const char *addresses[] = { "1!40001", "1!40002", "1!40004.3",
+                                "1!40005#BB", "1!40007.4H" };
+    neu_type_e  types[]     = { NEU_TYPE_INT16, NEU_TYPE_FLOAT, NEU_TYPE_BIT,
+                           NEU_TYPE_UINT32, NEU_TYPE_STRING };
+    uint8_t     bytes[]     = { 0xff, 0xfe, 0x00, 0x00, 0x3f, 0x80, 0x00,
+                            0x08, 0x11, 0x22, 0x33, 0x44, 'a',  'b',
+                            'c',  'd' };
+
+    utarray_new(points, &ut_ptr_icd);
+    modbus_read_cmd_sort_t *sort = read_cmd_sort(points, addresses, types, 5);
+    ASSERT_EQ(1, sort->n_cmd);
+
+    modbus_read_cmd_t *cmd = &sort->cmd[0];
+    modbus_read_cmd_decode(cmd, 1, bytes, sizeof(bytes), MODBUS_CDAB);
+
+    EXPECT_EQ(NEU_TYPE_INT16, cmd->values[0].type);
+    EXPECT_EQ(-2, cmd->values[0].value.i16);
+    EXPECT_EQ(NEU_TYPE_FLOAT, cmd->values[1].type);
+    EXPECT_FLOAT_EQ(1.0, cmd->values[1].value.f32);
+    EXPECT_EQ(1, cmd->values[2].value.u8);
+    EXPECT_EQ(0x11223344u, cmd->values[3].value.u32);
+    EXPECT_STREQ("abcd", cmd->values[4].value.str);
+
+    read_cmd_sort_free(points, sort);
+}
+
+TEST(test_modbus_read_cmd_decode, should_return_error_on_slave_mismatch)
+{
+    UT_array *  points      = NULL;
+    const char *addresses[] = { "1!00001", "1!00002" };
+    neu_type_e  types[]     = { NEU_TYPE_BIT, NEU_TYPE_BIT };
+    uint8_t     bytes[]     = { 0x02 };
+
+    utarray_new(points, &ut_ptr_icd);
+    modbus_read_cmd_sort_t *sort = read_cmd_sort(points, addresses, types, 2);
+    ASSERT_EQ(1, sort->n_cmd);
+
+    modbus_read_cmd_t *cmd = &sort->cmd[0];
+    modbus_read_cmd_decode(cmd, 1, bytes, sizeof(bytes), MODBUS_ABCD);
+    EXPECT_EQ(0, cmd->values[0].value.u8);
+    EXPECT_EQ(1, cmd->values[1].value.u8);
+
+    modbus_read_cmd_decode(cmd, 2, bytes, sizeof(bytes), MODBUS_ABCD);
+    EXPECT_EQ(NEU_TYPE_ERROR, cmd->values[0].type);
+    EXPECT_EQ(NEU_ERR_PLUGIN_READ_FAILURE, cmd->values[1].value.i32);
+
+    read_cmd_sort_free(points, sort);
+}
+
+static modbus_write_cmd_sort_t *write_cmd_sort(UT_array *   points,
+                                               const char **addresses,
+                                               neu_type_e * types,
+                                               neu_value_u *values, int n)
+{
+    for (int i = 0; i < n; i++) {
+        neu_datatag_t          tag = { 0 };
+        neu_plugin_tag_value_t tv  = { 0 };
+        modbus_point_write_t * p =
+            (modbus_point_write_t *) calloc(1, sizeof(*p));
+
+        tag.name      = (char *) "tag";
+        tag.address   = (char *) addresses[i];
+        tag.type      = types[i];
+        tag.attribute = NEU_ATTRIBUTE_WRITE;
+        tv.tag        = &tag;
+        tv.value      = values[i];
+        EXPECT_EQ(0, modbus_write_tag_to_point(&tv, p, base_1));
+        utarray_push_back(points, &p);
+    }
+
+    return modbus_write_tags_sort(points, MODBUS_ABCD);
+}
+
+static void write_cmd_sort_free(UT_array *points, modbus_write_cmd_sort_t *sort)
+{
+    for (uint16_t i = 0; i < sort->n_cmd; i++) {
+        utarray_free(sort->cmd[i].tags);
+        free(sort->cmd[i].bytes);
+    }
+    free(sort->cmd);
+    free(sort);
+    utarray_foreach(points, modbus_point_write_t **, p) { free(*p); }
+    utarray_free(points);
+}
+
+TEST(test_modbus_write_cmd_sort, should_merge_contiguous_registers)
+{
+    UT_array *  points      = NULL;
+    const char *addresses[] = { "1!40004", "1!40001", "1!40002", "1!40010",
+                                "2!40005" };
+    neu_type_e  types[]     = { NEU_TYPE_INT16, NEU_TYPE_INT16, NEU_TYPE_UINT32,
+                           NEU_TYPE_INT16, NEU_TYPE_INT16 };
+    neu_value_u values[5]   = { 0 };
+
+    values[0].i16 = 4;
+    values[1].i16 = 1;
+    values[2].u32 = 0x11223344;
+    values[3].i16 = 10;
+    values[4].i16 = 5;
+
+    utarray_new(points, &ut_ptr_icd);
+    modbus_write_cmd_sort_t *sort =
+        write_cmd_sort(points, addresses, types, values, 5);
+    ASSERT_EQ(3, sort->n_cmd);
+
+    // 40001 ~ 40004 合并为一帧，40010 与前面有空隙，不合并
+    uint8_t bytes[] = { 0x00, 0x01, 0x11, 0x22, 0x33, 0x44, 0x00, 0x04 };
+    EXPECT_EQ(1, sort->cmd[0].slave_id);
+    EXPECT_EQ(0, sort->cmd[0].start_address);
+    EXPECT_EQ(4, sort->cmd[0].n_register);
+    EXPECT_EQ(8, sort->cmd[0].n_byte);
+    EXPECT_EQ(3u, utarray_len(sort->cmd[0].tags));
+    EXPECT_EQ(0, memcmp(bytes, sort->cmd[0].bytes, sizeof(bytes)));
+
+    EXPECT_EQ(9, sort->cmd[1].start_address);
+    EXPECT_EQ(1, sort->cmd[1].n_register);
+    EXPECT_EQ(2, sort->cmd[2].slave_id);
+
+    write_cmd_sort_free(points, sort);
+}
+
+TEST(test_modbus_write_cmd_sort, should_pack_coils_by_address)
+{
+    UT_array *  points      = NULL;
+    const char *addresses[] = { "1!00003", "1!00001", "1!00002", "1!00002" };
+    neu_type_e  types[]     = { NEU_TYPE_BIT, NEU_TYPE_BIT, NEU_TYPE_BIT,
+                           NEU_TYPE_BIT };
+    neu_value_u values[4]   = { 0 };
+
+    values[0].u8 = 1;
+    values[1].u8 = 1;
+    values[2].u8 = 1;
+    values[3].u8 = 0;
+
+    utarray_new(points, &ut_ptr_icd);
+    modbus_write_cmd_sort_t *sort =
+        write_cmd_sort(points, addresses, types, values, 4);
+    ASSERT_EQ(1, sort->n_cmd);
+
+    // 重复的地址以请求中靠后的值为准
+    EXPECT_EQ(3, sort->cmd[0].n_register);
+    EXPECT_EQ(3, sort->cmd[0].n_byte);
+    EXPECT_EQ(0x05, sort->cmd[0].bytes[0]);
+
+    write_cmd_sort_free(points, sort);
+}
+
+TEST(test_modbus_write_cmd_sort, should_split_at_protocol_limit)
+{
+    UT_array *  points = NULL;
+    const int   n      = 2000;
+    char        addresses[2000][16];
+    const char *address_ptrs[2000];
+    neu_type_e  types[2000];
+    neu_value_u values[2000];
+
+    memset(values, 0, sizeof(values));
+
+    for (int i = 0; i < n; i++) {
+        snprintf(addresses[i], sizeof(addresses[i]), "1!%05d", i + 1);
+        address_ptrs[i] = addresses[i];
+        types[i]        = NEU_TYPE_BIT;
+    }
+    utarray_new(points, &ut_ptr_icd);
+    modbus_write_cmd_sort_t *sort =
+        write_cmd_sort(points, address_ptrs, types, values, n);
+    ASSERT_EQ(2, sort->n_cmd);
+    EXPECT_EQ(MODBUS_WRITE_MAX_COIL, sort->cmd[0].n_byte);
+    EXPECT_EQ(n - MODBUS_WRITE_MAX_COIL, sort->cmd[1].n_byte);
+    write_cmd_sort_free(points, sort);
+
+    for (int i = 0; i < 130; i++) {
+        snprintf(addresses[i], sizeof(addresses[i]), "1!4%04d", i + 1);
+        types[i] = NEU_TYPE_UINT16;
+    }
+    utarray_new(points, &ut_ptr_icd);
+    sort = write_cmd_sort(points, address_ptrs, types, values, 130);
+    ASSERT_EQ(2, sort->n_cmd);
+    EXPECT_EQ(MODBUS_WRITE_MAX_REGISTER, sort->cmd[0].n_register);
+    EXPECT_EQ(MODBUS_WRITE_MAX_REGISTER * 2, sort->cmd[0].n_byte);
+    EXPECT_EQ(130 - MODBUS_WRITE_MAX_REGISTER, sort->cmd[1].n_register);
+    write_cmd_sort_free(points, sort);
+}
+
+TEST(test_modbus_rtu_timing, should_follow_baud_rate)
+{
+    modbus_rtu_timing_t timing = { 0 };
+
+    // 9600 8N1: 10 位，每字符约 1042us
+    ASSERT_EQ(0,
+              modbus_rtu_timing(NEU_CONN_TTY_BAUD_9600, NEU_CONN_TTY_DATA_8,
+                                NEU_CONN_TTY_PARITY_NONE, NEU_CONN_TTY_STOP_1,
+                                &timing));
+    EXPECT_EQ(1042, timing.char_us);
+    EXPECT_EQ(1563, timing.t15_us);
+    EXPECT_EQ(3646, timing.t35_us);
+
+    // 9600 8E1: 11 位
+    ASSERT_EQ(0,
+              modbus_rtu_timing(NEU_CONN_TTY_BAUD_9600, NEU_CONN_TTY_DATA_8,
+                                NEU_CONN_TTY_PARITY_EVEN, NEU_CONN_TTY_STOP_1,
+                                &timing));
+    EXPECT_EQ(4011, timing.t35_us);
+
+    // 高于 19200 时使用固定值
+    ASSERT_EQ(0,
+              modbus_rtu_timing(NEU_CONN_TTY_BAUD_115200, NEU_CONN_TTY_DATA_8,
+                                NEU_CONN_TTY_PARITY_NONE, NEU_CONN_TTY_STOP_1,
+                                &timing));
+    EXPECT_EQ(87, timing.char_us);
+    EXPECT_EQ(750, timing.t15_us);
+    EXPECT_EQ(1750, timing.t35_us);
+
+    EXPECT_EQ(-1,
+              modbus_rtu_timing((neu_conn_tty_baud_e) 100, NEU_CONN_TTY_DATA_8,
+                                NEU_CONN_TTY_PARITY_NONE, NEU_CONN_TTY_STOP_1,
+                                &timing));
+}
+
+TEST(test_modbus_bus, should_keep_frame_gap)
+{
+    modbus_bus_t        bus    = {};
+    modbus_rtu_timing_t timing = { 1000, 1500, 3500 };
+
+    // 用户配置的发送间隔小于 t3.5 时使用 t3.5
+    modbus_bus_config(&bus, &timing, 0);
+    EXPECT_EQ(3500, bus.gap_us);
+    modbus_bus_config(&bus, &timing, 5);
+    EXPECT_EQ(5000, bus.gap_us);
+
+    modbus_bus_config(&bus, &timing, 0);
+    modbus_bus_before_send(&bus, 1, 8);
+    modbus_bus_after_recv(&bus, 7);
+    int64_t idle = bus.idle_us;
+    modbus_bus_before_send(&bus, 2, 8);
+    EXPECT_GE(bus.tx_us - idle, 3500);
+
+    // 超时计入从站统计
+    modbus_bus_after_recv(&bus, 0);
+    EXPECT_EQ(1, bus.slaves[1].n_request);
+    EXPECT_EQ(0, bus.slaves[1].n_timeout);
+    EXPECT_EQ(1, bus.slaves[2].n_request);
+    EXPECT_EQ(1, bus.slaves[2].n_timeout);
+    EXPECT_EQ((8 + 7 + 8) * 1000, bus.wire_us);
+}
+
+TEST(test_modbus_bus, should_schedule_by_deadline)
+{
+    int64_t  due[5]   = { 30, 10, 20, 10, 0 };
+    uint16_t order[5] = { 0, 1, 2, 3, 4 };
+
+    modbus_bus_schedule(due, order, 5);
+    EXPECT_EQ(4, order[0]);
+    EXPECT_EQ(1, order[1]);
+    EXPECT_EQ(3, order[2]);
+    EXPECT_EQ(2, order[3]);
+    EXPECT_EQ(0, order[4]);
+
+    // 未执行的命令保留原截止时间，下一次排在前面
+    due[4] = 40;
+    due[1] = 50;
+    modbus_bus_schedule(due, order, 5);
+    EXPECT_EQ(3, order[0]);
+    EXPECT_EQ(2, order[1]);
+    EXPECT_EQ(0, order[2]);
+    EXPECT_EQ(4, order[3]);
+    EXPECT_EQ(1, order[4]);
+}
+
 int main(int argc, char **argv)
 {
     zlog_init("./config/dev.conf");
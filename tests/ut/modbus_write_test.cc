@@ -0,0 +1,181 @@
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "modbus_req.h"
+}
+
+zlog_category_t *neuron = NULL;
+
+#define BAD_SLAVE 2
+#define SILENT_SLAVE 3
+
+static std::vector<neu_driver_write_responses_t> responses;
+
+static void write_responses(neu_adapter_t *adapter, void *req,
+                            neu_driver_write_responses_t *resp, int n_resp)
+{
+    (void) adapter;
+    (void) req;
+    responses.assign(resp, resp + n_resp);
+}
+
+// 应答写请求的 Modbus TCP 从站，对 BAD_SLAVE 返回异常，不应答 SILENT_SLAVE
+static void slave_serve(int listen_fd)
+{
+    int     fd      = accept(listen_fd, NULL, NULL);
+    uint8_t req[64] = { 0 };
+
+    while (fd >= 0 && recv(fd, req, 7, MSG_WAITALL) == 7) {
+        uint16_t len = (req[4] << 8) | req[5];
+        if (len < 2 || len > sizeof(req) - 7 ||
+            recv(fd, req + 7, len - 1, MSG_WAITALL) != len - 1) {
+            break;
+        }
+
+        uint8_t resp[12] = { 0 };
+        memcpy(resp, req, 7);
+        if (req[6] == SILENT_SLAVE) {
+            continue;
+        } else if (req[6] == BAD_SLAVE) {
+            // 非法数据地址
+            resp[5] = 3;
+            resp[7] = req[7] | 0x80;
+            resp[8] = 0x02;
+            send(fd, resp, 9, 0);
+        } else {
+            // 写单个/多个线圈与寄存器的正常响应均为请求 PDU 的前 5 个字节
+            resp[5] = 6;
+            memcpy(resp + 7, req + 7, 5);
+            send(fd, resp, 12, 0);
+        }
+    }
+
+    if (fd >= 0) {
+        close(fd);
+    }
+}
+
+class ModbusWriteTest : public testing::Test {
+protected:
+    neu_plugin_t        plugin    = {};
+    adapter_callbacks_t callbacks = {};
+    int                 listen_fd = -1;
+    std::thread         slave;
+
+    void SetUp() override
+    {
+        struct sockaddr_in addr     = {};
+        socklen_t          addr_len = sizeof(addr);
+
+        listen_fd            = socket(AF_INET, SOCK_STREAM, 0);
+        addr.sin_family      = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        ASSERT_EQ(0, bind(listen_fd, (struct sockaddr *) &addr, sizeof(addr)));
+        ASSERT_EQ(0, listen(listen_fd, 1));
+        ASSERT_EQ(0,
+                  getsockname(listen_fd, (struct sockaddr *) &addr, &addr_len));
+        slave = std::thread(slave_serve, listen_fd);
+
+        callbacks.driver.write_responses = write_responses;
+        plugin.common.adapter_callbacks  = &callbacks;
+        plugin.protocol                  = MODBUS_PROTOCOL_TCP;
+        plugin.endianess                 = MODBUS_ABCD;
+        plugin.address_base              = base_1;
+        plugin.stack = modbus_stack_create(&plugin, MODBUS_PROTOCOL_TCP,
+                                           modbus_send_msg, modbus_value_handle,
+                                           modbus_write_resp);
+
+        neu_conn_param_t param          = {};
+        param.type                      = NEU_CONN_TCP_CLIENT;
+        param.params.tcp_client.ip      = (char *) "127.0.0.1";
+        param.params.tcp_client.port    = ntohs(addr.sin_port);
+        param.params.tcp_client.timeout = 200;
+        plugin.conn = neu_conn_new(&param, &plugin, modbus_conn_connected,
+                                   modbus_conn_disconnected);
+        responses.clear();
+    }
+
+    void TearDown() override
+    {
+        neu_conn_destory(plugin.conn);
+        modbus_stack_destroy(plugin.stack);
+        slave.join();
+        close(listen_fd);
+    }
+
+    int write(const std::vector<std::string> &addresses)
+    {
+        UT_icd    icd  = { sizeof(neu_plugin_tag_value_t), NULL, NULL, NULL };
+        UT_array *tags = NULL;
+        std::vector<neu_datatag_t> datatags(addresses.size());
+        std::vector<std::string>   names;
+
+        for (size_t i = 0; i < addresses.size(); i++) {
+            names.push_back("tag" + std::to_string(i));
+        }
+
+        utarray_new(tags, &icd);
+        for (size_t i = 0; i < addresses.size(); i++) {
+            neu_plugin_tag_value_t tv = {};
+
+            datatags[i].name      = (char *) names[i].c_str();
+            datatags[i].address   = (char *) addresses[i].c_str();
+            datatags[i].type      = addresses[i].find("!0") != std::string::npos
+                     ? NEU_TYPE_BIT
+                     : NEU_TYPE_INT16;
+            datatags[i].attribute = NEU_ATTRIBUTE_WRITE;
+            tv.tag                = &datatags[i];
+            tv.value.i16          = (int16_t) i;
+            utarray_push_back(tags, &tv);
+        }
+
+        int ret = modbus_write_tags(&plugin, NULL, tags);
+        utarray_free(tags);
+        return ret;
+    }
+};
+
+TEST_F(ModbusWriteTest, per_tag_results)
+{
+    // 1!400001 与 1!400002 合并为一帧，各帧结果分别返回给帧内的点位
+    int ret = write({ "1!400001", "2!400001", "1!400002", "1!000001",
+                      "3!400001" });
+    EXPECT_EQ(NEU_ERR_PLUGIN_WRITE_FAILURE, ret);
+
+    ASSERT_EQ(5, responses.size());
+    EXPECT_STREQ("tag0", responses[0].name);
+    EXPECT_EQ(NEU_ERR_SUCCESS, responses[0].error);
+    EXPECT_STREQ("tag1", responses[1].name);
+    EXPECT_EQ(NEU_ERR_PLUGIN_WRITE_FAILURE, responses[1].error);
+    EXPECT_STREQ("tag2", responses[2].name);
+    EXPECT_EQ(NEU_ERR_SUCCESS, responses[2].error);
+    EXPECT_STREQ("tag3", responses[3].name);
+    EXPECT_EQ(NEU_ERR_SUCCESS, responses[3].error);
+    EXPECT_STREQ("tag4", responses[4].name);
+    EXPECT_EQ(NEU_ERR_PLUGIN_DEVICE_NOT_RESPONSE, responses[4].error);
+
+    // 组名由驱动按请求补全
+    for (const auto &resp : responses) {
+        EXPECT_STREQ("", resp.group);
+    }
+}
+
+TEST_F(ModbusWriteTest, all_success)
+{
+    EXPECT_EQ(NEU_ERR_SUCCESS, write({ "1!400001", "1!400003", "1!000002" }));
+
+    ASSERT_EQ(3, responses.size());
+    for (const auto &resp : responses) {
+        EXPECT_EQ(NEU_ERR_SUCCESS, resp.error);
+    }
+}
@@ -4,8 +4,7 @@
 
 #include "mqtt/schema.h"
 
-int64_t          global_timestamp = 0;
-zlog_category_t *neuron           = NULL;
+zlog_category_t *neuron = NULL;
 
 TEST(validate_success, schema)
 {
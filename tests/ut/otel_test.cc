@@ -0,0 +1,168 @@
+#include <string.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+
+#include "otel/otel_manager.h"
+#include "parser/neu_json_otel.h"
+#include "utils/log.h"
+
+zlog_category_t *neuron = NULL;
+
+// 替换 neuron-base 中的实现，记录导出请求而不访问网络
+static int g_post_status = 200;
+static int g_post_count  = 0;
+
+extern "C" int neu_http_post_otel_trace(uint8_t *data, int len)
+{
+    (void) data;
+    (void) len;
+    __atomic_fetch_add(&g_post_count, 1, __ATOMIC_RELAXED);
+    return __atomic_load_n(&g_post_status, __ATOMIC_RELAXED);
+}
+
+static void set_config(double rate)
+{
+    neu_json_otel_conf_req_t req = {};
+    req.action                   = (char *) "start";
+    req.collector_url            = (char *) "127.0.0.1:4318";
+    req.service_name             = (char *) "neuron";
+    req.data_flag                = true;
+    req.data_sample_rate         = rate;
+    neu_otel_set_config(&req);
+}
+
+static void finish_trace(intptr_t key)
+{
+    char trace_id[64] = { 0 };
+    char span_id[36]  = { 0 };
+
+    neu_otel_new_trace_id(trace_id);
+    neu_otel_new_span_id(span_id);
+
+    neu_otel_trace_ctx trace =
+        neu_otel_create_trace(trace_id, (void *) key, 0, NULL);
+    ASSERT_NE(nullptr, trace);
+    neu_otel_scope_ctx scope = neu_otel_add_span(trace);
+    neu_otel_scope_set_span_name(scope, "test");
+    neu_otel_scope_set_span_id(scope, span_id);
+    neu_otel_scope_set_span_start_time(scope, 1);
+    neu_otel_scope_set_span_end_time(scope, 2);
+    neu_otel_trace_set_final(trace);
+}
+
+static neu_otel_stats_t wait_stats(uint64_t exported)
+{
+    neu_otel_stats_t stats = {};
+    for (int i = 0; i < 100; i++) {
+        neu_otel_get_stats(&stats);
+        if (stats.exported >= exported) {
+            break;
+        }
+        usleep(20 * 1000);
+    }
+    return stats;
+}
+
+TEST(OtelTest, batch_export)
+{
+    set_config(1.0);
+    __atomic_store_n(&g_post_status, 200, __ATOMIC_RELAXED);
+    __atomic_store_n(&g_post_count, 0, __ATOMIC_RELAXED);
+
+    for (intptr_t i = 1; i <= 100; i++) {
+        finish_trace(i);
+    }
+    neu_otel_start();
+
+    neu_otel_stats_t stats = wait_stats(100);
+    EXPECT_EQ(100u, stats.exported);
+    EXPECT_EQ(0u, stats.traces);
+    EXPECT_EQ(0u, stats.queued_traces);
+    EXPECT_EQ(0u, stats.queued_bytes);
+    // 一轮收集到的追踪合并成一次请求
+    EXPECT_EQ(1, __atomic_load_n(&g_post_count, __ATOMIC_RELAXED));
+
+    neu_otel_stop();
+}
+
+TEST(OtelTest, retry_after_failure)
+{
+    neu_otel_stats_t before = {};
+    neu_otel_get_stats(&before);
+
+    __atomic_store_n(&g_post_status, 503, __ATOMIC_RELAXED);
+    for (intptr_t i = 1; i <= 10; i++) {
+        finish_trace(i);
+    }
+    neu_otel_start();
+
+    neu_otel_stats_t stats = {};
+    for (int i = 0; i < 100 && stats.export_failures == 0; i++) {
+        usleep(20 * 1000);
+        neu_otel_get_stats(&stats);
+    }
+    EXPECT_LT(before.export_failures, stats.export_failures);
+    EXPECT_EQ(10u, stats.queued_traces);
+    EXPECT_EQ(0u, stats.traces);
+
+    // 追踪表不再被发送阻塞
+    EXPECT_NE(nullptr, neu_otel_create_trace("0123", (void *) 100, 0, NULL));
+
+    __atomic_store_n(&g_post_status, 200, __ATOMIC_RELAXED);
+    stats = wait_stats(before.exported + 10);
+    EXPECT_EQ(before.exported + 10, stats.exported);
+    EXPECT_EQ(0u, stats.queued_traces);
+
+    neu_otel_stop();
+}
+
+TEST(OtelTest, trace_limit)
+{
+    neu_otel_stats_t before = {};
+    neu_otel_get_stats(&before);
+
+    // 未启动导出时追踪只进不出
+    neu_otel_trace_ctx trace = NULL;
+    intptr_t           key   = 1;
+    for (; key <= 100000; key++) {
+        trace = neu_otel_create_trace("0123", (void *) key, 0, NULL);
+        if (trace == NULL) {
+            break;
+        }
+    }
+    ASSERT_EQ(nullptr, trace);
+
+    neu_otel_stats_t stats = {};
+    neu_otel_get_stats(&stats);
+    EXPECT_EQ((uint64_t) key - 1, stats.traces);
+    EXPECT_EQ(before.dropped_limit + 1, stats.dropped_limit);
+
+    // 未创建的追踪可以照常传给 span 接口
+    neu_otel_scope_ctx scope = neu_otel_add_span(trace);
+    EXPECT_EQ(nullptr, scope);
+    neu_otel_scope_set_span_name(scope, "dropped");
+    neu_otel_scope_add_span_attr_int(scope, "k", 1);
+    neu_otel_scope_set_span_end_time(scope, 1);
+    neu_otel_trace_set_final(trace);
+
+    neu_otel_stop();
+    neu_otel_get_stats(&stats);
+    EXPECT_EQ(0u, stats.traces);
+}
+
+TEST(OtelTest, data_sample)
+{
+    int sampled = 0;
+
+    set_config(0.25);
+    for (int i = 0; i < 100000; i++) {
+        sampled += neu_otel_data_sampled();
+    }
+    EXPECT_NEAR(25000, sampled, 1000);
+
+    set_config(0.0);
+    EXPECT_FALSE(neu_otel_data_sampled());
+    set_config(1.0);
+    EXPECT_TRUE(neu_otel_data_sampled());
+}
@@ -0,0 +1,251 @@
+#include <pthread.h>
+#include <unistd.h>
+
+#include <gtest/gtest.h>
+#include <sqlite3.h>
+
+#include "persist/queue.h"
+#include "utils/log.h"
+
+zlog_category_t *neuron = NULL;
+
+typedef struct {
+    neu_persister_t base;
+    sqlite3 *       db;
+} fake_persister_t;
+
+static void *fake_native_handle(neu_persister_t *self)
+{
+    return ((fake_persister_t *) self)->db;
+}
+
+static struct neu_persister_vtbl_s fake_vtbl = {};
+
+static int  n_exec  = 0;
+static int  blocked = 0;
+static bool release = false;
+
+static int exec_block(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    (void) impl;
+    (void) cmd;
+
+    __atomic_store_n(&blocked, 1, __ATOMIC_SEQ_CST);
+    while (!__atomic_load_n(&release, __ATOMIC_SEQ_CST)) {
+        usleep(1000);
+    }
+    return 0;
+}
+
+static void *call_block(void *arg)
+{
+    (void) arg;
+
+    persist_cmd_t cmd = {};
+    cmd.exec          = exec_block;
+    persist_queue_call(&cmd);
+    return NULL;
+}
+
+// 写入 (num[0], num[1])，num[1] 为负时写入后返回失败
+static int exec_insert(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    sqlite3 *db  = (sqlite3 *) impl->vtbl->native_handle(impl);
+    char *   sql = sqlite3_mprintf("INSERT OR REPLACE INTO kv VALUES (%lld, %lld)",
+                                (long long) cmd->num[0],
+                                (long long) cmd->num[1]);
+
+    n_exec += 1;
+    int rv = sqlite3_exec(db, sql, NULL, NULL, NULL);
+    sqlite3_free(sql);
+
+    return (rv == SQLITE_OK && cmd->num[1] >= 0) ? 0 : -1;
+}
+
+static int row_cb(void *arg, int n, char **values, char **names)
+{
+    (void) n;
+    (void) names;
+    *(long long *) arg = atoll(values[0]);
+    return 0;
+}
+
+static int exec_select(neu_persister_t *impl, persist_cmd_t *cmd)
+{
+    sqlite3 *db  = (sqlite3 *) impl->vtbl->native_handle(impl);
+    char *   sql = sqlite3_mprintf("SELECT v FROM kv WHERE k = %lld",
+                                (long long) cmd->num[0]);
+    *(long long *) cmd->out = -1;
+
+    int rv = sqlite3_exec(db, sql, row_cb, cmd->out, NULL);
+    sqlite3_free(sql);
+    return rv == SQLITE_OK ? 0 : -1;
+}
+
+static void push_insert(int64_t k, int64_t v, const char *key)
+{
+    persist_cmd_t *cmd = (persist_cmd_t *) calloc(1, sizeof(persist_cmd_t));
+
+    cmd->exec   = exec_insert;
+    cmd->num[0] = k;
+    cmd->num[1] = v;
+    cmd->key    = key ? strdup(key) : NULL;
+    persist_queue_push(cmd);
+}
+
+static long long select_value(int64_t k)
+{
+    long long     v   = 0;
+    persist_cmd_t cmd = {};
+
+    cmd.exec   = exec_select;
+    cmd.num[0] = k;
+    cmd.out    = &v;
+    EXPECT_EQ(0, persist_queue_call(&cmd));
+    return v;
+}
+
+static fake_persister_t persister = {};
+
+TEST(PersistQueueTest, start)
+{
+    fake_vtbl.native_handle = fake_native_handle;
+    persister.base.vtbl     = &fake_vtbl;
+
+    ASSERT_EQ(SQLITE_OK, sqlite3_open(":memory:", &persister.db));
+    ASSERT_EQ(SQLITE_OK,
+              sqlite3_exec(persister.db,
+                           "CREATE TABLE kv (k INTEGER PRIMARY KEY, v INTEGER)",
+                           NULL, NULL, NULL));
+
+    EXPECT_EQ(0, persist_queue_start(&persister.base));
+    EXPECT_EQ(-1, persist_queue_start(&persister.base));
+}
+
+TEST(PersistQueueTest, coalesce)
+{
+    pthread_t             tid;
+    persist_queue_stats_t stats = {};
+
+    // 阻塞持久化线程，让后续命令积压在队列中
+    ASSERT_EQ(0, pthread_create(&tid, NULL, call_block, NULL));
+    while (!__atomic_load_n(&blocked, __ATOMIC_SEQ_CST)) {
+        usleep(1000);
+    }
+
+    n_exec = 0;
+    for (int i = 0; i < 100; i++) {
+        push_insert(1, i, "k1");
+    }
+    // 不可合并的命令之后，同 key 命令不再与之前的合并
+    push_insert(2, 2, NULL);
+    push_insert(1, 1000, "k1");
+
+    persist_queue_stats(&stats);
+    EXPECT_EQ(3, stats.pending);
+    EXPECT_EQ(99, stats.coalesced);
+
+    __atomic_store_n(&release, true, __ATOMIC_SEQ_CST);
+    pthread_join(tid, NULL);
+
+    EXPECT_EQ(0, persist_queue_sync());
+    EXPECT_EQ(3, n_exec);
+    EXPECT_EQ(1000, select_value(1));
+    EXPECT_EQ(2, select_value(2));
+}
+
+TEST(PersistQueueTest, failure)
+{
+    push_insert(3, 3, NULL);
+    push_insert(4, -4, NULL);
+    push_insert(5, 5, NULL);
+
+    // 失败的命令只回滚自身
+    EXPECT_NE(0, persist_queue_sync());
+    EXPECT_EQ(3, select_value(3));
+    EXPECT_EQ(-1, select_value(4));
+    EXPECT_EQ(5, select_value(5));
+
+    EXPECT_EQ(0, persist_queue_sync());
+}
+
+static void ticket_cb(int rv, void *arg)
+{
+    *(int *) arg = rv;
+}
+
+static persist_ticket_t *track_insert(int64_t k, int64_t v, const char *key)
+{
+    persist_queue_track_begin(NULL);
+    push_insert(k, v, key);
+    persist_ticket_t *ticket = persist_queue_track_take();
+    persist_queue_track_end();
+    return ticket;
+}
+
+TEST(PersistQueueTest, ticket)
+{
+    pthread_t tid;
+    int       rv_a = 1;
+    int       rv_b = 0;
+    int       rv_c = 1;
+
+    __atomic_store_n(&blocked, 0, __ATOMIC_SEQ_CST);
+    __atomic_store_n(&release, false, __ATOMIC_SEQ_CST);
+    ASSERT_EQ(0, pthread_create(&tid, NULL, call_block, NULL));
+    while (!__atomic_load_n(&blocked, __ATOMIC_SEQ_CST)) {
+        usleep(1000);
+    }
+
+    // 不属于任何请求的失败命令不影响请求的结果
+    push_insert(20, -20, NULL);
+    persist_ticket_t *a = track_insert(21, 21, "k21");
+    // 同 key 但属于另一个请求的命令不合并，各自拿到自己的结果
+    persist_ticket_t *b = track_insert(21, -21, "k21");
+    ASSERT_NE(nullptr, a);
+    ASSERT_NE(nullptr, b);
+    ASSERT_NE(a, b);
+
+    persist_queue_track_begin(NULL);
+    EXPECT_EQ(nullptr, persist_queue_track_take());
+    persist_queue_track_end();
+
+    persist_ticket_wait(a, ticket_cb, &rv_a);
+    persist_ticket_wait(b, ticket_cb, &rv_b);
+
+    __atomic_store_n(&release, true, __ATOMIC_SEQ_CST);
+    pthread_join(tid, NULL);
+
+    // sync 返回前回调已执行
+    persist_queue_sync();
+    EXPECT_EQ(0, rv_a);
+    EXPECT_NE(0, rv_b);
+    EXPECT_EQ(21, select_value(21));
+
+    // 已完成的记录在调用线程中直接回调
+    persist_ticket_t *c = track_insert(23, 23, NULL);
+    persist_queue_sync();
+    persist_ticket_wait(c, ticket_cb, &rv_c);
+    EXPECT_EQ(0, rv_c);
+}
+
+TEST(PersistQueueTest, stop)
+{
+    for (int i = 0; i < 1000; i++) {
+        push_insert(10 + i, i, NULL);
+    }
+
+    // 停止前执行完积压的命令
+    persist_queue_stop();
+
+    long long count = 0;
+    sqlite3_exec(persister.db, "SELECT COUNT(*) FROM kv WHERE k >= 10",
+                 row_cb, &count, NULL);
+    EXPECT_EQ(1000, count);
+
+    persist_cmd_t cmd = {};
+    cmd.exec          = exec_select;
+    EXPECT_NE(0, persist_queue_call(&cmd));
+
+    sqlite3_close(persister.db);
+}
@@ -1,3 +1,5 @@
+#include <pthread.h>
+
 #include <gtest/gtest.h>
 
 #include "utils/log.h"
@@ -36,6 +38,39 @@ TEST(RollingCounterTest, neu_rolling_counter_inc)
     neu_rolling_counter_free(counter);
 }
 
+static void *add_rolling_counter(void *arg)
+{
+    neu_rolling_counter_t *counter = (neu_rolling_counter_t *) arg;
+
+    for (int i = 0; i < 100000; ++i) {
+        neu_rolling_counter_add(counter, 1000, 1);
+    }
+    return NULL;
+}
+
+TEST(RollingCounterTest, neu_rolling_counter_add_concurrent)
+{
+    pthread_t              tids[4] = {};
+    neu_rolling_counter_t *counter = neu_rolling_counter_new(4000);
+    EXPECT_NE(nullptr, counter);
+
+    for (int i = 0; i < 4; ++i) {
+        pthread_create(&tids[i], NULL, add_rolling_counter, counter);
+    }
+    for (int i = 0; i < 4; ++i) {
+        pthread_join(tids[i], NULL);
+    }
+
+    EXPECT_EQ(400000, neu_rolling_counter_value(counter));
+    EXPECT_EQ(400000, neu_rolling_counter_value_at(counter, 4999));
+    EXPECT_EQ(0, neu_rolling_counter_value_at(counter, 5000));
+
+    neu_rolling_counter_reset(counter);
+    EXPECT_EQ(0, neu_rolling_counter_value(counter));
+
+    neu_rolling_counter_free(counter);
+}
+
 int main(int argc, char **argv)
 {
     zlog_init("./config/dev.conf");